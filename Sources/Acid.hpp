@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Animations/AnimatedMesh.hpp"
+#include "Animations/AnimatedModel.hpp"
 #include "Animations/Animation/Animation.hpp"
 #include "Animations/Animation/AnimationLoader.hpp"
 #include "Animations/Animation/JointTransform.hpp"
@@ -21,10 +22,17 @@
 #include "Audio/SoundBuffer.hpp"
 #include "Audio/Wave/WaveSoundBuffer.hpp"
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/BitmapOps.hpp"
+#include "Bitmaps/BlockDecoder.hpp"
+#include "Bitmaps/Dds/DdsBitmap.hpp"
 #include "Bitmaps/Dng/DngBitmap.hpp"
 #include "Bitmaps/Exr/ExrBitmap.hpp"
 #include "Bitmaps/Jpg/JpgBitmap.hpp"
+#include "Bitmaps/Ktx/KtxBitmap.hpp"
+#include "Bitmaps/PixelFormat.hpp"
 #include "Bitmaps/Png/PngBitmap.hpp"
+#include "Bitmaps/Qoi/QoiBitmap.hpp"
+#include "Bitmaps/TextureCooker.hpp"
 #include "Devices/Instance.hpp"
 #include "Devices/Joysticks.hpp"
 #include "Devices/Keyboard.hpp"
@@ -38,27 +46,39 @@
 #include "Engine/Engine.hpp"
 #include "Engine/Log.hpp"
 #include "Engine/Module.hpp"
+#include "Files/AsyncReader.hpp"
+#include "Files/Binary/Binary.hpp"
 #include "Files/File.hpp"
 #include "Files/FileObserver.hpp"
 #include "Files/Files.hpp"
 #include "Files/Json/Json.hpp"
+#include "Files/MappedFile.hpp"
 #include "Files/Node.hpp"
+#include "Files/NodeArena.hpp"
 #include "Files/NodeConstView.hpp"
+#include "Files/NodeHandler.hpp"
+#include "Files/NodeReflect.hpp"
 #include "Files/NodeView.hpp"
+#include "Files/NodeWriter.hpp"
 #include "Files/Xml/Xml.hpp"
 #include "Files/Zip/ZipArchive.hpp"
 #include "Files/Zip/ZipEntry.hpp"
 #include "Files/Zip/ZipException.hpp"
+#include "Files/Zip/ZipPack.hpp"
+#include "Fonts/Fonts.hpp"
 #include "Fonts/FontsSubrender.hpp"
 #include "Fonts/FontType.hpp"
 #include "Fonts/Text.hpp"
+#include "Fonts/TextBatch.hpp"
 #include "Gizmos/Gizmo.hpp"
 #include "Gizmos/Gizmos.hpp"
 #include "Gizmos/GizmosSubrender.hpp"
 #include "Gizmos/GizmoType.hpp"
+#include "Graphics/Buffers/BatchBuffers.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
 #include "Graphics/Buffers/InstanceBuffer.hpp"
 #include "Graphics/Buffers/PushHandler.hpp"
+#include "Graphics/Buffers/ReadbackQueue.hpp"
 #include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Graphics/Buffers/StorageHandler.hpp"
 #include "Graphics/Buffers/UniformBuffer.hpp"
@@ -69,11 +89,14 @@
 #include "Graphics/Descriptors/DescriptorSet.hpp"
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Graphics.hpp"
+#include "Graphics/Images/AtlasPacker.hpp"
 #include "Graphics/Images/Image.hpp"
 #include "Graphics/Images/Image2d.hpp"
 #include "Graphics/Images/Image2dArray.hpp"
 #include "Graphics/Images/ImageCube.hpp"
 #include "Graphics/Images/ImageDepth.hpp"
+#include "Graphics/Images/TextureAtlas.hpp"
+#include "Graphics/Images/TextureStreamer.hpp"
 #include "Graphics/Pipelines/Pipeline.hpp"
 #include "Graphics/Pipelines/PipelineCompute.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
@@ -86,6 +109,7 @@
 #include "Graphics/Subrender.hpp"
 #include "Graphics/SubrenderHolder.hpp"
 #include "Guis/Gui.hpp"
+#include "Guis/GuiBatch.hpp"
 #include "Guis/GuisSubrender.hpp"
 #include "Inputs/Axes/ButtonInputAxis.hpp"
 #include "Inputs/Axes/CompoundInputAxis.hpp"
@@ -121,6 +145,7 @@
 #include "Maths/Vector4.hpp"
 #include "Meshes/Mesh.hpp"
 #include "Meshes/MeshesSubrender.hpp"
+#include "Models/Gltf/GltfLoader.hpp"
 #include "Models/Gltf/GltfModel.hpp"
 #include "Models/Model.hpp"
 #include "Models/Obj/ObjModel.hpp"
@@ -167,9 +192,11 @@
 #include "Physics/Colliders/HeightfieldCollider.hpp"
 #include "Physics/Colliders/SphereCollider.hpp"
 #include "Physics/CollisionObject.hpp"
+#include "Physics/CollisionPairSet.hpp"
 #include "Physics/Force.hpp"
 #include "Physics/Frustum.hpp"
 #include "Physics/KinematicCharacter.hpp"
+#include "Physics/PhysicsQuery.hpp"
 #include "Physics/Ray.hpp"
 #include "Physics/Rigidbody.hpp"
 #include "Post/Deferred/DeferredSubrender.hpp"
@@ -202,6 +229,7 @@
 #include "Scenes/Entity.hpp"
 #include "Scenes/EntityPrefab.hpp"
 #include "Scenes/Scene.hpp"
+#include "Scenes/SceneLoader.hpp"
 #include "Scenes/ScenePhysics.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Scenes/SceneStructure.hpp"
@@ -232,7 +260,9 @@
 #include "Uis/Inputs/UiRadioInput.hpp"
 #include "Uis/Inputs/UiSliderInput.hpp"
 #include "Uis/Inputs/UiTextInput.hpp"
+#include "Uis/UiHitGrid.hpp"
 #include "Uis/UiObject.hpp"
+#include "Uis/UiObjectFilter.hpp"
 #include "Uis/UiPanel.hpp"
 #include "Uis/Uis.hpp"
 #include "Uis/UiScrollBar.hpp"
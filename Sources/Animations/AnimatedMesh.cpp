@@ -1,13 +1,7 @@
 #include "AnimatedMesh.hpp"
 
-#include "Maths/Maths.hpp"
 #include "Files/File.hpp"
-#include "Maths/Matrix4.hpp"
 #include "Scenes/Entity.hpp"
-#include "Animation/AnimationLoader.hpp"
-#include "Skeleton/SkeletonLoader.hpp"
-#include "Skin/SkinLoader.hpp"
-#include "Geometry/GeometryLoader.hpp"
 #include "Maths/Transform.hpp"
 
 namespace acid {
@@ -23,24 +17,13 @@ void AnimatedMesh::Start() {
 	if (filename.empty())
 		return;
 
-	File file(filename, File::Type::Xml);
-	file.Load();
-	auto fileNode = file.GetNode()["COLLADA"];
+	animatedModel = AnimatedModel::Create(filename);
+	model = animatedModel->GetModel();
+	animator.DoAnimation(animatedModel->GetAnimation());
 
-	// Because in Blender z is up, but Acid is y up. A correction must be applied to positions and normals.
-	static const auto Correction = Matrix4().Rotate(Maths::Radians(-90.0f), Vector3f::Right);
-
-	SkinLoader skinLoader(fileNode["library_controllers"], MaxWeights);
-	SkeletonLoader skeletonLoader(fileNode["library_visual_scenes"], skinLoader.GetJointOrder(), Correction);
-	GeometryLoader geometryLoader(fileNode["library_geometries"], skinLoader.GetVertexWeights(), Correction);
-
-	model = std::make_shared<Model>(geometryLoader.GetVertices(), geometryLoader.GetIndices());
-	headJoint = skeletonLoader.GetHeadJoint();
-
-	AnimationLoader animationLoader(fileNode["library_animations"], fileNode["library_visual_scenes"], Correction);
-
-	animation = std::make_unique<Animation>(animationLoader.GetLengthSeconds(), animationLoader.GetKeyframes());
-	animator.DoAnimation(animation.get());
+	// Uses the material imported with the model when none was given.
+	if (!material && !animatedModel->GetMaterials().empty())
+		SetMaterial(animatedModel->CreateMaterial(0));
 
 /*#if defined(ACID_DEBUG)
 	{
@@ -51,12 +34,12 @@ void AnimatedMesh::Start() {
 	}
 	{
 		File fileJoints("Animation/Joints.json", File::Type::Json);
-		fileJoints.GetNode() = headJoint;
+		fileJoints.GetNode() = animatedModel->GetHeadJoint();
 		fileJoints.Write(Node::Format::Beautified);
 	}
 	{
 		File fileAnimation0("Animation/Animation0.json", File::Type::Json);
-		fileAnimation0.GetNode() = *animation;
+		fileAnimation0.GetNode() = *animatedModel->GetAnimation();
 		fileAnimation0.Write(Node::Format::Beautified);
 	}
 #endif*/
@@ -69,7 +52,8 @@ void AnimatedMesh::Update() {
 	}
 	
 	std::vector<Matrix4> jointMatrices(MaxJoints);
-	animator.Update(headJoint, jointMatrices);
+	if (animatedModel)
+		animator.Update(animatedModel->GetHeadJoint(), jointMatrices);
 	storageAnimation.Push(jointMatrices.data(), sizeof(Matrix4) * jointMatrices.size());
 }
 
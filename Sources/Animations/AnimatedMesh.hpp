@@ -5,6 +5,7 @@
 #include "Scenes/Component.hpp"
 #include "Graphics/Buffers/StorageHandler.hpp"
 #include "Geometry/VertexAnimated.hpp"
+#include "AnimatedModel.hpp"
 #include "Animator.hpp"
 
 namespace acid {
@@ -16,7 +17,7 @@ class ACID_EXPORT AnimatedMesh : public Component::Registrar<AnimatedMesh> {
 public:
 	/**
 	 * Creates a new animated mesh component.
-	 * @param filename The file to load the model and animation from.
+	 * @param filename The COLLADA or compiled file to load the model and animation from.
 	 * @param material The material to render this mesh with.
 	 */
 	explicit AnimatedMesh(std::filesystem::path filename = "", std::unique_ptr<Material> &&material = nullptr);
@@ -31,6 +32,8 @@ public:
 	const std::shared_ptr<Model> &GetModel() const { return model; }
 	void SetModel(const std::shared_ptr<Model> &model) { this->model = model; }
 
+	const std::shared_ptr<AnimatedModel> &GetAnimatedModel() const { return animatedModel; }
+
 	const std::unique_ptr<Material> &GetMaterial() const { return material; }
 	void SetMaterial(std::unique_ptr<Material> &&material);
 
@@ -47,10 +50,8 @@ private:
 	std::unique_ptr<Material> material;
 	
 	std::filesystem::path filename;
+	std::shared_ptr<AnimatedModel> animatedModel;
 	Animator animator;
-	Joint headJoint;
-	
-	std::unique_ptr<Animation> animation;
 
 	DescriptorsHandler descriptorSet;
 	UniformHandler uniformObject;
@@ -0,0 +1,446 @@
+#include "AnimatedModel.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+
+#include "Files/File.hpp"
+#include "Files/Files.hpp"
+#include "Maths/Maths.hpp"
+#include "Models/Gltf/GltfLoader.hpp"
+#include "Resources/Resources.hpp"
+#include "Animation/AnimationLoader.hpp"
+#include "Geometry/GeometryLoader.hpp"
+#include "Skeleton/SkeletonLoader.hpp"
+#include "Skin/SkinLoader.hpp"
+#include "AnimatedMesh.hpp"
+
+namespace acid {
+namespace {
+constexpr char CompiledMagic[4] = {'A', 'C', 'M', '0'};
+constexpr uint32_t CompiledVersion = 2;
+
+enum CompiledFlags : uint32_t {
+	CompiledFlagQuantized = 1 << 0
+};
+
+/// The fewest bytes each element of a section is written with, counts are checked against the bytes left before anything is allocated.
+constexpr std::size_t CompiledJointSize = 3 * sizeof(uint32_t) + 16 * sizeof(float);
+constexpr std::size_t CompiledVertexSize = 11 * sizeof(float) + 3 * sizeof(uint32_t);
+constexpr std::size_t CompiledPoseSize = 7 * sizeof(float);
+constexpr std::size_t CompiledQuantizedPoseSize = 7 * sizeof(uint16_t);
+
+/**
+ * Writes each field of the compiled format on its own, so the file does not depend on how the compiler pads structures.
+ * Numbers are written little endian, as used by every platform the engine targets.
+ */
+class CompiledWriter {
+public:
+	explicit CompiledWriter(std::ostream &stream) :
+		stream(stream) {
+	}
+
+	template<typename T>
+	void Write(T value) {
+		static_assert(std::is_arithmetic_v<T>, "Only numbers are written natively");
+		stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	void WriteVector(const T &vector, uint32_t size) {
+		for (uint32_t i = 0; i < size; i++)
+			Write(vector[i]);
+	}
+
+	void WriteString(std::string_view string) {
+		Write(static_cast<uint32_t>(string.size()));
+		stream.write(string.data(), static_cast<std::streamsize>(string.size()));
+	}
+
+private:
+	std::ostream &stream;
+};
+
+class CompiledReader {
+public:
+	CompiledReader(const uint8_t *data, std::size_t size) :
+		it(data),
+		end(data + size) {
+	}
+
+	void Require(std::size_t count, std::size_t elementSize) const {
+		if (count > static_cast<std::size_t>(end - it) / elementSize)
+			throw std::runtime_error("Compiled animated model is truncated");
+	}
+
+	template<typename T>
+	T Read() {
+		Require(1, sizeof(T));
+		T value;
+		std::memcpy(&value, it, sizeof(T));
+		it += sizeof(T);
+		return value;
+	}
+
+	template<typename T>
+	T ReadVector(uint32_t size) {
+		T vector;
+		for (uint32_t i = 0; i < size; i++)
+			vector[i] = Read<std::decay_t<decltype(vector[i])>>();
+		return vector;
+	}
+
+	std::string_view ReadString() {
+		auto size = Read<uint32_t>();
+		Require(size, 1);
+		std::string_view string(reinterpret_cast<const char *>(it), size);
+		it += size;
+		return string;
+	}
+
+private:
+	const uint8_t *it;
+	const uint8_t *end;
+};
+
+AnimatedModel::CompiledData ReadCollada(const std::filesystem::path &filename) {
+	File file(filename, File::Type::Xml);
+	file.Load();
+	auto fileNode = file.GetNode()["COLLADA"];
+
+	// Because in Blender z is up, but Acid is y up. A correction must be applied to positions and normals.
+	static const auto Correction = Matrix4().Rotate(Maths::Radians(-90.0f), Vector3f::Right);
+
+	SkinLoader skinLoader(fileNode["library_controllers"], AnimatedMesh::MaxWeights);
+	SkeletonLoader skeletonLoader(fileNode["library_visual_scenes"], skinLoader.GetJointOrder(), Correction);
+	GeometryLoader geometryLoader(fileNode["library_geometries"], skinLoader.GetVertexWeights(), Correction);
+	AnimationLoader animationLoader(fileNode["library_animations"], fileNode["library_visual_scenes"], Correction);
+
+	AnimatedModel::CompiledData data;
+	data.vertices = geometryLoader.GetVertices();
+	data.indices = geometryLoader.GetIndices();
+	data.headJoint = skeletonLoader.GetHeadJoint();
+	data.length = animationLoader.GetLengthSeconds();
+	data.keyframes = animationLoader.GetKeyframes();
+	return data;
+}
+
+void FlattenJoints(const Joint &joint, int32_t parent, std::vector<const Joint *> &joints, std::vector<int32_t> &parents) {
+	auto self = static_cast<int32_t>(joints.size());
+	joints.emplace_back(&joint);
+	parents.emplace_back(parent);
+
+	for (const auto &child : joint.GetChildren())
+		FlattenJoints(child, self, joints, parents);
+}
+
+Joint BuildJoint(uint32_t i, const std::vector<Joint> &joints, const std::vector<std::vector<uint32_t>> &children) {
+	auto joint = joints[i];
+	for (auto child : children[i])
+		joint.AddChild(BuildJoint(child, joints, children));
+	return joint;
+}
+}
+
+std::shared_ptr<AnimatedModel> AnimatedModel::Create(const Node &node) {
+	if (auto resource = Resources::Get()->Find<AnimatedModel>(node))
+		return resource;
+
+	auto result = std::make_shared<AnimatedModel>("");
+	Resources::Get()->Add(node, std::dynamic_pointer_cast<Resource>(result));
+	node >> *result;
+	result->Load();
+	return result;
+}
+
+std::shared_ptr<AnimatedModel> AnimatedModel::Create(const std::filesystem::path &filename) {
+	AnimatedModel temp(filename, false);
+	Node node;
+	node << temp;
+	return Create(node);
+}
+
+AnimatedModel::AnimatedModel(std::filesystem::path filename, bool load) :
+	filename(std::move(filename)) {
+	if (load)
+		Load();
+}
+
+bool AnimatedModel::Compile(const std::filesystem::path &colladaFilename, const std::filesystem::path &outputFilename, bool quantize) {
+	auto data = ReadCollada(colladaFilename);
+
+	if (auto parentPath = outputFilename.parent_path(); !parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	std::ofstream os(outputFilename, std::ios::out | std::ios::binary);
+	if (!os)
+		return false;
+	WriteCompiled(data, os, quantize);
+	return static_cast<bool>(os);
+}
+
+void AnimatedModel::WriteCompiled(const CompiledData &data, std::ostream &stream, bool quantize) {
+	std::vector<const Joint *> joints;
+	std::vector<int32_t> parents;
+	FlattenJoints(data.headJoint, -1, joints, parents);
+
+	// Every keyframe stores a pose for the same set of tracks, the first keyframe defines the order.
+	std::vector<std::string_view> trackNames;
+	if (!data.keyframes.empty()) {
+		for (const auto &[name, transform] : data.keyframes[0].GetPose())
+			trackNames.emplace_back(name);
+	}
+
+	std::vector<JointTransform> poses;
+	poses.reserve(data.keyframes.size() * trackNames.size());
+
+	auto positionMin = Vector3f::Infinity;
+	auto positionMax = -Vector3f::Infinity;
+
+	for (const auto &keyframe : data.keyframes) {
+		for (const auto &name : trackNames) {
+			auto it = keyframe.GetPose().find(std::string(name));
+			auto &pose = poses.emplace_back(it != keyframe.GetPose().end() ? it->second : JointTransform());
+			positionMin = positionMin.Min(pose.GetPosition());
+			positionMax = positionMax.Max(pose.GetPosition());
+		}
+	}
+
+	Vector3f positionScale;
+	for (uint32_t i = 0; i < 3; i++) {
+		positionMin[i] = poses.empty() ? 0.0f : positionMin[i];
+		positionScale[i] = poses.empty() ? 0.0f : (positionMax[i] - positionMin[i]) / std::numeric_limits<uint16_t>::max();
+	}
+
+	CompiledWriter writer(stream);
+	stream.write(CompiledMagic, sizeof(CompiledMagic));
+	writer.Write(CompiledVersion);
+	writer.Write<uint32_t>(quantize ? CompiledFlagQuantized : 0);
+	writer.Write(static_cast<uint32_t>(joints.size()));
+	writer.Write(static_cast<uint32_t>(data.vertices.size()));
+	writer.Write(static_cast<uint32_t>(data.indices.size()));
+	writer.Write(static_cast<uint32_t>(trackNames.size()));
+	writer.Write(static_cast<uint32_t>(data.keyframes.size()));
+	writer.Write(data.length.AsSeconds<float>());
+	writer.WriteVector(positionMin, 3);
+	writer.WriteVector(positionScale, 3);
+
+	for (std::size_t i = 0; i < joints.size(); i++) {
+		writer.Write(joints[i]->GetIndex());
+		writer.Write(parents[i]);
+		writer.WriteString(joints[i]->GetName());
+		for (uint32_t row = 0; row < 4; row++)
+			writer.WriteVector(joints[i]->GetLocalBindTransform()[row], 4);
+	}
+
+	for (const auto &vertex : data.vertices) {
+		writer.WriteVector(vertex.position, 3);
+		writer.WriteVector(vertex.uv, 2);
+		writer.WriteVector(vertex.normal, 3);
+		writer.WriteVector(vertex.jointId, 3);
+		writer.WriteVector(vertex.vertexWeight, 3);
+	}
+
+	for (auto index : data.indices)
+		writer.Write(index);
+	for (const auto &name : trackNames)
+		writer.WriteString(name);
+	for (const auto &keyframe : data.keyframes)
+		writer.Write(keyframe.GetTimeStamp().AsSeconds<float>());
+
+	for (const auto &pose : poses) {
+		const auto &position = pose.GetPosition();
+		auto rotation = pose.GetRotation().Normalize();
+
+		if (quantize) {
+			for (uint32_t j = 0; j < 3; j++) {
+				writer.Write<uint16_t>(positionScale[j] == 0.0f ? 0 :
+					static_cast<uint16_t>(std::round((position[j] - positionMin[j]) / positionScale[j])));
+			}
+			writer.Write(static_cast<int16_t>(std::round(rotation.x * std::numeric_limits<int16_t>::max())));
+			writer.Write(static_cast<int16_t>(std::round(rotation.y * std::numeric_limits<int16_t>::max())));
+			writer.Write(static_cast<int16_t>(std::round(rotation.z * std::numeric_limits<int16_t>::max())));
+			writer.Write(static_cast<int16_t>(std::round(rotation.w * std::numeric_limits<int16_t>::max())));
+		} else {
+			writer.WriteVector(position, 3);
+			writer.Write(rotation.x);
+			writer.Write(rotation.y);
+			writer.Write(rotation.z);
+			writer.Write(rotation.w);
+		}
+	}
+}
+
+AnimatedModel::CompiledData AnimatedModel::ReadCompiled(const uint8_t *bytes, std::size_t size) {
+	CompiledReader reader(bytes, size);
+	char magic[4];
+	for (auto &c : magic)
+		c = reader.Read<char>();
+	if (!std::equal(std::begin(CompiledMagic), std::end(CompiledMagic), magic) || reader.Read<uint32_t>() != CompiledVersion)
+		throw std::runtime_error("Compiled animated model has an unsupported format");
+
+	auto quantized = (reader.Read<uint32_t>() & CompiledFlagQuantized) != 0;
+	auto jointCount = reader.Read<uint32_t>();
+	auto vertexCount = reader.Read<uint32_t>();
+	auto indexCount = reader.Read<uint32_t>();
+	auto trackCount = reader.Read<uint32_t>();
+	auto keyframeCount = reader.Read<uint32_t>();
+
+	CompiledData data;
+	data.length = Time::Seconds(reader.Read<float>());
+	auto positionMin = reader.ReadVector<Vector3f>(3);
+	auto positionScale = reader.ReadVector<Vector3f>(3);
+
+	if (jointCount > AnimatedMesh::MaxJoints)
+		throw std::runtime_error("Compiled animated model has more joints than can be animated");
+
+	// Joints are written depth first, so each parent comes before its children.
+	reader.Require(jointCount, CompiledJointSize);
+	std::vector<Joint> joints;
+	std::vector<std::vector<uint32_t>> children(jointCount);
+	joints.reserve(jointCount);
+	for (uint32_t i = 0; i < jointCount; i++) {
+		auto index = reader.Read<uint32_t>();
+		auto parent = reader.Read<int32_t>();
+		auto name = reader.ReadString();
+		Matrix4 localBindTransform;
+		for (uint32_t row = 0; row < 4; row++)
+			localBindTransform[row] = reader.ReadVector<Vector4f>(4);
+
+		if (i == 0 ? parent != -1 : parent < 0 || static_cast<uint32_t>(parent) >= i)
+			throw std::runtime_error("Compiled animated model has a malformed skeleton");
+		if (i != 0)
+			children[parent].emplace_back(i);
+		joints.emplace_back(index, std::string(name), localBindTransform);
+	}
+
+	if (jointCount != 0) {
+		data.headJoint = BuildJoint(0, joints, children);
+		data.headJoint.CalculateInverseBindTransform({});
+	}
+
+	reader.Require(vertexCount, CompiledVertexSize);
+	data.vertices.reserve(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; i++) {
+		auto &vertex = data.vertices.emplace_back();
+		vertex.position = reader.ReadVector<Vector3f>(3);
+		vertex.uv = reader.ReadVector<Vector2f>(2);
+		vertex.normal = reader.ReadVector<Vector3f>(3);
+		vertex.jointId = reader.ReadVector<Vector3ui>(3);
+		vertex.vertexWeight = reader.ReadVector<Vector3f>(3);
+
+		if (vertex.jointId.x >= AnimatedMesh::MaxJoints || vertex.jointId.y >= AnimatedMesh::MaxJoints || vertex.jointId.z >= AnimatedMesh::MaxJoints)
+			throw std::runtime_error("Compiled animated model has a vertex weighted to a joint out of range");
+	}
+
+	reader.Require(indexCount, sizeof(uint32_t));
+	data.indices.reserve(indexCount);
+	for (uint32_t i = 0; i < indexCount; i++) {
+		auto index = reader.Read<uint32_t>();
+		if (index >= vertexCount)
+			throw std::runtime_error("Compiled animated model has an index out of range");
+		data.indices.emplace_back(index);
+	}
+
+	reader.Require(trackCount, sizeof(uint32_t));
+	std::vector<std::string> trackNames;
+	trackNames.reserve(trackCount);
+	for (uint32_t i = 0; i < trackCount; i++)
+		trackNames.emplace_back(reader.ReadString());
+
+	reader.Require(keyframeCount, sizeof(float));
+	std::vector<float> times;
+	times.reserve(keyframeCount);
+	for (uint32_t i = 0; i < keyframeCount; i++)
+		times.emplace_back(reader.Read<float>());
+
+	reader.Require(std::size_t(keyframeCount) * trackCount, quantized ? CompiledQuantizedPoseSize : CompiledPoseSize);
+	data.keyframes.reserve(keyframeCount);
+
+	for (uint32_t i = 0; i < keyframeCount; i++) {
+		std::map<std::string, JointTransform> pose;
+
+		for (uint32_t j = 0; j < trackCount; j++) {
+			if (quantized) {
+				Vector3f position;
+				for (uint32_t k = 0; k < 3; k++)
+					position[k] = positionMin[k] + reader.Read<uint16_t>() * positionScale[k];
+				constexpr auto Scale = 1.0f / std::numeric_limits<int16_t>::max();
+				auto rotation = reader.ReadVector<std::array<int16_t, 4>>(4);
+				pose.emplace(trackNames[j], JointTransform(position, Quaternion(rotation[0] * Scale, rotation[1] * Scale, rotation[2] * Scale, rotation[3] * Scale).Normalize()));
+			} else {
+				auto position = reader.ReadVector<Vector3f>(3);
+				auto rotation = reader.ReadVector<std::array<float, 4>>(4);
+				pose.emplace(trackNames[j], JointTransform(position, Quaternion(rotation[0], rotation[1], rotation[2], rotation[3])));
+			}
+		}
+
+		data.keyframes.emplace_back(Time::Seconds(times[i]), std::move(pose));
+	}
+
+	return data;
+}
+
+std::unique_ptr<DefaultMaterial> AnimatedModel::CreateMaterial(std::size_t index) const {
+	return GltfLoader::CreateMaterial(materials, index);
+}
+
+const Node &operator>>(const Node &node, AnimatedModel &animatedModel) {
+	node["filename"].Get(animatedModel.filename);
+	return node;
+}
+
+Node &operator<<(Node &node, const AnimatedModel &animatedModel) {
+	node["filename"].Set(animatedModel.filename);
+	return node;
+}
+
+void AnimatedModel::Load() {
+	if (filename.empty())
+		return;
+
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	if (filename.extension() == CompiledExtension)
+		LoadCompiled();
+	else if (filename.extension() == ".gltf" || filename.extension() == ".glb")
+		LoadGltf();
+	else
+		LoadCollada();
+
+#if defined(ACID_DEBUG)
+	Log::Out("Animated model ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+}
+
+void AnimatedModel::LoadCollada() {
+	auto data = ReadCollada(filename);
+	model = std::make_shared<Model>(data.vertices, data.indices);
+	headJoint = std::move(data.headJoint);
+	animation = std::make_unique<Animation>(data.length, std::move(data.keyframes));
+}
+
+void AnimatedModel::LoadGltf() {
+	GltfLoader loader(filename, true);
+	model = std::make_shared<Model>(loader.GetAnimatedVertices(), loader.GetIndices());
+	headJoint = loader.GetHeadJoint();
+	materials = loader.GetMaterials();
+
+	// Only the first animation clip is played by the animator, a skin without animations is drawn in its bind pose.
+	if (!loader.GetAnimations().empty())
+		animation = std::make_unique<Animation>(loader.GetAnimations().front());
+}
+
+void AnimatedModel::LoadCompiled() {
+	auto file = Files::ReadAsync(filename).get();
+	if (!*file)
+		throw std::runtime_error("Compiled animated model could not be read");
+
+	auto data = ReadCompiled(file->GetData(), file->GetSize());
+	model = std::make_shared<Model>(data.vertices, data.indices);
+	headJoint = std::move(data.headJoint);
+	animation = std::make_unique<Animation>(data.length, std::move(data.keyframes));
+}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Materials/DefaultMaterial.hpp"
+#include "Models/Model.hpp"
+#include "Resources/Resource.hpp"
+#include "Animation/Animation.hpp"
+#include "Geometry/VertexAnimated.hpp"
+#include "Skeleton/Joint.hpp"
+
+namespace acid {
+/**
+ * @brief Resource that represents the shared data of an animated mesh: the skinned geometry, skeleton and animation clip.
+ * Loaded from either a COLLADA file, the first skin of a glTF file, or from the compiled binary format written by {@link AnimatedModel#Compile}.
+ *
+ * The compiled format is a header followed by the joints, vertices, indices, tracks and keyframes, with every field written on its own
+ * so the layout does not depend on compiler padding. Keyframe poses may optionally be quantized to 16 bits per component.
+ */
+class ACID_EXPORT AnimatedModel : public Resource {
+public:
+	/**
+	 * @brief The skinned geometry, skeleton and animation clip stored in the compiled format.
+	 */
+	class CompiledData {
+	public:
+		std::vector<VertexAnimated> vertices;
+		std::vector<uint32_t> indices;
+		Joint headJoint;
+		Time length;
+		std::vector<Keyframe> keyframes;
+	};
+
+	static constexpr std::string_view CompiledExtension = ".acm";
+
+	/**
+	 * Creates a new animated model, or finds one with the same values.
+	 * @param node The node to decode values from.
+	 * @return The animated model with the requested values.
+	 */
+	static std::shared_ptr<AnimatedModel> Create(const Node &node);
+
+	/**
+	 * Creates a new animated model, or finds one with the same values.
+	 * @param filename The COLLADA, glTF or compiled file to load the animated model from.
+	 * @return The animated model with the requested values.
+	 */
+	static std::shared_ptr<AnimatedModel> Create(const std::filesystem::path &filename);
+
+	/**
+	 * Creates a new animated model.
+	 * @param filename The COLLADA, glTF or compiled file to load the animated model from.
+	 * @param load If this resource will be loaded immediately, otherwise {@link AnimatedModel#Load} can be called later.
+	 */
+	explicit AnimatedModel(std::filesystem::path filename, bool load = true);
+
+	/**
+	 * Converts a COLLADA file into the compiled binary format, this does not require a graphics device.
+	 * @param colladaFilename The COLLADA file to read.
+	 * @param outputFilename The compiled file to write.
+	 * @param quantize If keyframe positions and rotations will be quantized to 16 bits per component.
+	 * @return If the file was written.
+	 */
+	static bool Compile(const std::filesystem::path &colladaFilename, const std::filesystem::path &outputFilename, bool quantize = false);
+
+	/**
+	 * Writes data in the compiled binary format.
+	 * @param data The data to write.
+	 * @param stream The stream to write into.
+	 * @param quantize If keyframe positions and rotations will be quantized to 16 bits per component.
+	 */
+	static void WriteCompiled(const CompiledData &data, std::ostream &stream, bool quantize = false);
+
+	/**
+	 * Reads data in the compiled binary format, every count, name and index is checked against the bytes read.
+	 * @param bytes The compiled bytes.
+	 * @param size The number of bytes.
+	 * @return The data read.
+	 * @throws std::runtime_error If the bytes are truncated or malformed.
+	 */
+	static CompiledData ReadCompiled(const uint8_t *bytes, std::size_t size);
+
+	std::type_index GetTypeIndex() const override { return typeid(AnimatedModel); }
+
+	const std::filesystem::path &GetFilename() const { return filename; }
+	const std::shared_ptr<Model> &GetModel() const { return model; }
+	const Joint &GetHeadJoint() const { return headJoint; }
+	/**
+	 * Gets the animation clip, a glTF file may only have a skin.
+	 * @return The animation, or nullptr if the model is only drawn in its bind pose.
+	 */
+	const Animation *GetAnimation() const { return animation.get(); }
+	const std::vector<DefaultMaterial> &GetMaterials() const { return materials; }
+
+	/**
+	 * Creates a new material from one of the materials imported with the model, only glTF files contain materials.
+	 * @param index The material index.
+	 * @return The new material, or nullptr if the index is out of range.
+	 */
+	std::unique_ptr<DefaultMaterial> CreateMaterial(std::size_t index) const;
+
+	friend const Node &operator>>(const Node &node, AnimatedModel &animatedModel);
+	friend Node &operator<<(Node &node, const AnimatedModel &animatedModel);
+
+private:
+	void Load();
+	void LoadCollada();
+	void LoadGltf();
+	void LoadCompiled();
+
+	std::filesystem::path filename;
+
+	std::shared_ptr<Model> model;
+	Joint headJoint;
+	std::unique_ptr<Animation> animation;
+	std::vector<DefaultMaterial> materials;
+};
+}
@@ -73,7 +73,7 @@ void Animator::CalculateJointPose(const std::map<std::string, Matrix4> &currentP
 		jointMatrices[joint.GetIndex()] = currentTransform;
 }
 
-void Animator::DoAnimation(Animation *animation) {
+void Animator::DoAnimation(const Animation *animation) {
 	animationTime = 0s;
 	currentAnimation = animation;
 }
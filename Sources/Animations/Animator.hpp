@@ -113,10 +113,10 @@ public:
 	 * Indicates that the entity should carry out the given animation. Resets the animation time so that the new animation starts from the beginning.
 	 * @param animation The new animation to carry out.
 	 */
-	void DoAnimation(Animation *animation);
+	void DoAnimation(const Animation *animation);
 
 private:
 	Time animationTime;
-	Animation *currentAnimation = nullptr;
+	const Animation *currentAnimation = nullptr;
 };
 }
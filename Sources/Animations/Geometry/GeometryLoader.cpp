@@ -3,6 +3,29 @@
 #include "Animations/AnimatedMesh.hpp"
 
 namespace acid {
+/**
+ * Reads the whitespace separated numbers of a node value in place, rather than splitting the value into strings first.
+ */
+template<typename T>
+static std::vector<T> ReadValues(const NodeConstView &node) {
+	std::vector<T> values;
+	if (!node)
+		return values;
+
+	auto string = node->GetValueView();
+	for (std::size_t i = 0; i < string.size();) {
+		while (i < string.size() && String::IsWhitespace(string[i]))
+			i++;
+		auto start = i;
+		while (i < string.size() && !String::IsWhitespace(string[i]))
+			i++;
+		if (i != start)
+			values.emplace_back(String::From<T>(string.substr(start, i - start)));
+	}
+
+	return values;
+}
+
 GeometryLoader::GeometryLoader(NodeConstView &&libraryGeometries, std::vector<VertexWeights> vertexWeights, const Matrix4 &correction) :
 	meshData(libraryGeometries["geometry"]["mesh"]),
 	vertexWeights(std::move(vertexWeights)),
@@ -12,14 +35,14 @@ GeometryLoader::GeometryLoader(NodeConstView &&libraryGeometries, std::vector<Ve
 	auto normals = GetNormals();
 
 	auto indexCount = static_cast<int32_t>(meshData.GetPropertyWithBackup("polylist", "triangles")["input"].GetProperties().size());
-	auto indexRawData = String::Split(meshData.GetPropertyWithBackup("polylist", "triangles")["p"].Get<std::string>(), ' ');
+	auto indexData = ReadValues<uint32_t>(meshData.GetPropertyWithBackup("polylist", "triangles")["p"]);
 
 	std::unordered_map<VertexAnimated, size_t> uniqueVertices;
 
-	for (uint32_t i = 0; i < indexRawData.size() / indexCount; i++) {
-		auto positionIndex = String::From<uint32_t>(indexRawData[indexCount * i]);
-		auto normalIndex = String::From<uint32_t>(indexRawData[indexCount * i + 1]);
-		auto uvIndex = String::From<uint32_t>(indexRawData[indexCount * i + 2]);
+	for (uint32_t i = 0; i < indexData.size() / indexCount; i++) {
+		auto positionIndex = indexData[indexCount * i];
+		auto normalIndex = indexData[indexCount * i + 1];
+		auto uvIndex = indexData[indexCount * i + 2];
 
 		auto vertexWeight = this->vertexWeights[positionIndex];
 		Vector3ui jointIds(vertexWeight.GetJointIds()[0], vertexWeight.GetJointIds()[1], vertexWeight.GetJointIds()[2]);
@@ -40,13 +63,12 @@ std::vector<Vector3f> GeometryLoader::GetPositions() const {
 	auto positionsSource = meshData["vertices"]["input"]["-source"].Get<std::string>().substr(1);
 	auto positionsData = meshData["source"].GetPropertyWithValue("-id", positionsSource)["float_array"];
 	auto positionsCount = positionsData["-count"].Get<uint32_t>();
-	auto positionsRawData = String::Split(positionsData.Get<std::string>(), ' ');
+	auto positionsRawData = ReadValues<float>(positionsData);
 
 	std::vector<Vector3f> positions;
 
-	for (uint32_t i = 0; i < positionsCount / 3; i++) {
-		Vector4f position(String::From<float>(positionsRawData[3 * i]), String::From<float>(positionsRawData[i * 3 + 1]),
-			String::From<float>(positionsRawData[3 * i + 2]));
+	for (uint32_t i = 0; i < std::min<std::size_t>(positionsCount, positionsRawData.size()) / 3; i++) {
+		Vector4f position(positionsRawData[3 * i], positionsRawData[3 * i + 1], positionsRawData[3 * i + 2]);
 		positions.emplace_back(correction.Transform(position));
 	}
 
@@ -57,12 +79,12 @@ std::vector<Vector2f> GeometryLoader::GetUvs() const {
 	auto uvsSource = meshData.GetPropertyWithBackup("polylist", "triangles")["input"].GetPropertyWithValue("-semantic", "TEXCOORD")["-source"].Get<std::string>().substr(1);
 	auto uvsData = meshData["source"].GetPropertyWithValue("-id", uvsSource)["float_array"];
 	auto uvsCount = uvsData["-count"].Get<uint32_t>();
-	auto uvsRawData = String::Split(uvsData.Get<std::string>(), ' ');
+	auto uvsRawData = ReadValues<float>(uvsData);
 
 	std::vector<Vector2f> uvs;
 
-	for (uint32_t i = 0; i < uvsCount / 2; i++) {
-		Vector2f uv(String::From<float>(uvsRawData[2 * i]), 1.0f - String::From<float>(uvsRawData[2 * i + 1]));
+	for (uint32_t i = 0; i < std::min<std::size_t>(uvsCount, uvsRawData.size()) / 2; i++) {
+		Vector2f uv(uvsRawData[2 * i], 1.0f - uvsRawData[2 * i + 1]);
 		uvs.emplace_back(uv);
 	}
 
@@ -73,12 +95,12 @@ std::vector<Vector3f> GeometryLoader::GetNormals() const {
 	auto normalsSource = meshData.GetPropertyWithBackup("polylist", "triangles")["input"].GetPropertyWithValue("-semantic", "NORMAL")["-source"].Get<std::string>().substr(1);
 	auto normalsData = meshData["source"].GetPropertyWithValue("-id", normalsSource)["float_array"];
 	auto normalsCount = normalsData["-count"].Get<uint32_t>();
-	auto normalsRawData = String::Split(normalsData.Get<std::string>(), ' ');
+	auto normalsRawData = ReadValues<float>(normalsData);
 
 	std::vector<Vector3f> normals;
 
-	for (uint32_t i = 0; i < normalsCount / 3; i++) {
-		Vector4f normal(String::From<float>(normalsRawData[3 * i]), String::From<float>(normalsRawData[3 * i + 1]), String::From<float>(normalsRawData[3 * i + 2]));
+	for (uint32_t i = 0; i < std::min<std::size_t>(normalsCount, normalsRawData.size()) / 3; i++) {
+		Vector4f normal(normalsRawData[3 * i], normalsRawData[3 * i + 1], normalsRawData[3 * i + 2]);
 		normals.emplace_back(correction.Transform(normal));
 	}
 
@@ -16,6 +16,7 @@ Sound::Sound(const std::string &filename, const Audio::Type &type, bool begin, b
 	pitch(pitch) {
 	alGenSources(1, &source);
 	alSourcei(source, AL_BUFFER, buffer->GetBuffer());
+	ObserveBuffer();
 
 	Audio::CheckAl(alGetError());
 
@@ -46,6 +47,7 @@ void Sound::Update() {
 }
 
 void Sound::Play(bool loop) {
+	AttachBuffer();
 	alSourcei(source, AL_LOOPING, loop);
 	alSourcePlay(source);
 	Audio::CheckAl(alGetError());
@@ -115,8 +117,40 @@ void Sound::SetPitch(float pitch) {
 	Audio::CheckAl(alGetError());
 }
 
+void Sound::ObserveBuffer() {
+	if (buffer)
+		buffer->OnSwap().Add([this]() { AttachBuffer(); }, this);
+}
+
+void Sound::AttachBuffer() {
+	if (!buffer || !source)
+		return;
+
+	ALint attached = 0;
+	alGetSourcei(source, AL_BUFFER, &attached);
+	if (static_cast<uint32_t>(attached) == buffer->GetBuffer())
+		return;
+
+	// The buffer of a source can only be changed while it is stopped, a playing sound continues from the same time in the new buffer.
+	ALint state = AL_INITIAL;
+	ALfloat offset = 0.0f;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+	alGetSourcef(source, AL_SEC_OFFSET, &offset);
+	alSourceStop(source);
+	alSourcei(source, AL_BUFFER, buffer->GetBuffer());
+
+	// A paused sound is left stopped at its offset, Resume plays from there.
+	if (state == AL_PLAYING || state == AL_PAUSED)
+		alSourcef(source, AL_SEC_OFFSET, offset);
+	if (state == AL_PLAYING)
+		alSourcePlay(source);
+
+	Audio::CheckAl(alGetError());
+}
+
 const Node &operator>>(const Node &node, Sound &sound) {
 	node["buffer"].Get(sound.buffer);
+	sound.ObserveBuffer();
 	node["type"].Get(sound.type);
 	node["gain"].Get(sound.gain);
 	node["pitch"].Get(sound.pitch);
@@ -44,6 +44,9 @@ public:
 	friend Node &operator<<(Node &node, const Sound &sound);
 
 private:
+	void ObserveBuffer();
+	void AttachBuffer();
+
 	std::shared_ptr<SoundBuffer> buffer;
 	uint32_t source = 0;
 
@@ -43,6 +43,21 @@ void SoundBuffer::SetBuffer(uint32_t buffer) {
 	this->buffer = buffer;
 }
 
+std::shared_ptr<Resource> SoundBuffer::Reload() const {
+	if (filename.empty())
+		return nullptr;
+
+	return std::make_shared<SoundBuffer>(filename);
+}
+
+void SoundBuffer::Swap(Resource &other) {
+	Resource::Swap(other);
+	auto &soundBuffer = dynamic_cast<SoundBuffer &>(other);
+	std::swap(buffer, soundBuffer.buffer);
+	// A buffer attached to a source can not be deleted, so sources move to the new buffer before the old one is retired.
+	onSwap();
+}
+
 const Node &operator>>(const Node &node, SoundBuffer &soundBuffer) {
 	node["filename"].Get(soundBuffer.filename);
 	return node;
@@ -58,5 +73,6 @@ void SoundBuffer::Load() {
 		return;
 
 	Registry()[filename.extension().string()].first(this, filename);
+	dependencies = {filename};
 }
 }
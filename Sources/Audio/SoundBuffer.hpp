@@ -60,11 +60,19 @@ public:
 	~SoundBuffer();
 
 	std::type_index GetTypeIndex() const override { return typeid(SoundBuffer); }
+	std::shared_ptr<Resource> Reload() const override;
+	void Swap(Resource &other) override;
 
 	const std::filesystem::path &GetFilename() const { return filename; };
 	uint32_t GetBuffer() const { return buffer; }
 	void SetBuffer(uint32_t buffer);
 
+	/**
+	 * Called after a hot reload swapped in a new buffer, sources must attach it before the old buffer is retired and deleted.
+	 * @return The delegate.
+	 */
+	Delegate<void()> &OnSwap() { return onSwap; }
+
 	friend const Node &operator>>(const Node &node, SoundBuffer &soundBuffer);
 	friend Node &operator<<(Node &node, const SoundBuffer &soundBuffer);
 
@@ -73,5 +81,6 @@ private:
 
 	std::filesystem::path filename;
 	uint32_t buffer = 0;
+	Delegate<void()> onSwap;
 };
 }
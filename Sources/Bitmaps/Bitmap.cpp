@@ -1,10 +1,16 @@
 #include "Bitmap.hpp"
 
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 #include <stb/stb_image.h>
-#include <stb/stb_image_write.h>
 
 #include "Engine/Log.hpp"
 #include "Files/Files.hpp"
+#include "Png/PngBitmap.hpp"
+#include "Utils/String.hpp"
 
 namespace acid {
 Bitmap::Bitmap(std::filesystem::path filename) :
@@ -15,47 +21,274 @@ Bitmap::Bitmap(std::filesystem::path filename) :
 Bitmap::Bitmap(const Vector2ui &size, uint32_t bytesPerPixel) :
 	data(std::make_unique<uint8_t[]>(CalculateLength(size, bytesPerPixel))),
 	size(size),
-	bytesPerPixel(bytesPerPixel) {
+	bytesPerPixel(bytesPerPixel),
+	format(FindFormat(bytesPerPixel)) {
 }
 
 Bitmap::Bitmap(std::unique_ptr<uint8_t[]> &&data, const Vector2ui &size, uint32_t bytesPerPixel) :
 	data(std::move(data)),
 	size(size),
-	bytesPerPixel(bytesPerPixel) {
+	bytesPerPixel(bytesPerPixel),
+	format(FindFormat(bytesPerPixel)) {
+}
+
+Bitmap::Bitmap(std::unique_ptr<uint8_t[]> &&data, const Vector2ui &size, PixelFormat format, uint32_t mipLevels, uint32_t arrayLayers) :
+	data(std::move(data)),
+	size(size),
+	bytesPerPixel(PixelBlock::IsCompressed(format) ? 0 : PixelBlock::Get(format).bytes),
+	format(format),
+	mipLevels(mipLevels),
+	arrayLayers(arrayLayers) {
 }
 
 void Bitmap::Load(const std::filesystem::path &filename) {
-	//Registry()[filename.extension().string()].first(this, filename);
+	if (auto it = Registry().find(String::Lowercase(filename.extension().string())); it != Registry().end()) {
+		it->second.first(this, filename);
+		return;
+	}
 
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::ReadAsync(filename).get();
 
-	if (!fileLoaded) {
+	if (!*fileLoaded) {
 		Log::Error("Bitmap could not be loaded: ", filename, '\n');
 		return;
 	}
 
-	data = std::unique_ptr<uint8_t[]>(stbi_load_from_memory(reinterpret_cast<uint8_t *>(fileLoaded->data()), static_cast<uint32_t>(fileLoaded->size()),
+	data = std::unique_ptr<uint8_t[]>(stbi_load_from_memory(fileLoaded->GetData(), static_cast<uint32_t>(fileLoaded->GetSize()),
 		reinterpret_cast<int32_t *>(&size.x), reinterpret_cast<int32_t *>(&size.y), reinterpret_cast<int32_t *>(&bytesPerPixel), STBI_rgb_alpha));
 	bytesPerPixel = 4;
+	format = PixelFormat::R8G8B8A8Unorm;
+	mipLevels = 1;
+	arrayLayers = 1;
 }
 
 void Bitmap::Write(const std::filesystem::path &filename) const {
 	if (auto parentPath = filename.parent_path(); !parentPath.empty())
 		std::filesystem::create_directories(parentPath);
 
-	//Registry()[filename.extension().string()].second(this, filename);
+	if (auto it = Registry().find(String::Lowercase(filename.extension().string())); it != Registry().end()) {
+		it->second.second(this, filename);
+		return;
+	}
+
+	PngBitmap::Write(this, filename);
+}
 
-	std::ofstream os(filename, std::ios::binary | std::ios::out);
-	int32_t len;
-	std::unique_ptr<uint8_t[]> png(stbi_write_png_to_mem(data.get(), size.x * bytesPerPixel, size.x, size.y, bytesPerPixel, &len));
-	os.write(reinterpret_cast<char *>(png.get()), len);
+static float SrgbToLinear(float value) {
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSrgb(float value) {
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static std::array<float, 4> ReadPixel(PixelFormat format, const uint8_t *pixel) {
+	std::array<float, 4> result = {0.0f, 0.0f, 0.0f, 1.0f};
+
+	switch (format) {
+	case PixelFormat::R16G16B16A16Sfloat:
+		for (std::size_t i = 0; i < 4; i++) {
+			uint16_t half;
+			std::memcpy(&half, pixel + i * sizeof(uint16_t), sizeof(uint16_t));
+			result[i] = Bitmap::HalfToFloat(half);
+		}
+		break;
+	case PixelFormat::R32G32B32A32Sfloat:
+		std::memcpy(result.data(), pixel, sizeof(result));
+		break;
+	default:
+		for (uint32_t i = 0; i < PixelBlock::Get(format).bytes; i++)
+			result[i] = pixel[i] / 255.0f;
+		if (format == PixelFormat::R8G8B8A8Srgb) {
+			for (std::size_t i = 0; i < 3; i++)
+				result[i] = SrgbToLinear(result[i]);
+		}
+		break;
+	}
+
+	return result;
+}
+
+static void WritePixel(PixelFormat format, std::array<float, 4> value, uint8_t *pixel) {
+	switch (format) {
+	case PixelFormat::R16G16B16A16Sfloat:
+		for (std::size_t i = 0; i < 4; i++) {
+			auto half = Bitmap::FloatToHalf(value[i]);
+			std::memcpy(pixel + i * sizeof(uint16_t), &half, sizeof(uint16_t));
+		}
+		break;
+	case PixelFormat::R32G32B32A32Sfloat:
+		std::memcpy(pixel, value.data(), sizeof(value));
+		break;
+	default:
+		if (format == PixelFormat::R8G8B8A8Srgb) {
+			for (std::size_t i = 0; i < 3; i++)
+				value[i] = LinearToSrgb(std::clamp(value[i], 0.0f, 1.0f));
+		}
+		for (uint32_t i = 0; i < PixelBlock::Get(format).bytes; i++)
+			pixel[i] = static_cast<uint8_t>(std::lround(std::clamp(value[i], 0.0f, 1.0f) * 255.0f));
+		break;
+	}
+}
+
+std::unique_ptr<Bitmap> Bitmap::Convert(PixelFormat format) const {
+	if (!data || !IsConvertible(this->format) || !IsConvertible(format)) {
+		Log::Error("Bitmap ", filename, " can not be converted from format ", static_cast<uint32_t>(this->format), " to ", static_cast<uint32_t>(format), '\n');
+		return nullptr;
+	}
+
+	auto result = std::make_unique<Bitmap>(nullptr, size, format, mipLevels, arrayLayers);
+	result->SetFilename(filename);
+	result->SetData(std::make_unique<uint8_t[]>(result->GetLength()));
+
+	// Every level and layer holds the same pixels in both bitmaps, so they are converted in one pass.
+	auto sourceBytes = PixelBlock::Get(this->format).bytes;
+	auto resultBytes = PixelBlock::Get(format).bytes;
+	auto pixels = GetLength() / sourceBytes;
+	for (uint32_t i = 0; i < pixels; i++)
+		WritePixel(format, ReadPixel(this->format, data.get() + i * sourceBytes), result->GetData().get() + i * resultBytes);
+
+	return result;
+}
+
+bool Bitmap::IsConvertible(PixelFormat format) {
+	switch (format) {
+	case PixelFormat::R8Unorm:
+	case PixelFormat::R8G8Unorm:
+	case PixelFormat::R8G8B8Unorm:
+	case PixelFormat::R8G8B8A8Unorm:
+	case PixelFormat::R8G8B8A8Srgb:
+	case PixelFormat::R16G16B16A16Sfloat:
+	case PixelFormat::R32G32B32A32Sfloat:
+		return true;
+	default:
+		return false;
+	}
+}
+
+float Bitmap::HalfToFloat(uint16_t half) {
+	uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+	uint32_t exponent = (half >> 10) & 0x1f;
+	uint32_t mantissa = half & 0x3ff;
+	uint32_t bits;
+
+	if (exponent == 0x1f) {
+		// Infinity and NaN keep their mantissa.
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	} else if (exponent != 0) {
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	} else if (mantissa != 0) {
+		// Subnormal halves are normal floats, the mantissa is shifted up to its leading bit.
+		exponent = 113;
+		while (!(mantissa & 0x400)) {
+			mantissa <<= 1;
+			exponent--;
+		}
+		bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+	} else {
+		bits = sign;
+	}
+
+	float value;
+	std::memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
+uint16_t Bitmap::FloatToHalf(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(float));
+	auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+	auto exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 112;
+	uint32_t mantissa = bits & 0x7fffff;
+
+	if (exponent == 143)
+		return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+	if (exponent >= 0x1f)
+		return sign | 0x7c00;
+
+	uint32_t shift = 13;
+	if (exponent <= 0) {
+		// Values below the smallest normal half are stored subnormal, or as zero when too small.
+		if (exponent < -10)
+			return sign;
+		mantissa |= 0x800000;
+		shift = 14 - exponent;
+		exponent = 0;
+	}
+
+	// Rounds to the nearest, ties go to even. A carry out of the mantissa moves up the exponent.
+	uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> shift);
+	uint32_t remainder = mantissa & ((1u << shift) - 1);
+	uint32_t halfway = 1u << (shift - 1);
+	if (remainder > halfway || (remainder == halfway && (half & 1)))
+		half++;
+	return sign | static_cast<uint16_t>(half);
+}
+
+std::optional<uint32_t> Bitmap::CheckLayout(const Vector2ui &size, PixelFormat format, uint32_t mipLevels, uint32_t arrayLayers) {
+	auto block = PixelBlock::Get(format);
+	if (block.bytes == 0 || size.x == 0 || size.y == 0 || size.x > MaxSize || size.y > MaxSize || arrayLayers == 0)
+		return std::nullopt;
+
+	// Each level halves the last, so there are at most floor(log2(max(width, height))) + 1 levels.
+	uint32_t maxLevels = 1;
+	for (auto largest = std::max(size.x, size.y); largest > 1; largest >>= 1)
+		maxLevels++;
+	if (mipLevels == 0 || mipLevels > maxLevels)
+		return std::nullopt;
+
+	uint64_t length = 0;
+	for (uint32_t level = 0; level < mipLevels; level++) {
+		uint64_t blocksX = (std::max(size.x >> level, 1u) + block.width - 1) / block.width;
+		uint64_t blocksY = (std::max(size.y >> level, 1u) + block.height - 1) / block.height;
+		auto levelLength = blocksX * blocksY * block.bytes;
+		if (levelLength > (std::numeric_limits<uint32_t>::max() - length) / arrayLayers)
+			return std::nullopt;
+		length += levelLength * arrayLayers;
+	}
+
+	return static_cast<uint32_t>(length);
 }
 
 uint32_t Bitmap::GetLength() const {
-	return size.x * size.y * bytesPerPixel;
+	return GetLevelOffset(mipLevels);
+}
+
+Vector2ui Bitmap::GetLevelSize(uint32_t mipLevel) const {
+	// Shifting by the width of the size is undefined, every level past the 32nd is one pixel.
+	if (mipLevel >= 32)
+		return {1, 1};
+	return {std::max(size.x >> mipLevel, 1u), std::max(size.y >> mipLevel, 1u)};
+}
+
+uint32_t Bitmap::GetLevelOffset(uint32_t mipLevel) const {
+	uint32_t offset = 0;
+	for (uint32_t i = 0; i < mipLevel; i++)
+		offset += GetLevelLength(i);
+	return offset;
+}
+
+uint32_t Bitmap::GetLevelLength(uint32_t mipLevel) const {
+	auto levelSize = GetLevelSize(mipLevel);
+	if (PixelBlock::IsCompressed(format))
+		return PixelBlock::Get(format).GetLength(levelSize.x, levelSize.y) * arrayLayers;
+	return CalculateLength(levelSize, bytesPerPixel) * arrayLayers;
 }
 
 uint32_t Bitmap::CalculateLength(const Vector2ui &size, uint32_t bytesPerPixel) {
 	return size.x * size.y * bytesPerPixel;
 }
+
+PixelFormat Bitmap::FindFormat(uint32_t bytesPerPixel) {
+	switch (bytesPerPixel) {
+	case 1:
+		return PixelFormat::R8Unorm;
+	case 2:
+		return PixelFormat::R8G8Unorm;
+	case 3:
+		return PixelFormat::R8G8B8Unorm;
+	default:
+		return PixelFormat::R8G8B8A8Unorm;
+	}
+}
 }
@@ -2,8 +2,10 @@
 
 #include <unordered_map>
 #include <functional>
+#include <optional>
 
 #include "Maths/Vector2.hpp"
+#include "PixelFormat.hpp"
 
 namespace acid {
 template<typename Base>
@@ -32,21 +34,110 @@ public:
 	};
 };
 
+/**
+ * @brief Class that holds the pixels of a image. Data is stored one mip level after another, each level holds every array layer.
+ * Block compressed formats keep their blocks as loaded, so they can be uploaded without being decoded.
+ */
 class ACID_EXPORT Bitmap : public BitmapFactory<Bitmap> {
 public:
+	/// The largest width or height loaders accept.
+	static constexpr uint32_t MaxSize = 1 << 16;
+
 	Bitmap() = default;
 	explicit Bitmap(std::filesystem::path filename);
 	explicit Bitmap(const Vector2ui &size, uint32_t bytesPerPixel = 4);
 	Bitmap(std::unique_ptr<uint8_t[]> &&data, const Vector2ui &size, uint32_t bytesPerPixel = 4);
+	/**
+	 * Creates a new bitmap from pixels in a format.
+	 * @param data The pixels, every mip level and array layer.
+	 * @param size The size of the base mip level in pixels.
+	 * @param format The format of the pixels.
+	 * @param mipLevels The number of mip levels in the data.
+	 * @param arrayLayers The number of array layers in each mip level.
+	 */
+	Bitmap(std::unique_ptr<uint8_t[]> &&data, const Vector2ui &size, PixelFormat format, uint32_t mipLevels = 1, uint32_t arrayLayers = 1);
 	~Bitmap() = default;
 
+	/**
+	 * Loads the bitmap through the loader registered for the extension, files without a loader are decoded to 8 bit RGBA.
+	 * @param filename The file to load.
+	 */
 	void Load(const std::filesystem::path &filename);
+	/**
+	 * Writes the bitmap through the writer registered for the extension, files without a writer are written as PNGs.
+	 * @param filename The file to write.
+	 */
 	void Write(const std::filesystem::path &filename) const;
 
+	/**
+	 * Converts the pixels to another format, every mip level and array layer is converted.
+	 * Only 8 bit, 16 bit float and 32 bit float formats can be converted. Channels missing from the pixels are 0, with a alpha of 1.
+	 * @param format The format to convert to.
+	 * @return The converted bitmap, or nullptr if either format can not be converted.
+	 */
+	std::unique_ptr<Bitmap> Convert(PixelFormat format) const;
+
+	/**
+	 * Gets if the pixels of a format can be converted by {@link Bitmap#Convert}.
+	 * @param format The pixel format.
+	 * @return If the format can be converted.
+	 */
+	static bool IsConvertible(PixelFormat format);
+
+	/**
+	 * Converts a 16 bit float to a 32 bit float.
+	 * @param half The 16 bit float.
+	 * @return The 32 bit float.
+	 */
+	static float HalfToFloat(uint16_t half);
+
+	/**
+	 * Converts a 32 bit float to a 16 bit float, rounding to the nearest. Values too large become infinity.
+	 * @param value The 32 bit float.
+	 * @return The 16 bit float.
+	 */
+	static uint16_t FloatToHalf(float value);
+
+	/**
+	 * Checks a layout read from a file before it is trusted, the length is summed without overflowing.
+	 * Sizes must be at most {@link Bitmap#MaxSize}, with at least one mip level and no more than the largest side can be halved.
+	 * @param size The size of the base mip level in pixels.
+	 * @param format The format of the pixels.
+	 * @param mipLevels The number of mip levels.
+	 * @param arrayLayers The number of array layers in each mip level.
+	 * @return The length of the data in bytes, or std::nullopt if the layout is invalid or longer than a bitmap can hold.
+	 */
+	static std::optional<uint32_t> CheckLayout(const Vector2ui &size, PixelFormat format, uint32_t mipLevels, uint32_t arrayLayers);
+
 	explicit operator bool() const noexcept { return !data; }
 
+	/**
+	 * Gets the length of the data, every mip level and array layer.
+	 * @return The length in bytes.
+	 */
 	uint32_t GetLength() const;
 
+	/**
+	 * Gets the size of a mip level.
+	 * @param mipLevel The mip level.
+	 * @return The size in pixels.
+	 */
+	Vector2ui GetLevelSize(uint32_t mipLevel) const;
+
+	/**
+	 * Gets the offset into the data of a mip level.
+	 * @param mipLevel The mip level.
+	 * @return The offset in bytes.
+	 */
+	uint32_t GetLevelOffset(uint32_t mipLevel) const;
+
+	/**
+	 * Gets the length of a mip level, with every array layer.
+	 * @param mipLevel The mip level.
+	 * @return The length in bytes.
+	 */
+	uint32_t GetLevelLength(uint32_t mipLevel) const;
+
 	const std::filesystem::path &GetFilename() const { return filename; }
 	void SetFilename(const std::filesystem::path &filename) { this->filename = filename; }
 
@@ -60,13 +151,26 @@ public:
 	uint32_t GetBytesPerPixel() const { return bytesPerPixel; }
 	void SetBytesPerPixel(uint32_t bytesPerPixel) { this->bytesPerPixel = bytesPerPixel; }
 
+	PixelFormat GetFormat() const { return format; }
+	void SetFormat(PixelFormat format) { this->format = format; }
+
+	uint32_t GetMipLevels() const { return mipLevels; }
+	void SetMipLevels(uint32_t mipLevels) { this->mipLevels = mipLevels; }
+
+	uint32_t GetArrayLayers() const { return arrayLayers; }
+	void SetArrayLayers(uint32_t arrayLayers) { this->arrayLayers = arrayLayers; }
+
 private:
 	static uint32_t CalculateLength(const Vector2ui &size, uint32_t bytesPerPixel);
+	static PixelFormat FindFormat(uint32_t bytesPerPixel);
 	
 	std::filesystem::path filename;
 	std::unique_ptr<uint8_t[]> data;
 	Vector2ui size;
 	uint32_t bytesPerPixel = 0;
+	PixelFormat format = PixelFormat::R8G8B8A8Unorm;
+	uint32_t mipLevels = 1;
+	uint32_t arrayLayers = 1;
 };
 }
 
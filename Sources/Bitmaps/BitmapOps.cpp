@@ -0,0 +1,918 @@
+#include "BitmapOps.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Engine/Log.hpp"
+#include "Maths/Maths.hpp"
+#include "Utils/ThreadPool.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ACID_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ACID_TARGET(isa)
+#else
+#define ACID_TARGET(isa) __attribute__((target(isa)))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ACID_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace acid {
+/// Rows given to each task when spread across a thread pool.
+static constexpr std::size_t RowsPerTask = 32;
+/// Resampling weights are fixed point with this many fractional bits.
+static constexpr int32_t WeightBits = 14;
+static constexpr int32_t WeightOne = 1 << WeightBits;
+static constexpr int32_t WeightRound = 1 << (WeightBits - 1);
+/// Linear values below this encode to sRGB 0, the encode table covers the 13 exponents from here up to 1.
+static constexpr uint32_t MinLinearBits = (127 - 13) << 23;
+static constexpr uint32_t AlmostOneBits = 0x3f7fffff;
+
+/// The taps of a resampling filter along one axis, every output pixel reads the same number of source pixels.
+struct Taps {
+	uint32_t count = 0;
+	std::vector<uint32_t> first;
+	std::vector<int16_t> weights;
+};
+
+using SwizzleKernel = void(*)(const uint8_t *source, uint8_t *destination, std::size_t pixels, const uint8_t *order);
+using ExpandKernel = void(*)(const uint8_t *source, uint8_t *destination, std::size_t pixels, uint32_t channels);
+using PremultiplyKernel = void(*)(uint8_t *pixels, std::size_t count);
+using DecodeSrgbKernel = void(*)(const uint8_t *source, float *destination, std::size_t pixels);
+using EncodeSrgbKernel = void(*)(const float *source, uint8_t *destination, std::size_t pixels);
+using ResampleRowKernel = void(*)(const uint8_t *source, uint8_t *destination, const Taps &taps);
+using ResampleColumnKernel = void(*)(const uint8_t *const *rows, const int16_t *weights, uint32_t count, uint8_t *destination, std::size_t bytes);
+
+struct Kernels {
+	SwizzleKernel swizzle;
+	ExpandKernel expand;
+	PremultiplyKernel premultiply;
+	DecodeSrgbKernel decodeSrgb;
+	EncodeSrgbKernel encodeSrgb;
+	ResampleRowKernel resampleRow;
+	ResampleColumnKernel resampleColumn;
+};
+
+static float FromBits(uint32_t bits) {
+	float value;
+	std::memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
+static uint32_t ToBits(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(float));
+	return bits;
+}
+
+/**
+ * Gets the table 8 bit pixels are decoded with, the first 256 entries decode sRGB colour and the next 256 scale alpha.
+ * @return The table.
+ */
+static const std::array<float, 512> &DecodeTable() {
+	static const auto Table = [] {
+		std::array<float, 512> table;
+		for (uint32_t i = 0; i < 256; i++) {
+			auto c = static_cast<float>(i) / 255.0f;
+			table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			table[256 + i] = c;
+		}
+		return table;
+	}();
+	return Table;
+}
+
+/**
+ * Gets the table linear values are encoded to sRGB with. Each entry covers the 256 steps of the 8 mantissa bits after the exponent and top 3 bits,
+ * as a line fitted to the exact curve by least squares. The upper 16 bits hold the offset of the line and the lower 16 bits its slope.
+ * @return The table.
+ */
+static const std::array<uint32_t, 104> &EncodeTable() {
+	static const auto Table = [] {
+		std::array<uint32_t, 104> table;
+		for (uint32_t i = 0; i < table.size(); i++) {
+			double sumT = 0.0, sumY = 0.0, sumTT = 0.0, sumTY = 0.0;
+			for (uint32_t t = 0; t < 256; t++) {
+				auto value = static_cast<double>(FromBits(MinLinearBits + (i << 20) + (t << 12) + (1 << 11)));
+				auto y = 255.0 * (value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055);
+				sumT += t;
+				sumY += y;
+				sumTT += static_cast<double>(t) * t;
+				sumTY += t * y;
+			}
+
+			auto scale = (256.0 * sumTY - sumT * sumY) / (256.0 * sumTT - sumT * sumT);
+			auto bias = (sumY - scale * sumT) / 256.0;
+			auto scaleBits = static_cast<uint32_t>(std::lround(scale * 65536.0));
+			auto biasBits = static_cast<uint32_t>(std::lround((bias * 65536.0 + 32768.0) / 512.0));
+			table[i] = biasBits << 16 | scaleBits;
+		}
+		return table;
+	}();
+	return Table;
+}
+
+static uint8_t EncodeSrgb(float value, const uint32_t *table) {
+	// Comparisons are written so NaN clamps to the minimum, as the vector min and max do.
+	value = value > FromBits(MinLinearBits) ? value : FromBits(MinLinearBits);
+	value = value < FromBits(AlmostOneBits) ? value : FromBits(AlmostOneBits);
+	auto bits = ToBits(value);
+	auto entry = table[(bits - MinLinearBits) >> 20];
+	auto bias = (entry >> 16) << 9;
+	auto scale = entry & 0xffff;
+	auto t = (bits >> 12) & 0xff;
+	return static_cast<uint8_t>(std::min((bias + scale * t) >> 16, 255u));
+}
+
+static uint8_t EncodeUnorm(float value) {
+	value = value > 0.0f ? value : 0.0f;
+	value = value < 1.0f ? value : 1.0f;
+	return static_cast<uint8_t>(std::nearbyint(value * 255.0f));
+}
+
+static uint8_t ClampWeighted(int32_t sum) {
+	return static_cast<uint8_t>(std::clamp(sum >> WeightBits, 0, 255));
+}
+
+static void SwizzleScalar(const uint8_t *source, uint8_t *destination, std::size_t pixels, const uint8_t *order) {
+	for (std::size_t i = 0; i < pixels; i++) {
+		uint8_t pixel[4];
+		std::memcpy(pixel, source + i * 4, 4);
+		for (std::size_t c = 0; c < 4; c++)
+			destination[i * 4 + c] = pixel[order[c]];
+	}
+}
+
+static void ExpandScalar(const uint8_t *source, uint8_t *destination, std::size_t pixels, uint32_t channels) {
+	for (std::size_t i = 0; i < pixels; i++) {
+		for (uint32_t c = 0; c < 3; c++)
+			destination[i * 4 + c] = c < channels ? source[i * channels + c] : 0;
+		destination[i * 4 + 3] = 255;
+	}
+}
+
+static void PremultiplyScalar(uint8_t *pixels, std::size_t count) {
+	for (std::size_t i = 0; i < count; i++) {
+		auto alpha = pixels[i * 4 + 3];
+		for (std::size_t c = 0; c < 3; c++) {
+			// Divides by 255 rounding to the nearest, exactly for every product of two bytes.
+			uint32_t product = pixels[i * 4 + c] * alpha + 128;
+			pixels[i * 4 + c] = static_cast<uint8_t>((product + (product >> 8)) >> 8);
+		}
+	}
+}
+
+static void DecodeSrgbScalar(const uint8_t *source, float *destination, std::size_t pixels) {
+	const auto &table = DecodeTable();
+	for (std::size_t i = 0; i < pixels * 4; i++)
+		destination[i] = table[(i % 4 == 3 ? 256 : 0) + source[i]];
+}
+
+static void EncodeSrgbScalar(const float *source, uint8_t *destination, std::size_t pixels) {
+	auto table = EncodeTable().data();
+	for (std::size_t i = 0; i < pixels * 4; i++)
+		destination[i] = i % 4 == 3 ? EncodeUnorm(source[i]) : EncodeSrgb(source[i], table);
+}
+
+static void ResampleRowScalar(const uint8_t *source, uint8_t *destination, const Taps &taps) {
+	for (std::size_t x = 0; x < taps.first.size(); x++) {
+		auto pixels = source + taps.first[x] * 4;
+		auto weights = taps.weights.data() + x * taps.count;
+		int32_t sum[4] = {WeightRound, WeightRound, WeightRound, WeightRound};
+		for (uint32_t k = 0; k < taps.count; k++) {
+			for (std::size_t c = 0; c < 4; c++)
+				sum[c] += pixels[k * 4 + c] * weights[k];
+		}
+		for (std::size_t c = 0; c < 4; c++)
+			destination[x * 4 + c] = ClampWeighted(sum[c]);
+	}
+}
+
+static void ResampleColumnScalar(const uint8_t *const *rows, const int16_t *weights, uint32_t count, uint8_t *destination, std::size_t bytes) {
+	for (std::size_t i = 0; i < bytes; i++) {
+		auto sum = WeightRound;
+		for (uint32_t k = 0; k < count; k++)
+			sum += rows[k][i] * weights[k];
+		destination[i] = ClampWeighted(sum);
+	}
+}
+
+#if defined(ACID_SIMD_X86)
+ACID_TARGET("sse4.1")
+static void SwizzleSse41(const uint8_t *source, uint8_t *destination, std::size_t pixels, const uint8_t *order) {
+	alignas(16) uint8_t mask[16];
+	for (std::size_t i = 0; i < 16; i++)
+		mask[i] = static_cast<uint8_t>(i / 4 * 4 + order[i % 4]);
+	auto shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+
+	std::size_t i = 0;
+	for (; i + 4 <= pixels; i += 4)
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * 4), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 4)), shuffle));
+	SwizzleScalar(source + i * 4, destination + i * 4, pixels - i, order);
+}
+
+/**
+ * Creates the shuffle that expands four pixels of one to three channels into RGBA, channels that are not read are zeroed.
+ */
+static void ExpandMask(uint32_t channels, uint8_t *mask) {
+	for (uint32_t i = 0; i < 16; i++)
+		mask[i] = i % 4 < channels && i % 4 != 3 ? static_cast<uint8_t>(i / 4 * channels + i % 4) : 0x80;
+}
+
+ACID_TARGET("sse4.1")
+static void ExpandSse41(const uint8_t *source, uint8_t *destination, std::size_t pixels, uint32_t channels) {
+	alignas(16) uint8_t mask[16];
+	ExpandMask(channels, mask);
+	auto shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+	auto alpha = _mm_set1_epi32(static_cast<int32_t>(0xff000000));
+
+	// Each load reads 16 bytes for four pixels, so it stops before reading past the source.
+	std::size_t i = 0;
+	for (; i * channels + 16 <= pixels * channels; i += 4) {
+		auto expanded = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * channels)), shuffle);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * 4), _mm_or_si128(expanded, alpha));
+	}
+	ExpandScalar(source + i * channels, destination + i * 4, pixels - i, channels);
+}
+
+ACID_TARGET("sse4.1")
+static __m128i PremultiplyHalf(__m128i pixels) {
+	auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	auto product = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+ACID_TARGET("sse4.1")
+static void PremultiplySse41(uint8_t *pixels, std::size_t count) {
+	auto alphaMask = _mm_set1_epi32(static_cast<int32_t>(0xff000000));
+	auto zero = _mm_setzero_si128();
+
+	std::size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		auto source = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i * 4));
+		auto result = _mm_packus_epi16(PremultiplyHalf(_mm_unpacklo_epi8(source, zero)), PremultiplyHalf(_mm_unpackhi_epi8(source, zero)));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i * 4), _mm_blendv_epi8(result, source, alphaMask));
+	}
+	PremultiplyScalar(pixels + i * 4, count - i);
+}
+
+ACID_TARGET("sse4.1")
+static void EncodeSrgbSse41(const float *source, uint8_t *destination, std::size_t pixels) {
+	auto table = EncodeTable().data();
+	auto minLinear = _mm_castsi128_ps(_mm_set1_epi32(MinLinearBits));
+	auto almostOne = _mm_castsi128_ps(_mm_set1_epi32(AlmostOneBits));
+
+	for (std::size_t i = 0; i < pixels; i++) {
+		auto value = _mm_loadu_ps(source + i * 4);
+		// The second operand is returned when the first is NaN, so NaN clamps to the minimum.
+		auto bits = _mm_castps_si128(_mm_min_ps(_mm_max_ps(value, minLinear), almostOne));
+		auto index = _mm_srli_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(MinLinearBits)), 20);
+		auto entry = _mm_setr_epi32(table[_mm_extract_epi32(index, 0)], table[_mm_extract_epi32(index, 1)], table[_mm_extract_epi32(index, 2)],
+			table[_mm_extract_epi32(index, 3)]);
+		auto bias = _mm_slli_epi32(_mm_srli_epi32(entry, 16), 9);
+		auto scale = _mm_and_si128(entry, _mm_set1_epi32(0xffff));
+		auto t = _mm_and_si128(_mm_srli_epi32(bits, 12), _mm_set1_epi32(0xff));
+		auto colour = _mm_min_epu32(_mm_srli_epi32(_mm_add_epi32(bias, _mm_mullo_epi32(scale, t)), 16), _mm_set1_epi32(255));
+
+		auto alpha = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f)), _mm_set1_ps(255.0f)));
+		auto result = _mm_blend_epi16(colour, alpha, 0xc0);
+		auto packed = _mm_packus_epi16(_mm_packus_epi32(result, result), result);
+		auto word = _mm_cvtsi128_si32(packed);
+		std::memcpy(destination + i * 4, &word, 4);
+	}
+}
+
+ACID_TARGET("sse4.1")
+static void ResampleRowSse41(const uint8_t *source, uint8_t *destination, const Taps &taps) {
+	for (std::size_t x = 0; x < taps.first.size(); x++) {
+		auto pixels = source + taps.first[x] * 4;
+		auto weights = taps.weights.data() + x * taps.count;
+		auto sum = _mm_set1_epi32(WeightRound);
+		for (uint32_t k = 0; k < taps.count; k++) {
+			int32_t pixel;
+			std::memcpy(&pixel, pixels + k * 4, 4);
+			sum = _mm_add_epi32(sum, _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(pixel)), _mm_set1_epi32(weights[k])));
+		}
+		sum = _mm_srai_epi32(sum, WeightBits);
+		auto word = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(sum, sum), sum));
+		std::memcpy(destination + x * 4, &word, 4);
+	}
+}
+
+ACID_TARGET("sse4.1")
+static void ResampleColumnSse41(const uint8_t *const *rows, const int16_t *weights, uint32_t count, uint8_t *destination, std::size_t bytes) {
+	std::size_t i = 0;
+	for (; i + 16 <= bytes; i += 16) {
+		__m128i sums[4];
+		for (auto &sum : sums)
+			sum = _mm_set1_epi32(WeightRound);
+		for (uint32_t k = 0; k < count; k++) {
+			auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[k] + i));
+			auto weight = _mm_set1_epi32(weights[k]);
+			sums[0] = _mm_add_epi32(sums[0], _mm_mullo_epi32(_mm_cvtepu8_epi32(pixels), weight));
+			sums[1] = _mm_add_epi32(sums[1], _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(pixels, 4)), weight));
+			sums[2] = _mm_add_epi32(sums[2], _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(pixels, 8)), weight));
+			sums[3] = _mm_add_epi32(sums[3], _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(pixels, 12)), weight));
+		}
+		auto low = _mm_packs_epi32(_mm_srai_epi32(sums[0], WeightBits), _mm_srai_epi32(sums[1], WeightBits));
+		auto high = _mm_packs_epi32(_mm_srai_epi32(sums[2], WeightBits), _mm_srai_epi32(sums[3], WeightBits));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_packus_epi16(low, high));
+	}
+
+	if (i < bytes) {
+		std::vector<const uint8_t *> offsetRows(count);
+		for (uint32_t k = 0; k < count; k++)
+			offsetRows[k] = rows[k] + i;
+		ResampleColumnScalar(offsetRows.data(), weights, count, destination + i, bytes - i);
+	}
+}
+
+ACID_TARGET("avx2")
+static void SwizzleAvx2(const uint8_t *source, uint8_t *destination, std::size_t pixels, const uint8_t *order) {
+	alignas(16) uint8_t mask[16];
+	for (std::size_t i = 0; i < 16; i++)
+		mask[i] = static_cast<uint8_t>(i / 4 * 4 + order[i % 4]);
+	// Shuffles do not cross the two 128 bit lanes, which is fine as no pixel does either.
+	auto shuffle = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(mask)));
+
+	std::size_t i = 0;
+	for (; i + 8 <= pixels; i += 8) {
+		auto shuffled = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i * 4)), shuffle);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i * 4), shuffled);
+	}
+	SwizzleScalar(source + i * 4, destination + i * 4, pixels - i, order);
+}
+
+ACID_TARGET("avx2")
+static void ExpandAvx2(const uint8_t *source, uint8_t *destination, std::size_t pixels, uint32_t channels) {
+	alignas(16) uint8_t mask[16];
+	ExpandMask(channels, mask);
+	auto shuffle = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(mask)));
+	auto alpha = _mm256_set1_epi32(static_cast<int32_t>(0xff000000));
+
+	// Four pixels are loaded into each lane, the second load reads 16 bytes from the fifth pixel.
+	std::size_t i = 0;
+	for (; (i + 4) * channels + 16 <= pixels * channels; i += 8) {
+		auto low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * channels));
+		auto high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + (i + 4) * channels));
+		auto expanded = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), shuffle);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i * 4), _mm256_or_si256(expanded, alpha));
+	}
+	ExpandScalar(source + i * channels, destination + i * 4, pixels - i, channels);
+}
+
+ACID_TARGET("avx2")
+static __m256i PremultiplyHalfAvx2(__m256i pixels) {
+	auto alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	auto product = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha), _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+ACID_TARGET("avx2")
+static void PremultiplyAvx2(uint8_t *pixels, std::size_t count) {
+	auto alphaMask = _mm256_set1_epi32(static_cast<int32_t>(0xff000000));
+	auto zero = _mm256_setzero_si256();
+
+	// Unpacking and packing both stay within lanes, so pixels come back in order.
+	std::size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		auto source = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + i * 4));
+		auto result = _mm256_packus_epi16(PremultiplyHalfAvx2(_mm256_unpacklo_epi8(source, zero)), PremultiplyHalfAvx2(_mm256_unpackhi_epi8(source, zero)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(pixels + i * 4), _mm256_blendv_epi8(result, source, alphaMask));
+	}
+	PremultiplyScalar(pixels + i * 4, count - i);
+}
+
+ACID_TARGET("avx2")
+static void DecodeSrgbAvx2(const uint8_t *source, float *destination, std::size_t pixels) {
+	auto table = DecodeTable().data();
+	auto alphaOffset = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+
+	std::size_t i = 0;
+	for (; i + 2 <= pixels; i += 2) {
+		auto index = _mm256_add_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + i * 4))), alphaOffset);
+		_mm256_storeu_ps(destination + i * 4, _mm256_i32gather_ps(table, index, 4));
+	}
+	DecodeSrgbScalar(source + i * 4, destination + i * 4, pixels - i);
+}
+
+ACID_TARGET("avx2")
+static void EncodeSrgbAvx2(const float *source, uint8_t *destination, std::size_t pixels) {
+	auto table = reinterpret_cast<const int32_t *>(EncodeTable().data());
+	auto minLinear = _mm256_castsi256_ps(_mm256_set1_epi32(MinLinearBits));
+	auto almostOne = _mm256_castsi256_ps(_mm256_set1_epi32(AlmostOneBits));
+
+	std::size_t i = 0;
+	for (; i + 2 <= pixels; i += 2) {
+		auto value = _mm256_loadu_ps(source + i * 4);
+		auto bits = _mm256_castps_si256(_mm256_min_ps(_mm256_max_ps(value, minLinear), almostOne));
+		auto index = _mm256_srli_epi32(_mm256_sub_epi32(bits, _mm256_set1_epi32(MinLinearBits)), 20);
+		auto entry = _mm256_i32gather_epi32(table, index, 4);
+		auto bias = _mm256_slli_epi32(_mm256_srli_epi32(entry, 16), 9);
+		auto scale = _mm256_and_si256(entry, _mm256_set1_epi32(0xffff));
+		auto t = _mm256_and_si256(_mm256_srli_epi32(bits, 12), _mm256_set1_epi32(0xff));
+		auto colour = _mm256_min_epu32(_mm256_srli_epi32(_mm256_add_epi32(bias, _mm256_mullo_epi32(scale, t)), 16), _mm256_set1_epi32(255));
+
+		auto alpha = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f)), _mm256_set1_ps(255.0f)));
+		auto result = _mm256_blend_epi32(colour, alpha, 0x88);
+		auto words = _mm_packus_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(destination + i * 4), _mm_packus_epi16(words, words));
+	}
+	EncodeSrgbScalar(source + i * 4, destination + i * 4, pixels - i);
+}
+
+ACID_TARGET("avx2")
+static void ResampleRowAvx2(const uint8_t *source, uint8_t *destination, const Taps &taps) {
+	for (std::size_t x = 0; x < taps.first.size(); x++) {
+		auto pixels = source + taps.first[x] * 4;
+		auto weights = taps.weights.data() + x * taps.count;
+
+		// Taps are taken two at a time, one in each lane, and the lanes added at the end.
+		auto sum = _mm256_setzero_si256();
+		uint32_t k = 0;
+		for (; k + 2 <= taps.count; k += 2) {
+			auto pair = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pixels + k * 4)));
+			auto weight = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi32(weights[k])), _mm_set1_epi32(weights[k + 1]), 1);
+			sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(pair, weight));
+		}
+
+		auto total = _mm_add_epi32(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)), _mm_set1_epi32(WeightRound));
+		if (k < taps.count) {
+			int32_t pixel;
+			std::memcpy(&pixel, pixels + k * 4, 4);
+			total = _mm_add_epi32(total, _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(pixel)), _mm_set1_epi32(weights[k])));
+		}
+
+		total = _mm_srai_epi32(total, WeightBits);
+		auto word = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(total, total), total));
+		std::memcpy(destination + x * 4, &word, 4);
+	}
+}
+
+ACID_TARGET("avx2")
+static void ResampleColumnAvx2(const uint8_t *const *rows, const int16_t *weights, uint32_t count, uint8_t *destination, std::size_t bytes) {
+	std::size_t i = 0;
+	for (; i + 16 <= bytes; i += 16) {
+		auto low = _mm256_set1_epi32(WeightRound);
+		auto high = _mm256_set1_epi32(WeightRound);
+		for (uint32_t k = 0; k < count; k++) {
+			auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[k] + i));
+			auto weight = _mm256_set1_epi32(weights[k]);
+			low = _mm256_add_epi32(low, _mm256_mullo_epi32(_mm256_cvtepu8_epi32(pixels), weight));
+			high = _mm256_add_epi32(high, _mm256_mullo_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(pixels, 8)), weight));
+		}
+		low = _mm256_srai_epi32(low, WeightBits);
+		high = _mm256_srai_epi32(high, WeightBits);
+		auto lowWords = _mm_packs_epi32(_mm256_castsi256_si128(low), _mm256_extracti128_si256(low, 1));
+		auto highWords = _mm_packs_epi32(_mm256_castsi256_si128(high), _mm256_extracti128_si256(high, 1));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_packus_epi16(lowWords, highWords));
+	}
+
+	if (i < bytes) {
+		std::vector<const uint8_t *> offsetRows(count);
+		for (uint32_t k = 0; k < count; k++)
+			offsetRows[k] = rows[k] + i;
+		ResampleColumnScalar(offsetRows.data(), weights, count, destination + i, bytes - i);
+	}
+}
+#elif defined(ACID_SIMD_NEON)
+static void SwizzleNeon(const uint8_t *source, uint8_t *destination, std::size_t pixels, const uint8_t *order) {
+	uint8_t mask[16];
+	for (std::size_t i = 0; i < 16; i++)
+		mask[i] = static_cast<uint8_t>(i / 4 * 4 + order[i % 4]);
+	auto shuffle = vld1q_u8(mask);
+
+	std::size_t i = 0;
+	for (; i + 4 <= pixels; i += 4)
+		vst1q_u8(destination + i * 4, vqtbl1q_u8(vld1q_u8(source + i * 4), shuffle));
+	SwizzleScalar(source + i * 4, destination + i * 4, pixels - i, order);
+}
+
+static void ExpandNeon(const uint8_t *source, uint8_t *destination, std::size_t pixels, uint32_t channels) {
+	// Indices out of the table read as zero.
+	uint8_t mask[16];
+	for (uint32_t i = 0; i < 16; i++)
+		mask[i] = i % 4 < channels && i % 4 != 3 ? static_cast<uint8_t>(i / 4 * channels + i % 4) : 0xff;
+	auto shuffle = vld1q_u8(mask);
+	auto alpha = vreinterpretq_u8_u32(vdupq_n_u32(0xff000000));
+
+	std::size_t i = 0;
+	for (; i * channels + 16 <= pixels * channels; i += 4)
+		vst1q_u8(destination + i * 4, vorrq_u8(vqtbl1q_u8(vld1q_u8(source + i * channels), shuffle), alpha));
+	ExpandScalar(source + i * channels, destination + i * 4, pixels - i, channels);
+}
+
+static uint8x16_t PremultiplyChannel(uint8x16_t channel, uint8x16_t alpha) {
+	auto round = vdupq_n_u16(128);
+	auto low = vaddq_u16(vmull_u8(vget_low_u8(channel), vget_low_u8(alpha)), round);
+	auto high = vaddq_u16(vmull_high_u8(channel, alpha), round);
+	return vcombine_u8(vshrn_n_u16(vaddq_u16(low, vshrq_n_u16(low, 8)), 8), vshrn_n_u16(vaddq_u16(high, vshrq_n_u16(high, 8)), 8));
+}
+
+static void PremultiplyNeon(uint8_t *pixels, std::size_t count) {
+	// Pixels are loaded split into a register per channel.
+	std::size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		auto channels = vld4q_u8(pixels + i * 4);
+		channels.val[0] = PremultiplyChannel(channels.val[0], channels.val[3]);
+		channels.val[1] = PremultiplyChannel(channels.val[1], channels.val[3]);
+		channels.val[2] = PremultiplyChannel(channels.val[2], channels.val[3]);
+		vst4q_u8(pixels + i * 4, channels);
+	}
+	PremultiplyScalar(pixels + i * 4, count - i);
+}
+
+static void EncodeSrgbNeon(const float *source, uint8_t *destination, std::size_t pixels) {
+	auto table = EncodeTable().data();
+	auto minLinear = vreinterpretq_f32_u32(vdupq_n_u32(MinLinearBits));
+	auto almostOne = vreinterpretq_f32_u32(vdupq_n_u32(AlmostOneBits));
+	const uint32_t alphaLanes[4] = {0, 0, 0, 0xffffffff};
+	auto alphaMask = vld1q_u32(alphaLanes);
+
+	for (std::size_t i = 0; i < pixels; i++) {
+		auto value = vld1q_f32(source + i * 4);
+		// The number is returned when one operand is NaN, so NaN clamps to the minimum.
+		auto bits = vreinterpretq_u32_f32(vminnmq_f32(vmaxnmq_f32(value, minLinear), almostOne));
+		auto index = vshrq_n_u32(vsubq_u32(bits, vdupq_n_u32(MinLinearBits)), 20);
+		const uint32_t entries[4] = {table[vgetq_lane_u32(index, 0)], table[vgetq_lane_u32(index, 1)], table[vgetq_lane_u32(index, 2)],
+			table[vgetq_lane_u32(index, 3)]};
+		auto entry = vld1q_u32(entries);
+		auto bias = vshlq_n_u32(vshrq_n_u32(entry, 16), 9);
+		auto scale = vandq_u32(entry, vdupq_n_u32(0xffff));
+		auto t = vandq_u32(vshrq_n_u32(bits, 12), vdupq_n_u32(0xff));
+		auto colour = vminq_u32(vshrq_n_u32(vmlaq_u32(bias, scale, t), 16), vdupq_n_u32(255));
+
+		auto alpha = vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_f32(vminnmq_f32(vmaxnmq_f32(value, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f)), vdupq_n_f32(255.0f))));
+		auto result = vmovn_u16(vcombine_u16(vmovn_u32(vbslq_u32(alphaMask, alpha, colour)), vdup_n_u16(0)));
+		vst1_lane_u32(reinterpret_cast<uint32_t *>(destination + i * 4), vreinterpret_u32_u8(result), 0);
+	}
+}
+
+static void ResampleRowNeon(const uint8_t *source, uint8_t *destination, const Taps &taps) {
+	for (std::size_t x = 0; x < taps.first.size(); x++) {
+		auto pixels = source + taps.first[x] * 4;
+		auto weights = taps.weights.data() + x * taps.count;
+		auto sum = vdupq_n_s32(WeightRound);
+		for (uint32_t k = 0; k < taps.count; k++) {
+			uint32_t pixel;
+			std::memcpy(&pixel, pixels + k * 4, 4);
+			auto widened = vreinterpret_s16_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(pixel)))));
+			sum = vmlal_n_s16(sum, widened, weights[k]);
+		}
+		auto narrowed = vqmovn_u16(vcombine_u16(vqmovun_s32(vshrq_n_s32(sum, WeightBits)), vdup_n_u16(0)));
+		vst1_lane_u32(reinterpret_cast<uint32_t *>(destination + x * 4), vreinterpret_u32_u8(narrowed), 0);
+	}
+}
+
+static void ResampleColumnNeon(const uint8_t *const *rows, const int16_t *weights, uint32_t count, uint8_t *destination, std::size_t bytes) {
+	std::size_t i = 0;
+	for (; i + 16 <= bytes; i += 16) {
+		int32x4_t sums[4];
+		for (auto &sum : sums)
+			sum = vdupq_n_s32(WeightRound);
+		for (uint32_t k = 0; k < count; k++) {
+			auto pixels = vld1q_u8(rows[k] + i);
+			auto low = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(pixels)));
+			auto high = vreinterpretq_s16_u16(vmovl_high_u8(pixels));
+			sums[0] = vmlal_n_s16(sums[0], vget_low_s16(low), weights[k]);
+			sums[1] = vmlal_n_s16(sums[1], vget_high_s16(low), weights[k]);
+			sums[2] = vmlal_n_s16(sums[2], vget_low_s16(high), weights[k]);
+			sums[3] = vmlal_n_s16(sums[3], vget_high_s16(high), weights[k]);
+		}
+		auto low = vcombine_u16(vqmovun_s32(vshrq_n_s32(sums[0], WeightBits)), vqmovun_s32(vshrq_n_s32(sums[1], WeightBits)));
+		auto high = vcombine_u16(vqmovun_s32(vshrq_n_s32(sums[2], WeightBits)), vqmovun_s32(vshrq_n_s32(sums[3], WeightBits)));
+		vst1q_u8(destination + i, vcombine_u8(vqmovn_u16(low), vqmovn_u16(high)));
+	}
+
+	if (i < bytes) {
+		std::vector<const uint8_t *> offsetRows(count);
+		for (uint32_t k = 0; k < count; k++)
+			offsetRows[k] = rows[k] + i;
+		ResampleColumnScalar(offsetRows.data(), weights, count, destination + i, bytes - i);
+	}
+}
+#endif
+
+static BitmapOps::Simd DetectSimd() {
+#if defined(ACID_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+	int32_t info[4];
+	__cpuid(info, 0);
+	auto maxLeaf = info[0];
+	__cpuid(info, 1);
+	auto sse41 = (info[2] & (1 << 19)) != 0;
+	// AVX2 also needs the OS to save the upper halves of registers.
+	auto avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+	auto avx2 = false;
+	if (avx && maxLeaf >= 7) {
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#else
+	__builtin_cpu_init();
+	auto sse41 = __builtin_cpu_supports("sse4.1") != 0;
+	auto avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+	return avx2 ? BitmapOps::Simd::Avx2 : sse41 ? BitmapOps::Simd::Sse41 : BitmapOps::Simd::Scalar;
+#elif defined(ACID_SIMD_NEON)
+	return BitmapOps::Simd::Neon;
+#else
+	return BitmapOps::Simd::Scalar;
+#endif
+}
+
+static std::atomic<BitmapOps::Simd> &CurrentSimd() {
+	static std::atomic<BitmapOps::Simd> simd(BitmapOps::GetSupportedSimd());
+	return simd;
+}
+
+static const Kernels &GetKernels() {
+	static constexpr Kernels Scalar = {SwizzleScalar, ExpandScalar, PremultiplyScalar, DecodeSrgbScalar, EncodeSrgbScalar, ResampleRowScalar, ResampleColumnScalar};
+#if defined(ACID_SIMD_X86)
+	// Without gathers the decode table is read one value at a time either way.
+	static constexpr Kernels Sse41 = {SwizzleSse41, ExpandSse41, PremultiplySse41, DecodeSrgbScalar, EncodeSrgbSse41, ResampleRowSse41, ResampleColumnSse41};
+	static constexpr Kernels Avx2 = {SwizzleAvx2, ExpandAvx2, PremultiplyAvx2, DecodeSrgbAvx2, EncodeSrgbAvx2, ResampleRowAvx2, ResampleColumnAvx2};
+#elif defined(ACID_SIMD_NEON)
+	static constexpr Kernels Neon = {SwizzleNeon, ExpandNeon, PremultiplyNeon, DecodeSrgbScalar, EncodeSrgbNeon, ResampleRowNeon, ResampleColumnNeon};
+#endif
+
+	switch (CurrentSimd().load()) {
+#if defined(ACID_SIMD_X86)
+	case BitmapOps::Simd::Sse41:
+		return Sse41;
+	case BitmapOps::Simd::Avx2:
+		return Avx2;
+#elif defined(ACID_SIMD_NEON)
+	case BitmapOps::Simd::Neon:
+		return Neon;
+#endif
+	default:
+		return Scalar;
+	}
+}
+
+/**
+ * Runs a function over runs of a range, spread across a thread pool when one is given.
+ */
+template<typename F>
+static void ForRange(ThreadPool *threadPool, std::size_t count, std::size_t grainSize, F &&f) {
+	if (threadPool)
+		threadPool->ParallelFor(0, count, grainSize, std::forward<F>(f));
+	else if (count > 0)
+		f(0, count);
+}
+
+static bool IsRgba8(const Bitmap &bitmap) {
+	return bitmap.GetData() && (bitmap.GetFormat() == PixelFormat::R8G8B8A8Unorm || bitmap.GetFormat() == PixelFormat::R8G8B8A8Srgb);
+}
+
+static std::size_t GetPixelGrain(const Bitmap &bitmap) {
+	return std::max<std::size_t>(bitmap.GetSize().x, 1) * RowsPerTask;
+}
+
+static float BoxKernel(double x) {
+	return x > -0.5 && x <= 0.5 ? 1.0f : 0.0f;
+}
+
+static double Sinc(double x) {
+	if (x == 0.0)
+		return 1.0;
+	x *= Maths::PI<double>;
+	return std::sin(x) / x;
+}
+
+static double LanczosKernel(double x) {
+	return std::abs(x) < 3.0 ? Sinc(x) * Sinc(x / 3.0) : 0.0;
+}
+
+/**
+ * Creates the taps that resample one axis, the filter is widened when shrinking so every source pixel is covered.
+ * @param sourceSize The number of source pixels.
+ * @param size The number of resampled pixels.
+ * @param filter The filter.
+ * @return The taps.
+ */
+static Taps CreateTaps(uint32_t sourceSize, uint32_t size, BitmapOps::Filter filter) {
+	auto scale = static_cast<double>(sourceSize) / size;
+	auto filterScale = std::max(scale, 1.0);
+	auto support = (filter == BitmapOps::Filter::Box ? 0.5 : 3.0) * filterScale;
+
+	Taps taps;
+	taps.count = std::min(static_cast<uint32_t>(std::ceil(support)) * 2 + 1, sourceSize);
+	taps.first.resize(size);
+	taps.weights.resize(static_cast<std::size_t>(size) * taps.count);
+	std::vector<double> weights(taps.count);
+
+	for (uint32_t x = 0; x < size; x++) {
+		auto center = (x + 0.5) * scale;
+		auto begin = std::max<int64_t>(static_cast<int64_t>(center - support + 0.5), 0);
+		auto end = std::min<int64_t>(static_cast<int64_t>(center + support + 0.5), sourceSize);
+		// Taps near the end are moved back so every tap reads inside the source, taps outside the filter weigh nothing.
+		auto first = std::min<int64_t>(begin, sourceSize - taps.count);
+
+		auto total = 0.0;
+		for (uint32_t k = 0; k < taps.count; k++) {
+			auto i = first + k;
+			auto offset = (i - center + 0.5) / filterScale;
+			weights[k] = i >= begin && i < end ? filter == BitmapOps::Filter::Box ? BoxKernel(offset) : LanczosKernel(offset) : 0.0;
+			total += weights[k];
+		}
+
+		// The rounding error of fixed point weights is given to the largest, so they sum to exactly one.
+		auto fixed = taps.weights.data() + static_cast<std::size_t>(x) * taps.count;
+		int32_t sum = 0;
+		uint32_t largest = 0;
+		for (uint32_t k = 0; k < taps.count; k++) {
+			fixed[k] = static_cast<int16_t>(total != 0.0 ? std::lround(weights[k] / total * WeightOne) : 0);
+			sum += fixed[k];
+			if (fixed[k] > fixed[largest])
+				largest = k;
+		}
+		fixed[largest] = static_cast<int16_t>(fixed[largest] + WeightOne - sum);
+		taps.first[x] = static_cast<uint32_t>(first);
+	}
+
+	return taps;
+}
+
+void BitmapOps::Swizzle(Bitmap &bitmap, const std::array<uint8_t, 4> &order, ThreadPool *threadPool) {
+	if (!IsRgba8(bitmap) || std::any_of(order.begin(), order.end(), [](uint8_t channel) { return channel > 3; })) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " can not be swizzled, it must be 8 bit RGBA\n");
+		return;
+	}
+
+	auto kernel = GetKernels().swizzle;
+	auto pixels = bitmap.GetData().get();
+	ForRange(threadPool, bitmap.GetLength() / 4, GetPixelGrain(bitmap), [&](std::size_t begin, std::size_t end) {
+		kernel(pixels + begin * 4, pixels + begin * 4, end - begin, order.data());
+	});
+}
+
+std::unique_ptr<Bitmap> BitmapOps::ExpandToRgba(const Bitmap &bitmap, ThreadPool *threadPool) {
+	uint32_t channels = 0;
+	switch (bitmap.GetFormat()) {
+	case PixelFormat::R8Unorm:
+		channels = 1;
+		break;
+	case PixelFormat::R8G8Unorm:
+		channels = 2;
+		break;
+	case PixelFormat::R8G8B8Unorm:
+		channels = 3;
+		break;
+	default:
+		break;
+	}
+
+	if (!bitmap.GetData() || channels == 0) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " can not be expanded to RGBA from format ", static_cast<uint32_t>(bitmap.GetFormat()), '\n');
+		return nullptr;
+	}
+
+	auto result = std::make_unique<Bitmap>(nullptr, bitmap.GetSize(), PixelFormat::R8G8B8A8Unorm, bitmap.GetMipLevels(), bitmap.GetArrayLayers());
+	result->SetFilename(bitmap.GetFilename());
+	result->SetData(std::make_unique<uint8_t[]>(result->GetLength()));
+
+	auto kernel = GetKernels().expand;
+	auto source = bitmap.GetData().get();
+	auto destination = result->GetData().get();
+	ForRange(threadPool, bitmap.GetLength() / channels, GetPixelGrain(bitmap), [&](std::size_t begin, std::size_t end) {
+		kernel(source + begin * channels, destination + begin * 4, end - begin, channels);
+	});
+	return result;
+}
+
+std::unique_ptr<Bitmap> BitmapOps::SrgbToLinear(const Bitmap &bitmap, ThreadPool *threadPool) {
+	if (!IsRgba8(bitmap)) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " can not be decoded from sRGB, it must be 8 bit RGBA\n");
+		return nullptr;
+	}
+
+	auto result = std::make_unique<Bitmap>(nullptr, bitmap.GetSize(), PixelFormat::R32G32B32A32Sfloat, bitmap.GetMipLevels(), bitmap.GetArrayLayers());
+	result->SetFilename(bitmap.GetFilename());
+	result->SetData(std::make_unique<uint8_t[]>(result->GetLength()));
+
+	auto kernel = GetKernels().decodeSrgb;
+	auto source = bitmap.GetData().get();
+	auto destination = reinterpret_cast<float *>(result->GetData().get());
+	ForRange(threadPool, bitmap.GetLength() / 4, GetPixelGrain(bitmap), [&](std::size_t begin, std::size_t end) {
+		kernel(source + begin * 4, destination + begin * 4, end - begin);
+	});
+	return result;
+}
+
+std::unique_ptr<Bitmap> BitmapOps::LinearToSrgb(const Bitmap &bitmap, ThreadPool *threadPool) {
+	if (!bitmap.GetData() || bitmap.GetFormat() != PixelFormat::R32G32B32A32Sfloat) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " can not be encoded to sRGB, it must be 32 bit float RGBA\n");
+		return nullptr;
+	}
+
+	auto result = std::make_unique<Bitmap>(nullptr, bitmap.GetSize(), PixelFormat::R8G8B8A8Srgb, bitmap.GetMipLevels(), bitmap.GetArrayLayers());
+	result->SetFilename(bitmap.GetFilename());
+	result->SetData(std::make_unique<uint8_t[]>(result->GetLength()));
+
+	auto kernel = GetKernels().encodeSrgb;
+	auto source = reinterpret_cast<const float *>(bitmap.GetData().get());
+	auto destination = result->GetData().get();
+	ForRange(threadPool, result->GetLength() / 4, GetPixelGrain(bitmap), [&](std::size_t begin, std::size_t end) {
+		kernel(source + begin * 4, destination + begin * 4, end - begin);
+	});
+	return result;
+}
+
+void BitmapOps::Premultiply(Bitmap &bitmap, ThreadPool *threadPool) {
+	if (!IsRgba8(bitmap)) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " can not be premultiplied, it must be 8 bit RGBA\n");
+		return;
+	}
+
+	auto kernel = GetKernels().premultiply;
+	auto pixels = bitmap.GetData().get();
+	ForRange(threadPool, bitmap.GetLength() / 4, GetPixelGrain(bitmap), [&](std::size_t begin, std::size_t end) {
+		kernel(pixels + begin * 4, end - begin);
+	});
+}
+
+void BitmapOps::FlipVertical(Bitmap &bitmap, ThreadPool *threadPool) {
+	if (!bitmap.GetData() || PixelBlock::IsCompressed(bitmap.GetFormat())) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " can not be flipped, it must not be block compressed\n");
+		return;
+	}
+
+	// Rows are swapped in place, which is bound by memory rather than instructions.
+	for (uint32_t level = 0; level < bitmap.GetMipLevels(); level++) {
+		auto levelSize = bitmap.GetLevelSize(level);
+		std::size_t rowLength = static_cast<std::size_t>(levelSize.x) * bitmap.GetBytesPerPixel();
+
+		for (uint32_t layer = 0; layer < bitmap.GetArrayLayers(); layer++) {
+			auto rows = bitmap.GetData().get() + bitmap.GetLevelOffset(level) + layer * rowLength * levelSize.y;
+			ForRange(threadPool, levelSize.y / 2, RowsPerTask, [&](std::size_t begin, std::size_t end) {
+				for (auto y = begin; y < end; y++)
+					std::swap_ranges(rows + y * rowLength, rows + (y + 1) * rowLength, rows + (levelSize.y - 1 - y) * rowLength);
+			});
+		}
+	}
+}
+
+std::unique_ptr<Bitmap> BitmapOps::Resize(const Bitmap &bitmap, const Vector2ui &size, Filter filter, ThreadPool *threadPool) {
+	if (!IsRgba8(bitmap) || size.x == 0 || size.y == 0) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " can not be resized, it must be 8 bit RGBA\n");
+		return nullptr;
+	}
+
+	const auto &kernels = GetKernels();
+	auto sourceSize = bitmap.GetSize();
+	auto layers = bitmap.GetArrayLayers();
+
+	// Rows of every layer are resampled into the new width, then columns into the new height.
+	auto rowTaps = CreateTaps(sourceSize.x, size.x, filter);
+	std::size_t sourceRowLength = static_cast<std::size_t>(sourceSize.x) * 4;
+	std::size_t rowLength = static_cast<std::size_t>(size.x) * 4;
+	std::vector<uint8_t> rows(rowLength * sourceSize.y * layers);
+	auto source = bitmap.GetData().get();
+	ForRange(threadPool, static_cast<std::size_t>(sourceSize.y) * layers, RowsPerTask, [&](std::size_t begin, std::size_t end) {
+		for (auto y = begin; y < end; y++)
+			kernels.resampleRow(source + y * sourceRowLength, rows.data() + y * rowLength, rowTaps);
+	});
+
+	auto result = std::make_unique<Bitmap>(nullptr, size, bitmap.GetFormat(), 1, layers);
+	result->SetFilename(bitmap.GetFilename());
+	result->SetData(std::make_unique<uint8_t[]>(result->GetLength()));
+
+	auto columnTaps = CreateTaps(sourceSize.y, size.y, filter);
+	auto destination = result->GetData().get();
+	ForRange(threadPool, static_cast<std::size_t>(size.y) * layers, RowsPerTask, [&](std::size_t begin, std::size_t end) {
+		std::vector<const uint8_t *> columnRows(columnTaps.count);
+		for (auto row = begin; row < end; row++) {
+			auto layer = row / size.y;
+			auto y = row % size.y;
+			for (uint32_t k = 0; k < columnTaps.count; k++)
+				columnRows[k] = rows.data() + (layer * sourceSize.y + columnTaps.first[y] + k) * rowLength;
+			kernels.resampleColumn(columnRows.data(), columnTaps.weights.data() + y * columnTaps.count, columnTaps.count, destination + row * rowLength, rowLength);
+		}
+	});
+	return result;
+}
+
+BitmapOps::Simd BitmapOps::GetSimd() {
+	return CurrentSimd().load();
+}
+
+void BitmapOps::SetSimd(Simd simd) {
+	auto supported = GetSupportedSimd();
+	auto available = simd == Simd::Scalar || simd == supported || (simd == Simd::Sse41 && supported == Simd::Avx2);
+	CurrentSimd() = available ? simd : supported;
+}
+
+BitmapOps::Simd BitmapOps::GetSupportedSimd() {
+	static const auto Supported = DetectSimd();
+	return Supported;
+}
+}
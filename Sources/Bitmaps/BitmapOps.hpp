@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+
+#include "Bitmap.hpp"
+
+namespace acid {
+class ThreadPool;
+
+/**
+ * @brief Class of operations over the pixels of bitmaps, run with the widest vector instructions the CPU has: AVX2 or SSE4.1 on x86 and NEON on ARM64.
+ * Every operation has a scalar version that the vector versions match bit for bit. Given a thread pool, pixels are split into runs of rows across its workers.
+ */
+class ACID_EXPORT BitmapOps {
+public:
+	/// The vector instructions operations are run with.
+	enum class Simd {
+		Scalar, Sse41, Avx2, Neon
+	};
+
+	enum class Filter {
+		/// Averages the pixels each output pixel covers.
+		Box,
+		/// Windowed sinc over three lobes, keeps more detail than box at the cost of slight ringing.
+		Lanczos
+	};
+
+	/**
+	 * Reorders the channels of 8 bit RGBA pixels, such as swapping blue first pixels to red first.
+	 * @param bitmap The bitmap, every mip level and array layer is reordered.
+	 * @param order The channel each channel is taken from, {2, 1, 0, 3} swaps red and blue.
+	 * @param threadPool The pool to spread rows across, or nullptr to run on the calling thread.
+	 */
+	static void Swizzle(Bitmap &bitmap, const std::array<uint8_t, 4> &order, ThreadPool *threadPool = nullptr);
+
+	/**
+	 * Expands 8 bit pixels with one to three channels to RGBA. Missing channels are 0, with a alpha of 255.
+	 * @param bitmap The bitmap in R8, RG8 or RGB8.
+	 * @param threadPool The pool to spread rows across, or nullptr to run on the calling thread.
+	 * @return The RGBA bitmap, or nullptr if the format can not be expanded.
+	 */
+	static std::unique_ptr<Bitmap> ExpandToRgba(const Bitmap &bitmap, ThreadPool *threadPool = nullptr);
+
+	/**
+	 * Decodes the sRGB curve from 8 bit RGBA pixels into linear 32 bit floats, alpha is scaled without the curve.
+	 * @param bitmap The bitmap in 8 bit RGBA.
+	 * @param threadPool The pool to spread rows across, or nullptr to run on the calling thread.
+	 * @return The linear bitmap, or nullptr if the format is not 8 bit RGBA.
+	 */
+	static std::unique_ptr<Bitmap> SrgbToLinear(const Bitmap &bitmap, ThreadPool *threadPool = nullptr);
+
+	/**
+	 * Encodes linear 32 bit float pixels into 8 bit sRGB, within one step of the exact curve. Values are clamped between 0 and 1.
+	 * @param bitmap The bitmap in 32 bit float RGBA.
+	 * @param threadPool The pool to spread rows across, or nullptr to run on the calling thread.
+	 * @return The sRGB bitmap, or nullptr if the format is not 32 bit float RGBA.
+	 */
+	static std::unique_ptr<Bitmap> LinearToSrgb(const Bitmap &bitmap, ThreadPool *threadPool = nullptr);
+
+	/**
+	 * Multiplies the colour channels of 8 bit RGBA pixels by their alpha, rounding to the nearest.
+	 * @param bitmap The bitmap, every mip level and array layer is multiplied.
+	 * @param threadPool The pool to spread rows across, or nullptr to run on the calling thread.
+	 */
+	static void Premultiply(Bitmap &bitmap, ThreadPool *threadPool = nullptr);
+
+	/**
+	 * Flips the rows of every mip level and array layer from top to bottom.
+	 * @param bitmap The bitmap, that must not be block compressed.
+	 * @param threadPool The pool to spread rows across, or nullptr to run on the calling thread.
+	 */
+	static void FlipVertical(Bitmap &bitmap, ThreadPool *threadPool = nullptr);
+
+	/**
+	 * Resamples the base level of 8 bit RGBA pixels to a new size, rows and columns are filtered one after the other.
+	 * Weights are fixed point, so a solid colour stays the same colour.
+	 * @param bitmap The bitmap in 8 bit RGBA, every array layer is resampled.
+	 * @param size The new size, usually smaller than the bitmap.
+	 * @param filter The filter to sample with.
+	 * @param threadPool The pool to spread rows across, or nullptr to run on the calling thread.
+	 * @return The resampled bitmap with one mip level, or nullptr if the format is not 8 bit RGBA.
+	 */
+	static std::unique_ptr<Bitmap> Resize(const Bitmap &bitmap, const Vector2ui &size, Filter filter, ThreadPool *threadPool = nullptr);
+
+	/**
+	 * Gets the vector instructions operations are run with, the widest the CPU supports unless lowered with {@link BitmapOps#SetSimd}.
+	 * @return The vector instructions.
+	 */
+	static Simd GetSimd();
+
+	/**
+	 * Sets the vector instructions operations are run with, used to compare them against the scalar versions.
+	 * @param simd The vector instructions, instructions the CPU does not support fall back to the widest it does.
+	 */
+	static void SetSimd(Simd simd);
+
+	/**
+	 * Gets the widest vector instructions the CPU supports.
+	 * @return The vector instructions.
+	 */
+	static Simd GetSupportedSimd();
+};
+}
@@ -0,0 +1,348 @@
+#include "BlockDecoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace acid {
+static constexpr int32_t EtcModifiers[8][4] = {
+	{2, 8, -2, -8}, {5, 17, -5, -17}, {9, 29, -9, -29}, {13, 42, -13, -42}, {18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183}
+};
+static constexpr int32_t EtcDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+static constexpr int32_t EacModifiers[16][8] = {
+	{-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12}, {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+	{-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10}, {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+	{-2, -6, -8, -10, 1, 5, 7, 9}, {-2, -5, -8, -10, 1, 4, 7, 9}, {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+	{-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9}, {-4, -6, -8, -9, 3, 5, 7, 8}, {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+static uint8_t Saturate(int32_t value) {
+	return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+/**
+ * Gets bits from a big endian ETC block.
+ * @param bits The block.
+ * @param high The highest bit, counted from the least significant bit.
+ * @param count The number of bits.
+ * @return The bits.
+ */
+static int32_t GetBits(uint64_t bits, uint32_t high, uint32_t count) {
+	return static_cast<int32_t>((bits >> (high + 1 - count)) & ((1u << count) - 1));
+}
+
+static uint64_t ReadBigEndian(const uint8_t *block) {
+	uint64_t bits = 0;
+	for (uint32_t i = 0; i < 8; i++)
+		bits = bits << 8 | block[i];
+	return bits;
+}
+
+static void DecodeBc1(const uint8_t *block, uint8_t *pixels, bool alphaBlock, bool punchthrough) {
+	uint32_t colours[2] = {static_cast<uint32_t>(block[0] | block[1] << 8), static_cast<uint32_t>(block[2] | block[3] << 8)};
+	int32_t palette[4][4];
+
+	for (uint32_t i = 0; i < 2; i++) {
+		auto r = colours[i] >> 11 & 0x1F, g = colours[i] >> 5 & 0x3F, b = colours[i] & 0x1F;
+		palette[i][0] = static_cast<int32_t>(r << 3 | r >> 2);
+		palette[i][1] = static_cast<int32_t>(g << 2 | g >> 4);
+		palette[i][2] = static_cast<int32_t>(b << 3 | b >> 2);
+		palette[i][3] = 255;
+	}
+
+	// Blocks holding alpha separately always use four colours, BC1 blocks with the colours in order use three and black.
+	for (uint32_t c = 0; c < 3; c++) {
+		if (alphaBlock || colours[0] > colours[1]) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+		} else {
+			palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = (!alphaBlock && colours[0] <= colours[1] && punchthrough) ? 0 : 255;
+
+	auto indices = static_cast<uint32_t>(block[4] | block[5] << 8 | block[6] << 16) | static_cast<uint32_t>(block[7]) << 24;
+	for (uint32_t i = 0; i < 16; i++) {
+		auto &colour = palette[indices >> (2 * i) & 3];
+		for (uint32_t c = 0; c < 4; c++)
+			pixels[i * 4 + c] = static_cast<uint8_t>(colour[c]);
+	}
+}
+
+static void DecodeBc4(const uint8_t *block, uint8_t *pixels, uint32_t channel) {
+	int32_t palette[8] = {block[0], block[1]};
+
+	if (palette[0] > palette[1]) {
+		for (int32_t i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * palette[0] + i * palette[1] + 3) / 7;
+	} else {
+		for (int32_t i = 1; i < 5; i++)
+			palette[i + 1] = ((5 - i) * palette[0] + i * palette[1] + 2) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	uint64_t indices = 0;
+	for (uint32_t i = 0; i < 6; i++)
+		indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+
+	for (uint32_t i = 0; i < 16; i++)
+		pixels[i * 4 + channel] = static_cast<uint8_t>(palette[indices >> (3 * i) & 7]);
+}
+
+static void DecodeEtc2(const uint8_t *block, uint8_t *pixels, bool punchthrough) {
+	auto bits = ReadBigEndian(block);
+	// Punchthrough blocks have no individual mode, the differential bit instead says if the block is opaque.
+	auto differential = punchthrough || GetBits(bits, 33, 1);
+	auto opaque = !punchthrough || GetBits(bits, 33, 1);
+
+	// Pixel indices are stored in columns, the most significant bits of every index before the least.
+	auto getIndex = [bits](uint32_t x, uint32_t y) {
+		auto k = x * 4 + y;
+		return static_cast<uint32_t>((bits >> (k + 16) & 1) << 1 | (bits >> k & 1));
+	};
+	auto setPixel = [pixels](uint32_t x, uint32_t y, const int32_t *colour, uint8_t alpha) {
+		auto pixel = pixels + (y * 4 + x) * 4;
+		for (uint32_t c = 0; c < 3; c++)
+			pixel[c] = alpha ? Saturate(colour[c]) : 0;
+		pixel[3] = alpha;
+	};
+
+	int32_t base[2][3];
+
+	if (!differential) {
+		for (uint32_t c = 0; c < 3; c++) {
+			base[0][c] = GetBits(bits, 63 - 8 * c, 4) * 17;
+			base[1][c] = GetBits(bits, 59 - 8 * c, 4) * 17;
+		}
+	} else {
+		int32_t first[3], second[3];
+		for (uint32_t c = 0; c < 3; c++) {
+			first[c] = GetBits(bits, 63 - 8 * c, 5);
+			auto delta = GetBits(bits, 58 - 8 * c, 3);
+			second[c] = first[c] + (delta >= 4 ? delta - 8 : delta);
+		}
+
+		// ETC2 modes are stored as differential colours that overflow, red for T, green for H and blue for planar.
+		if (second[0] < 0 || second[0] > 31 || second[1] < 0 || second[1] > 31) {
+			int32_t colours[2][3];
+			int32_t distance;
+			int32_t paint[4][3];
+
+			if (second[0] < 0 || second[0] > 31) {
+				colours[0][0] = GetBits(bits, 60, 2) << 2 | GetBits(bits, 57, 2);
+				colours[0][1] = GetBits(bits, 55, 4);
+				colours[0][2] = GetBits(bits, 51, 4);
+				for (uint32_t c = 0; c < 3; c++)
+					colours[1][c] = GetBits(bits, 47 - 4 * c, 4);
+				distance = EtcDistances[GetBits(bits, 35, 2) << 1 | GetBits(bits, 32, 1)];
+
+				for (uint32_t c = 0; c < 3; c++) {
+					paint[0][c] = colours[0][c] * 17;
+					paint[1][c] = colours[1][c] * 17 + distance;
+					paint[2][c] = colours[1][c] * 17;
+					paint[3][c] = colours[1][c] * 17 - distance;
+				}
+			} else {
+				colours[0][0] = GetBits(bits, 62, 4);
+				colours[0][1] = GetBits(bits, 58, 3) << 1 | GetBits(bits, 52, 1);
+				colours[0][2] = GetBits(bits, 51, 1) << 3 | GetBits(bits, 49, 3);
+				for (uint32_t c = 0; c < 3; c++)
+					colours[1][c] = GetBits(bits, 46 - 4 * c, 4);
+				auto ordered = (colours[0][0] << 8 | colours[0][1] << 4 | colours[0][2]) >= (colours[1][0] << 8 | colours[1][1] << 4 | colours[1][2]);
+				distance = EtcDistances[GetBits(bits, 34, 1) << 2 | GetBits(bits, 32, 1) << 1 | (ordered ? 1 : 0)];
+
+				for (uint32_t c = 0; c < 3; c++) {
+					paint[0][c] = colours[0][c] * 17 + distance;
+					paint[1][c] = colours[0][c] * 17 - distance;
+					paint[2][c] = colours[1][c] * 17 + distance;
+					paint[3][c] = colours[1][c] * 17 - distance;
+				}
+			}
+
+			for (uint32_t y = 0; y < 4; y++) {
+				for (uint32_t x = 0; x < 4; x++) {
+					auto index = getIndex(x, y);
+					setPixel(x, y, paint[index], !opaque && index == 2 ? 0 : 255);
+				}
+			}
+			return;
+		}
+
+		if (second[2] < 0 || second[2] > 31) {
+			// Planar blocks store colours at three corners, extrapolated across the block.
+			int32_t origin[3] = {GetBits(bits, 62, 6), GetBits(bits, 56, 1) << 6 | GetBits(bits, 54, 6),
+				GetBits(bits, 48, 1) << 5 | GetBits(bits, 44, 2) << 3 | GetBits(bits, 41, 3)};
+			int32_t horizontal[3] = {GetBits(bits, 38, 5) << 1 | GetBits(bits, 32, 1), GetBits(bits, 31, 7), GetBits(bits, 24, 6)};
+			int32_t vertical[3] = {GetBits(bits, 18, 6), GetBits(bits, 12, 7), GetBits(bits, 5, 6)};
+
+			for (auto corner : {origin, horizontal, vertical}) {
+				corner[0] = corner[0] << 2 | corner[0] >> 4;
+				corner[1] = corner[1] << 1 | corner[1] >> 6;
+				corner[2] = corner[2] << 2 | corner[2] >> 4;
+			}
+
+			for (int32_t y = 0; y < 4; y++) {
+				for (int32_t x = 0; x < 4; x++) {
+					int32_t colour[3];
+					for (uint32_t c = 0; c < 3; c++)
+						colour[c] = (x * (horizontal[c] - origin[c]) + y * (vertical[c] - origin[c]) + 4 * origin[c] + 2) >> 2;
+					setPixel(x, y, colour, 255);
+				}
+			}
+			return;
+		}
+
+		for (uint32_t c = 0; c < 3; c++) {
+			base[0][c] = first[c] << 3 | first[c] >> 2;
+			base[1][c] = second[c] << 3 | second[c] >> 2;
+		}
+	}
+
+	const int32_t *tables[2] = {EtcModifiers[GetBits(bits, 39, 3)], EtcModifiers[GetBits(bits, 36, 3)]};
+	auto flip = GetBits(bits, 32, 1);
+
+	for (uint32_t y = 0; y < 4; y++) {
+		for (uint32_t x = 0; x < 4; x++) {
+			auto subblock = flip ? y >= 2 : x >= 2;
+			auto index = getIndex(x, y);
+
+			if (!opaque && index == 2) {
+				setPixel(x, y, base[subblock], 0);
+				continue;
+			}
+
+			auto modifier = !opaque && index == 0 ? 0 : tables[subblock][index];
+			int32_t colour[3] = {base[subblock][0] + modifier, base[subblock][1] + modifier, base[subblock][2] + modifier};
+			setPixel(x, y, colour, 255);
+		}
+	}
+}
+
+static void DecodeEacAlpha(const uint8_t *block, uint8_t *pixels) {
+	auto bits = ReadBigEndian(block);
+	auto base = GetBits(bits, 63, 8);
+	auto multiplier = GetBits(bits, 55, 4);
+	auto &modifiers = EacModifiers[GetBits(bits, 51, 4)];
+
+	for (uint32_t k = 0; k < 16; k++) {
+		auto x = k / 4, y = k % 4;
+		pixels[(y * 4 + x) * 4 + 3] = Saturate(base + modifiers[GetBits(bits, 47 - 3 * k, 3)] * multiplier);
+	}
+}
+
+bool BlockDecoder::IsSupported(PixelFormat format) {
+	switch (format) {
+	case PixelFormat::Bc1RgbUnorm:
+	case PixelFormat::Bc1RgbSrgb:
+	case PixelFormat::Bc1RgbaUnorm:
+	case PixelFormat::Bc1RgbaSrgb:
+	case PixelFormat::Bc2Unorm:
+	case PixelFormat::Bc2Srgb:
+	case PixelFormat::Bc3Unorm:
+	case PixelFormat::Bc3Srgb:
+	case PixelFormat::Bc4Unorm:
+	case PixelFormat::Bc5Unorm:
+	case PixelFormat::Etc2R8G8B8Unorm:
+	case PixelFormat::Etc2R8G8B8Srgb:
+	case PixelFormat::Etc2R8G8B8A1Unorm:
+	case PixelFormat::Etc2R8G8B8A1Srgb:
+	case PixelFormat::Etc2R8G8B8A8Unorm:
+	case PixelFormat::Etc2R8G8B8A8Srgb:
+		return true;
+	default:
+		return false;
+	}
+}
+
+std::unique_ptr<Bitmap> BlockDecoder::Decode(const Bitmap &bitmap) {
+	auto format = bitmap.GetFormat();
+	if (!IsSupported(format) || !bitmap.GetData())
+		return nullptr;
+
+	auto block = PixelBlock::Get(format);
+	auto result = std::make_unique<Bitmap>(nullptr, bitmap.GetSize(), PixelBlock::IsSrgb(format) ? PixelFormat::R8G8B8A8Srgb : PixelFormat::R8G8B8A8Unorm,
+		bitmap.GetMipLevels(), bitmap.GetArrayLayers());
+	result->SetData(std::make_unique<uint8_t[]>(result->GetLength()));
+	result->SetFilename(bitmap.GetFilename());
+
+	uint8_t pixels[64];
+
+	for (uint32_t level = 0; level < bitmap.GetMipLevels(); level++) {
+		auto size = bitmap.GetLevelSize(level);
+		auto blocksX = (size.x + 3) / 4, blocksY = (size.y + 3) / 4;
+		auto source = bitmap.GetData().get() + bitmap.GetLevelOffset(level);
+		auto destination = result->GetData().get() + result->GetLevelOffset(level);
+
+		for (uint32_t layer = 0; layer < bitmap.GetArrayLayers(); layer++) {
+			for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+				for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+					DecodeBlock(format, source, pixels);
+					source += block.bytes;
+
+					// Blocks on the right and bottom edges can hang over the image.
+					auto width = std::min(4u, size.x - blockX * 4), height = std::min(4u, size.y - blockY * 4);
+					for (uint32_t y = 0; y < height; y++)
+						std::memcpy(destination + ((blockY * 4 + y) * size.x + blockX * 4) * 4, pixels + y * 16, width * 4);
+				}
+			}
+
+			destination += size.x * size.y * 4;
+		}
+	}
+
+	return result;
+}
+
+void BlockDecoder::DecodeBlock(PixelFormat format, const uint8_t *block, uint8_t *pixels) {
+	switch (format) {
+	case PixelFormat::Bc1RgbUnorm:
+	case PixelFormat::Bc1RgbSrgb:
+		DecodeBc1(block, pixels, false, false);
+		break;
+	case PixelFormat::Bc1RgbaUnorm:
+	case PixelFormat::Bc1RgbaSrgb:
+		DecodeBc1(block, pixels, false, true);
+		break;
+	case PixelFormat::Bc2Unorm:
+	case PixelFormat::Bc2Srgb:
+		DecodeBc1(block + 8, pixels, true, false);
+		for (uint32_t i = 0; i < 16; i++)
+			pixels[i * 4 + 3] = static_cast<uint8_t>((block[i / 2] >> (4 * (i % 2)) & 0xF) * 17);
+		break;
+	case PixelFormat::Bc3Unorm:
+	case PixelFormat::Bc3Srgb:
+		DecodeBc1(block + 8, pixels, true, false);
+		DecodeBc4(block, pixels, 3);
+		break;
+	case PixelFormat::Bc4Unorm:
+	case PixelFormat::Bc5Unorm:
+		// Single and dual channel blocks sample as red and green, with no blue and full alpha.
+		for (uint32_t i = 0; i < 16; i++) {
+			pixels[i * 4 + 1] = 0;
+			pixels[i * 4 + 2] = 0;
+			pixels[i * 4 + 3] = 255;
+		}
+		DecodeBc4(block, pixels, 0);
+		if (format == PixelFormat::Bc5Unorm)
+			DecodeBc4(block + 8, pixels, 1);
+		break;
+	case PixelFormat::Etc2R8G8B8Unorm:
+	case PixelFormat::Etc2R8G8B8Srgb:
+		DecodeEtc2(block, pixels, false);
+		break;
+	case PixelFormat::Etc2R8G8B8A1Unorm:
+	case PixelFormat::Etc2R8G8B8A1Srgb:
+		DecodeEtc2(block, pixels, true);
+		break;
+	case PixelFormat::Etc2R8G8B8A8Unorm:
+	case PixelFormat::Etc2R8G8B8A8Srgb:
+		DecodeEtc2(block + 8, pixels, false);
+		DecodeEacAlpha(block, pixels);
+		break;
+	default:
+		break;
+	}
+}
+}
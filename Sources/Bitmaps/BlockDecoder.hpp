@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Bitmap.hpp"
+
+namespace acid {
+/**
+ * @brief Class that decodes block compressed bitmaps to 8 bit RGBA on the CPU, for devices that can not sample a format.
+ * BC1 to BC5 and the ETC2 colour formats can be decoded, BC4 and BC5 are decoded into the red and green channels.
+ */
+class ACID_EXPORT BlockDecoder {
+public:
+	/**
+	 * Gets if blocks of a format can be decoded.
+	 * @param format The pixel format.
+	 * @return If the format can be decoded.
+	 */
+	static bool IsSupported(PixelFormat format);
+
+	/**
+	 * Decodes every mip level and array layer of a bitmap.
+	 * @param bitmap The block compressed bitmap.
+	 * @return The decoded bitmap in 8 bit RGBA, sRGB if the blocks were sRGB, or nullptr if the format can not be decoded.
+	 */
+	static std::unique_ptr<Bitmap> Decode(const Bitmap &bitmap);
+
+	/**
+	 * Decodes a single block.
+	 * @param format The pixel format, that must be supported.
+	 * @param block The block.
+	 * @param pixels The 4x4 RGBA pixels written in rows, 64 bytes.
+	 */
+	static void DecodeBlock(PixelFormat format, const uint8_t *block, uint8_t *pixels);
+};
+}
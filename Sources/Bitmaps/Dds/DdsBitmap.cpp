@@ -0,0 +1,223 @@
+#include "DdsBitmap.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include "Engine/Log.hpp"
+#include "Files/Files.hpp"
+#include "Maths/Time.hpp"
+
+namespace acid {
+static constexpr uint32_t MakeFourCc(char a, char b, char c, char d) {
+	return static_cast<uint32_t>(a) | static_cast<uint32_t>(b) << 8 | static_cast<uint32_t>(c) << 16 | static_cast<uint32_t>(d) << 24;
+}
+
+/// The magic and header before the optional DX10 header.
+static constexpr std::size_t HeaderSize = 128;
+static constexpr std::size_t Dx10HeaderSize = 20;
+
+static constexpr uint32_t FlagMipMapCount = 0x20000;
+static constexpr uint32_t PixelFlagAlpha = 0x1;
+static constexpr uint32_t PixelFlagFourCc = 0x4;
+static constexpr uint32_t PixelFlagRgb = 0x40;
+static constexpr uint32_t Caps2Cubemap = 0x200;
+static constexpr uint32_t Caps2CubemapFaces = 0xFC00;
+static constexpr uint32_t Caps2Volume = 0x200000;
+static constexpr uint32_t MiscTextureCube = 0x4;
+
+template<typename T>
+static T ReadValue(const uint8_t *data) {
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+static PixelFormat FindFourCcFormat(uint32_t fourCc) {
+	switch (fourCc) {
+	case MakeFourCc('D', 'X', 'T', '1'):
+		return PixelFormat::Bc1RgbaUnorm;
+	case MakeFourCc('D', 'X', 'T', '2'):
+	case MakeFourCc('D', 'X', 'T', '3'):
+		return PixelFormat::Bc2Unorm;
+	case MakeFourCc('D', 'X', 'T', '4'):
+	case MakeFourCc('D', 'X', 'T', '5'):
+		return PixelFormat::Bc3Unorm;
+	case MakeFourCc('A', 'T', 'I', '1'):
+	case MakeFourCc('B', 'C', '4', 'U'):
+		return PixelFormat::Bc4Unorm;
+	case MakeFourCc('B', 'C', '4', 'S'):
+		return PixelFormat::Bc4Snorm;
+	case MakeFourCc('A', 'T', 'I', '2'):
+	case MakeFourCc('B', 'C', '5', 'U'):
+		return PixelFormat::Bc5Unorm;
+	case MakeFourCc('B', 'C', '5', 'S'):
+		return PixelFormat::Bc5Snorm;
+	default:
+		return PixelFormat::Undefined;
+	}
+}
+
+static PixelFormat FindDxgiFormat(uint32_t dxgiFormat) {
+	switch (dxgiFormat) {
+	case 2:
+		return PixelFormat::R32G32B32A32Sfloat;
+	case 10:
+		return PixelFormat::R16G16B16A16Sfloat;
+	case 28:
+		return PixelFormat::R8G8B8A8Unorm;
+	case 29:
+		return PixelFormat::R8G8B8A8Srgb;
+	case 71:
+		return PixelFormat::Bc1RgbaUnorm;
+	case 72:
+		return PixelFormat::Bc1RgbaSrgb;
+	case 74:
+		return PixelFormat::Bc2Unorm;
+	case 75:
+		return PixelFormat::Bc2Srgb;
+	case 77:
+		return PixelFormat::Bc3Unorm;
+	case 78:
+		return PixelFormat::Bc3Srgb;
+	case 80:
+		return PixelFormat::Bc4Unorm;
+	case 81:
+		return PixelFormat::Bc4Snorm;
+	case 83:
+		return PixelFormat::Bc5Unorm;
+	case 84:
+		return PixelFormat::Bc5Snorm;
+	case 95:
+		return PixelFormat::Bc6hUfloat;
+	case 96:
+		return PixelFormat::Bc6hSfloat;
+	case 98:
+		return PixelFormat::Bc7Unorm;
+	case 99:
+		return PixelFormat::Bc7Srgb;
+	default:
+		return PixelFormat::Undefined;
+	}
+}
+
+void DdsBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	auto file = Files::ReadAsync(filename).get();
+	if (!*file)
+		return;
+
+	auto data = file->GetData();
+	if (file->GetSize() < HeaderSize || ReadValue<uint32_t>(data) != MakeFourCc('D', 'D', 'S', ' ') || ReadValue<uint32_t>(data + 4) != 124) {
+		Log::Error("Bitmap ", filename, " is not a DDS file\n");
+		return;
+	}
+
+	Vector2ui size(ReadValue<uint32_t>(data + 16), ReadValue<uint32_t>(data + 12));
+	auto mipLevels = ReadValue<uint32_t>(data + 28);
+	// Files without the mip map count flag may leave the count zero when they only store the base level.
+	if (mipLevels == 0 && !(ReadValue<uint32_t>(data + 8) & FlagMipMapCount))
+		mipLevels = 1;
+	auto pixelFlags = ReadValue<uint32_t>(data + 80);
+	auto fourCc = ReadValue<uint32_t>(data + 84);
+	auto caps2 = ReadValue<uint32_t>(data + 112);
+	auto dataOffset = HeaderSize;
+	auto format = PixelFormat::Undefined;
+	uint32_t arrayLayers = 1;
+	// Uncompressed pixels may be stored as BGRA, or without alpha.
+	auto swizzle = false;
+	auto opaque = false;
+
+	if ((pixelFlags & PixelFlagFourCc) && fourCc == MakeFourCc('D', 'X', '1', '0')) {
+		if (file->GetSize() < HeaderSize + Dx10HeaderSize) {
+			Log::Error("Bitmap ", filename, " is truncated\n");
+			return;
+		}
+
+		format = FindDxgiFormat(ReadValue<uint32_t>(data + HeaderSize));
+		auto miscFlag = ReadValue<uint32_t>(data + HeaderSize + 8);
+		auto layers = static_cast<uint64_t>(std::max(ReadValue<uint32_t>(data + HeaderSize + 12), 1u)) * ((miscFlag & MiscTextureCube) ? 6 : 1);
+		if (layers > std::numeric_limits<uint32_t>::max()) {
+			Log::Error("Bitmap ", filename, " has too many layers\n");
+			return;
+		}
+		arrayLayers = static_cast<uint32_t>(layers);
+		dataOffset += Dx10HeaderSize;
+	} else if (pixelFlags & PixelFlagFourCc) {
+		format = FindFourCcFormat(fourCc);
+	} else if ((pixelFlags & PixelFlagRgb) && ReadValue<uint32_t>(data + 88) == 32) {
+		auto redMask = ReadValue<uint32_t>(data + 92);
+		if (redMask == 0x000000FF || redMask == 0x00FF0000) {
+			format = PixelFormat::R8G8B8A8Unorm;
+			swizzle = redMask == 0x00FF0000;
+			opaque = !(pixelFlags & PixelFlagAlpha);
+		}
+	}
+
+	if (format == PixelFormat::Undefined) {
+		Log::Error("Bitmap ", filename, " has a unsupported pixel format\n");
+		return;
+	}
+	if (caps2 & Caps2Volume) {
+		Log::Error("Bitmap ", filename, " is not a 2D image or cube map\n");
+		return;
+	}
+	if (caps2 & Caps2Cubemap) {
+		if ((caps2 & Caps2CubemapFaces) != Caps2CubemapFaces) {
+			Log::Error("Bitmap ", filename, " is a cube map without every face\n");
+			return;
+		}
+		arrayLayers = std::max(arrayLayers, 6u);
+	}
+
+	// Sizes and counts come from the file, so the length is checked without overflowing before it is trusted.
+	auto length = Bitmap::CheckLayout(size, format, mipLevels, arrayLayers);
+	if (!length) {
+		Log::Error("Bitmap ", filename, " has a invalid size, level count or layer count\n");
+		return;
+	}
+	if (file->GetSize() < dataOffset + *length) {
+		Log::Error("Bitmap ", filename, " is truncated\n");
+		return;
+	}
+
+	// The file stores every mip level of a layer before the next layer, bitmaps store every layer of a level before the next level.
+	Bitmap layout(nullptr, size, format, mipLevels, arrayLayers);
+	auto pixels = std::make_unique<uint8_t[]>(*length);
+	auto source = data + dataOffset;
+
+	for (uint32_t layer = 0; layer < arrayLayers; layer++) {
+		for (uint32_t level = 0; level < mipLevels; level++) {
+			auto layerLength = layout.GetLevelLength(level) / arrayLayers;
+			std::memcpy(pixels.get() + layout.GetLevelOffset(level) + layer * layerLength, source, layerLength);
+			source += layerLength;
+		}
+	}
+
+	if (swizzle || opaque) {
+		for (uint32_t i = 0; i < *length; i += 4) {
+			if (swizzle)
+				std::swap(pixels[i], pixels[i + 2]);
+			if (opaque)
+				pixels[i + 3] = 0xFF;
+		}
+	}
+
+	bitmap->SetData(std::move(pixels));
+	bitmap->SetSize(size);
+	bitmap->SetBytesPerPixel(layout.GetBytesPerPixel());
+	bitmap->SetFormat(format);
+	bitmap->SetMipLevels(mipLevels);
+	bitmap->SetArrayLayers(arrayLayers);
+
+#if defined(ACID_DEBUG)
+	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+}
+
+void DdsBitmap::Write(const Bitmap *, const std::filesystem::path &filename) {
+	Log::Error("Bitmap ", filename, " can not be written, DDS files are only loaded\n");
+}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Bitmaps/Bitmap.hpp"
+
+namespace acid {
+/**
+ * @brief Class that loads DDS textures, BCn blocks and mip levels are kept as stored so they upload without being decoded.
+ */
+class ACID_EXPORT DdsBitmap : public Bitmap::Registrar<DdsBitmap> {
+	inline static const bool Registered = Register(".dds");
+public:
+	static void Load(Bitmap *bitmap, const std::filesystem::path &filename);
+	static void Write(const Bitmap *bitmap, const std::filesystem::path &filename);
+};
+}
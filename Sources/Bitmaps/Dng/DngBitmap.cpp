@@ -1,6 +1,9 @@
 #include "DngBitmap.hpp"
 
+#include <array>
 #include <cstring>
+#include <fstream>
+#include <limits>
 
 #include <tinydng/tiny_dng.h>
 
@@ -8,19 +11,212 @@
 #include "Maths/Time.hpp"
 
 namespace acid {
+/// TIFF tags written for a linear DNG, in the ascending order an IFD stores them.
+enum class Tag : uint16_t {
+	NewSubfileType = 254, ImageWidth = 256, ImageLength = 257, BitsPerSample = 258, Compression = 259, PhotometricInterpretation = 262,
+	StripOffsets = 273, Orientation = 274, SamplesPerPixel = 277, RowsPerStrip = 278, StripByteCounts = 279, PlanarConfiguration = 284,
+	SampleFormat = 339, DngVersion = 50706, DngBackwardVersion = 50707, UniqueCameraModel = 50708
+};
+
+enum class TagType : uint16_t {
+	Byte = 1, Ascii = 2, Short = 3, Long = 4
+};
+
+/// Photometric interpretation of pixels that already hold every colour, with no colour filter array.
+static constexpr uint16_t LinearRaw = 34892;
+
+/**
+ * Reads a sample of a DNG image as a float, unsigned samples are scaled between the black and white levels of their channel.
+ * @param image The image.
+ * @param index The index of the sample, across every channel of every pixel.
+ * @param bigEndian If the samples of the image are stored big endian.
+ * @return The sample.
+ */
+static float ReadSample(const tinydng::DNGImage &image, std::size_t index, bool bigEndian) {
+	auto bits = static_cast<uint32_t>(image.bits_per_sample);
+	auto data = image.data.data();
+
+	if (image.sample_format == tinydng::SAMPLEFORMAT_IEEEFP) {
+		if (bits == 16) {
+			uint16_t half;
+			std::memcpy(&half, data + index * 2, sizeof(uint16_t));
+			return Bitmap::HalfToFloat(bigEndian ? static_cast<uint16_t>(half << 8 | half >> 8) : half);
+		}
+
+		uint32_t value;
+		std::memcpy(&value, data + index * 4, sizeof(uint32_t));
+		if (bigEndian)
+			value = (value << 24) | ((value << 8) & 0xff0000) | ((value >> 8) & 0xff00) | (value >> 24);
+		float result;
+		std::memcpy(&result, &value, sizeof(float));
+		return result;
+	}
+
+	uint32_t value;
+	if (bits == 8) {
+		value = data[index];
+	} else if (bits == 16) {
+		uint16_t sample;
+		std::memcpy(&sample, data + index * 2, sizeof(uint16_t));
+		value = bigEndian ? static_cast<uint16_t>(sample << 8 | sample >> 8) : sample;
+	} else {
+		// Other depths are packed from the highest bit, a sample spans at most three bytes.
+		auto bit = index * bits;
+		auto byte = bit / 8;
+		uint32_t window = 0;
+		for (std::size_t i = 0; i < 3; i++)
+			window = (window << 8) | (byte + i < image.data.size() ? data[byte + i] : 0);
+		value = (window >> (24 - bit % 8 - bits)) & ((1u << bits) - 1);
+	}
+
+	auto channel = index % image.samples_per_pixel;
+	auto black = static_cast<float>(image.black_level[channel]);
+	auto white = static_cast<float>(image.white_level[channel]);
+	return white > black ? (static_cast<float>(value) - black) / (white - black) : static_cast<float>(value);
+}
+
+template<typename T>
+static void WriteValue(std::string &data, T value) {
+	data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
 void DngBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
 #if defined(ACID_DEBUG)
 	auto debugStart = Time::Now();
 #endif
 
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::ReadAsync(filename).get();
 
-	if (!fileLoaded) {
+	if (!*fileLoaded) {
 		Log::Error("Bitmap could not be loaded: ", filename, '\n');
 		return;
 	}
 
-	// TODO
+	std::vector<tinydng::FieldInfo> customFields;
+	std::vector<tinydng::DNGImage> images;
+	std::string warning, error;
+
+	try {
+		if (!tinydng::LoadDNGFromMemory(reinterpret_cast<const char *>(fileLoaded->GetData()), static_cast<uint32_t>(fileLoaded->GetSize()), customFields, &images, &warning, &error)) {
+			Log::Error("Bitmap ", filename, " could not be decoded: ", error, '\n');
+			return;
+		}
+	} catch (const std::exception &e) {
+		Log::Error("Bitmap ", filename, " could not be decoded: ", e.what(), '\n');
+		return;
+	}
+
+	if (!warning.empty())
+		Log::Warning("Bitmap ", filename, ": ", warning, '\n');
+
+	// Files hold previews next to the raw image, the largest image is loaded.
+	const tinydng::DNGImage *image = nullptr;
+	for (const auto &candidate : images) {
+		if (!candidate.data.empty() && (!image || static_cast<int64_t>(candidate.width) * candidate.height > static_cast<int64_t>(image->width) * image->height))
+			image = &candidate;
+	}
+
+	auto colourFilter = image && image->samples_per_pixel == 1 && image->cfa_pattern[0][0] != -1;
+	// Black and white levels are only stored for up to 4 samples per pixel.
+	if (!image || image->width <= 0 || image->height <= 0 || image->samples_per_pixel < 1 || image->samples_per_pixel > 4 || image->bits_per_sample < 1 ||
+		(image->sample_format == tinydng::SAMPLEFORMAT_IEEEFP && image->bits_per_sample != 16 && image->bits_per_sample != 32) ||
+		(image->sample_format != tinydng::SAMPLEFORMAT_IEEEFP && image->bits_per_sample > 16)) {
+		Log::Error("Bitmap ", filename, " has no image that can be read\n");
+		return;
+	}
+
+	for (const auto &row : image->cfa_pattern) {
+		for (auto colour : row) {
+			if (colourFilter && (colour < 0 || colour > 2)) {
+				Log::Error("Bitmap ", filename, " has a colour filter that is not red, green and blue\n");
+				return;
+			}
+		}
+	}
+
+	// Samples are read without bounds checks, so the decoded data must hold every sample of the image.
+	auto sampleBits = static_cast<uint64_t>(image->width) * image->height * image->samples_per_pixel * image->bits_per_sample;
+	if (image->data.size() < (sampleBits + 7) / 8) {
+		Log::Error("Bitmap ", filename, " has less data than its size\n");
+		return;
+	}
+
+	// Uncompressed samples keep the byte order of the file, decompressed samples are native.
+	auto bigEndian = fileLoaded->GetSize() >= 2 && fileLoaded->GetData()[0] == 'M' && fileLoaded->GetData()[1] == 'M' && image->compression == tinydng::COMPRESSION_NONE;
+
+	// Only the active area holds image pixels, the colour filter pattern starts at its corner.
+	int32_t top = 0, left = 0, bottom = image->height, right = image->width;
+	if (image->has_active_area) {
+		top = image->active_area[0], left = image->active_area[1], bottom = image->active_area[2], right = image->active_area[3];
+		if (top < 0 || top >= bottom || bottom > image->height || left < 0 || left >= right || right > image->width) {
+			Log::Error("Bitmap ", filename, " has a active area outside of the image\n");
+			return;
+		}
+	}
+
+	Vector2ui size(right - left, bottom - top);
+	// Bitmap lengths are 32 bit.
+	auto length = static_cast<std::size_t>(size.x) * size.y * 4 * sizeof(uint16_t);
+	if (length > std::numeric_limits<uint32_t>::max()) {
+		Log::Error("Bitmap ", filename, " is too large\n");
+		return;
+	}
+
+	auto spp = static_cast<std::size_t>(image->samples_per_pixel);
+	auto sample = [&](int32_t x, int32_t y, std::size_t channel) {
+		return ReadSample(*image, (static_cast<std::size_t>(top + y) * image->width + left + x) * spp + channel, bigEndian);
+	};
+
+	// White balance scales each channel so a neutral colour in the scene is grey.
+	std::array<float, 3> balance = {1.0f, 1.0f, 1.0f};
+	if (image->has_as_shot_neutral) {
+		for (std::size_t i = 0; i < 3; i++)
+			balance[i] = image->as_shot_neutral[i] > 0.0 ? static_cast<float>(1.0 / image->as_shot_neutral[i]) : 1.0f;
+	}
+
+	auto data = std::make_unique<uint8_t[]>(length);
+	auto pixels = reinterpret_cast<uint16_t *>(data.get());
+
+	for (int32_t y = 0; y < static_cast<int32_t>(size.y); y++) {
+		for (int32_t x = 0; x < static_cast<int32_t>(size.x); x++) {
+			std::array<float, 3> colour = {};
+
+			if (colourFilter) {
+				// Each colour is the average of the pixels around that sampled it, a bilinear demosaic.
+				std::array<float, 3> sums = {};
+				std::array<uint32_t, 3> counts = {};
+				for (int32_t dy = -1; dy <= 1; dy++) {
+					for (int32_t dx = -1; dx <= 1; dx++) {
+						auto sx = x + dx, sy = y + dy;
+						if (sx < 0 || sy < 0 || sx >= static_cast<int32_t>(size.x) || sy >= static_cast<int32_t>(size.y))
+							continue;
+						auto filter = image->cfa_pattern[sy % 2][sx % 2];
+						sums[filter] += sample(sx, sy, 0);
+						counts[filter]++;
+					}
+				}
+
+				for (std::size_t i = 0; i < 3; i++)
+					colour[i] = counts[i] ? sums[i] / static_cast<float>(counts[i]) : 0.0f;
+			} else if (spp >= 3) {
+				colour = {sample(x, y, 0), sample(x, y, 1), sample(x, y, 2)};
+			} else {
+				colour.fill(sample(x, y, 0));
+			}
+
+			auto pixel = pixels + (static_cast<std::size_t>(y) * size.x + x) * 4;
+			for (std::size_t i = 0; i < 3; i++)
+				pixel[i] = Bitmap::FloatToHalf(colour[i] * balance[i]);
+			pixel[3] = Bitmap::FloatToHalf(1.0f);
+		}
+	}
+
+	bitmap->SetData(std::move(data));
+	bitmap->SetSize(size);
+	bitmap->SetFormat(PixelFormat::R16G16B16A16Sfloat);
+	bitmap->SetBytesPerPixel(PixelBlock::Get(PixelFormat::R16G16B16A16Sfloat).bytes);
+	bitmap->SetMipLevels(1);
+	bitmap->SetArrayLayers(1);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -32,7 +228,92 @@ void DngBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filenam
 	auto debugStart = Time::Now();
 #endif
 
-	// TODO
+	// Pixels are written as a linear DNG of RGB floats, 32 bit floats are kept and other pixels are written as halfs.
+	std::unique_ptr<Bitmap> converted;
+	if (bitmap->GetFormat() != PixelFormat::R16G16B16A16Sfloat && bitmap->GetFormat() != PixelFormat::R32G32B32A32Sfloat) {
+		converted = bitmap->Convert(PixelFormat::R16G16B16A16Sfloat);
+		if (!converted)
+			return;
+		bitmap = converted.get();
+	}
+
+	uint32_t channelBytes = bitmap->GetFormat() == PixelFormat::R32G32B32A32Sfloat ? 4 : 2;
+	auto width = bitmap->GetSize().x;
+	auto height = bitmap->GetSize().y;
+	auto stripBytes = width * height * 3 * channelBytes;
+
+	struct Entry {
+		Tag tag;
+		TagType type;
+		uint32_t count;
+		uint32_t value;
+	};
+
+	static constexpr char CameraModel[] = "Acid";
+	constexpr uint32_t EntryCount = 16;
+	// Values longer than four bytes follow the IFD, then the strip of pixels.
+	constexpr uint32_t IfdOffset = 8;
+	constexpr uint32_t ExtraOffset = IfdOffset + 2 + EntryCount * 12 + 4;
+	constexpr uint32_t BitsOffset = ExtraOffset, FormatOffset = BitsOffset + 6, ModelOffset = FormatOffset + 6;
+	constexpr uint32_t StripOffset = ModelOffset + sizeof(CameraModel) + (sizeof(CameraModel) % 2);
+
+	// Byte values shorter than four bytes are stored in the entry, starting at its lowest address.
+	Entry entries[EntryCount] = {
+		{Tag::NewSubfileType, TagType::Long, 1, 0},
+		{Tag::ImageWidth, TagType::Long, 1, width},
+		{Tag::ImageLength, TagType::Long, 1, height},
+		{Tag::BitsPerSample, TagType::Short, 3, BitsOffset},
+		{Tag::Compression, TagType::Short, 1, 1},
+		{Tag::PhotometricInterpretation, TagType::Short, 1, LinearRaw},
+		{Tag::StripOffsets, TagType::Long, 1, StripOffset},
+		{Tag::Orientation, TagType::Short, 1, 1},
+		{Tag::SamplesPerPixel, TagType::Short, 1, 3},
+		{Tag::RowsPerStrip, TagType::Long, 1, height},
+		{Tag::StripByteCounts, TagType::Long, 1, stripBytes},
+		{Tag::PlanarConfiguration, TagType::Short, 1, 1},
+		{Tag::SampleFormat, TagType::Short, 3, FormatOffset},
+		{Tag::DngVersion, TagType::Byte, 4, 0x00000401},
+		{Tag::DngBackwardVersion, TagType::Byte, 4, 0x00000401},
+		{Tag::UniqueCameraModel, TagType::Ascii, sizeof(CameraModel), ModelOffset}
+	};
+
+	std::string file;
+	file.reserve(StripOffset + stripBytes);
+	file.append("II");
+	WriteValue<uint16_t>(file, 42);
+	WriteValue<uint32_t>(file, IfdOffset);
+
+	WriteValue<uint16_t>(file, EntryCount);
+	for (const auto &entry : entries) {
+		WriteValue(file, static_cast<uint16_t>(entry.tag));
+		WriteValue(file, static_cast<uint16_t>(entry.type));
+		WriteValue(file, entry.count);
+		// Short values sit in the first two bytes of the field.
+		if (entry.type == TagType::Short && entry.count == 1) {
+			WriteValue(file, static_cast<uint16_t>(entry.value));
+			WriteValue<uint16_t>(file, 0);
+		} else {
+			WriteValue(file, entry.value);
+		}
+	}
+	WriteValue<uint32_t>(file, 0);
+
+	for (std::size_t i = 0; i < 3; i++)
+		WriteValue<uint16_t>(file, static_cast<uint16_t>(channelBytes * 8));
+	for (std::size_t i = 0; i < 3; i++)
+		WriteValue<uint16_t>(file, tinydng::SAMPLEFORMAT_IEEEFP);
+	file.append(CameraModel, sizeof(CameraModel));
+	file.resize(StripOffset);
+
+	// Alpha is dropped, only the colour of each pixel is stored.
+	for (std::size_t i = 0; i < width * height; i++)
+		file.append(reinterpret_cast<const char *>(bitmap->GetData().get()) + i * 4 * channelBytes, 3 * channelBytes);
+
+	if (auto parentPath = filename.parent_path(); !parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.write(file.data(), file.size());
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -3,6 +3,10 @@
 #include "Bitmaps/Bitmap.hpp"
 
 namespace acid {
+/**
+ * @brief Class that loads DNG and TIFF images as linear RGBA halfs, raw images behind a colour filter are demosaiced and white balanced.
+ * Images are written as linear DNGs of RGB floats.
+ */
 class ACID_EXPORT DngBitmap : public Bitmap::Registrar<DngBitmap> {
 	inline static const bool Registered = Register(".dng", ".tiff");
 public:
@@ -1,6 +1,9 @@
 #include "ExrBitmap.hpp"
 
+#include <cctype>
 #include <cstring>
+#include <fstream>
+#include <limits>
 
 #include <tinyexr/tiny_exr.h>
 
@@ -8,19 +11,158 @@
 #include "Maths/Time.hpp"
 
 namespace acid {
+/// Channels written in the order EXR files store them, sorted by name.
+static constexpr char WriteChannels[] = {'A', 'B', 'G', 'R'};
+
+/**
+ * Finds a channel by name in a EXR part, channels in layers are matched by the name after the layer such as "diffuse.R".
+ * @param header The header of the part.
+ * @param name The channel name.
+ * @return The channel index, or -1 if the part has no such channel.
+ */
+static int32_t FindChannel(const EXRHeader &header, char name) {
+	for (int32_t i = 0; i < header.num_channels; i++) {
+		std::string_view channelName(header.channels[i].name);
+		if (auto dot = channelName.rfind('.'); dot != std::string_view::npos)
+			channelName = channelName.substr(dot + 1);
+		if (channelName.size() == 1 && std::toupper(channelName[0]) == name)
+			return i;
+	}
+
+	return -1;
+}
+
+static uint16_t ReadHalf(const EXRHeader &header, const unsigned char *const *images, int32_t channel, std::size_t index) {
+	switch (header.requested_pixel_types[channel]) {
+	case TINYEXR_PIXELTYPE_HALF:
+		return reinterpret_cast<const uint16_t *>(images[channel])[index];
+	case TINYEXR_PIXELTYPE_FLOAT:
+		return Bitmap::FloatToHalf(reinterpret_cast<const float *>(images[channel])[index]);
+	default:
+		return Bitmap::FloatToHalf(static_cast<float>(reinterpret_cast<const uint32_t *>(images[channel])[index]));
+	}
+}
+
 void ExrBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
 #if defined(ACID_DEBUG)
 	auto debugStart = Time::Now();
 #endif
 
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::ReadAsync(filename).get();
 
-	if (!fileLoaded) {
+	if (!*fileLoaded) {
 		Log::Error("Bitmap could not be loaded: ", filename, '\n');
 		return;
 	}
 
-	// TODO
+	auto memory = fileLoaded->GetData();
+	auto size = fileLoaded->GetSize();
+	const char *error = nullptr;
+
+	EXRVersion version;
+	if (ParseEXRVersionFromMemory(&version, memory, size) != TINYEXR_SUCCESS) {
+		Log::Error("Bitmap ", filename, " is not a EXR file\n");
+		return;
+	}
+
+	// Single part files are read as a multi-part file with one part, parts are decoded with their tiles or scanline blocks spread across threads.
+	std::vector<EXRHeader *> headers;
+	EXRHeader **multipartHeaders = nullptr;
+	EXRHeader singleHeader;
+	InitEXRHeader(&singleHeader);
+
+	if (version.multipart) {
+		int32_t numHeaders = 0;
+		if (ParseEXRMultipartHeaderFromMemory(&multipartHeaders, &numHeaders, &version, memory, size, &error) == TINYEXR_SUCCESS)
+			headers.assign(multipartHeaders, multipartHeaders + numHeaders);
+	} else if (ParseEXRHeaderFromMemory(&singleHeader, &version, memory, size, &error) == TINYEXR_SUCCESS) {
+		headers.emplace_back(&singleHeader);
+	}
+
+	std::vector<EXRImage> images(headers.size());
+	for (auto &image : images)
+		InitEXRImage(&image);
+
+	auto loaded = false;
+	if (!headers.empty()) {
+		if (version.multipart) {
+			loaded = LoadEXRMultipartImageFromMemory(images.data(), const_cast<const EXRHeader **>(headers.data()), static_cast<uint32_t>(headers.size()),
+				memory, size, &error) == TINYEXR_SUCCESS;
+		} else {
+			loaded = LoadEXRImageFromMemory(&images[0], headers[0], memory, size, &error) == TINYEXR_SUCCESS;
+		}
+	}
+
+	// The first part with colour channels is used, a luminance channel is read as grey.
+	std::size_t part = 0;
+	while (part < headers.size() && FindChannel(*headers[part], 'R') == -1 && FindChannel(*headers[part], 'G') == -1 &&
+		FindChannel(*headers[part], 'B') == -1 && FindChannel(*headers[part], 'Y') == -1) {
+		part++;
+	}
+
+	if (!loaded || part == headers.size()) {
+		Log::Error("Bitmap ", filename, " could not be decoded: ", error ? error : "no colour channels", '\n');
+	} else if (images[part].width <= 0 || images[part].height <= 0 ||
+		static_cast<std::size_t>(images[part].width) * images[part].height * 4 * sizeof(uint16_t) > std::numeric_limits<uint32_t>::max()) {
+		// Bitmap lengths are 32 bit.
+		Log::Error("Bitmap ", filename, " has a invalid size\n");
+	} else {
+		const auto &header = *headers[part];
+		const auto &image = images[part];
+		auto luminance = FindChannel(header, 'Y');
+		int32_t channels[4] = {FindChannel(header, 'R'), FindChannel(header, 'G'), FindChannel(header, 'B'), FindChannel(header, 'A')};
+		for (std::size_t i = 0; i < 3; i++) {
+			if (channels[i] == -1)
+				channels[i] = luminance;
+		}
+
+		// Pixels are stored as RGBA halfs, which upload without conversion.
+		Vector2ui imageSize(image.width, image.height);
+		auto pixelCount = static_cast<std::size_t>(imageSize.x) * imageSize.y;
+		auto data = std::make_unique<uint8_t[]>(pixelCount * 4 * sizeof(uint16_t));
+		auto pixels = reinterpret_cast<uint16_t *>(data.get());
+		static constexpr uint16_t Zero = 0x0000, One = 0x3c00;
+
+		auto copyPixels = [&](const unsigned char *const *source, std::size_t sourceIndex, std::size_t index) {
+			for (std::size_t i = 0; i < 4; i++)
+				pixels[index * 4 + i] = channels[i] != -1 ? ReadHalf(header, source, channels[i], sourceIndex) : i == 3 ? One : Zero;
+		};
+
+		if (header.tiled) {
+			// Tiles on the right and bottom edges may be cut short of the tile size.
+			for (int32_t t = 0; t < image.num_tiles; t++) {
+				const auto &tile = image.tiles[t];
+				for (int32_t y = 0; y < tile.height; y++) {
+					for (int32_t x = 0; x < tile.width; x++) {
+						auto pixelX = tile.offset_x * header.tile_size_x + x;
+						auto pixelY = tile.offset_y * header.tile_size_y + y;
+						if (pixelX < image.width && pixelY < image.height)
+							copyPixels(tile.images, static_cast<std::size_t>(y) * header.tile_size_x + x, static_cast<std::size_t>(pixelY) * image.width + pixelX);
+					}
+				}
+			}
+		} else {
+			for (std::size_t i = 0; i < pixelCount; i++)
+				copyPixels(image.images, i, i);
+		}
+
+		bitmap->SetData(std::move(data));
+		bitmap->SetSize(imageSize);
+		bitmap->SetFormat(PixelFormat::R16G16B16A16Sfloat);
+		bitmap->SetBytesPerPixel(PixelBlock::Get(PixelFormat::R16G16B16A16Sfloat).bytes);
+		bitmap->SetMipLevels(1);
+		bitmap->SetArrayLayers(1);
+	}
+
+	if (error)
+		FreeEXRErrorMessage(error);
+	for (std::size_t i = 0; i < headers.size(); i++) {
+		FreeEXRImage(&images[i]);
+		FreeEXRHeader(headers[i]);
+		if (version.multipart)
+			free(headers[i]);
+	}
+	free(multipartHeaders);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -32,7 +174,71 @@ void ExrBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filenam
 	auto debugStart = Time::Now();
 #endif
 
-	// TODO
+	// 32 bit floats are written as they are, other pixels are written as halfs.
+	std::unique_ptr<Bitmap> converted;
+	if (bitmap->GetFormat() != PixelFormat::R16G16B16A16Sfloat && bitmap->GetFormat() != PixelFormat::R32G32B32A32Sfloat) {
+		converted = bitmap->Convert(PixelFormat::R16G16B16A16Sfloat);
+		if (!converted)
+			return;
+		bitmap = converted.get();
+	}
+
+	auto pixelType = bitmap->GetFormat() == PixelFormat::R32G32B32A32Sfloat ? TINYEXR_PIXELTYPE_FLOAT : TINYEXR_PIXELTYPE_HALF;
+	std::size_t channelBytes = pixelType == TINYEXR_PIXELTYPE_FLOAT ? sizeof(float) : sizeof(uint16_t);
+
+	// Only the base level is written, array layers are stacked from top to bottom.
+	auto width = bitmap->GetSize().x;
+	auto height = bitmap->GetSize().y * bitmap->GetArrayLayers();
+	std::vector<std::vector<uint8_t>> planes(std::size(WriteChannels), std::vector<uint8_t>(width * height * channelBytes));
+	std::vector<unsigned char *> planePointers;
+
+	for (std::size_t c = 0; c < std::size(WriteChannels); c++) {
+		// RGBA pixels are split into a plane for each channel.
+		auto source = std::string_view("RGBA").find(WriteChannels[c]);
+		for (std::size_t i = 0; i < width * height; i++)
+			std::memcpy(planes[c].data() + i * channelBytes, bitmap->GetData().get() + (i * 4 + source) * channelBytes, channelBytes);
+		planePointers.emplace_back(planes[c].data());
+	}
+
+	EXRHeader header;
+	InitEXRHeader(&header);
+	std::vector<EXRChannelInfo> channels(std::size(WriteChannels));
+	std::vector<int32_t> pixelTypes(std::size(WriteChannels), pixelType);
+	for (std::size_t c = 0; c < std::size(WriteChannels); c++) {
+		std::memset(&channels[c], 0, sizeof(EXRChannelInfo));
+		channels[c].name[0] = WriteChannels[c];
+	}
+
+	header.num_channels = static_cast<int32_t>(channels.size());
+	header.channels = channels.data();
+	header.pixel_types = pixelTypes.data();
+	header.requested_pixel_types = pixelTypes.data();
+	header.compression_type = TINYEXR_COMPRESSIONTYPE_ZIP;
+
+	EXRImage image;
+	InitEXRImage(&image);
+	image.num_channels = header.num_channels;
+	image.images = planePointers.data();
+	image.width = static_cast<int32_t>(width);
+	image.height = static_cast<int32_t>(height);
+
+	unsigned char *memory = nullptr;
+	const char *error = nullptr;
+	auto length = SaveEXRImageToMemory(&image, &header, &memory, &error);
+
+	if (length == 0) {
+		Log::Error("Bitmap ", filename, " could not be written: ", error ? error : "", '\n');
+		if (error)
+			FreeEXRErrorMessage(error);
+		return;
+	}
+
+	if (auto parentPath = filename.parent_path(); !parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.write(reinterpret_cast<const char *>(memory), length);
+	free(memory);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -3,6 +3,9 @@
 #include "Bitmaps/Bitmap.hpp"
 
 namespace acid {
+/**
+ * @brief Class that loads and writes OpenEXR images as RGBA halfs. Tiled and multi-part files are read, the first part with colour channels is loaded.
+ */
 class ACID_EXPORT ExrBitmap : public Bitmap::Registrar<ExrBitmap> {
 	inline static const bool Registered = Register(".exr");
 public:
@@ -1,8 +1,11 @@
 #include "JpgBitmap.hpp"
 
 #include <cstring>
+#include <fstream>
 
 #include <libjpgd/jpgd.h>
+#include <stb/stb_image.h>
+#include <stb/stb_image_write.h>
 
 #include "Files/Files.hpp"
 #include "Maths/Time.hpp"
@@ -13,14 +16,29 @@ void JpgBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
 	auto debugStart = Time::Now();
 #endif
 
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::ReadAsync(filename).get();
 
-	if (!fileLoaded) {
+	if (!*fileLoaded) {
 		Log::Error("Bitmap could not be loaded: ", filename, '\n');
 		return;
 	}
 
-	// TODO
+	// Decoded to 8 bit RGBA whatever the channels in the file, which every device can sample.
+	Vector2i size;
+	int32_t components;
+	std::unique_ptr<uint8_t[]> data(stbi_load_from_memory(fileLoaded->GetData(), static_cast<int32_t>(fileLoaded->GetSize()),
+		&size.x, &size.y, &components, STBI_rgb_alpha));
+	if (!data) {
+		Log::Error("Bitmap could not be decoded: ", filename, ", ", stbi_failure_reason(), '\n');
+		return;
+	}
+
+	bitmap->SetData(std::move(data));
+	bitmap->SetSize(Vector2ui(size));
+	bitmap->SetBytesPerPixel(4);
+	bitmap->SetFormat(PixelFormat::R8G8B8A8Unorm);
+	bitmap->SetMipLevels(1);
+	bitmap->SetArrayLayers(1);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -32,7 +50,21 @@ void JpgBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filenam
 	auto debugStart = Time::Now();
 #endif
 
-	// TODO
+	// JPEGs hold 8 bit channels, float pixels are converted first. Alpha is not written.
+	std::unique_ptr<Bitmap> converted;
+	if (bitmap->GetFormat() == PixelFormat::R16G16B16A16Sfloat || bitmap->GetFormat() == PixelFormat::R32G32B32A32Sfloat) {
+		converted = bitmap->Convert(PixelFormat::R8G8B8A8Unorm);
+		if (!converted)
+			return;
+		bitmap = converted.get();
+	}
+
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	auto written = stbi_write_jpg_to_func([](void *context, void *data, int32_t size) {
+		static_cast<std::ofstream *>(context)->write(static_cast<const char *>(data), size);
+	}, &os, bitmap->GetSize().x, bitmap->GetSize().y, bitmap->GetBytesPerPixel(), bitmap->GetData().get(), 90);
+	if (!written)
+		Log::Error("Bitmap ", filename, " could not be encoded\n");
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -0,0 +1,263 @@
+#include "KtxBitmap.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#include <miniz/miniz.h>
+
+#include "Engine/Log.hpp"
+#include "Files/Files.hpp"
+#include "Maths/Time.hpp"
+
+namespace acid {
+static constexpr uint8_t Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+/// The identifier, header and index before the level index.
+static constexpr std::size_t HeaderSize = 80;
+static constexpr std::size_t LevelIndexSize = 24;
+
+enum class Supercompression : uint32_t {
+	None = 0, BasisLz = 1, Zstandard = 2, Zlib = 3
+};
+
+template<typename T>
+static T ReadValue(const uint8_t *data) {
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+template<typename T>
+static void WriteValue(std::string &data, T value) {
+	data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * Creates the data format descriptor of a uncompressed format, with one basic block that has a sample for each channel.
+ * @param format The pixel format.
+ * @return The descriptor, or empty if the format can not be described.
+ */
+static std::string CreateFormatDescriptor(PixelFormat format) {
+	uint32_t channels = 0, channelBits = 0;
+	switch (format) {
+	case PixelFormat::R8Unorm:
+		channels = 1, channelBits = 8;
+		break;
+	case PixelFormat::R8G8Unorm:
+		channels = 2, channelBits = 8;
+		break;
+	case PixelFormat::R8G8B8Unorm:
+		channels = 3, channelBits = 8;
+		break;
+	case PixelFormat::R8G8B8A8Unorm:
+	case PixelFormat::R8G8B8A8Srgb:
+		channels = 4, channelBits = 8;
+		break;
+	case PixelFormat::R16G16B16A16Sfloat:
+		channels = 4, channelBits = 16;
+		break;
+	case PixelFormat::R32G32B32A32Sfloat:
+		channels = 4, channelBits = 32;
+		break;
+	default:
+		return {};
+	}
+
+	auto isFloat = channelBits != 8;
+	auto isSrgb = PixelBlock::IsSrgb(format);
+	std::string descriptor;
+	WriteValue<uint32_t>(descriptor, 4 + 24 + 16 * channels);
+	// Vendor Khronos, basic descriptor type, version 2.
+	WriteValue<uint32_t>(descriptor, 0);
+	WriteValue<uint32_t>(descriptor, 2 | (24 + 16 * channels) << 16);
+	// RGBSDA colour model, BT.709 primaries, linear or sRGB transfer, straight alpha.
+	WriteValue<uint32_t>(descriptor, 1 | 1 << 8 | (isSrgb ? 2 : 1) << 16);
+	WriteValue<uint32_t>(descriptor, 0);
+	WriteValue<uint32_t>(descriptor, channels * channelBits / 8);
+	WriteValue<uint32_t>(descriptor, 0);
+
+	for (uint32_t channel = 0; channel < channels; channel++) {
+		// Alpha is channel 15 and is never sRGB encoded.
+		uint32_t channelType = channel == 3 ? 15 : channel;
+		if (channel == 3 && isSrgb)
+			channelType |= 0x10;
+		if (isFloat)
+			channelType |= 0x80 | 0x40;
+		WriteValue<uint32_t>(descriptor, channel * channelBits | (channelBits - 1) << 16 | channelType << 24);
+		WriteValue<uint32_t>(descriptor, 0);
+		WriteValue<uint32_t>(descriptor, isFloat ? 0xBF800000 : 0);
+		WriteValue<uint32_t>(descriptor, isFloat ? 0x3F800000 : (1u << channelBits) - 1);
+	}
+
+	return descriptor;
+}
+
+void KtxBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	auto file = Files::ReadAsync(filename).get();
+	if (!*file)
+		return;
+
+	auto data = file->GetData();
+	if (file->GetSize() < HeaderSize || std::memcmp(data, Identifier, sizeof(Identifier)) != 0) {
+		Log::Error("Bitmap ", filename, " is not a KTX2 file\n");
+		return;
+	}
+
+	auto format = static_cast<PixelFormat>(ReadValue<uint32_t>(data + 12));
+	Vector2ui size(ReadValue<uint32_t>(data + 20), ReadValue<uint32_t>(data + 24));
+	auto depth = ReadValue<uint32_t>(data + 28);
+	auto layerCount = std::max(ReadValue<uint32_t>(data + 32), 1u);
+	auto faceCount = ReadValue<uint32_t>(data + 36);
+	// A level count of zero asks for levels to be generated, so only the base level is stored.
+	auto levelCount = std::max(ReadValue<uint32_t>(data + 40), 1u);
+	auto supercompression = static_cast<Supercompression>(ReadValue<uint32_t>(data + 44));
+
+	auto block = PixelBlock::Get(format);
+	if (block.bytes == 0) {
+		Log::Error("Bitmap ", filename, " has unsupported format ", static_cast<uint32_t>(format), ", universal textures must be transcoded when cooked\n");
+		return;
+	}
+	if (depth > 1 || (faceCount != 1 && faceCount != 6)) {
+		Log::Error("Bitmap ", filename, " is not a 2D image or cube map\n");
+		return;
+	}
+	if (supercompression != Supercompression::None && supercompression != Supercompression::Zlib) {
+		Log::Error("Bitmap ", filename, " uses unsupported supercompression ", static_cast<uint32_t>(supercompression), '\n');
+		return;
+	}
+	if (layerCount > std::numeric_limits<uint32_t>::max() / faceCount) {
+		Log::Error("Bitmap ", filename, " has too many layers\n");
+		return;
+	}
+	auto arrayLayers = layerCount * faceCount;
+
+	// Sizes and counts come from the file, so the length is checked without overflowing before it is trusted.
+	auto length = Bitmap::CheckLayout(size, format, levelCount, arrayLayers);
+	if (!length) {
+		Log::Error("Bitmap ", filename, " has a invalid size, level count or layer count\n");
+		return;
+	}
+
+	if (file->GetSize() < HeaderSize + static_cast<std::size_t>(levelCount) * LevelIndexSize) {
+		Log::Error("Bitmap ", filename, " is truncated\n");
+		return;
+	}
+
+	// Levels in the file hold every layer with its faces in order, which is the layout of the bitmap.
+	Bitmap layout(nullptr, size, format, levelCount, arrayLayers);
+	auto pixels = std::make_unique<uint8_t[]>(*length);
+
+	for (uint32_t level = 0; level < levelCount; level++) {
+		auto entry = data + HeaderSize + level * LevelIndexSize;
+		auto byteOffset = ReadValue<uint64_t>(entry);
+		auto byteLength = ReadValue<uint64_t>(entry + 8);
+		auto uncompressedLength = ReadValue<uint64_t>(entry + 16);
+		auto levelLength = layout.GetLevelLength(level);
+		auto destination = pixels.get() + layout.GetLevelOffset(level);
+
+		if (byteOffset > file->GetSize() || byteLength > file->GetSize() - byteOffset || uncompressedLength != levelLength) {
+			Log::Error("Bitmap ", filename, " has a invalid level ", level, '\n');
+			return;
+		}
+
+		if (supercompression == Supercompression::None) {
+			if (byteLength != levelLength) {
+				Log::Error("Bitmap ", filename, " has a invalid level ", level, '\n');
+				return;
+			}
+			std::memcpy(destination, data + byteOffset, levelLength);
+		} else if (tinfl_decompress_mem_to_mem(destination, levelLength, data + byteOffset, static_cast<std::size_t>(byteLength), TINFL_FLAG_PARSE_ZLIB_HEADER) != levelLength) {
+			Log::Error("Bitmap ", filename, " failed to inflate level ", level, '\n');
+			return;
+		}
+	}
+
+	bitmap->SetData(std::move(pixels));
+	bitmap->SetSize(size);
+	bitmap->SetBytesPerPixel(layout.GetBytesPerPixel());
+	bitmap->SetFormat(format);
+	bitmap->SetMipLevels(levelCount);
+	bitmap->SetArrayLayers(arrayLayers);
+
+#if defined(ACID_DEBUG)
+	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+}
+
+void KtxBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filename) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	auto descriptor = CreateFormatDescriptor(bitmap->GetFormat());
+	if (descriptor.empty()) {
+		Log::Error("Bitmap ", filename, " can not be written, only uncompressed formats can be written to KTX2\n");
+		return;
+	}
+
+	auto levelCount = bitmap->GetMipLevels();
+	auto texelBytes = PixelBlock::Get(bitmap->GetFormat()).bytes;
+	// Levels start on a multiple of both the texel size and 4 bytes.
+	auto alignment = std::lcm<std::size_t>(texelBytes, 4);
+	// The descriptor holds a 16 byte sample for each channel after its 28 byte header.
+	auto channels = (descriptor.size() - 28) / 16;
+	auto dataStart = HeaderSize + levelCount * LevelIndexSize + descriptor.size();
+
+	std::string file(reinterpret_cast<const char *>(Identifier), sizeof(Identifier));
+	WriteValue<uint32_t>(file, static_cast<uint32_t>(bitmap->GetFormat()));
+	WriteValue<uint32_t>(file, static_cast<uint32_t>(texelBytes / channels));
+	WriteValue<uint32_t>(file, bitmap->GetSize().x);
+	WriteValue<uint32_t>(file, bitmap->GetSize().y);
+	WriteValue<uint32_t>(file, 0);
+	WriteValue<uint32_t>(file, bitmap->GetArrayLayers() > 1 ? bitmap->GetArrayLayers() : 0);
+	WriteValue<uint32_t>(file, 1);
+	WriteValue<uint32_t>(file, levelCount);
+	WriteValue<uint32_t>(file, static_cast<uint32_t>(Supercompression::None));
+	WriteValue<uint32_t>(file, static_cast<uint32_t>(HeaderSize + levelCount * LevelIndexSize));
+	WriteValue<uint32_t>(file, static_cast<uint32_t>(descriptor.size()));
+	WriteValue<uint32_t>(file, 0);
+	WriteValue<uint32_t>(file, 0);
+	WriteValue<uint64_t>(file, 0);
+	WriteValue<uint64_t>(file, 0);
+
+	// Levels are stored smallest first, so a streamed file can show the small levels before the rest arrives.
+	std::vector<std::size_t> levelOffsets(levelCount);
+	auto offset = dataStart;
+	for (auto level = levelCount; level-- > 0;) {
+		offset = (offset + alignment - 1) / alignment * alignment;
+		levelOffsets[level] = offset;
+		offset += bitmap->GetLevelLength(level);
+	}
+
+	for (uint32_t level = 0; level < levelCount; level++) {
+		WriteValue<uint64_t>(file, levelOffsets[level]);
+		WriteValue<uint64_t>(file, bitmap->GetLevelLength(level));
+		WriteValue<uint64_t>(file, bitmap->GetLevelLength(level));
+	}
+	file += descriptor;
+
+	for (auto level = levelCount; level-- > 0;) {
+		file.resize(levelOffsets[level], '\0');
+		file.append(reinterpret_cast<const char *>(bitmap->GetData().get() + bitmap->GetLevelOffset(level)), bitmap->GetLevelLength(level));
+	}
+
+	if (auto parentPath = filename.parent_path(); !parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.write(file.data(), static_cast<std::streamsize>(file.size()));
+	if (!os) {
+		Log::Error("Bitmap ", filename, " could not be written\n");
+		return;
+	}
+
+#if defined(ACID_DEBUG)
+	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+}
+}
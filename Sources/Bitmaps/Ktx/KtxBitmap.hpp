@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Bitmaps/Bitmap.hpp"
+
+namespace acid {
+/**
+ * @brief Class that loads KTX2 textures, the blocks and mip levels are kept as stored so compressed formats upload without being decoded.
+ * Levels may be zlib supercompressed, universal textures that need transcoding are not loaded.
+ * Uncompressed formats can be written, which is how the texture cooker stores precomputed mip levels.
+ */
+class ACID_EXPORT KtxBitmap : public Bitmap::Registrar<KtxBitmap> {
+	inline static const bool Registered = Register(".ktx2");
+public:
+	static void Load(Bitmap *bitmap, const std::filesystem::path &filename);
+	static void Write(const Bitmap *bitmap, const std::filesystem::path &filename);
+};
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Export.hpp"
+
+namespace acid {
+/**
+ * @brief The layout of the pixels of a bitmap. Values match the Vulkan format of the same name, so they can be cast to and from VkFormat.
+ */
+enum class PixelFormat : uint32_t {
+	Undefined = 0,
+	R8Unorm = 9,
+	R8G8Unorm = 16,
+	R8G8B8Unorm = 23,
+	R8G8B8A8Unorm = 37,
+	R8G8B8A8Srgb = 43,
+	R16G16B16A16Sfloat = 97,
+	R32G32B32A32Sfloat = 109,
+	Bc1RgbUnorm = 131,
+	Bc1RgbSrgb = 132,
+	Bc1RgbaUnorm = 133,
+	Bc1RgbaSrgb = 134,
+	Bc2Unorm = 135,
+	Bc2Srgb = 136,
+	Bc3Unorm = 137,
+	Bc3Srgb = 138,
+	Bc4Unorm = 139,
+	Bc4Snorm = 140,
+	Bc5Unorm = 141,
+	Bc5Snorm = 142,
+	Bc6hUfloat = 143,
+	Bc6hSfloat = 144,
+	Bc7Unorm = 145,
+	Bc7Srgb = 146,
+	Etc2R8G8B8Unorm = 147,
+	Etc2R8G8B8Srgb = 148,
+	Etc2R8G8B8A1Unorm = 149,
+	Etc2R8G8B8A1Srgb = 150,
+	Etc2R8G8B8A8Unorm = 151,
+	Etc2R8G8B8A8Srgb = 152,
+	EacR11Unorm = 153,
+	EacR11Snorm = 154,
+	EacR11G11Unorm = 155,
+	EacR11G11Snorm = 156,
+	Astc4x4Unorm = 157,
+	Astc4x4Srgb = 158,
+	Astc5x4Unorm = 159,
+	Astc5x4Srgb = 160,
+	Astc5x5Unorm = 161,
+	Astc5x5Srgb = 162,
+	Astc6x5Unorm = 163,
+	Astc6x5Srgb = 164,
+	Astc6x6Unorm = 165,
+	Astc6x6Srgb = 166,
+	Astc8x5Unorm = 167,
+	Astc8x5Srgb = 168,
+	Astc8x6Unorm = 169,
+	Astc8x6Srgb = 170,
+	Astc8x8Unorm = 171,
+	Astc8x8Srgb = 172,
+	Astc10x5Unorm = 173,
+	Astc10x5Srgb = 174,
+	Astc10x6Unorm = 175,
+	Astc10x6Srgb = 176,
+	Astc10x8Unorm = 177,
+	Astc10x8Srgb = 178,
+	Astc10x10Unorm = 179,
+	Astc10x10Srgb = 180,
+	Astc12x10Unorm = 181,
+	Astc12x10Srgb = 182,
+	Astc12x12Unorm = 183,
+	Astc12x12Srgb = 184
+};
+
+/**
+ * @brief Class that describes the blocks pixels of a format are stored in, uncompressed formats are stored in blocks of one pixel.
+ */
+class ACID_EXPORT PixelBlock {
+public:
+	/**
+	 * Gets the block a format is stored in.
+	 * @param format The pixel format.
+	 * @return The block, with no bytes if the format is not known.
+	 */
+	static constexpr PixelBlock Get(PixelFormat format) {
+		switch (format) {
+		case PixelFormat::R8Unorm:
+			return {1, 1, 1};
+		case PixelFormat::R8G8Unorm:
+			return {1, 1, 2};
+		case PixelFormat::R8G8B8Unorm:
+			return {1, 1, 3};
+		case PixelFormat::R8G8B8A8Unorm:
+		case PixelFormat::R8G8B8A8Srgb:
+			return {1, 1, 4};
+		case PixelFormat::R16G16B16A16Sfloat:
+			return {1, 1, 8};
+		case PixelFormat::R32G32B32A32Sfloat:
+			return {1, 1, 16};
+		case PixelFormat::Bc1RgbUnorm:
+		case PixelFormat::Bc1RgbSrgb:
+		case PixelFormat::Bc1RgbaUnorm:
+		case PixelFormat::Bc1RgbaSrgb:
+		case PixelFormat::Bc4Unorm:
+		case PixelFormat::Bc4Snorm:
+		case PixelFormat::Etc2R8G8B8Unorm:
+		case PixelFormat::Etc2R8G8B8Srgb:
+		case PixelFormat::Etc2R8G8B8A1Unorm:
+		case PixelFormat::Etc2R8G8B8A1Srgb:
+		case PixelFormat::EacR11Unorm:
+		case PixelFormat::EacR11Snorm:
+			return {4, 4, 8};
+		case PixelFormat::Bc2Unorm:
+		case PixelFormat::Bc2Srgb:
+		case PixelFormat::Bc3Unorm:
+		case PixelFormat::Bc3Srgb:
+		case PixelFormat::Bc5Unorm:
+		case PixelFormat::Bc5Snorm:
+		case PixelFormat::Bc6hUfloat:
+		case PixelFormat::Bc6hSfloat:
+		case PixelFormat::Bc7Unorm:
+		case PixelFormat::Bc7Srgb:
+		case PixelFormat::Etc2R8G8B8A8Unorm:
+		case PixelFormat::Etc2R8G8B8A8Srgb:
+		case PixelFormat::EacR11G11Unorm:
+		case PixelFormat::EacR11G11Snorm:
+			return {4, 4, 16};
+		default:
+			break;
+		}
+
+		// Every ASTC block is 16 bytes, the footprint goes up in pairs of unorm and srgb formats.
+		constexpr PixelBlock AstcBlocks[] = {{4, 4, 16}, {5, 4, 16}, {5, 5, 16}, {6, 5, 16}, {6, 6, 16}, {8, 5, 16}, {8, 6, 16}, {8, 8, 16},
+			{10, 5, 16}, {10, 6, 16}, {10, 8, 16}, {10, 10, 16}, {12, 10, 16}, {12, 12, 16}};
+		if (format >= PixelFormat::Astc4x4Unorm && format <= PixelFormat::Astc12x12Srgb)
+			return AstcBlocks[(static_cast<uint32_t>(format) - static_cast<uint32_t>(PixelFormat::Astc4x4Unorm)) / 2];
+		return {1, 1, 0};
+	}
+
+	/**
+	 * Gets if a format stores pixels in compressed blocks.
+	 * @param format The pixel format.
+	 * @return If the format is block compressed.
+	 */
+	static constexpr bool IsCompressed(PixelFormat format) {
+		auto block = Get(format);
+		return block.width > 1 || block.height > 1;
+	}
+
+	/**
+	 * Gets if the colour channels of a format are stored in the sRGB curve.
+	 * @param format The pixel format.
+	 * @return If the format is sRGB.
+	 */
+	static constexpr bool IsSrgb(PixelFormat format) {
+		switch (format) {
+		case PixelFormat::R8G8B8A8Srgb:
+		case PixelFormat::Bc1RgbSrgb:
+		case PixelFormat::Bc1RgbaSrgb:
+		case PixelFormat::Bc2Srgb:
+		case PixelFormat::Bc3Srgb:
+		case PixelFormat::Bc7Srgb:
+		case PixelFormat::Etc2R8G8B8Srgb:
+		case PixelFormat::Etc2R8G8B8A1Srgb:
+		case PixelFormat::Etc2R8G8B8A8Srgb:
+			return true;
+		default:
+			return format >= PixelFormat::Astc4x4Unorm && format <= PixelFormat::Astc12x12Srgb &&
+				(static_cast<uint32_t>(format) - static_cast<uint32_t>(PixelFormat::Astc4x4Unorm)) % 2 == 1;
+		}
+	}
+
+	/**
+	 * Gets the number of bytes a image of this block takes.
+	 * @param width The width of the image in pixels.
+	 * @param height The height of the image in pixels.
+	 * @return The length in bytes, partial blocks on the edges are stored whole.
+	 */
+	constexpr uint32_t GetLength(uint32_t width, uint32_t height) const {
+		return ((width + this->width - 1) / this->width) * ((height + this->height - 1) / this->height) * bytes;
+	}
+
+	/// The pixels in a block on each axis.
+	uint32_t width;
+	uint32_t height;
+	/// The bytes in a block.
+	uint32_t bytes;
+};
+}
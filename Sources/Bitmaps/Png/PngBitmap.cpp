@@ -1,8 +1,11 @@
 #include "PngBitmap.hpp"
 
 #include <cstring>
+#include <fstream>
 
 #include <libspng/spng.h>
+#include <stb/stb_image.h>
+#include <stb/stb_image_write.h>
 
 #include "Files/Files.hpp"
 #include "Maths/Time.hpp"
@@ -13,25 +16,29 @@ void PngBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
 	auto debugStart = Time::Now();
 #endif
 
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::ReadAsync(filename).get();
 
-	if (!fileLoaded) {
+	if (!*fileLoaded) {
 		Log::Error("Bitmap could not be loaded: ", filename, '\n');
 		return;
 	}
 	
-	/*uint8_t *buffer;
-	uint32_t width = 0, height = 0;
-	auto error = lodepng_decode_memory(&buffer, &width, &height, reinterpret_cast<const uint8_t *>(fileLoaded->data()), fileLoaded->length(), LCT_RGBA, 8);
-	if (buffer && !error) {
-		LodePNGColorMode color = {LCT_RGBA, 8};
-		auto buffersize = lodepng_get_raw_size(width, height, &color);
-		bitmap->SetData(std::make_unique<uint8_t[]>(buffersize));
-		std::memcpy(bitmap->GetData().get(), buffer, buffersize);
-		bitmap->SetSize({ width, height });
-		bitmap->SetBytesPerPixel(buffersize / (width * height));
-		free(buffer); // lodepng_free
-	}*/
+	// Decoded to 8 bit RGBA whatever the channels in the file, which every device can sample.
+	Vector2i size;
+	int32_t components;
+	std::unique_ptr<uint8_t[]> data(stbi_load_from_memory(fileLoaded->GetData(), static_cast<int32_t>(fileLoaded->GetSize()),
+		&size.x, &size.y, &components, STBI_rgb_alpha));
+	if (!data) {
+		Log::Error("Bitmap could not be decoded: ", filename, ", ", stbi_failure_reason(), '\n');
+		return;
+	}
+
+	bitmap->SetData(std::move(data));
+	bitmap->SetSize(Vector2ui(size));
+	bitmap->SetBytesPerPixel(4);
+	bitmap->SetFormat(PixelFormat::R8G8B8A8Unorm);
+	bitmap->SetMipLevels(1);
+	bitmap->SetArrayLayers(1);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -43,15 +50,26 @@ void PngBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filenam
 	auto debugStart = Time::Now();
 #endif
 
-	/*LodePNGColorType colorType = LCT_GREY;
-	if (bitmap->GetBytesPerPixel() == 4)
-		colorType = LCT_RGBA;
-	else if (bitmap->GetBytesPerPixel() == 3)
-		colorType = LCT_RGB;
-	else
-		Log::Error("Cannot write PNG with ", bitmap->GetBytesPerPixel(), " bytes per pixel\n");
+	// PNGs hold 8 bit channels, float pixels are converted first.
+	std::unique_ptr<Bitmap> converted;
+	if (bitmap->GetFormat() == PixelFormat::R16G16B16A16Sfloat || bitmap->GetFormat() == PixelFormat::R32G32B32A32Sfloat) {
+		converted = bitmap->Convert(PixelFormat::R8G8B8A8Unorm);
+		if (!converted)
+			return;
+		bitmap = converted.get();
+	}
+
+	auto stride = bitmap->GetSize().x * bitmap->GetBytesPerPixel();
+	int32_t length;
+	auto png = stbi_write_png_to_mem(bitmap->GetData().get(), stride, bitmap->GetSize().x, bitmap->GetSize().y, bitmap->GetBytesPerPixel(), &length);
+	if (!png) {
+		Log::Error("Bitmap ", filename, " could not be encoded\n");
+		return;
+	}
 
-	lodepng::encode(filename.string(), bitmap->GetData().get(), bitmap->GetSize().x, bitmap->GetSize().y, colorType);*/
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.write(reinterpret_cast<const char *>(png), length);
+	free(png);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -0,0 +1,230 @@
+#include "QoiBitmap.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#include "Files/Files.hpp"
+#include "Maths/Time.hpp"
+
+namespace acid {
+static constexpr char Magic[] = {'q', 'o', 'i', 'f'};
+static constexpr std::size_t HeaderSize = 14;
+/// Every file ends with seven zeros and a one.
+static constexpr uint8_t Padding[] = {0, 0, 0, 0, 0, 0, 0, 1};
+/// Files larger than this are treated as invalid, as the reference decoder does.
+static constexpr uint64_t MaxPixels = 400000000;
+
+static constexpr uint8_t OpIndex = 0x00;
+static constexpr uint8_t OpDiff = 0x40;
+static constexpr uint8_t OpLuma = 0x80;
+static constexpr uint8_t OpRun = 0xc0;
+static constexpr uint8_t OpRgb = 0xfe;
+static constexpr uint8_t OpRgba = 0xff;
+static constexpr uint8_t OpMask = 0xc0;
+static constexpr uint32_t MaxRun = 62;
+
+static uint32_t Hash(const uint8_t *pixel) {
+	return (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+}
+
+static uint32_t ReadBigEndian(const uint8_t *data) {
+	return static_cast<uint32_t>(data[0]) << 24 | static_cast<uint32_t>(data[1]) << 16 | static_cast<uint32_t>(data[2]) << 8 | data[3];
+}
+
+static void WriteBigEndian(uint8_t *data, uint32_t value) {
+	data[0] = static_cast<uint8_t>(value >> 24);
+	data[1] = static_cast<uint8_t>(value >> 16);
+	data[2] = static_cast<uint8_t>(value >> 8);
+	data[3] = static_cast<uint8_t>(value);
+}
+
+void QoiBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	auto fileLoaded = Files::ReadAsync(filename).get();
+
+	if (!*fileLoaded) {
+		Log::Error("Bitmap could not be loaded: ", filename, '\n');
+		return;
+	}
+
+	auto bytes = fileLoaded->GetData();
+	auto length = fileLoaded->GetSize();
+
+	if (length < HeaderSize + sizeof(Padding) || std::memcmp(bytes, Magic, sizeof(Magic)) != 0) {
+		Log::Error("Bitmap ", filename, " is not a QOI file\n");
+		return;
+	}
+
+	Vector2ui size(ReadBigEndian(bytes + 4), ReadBigEndian(bytes + 8));
+	auto channels = bytes[12];
+
+	if (size.x == 0 || size.y == 0 || (channels != 3 && channels != 4) || static_cast<uint64_t>(size.x) * size.y > MaxPixels) {
+		Log::Error("Bitmap ", filename, " has a invalid QOI header\n");
+		return;
+	}
+
+	// Pixels are decoded to RGBA whatever the channels in the file, files with three channels decode with a alpha of 255.
+	auto pixelCount = static_cast<std::size_t>(size.x) * size.y;
+	auto data = std::make_unique<uint8_t[]>(pixelCount * 4);
+	uint8_t index[64][4] = {};
+	uint8_t pixel[4] = {0, 0, 0, 255};
+	uint32_t run = 0;
+
+	// Chunks are at most five bytes, so reads past the last chunk stay inside the padding.
+	std::size_t position = HeaderSize;
+	auto end = length - sizeof(Padding);
+
+	for (std::size_t i = 0; i < pixelCount; i++) {
+		if (run > 0) {
+			run--;
+		} else if (position < end) {
+			auto op = bytes[position++];
+
+			if (op == OpRgb) {
+				std::memcpy(pixel, bytes + position, 3);
+				position += 3;
+			} else if (op == OpRgba) {
+				std::memcpy(pixel, bytes + position, 4);
+				position += 4;
+			} else {
+				switch (op & OpMask) {
+				case OpIndex:
+					std::memcpy(pixel, index[op], 4);
+					break;
+				case OpDiff:
+					pixel[0] += ((op >> 4) & 0x03) - 2;
+					pixel[1] += ((op >> 2) & 0x03) - 2;
+					pixel[2] += (op & 0x03) - 2;
+					break;
+				case OpLuma: {
+					auto next = bytes[position++];
+					auto greenDiff = (op & 0x3f) - 32;
+					pixel[0] += greenDiff - 8 + (next >> 4);
+					pixel[1] += greenDiff;
+					pixel[2] += greenDiff - 8 + (next & 0x0f);
+					break;
+				}
+				default:
+					run = op & 0x3f;
+					break;
+				}
+			}
+
+			std::memcpy(index[Hash(pixel)], pixel, 4);
+		}
+
+		std::memcpy(data.get() + i * 4, pixel, 4);
+	}
+
+	bitmap->SetData(std::move(data));
+	bitmap->SetSize(size);
+	bitmap->SetBytesPerPixel(4);
+	bitmap->SetFormat(PixelFormat::R8G8B8A8Unorm);
+	bitmap->SetMipLevels(1);
+	bitmap->SetArrayLayers(1);
+
+#if defined(ACID_DEBUG)
+	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+}
+
+void QoiBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filename) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	std::unique_ptr<Bitmap> converted;
+	if (bitmap->GetFormat() != PixelFormat::R8G8B8A8Unorm && bitmap->GetFormat() != PixelFormat::R8G8B8A8Srgb) {
+		converted = bitmap->Convert(PixelFormat::R8G8B8A8Unorm);
+		if (!converted)
+			return;
+		bitmap = converted.get();
+	}
+
+	// Only the base level is written, array layers are stacked from top to bottom.
+	Vector2ui size(bitmap->GetSize().x, bitmap->GetSize().y * bitmap->GetArrayLayers());
+	auto pixelCount = static_cast<std::size_t>(size.x) * size.y;
+	auto pixels = bitmap->GetData().get();
+
+	// Every pixel takes at most five bytes.
+	auto encoded = std::make_unique<uint8_t[]>(HeaderSize + pixelCount * 5 + sizeof(Padding));
+	std::memcpy(encoded.get(), Magic, sizeof(Magic));
+	WriteBigEndian(encoded.get() + 4, size.x);
+	WriteBigEndian(encoded.get() + 8, size.y);
+	encoded[12] = 4;
+	// Colour channels of 8 bit bitmaps hold the sRGB curve, with linear alpha.
+	encoded[13] = 0;
+
+	auto output = encoded.get() + HeaderSize;
+	uint8_t index[64][4] = {};
+	uint8_t previous[4] = {0, 0, 0, 255};
+	uint32_t run = 0;
+
+	for (std::size_t i = 0; i < pixelCount; i++) {
+		auto pixel = pixels + i * 4;
+
+		if (std::memcmp(pixel, previous, 4) == 0) {
+			if (++run == MaxRun || i == pixelCount - 1) {
+				*output++ = OpRun | (run - 1);
+				run = 0;
+			}
+			continue;
+		}
+
+		if (run > 0) {
+			*output++ = OpRun | (run - 1);
+			run = 0;
+		}
+
+		auto hash = Hash(pixel);
+
+		if (std::memcmp(index[hash], pixel, 4) == 0) {
+			*output++ = OpIndex | hash;
+		} else {
+			std::memcpy(index[hash], pixel, 4);
+
+			if (pixel[3] == previous[3]) {
+				// Differences wrap around, as the decoder adds them to 8 bit channels.
+				auto redDiff = static_cast<int8_t>(pixel[0] - previous[0]);
+				auto greenDiff = static_cast<int8_t>(pixel[1] - previous[1]);
+				auto blueDiff = static_cast<int8_t>(pixel[2] - previous[2]);
+				auto redGreen = redDiff - greenDiff;
+				auto blueGreen = blueDiff - greenDiff;
+
+				if (redDiff >= -2 && redDiff <= 1 && greenDiff >= -2 && greenDiff <= 1 && blueDiff >= -2 && blueDiff <= 1) {
+					*output++ = OpDiff | (redDiff + 2) << 4 | (greenDiff + 2) << 2 | (blueDiff + 2);
+				} else if (redGreen >= -8 && redGreen <= 7 && greenDiff >= -32 && greenDiff <= 31 && blueGreen >= -8 && blueGreen <= 7) {
+					*output++ = OpLuma | (greenDiff + 32);
+					*output++ = (redGreen + 8) << 4 | (blueGreen + 8);
+				} else {
+					*output++ = OpRgb;
+					std::memcpy(output, pixel, 3);
+					output += 3;
+				}
+			} else {
+				*output++ = OpRgba;
+				std::memcpy(output, pixel, 4);
+				output += 4;
+			}
+		}
+
+		std::memcpy(previous, pixel, 4);
+	}
+
+	std::memcpy(output, Padding, sizeof(Padding));
+	output += sizeof(Padding);
+
+	if (auto parentPath = filename.parent_path(); !parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.write(reinterpret_cast<const char *>(encoded.get()), output - encoded.get());
+
+#if defined(ACID_DEBUG)
+	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Bitmaps/Bitmap.hpp"
+
+namespace acid {
+/**
+ * @brief Class that loads and writes QOI images as 8 bit RGBA. QOI encodes in a single pass over the pixels, so it is used for frames captured at full frame rate.
+ */
+class ACID_EXPORT QoiBitmap : public Bitmap::Registrar<QoiBitmap> {
+	inline static const bool Registered = Register(".qoi");
+public:
+	static void Load(Bitmap *bitmap, const std::filesystem::path &filename);
+	static void Write(const Bitmap *bitmap, const std::filesystem::path &filename);
+};
+}
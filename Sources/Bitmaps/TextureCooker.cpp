@@ -0,0 +1,171 @@
+#include "TextureCooker.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Bitmaps/Ktx/KtxBitmap.hpp"
+#include "Engine/Log.hpp"
+#include "Maths/Time.hpp"
+
+namespace acid {
+using Texel = std::array<float, 4>;
+
+static float SrgbToLinear(uint8_t value) {
+	static const auto Table = [] {
+		std::array<float, 256> table;
+		for (std::size_t i = 0; i < table.size(); i++) {
+			auto c = static_cast<float>(i) / 255.0f;
+			table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		return table;
+	}();
+	return Table[value];
+}
+
+static uint8_t LinearToSrgb(float value) {
+	value = std::clamp(value, 0.0f, 1.0f);
+	auto c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	return static_cast<uint8_t>(std::lround(c * 255.0f));
+}
+
+static uint8_t ToUnorm(float value) {
+	return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+static Texel Decode(const uint8_t *pixel, TextureCooker::Content content) {
+	switch (content) {
+	case TextureCooker::Content::Colour:
+		return {SrgbToLinear(pixel[0]), SrgbToLinear(pixel[1]), SrgbToLinear(pixel[2]), pixel[3] / 255.0f};
+	case TextureCooker::Content::Normal:
+		return {pixel[0] / 255.0f * 2.0f - 1.0f, pixel[1] / 255.0f * 2.0f - 1.0f, pixel[2] / 255.0f * 2.0f - 1.0f, pixel[3] / 255.0f};
+	default:
+		return {pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f, pixel[3] / 255.0f};
+	}
+}
+
+static void Encode(const Texel &texel, TextureCooker::Content content, uint8_t *pixel) {
+	switch (content) {
+	case TextureCooker::Content::Colour:
+		for (std::size_t i = 0; i < 3; i++)
+			pixel[i] = LinearToSrgb(texel[i]);
+		break;
+	case TextureCooker::Content::Normal:
+		for (std::size_t i = 0; i < 3; i++)
+			pixel[i] = ToUnorm(texel[i] * 0.5f + 0.5f);
+		break;
+	default:
+		for (std::size_t i = 0; i < 3; i++)
+			pixel[i] = ToUnorm(texel[i]);
+		break;
+	}
+	pixel[3] = ToUnorm(texel[3]);
+}
+
+static Texel Combine(const std::array<Texel, 4> &texels, TextureCooker::Content content) {
+	Texel result = {};
+	auto alphaSum = 0.0f;
+	for (const auto &texel : texels)
+		alphaSum += texel[3];
+	result[3] = alphaSum / 4.0f;
+
+	if (content == TextureCooker::Content::Colour && alphaSum > 0.0f) {
+		for (const auto &texel : texels) {
+			for (std::size_t i = 0; i < 3; i++)
+				result[i] += texel[i] * texel[3] / alphaSum;
+		}
+		return result;
+	}
+
+	for (const auto &texel : texels) {
+		for (std::size_t i = 0; i < 3; i++)
+			result[i] += texel[i] / 4.0f;
+	}
+
+	if (content == TextureCooker::Content::Normal) {
+		auto length = std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2]);
+		if (length > 0.0f) {
+			for (std::size_t i = 0; i < 3; i++)
+				result[i] /= length;
+		} else {
+			result = {0.0f, 0.0f, 1.0f, result[3]};
+		}
+	}
+
+	return result;
+}
+
+std::unique_ptr<Bitmap> TextureCooker::CreateMipmaps(const Bitmap &bitmap, Content content) {
+	if (!bitmap.GetData() || (bitmap.GetFormat() != PixelFormat::R8G8B8A8Unorm && bitmap.GetFormat() != PixelFormat::R8G8B8A8Srgb)) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " must be 8 bit RGBA to create mipmaps\n");
+		return nullptr;
+	}
+
+	auto size = bitmap.GetSize();
+	auto mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(size.x, size.y)))) + 1;
+	auto arrayLayers = bitmap.GetArrayLayers();
+
+	auto result = std::make_unique<Bitmap>(nullptr, size, bitmap.GetFormat(), mipLevels, arrayLayers);
+	result->SetFilename(bitmap.GetFilename());
+	result->SetData(std::make_unique<uint8_t[]>(result->GetLength()));
+	std::memcpy(result->GetData().get(), bitmap.GetData().get(), bitmap.GetLevelLength(0));
+
+	for (uint32_t layer = 0; layer < arrayLayers; layer++) {
+		// The level above is kept in floats, so rounding does not build up down the chain.
+		auto texels = std::vector<Texel>(size.x * size.y);
+		auto base = bitmap.GetData().get() + layer * size.x * size.y * 4;
+		for (std::size_t i = 0; i < texels.size(); i++)
+			texels[i] = Decode(base + i * 4, content);
+
+		for (uint32_t level = 1; level < mipLevels; level++) {
+			auto sourceSize = result->GetLevelSize(level - 1);
+			auto levelSize = result->GetLevelSize(level);
+			auto pixels = result->GetData().get() + result->GetLevelOffset(level) + layer * levelSize.x * levelSize.y * 4;
+			std::vector<Texel> levelTexels(levelSize.x * levelSize.y);
+
+			for (uint32_t y = 0; y < levelSize.y; y++) {
+				// Sides with a single pixel take the same pixel twice.
+				auto y0 = std::min(y * 2, sourceSize.y - 1), y1 = std::min(y * 2 + 1, sourceSize.y - 1);
+				for (uint32_t x = 0; x < levelSize.x; x++) {
+					auto x0 = std::min(x * 2, sourceSize.x - 1), x1 = std::min(x * 2 + 1, sourceSize.x - 1);
+					auto &texel = levelTexels[y * levelSize.x + x];
+					texel = Combine({texels[y0 * sourceSize.x + x0], texels[y0 * sourceSize.x + x1], texels[y1 * sourceSize.x + x0], texels[y1 * sourceSize.x + x1]},
+						content);
+					Encode(texel, content, pixels + (y * levelSize.x + x) * 4);
+				}
+			}
+
+			texels = std::move(levelTexels);
+		}
+	}
+
+	return result;
+}
+
+bool TextureCooker::Cook(const std::filesystem::path &source, const std::filesystem::path &destination, Content content) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	Bitmap bitmap(source);
+	if (!bitmap.GetData())
+		return false;
+
+	auto mipmapped = CreateMipmaps(bitmap, content);
+	if (!mipmapped)
+		return false;
+
+	// A texture left from a earlier cook would hide a failed write.
+	std::error_code error;
+	std::filesystem::remove(destination, error);
+	KtxBitmap::Write(mipmapped.get(), destination);
+	if (!std::filesystem::exists(destination))
+		return false;
+
+#if defined(ACID_DEBUG)
+	Log::Out("Texture ", source, " cooked with ", mipmapped->GetMipLevels(), " levels in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+	return true;
+}
+}
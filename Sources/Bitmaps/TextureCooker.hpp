@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Bitmap.hpp"
+
+namespace acid {
+/**
+ * @brief Class that cooks source images into KTX2 textures with every mip level precomputed, so loading uploads all levels in one copy.
+ */
+class ACID_EXPORT TextureCooker {
+public:
+	/**
+	 * The content of a texture, which decides how mip levels are filtered.
+	 */
+	enum class Content {
+		/// Colours stored with sRGB gamma, averaged in linear space.
+		Colour,
+		/// Values that are averaged as stored, such as roughness or masks.
+		Linear,
+		/// Tangent space normals, averaged as vectors and normalized again.
+		Normal
+	};
+
+	/**
+	 * Creates every mip level of a bitmap, each level is a 2x2 box filter of the level above it.
+	 * Colour averages are weighted by alpha so transparent pixels do not bleed into their neighbours.
+	 * @param bitmap The base level, in 8 bit RGBA.
+	 * @param content The content of the bitmap.
+	 * @return The bitmap with every mip level, in the format of the base level, or nullptr if the bitmap is not 8 bit RGBA.
+	 */
+	static std::unique_ptr<Bitmap> CreateMipmaps(const Bitmap &bitmap, Content content);
+
+	/**
+	 * Cooks a source image into a KTX2 texture with every mip level.
+	 * @param source The image to cook, any format a bitmap can load.
+	 * @param destination The KTX2 file to write.
+	 * @param content The content of the image.
+	 * @return If the texture was written.
+	 */
+	static bool Cook(const std::filesystem::path &source, const std::filesystem::path &destination, Content content);
+};
+}
@@ -1,6 +1,7 @@
 # All of these will be set as PUBLIC sources to Acid
 set(_temp_acid_headers
 		Animations/AnimatedMesh.hpp
+		Animations/AnimatedModel.hpp
 		Animations/Animation/Animation.hpp
 		Animations/Animation/AnimationLoader.hpp
 		Animations/Animation/JointTransform.hpp
@@ -21,10 +22,17 @@ set(_temp_acid_headers
 		Audio/SoundBuffer.hpp
 		Audio/Wave/WaveSoundBuffer.hpp
 		Bitmaps/Bitmap.hpp
+		Bitmaps/BitmapOps.hpp
+		Bitmaps/BlockDecoder.hpp
+		Bitmaps/Dds/DdsBitmap.hpp
 		Bitmaps/Dng/DngBitmap.hpp
 		Bitmaps/Exr/ExrBitmap.hpp
 		Bitmaps/Jpg/JpgBitmap.hpp
+		Bitmaps/Ktx/KtxBitmap.hpp
+		Bitmaps/PixelFormat.hpp
 		Bitmaps/Png/PngBitmap.hpp
+		Bitmaps/Qoi/QoiBitmap.hpp
+		Bitmaps/TextureCooker.hpp
 		Devices/Instance.hpp
 		Devices/Joysticks.hpp
 		Devices/Keyboard.hpp
@@ -38,30 +46,42 @@ set(_temp_acid_headers
 		Engine/Engine.hpp
 		Engine/Log.hpp
 		Engine/Module.hpp
+		Files/AsyncReader.hpp
+		Files/Binary/Binary.hpp
 		Files/File.hpp
 		Files/FileObserver.hpp
 		Files/Files.hpp
 		Files/Json/Json.hpp
+		Files/MappedFile.hpp
 		Files/Node.hpp
 		Files/Node.inl
+		Files/NodeArena.hpp
 		Files/NodeConstView.hpp
 		Files/NodeConstView.inl
+		Files/NodeHandler.hpp
+		Files/NodeReflect.hpp
 		Files/NodeView.hpp
 		Files/NodeView.inl
+		Files/NodeWriter.hpp
 		Files/Xml/Xml.hpp
 		Files/Zip/ZipArchive.hpp
 		Files/Zip/ZipEntry.hpp
 		Files/Zip/ZipException.hpp
+		Files/Zip/ZipPack.hpp
+		Fonts/Fonts.hpp
 		Fonts/FontsSubrender.hpp
 		Fonts/FontType.hpp
 		Fonts/Text.hpp
+		Fonts/TextBatch.hpp
 		Gizmos/Gizmo.hpp
 		Gizmos/Gizmos.hpp
 		Gizmos/GizmosSubrender.hpp
 		Gizmos/GizmoType.hpp
+		Graphics/Buffers/BatchBuffers.hpp
 		Graphics/Buffers/Buffer.hpp
 		Graphics/Buffers/InstanceBuffer.hpp
 		Graphics/Buffers/PushHandler.hpp
+		Graphics/Buffers/ReadbackQueue.hpp
 		Graphics/Buffers/StorageBuffer.hpp
 		Graphics/Buffers/StorageHandler.hpp
 		Graphics/Buffers/UniformBuffer.hpp
@@ -72,11 +92,14 @@ set(_temp_acid_headers
 		Graphics/Descriptors/DescriptorSet.hpp
 		Graphics/Descriptors/DescriptorsHandler.hpp
 		Graphics/Graphics.hpp
+		Graphics/Images/AtlasPacker.hpp
 		Graphics/Images/Image.hpp
 		Graphics/Images/Image2d.hpp
 		Graphics/Images/Image2dArray.hpp
 		Graphics/Images/ImageCube.hpp
 		Graphics/Images/ImageDepth.hpp
+		Graphics/Images/TextureAtlas.hpp
+		Graphics/Images/TextureStreamer.hpp
 		Graphics/Pipelines/Pipeline.hpp
 		Graphics/Pipelines/PipelineCompute.hpp
 		Graphics/Pipelines/PipelineGraphics.hpp
@@ -89,6 +112,7 @@ set(_temp_acid_headers
 		Graphics/Subrender.hpp
 		Graphics/SubrenderHolder.hpp
 		Guis/Gui.hpp
+		Guis/GuiBatch.hpp
 		Guis/GuisSubrender.hpp
 		Inputs/Axes/ButtonInputAxis.hpp
 		Inputs/Axes/CompoundInputAxis.hpp
@@ -129,6 +153,7 @@ set(_temp_acid_headers
 		Maths/Vector4.inl
 		Meshes/Mesh.hpp
 		Meshes/MeshesSubrender.hpp
+		Models/Gltf/GltfLoader.hpp
 		Models/Gltf/GltfModel.hpp
 		Models/Model.hpp
 		Models/Obj/ObjModel.hpp
@@ -175,9 +200,11 @@ set(_temp_acid_headers
 		Physics/Colliders/HeightfieldCollider.hpp
 		Physics/Colliders/SphereCollider.hpp
 		Physics/CollisionObject.hpp
+		Physics/CollisionPairSet.hpp
 		Physics/Force.hpp
 		Physics/Frustum.hpp
 		Physics/KinematicCharacter.hpp
+		Physics/PhysicsQuery.hpp
 		Physics/Ray.hpp
 		Physics/Rigidbody.hpp
 		Post/Deferred/DeferredSubrender.hpp
@@ -210,6 +237,7 @@ set(_temp_acid_headers
 		Scenes/Entity.hpp
 		Scenes/EntityPrefab.hpp
 		Scenes/Scene.hpp
+		Scenes/SceneLoader.hpp
 		Scenes/ScenePhysics.hpp
 		Scenes/Scenes.hpp
 		Scenes/SceneStructure.hpp
@@ -240,7 +268,9 @@ set(_temp_acid_headers
 		Uis/Inputs/UiRadioInput.hpp
 		Uis/Inputs/UiSliderInput.hpp
 		Uis/Inputs/UiTextInput.hpp
+		Uis/UiHitGrid.hpp
 		Uis/UiObject.hpp
+		Uis/UiObjectFilter.hpp
 		Uis/UiPanel.hpp
 		Uis/Uis.hpp
 		Uis/UiScrollBar.hpp
@@ -283,6 +313,7 @@ set(_temp_acid_third_party_headers
 		)
 set(_temp_acid_sources
 		Animations/AnimatedMesh.cpp
+		Animations/AnimatedModel.cpp
 		Animations/Animation/Animation.cpp
 		Animations/Animation/AnimationLoader.cpp
 		Animations/Animation/JointTransform.cpp
@@ -302,10 +333,16 @@ set(_temp_acid_sources
 		Audio/SoundBuffer.cpp
 		Audio/Wave/WaveSoundBuffer.cpp
 		Bitmaps/Bitmap.cpp
+		Bitmaps/BitmapOps.cpp
+		Bitmaps/BlockDecoder.cpp
+		Bitmaps/Dds/DdsBitmap.cpp
 		Bitmaps/Dng/DngBitmap.cpp
 		Bitmaps/Exr/ExrBitmap.cpp
 		Bitmaps/Jpg/JpgBitmap.cpp
+		Bitmaps/Ktx/KtxBitmap.cpp
 		Bitmaps/Png/PngBitmap.cpp
+		Bitmaps/Qoi/QoiBitmap.cpp
+		Bitmaps/TextureCooker.cpp
 		Devices/Instance.cpp
 		Devices/Joysticks.cpp
 		Devices/Keyboard.cpp
@@ -317,26 +354,37 @@ set(_temp_acid_sources
 		Devices/Window.cpp
 		Engine/Engine.cpp
 		Engine/Log.cpp
+		Files/AsyncReader.cpp
+		Files/Binary/Binary.cpp
 		Files/File.cpp
 		Files/FileObserver.cpp
 		Files/Files.cpp
 		Files/Json/Json.cpp
+		Files/MappedFile.cpp
 		Files/Node.cpp
+		Files/NodeArena.cpp
 		Files/NodeConstView.cpp
+		Files/NodeHandler.cpp
 		Files/NodeView.cpp
+		Files/NodeWriter.cpp
 		Files/Xml/Xml.cpp
 		Files/Zip/ZipArchive.cpp
 		Files/Zip/ZipEntry.cpp
+		Files/Zip/ZipPack.cpp
+		Fonts/Fonts.cpp
 		Fonts/FontsSubrender.cpp
 		Fonts/FontType.cpp
 		Fonts/Text.cpp
+		Fonts/TextBatch.cpp
 		Gizmos/Gizmo.cpp
 		Gizmos/Gizmos.cpp
 		Gizmos/GizmosSubrender.cpp
 		Gizmos/GizmoType.cpp
+		Graphics/Buffers/BatchBuffers.cpp
 		Graphics/Buffers/Buffer.cpp
 		Graphics/Buffers/InstanceBuffer.cpp
 		Graphics/Buffers/PushHandler.cpp
+		Graphics/Buffers/ReadbackQueue.cpp
 		Graphics/Buffers/StorageBuffer.cpp
 		Graphics/Buffers/StorageHandler.cpp
 		Graphics/Buffers/UniformBuffer.cpp
@@ -346,11 +394,14 @@ set(_temp_acid_sources
 		Graphics/Descriptors/DescriptorSet.cpp
 		Graphics/Descriptors/DescriptorsHandler.cpp
 		Graphics/Graphics.cpp
+		Graphics/Images/AtlasPacker.cpp
 		Graphics/Images/Image.cpp
 		Graphics/Images/Image2d.cpp
 		Graphics/Images/Image2dArray.cpp
 		Graphics/Images/ImageCube.cpp
 		Graphics/Images/ImageDepth.cpp
+		Graphics/Images/TextureAtlas.cpp
+		Graphics/Images/TextureStreamer.cpp
 		Graphics/Pipelines/PipelineCompute.cpp
 		Graphics/Pipelines/PipelineGraphics.cpp
 		Graphics/Pipelines/Shader.cpp
@@ -360,6 +411,7 @@ set(_temp_acid_sources
 		Graphics/RenderStage.cpp
 		Graphics/SubrenderHolder.cpp
 		Guis/Gui.cpp
+		Guis/GuiBatch.cpp
 		Guis/GuisSubrender.cpp
 		Inputs/Axes/ButtonInputAxis.cpp
 		Inputs/Axes/CompoundInputAxis.cpp
@@ -391,6 +443,7 @@ set(_temp_acid_sources
 		Maths/Vector4.cpp
 		Meshes/Mesh.cpp
 		Meshes/MeshesSubrender.cpp
+		Models/Gltf/GltfLoader.cpp
 		Models/Gltf/GltfModel.cpp
 		Models/Model.cpp
 		Models/Obj/ObjModel.cpp
@@ -434,6 +487,7 @@ set(_temp_acid_sources
 		Physics/Colliders/HeightfieldCollider.cpp
 		Physics/Colliders/SphereCollider.cpp
 		Physics/CollisionObject.cpp
+		Physics/CollisionPairSet.cpp
 		Physics/Force.cpp
 		Physics/Frustum.cpp
 		Physics/KinematicCharacter.cpp
@@ -464,6 +518,7 @@ set(_temp_acid_sources
 		Resources/Resources.cpp
 		Scenes/Entity.cpp
 		Scenes/EntityPrefab.cpp
+		Scenes/SceneLoader.cpp
 		Scenes/ScenePhysics.cpp
 		Scenes/Scenes.cpp
 		Scenes/SceneStructure.cpp
@@ -482,6 +537,7 @@ set(_temp_acid_sources
 		Uis/Inputs/UiRadioInput.cpp
 		Uis/Inputs/UiSliderInput.cpp
 		Uis/Inputs/UiTextInput.cpp
+		Uis/UiHitGrid.cpp
 		Uis/UiObject.cpp
 		Uis/UiPanel.cpp
 		Uis/Uis.cpp
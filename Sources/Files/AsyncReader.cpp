@@ -0,0 +1,141 @@
+#include "AsyncReader.hpp"
+
+#include <algorithm>
+
+#include "Engine/Log.hpp"
+
+namespace acid {
+AsyncReader::AsyncReader(uint32_t threadCount) {
+	threadCount = std::max<uint32_t>(threadCount, 1);
+	for (uint32_t i = 0; i < threadCount; i++)
+		workers.emplace_back([this] { Run(); });
+}
+
+AsyncReader::~AsyncReader() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		stop = true;
+	}
+
+	// Workers finish the queued requests before they exit, so no future is left without a value.
+	condition.notify_all();
+	for (auto &worker : workers)
+		worker.join();
+}
+
+std::shared_future<AsyncReader::Result> AsyncReader::Read(const std::filesystem::path &filename, Priority priority) {
+	auto key = filename.string();
+	std::replace(key.begin(), key.end(), '\\', '/');
+
+	std::unique_lock<std::mutex> lock(mutex);
+	stats.requestCount++;
+
+	if (auto it = pending.find(key); it != pending.end()) {
+		stats.coalescedCount++;
+		auto &request = it->second;
+
+		// A urgent request does not wait behind background reads of the same file, requests already in flight are not in any queue.
+		if (priority < request->priority) {
+			auto &queue = queues[static_cast<std::size_t>(request->priority)];
+			if (auto queued = std::find(queue.begin(), queue.end(), request); queued != queue.end()) {
+				queue.erase(queued);
+				queues[static_cast<std::size_t>(priority)].emplace_back(request);
+			}
+			request->priority = priority;
+		}
+
+		return request->future;
+	}
+
+	auto request = std::make_shared<Request>();
+	request->filename = key;
+	request->priority = priority;
+	request->future = request->promise.get_future().share();
+	pending.emplace(key, request);
+	queues[static_cast<std::size_t>(priority)].emplace_back(request);
+	lock.unlock();
+
+	condition.notify_one();
+	return request->future;
+}
+
+void AsyncReader::Wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [this] { return pending.empty(); });
+}
+
+void AsyncReader::Pause() {
+	std::unique_lock<std::mutex> lock(mutex);
+	paused = true;
+}
+
+void AsyncReader::Resume() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		paused = false;
+	}
+
+	condition.notify_all();
+}
+
+std::size_t AsyncReader::GetPendingCount() const {
+	std::unique_lock<std::mutex> lock(mutex);
+	return pending.size();
+}
+
+AsyncReader::Stats AsyncReader::GetStats() const {
+	std::unique_lock<std::mutex> lock(mutex);
+	return stats;
+}
+
+void AsyncReader::Run() {
+	while (true) {
+		std::shared_ptr<Request> request;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			// A stopping reader finishes its queued requests even when paused.
+			condition.wait(lock, [this] {
+				return stop || (!paused && std::any_of(queues.begin(), queues.end(), [](const auto &queue) { return !queue.empty(); }));
+			});
+
+			auto queue = std::find_if(queues.begin(), queues.end(), [](const auto &queue) { return !queue.empty(); });
+			if (queue == queues.end())
+				return;
+
+			request = std::move(queue->front());
+			queue->pop_front();
+		}
+
+		auto start = Time::Now();
+		// A failed read completes the request with a empty file, so its future is never left without a value.
+		std::shared_ptr<MappedFile> file;
+		try {
+			file = std::make_shared<MappedFile>(request->filename);
+			file->Prefetch();
+		} catch (const std::exception &e) {
+			Log::Error("Failed to read file ", request->filename, ", ", e.what(), '\n');
+			file = std::make_shared<MappedFile>();
+		}
+		auto readTime = Time::Now() - start;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			pending.erase(request->filename);
+			stats.readTime += readTime;
+
+			if (*file) {
+				stats.completedCount++;
+				stats.bytesRead += file->GetSize();
+			} else {
+				stats.failedCount++;
+			}
+
+			// The value is set under the lock, so a future is always ready once its request is no longer pending.
+			request->promise.set_value(std::move(file));
+			if (pending.empty())
+				idle.notify_all();
+		}
+	}
+}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "Maths/Time.hpp"
+#include "MappedFile.hpp"
+
+namespace acid {
+/**
+ * @brief Class that reads files on its own threads, so loaders can request many files and wait on futures instead of blocking on each read.
+ * Files are found through the same search paths and mounted packs as {@link MappedFile}, and are mapped or read into a buffer the same way.
+ * At most one read is in flight per thread, requests for a file that is already pending share the pending read,
+ * which is moved up to the highest priority it was requested with while it is still queued.
+ */
+class ACID_EXPORT AsyncReader : NonCopyable {
+public:
+	using Result = std::shared_ptr<const MappedFile>;
+
+	enum class Priority {
+		/// Files needed before the application can continue, always read before streaming requests.
+		Startup,
+		/// Files read in the background while the application runs.
+		Streaming
+	};
+
+	/**
+	 * @brief Class that holds the counters of a reader.
+	 */
+	class Stats {
+	public:
+		/**
+		 * Gets the rate files were read at while a thread was reading.
+		 * @return The throughput in MB/s.
+		 */
+		double GetThroughput() const { return readTime.AsMicroseconds() > 0 ? bytesRead / 1048576.0 / readTime.AsSeconds<double>() : 0.0; }
+
+		/// Requests made, including requests that joined a pending read.
+		uint64_t requestCount = 0;
+		/// Requests that joined a pending read of the same file.
+		uint64_t coalescedCount = 0;
+		uint64_t completedCount = 0;
+		uint64_t failedCount = 0;
+		uint64_t bytesRead = 0;
+		/// The time spent reading, summed over all threads.
+		Time readTime;
+	};
+
+	/**
+	 * Creates a new reader.
+	 * @param threadCount The number of reading threads, and so the number of reads in flight at once.
+	 */
+	explicit AsyncReader(uint32_t threadCount = 4);
+	~AsyncReader();
+
+	/**
+	 * Requests a file to be read, mapped files are faulted in before the future is ready.
+	 * @param filename The file to read, found by real or partial path.
+	 * @param priority The priority of the request, a queued request for the same file is raised to this priority if it is higher.
+	 * @return The future file, which evaluates to false if the file could not be read.
+	 */
+	std::shared_future<Result> Read(const std::filesystem::path &filename, Priority priority = Priority::Startup);
+
+	/**
+	 * Blocks until every request made so far is complete, the reader must not be paused.
+	 */
+	void Wait();
+
+	/**
+	 * Stops starting new reads, requests are queued until {@link AsyncReader#Resume} so they can be read in priority order.
+	 */
+	void Pause();
+	void Resume();
+
+	std::size_t GetPendingCount() const;
+	Stats GetStats() const;
+
+private:
+	class Request {
+	public:
+		std::string filename;
+		Priority priority;
+		std::promise<Result> promise;
+		std::shared_future<Result> future;
+	};
+
+	void Run();
+
+	std::vector<std::thread> workers;
+	/// Queued requests for each priority.
+	std::array<std::deque<std::shared_ptr<Request>>, 2> queues;
+	/// Queued and in flight requests by filename.
+	std::unordered_map<std::string, std::shared_ptr<Request>> pending;
+	Stats stats;
+
+	mutable std::mutex mutex;
+	std::condition_variable condition;
+	std::condition_variable idle;
+	bool stop = false;
+	bool paused = false;
+};
+}
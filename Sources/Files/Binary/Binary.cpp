@@ -0,0 +1,542 @@
+#include "Binary.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+namespace acid {
+class Binary::Reader {
+public:
+	Reader(std::string_view string, NodeAllocator<Node> allocator) :
+		begin(string.data()),
+		it(string.data()),
+		end(string.data() + string.size()),
+		allocator(std::move(allocator)) {
+	}
+
+	void Require(std::size_t size) const {
+		if (static_cast<std::size_t>(end - it) < size)
+			Error("unexpected end of input");
+	}
+
+	uint8_t ReadByte() {
+		Require(1);
+		return static_cast<uint8_t>(*it++);
+	}
+
+	uint64_t ReadVarint() {
+		uint64_t value = 0;
+		for (uint32_t shift = 0; shift < 64; shift += 7) {
+			auto byte = ReadByte();
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+
+		Error("varint is too long");
+	}
+
+	template<typename T>
+	T ReadNative() {
+		Require(sizeof(T));
+		T value;
+		std::memcpy(&value, it, sizeof(T));
+		it += sizeof(T);
+		return value;
+	}
+
+	std::string_view ReadBytes(uint64_t size) {
+		Require(size);
+		std::string_view bytes(it, static_cast<std::size_t>(size));
+		it += size;
+		return bytes;
+	}
+
+	std::string_view ReadString() {
+		return ReadBytes(ReadVarint());
+	}
+
+	/**
+	 * Enters a property list, failing once the nesting is deeper than {@link Node#MaxDepth}.
+	 */
+	void Enter() {
+		if (++depth > Node::MaxDepth)
+			Error("nesting is deeper than " + std::to_string(Node::MaxDepth) + " levels");
+	}
+
+	void Leave() {
+		depth--;
+	}
+
+	[[noreturn]] void Error(const std::string &message) const {
+		throw std::runtime_error("Binary parse error at offset " + std::to_string(it - begin) + ", " + message);
+	}
+
+	/**
+	 * Sets a parsed value, referencing it in place when the node has an arena.
+	 * @param current The node to set.
+	 * @param value The value, either in the source or a temporary buffer.
+	 */
+	void SetValue(Node &current, std::string_view value) {
+		if (!allocator.GetArena()) {
+			current.SetValue(std::string(value));
+		} else if (value.data() >= begin && value.data() < end) {
+			current.SetValueView(value);
+		} else {
+			// Formatted numbers are copied into a chunk of the arena owned by this reader, so the arena is not locked for every value.
+			if (static_cast<std::size_t>(scratchEnd - scratch) < value.size()) {
+				auto size = std::max(value.size(), ScratchSize);
+				scratch = static_cast<char *>(allocator.GetArena()->Allocate(size, 1));
+				scratchEnd = scratch + size;
+			}
+
+			std::memcpy(scratch, value.data(), value.size());
+			current.SetValueView({scratch, value.size()});
+			scratch += value.size();
+		}
+	}
+
+	static constexpr std::size_t ScratchSize = 4096;
+
+	const char *begin;
+	const char *it;
+	const char *end;
+	NodeAllocator<Node> allocator;
+	uint32_t depth = 0;
+	char *scratch = nullptr;
+	char *scratchEnd = nullptr;
+};
+
+class Binary::Writer {
+public:
+	void WriteByte(uint8_t value) {
+		buffer += static_cast<char>(value);
+	}
+
+	void WriteVarint(uint64_t value) {
+		while (value >= 0x80) {
+			buffer += static_cast<char>((value & 0x7f) | 0x80);
+			value >>= 7;
+		}
+		buffer += static_cast<char>(value);
+	}
+
+	template<typename T>
+	void WriteNative(T value) {
+		buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	void WriteString(std::string_view string) {
+		WriteVarint(string.size());
+		buffer.append(string);
+	}
+
+	std::string buffer;
+};
+
+/**
+ * Formats a decimal with the fewest digits that read back as the same value.
+ */
+template<typename T>
+static std::string_view FormatDecimal(T value, char (&buffer)[32]) {
+#if defined(__cpp_lib_to_chars)
+	auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	return {buffer, static_cast<std::size_t>(result.ptr - buffer)};
+#else
+	auto length = std::snprintf(buffer, sizeof(buffer), "%.*g", std::is_same_v<T, float> ? 9 : 17, static_cast<double>(value));
+	return {buffer, static_cast<std::size_t>(length)};
+#endif
+}
+
+template<typename T>
+static bool ParseNumber(std::string_view string, T &value) {
+#if !defined(__cpp_lib_to_chars)
+	if constexpr (std::is_floating_point_v<T>) {
+		std::string copy(string);
+		char *parsedEnd = nullptr;
+		value = static_cast<T>(std::strtod(copy.c_str(), &parsedEnd));
+		return !copy.empty() && parsedEnd == copy.c_str() + copy.size();
+	} else
+#endif
+	{
+		auto result = std::from_chars(string.data(), string.data() + string.size(), value);
+		return result.ec == std::errc() && result.ptr == string.data() + string.size();
+	}
+}
+
+void Binary::ParseString(Node &node, std::string_view string) {
+	Reader reader(string, NodeAllocator<Node>(node.GetArena()));
+	if (reader.ReadBytes(std::min(Magic.size(), string.size())) != Magic)
+		reader.Error("missing binary node header");
+
+	auto tag = reader.ReadByte();
+	node.SetName(reader.ReadString());
+	ParseValue(node, tag, reader);
+
+	if (reader.it != reader.end)
+		reader.Error("unexpected data after the root value");
+}
+
+void Binary::WriteStream(const Node &node, std::ostream &stream, Node::Format format) {
+	// The tree is written into memory first, so property list sizes can be filled in once each list is written.
+	Writer writer;
+	writer.buffer.append(Magic);
+	AppendValue(node, writer);
+	stream.write(writer.buffer.data(), static_cast<std::streamsize>(writer.buffer.size()));
+}
+
+void Binary::ParseValue(Node &current, uint8_t tag, Reader &reader) {
+	char buffer[32];
+
+	switch (static_cast<Tag>(tag & ~PropertiesFlag)) {
+	case Tag::Null:
+		current.SetType(Node::Type::Null);
+		break;
+	case Tag::False:
+	case Tag::True:
+		reader.SetValue(current, (tag & ~PropertiesFlag) == static_cast<uint8_t>(Tag::True) ? "true" : "false");
+		current.SetType(Node::Type::Boolean);
+		break;
+	case Tag::Integer: {
+		// Zigzag encoded so small negative numbers stay short.
+		auto encoded = reader.ReadVarint();
+		auto value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		reader.SetValue(current, {buffer, static_cast<std::size_t>(result.ptr - buffer)});
+		current.SetType(Node::Type::Integer);
+		break;
+	}
+	case Tag::Unsigned: {
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), reader.ReadVarint());
+		reader.SetValue(current, {buffer, static_cast<std::size_t>(result.ptr - buffer)});
+		current.SetType(Node::Type::Integer);
+		break;
+	}
+	case Tag::Float:
+		reader.SetValue(current, FormatDecimal(reader.ReadNative<float>(), buffer));
+		current.SetType(Node::Type::Decimal);
+		break;
+	case Tag::Double:
+		reader.SetValue(current, FormatDecimal(reader.ReadNative<double>(), buffer));
+		current.SetType(Node::Type::Decimal);
+		break;
+	case Tag::String:
+	case Tag::Blob:
+	case Tag::Object:
+	case Tag::Array:
+	case Tag::Text: {
+		auto type = GetNodeType(tag, reader);
+		if (auto value = reader.ReadString(); !value.empty())
+			reader.SetValue(current, value);
+		current.SetType(type);
+		break;
+	}
+	default:
+		reader.Error("unknown value tag " + std::to_string(tag));
+	}
+
+	if ((tag & PropertiesFlag) == 0)
+		return;
+
+	auto size = reader.ReadNative<uint32_t>();
+	reader.Require(size);
+	auto end = reader.it + size;
+	auto count = reader.ReadVarint();
+	// Every property takes at least two bytes, which also bounds the reservation for corrupt counts.
+	if (count > size / 2)
+		reader.Error("property count does not fit the property list");
+
+	reader.Enter();
+	current.GetProperties().reserve(static_cast<std::size_t>(count));
+	for (uint64_t i = 0; i < count; i++) {
+		auto propertyTag = reader.ReadByte();
+		// Named before it is added so the property index of wide objects sees the name.
+		Node property(reader.allocator);
+		property.SetName(reader.ReadString());
+		// Properties are reserved up front, so the reference stays valid while siblings are added.
+		ParseValue(current.AddProperty(std::move(property)), propertyTag, reader);
+	}
+
+	if (reader.it != end)
+		reader.Error("property list size does not match its contents");
+	reader.Leave();
+}
+
+void Binary::SkipPayload(uint8_t tag, Reader &reader) {
+	switch (static_cast<Tag>(tag & ~PropertiesFlag)) {
+	case Tag::Null:
+	case Tag::False:
+	case Tag::True:
+		break;
+	case Tag::Integer:
+	case Tag::Unsigned:
+		reader.ReadVarint();
+		break;
+	case Tag::Float:
+		reader.ReadBytes(sizeof(float));
+		break;
+	case Tag::Double:
+		reader.ReadBytes(sizeof(double));
+		break;
+	case Tag::Text:
+		reader.ReadByte();
+		[[fallthrough]];
+	case Tag::String:
+	case Tag::Blob:
+	case Tag::Object:
+	case Tag::Array:
+		reader.ReadString();
+		break;
+	default:
+		reader.Error("unknown value tag " + std::to_string(tag));
+	}
+}
+
+Node::Type Binary::GetNodeType(uint8_t tag, Reader &reader) {
+	switch (static_cast<Tag>(tag & ~PropertiesFlag)) {
+	case Tag::Null:
+		return Node::Type::Null;
+	case Tag::False:
+	case Tag::True:
+		return Node::Type::Boolean;
+	case Tag::Integer:
+	case Tag::Unsigned:
+		return Node::Type::Integer;
+	case Tag::Float:
+	case Tag::Double:
+		return Node::Type::Decimal;
+	case Tag::String:
+		return Node::Type::String;
+	case Tag::Blob:
+		return Node::Type::Blob;
+	case Tag::Object:
+		return Node::Type::Object;
+	case Tag::Array:
+		return Node::Type::Array;
+	case Tag::Text:
+		// Values that could not be stored natively keep their node type in front of the text.
+		if (auto type = reader.ReadByte(); type <= static_cast<uint8_t>(Node::Type::Unknown))
+			return static_cast<Node::Type>(type);
+		reader.Error("unknown node type");
+	default:
+		reader.Error("unknown value tag " + std::to_string(tag));
+	}
+}
+
+void Binary::AppendValue(const Node &node, Writer &writer) {
+	auto tagOffset = writer.buffer.size();
+	writer.WriteByte(0);
+	writer.WriteString(node.GetName());
+	auto tag = static_cast<uint8_t>(AppendPayload(node, writer));
+
+	if (!node.GetProperties().empty()) {
+		tag |= PropertiesFlag;
+		auto sizeOffset = writer.buffer.size();
+		writer.WriteNative<uint32_t>(0);
+		writer.WriteVarint(node.GetProperties().size());
+
+		for (const auto &property : node.GetProperties())
+			AppendValue(property, writer);
+
+		auto size = writer.buffer.size() - sizeOffset - sizeof(uint32_t);
+		if (size > std::numeric_limits<uint32_t>::max())
+			throw std::runtime_error("Binary node property list is larger than 4GB");
+		auto size32 = static_cast<uint32_t>(size);
+		std::memcpy(&writer.buffer[sizeOffset], &size32, sizeof(uint32_t));
+	}
+
+	writer.buffer[tagOffset] = static_cast<char>(tag);
+}
+
+Binary::Tag Binary::AppendPayload(const Node &node, Writer &writer) {
+	auto value = node.GetValueView();
+
+	switch (node.GetType()) {
+	case Node::Type::Null:
+		return Tag::Null;
+	case Node::Type::Boolean:
+		if (value == "true")
+			return Tag::True;
+		if (value == "false")
+			return Tag::False;
+		break;
+	case Node::Type::Integer: {
+		if (int64_t signedValue; ParseNumber(value, signedValue)) {
+			writer.WriteVarint(static_cast<uint64_t>(signedValue) << 1 ^ static_cast<uint64_t>(signedValue >> 63));
+			return Tag::Integer;
+		}
+		if (uint64_t unsignedValue; ParseNumber(value, unsignedValue)) {
+			writer.WriteVarint(unsignedValue);
+			return Tag::Unsigned;
+		}
+		break;
+	}
+	case Node::Type::Decimal: {
+		if (double decimal; ParseNumber(value, decimal)) {
+			// Floats are used when no precision is lost, or when the text is exactly what the float prints as.
+			auto single = static_cast<float>(decimal);
+			char buffer[32];
+			if (static_cast<double>(single) == decimal || FormatDecimal(single, buffer) == value) {
+				writer.WriteNative(single);
+				return Tag::Float;
+			}
+
+			writer.WriteNative(decimal);
+			return Tag::Double;
+		}
+		break;
+	}
+	case Node::Type::String:
+		writer.WriteString(value);
+		return Tag::String;
+	case Node::Type::Blob:
+		writer.WriteString(value);
+		return Tag::Blob;
+	case Node::Type::Object:
+		writer.WriteString(value);
+		return Tag::Object;
+	case Node::Type::Array:
+		writer.WriteString(value);
+		return Tag::Array;
+	default:
+		break;
+	}
+
+	writer.WriteByte(static_cast<uint8_t>(node.GetType()));
+	writer.WriteString(value);
+	return Tag::Text;
+}
+
+BinaryView::BinaryView(std::string_view document) {
+	if (document.substr(0, Binary::Magic.size()) != Binary::Magic)
+		throw std::runtime_error("Binary view is missing the binary node header");
+	data = document.substr(Binary::Magic.size());
+}
+
+BinaryView::BinaryView(const MappedFile &file) :
+	BinaryView(std::string_view(reinterpret_cast<const char *>(file.GetData()), file.GetSize())) {
+}
+
+Node::Type BinaryView::GetType() const {
+	if (!data.data())
+		return Node::Type::Unknown;
+
+	Binary::Reader reader(data, {});
+	auto tag = reader.ReadByte();
+	reader.ReadString();
+	return Binary::GetNodeType(tag, reader);
+}
+
+std::string_view BinaryView::GetName() const {
+	if (!data.data())
+		return {};
+
+	Binary::Reader reader(data, {});
+	reader.ReadByte();
+	return reader.ReadString();
+}
+
+std::string_view BinaryView::GetBlob() const {
+	if (!data.data())
+		return {};
+
+	Binary::Reader reader(data, {});
+	auto tag = reader.ReadByte();
+	if (static_cast<Binary::Tag>(tag & ~Binary::PropertiesFlag) != Binary::Tag::Blob)
+		return {};
+	reader.ReadString();
+	return reader.ReadString();
+}
+
+uint32_t BinaryView::GetPropertyCount() const {
+	if (!data.data())
+		return 0;
+
+	Binary::Reader reader(data, {});
+	auto tag = reader.ReadByte();
+	if ((tag & Binary::PropertiesFlag) == 0)
+		return 0;
+	reader.ReadString();
+	Binary::SkipPayload(tag, reader);
+	reader.ReadNative<uint32_t>();
+	return static_cast<uint32_t>(reader.ReadVarint());
+}
+
+BinaryView BinaryView::GetProperty(std::string_view name) const {
+	if (!data.data())
+		return {};
+
+	Binary::Reader reader(data, {});
+	auto tag = reader.ReadByte();
+	if ((tag & Binary::PropertiesFlag) == 0)
+		return {};
+	reader.ReadString();
+	Binary::SkipPayload(tag, reader);
+	reader.ReadNative<uint32_t>();
+	auto count = reader.ReadVarint();
+
+	// Siblings are skipped over using the size in front of their property lists, so nothing below them is read.
+	for (uint64_t i = 0; i < count; i++) {
+		auto start = reader.it;
+		auto propertyTag = reader.ReadByte();
+		auto propertyName = reader.ReadString();
+		Binary::SkipPayload(propertyTag, reader);
+		if (propertyTag & Binary::PropertiesFlag)
+			reader.ReadBytes(reader.ReadNative<uint32_t>());
+
+		if (propertyName == name) {
+			BinaryView property;
+			property.data = {start, static_cast<std::size_t>(reader.it - start)};
+			return property;
+		}
+	}
+
+	return {};
+}
+
+BinaryView BinaryView::GetProperty(uint32_t index) const {
+	if (!data.data())
+		return {};
+
+	Binary::Reader reader(data, {});
+	auto tag = reader.ReadByte();
+	if ((tag & Binary::PropertiesFlag) == 0)
+		return {};
+	reader.ReadString();
+	Binary::SkipPayload(tag, reader);
+	reader.ReadNative<uint32_t>();
+	if (index >= reader.ReadVarint())
+		return {};
+
+	for (uint32_t i = 0;; i++) {
+		auto start = reader.it;
+		auto propertyTag = reader.ReadByte();
+		reader.ReadString();
+		Binary::SkipPayload(propertyTag, reader);
+		if (propertyTag & Binary::PropertiesFlag)
+			reader.ReadBytes(reader.ReadNative<uint32_t>());
+
+		if (i == index) {
+			BinaryView property;
+			property.data = {start, static_cast<std::size_t>(reader.it - start)};
+			return property;
+		}
+	}
+}
+
+void BinaryView::Load(Node &node) const {
+	if (!data.data()) {
+		node = Node();
+		return;
+	}
+
+	auto arena = std::make_unique<NodeArena>();
+	auto source = arena->AddString(data);
+	node = Node(std::move(arena));
+
+	Binary::Reader reader(source, NodeAllocator<Node>(node.GetArena()));
+	auto tag = reader.ReadByte();
+	node.SetName(reader.ReadString());
+	Binary::ParseValue(node, tag, reader);
+}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Files/Node.hpp"
+
+namespace acid {
+/**
+ * @brief Class that reads and writes a compact binary format using {@link Node} as storage.
+ * Every value is a type tag followed by a length prefixed name, numbers are stored natively as varints, floats or doubles,
+ * blobs are stored as raw bytes, and property lists are prefixed with their size so a {@link BinaryView} can skip over them.
+ * Numbers are written little endian, as used by every platform the engine targets.
+ */
+class ACID_EXPORT Binary {
+	friend class BinaryView;
+public:
+	/// The bytes every binary document starts with, the last byte is the format version.
+	static constexpr std::string_view Magic = {"ANB\x01", 4};
+
+	Binary() = delete;
+
+	static void ParseString(Node &node, std::string_view string);
+	static void WriteStream(const Node &node, std::ostream &stream, Node::Format format = Node::Format::Minified);
+
+private:
+	enum class Tag : uint8_t {
+		Null, False, True, Integer, Unsigned, Float, Double, String, Blob, Object, Array, Text
+	};
+
+	/// Set on the tag of values that are followed by a property list.
+	static constexpr uint8_t PropertiesFlag = 0x80;
+
+	class Reader;
+	class Writer;
+
+	static void ParseValue(Node &current, uint8_t tag, Reader &reader);
+	static void SkipPayload(uint8_t tag, Reader &reader);
+	static Node::Type GetNodeType(uint8_t tag, Reader &reader);
+
+	static void AppendValue(const Node &node, Writer &writer);
+	static Tag AppendPayload(const Node &node, Writer &writer);
+};
+
+/**
+ * @brief Class that gives lazy access to a binary document, only the sub-trees that are loaded get parsed into a {@link Node}.
+ * The viewed bytes, usually a {@link MappedFile}, must outlive the view.
+ */
+class ACID_EXPORT BinaryView {
+public:
+	BinaryView() = default;
+	/**
+	 * Creates a view of the root value of a binary document.
+	 * @param document The document, starting with {@link Binary#Magic}.
+	 */
+	explicit BinaryView(std::string_view document);
+	explicit BinaryView(const MappedFile &file);
+
+	Node::Type GetType() const;
+	std::string_view GetName() const;
+
+	/**
+	 * Gets the bytes of a blob value straight from the document, without copying them.
+	 * @return The bytes, or empty if the value is not a blob.
+	 */
+	std::string_view GetBlob() const;
+
+	uint32_t GetPropertyCount() const;
+	BinaryView GetProperty(std::string_view name) const;
+	BinaryView GetProperty(uint32_t index) const;
+
+	BinaryView operator[](std::string_view name) const { return GetProperty(name); }
+	BinaryView operator[](uint32_t index) const { return GetProperty(index); }
+
+	/**
+	 * Parses the viewed value and its properties into a node, the bytes of the sub-tree are copied into the arena of the node.
+	 * @param node The node to replace.
+	 */
+	void Load(Node &node) const;
+
+	/**
+	 * Gets the encoded value, including its tag, name and properties.
+	 * @return The encoded bytes.
+	 */
+	std::string_view GetData() const { return data; }
+
+	explicit operator bool() const noexcept { return data.data() != nullptr; }
+
+private:
+	std::string_view data;
+};
+}
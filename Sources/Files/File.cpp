@@ -1,9 +1,12 @@
 #include "File.hpp"
 
 #include "Engine/Engine.hpp"
+#include "Binary/Binary.hpp"
 #include "Json/Json.hpp"
 #include "Xml/Xml.hpp"
 #include "Files.hpp"
+#include "MappedFile.hpp"
+#include "Utils/String.hpp"
 
 namespace acid {
 File::File(Type type, const Node &node) :
@@ -28,24 +31,23 @@ File::File(std::filesystem::path filename, Type type, Node &&node) :
 	filename(std::move(filename)) {
 }
 
+File::Type File::FindType(const std::filesystem::path &filename) {
+	auto extension = String::Lowercase(filename.extension().string());
+	if (extension == ".xml")
+		return Type::Xml;
+	if (extension == ".bin")
+		return Type::Binary;
+	return Type::Json;
+}
+
 void File::Load(const std::filesystem::path &filename) {
 #if defined(ACID_DEBUG)
 	auto debugStart = Time::Now();
 #endif
 
-	if (Files::ExistsInPath(filename)) {
-		IFStream inStream(filename);
-		if (type == Type::Json)
-			node.ParseStream<Json>(inStream);
-		else if (type == Type::Xml)
-			node.ParseStream<Xml>(inStream);
-	} else if (std::filesystem::exists(filename)) {
-		std::ifstream inStream(filename);
-		if (type == Type::Json)
-			node.ParseStream<Json>(inStream);
-		else if (type == Type::Xml)
-			node.ParseStream<Xml>(inStream);
-		inStream.close();
+	if (Files::ExistsInPath(filename) || std::filesystem::exists(filename)) {
+		if (auto mappedFile = Files::ReadAsync(filename).get(); *mappedFile)
+			Load(std::move(mappedFile));
 	}
 
 #if defined(ACID_DEBUG)
@@ -57,6 +59,33 @@ void File::Load() {
 	Load(filename);
 }
 
+void File::Load(std::shared_ptr<const MappedFile> mappedFile) {
+	// Parsers work directly on the mapped bytes, the nodes arena keeps the mapping alive for values that reference it.
+	if (type == Type::Json)
+		node.ParseFile<Json>(std::move(mappedFile));
+	else if (type == Type::Xml)
+		node.ParseFile<Xml>(std::move(mappedFile));
+	else if (type == Type::Binary)
+		node.ParseFile<Binary>(std::move(mappedFile));
+}
+
+void File::Read(NodeHandler &handler) const {
+	auto mappedFile = Files::ReadAsync(filename).get();
+	if (!*mappedFile)
+		return;
+
+	std::string_view string(reinterpret_cast<const char *>(mappedFile->GetData()), mappedFile->GetSize());
+	if (type == Type::Json) {
+		Json::Read(string, handler);
+	} else if (type == Type::Xml) {
+		Xml::Read(string, handler);
+	} else if (type == Type::Binary) {
+		Node node;
+		node.ParseFile<Binary>(std::move(mappedFile));
+		handler.Visit(node);
+	}
+}
+
 void File::Write(const std::filesystem::path &filename, Node::Format format) const {
 #if defined(ACID_DEBUG)
 	auto debugStart = Time::Now();
@@ -69,11 +98,13 @@ void File::Write(const std::filesystem::path &filename, Node::Format format) con
 		if (auto parentPath = filename.parent_path(); !parentPath.empty())
 			std::filesystem::create_directories(parentPath);
 
-		std::ofstream os(filename);
+		std::ofstream os(filename, type == Type::Binary ? std::ios::binary : std::ios::out);
 		if (type == Type::Json)
 			node.WriteStream<Json>(os, format);
 		else if (type == Type::Xml)
 			node.WriteStream<Xml>(os, format);
+		else if (type == Type::Binary)
+			node.WriteStream<Binary>(os, format);
 		os.close();
 	//}
 
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Files/Node.hpp"
+#include "Files/NodeHandler.hpp"
 
 namespace acid {
 /**
@@ -10,7 +10,7 @@ class ACID_EXPORT File {
 public:
 	// TODO: Implement a more dynamic, less hard-coded, file parse/write.
 	enum class Type {
-		Json, Xml
+		Json, Xml, Binary
 	};
 	
 	File() = default;
@@ -19,8 +19,27 @@ public:
 	File(std::filesystem::path filename, Type type, const Node &node);
 	File(std::filesystem::path filename, Type type, Node &&node = {});
 
+	/**
+	 * Gets the file type used for a extension, ".xml" and ".bin" files are Xml and Binary, anything else is Json.
+	 * @param filename The file name.
+	 * @return The file type.
+	 */
+	static Type FindType(const std::filesystem::path &filename);
+
 	void Load(const std::filesystem::path &filename);
 	void Load();
+
+	/**
+	 * Parses a file that has already been read, so loaders can request files from the {@link AsyncReader} and parse them as they arrive.
+	 * @param mappedFile The file to parse, the nodes arena keeps the mapping alive.
+	 */
+	void Load(std::shared_ptr<const MappedFile> mappedFile);
+
+	/**
+	 * Streams the file to a handler without building a node tree, binary files are loaded and then visited.
+	 * @param handler The handler to send events to.
+	 */
+	void Read(NodeHandler &handler) const;
 	
 	void Write(const std::filesystem::path &filename, Node::Format format = Node::Format::Minified) const;
 	void Write(Node::Format format = Node::Format::Minified) const;
@@ -1,71 +1,488 @@
 #include "FileObserver.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(ACID_BUILD_LINUX)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+#include "Engine/Log.hpp"
+
 namespace acid {
-FileObserver::FileObserver(std::filesystem::path path, const Time &delay) :
-	path(std::move(path)),
-	delay(delay),
-	running(true),
-	thread(&FileObserver::QueueLoop, this) {
-	DoWithFilesInPath([this](const std::filesystem::path &file) {
-		paths[file.string()] = std::filesystem::last_write_time(file);
-	});
+namespace {
+std::mutex InstanceMutex;
+std::weak_ptr<FileWatcher> Instance;
+
+bool IsWithin(const std::filesystem::path &path, const std::filesystem::path &file) {
+	const auto &pathString = path.native();
+	const auto &fileString = file.native();
+	return fileString.size() >= pathString.size() && fileString.compare(0, pathString.size(), pathString) == 0 &&
+		(fileString.size() == pathString.size() || pathString.back() == '/' || fileString[pathString.size()] == '/');
 }
 
-FileObserver::~FileObserver() {
-	if (thread.joinable()) {
+std::unordered_map<std::string, std::filesystem::file_time_type> Scan(const std::filesystem::path &path) {
+	std::unordered_map<std::string, std::filesystem::file_time_type> files;
+	std::error_code error, timeError;
+
+	if (!std::filesystem::is_directory(path, error)) {
+		if (auto time = std::filesystem::last_write_time(path, timeError); !timeError)
+			files.emplace(path.string(), time);
+		return files;
+	}
+
+	for (std::filesystem::recursive_directory_iterator it(path, error), end; !error && it != end; it.increment(error)) {
+		if (auto time = it->last_write_time(timeError); !timeError)
+			files.emplace(it->path().string(), time);
+	}
+	return files;
+}
+}
+
+/**
+ * @brief Class that watches the paths of every {@link FileObserver} on one thread, and keeps their changes until they settle.
+ */
+class FileWatcher : NonCopyable {
+public:
+	FileWatcher();
+	~FileWatcher();
+
+	/**
+	 * Gets the shared watcher, creating it if there is none.
+	 * @return The watcher, destroyed with the last observer that holds it.
+	 */
+	static std::shared_ptr<FileWatcher> Get();
+	static std::shared_ptr<FileWatcher> Find();
+
+	void Add(FileObserver *observer);
+	void Remove(FileObserver *observer);
+	void Dispatch();
+
+private:
+	class Pending {
+	public:
+		FileObserver::Status status;
+		Time time;
+	};
+
+	class Watch {
+	public:
+		/// Cleared under the lock when the observer is removed, batches being delivered check it before each call.
+		FileObserver *observer;
+		std::shared_ptr<FileObserver::Delegates> delegates;
+		std::filesystem::path path;
+		Time delay;
+		std::unordered_map<std::string, Pending> pending;
+		/// The last write times of files, only used when polling.
+		std::unordered_map<std::string, std::filesystem::file_time_type> files;
+		Time nextPoll;
+	};
+
+	void Run();
+	void Poll(Watch &watch);
+	void Record(const std::filesystem::path &file, FileObserver::Status status, const Time &now);
+	static void Record(Watch &watch, const std::string &file, FileObserver::Status status, const Time &now);
+
+#if defined(ACID_BUILD_LINUX)
+	class Directory {
+	public:
+		std::filesystem::path path;
+		/// If directories created inside are watched too.
+		bool recursive = false;
+	};
+
+	void AddDirectory(const std::filesystem::path &directory, bool recursive, bool recordFiles, const Time &now);
+	void ReadEvents();
+
+	int inotifyFd = -1;
+	/// Written to wake the thread from poll when the watcher is destroyed.
+	int wakeFd = -1;
+	std::unordered_map<int, Directory> directories;
+#endif
+
+	std::vector<std::shared_ptr<Watch>> watches;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool running = true;
+	std::thread thread;
+};
+
+FileWatcher::FileWatcher() {
+#if defined(ACID_BUILD_LINUX)
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFd != -1)
+		wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (inotifyFd == -1 || wakeFd == -1) {
+		Log::Warning("Failed to start inotify, ", std::strerror(errno), ", polling for file changes instead\n");
+		if (inotifyFd != -1)
+			close(inotifyFd);
+		inotifyFd = -1;
+	}
+#endif
+
+	thread = std::thread(&FileWatcher::Run, this);
+}
+
+FileWatcher::~FileWatcher() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
 		running = false;
-		thread.join();
 	}
+
+	condition.notify_all();
+#if defined(ACID_BUILD_LINUX)
+	if (wakeFd != -1) {
+		uint64_t value = 1;
+		[[maybe_unused]] auto written = write(wakeFd, &value, sizeof(value));
+	}
+#endif
+	thread.join();
+
+#if defined(ACID_BUILD_LINUX)
+	if (inotifyFd != -1)
+		close(inotifyFd);
+	if (wakeFd != -1)
+		close(wakeFd);
+#endif
 }
 
-void FileObserver::DoWithFilesInPath(const std::function<void(std::filesystem::path)> &f) const {
-	if (!std::filesystem::is_directory(path)) {
-		f(path);
+std::shared_ptr<FileWatcher> FileWatcher::Get() {
+	std::unique_lock<std::mutex> lock(InstanceMutex);
+	auto watcher = Instance.lock();
+	if (!watcher) {
+		watcher = std::make_shared<FileWatcher>();
+		Instance = watcher;
+	}
+	return watcher;
+}
+
+std::shared_ptr<FileWatcher> FileWatcher::Find() {
+	std::unique_lock<std::mutex> lock(InstanceMutex);
+	return Instance.lock();
+}
+
+void FileWatcher::Add(FileObserver *observer) {
+	auto watch = std::make_shared<Watch>();
+	watch->observer = observer;
+	watch->delegates = observer->delegates;
+	// Paths are absolute so observers of the same files agree on names, whatever path they were given.
+	watch->path = std::filesystem::absolute(observer->path).lexically_normal();
+	watch->delay = observer->delay;
+
+#if defined(ACID_BUILD_LINUX)
+	if (inotifyFd != -1) {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (std::error_code error; std::filesystem::is_directory(watch->path, error))
+			AddDirectory(watch->path, true, false, Time::Now());
+		else
+			AddDirectory(watch->path.parent_path(), false, false, Time::Now());
+		watches.emplace_back(std::move(watch));
 		return;
 	}
-	for (auto &file : std::filesystem::recursive_directory_iterator(path)) {
-		f(file.path());
+#endif
+
+	// Polling takes a snapshot first, so only later changes are reported.
+	watch->files = Scan(watch->path);
+	watch->nextPoll = Time::Now() + watch->delay;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		watches.emplace_back(std::move(watch));
 	}
+
+	condition.notify_all();
 }
 
-void FileObserver::QueueLoop() {
-	while (running) {
-		// Wait for "delay" milliseconds
-		std::this_thread::sleep_for(std::chrono::microseconds(delay));
+void FileWatcher::Remove(FileObserver *observer) {
+	std::unique_lock<std::mutex> lock(mutex);
+	watches.erase(std::remove_if(watches.begin(), watches.end(), [observer](const auto &watch) {
+		if (watch->observer != observer)
+			return false;
+		watch->observer = nullptr;
+		return true;
+	}), watches.end());
 
-		// Check if one of the old files was erased
-		for (auto it = paths.begin(); it != paths.end();) {
-			if (!std::filesystem::exists(it->first)) {
-				onChange(std::filesystem::path(it->first), Status::Erased);
-				it = paths.erase(it);
+#if defined(ACID_BUILD_LINUX)
+	// Directories no other observer needs stop being watched.
+	for (auto it = directories.begin(); it != directories.end();) {
+		auto needed = std::any_of(watches.begin(), watches.end(), [&it](const auto &watch) {
+			return IsWithin(watch->path, it->second.path) || watch->path.parent_path() == it->second.path;
+		});
+
+		if (!needed) {
+			inotify_rm_watch(inotifyFd, it->first);
+			it = directories.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+#endif
+}
+
+void FileWatcher::Dispatch() {
+	std::vector<std::pair<std::shared_ptr<Watch>, std::vector<FileObserver::Change>>> batches;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		auto now = Time::Now();
+
+		for (auto &watch : watches) {
+			std::vector<FileObserver::Change> changes;
+			for (auto it = watch->pending.begin(); it != watch->pending.end();) {
+				if (now - it->second.time < watch->delay) {
+					++it;
+					continue;
+				}
+
+				changes.push_back({it->first, it->second.status});
+				it = watch->pending.erase(it);
+			}
+
+			if (changes.empty())
 				continue;
+
+			std::sort(changes.begin(), changes.end(), [](const auto &a, const auto &b) { return a.path < b.path; });
+			batches.emplace_back(watch, std::move(changes));
+		}
+	}
+
+	// Any callback may destroy a observer, including its own, so the watch is checked again before every call.
+	auto isObserved = [this](const Watch &watch) {
+		std::unique_lock<std::mutex> lock(mutex);
+		return watch.observer != nullptr;
+	};
+
+	for (auto &[watch, changes] : batches) {
+		for (const auto &change : changes) {
+			if (isObserved(*watch))
+				watch->delegates->onChange(change.path, change.status);
+		}
+
+		if (isObserved(*watch))
+			watch->delegates->onChanges(changes);
+	}
+}
+
+void FileWatcher::Run() {
+	while (true) {
+#if defined(ACID_BUILD_LINUX)
+		if (inotifyFd != -1) {
+			pollfd fds[] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+			poll(fds, 2, -1);
+
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				if (!running)
+					return;
 			}
 
-			++it;
+			if (fds[0].revents & POLLIN)
+				ReadEvents();
+			continue;
 		}
-		
-		// Check if a file was created or modified
-		DoWithFilesInPath([&](const std::filesystem::path &file) {
-			auto lastWriteTime = std::filesystem::last_write_time(file);
-
-			// File creation
-			if (!Contains(file.string())) {
-				// File modification
-				paths[file.string()] = lastWriteTime;
-				onChange(file.string(), Status::Created);
-			} else {
-				if (paths[file.string()] != lastWriteTime) {
-					paths[file.string()] = lastWriteTime;
-					onChange(file.string(), Status::Modified);
+#endif
+
+		std::vector<std::shared_ptr<Watch>> due;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (!running)
+				return;
+
+			auto now = Time::Now();
+			auto next = now + 1s;
+			for (auto &watch : watches) {
+				if (watch->nextPoll <= now) {
+					due.emplace_back(watch);
+					watch->nextPoll = now + watch->delay;
 				}
+				next = std::min(next, watch->nextPoll);
 			}
-		});
+
+			if (due.empty()) {
+				condition.wait_for(lock, std::chrono::microseconds(next - now));
+				continue;
+			}
+		}
+
+		// Scanning happens outside the lock, only this thread reads and writes the files of a watch.
+		for (auto &watch : due)
+			Poll(*watch);
+	}
+}
+
+void FileWatcher::Poll(Watch &watch) {
+	auto files = Scan(watch.path);
+	std::vector<std::pair<std::string, FileObserver::Status>> changes;
+
+	for (const auto &[file, time] : watch.files) {
+		if (files.find(file) == files.end())
+			changes.emplace_back(file, FileObserver::Status::Erased);
+	}
+
+	for (const auto &[file, time] : files) {
+		if (auto it = watch.files.find(file); it == watch.files.end())
+			changes.emplace_back(file, FileObserver::Status::Created);
+		else if (it->second != time)
+			changes.emplace_back(file, FileObserver::Status::Modified);
+	}
+
+	watch.files = std::move(files);
+	if (changes.empty())
+		return;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	auto now = Time::Now();
+	for (const auto &[file, status] : changes)
+		Record(watch, file, status, now);
+}
+
+void FileWatcher::Record(const std::filesystem::path &file, FileObserver::Status status, const Time &now) {
+	for (auto &watch : watches) {
+		if (IsWithin(watch->path, file))
+			Record(*watch, file.string(), status, now);
+	}
+}
+
+void FileWatcher::Record(Watch &watch, const std::string &file, FileObserver::Status status, const Time &now) {
+	auto [it, inserted] = watch.pending.try_emplace(file, Pending{status, now});
+	if (inserted)
+		return;
+
+	// Changes to a file that has not settled are combined into the change from before the first to after the last.
+	auto &pending = it->second;
+	if (pending.status == FileObserver::Status::Created && status == FileObserver::Status::Erased) {
+		watch.pending.erase(it);
+		return;
+	}
+
+	if (pending.status == FileObserver::Status::Erased && status == FileObserver::Status::Created)
+		pending.status = FileObserver::Status::Modified;
+	else if (pending.status != FileObserver::Status::Created)
+		pending.status = status;
+	pending.time = now;
+}
+
+#if defined(ACID_BUILD_LINUX)
+void FileWatcher::AddDirectory(const std::filesystem::path &directory, bool recursive, bool recordFiles, const Time &now) {
+	auto wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO);
+	if (wd == -1) {
+		Log::Warning("Failed to watch directory ", directory, ", ", std::strerror(errno), '\n');
+		return;
 	}
+
+	auto &watched = directories[wd];
+	watched.path = directory;
+	watched.recursive = watched.recursive || recursive;
+
+	if (!recursive)
+		return;
+
+	std::error_code error;
+	for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+		// Files created with a new directory were made before it could be watched, so they are recorded here.
+		if (recordFiles)
+			Record(it->path(), FileObserver::Status::Created, now);
+
+		std::error_code typeError;
+		if (it->is_directory(typeError) && !it->is_symlink(typeError))
+			AddDirectory(it->path(), true, recordFiles, now);
+	}
+}
+
+void FileWatcher::ReadEvents() {
+	alignas(inotify_event) char buffer[16 * 1024];
+
+	while (true) {
+		auto length = read(inotifyFd, buffer, sizeof(buffer));
+		if (length <= 0)
+			return;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		auto now = Time::Now();
+
+		for (auto offset = 0; offset < length;) {
+			auto event = reinterpret_cast<const inotify_event *>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				Log::Warning("File watcher event queue overflowed, some file changes were missed\n");
+				continue;
+			}
+
+			auto it = directories.find(event->wd);
+			if (it == directories.end())
+				continue;
+
+			if (event->mask & IN_IGNORED) {
+				directories.erase(it);
+				continue;
+			}
+
+			// Events without a name are about the watched directory itself, its parent reports those.
+			if (event->len == 0)
+				continue;
+
+			auto file = it->second.path / event->name;
+			if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+				if ((event->mask & IN_ISDIR) && it->second.recursive)
+					AddDirectory(file, true, true, now);
+				Record(file, FileObserver::Status::Created, now);
+			} else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+				Record(file, FileObserver::Status::Erased, now);
+			} else if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE)) {
+				Record(file, FileObserver::Status::Modified, now);
+			}
+		}
+	}
+}
+#endif
+
+FileObserver::FileObserver(std::filesystem::path path, const Time &delay) :
+	path(std::move(path)),
+	delay(delay),
+	delegates(std::make_shared<Delegates>()),
+	watcher(FileWatcher::Get()) {
+	watcher->Add(this);
+}
+
+FileObserver::~FileObserver() {
+	watcher->Remove(this);
+}
+
+void FileObserver::Update() {
+	if (auto watcher = FileWatcher::Find())
+		watcher->Dispatch();
+}
+
+void FileObserver::DoWithFilesInPath(const std::function<void(std::filesystem::path)> &f) const {
+	if (!std::filesystem::is_directory(path)) {
+		f(path);
+		return;
+	}
+	for (auto &file : std::filesystem::recursive_directory_iterator(path)) {
+		f(file.path());
+	}
+}
+
+void FileObserver::SetPath(const std::filesystem::path &path) {
+	watcher->Remove(this);
+	this->path = path;
+	watcher->Add(this);
 }
 
-bool FileObserver::Contains(const std::string &key) const {
-	// TODO C++20: Remove method
-	auto el = paths.find(key);
-	return el != paths.end();
+void FileObserver::SetDelay(const Time &delay) {
+	watcher->Remove(this);
+	this->delay = delay;
+	watcher->Add(this);
 }
 }
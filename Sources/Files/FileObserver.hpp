@@ -1,55 +1,79 @@
 #pragma once
 
 #include <filesystem>
-#include <unordered_map>
-#include <thread>
+#include <memory>
 
 #include "Maths/Time.hpp"
 #include "Utils/Delegate.hpp"
+#include "Utils/NonCopyable.hpp"
 
 namespace acid {
+class FileWatcher;
+
 /**
  * @brief Class that can listen to file changes on a path recursively.
+ * All observers share one watcher thread, which uses inotify on Linux and polls the path every delay elsewhere.
+ * Changes to a file are combined until the file has been quiet for the delay, then delivered in a batch from {@link FileObserver#Update}.
  */
-class ACID_EXPORT FileObserver {
+class ACID_EXPORT FileObserver : NonCopyable {
 public:
 	enum class Status {
 		Created, Modified, Erased
 	};
 
+	class Change {
+	public:
+		std::filesystem::path path;
+		Status status;
+	};
+
 	/**
 	 * Creates a new file watcher.
 	 * @param path The path to watch recursively.
-	 * @param delay How frequently to check for changes.
+	 * @param delay How long a file has to be unchanged before its changes are delivered, and how frequently to poll where there is no inotify.
 	 */
-	explicit FileObserver(std::filesystem::path path, const Time &delay = 5s);
+	explicit FileObserver(std::filesystem::path path, const Time &delay = 500ms);
 	~FileObserver();
 
+	/**
+	 * Delivers the changes that have settled to every observer, this is called on the main thread by {@link Files#Update}.
+	 */
+	static void Update();
+
 	void DoWithFilesInPath(const std::function<void(std::filesystem::path)> &f) const;
 
 	const std::filesystem::path &GetPath() const { return path; }
-	void SetPath(const std::filesystem::path &path) { this->path = path; }
+	void SetPath(const std::filesystem::path &path);
 
 	const Time &GetDelay() const { return delay; }
-	void SetDelay(const Time &delay) { this->delay = delay; }
+	void SetDelay(const Time &delay);
 
 	/**
 	 * Called when a file or directory has changed.
 	 * @return The delegate.
 	 */
-	Delegate<void(std::filesystem::path, Status)> &OnChange() { return onChange; }
+	Delegate<void(std::filesystem::path, Status)> &OnChange() { return delegates->onChange; }
+
+	/**
+	 * Called once for every batch of changes, after {@link FileObserver#OnChange} has been called for each change.
+	 * @return The delegate.
+	 */
+	Delegate<void(const std::vector<Change> &)> &OnChanges() { return delegates->onChanges; }
 
 private:
-	void QueueLoop();
+	friend class FileWatcher;
 
-	bool Contains(const std::string &key) const;
+	class Delegates {
+	public:
+		Delegate<void(std::filesystem::path, Status)> onChange;
+		Delegate<void(const std::vector<Change> &)> onChanges;
+	};
 
 	std::filesystem::path path;
 	Time delay;
-	Delegate<void(std::filesystem::path, Status)> onChange;
+	/// Shared with the watcher, so a observer destroyed by its own callbacks is released only once they return.
+	std::shared_ptr<Delegates> delegates;
 
-	bool running;
-	std::thread thread;
-	std::unordered_map<std::string, std::filesystem::file_time_type> paths;
+	std::shared_ptr<FileWatcher> watcher;
 };
 }
@@ -3,6 +3,9 @@
 #include <iterator>
 #include <physfs.h>
 #include "Engine/Engine.hpp"
+#include "FileObserver.hpp"
+#include "Zip/ZipException.hpp"
+#include "Zip/ZipPack.hpp"
 #include "Config.hpp"
 
 namespace acid {
@@ -11,7 +14,7 @@ using std::ios_base;
 
 class FBuffer : public streambuf, NonCopyable {
 public:
-	explicit FBuffer(PHYSFS_File *file, std::size_t bufferSize = 2048) :
+	explicit FBuffer(PHYSFS_File *file, std::size_t bufferSize = 64 * 1024) :
 		bufferSize(bufferSize),
 		file(file) {
 		buffer = new char[bufferSize];
@@ -161,7 +164,8 @@ FStream::~FStream() {
 	delete rdbuf();
 }
 
-Files::Files() {
+Files::Files() :
+	asyncReader(std::make_unique<AsyncReader>()) {
 	PHYSFS_init(Engine::Get()->GetArgv0().c_str());
 	// TODO: Only when not installed. 
 	if (std::filesystem::exists(ACID_RESOURCES_DEV))
@@ -169,16 +173,34 @@ Files::Files() {
 }
 
 Files::~Files() {
+	// Pending reads still use PhysFS, so they finish before it is shut down.
+	asyncReader = nullptr;
 	PHYSFS_deinit();
 }
 
 void Files::Update() {
+	FileObserver::Update();
 }
 
 void Files::AddSearchPath(const std::string &path) {
 	if (std::find(searchPaths.begin(), searchPaths.end(), path) != searchPaths.end())
 		return;
 
+	// Zip packs are mounted from their mapping, so PhysFS reads them without file calls and MappedFile can view stored entries.
+	if (std::filesystem::path(path).extension() == ".zip" && std::filesystem::is_regular_file(path)) {
+		try {
+			auto pack = std::make_shared<ZipPack>(path);
+			if (*pack && PHYSFS_mountMemory(pack->GetFile().GetData(), pack->GetFile().GetSize(), nullptr, path.c_str(), nullptr, true) != 0) {
+				std::unique_lock<std::shared_mutex> lock(packsMutex);
+				packs.emplace(path, std::move(pack));
+				searchPaths.emplace_back(path);
+				return;
+			}
+		} catch (const ZipException &e) {
+			Log::Warning("Failed to map zip pack ", path, ", ", e.what(), '\n');
+		}
+	}
+
 	if (PHYSFS_mount(path.c_str(), nullptr, true) == 0) {
 		Log::Warning("Failed to mount path ", path, ", ", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()), '\n');
 		return;
@@ -198,6 +220,10 @@ void Files::RemoveSearchPath(const std::string &path) {
 		return;
 	}
 
+	{
+		std::unique_lock<std::shared_mutex> lock(packsMutex);
+		packs.erase(path);
+	}
 	searchPaths.erase(it);
 }
 
@@ -207,9 +233,19 @@ void Files::ClearSearchPath() {
 			Log::Warning("Failed to unmount path ", searchPath, ", ", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()), '\n');
 	}
 
+	{
+		std::unique_lock<std::shared_mutex> lock(packsMutex);
+		packs.clear();
+	}
 	searchPaths.clear();
 }
 
+std::shared_ptr<const ZipPack> Files::GetPack(const std::string &path) const {
+	std::shared_lock<std::shared_mutex> lock(packsMutex);
+	auto it = packs.find(path);
+	return it != packs.end() ? it->second : nullptr;
+}
+
 bool Files::ExistsInPath(const std::filesystem::path &path) {
 	if (PHYSFS_isInit() == 0) return false;
 
@@ -218,6 +254,26 @@ bool Files::ExistsInPath(const std::filesystem::path &path) {
 	return PHYSFS_exists(pathStr.c_str()) != 0;
 }
 
+std::optional<int64_t> Files::GetModifiedTime(const std::filesystem::path &path) {
+	if (PHYSFS_isInit() == 0) return std::nullopt;
+
+	auto pathStr = path.string();
+	std::replace(pathStr.begin(), pathStr.end(), '\\', '/');
+	PHYSFS_Stat stat;
+	if (PHYSFS_stat(pathStr.c_str(), &stat) == 0 || stat.modtime < 0)
+		return std::nullopt;
+	return stat.modtime;
+}
+
+std::shared_future<AsyncReader::Result> Files::ReadAsync(const std::filesystem::path &path, AsyncReader::Priority priority) {
+	if (auto files = Get())
+		return files->asyncReader->Read(path, priority);
+
+	std::promise<AsyncReader::Result> promise;
+	promise.set_value(std::make_shared<MappedFile>(path));
+	return promise.get_future().share();
+}
+
 std::optional<std::string> Files::Read(const std::filesystem::path &path) {
 	auto pathStr = path.string();
 	std::replace(pathStr.begin(), pathStr.end(), '\\', '/');
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <shared_mutex>
+
 #include "Engine/Engine.hpp"
+#include "AsyncReader.hpp"
 
 struct PHYSFS_File;
 
 namespace acid {
+class ZipPack;
+
 enum class FileMode {
 	Read, Write, Append
 };
@@ -49,7 +54,7 @@ public:
 	void Update() override;
 
 	/**
-	 * Adds an file search path.
+	 * Adds an file search path, zip archives are memory mapped and mounted as a {@link ZipPack}.
 	 * @param path The path to add.
 	 */
 	void AddSearchPath(const std::string &path);
@@ -65,6 +70,17 @@ public:
 	 */
 	void ClearSearchPath();
 
+	const std::vector<std::string> &GetSearchPaths() const { return searchPaths; }
+
+	/**
+	 * Gets a mounted zip pack, safe to call from any thread.
+	 * @param path The search path the pack was added with.
+	 * @return The pack, kept open while held even if it is removed from the search path, or nullptr if the path is not a mounted pack.
+	 */
+	std::shared_ptr<const ZipPack> GetPack(const std::string &path) const;
+
+	AsyncReader &GetAsyncReader() { return *asyncReader; }
+
 	/**
 	 * Gets if the path is found in one of the search paths.
 	 * @param path The path to look for.
@@ -72,6 +88,21 @@ public:
 	 */
 	static bool ExistsInPath(const std::filesystem::path &path);
 
+	/**
+	 * Gets when a file found in one of the search paths was last modified.
+	 * @param path The path to look for.
+	 * @return The modification time in seconds since the epoch, or std::nullopt if it is not found or not known.
+	 */
+	static std::optional<int64_t> GetModifiedTime(const std::filesystem::path &path);
+
+	/**
+	 * Requests a file found by real or partial path to be read on the async reader threads.
+	 * @param path The path to read.
+	 * @param priority The priority of the request.
+	 * @return The future file, ready straight away when there is no files module.
+	 */
+	static std::shared_future<AsyncReader::Result> ReadAsync(const std::filesystem::path &path, AsyncReader::Priority priority = AsyncReader::Priority::Startup);
+
 	/**
 	 * Reads a file found by real or partial path.
 	 * @param path The path to read.
@@ -104,5 +135,9 @@ public:
 
 private:
 	std::vector<std::string> searchPaths;
+	std::map<std::string, std::shared_ptr<const ZipPack>> packs;
+	/// Guards packs, which are looked up from async reader threads.
+	mutable std::shared_mutex packsMutex;
+	std::unique_ptr<AsyncReader> asyncReader;
 };
 }
@@ -1,203 +1,608 @@
 #include "Json.hpp"
 
-#include "Utils/Enumerate.hpp"
+#include <charconv>
+
 #include "Utils/String.hpp"
 
 #define ATTRIBUTE_TEXT_SUPPORT 1
 
 namespace acid {
-void Json::ParseString(Node &node, std::string_view string) {
-	// Tokenizes the string view into small views that are used to build a Node tree.
-	std::vector<Node::Token> tokens;
-
-	std::size_t tokenStart = 0;
-	enum class QuoteState : char {
-		None = '\0', Single = '\'', Double = '"'
-	} quoteState = QuoteState::None;
-
-	// Iterates over all the characters in the string view.
-	for (auto &&[index, c] : Enumerate(string)) {
-		// If the previous character was a backslash the quote will not break the string.
-		if (c == '\'' && quoteState != QuoteState::Double && string[index - 1] != '\\')
-			quoteState = quoteState == QuoteState::None ? QuoteState::Single : QuoteState::None;
-		else if (c == '"' && quoteState != QuoteState::Single && string[index - 1] != '\\')
-			quoteState = quoteState == QuoteState::None ? QuoteState::Double : QuoteState::None;
-
-		// When not reading a string tokens can be found.
-		// While in a string whitespace and tokens are added to the strings view.
-		if (quoteState == QuoteState::None) {
-			if (String::IsWhitespace(c)) {
-				// On whitespace start save current token.
-				AddToken(std::string_view(string.data() + tokenStart, index - tokenStart), tokens);
-				tokenStart = index + 1;
-			} else if (c == ':' || c == '{' || c == '}' || c == ',' || c == '[' || c == ']') {
-				// Tokens used to read json nodes.
-				AddToken(std::string_view(string.data() + tokenStart, index - tokenStart), tokens);
-				tokens.emplace_back(Node::Type::Token, std::string_view(string.data() + index, 1));
-				tokenStart = index + 1;
-			}
-		}
+class Json::Reader {
+public:
+	Reader(std::string_view string, NodeAllocator<Node> allocator) :
+		begin(string.data()),
+		it(string.data()),
+		end(string.data() + string.size()),
+		allocator(std::move(allocator)),
+		properties(NodeScratchAllocator<Node>(this->allocator.GetArena())) {
 	}
 
-	// Converts the tokens into nodes.
-	int32_t k = 0;
-	Convert(node, tokens, k);
+	void SkipWhitespace() {
+		while (it != end && String::IsWhitespace(*it))
+			++it;
+	}
+
+	bool Consume(char c) {
+		SkipWhitespace();
+		if (it == end || *it != c)
+			return false;
+		++it;
+		return true;
+	}
+
+	void Expect(char c) {
+		if (!Consume(c))
+			Error(std::string("expected '") + c + '\'');
+	}
+
+	bool Literal(std::string_view literal) {
+		if (static_cast<std::size_t>(end - it) < literal.size() || std::string_view(it, literal.size()) != literal)
+			return false;
+		it += literal.size();
+		return true;
+	}
+
+	/**
+	 * Enters a object or array, failing once the nesting is deeper than {@link Node#MaxDepth}.
+	 */
+	void Enter() {
+		if (++depth > Node::MaxDepth)
+			Error("nesting is deeper than " + std::to_string(Node::MaxDepth) + " levels");
+	}
+
+	void Leave() {
+		depth--;
+	}
+
+	[[noreturn]] void Error(const std::string &message) const {
+		throw std::runtime_error("Json parse error at offset " + std::to_string(it - begin) + ", " + message);
+	}
+
+	/**
+	 * Sets a parsed string value, referencing it in place when the node has an arena.
+	 * @param current The node to set.
+	 * @param value The value, either in the source or the escape buffer.
+	 */
+	void SetValue(Node &current, std::string_view value) {
+		if (!allocator.GetArena())
+			current.SetValue(std::string(value));
+		else if (value.data() >= begin && value.data() < end)
+			current.SetValueView(value);
+		else
+			current.SetValueView(allocator.GetArena()->AddString(value));
+	}
+
+	const char *begin;
+	const char *it;
+	const char *end;
+	NodeAllocator<Node> allocator;
+	uint32_t depth = 0;
+	/// Properties of the objects being parsed, each list is moved into a exactly sized list once its object ends.
+	std::vector<Node, NodeScratchAllocator<Node>> properties;
+	/// Strings with escapes are decoded into these buffers, names are kept apart so both are valid while a value is read.
+	std::string unescaped;
+	std::string unescapedName;
+};
+
+void Json::ParseString(Node &node, std::string_view string) {
+	Reader reader(string, NodeAllocator<Node>(node.GetArena()));
+
+	// Skips the UTF-8 byte order mark some editors write.
+	reader.Literal("\xEF\xBB\xBF");
+	reader.SkipWhitespace();
+	if (reader.it == reader.end)
+		return;
+
+	ParseValue(node, reader);
+
+	reader.SkipWhitespace();
+	if (reader.it != reader.end)
+		reader.Error("unexpected data after the root value");
 }
 
 void Json::WriteStream(const Node &node, std::ostream &stream, Node::Format format) {
-	stream << (node.GetType() == Node::Type::Array ? '[' : '{') << format.newLine;
-	AppendData(node, stream, format, 1);
-	stream << (node.GetType() == Node::Type::Array ? ']' : '}');
-}
-
-void Json::AddToken(std::string_view view, std::vector<Node::Token> &tokens) {
-	if (view.length() != 0) {
-		// Finds the node value type of the string and adds it to the tokens vector.
-		if (view == "null") {
-			tokens.emplace_back(Node::Type::Null, std::string_view());
-		} else if (view == "true" || view == "false") {
-			tokens.emplace_back(Node::Type::Boolean, view);
-		} else if (String::IsNumber(view)) {
-			// This is a quick hack to get if the number is a decimal.
-			if (view.find('.') != std::string::npos) {
-				if (view.size() >= std::numeric_limits<long double>::digits)
-					throw std::runtime_error("Decimal number is too long");
-				tokens.emplace_back(Node::Type::Decimal, view);
-			} else {
-				if (view.size() >= std::numeric_limits<uint64_t>::digits)
-					throw std::runtime_error("Integer number is too long");
-				tokens.emplace_back(Node::Type::Integer, view);
-			}
-		} else { // if (view.front() == view.back() == '\"')
-			tokens.emplace_back(Node::Type::String, view.substr(1, view.length() - 2));
-		}
+	Writer writer(stream, format);
+	writer.Visit(node);
+}
+
+void Json::Read(std::string_view string, NodeHandler &handler) {
+	Reader reader(string, {});
+
+	reader.Literal("\xEF\xBB\xBF");
+	reader.SkipWhitespace();
+	if (reader.it == reader.end)
+		return;
+
+	ReadValue(&handler, {}, reader);
+
+	reader.SkipWhitespace();
+	if (reader.it != reader.end)
+		reader.Error("unexpected data after the root value");
+}
+
+void Json::ParseValue(Node &current, Reader &reader) {
+	reader.SkipWhitespace();
+	if (reader.it == reader.end)
+		reader.Error("unexpected end of input");
+
+	switch (*reader.it) {
+	case '{':
+		ParseObject(current, reader);
+		break;
+	case '[':
+		ParseArray(current, reader);
+		break;
+	case '"':
+	case '\'': {
+		reader.SetValue(current, ParseQuoted(reader, reader.unescaped));
+		current.SetType(Node::Type::String);
+		break;
+	}
+	case 't':
+	case 'f':
+		if (reader.Literal("true"))
+			reader.SetValue(current, {reader.it - 4, 4});
+		else if (reader.Literal("false"))
+			reader.SetValue(current, {reader.it - 5, 5});
+		else
+			reader.Error("invalid literal");
+		current.SetType(Node::Type::Boolean);
+		break;
+	case 'n':
+		if (!reader.Literal("null"))
+			reader.Error("invalid literal");
+		current.SetValue({});
+		current.SetType(Node::Type::Null);
+		break;
+	default: {
+		Node::Type type;
+		auto number = ParseNumber(reader, type);
+		reader.SetValue(current, number);
+		current.SetType(type);
+		break;
+	}
 	}
 }
 
-void Json::Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k) {
-	if (tokens[k] == Node::Token(Node::Type::Token, "{")) {
-		k++;
+void Json::ParseObject(Node &current, Reader &reader) {
+	reader.Expect('{');
+	reader.Enter();
+	auto first = reader.properties.size();
+
+	// A comma before the closing brace is accepted, older files were written with them.
+	while (!reader.Consume('}')) {
+		reader.SkipWhitespace();
+		if (reader.it == reader.end)
+			reader.Error("missing end of {} object");
+
+		auto key = ParseQuoted(reader, reader.unescaped);
+		reader.Expect(':');
 
-		while (tokens[k] != Node::Token(Node::Type::Token, "}")) {
-			auto key = tokens[k].view;
-			if (k + 2 >= tokens.size())
-				throw std::runtime_error("Missing end of {} array");
-			if (tokens[k + 1].view != ":")
-				throw std::runtime_error("Missing object colon");
-			k += 2;
 #if ATTRIBUTE_TEXT_SUPPORT
-			// Write value string into current value, then continue parsing properties into current.
-			if (key == "#text")
-				Convert(current, tokens, k);
-			else
+		// Write value string into current value, then continue parsing properties into current.
+		if (key == "#text") {
+			ParseValue(current, reader);
+		} else
 #endif
-				Convert(current.AddProperty(std::string(key)), tokens, k);
-			if (tokens[k].view == ",")
-				k++;
-		}
-		k++;
-
-		current.SetType(Node::Type::Object);
-	} else if (tokens[k] == Node::Token(Node::Type::Token, "[")) {
-		k++;
-
-		while (tokens[k] != Node::Token(Node::Type::Token, "]")) {
-			if (k >= tokens.size())
-				throw std::runtime_error("Missing end of [] object");
-			Convert(current.AddProperty(), tokens, k);
-			if (tokens[k].view == ",")
-				k++;
+		{
+			Node property(reader.allocator);
+			property.SetName(key);
+			ParseValue(property, reader);
+			reader.properties.emplace_back(std::move(property));
 		}
-		k++;
 
-		current.SetType(Node::Type::Array);
-	} else {
-		std::string str(tokens[k].view);
-		if (tokens[k].type == Node::Type::String)
-			str = String::UnfixEscapedChars(str);
-		current.SetValue(str);
-		current.SetType(tokens[k].type);
-		k++;
+		if (!reader.Consume(',')) {
+			reader.Expect('}');
+			break;
+		}
 	}
+
+	MoveProperties(current, reader, first);
+	current.SetType(Node::Type::Object);
+	reader.Leave();
 }
 
-void Json::AppendData(const Node &node, std::ostream &stream, Node::Format format, int32_t indent) {
-	auto indents = format.GetIndents(indent);
+void Json::ParseArray(Node &current, Reader &reader) {
+	reader.Expect('[');
+	reader.Enter();
+	auto first = reader.properties.size();
 
-	// Only output the value if no properties exist.
-	if (node.GetProperties().empty()) {
-		if (node.GetType() == Node::Type::String)
-			stream << '\"' << String::FixEscapedChars(node.GetValue()) << '\"';
-		else if (node.GetType() == Node::Type::Null)
-			stream << "null";
-		else
-			stream << node.GetValue();
-	}
+	while (!reader.Consume(']')) {
+		reader.SkipWhitespace();
+		if (reader.it == reader.end)
+			reader.Error("missing end of [] array");
 
-#if ATTRIBUTE_TEXT_SUPPORT
-	// If the Json Node has both properties and a value, value will be written as a "#text" property.
-	// XML is the only format that allows a Node to have both a value and properties.
-	if (!node.GetProperties().empty() && !node.GetValue().empty()) {
-		stream << indents;
-		stream << "\"#text\":" << format.space << "\"" << node.GetValue() << "\",";
-		// No new line if the indent level is zero (if primitive array type).
-		stream << (indent != 0 ? format.newLine : format.space);
+		Node property(reader.allocator);
+		ParseValue(property, reader);
+		reader.properties.emplace_back(std::move(property));
+
+		if (!reader.Consume(',')) {
+			reader.Expect(']');
+			break;
+		}
 	}
-#endif
 
-	// Output each property.
-	for (auto it = node.GetProperties().begin(); it < node.GetProperties().end(); ++it) {
-		stream << indents;
-		// Output name for property if it exists.
-		if (!it->GetName().empty()) {
-			stream << '\"' << it->GetName() << "\":" << format.space;
+	MoveProperties(current, reader, first);
+	current.SetType(Node::Type::Array);
+	reader.Leave();
+}
+
+void Json::MoveProperties(Node &current, Reader &reader, std::size_t first) {
+	// Each list is allocated once at its final size, so no memory is left behind in the arena by growing lists.
+	auto &properties = current.GetProperties();
+	properties.reserve(properties.size() + reader.properties.size() - first);
+	for (auto it = reader.properties.begin() + first; it != reader.properties.end(); ++it)
+		current.AddProperty(std::move(*it));
+	reader.properties.erase(reader.properties.begin() + first, reader.properties.end());
+}
+
+std::string_view Json::ParseQuoted(Reader &reader, std::string &unescaped) {
+	auto quote = *reader.it;
+	if (quote != '"' && quote != '\'')
+		reader.Error("expected a string");
+	++reader.it;
+
+	// Strings without escapes are returned as a view of the source.
+	auto start = reader.it;
+	while (reader.it != reader.end && *reader.it != quote && *reader.it != '\\')
+		++reader.it;
+	if (reader.it != reader.end && *reader.it == quote)
+		return {start, static_cast<std::size_t>(reader.it++ - start)};
+
+	auto &dest = unescaped;
+	dest.assign(start, reader.it);
+
+	while (reader.it != reader.end && *reader.it != quote) {
+		// Runs without escapes are copied straight from the buffer in one go.
+		if (*reader.it != '\\') {
+			auto start = reader.it;
+			while (reader.it != reader.end && *reader.it != quote && *reader.it != '\\')
+				++reader.it;
+			dest.append(start, reader.it);
+			continue;
 		}
 
-		bool isArray = false;
-		if (!it->GetProperties().empty()) {
-			// If all properties have no names, then this must be an array.
-			for (const auto &property2 : it->GetProperties()) {
-				if (property2.GetName().empty()) {
-					isArray = true;
-					break;
-				}
+		if (++reader.it == reader.end)
+			break;
+
+		switch (auto c = *reader.it++) {
+		case 'n':
+			dest += '\n';
+			break;
+		case 'r':
+			dest += '\r';
+			break;
+		case 't':
+			dest += '\t';
+			break;
+		case 'b':
+			dest += '\b';
+			break;
+		case 'f':
+			dest += '\f';
+			break;
+		case 'u': {
+			auto readHex = [&reader]() {
+				uint32_t code = 0;
+				if (reader.end - reader.it < 4 || std::from_chars(reader.it, reader.it + 4, code, 16).ptr != reader.it + 4)
+					reader.Error("invalid unicode escape");
+				reader.it += 4;
+				return code;
+			};
+
+			auto code = readHex();
+			// Characters outside of the basic plane are escaped as a UTF-16 surrogate pair, a surrogate on its own is not a character.
+			if (code >= 0xD800 && code <= 0xDBFF) {
+				if (!reader.Literal("\\u"))
+					reader.Error("unpaired high surrogate");
+				auto low = readHex();
+				if (low < 0xDC00 || low > 0xDFFF)
+					reader.Error("invalid low surrogate");
+				code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+			} else if (code >= 0xDC00 && code <= 0xDFFF) {
+				reader.Error("unpaired low surrogate");
 			}
 
-			stream << (isArray ? '[' : '{') << format.newLine;
-		} else if (it->GetType() == Node::Type::Object) {
-			stream << '{';
-		} else if (it->GetType() == Node::Type::Array) {
-			stream << '[';
+			if (code < 0x80) {
+				dest += static_cast<char>(code);
+			} else if (code < 0x800) {
+				dest += static_cast<char>(0xC0 | (code >> 6));
+				dest += static_cast<char>(0x80 | (code & 0x3F));
+			} else if (code < 0x10000) {
+				dest += static_cast<char>(0xE0 | (code >> 12));
+				dest += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				dest += static_cast<char>(0x80 | (code & 0x3F));
+			} else {
+				dest += static_cast<char>(0xF0 | (code >> 18));
+				dest += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+				dest += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				dest += static_cast<char>(0x80 | (code & 0x3F));
+			}
+			break;
 		}
+		default:
+			// Quotes, slashes and any unknown escape are kept as the escaped character.
+			dest += c;
+			break;
+		}
+	}
 
-		// If a node type is a primitive type.
-		static constexpr auto IsPrimitive = [](const Node &type) {
-			return type.GetProperties().empty() && type.GetType() != Node::Type::Object && type.GetType() != Node::Type::Array && type.GetType() != Node::Type::Unknown;
-		};
-
-		// Shorten primitive array output length.
-		if (isArray && format.inlineArrays && !it->GetProperties().empty() && IsPrimitive(it->GetProperties()[0])) {
-			stream << format.GetIndents(indent + 1);
-			// New lines are printed a a space, no spaces are ever emitted by primitives.
-			AppendData(*it, stream, Node::Format(0, '\0', '\0', false), indent);
-			stream << '\n';
+	if (reader.it == reader.end)
+		reader.Error("missing end of string");
+	++reader.it;
+	return dest;
+}
+
+std::string_view Json::ParseNumber(Reader &reader, Node::Type &type) {
+	// Finds the extent of the number following the JSON grammar, the value is kept as written.
+	auto start = reader.it;
+	auto isDigit = [&reader]() {
+		return reader.it != reader.end && *reader.it >= '0' && *reader.it <= '9';
+	};
+	auto skipDigits = [&]() {
+		auto digitsStart = reader.it;
+		while (isDigit())
+			++reader.it;
+		if (reader.it == digitsStart)
+			reader.Error("invalid number");
+	};
+
+	auto decimal = false;
+	if (*reader.it == '-')
+		++reader.it;
+	// A zero can only be followed by a fraction or exponent, "01" is not a JSON number.
+	if (reader.it != reader.end && *reader.it == '0' && reader.end - reader.it > 1 && reader.it[1] >= '0' && reader.it[1] <= '9')
+		reader.Error("invalid number, leading zeros are not allowed");
+	skipDigits();
+	if (reader.it != reader.end && *reader.it == '.') {
+		++reader.it;
+		skipDigits();
+		decimal = true;
+	}
+	if (reader.it != reader.end && (*reader.it == 'e' || *reader.it == 'E')) {
+		++reader.it;
+		if (reader.it != reader.end && (*reader.it == '+' || *reader.it == '-'))
+			++reader.it;
+		skipDigits();
+		decimal = true;
+	}
+
+	// Integers that do not fit into 64 bits are stored as decimals.
+	if (!decimal) {
+		std::from_chars_result result;
+		if (*start == '-') {
+			int64_t integer;
+			result = std::from_chars(start, reader.it, integer);
 		} else {
-			AppendData(*it, stream, format, indent + 1);
+			uint64_t integer;
+			result = std::from_chars(start, reader.it, integer);
+		}
+		decimal = result.ec != std::errc() || result.ptr != reader.it;
+	}
+
+#if defined(__cpp_lib_to_chars)
+	if (decimal) {
+		double value;
+		auto result = std::from_chars(start, reader.it, value);
+		if (result.ptr != reader.it || (result.ec != std::errc() && result.ec != std::errc::result_out_of_range))
+			reader.Error("invalid number");
+	}
+#endif
+
+	type = decimal ? Node::Type::Decimal : Node::Type::Integer;
+	return {start, static_cast<std::size_t>(reader.it - start)};
+}
+
+void Json::ReadValue(NodeHandler *handler, std::string_view name, Reader &reader) {
+	reader.SkipWhitespace();
+	if (reader.it == reader.end)
+		reader.Error("unexpected end of input");
+
+	switch (*reader.it) {
+	case '{': {
+		++reader.it;
+		reader.Enter();
+		// Skipped objects are still read to find their end, without a handler to send events to.
+		auto objectHandler = handler && handler->BeginObject(name) ? handler : nullptr;
+
+		while (!reader.Consume('}')) {
+			reader.SkipWhitespace();
+			if (reader.it == reader.end)
+				reader.Error("missing end of {} object");
+
+			auto key = ParseQuoted(reader, reader.unescapedName);
+			reader.Expect(':');
+			ReadValue(objectHandler, key, reader);
+
+			if (!reader.Consume(',')) {
+				reader.Expect('}');
+				break;
+			}
 		}
 
-		if (!it->GetProperties().empty()) {
-			stream << indents << (isArray ? ']' : '}');
-		} else if (it->GetType() == Node::Type::Object) {
-			stream << '}';
-		} else if (it->GetType() == Node::Type::Array) {
-			stream << ']';
+		if (objectHandler)
+			objectHandler->EndObject();
+		reader.Leave();
+		break;
+	}
+	case '[': {
+		++reader.it;
+		reader.Enter();
+		auto arrayHandler = handler && handler->BeginArray(name) ? handler : nullptr;
+
+		while (!reader.Consume(']')) {
+			reader.SkipWhitespace();
+			if (reader.it == reader.end)
+				reader.Error("missing end of [] array");
+
+			ReadValue(arrayHandler, {}, reader);
+
+			if (!reader.Consume(',')) {
+				reader.Expect(']');
+				break;
+			}
 		}
 
-		// Separate properties by comma.
-		if (it != node.GetProperties().end() - 1)
-			stream << ',';
-		// No new line if the indent level is zero (if primitive array type).
-		stream << (indent != 0 ? format.newLine : format.space);
+		if (arrayHandler)
+			arrayHandler->EndArray();
+		reader.Leave();
+		break;
+	}
+	case '"':
+	case '\'': {
+		auto value = ParseQuoted(reader, reader.unescaped);
+		if (handler)
+			handler->Value(name, Node::Type::String, value);
+		break;
+	}
+	case 't':
+	case 'f': {
+		std::string_view literal = *reader.it == 't' ? "true" : "false";
+		if (!reader.Literal(literal))
+			reader.Error("invalid literal");
+		if (handler)
+			handler->Value(name, Node::Type::Boolean, literal);
+		break;
+	}
+	case 'n':
+		if (!reader.Literal("null"))
+			reader.Error("invalid literal");
+		if (handler)
+			handler->Value(name, Node::Type::Null, {});
+		break;
+	default: {
+		Node::Type type;
+		auto number = ParseNumber(reader, type);
+		if (handler)
+			handler->Value(name, type, number);
+		break;
+	}
+	}
+}
+
+Json::Writer::Writer(std::ostream &stream, Node::Format format) :
+	NodeWriter(stream, format) {
+}
+
+bool Json::Writer::BeginObject(std::string_view name) {
+	BeginProperty(name, false);
+	Append('{');
+	scopes.emplace_back(Scope{false});
+	return true;
+}
+
+void Json::Writer::EndObject() {
+	EndScope('}');
+}
+
+bool Json::Writer::BeginArray(std::string_view name) {
+	BeginProperty(name, false);
+	Append('[');
+	scopes.emplace_back(Scope{true});
+	return true;
+}
+
+void Json::Writer::EndArray() {
+	EndScope(']');
+}
+
+void Json::Writer::Value(std::string_view name, Node::Type type, std::string_view value) {
+	BeginProperty(name, true);
+
+	switch (type) {
+	case Node::Type::String:
+		Append('"');
+		AppendEscaped(value);
+		Append('"');
+		break;
+	case Node::Type::Blob:
+		Append('"');
+		Append(String::EncodeBase64(value));
+		Append('"');
+		break;
+	default:
+		// Values without text would not be valid JSON.
+		Append(type == Node::Type::Null || value.empty() ? "null" : value);
+		break;
+	}
+}
+
+void Json::Writer::BeginProperty(std::string_view name, bool isValue) {
+	if (scopes.empty())
+		return;
+
+	auto &scope = scopes.back();
+	if (scope.count++ == 0) {
+		// Arrays that start with a value are written on a single line.
+		scope.isInline = scope.isArray && isValue && format.inlineArrays;
+	} else {
+		Append(',');
+	}
+
+	if (scope.isInline) {
+		if (scope.count != 1)
+			AppendSpace();
+	} else {
+		AppendNewLine();
+		AppendIndents(scopes.size());
+	}
+
+	if (!scope.isArray) {
+		Append('"');
+		AppendEscaped(name);
+		Append("\":");
+		AppendSpace();
+	}
+}
+
+void Json::Writer::EndScope(char close) {
+	auto scope = scopes.back();
+	scopes.pop_back();
+
+	if (scope.count != 0 && !scope.isInline) {
+		AppendNewLine();
+		AppendIndents(scopes.size());
 	}
+	Append(close);
+}
+
+void Json::Writer::AppendEscaped(std::string_view string) {
+	auto start = string.data();
+	for (auto it = string.data(); it != string.data() + string.size(); ++it) {
+		auto c = static_cast<unsigned char>(*it);
+		if (c >= 0x20 && c != '"' && c != '\\')
+			continue;
+
+		// Runs without escapes are appended in one go.
+		Append({start, static_cast<std::size_t>(it - start)});
+		start = it + 1;
+
+		switch (c) {
+		case '"':
+			Append("\\\"");
+			break;
+		case '\\':
+			Append("\\\\");
+			break;
+		case '\n':
+			Append("\\n");
+			break;
+		case '\r':
+			Append("\\r");
+			break;
+		case '\t':
+			Append("\\t");
+			break;
+		default: {
+			static constexpr std::string_view Hex = "0123456789abcdef";
+			Append("\\u00");
+			Append(Hex[c >> 4]);
+			Append(Hex[c & 0xf]);
+			break;
+		}
+		}
+	}
+
+	Append({start, static_cast<std::size_t>(string.data() + string.size() - start)});
 }
 }
@@ -1,19 +1,65 @@
 #pragma once
 
-#include "Files/Node.hpp"
+#include "Files/NodeWriter.hpp"
 
 namespace acid {
+/**
+ * @brief Class that reads and writes JSON using {@link Node} as storage.
+ * Parsing is a single recursive descent pass over a contiguous buffer that builds the node tree directly,
+ * when the node has an arena the buffer must be owned by it as values reference the buffer.
+ */
 class ACID_EXPORT Json {
 public:
+	/**
+	 * @brief Class that writes JSON as {@link NodeHandler} events arrive, without building a node tree.
+	 */
+	class ACID_EXPORT Writer : public NodeWriter {
+	public:
+		explicit Writer(std::ostream &stream, Node::Format format = Node::Format::Minified);
+
+		bool BeginObject(std::string_view name) override;
+		void EndObject() override;
+		bool BeginArray(std::string_view name) override;
+		void EndArray() override;
+		void Value(std::string_view name, Node::Type type, std::string_view value) override;
+
+	private:
+		class Scope {
+		public:
+			bool isArray;
+			bool isInline = false;
+			uint32_t count = 0;
+		};
+
+		void BeginProperty(std::string_view name, bool isValue);
+		void EndScope(char close);
+		void AppendEscaped(std::string_view string);
+
+		std::vector<Scope> scopes;
+	};
+
 	Json() = delete;
 	
 	static void ParseString(Node &node, std::string_view string);
 	static void WriteStream(const Node &node, std::ostream &stream, Node::Format format);
 
+	/**
+	 * Reads a document as a stream of events, without building a node tree.
+	 * @param string The document, usually the contents of a {@link MappedFile}.
+	 * @param handler The handler to send events to.
+	 */
+	static void Read(std::string_view string, NodeHandler &handler);
+
 private:
-	static void AddToken(std::string_view view, std::vector<Node::Token> &tokens);
-	static void Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k);
+	class Reader;
+
+	static void ParseValue(Node &current, Reader &reader);
+	static void ParseObject(Node &current, Reader &reader);
+	static void ParseArray(Node &current, Reader &reader);
+	static void MoveProperties(Node &current, Reader &reader, std::size_t first);
+	static std::string_view ParseQuoted(Reader &reader, std::string &unescaped);
+	static std::string_view ParseNumber(Reader &reader, Node::Type &type);
 
-	static void AppendData(const Node &node, std::ostream &stream, Node::Format format, int32_t indent);
+	static void ReadValue(NodeHandler *handler, std::string_view name, Reader &reader);
 };
 }
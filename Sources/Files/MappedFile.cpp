@@ -0,0 +1,246 @@
+#include "MappedFile.hpp"
+
+#if defined(ACID_BUILD_WINDOWS)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <physfs.h>
+#include "Engine/Log.hpp"
+#include "Files.hpp"
+#include "Zip/ZipPack.hpp"
+
+namespace acid {
+MappedFile::MappedFile(const std::filesystem::path &filename) {
+	Open(filename);
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+	*this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+	if (this == &other)
+		return *this;
+
+	Close();
+	data = std::exchange(other.data, nullptr);
+	size = std::exchange(other.size, 0);
+	mapping = std::exchange(other.mapping, nullptr);
+#if defined(ACID_BUILD_WINDOWS)
+	fileHandle = std::exchange(other.fileHandle, nullptr);
+	mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+	// Moving a vector keeps its heap storage, so data stays valid.
+	buffer = std::move(other.buffer);
+	pack = std::move(other.pack);
+	return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path &filename) {
+	Close();
+
+	auto pathStr = filename.string();
+	std::replace(pathStr.begin(), pathStr.end(), '\\', '/');
+
+	auto realPath = filename;
+
+	if (PHYSFS_isInit() != 0 && PHYSFS_exists(pathStr.c_str()) != 0) {
+		std::filesystem::path realDir = PHYSFS_getRealDir(pathStr.c_str());
+
+		if (std::filesystem::is_directory(realDir)) {
+			realPath = realDir / filename;
+		} else {
+			// Files inside a mounted pack are read from the pack mapping, stored entries are not copied at all.
+			if (auto files = Files::Get()) {
+				if (auto filePack = files->GetPack(realDir.string())) {
+					if (auto entry = filePack->Find(pathStr)) {
+						try {
+							if (auto view = filePack->View(*entry)) {
+								data = reinterpret_cast<const uint8_t *>(view->data());
+								size = view->size();
+								pack = std::move(filePack);
+							} else {
+								auto contents = filePack->Read(*entry);
+								buffer.assign(contents.begin(), contents.end());
+								data = buffer.data();
+								size = buffer.size();
+							}
+						} catch (const std::exception &e) {
+							Log::Error("Failed to read file ", filename, ", ", e.what(), '\n');
+							return false;
+						}
+						return true;
+					}
+				}
+			}
+
+			// The file lives inside a mounted archive, there is nothing on disk to map.
+			auto fsFile = PHYSFS_openRead(pathStr.c_str());
+			if (!fsFile) {
+				Log::Error("Failed to open file ", filename, ", ", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()), '\n');
+				return false;
+			}
+
+			auto length = PHYSFS_fileLength(fsFile);
+			if (length >= 0)
+				buffer.resize(static_cast<std::size_t>(length));
+			auto bytesRead = length >= 0 ? PHYSFS_readBytes(fsFile, buffer.data(), static_cast<PHYSFS_uint64>(buffer.size())) : -1;
+			PHYSFS_close(fsFile);
+
+			if (bytesRead < 0 || static_cast<std::size_t>(bytesRead) != buffer.size()) {
+				Log::Error("Failed to read file ", filename, ", ", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()), '\n');
+				Close();
+				return false;
+			}
+
+			data = buffer.data();
+			size = buffer.size();
+			return true;
+		}
+	}
+
+	if (!std::filesystem::is_regular_file(realPath)) {
+		Log::Error("Failed to map file ", filename, ", file does not exist\n");
+		return false;
+	}
+
+	size = static_cast<std::size_t>(std::filesystem::file_size(realPath));
+
+	if (size == 0) {
+		// Zero length mappings are invalid, an empty buffer still gives a valid data pointer.
+		buffer.resize(1);
+		data = buffer.data();
+		return true;
+	}
+
+#if defined(ACID_BUILD_WINDOWS)
+	fileHandle = CreateFileW(realPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		fileHandle = nullptr;
+		size = 0;
+		return false;
+	}
+
+	if (size < MapThreshold) {
+		// Small files are cheaper to copy than to map and fault in.
+		buffer.resize(size);
+		DWORD bytesRead = 0;
+		auto read = ReadFile(fileHandle, buffer.data(), static_cast<DWORD>(size), &bytesRead, nullptr);
+		CloseHandle(fileHandle);
+		fileHandle = nullptr;
+		if (!read || bytesRead != size) {
+			Log::Error("Failed to read file ", filename, '\n');
+			Close();
+			return false;
+		}
+
+		data = buffer.data();
+		return true;
+	}
+
+	mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle)
+		mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+	auto fd = open(realPath.c_str(), O_RDONLY);
+	if (fd == -1) {
+		size = 0;
+		return false;
+	}
+
+	if (size < MapThreshold) {
+		// Small files are cheaper to copy than to map and fault in.
+		buffer.resize(size);
+		std::size_t offset = 0;
+		while (offset < size) {
+			auto bytesRead = pread(fd, buffer.data() + offset, size - offset, static_cast<off_t>(offset));
+			if (bytesRead <= 0)
+				break;
+			offset += static_cast<std::size_t>(bytesRead);
+		}
+		close(fd);
+
+		if (offset != size) {
+			Log::Error("Failed to read file ", filename, '\n');
+			Close();
+			return false;
+		}
+
+		data = buffer.data();
+		return true;
+	}
+
+	mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+		mapping = nullptr;
+#endif
+
+	if (!mapping) {
+		Log::Warning("Failed to map file ", filename, ", falling back to a read\n");
+		Close();
+		std::ifstream inStream(realPath, std::ios::in | std::ios::binary);
+		buffer.resize(static_cast<std::size_t>(std::filesystem::file_size(realPath)));
+		if (!inStream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+			Log::Error("Failed to read file ", filename, '\n');
+			Close();
+			return false;
+		}
+
+		data = buffer.data();
+		size = buffer.size();
+		return true;
+	}
+
+	data = static_cast<const uint8_t *>(mapping);
+	return true;
+}
+
+void MappedFile::Prefetch() const {
+	if (!mapping)
+		return;
+
+#if !defined(ACID_BUILD_WINDOWS)
+	madvise(mapping, size, MADV_WILLNEED);
+#endif
+
+	// Reading a byte from every page faults the whole file in on the calling thread.
+	uint8_t sum = 0;
+	for (std::size_t i = 0; i < size; i += 4096)
+		sum += data[i];
+	volatile auto result = sum;
+	(void)result;
+}
+
+void MappedFile::Close() {
+#if defined(ACID_BUILD_WINDOWS)
+	if (mapping)
+		UnmapViewOfFile(mapping);
+	if (mappingHandle)
+		CloseHandle(mappingHandle);
+	if (fileHandle)
+		CloseHandle(fileHandle);
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+#else
+	if (mapping)
+		munmap(mapping, size);
+#endif
+
+	mapping = nullptr;
+	data = nullptr;
+	size = 0;
+	buffer.clear();
+	buffer.shrink_to_fit();
+	pack = nullptr;
+}
+}
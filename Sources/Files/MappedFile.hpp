@@ -0,0 +1,71 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "Utils/NonCopyable.hpp"
+
+namespace acid {
+class ZipPack;
+
+/**
+ * @brief Class that gives read-only access to the bytes of a file, memory mapped when the file lives on disk.
+ * Files smaller than {@link MappedFile#MapThreshold} are read into an owned buffer, which is cheaper than mapping them.
+ * Files that are only found inside a mounted archive are read into an owned buffer instead,
+ * except for stored entries of a mounted {@link ZipPack}, which point into the pack mapping and keep the pack open until the file is closed.
+ */
+class ACID_EXPORT MappedFile : NonCopyable {
+public:
+	/// Files at least this many bytes are mapped, smaller files are read.
+	static constexpr std::size_t MapThreshold = 64 * 1024;
+
+	MappedFile() = default;
+	/**
+	 * Creates a new mapped file.
+	 * @param filename The file to map, found by real or partial path.
+	 */
+	explicit MappedFile(const std::filesystem::path &filename);
+	~MappedFile();
+
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+
+	/**
+	 * Maps a file, closing any file already mapped.
+	 * @param filename The file to map, found by real or partial path.
+	 * @return If the file could be opened.
+	 */
+	bool Open(const std::filesystem::path &filename);
+	void Close();
+
+	const uint8_t *GetData() const { return data; }
+	std::size_t GetSize() const { return size; }
+
+	/**
+	 * Gets if the data is backed by a operating system mapping, rather than a copy read into memory.
+	 * @return If the file is memory mapped.
+	 */
+	bool IsMapped() const { return mapping != nullptr; }
+
+	/**
+	 * Faults in every page of a mapped file, so later reads of the data do not wait on the disk.
+	 */
+	void Prefetch() const;
+
+	explicit operator bool() const noexcept { return data != nullptr; }
+
+private:
+	const uint8_t *data = nullptr;
+	std::size_t size = 0;
+
+	void *mapping = nullptr;
+#if defined(ACID_BUILD_WINDOWS)
+	void *fileHandle = nullptr;
+	void *mappingHandle = nullptr;
+#endif
+	std::vector<uint8_t> buffer;
+	/// The pack that data points into, when viewing a stored entry.
+	std::shared_ptr<const ZipPack> pack;
+};
+}
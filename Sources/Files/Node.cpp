@@ -1,6 +1,7 @@
 #include "Node.hpp"
 
 #include <algorithm>
+#include <utility>
 
 namespace acid {
 const Node::Format Node::Format::Beautified = Format(2, '\n', ' ', true);
@@ -8,13 +9,20 @@ const Node::Format Node::Format::Minified = Format(0, '\0', '\0', false);
 
 static const Node NullNode = (Node() = nullptr);
 
+static std::size_t GetIndexSlot(const std::string *key, std::size_t mask) {
+	// Interned names are unique, so the pointer is hashed rather than the string.
+	return static_cast<std::size_t>((static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key)) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
 Node::Node() :
+	name(NodeKeys::Empty()),
 	type(Type::Object) {
 }
 
 Node::Node(const std::string &name) :
-	name(name),
-	type(Type::Object) {
+	name(NodeKeys::Acquire(name)),
+	type(Type::Object),
+	ownsName(true) {
 }
 
 Node::Node(const std::string &name, const Node &node) :
@@ -22,8 +30,78 @@ Node::Node(const std::string &name, const Node &node) :
 	SetName(name);
 }
 
+Node::Node(const NodeAllocator<Node> &allocator) :
+	properties(allocator),
+	name(NodeKeys::Empty()),
+	type(Type::Object) {
+}
+
+Node::Node(std::unique_ptr<NodeArena> &&arena) :
+	arena(std::move(arena)),
+	properties(NodeAllocator<Node>(this->arena.get())),
+	name(NodeKeys::Empty()),
+	type(Type::Object) {
+}
+
+Node::Node(const Node &node) :
+	properties(node.properties),
+	// Copies may outlive the source document, so they hold their own reference to the name rather than relying on its arena.
+	name(node.name == NodeKeys::Empty() ? node.name : NodeKeys::Acquire(*node.name)),
+	// Copies are allocated on the heap and may outlive the source document, so viewed values are copied.
+	value(node.GetValueView()),
+	index(node.index),
+	indexedCount(node.indexedCount),
+	type(node.type),
+	ownsName(name != NodeKeys::Empty()) {
+}
+
+Node::Node(Node &&node) noexcept :
+	Node(std::move(node), nullptr) {
+}
+
+Node::Node(Node &&node, NodeArena *destination) noexcept :
+	arena(std::move(node.arena)),
+	name(std::exchange(node.name, NodeKeys::Empty())),
+	value(std::move(node.value)),
+	valueView(node.valueView),
+	index(std::move(node.index)),
+	indexedCount(node.indexedCount),
+	type(node.type),
+	ownsName(std::exchange(node.ownsName, false)) {
+	auto sourceArena = node.GetArena();
+	if (arena || !sourceArena || sourceArena == destination) {
+		properties = std::move(node.properties);
+		return;
+	}
+
+	// The source document owns everything this node references, so it is re-homed before the document can be destroyed.
+	properties.reserve(node.properties.size());
+	for (auto &property : node.properties)
+		properties.emplace_back(std::move(property));
+	if (!ownsName && name != NodeKeys::Empty()) {
+		name = NodeKeys::Acquire(*name);
+		ownsName = true;
+	}
+	if (valueView.data()) {
+		value = valueView;
+		valueView = {};
+	}
+}
+
+Node::~Node() {
+	if (ownsName)
+		NodeKeys::Release(name);
+}
+
 void Node::Clear() {
 	properties.clear();
+	index.clear();
+	indexedCount = 0;
+}
+
+void Node::SetBlob(std::string_view bytes) {
+	SetValue(std::string(bytes));
+	type = Type::Blob;
 }
 
 bool Node::IsValid() const {
@@ -37,17 +115,12 @@ bool Node::IsValid() const {
 	case Type::Null:
 		return true;
 	default:
-		return !value.empty();
+		return !GetValueView().empty();
 	}
 }
 
 bool Node::HasProperty(const std::string &name) const {
-	for (const auto &property : properties) {
-		if (property.name == name)
-			return true;
-	}
-
-	return false;
+	return FindProperty(name) != NotFound;
 }
 
 bool Node::HasProperty(uint32_t index) const {
@@ -55,10 +128,8 @@ bool Node::HasProperty(uint32_t index) const {
 }
 
 NodeConstView Node::GetProperty(const std::string &name) const {
-	for (const auto &property : properties) {
-		if (property.name == name)
-			return {this, name, &property};
-	}
+	if (auto i = FindProperty(name); i != NotFound)
+		return {this, i, &properties[i]};
 
 	return {this, name, nullptr};
 }
@@ -70,12 +141,9 @@ NodeConstView Node::GetProperty(uint32_t index) const {
 	return {this, index, nullptr};
 }
 
-// TODO: Duplicate
 NodeView Node::GetProperty(const std::string &name) {
-	for (auto &property : properties) {
-		if (property.name == name)
-			return {this, name, &property};
-	}
+	if (auto i = FindProperty(name); i != NotFound)
+		return {this, i, &properties[i]};
 
 	return {this, name, nullptr};
 }
@@ -89,22 +157,33 @@ NodeView Node::GetProperty(uint32_t index) {
 }
 
 Node &Node::AddProperty(const Node &node) {
-	return properties.emplace_back(node);
+	auto &property = properties.emplace_back(node);
+	IndexLastProperty();
+	return property;
 }
 
 Node &Node::AddProperty(Node &&node) {
-	return properties.emplace_back(std::move(node));
+	auto &property = properties.emplace_back(std::move(node));
+	IndexLastProperty();
+	return property;
 }
 
 Node &Node::AddProperty(const std::string &name, const Node &node) {
 	Node newNode = node;
-	newNode.name = name;
-	return properties.emplace_back(std::move(newNode));
+	newNode.SetKey(name, nullptr);
+	return AddProperty(std::move(newNode));
 }
 
 Node &Node::AddProperty(const std::string &name, Node &&node) {
-	node.name = name;
-	return properties.emplace_back(std::move(node));
+	// Names are only held by the arena of nodes allocated from it, so a node can never reference a arena it is not re-homed from.
+	auto arena = GetArena();
+	node.SetKey(name, arena && node.GetArena() == arena ? arena : nullptr);
+	return AddProperty(std::move(node));
+}
+
+void Node::SetName(std::string_view name) {
+	// A root can replace the arena it owns, so it holds its name like heap nodes do.
+	SetKey(name, arena ? nullptr : GetArena());
 }
 
 Node &Node::AddProperty(uint32_t index, const Node &node) {
@@ -117,25 +196,39 @@ Node &Node::AddProperty(uint32_t index, Node &&node) {
 	return properties[index] = std::move(node);
 }
 
+template<typename Predicate>
+void Node::RemoveProperties(const Predicate &predicate) {
+	// Assigning a node keeps its name, so the kept properties are move constructed into a new list rather than shifted by erase.
+	NodeProperties kept(properties.get_allocator());
+	kept.reserve(properties.size());
+	for (auto &property : properties) {
+		if (!predicate(property))
+			kept.emplace_back(std::move(property));
+	}
+	properties = std::move(kept);
+	index.clear();
+	indexedCount = 0;
+}
+
 void Node::RemoveProperty(const std::string &name) {
 	//node.parent = nullptr;
-	properties.erase(std::remove_if(properties.begin(), properties.end(), [name](const auto &n) {
-		return n.name == name;
-	}), properties.end());
+	RemoveProperties([&](const auto &n) {
+		return *n.name == name;
+	});
 }
 
 void Node::RemoveProperty(const Node &node) {
 	//node.parent = nullptr;
-	properties.erase(std::remove_if(properties.begin(), properties.end(), [node](const auto &n) {
+	RemoveProperties([&](const auto &n) {
 		return n == node;
-	}), properties.end());
+	});
 }
 
 std::vector<NodeConstView> Node::GetProperties(const std::string &name) const {
 	std::vector<NodeConstView> properties;
 
 	for (const auto &property : this->properties) {
-		if (property.name == name)
+		if (*property.name == name)
 			properties.emplace_back(NodeConstView(this, name, &property));
 	}
 
@@ -157,7 +250,7 @@ NodeConstView Node::GetPropertyWithValue(const std::string &name, const std::str
 			return {this, name, nullptr};
 
 		for (auto &property1 : properties1) {
-			if (property1 && property1->GetValue() == value)
+			if (property1 && property1->GetValueView() == value)
 				return {this, name, &property};
 		}
 	}
@@ -170,7 +263,7 @@ std::vector<NodeView> Node::GetProperties(const std::string &name) {
 	std::vector<NodeView> properties;
 
 	for (auto &property : this->properties) {
-		if (property.name == name)
+		if (*property.name == name)
 			properties.emplace_back(NodeView(this, name, &property));
 	}
 
@@ -194,7 +287,7 @@ NodeView Node::GetPropertyWithValue(const std::string &name, const std::string &
 			return {this, name, nullptr};
 
 		for (auto &property1 : properties1) {
-			if (property1 && property1->GetValue() == value)
+			if (property1 && property1->GetValueView() == value)
 				return {this, name, &property};
 		}
 	}
@@ -223,16 +316,36 @@ NodeView Node::operator[](uint32_t index) {
 Node &Node::operator=(const Node &rhs) {
 	properties = rhs.properties;
 	//name = rhs.name;
-	value = rhs.value;
+	value = rhs.GetValueView();
+	valueView = {};
+	index = rhs.index;
+	indexedCount = rhs.indexedCount;
 	type = rhs.type;
 	return *this;
 }
 
 Node &Node::operator=(Node &&rhs) noexcept {
-	properties = std::move(rhs.properties);
+	if (auto rhsArena = rhs.GetArena(); !rhs.arena && rhsArena && rhsArena != GetArena()) {
+		// Like moving construction, nodes assigned from a document they do not share are re-homed onto the heap.
+		NodeProperties moved;
+		moved.reserve(rhs.properties.size());
+		for (auto &property : rhs.properties)
+			moved.emplace_back(std::move(property));
+		properties = std::move(moved);
+		value = rhs.GetValueView();
+		valueView = {};
+	} else {
+		properties = std::move(rhs.properties);
+		value = std::move(rhs.value);
+		valueView = rhs.valueView;
+	}
 	//name = std::move(rhs.name);
-	value = std::move(rhs.value);
+	index = std::move(rhs.index);
+	indexedCount = rhs.indexedCount;
 	type = std::move(rhs.type);
+	// The previous properties are already released, so the arena they were allocated from can be too.
+	if (rhs.arena)
+		arena = std::move(rhs.arena);
 	return *this;
 }
 
@@ -253,7 +366,7 @@ Node &Node::operator=(NodeView &&rhs) noexcept {
 }
 
 bool Node::operator==(const Node &rhs) const {
-	return value == rhs.value && properties.size() == rhs.properties.size() &&
+	return GetValueView() == rhs.GetValueView() && properties.size() == rhs.properties.size() &&
 		std::equal(properties.begin(), properties.end(), rhs.properties.begin(), [](const auto &left, const auto &right) {
 		return left == right;
 	});
@@ -264,12 +377,101 @@ bool Node::operator!=(const Node &rhs) const {
 }
 
 bool Node::operator<(const Node &rhs) const {
-	if (value < rhs.value) return true;
-	if (rhs.value < value) return false;
+	if (GetValueView() < rhs.GetValueView()) return true;
+	if (rhs.GetValueView() < GetValueView()) return false;
 
 	if (properties < rhs.properties) return true;
 	if (rhs.properties < properties) return false;
 
 	return false;
 }
+
+void Node::SetKey(std::string_view name, NodeArena *keys) {
+	// The new name is acquired first, so setting the same name never releases it.
+	auto key = keys ? keys->AddKey(name) : NodeKeys::Acquire(name);
+	if (ownsName)
+		NodeKeys::Release(this->name);
+	this->name = key;
+	ownsName = !keys;
+}
+
+uint32_t Node::FindProperty(std::string_view name) const {
+	// The index is only used while it matches the properties, const lookups never rebuild it so concurrent reads stay safe.
+	if (!index.empty() && indexedCount == properties.size()) {
+		// A name that was never interned can not be a property of any node.
+		auto key = NodeKeys::Find(name);
+		if (!key)
+			return NotFound;
+
+		auto mask = index.size() - 1;
+		for (auto slot = GetIndexSlot(key, mask); index[slot] != 0; slot = (slot + 1) & mask) {
+			if (properties[index[slot] - 1].name == key)
+				return index[slot] - 1;
+		}
+
+		return NotFound;
+	}
+
+	for (uint32_t i = 0; i < properties.size(); i++) {
+		if (*properties[i].name == name)
+			return i;
+	}
+
+	return NotFound;
+}
+
+uint32_t Node::FindProperty(std::string_view name) {
+	if (properties.size() >= IndexThreshold && (index.empty() || indexedCount != properties.size()))
+		Reindex();
+
+	return std::as_const(*this).FindProperty(name);
+}
+
+void Node::IndexLastProperty() {
+	if (properties.size() < IndexThreshold)
+		return;
+
+	// Keeps the table at most half full, anything else falls back to a full rebuild.
+	if (index.empty() || indexedCount + 1 != properties.size() || properties.size() * 2 > index.size()) {
+		Reindex();
+		return;
+	}
+
+	auto mask = index.size() - 1;
+	auto key = properties.back().name;
+	auto slot = GetIndexSlot(key, mask);
+	for (; index[slot] != 0; slot = (slot + 1) & mask) {
+		// Lookups return the first property with a name.
+		if (properties[index[slot] - 1].name == key) {
+			indexedCount++;
+			return;
+		}
+	}
+
+	index[slot] = static_cast<uint32_t>(properties.size());
+	indexedCount++;
+}
+
+void Node::Reindex() {
+	std::size_t capacity = 32;
+	while (capacity < properties.size() * 4)
+		capacity *= 2;
+
+	index.assign(capacity, 0);
+	indexedCount = 0;
+	auto mask = capacity - 1;
+
+	for (const auto &property : properties) {
+		indexedCount++;
+
+		auto slot = GetIndexSlot(property.name, mask);
+		for (; index[slot] != 0; slot = (slot + 1) & mask) {
+			if (properties[index[slot] - 1].name == property.name)
+				break;
+		}
+
+		if (index[slot] == 0)
+			index[slot] = indexedCount;
+	}
+}
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <ostream>
 
 #include "NodeView.hpp"
@@ -7,11 +8,13 @@
 namespace acid {
 /**
  * @brief Class that is used to represent a tree of UFT-8 values, used in serialization.
+ * Parsed trees allocate their property lists from a {@link NodeArena} owned by the document root, names are interned with {@link NodeKeys},
+ * and values reference the parsed source until they are set again. Nodes copied or moved out of a document are re-homed onto the heap.
  */
 class ACID_EXPORT Node final {
 public:
 	enum class Type : uint8_t {
-		Object, Array, String, Boolean, Integer, Decimal, Null, Token, Unknown
+		Object, Array, String, Boolean, Integer, Decimal, Null, Blob, Token, Unknown
 	};
 
 	/**
@@ -89,14 +92,52 @@ public:
 		std::string_view view;
 	};
 
+	/// Objects with at least this many properties keep a hash index of their property names.
+	static constexpr std::size_t IndexThreshold = 16;
+	/// Documents nested deeper than this are rejected by the parsers, which recurse once for each level.
+	static constexpr uint32_t MaxDepth = 512;
+
 	Node();
 	explicit Node(const std::string &name);
 	Node(const std::string &name, const Node &node);
-	Node(const Node &node) = default;
-	Node(Node &&node) = default;
+	/**
+	 * Creates a node that allocates its properties with a allocator, usually one sharing a documents arena.
+	 * @param allocator The property allocator.
+	 */
+	explicit Node(const NodeAllocator<Node> &allocator);
+	/**
+	 * Creates a document root that owns the arena its properties are allocated from.
+	 * @param arena The arena.
+	 */
+	explicit Node(std::unique_ptr<NodeArena> &&arena);
+	Node(const Node &node);
+	/**
+	 * Moves a node, a node moved out of a parsed document it does not own is re-homed onto the heap so it can outlive the document.
+	 * @param node The node to move.
+	 */
+	Node(Node &&node) noexcept;
+	/**
+	 * Moves a node into memory allocated from a arena, used by {@link NodeAllocator} so lists growing inside a document keep referencing it.
+	 * @param node The node to move.
+	 * @param destination The arena the node is constructed in, or nullptr if on the heap.
+	 */
+	Node(Node &&node, NodeArena *destination) noexcept;
+	~Node();
 
+	/**
+	 * Replaces this node with a tree parsed from a string, the string is copied into the arena owning the new tree.
+	 * @tparam NodeParser The parser type.
+	 * @param string The string to parse.
+	 */
 	template<typename NodeParser>
 	void ParseString(std::string_view string);
+	/**
+	 * Replaces this node with a tree parsed from a mapped file, the arena owning the new tree keeps the mapping alive instead of copying it.
+	 * @tparam NodeParser The parser type.
+	 * @param file The file to parse.
+	 */
+	template<typename NodeParser>
+	void ParseFile(std::shared_ptr<const MappedFile> file);
 	template<typename NodeParser>
 	void WriteStream(std::ostream &stream, Format format = Format::Minified) const;
 
@@ -177,23 +218,107 @@ public:
 	bool operator!=(const Node &rhs) const;
 	bool operator<(const Node &rhs) const;
 
-	const std::vector<Node> &GetProperties() const { return properties; }
-	std::vector<Node> &GetProperties() { return properties; }
+	/**
+	 * Gets the properties, parsed documents allocate them from the arena owned by the root so references are only valid while the root is.
+	 * @return The properties.
+	 */
+	const NodeProperties &GetProperties() const { return properties; }
+	/**
+	 * Gets the properties for modification. Properties added or removed through the list are indexed again on the next lookup,
+	 * properties renamed through it are not.
+	 * @return The properties.
+	 */
+	NodeProperties &GetProperties() { return properties; }
 
-	const std::string &GetName() const { return name; }
-	void SetName(std::string name) { this->name = std::move(name); }
+	/**
+	 * Gets the name, names of nodes in a parsed document are held by its arena and released with the root,
+	 * names of nodes on the heap are released with the node.
+	 * @return The name.
+	 */
+	const std::string &GetName() const { return *name; }
+	void SetName(const std::string &name) { SetName(std::string_view(name)); }
+	void SetName(std::string_view name);
 
-	const std::string &GetValue() const { return value; }
-	void SetValue(std::string value) { this->value = std::move(value); }
+	/**
+	 * Gets a copy of the value, use {@link Node#GetValueView} to read it without copying.
+	 * @return The value.
+	 */
+	std::string GetValue() const { return std::string(GetValueView()); }
+	/**
+	 * Gets a view of the value without copying it, parsed documents view their source until the value is set again.
+	 * The view is invalidated by setting the value or destroying the document root.
+	 * @return The value.
+	 */
+	std::string_view GetValueView() const { return valueView.data() ? valueView : std::string_view(value); }
+	void SetValue(std::string value) {
+		this->value = std::move(value);
+		valueView = {};
+	}
+
+	/**
+	 * Sets the value to a view of memory that outlives the node, parsers use this for values in a source owned by the nodes arena.
+	 * @param value The value to reference.
+	 */
+	void SetValueView(std::string_view value) {
+		this->value.clear();
+		valueView = value;
+	}
+
+	/**
+	 * Sets the value to raw bytes, binary parsers store these as is and text parsers write them as base64.
+	 * @param bytes The bytes.
+	 */
+	void SetBlob(std::string_view bytes);
+	template<typename T>
+	void SetBlob(const std::vector<T> &data);
+
+	/**
+	 * Gets the value as raw bytes, decoding the base64 written by text parsers when the node is a string.
+	 * @tparam T The trivially copyable element type.
+	 * @param data The elements to fill.
+	 * @return If the value was a blob of whole elements.
+	 */
+	template<typename T>
+	bool GetBlob(std::vector<T> &data) const;
 
 	const Type &GetType() const { return type; }
 	void SetType(Type type) { this->type = type; }
 
+	/**
+	 * Gets the arena the properties of this node are allocated from.
+	 * @return The arena, or nullptr if allocated on the heap.
+	 */
+	NodeArena *GetArena() const { return properties.get_allocator().GetArena(); }
+
 protected:
-	std::vector<Node> properties; // members
-	std::string name; // key
+	static constexpr uint32_t NotFound = std::numeric_limits<uint32_t>::max();
+
+	/**
+	 * Replaces the interned name, held by a arena if one is given or by this node otherwise.
+	 * @param name The name.
+	 * @param keys The arena to hold the name, or nullptr.
+	 */
+	void SetKey(std::string_view name, NodeArena *keys);
+	uint32_t FindProperty(std::string_view name) const;
+	uint32_t FindProperty(std::string_view name);
+	template<typename Predicate>
+	void RemoveProperties(const Predicate &predicate);
+	void IndexLastProperty();
+	void Reindex();
+
+	/// Only set on the root of a parsed document, declared first so it is released after the properties.
+	std::unique_ptr<NodeArena> arena;
+	NodeProperties properties; // members
+	const std::string *name; // key
 	std::string value;
+	/// Set instead of value when the value references memory that outlives the node, such as the source of a parsed document.
+	std::string_view valueView;
+	/// Open addressing table of property indices plus one, only built for objects with many properties.
+	std::vector<uint32_t> index;
+	uint32_t indexedCount = 0;
 	Type type;
+	/// If this node holds a reference to its name, which is released when it is destroyed.
+	bool ownsName = false;
 };
 }
 
@@ -20,7 +20,19 @@
 namespace acid {
 template<typename NodeParser>
 void Node::ParseString(std::string_view string) {
-	NodeParser::ParseString(*this, string);
+	// Parsed values reference the source, so it is kept in the arena that owns the new tree.
+	auto arena = std::make_unique<NodeArena>();
+	auto source = arena->AddString(string);
+	*this = Node(std::move(arena));
+	NodeParser::ParseString(*this, source);
+}
+
+template<typename NodeParser>
+void Node::ParseFile(std::shared_ptr<const MappedFile> file) {
+	auto arena = std::make_unique<NodeArena>();
+	auto source = arena->AddSource(std::move(file));
+	*this = Node(std::move(arena));
+	NodeParser::ParseString(*this, source);
 }
 
 template<typename NodeParser>
@@ -54,13 +66,39 @@ std::basic_string<_Elem> Node::WriteString(Format format) const {
 template<typename T>
 T Node::GetName() const {
 	// String to basic type conversion.
-	return String::From<T>(name);
+	return String::From<T>(*name);
 }
 
 template<typename T>
 void Node::SetName(const T &value) {
 	// Basic type to string conversion.
-	name = String::To(value);
+	SetName(String::To(value));
+}
+
+template<typename T>
+void Node::SetBlob(const std::vector<T> &data) {
+	static_assert(std::is_trivially_copyable_v<T>, "Blob elements must be trivially copyable");
+	SetBlob(std::string_view(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(T)));
+}
+
+template<typename T>
+bool Node::GetBlob(std::vector<T> &data) const {
+	static_assert(std::is_trivially_copyable_v<T>, "Blob elements must be trivially copyable");
+	std::optional<std::string> decoded;
+	auto bytes = GetValueView();
+	if (type == Type::String) {
+		if (!(decoded = String::DecodeBase64(bytes)))
+			return false;
+		bytes = *decoded;
+	} else if (type != Type::Blob) {
+		return false;
+	}
+
+	if (bytes.size() % sizeof(T) != 0)
+		return false;
+	data.resize(bytes.size() / sizeof(T));
+	std::memcpy(data.data(), bytes.data(), bytes.size());
+	return true;
 }
 
 template<typename T>
@@ -190,7 +228,7 @@ Node &operator<<(Node &node, const std::shared_ptr<T> &object) {
 }
 
 inline const Node &operator>>(const Node &node, bool &object) {
-	object = String::From<bool>(node.GetValue());
+	object = String::From<bool>(node.GetValueView());
 	return node;
 }
 
@@ -202,7 +240,7 @@ inline Node &operator<<(Node &node, bool object) {
 
 template<typename T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>, int> = 0>
 const Node &operator>>(const Node &node, T &object) {
-	object = String::From<T>(node.GetValue());
+	object = String::From<T>(node.GetValueView());
 	return node;
 }
 
@@ -214,7 +252,9 @@ Node &operator<<(Node &node, T object) {
 }
 
 inline const Node &operator>>(const Node &node, char *&string) {
-	std::strcpy(string, node.GetValue().c_str());
+	auto value = node.GetValueView();
+	std::memcpy(string, value.data(), value.size());
+	string[value.size()] = '\0';
 	return node;
 }
 
@@ -233,7 +273,7 @@ inline Node &operator<<(Node &node, std::string_view string) {
 }
 
 inline const Node &operator>>(const Node &node, std::string &string) {
-	string = node.GetValue();
+	string = node.GetValueView();
 	return node;
 }
 
@@ -244,7 +284,7 @@ inline Node &operator<<(Node &node, const std::string &string) {
 }
 
 inline const Node &operator>>(const Node &node, std::filesystem::path &object) {
-	object = node.GetValue();
+	object = node.GetValueView();
 	return node;
 }
 
@@ -272,7 +312,7 @@ Node &operator<<(Node &node, const std::pair<T, K> &pair) {
 
 template<typename T>
 const Node &operator>>(const Node &node, std::optional<T> &optional) {
-	if (node.GetValue() != "null") {
+	if (node.GetValueView() != "null") {
 		T x;
 		node >> x;
 		optional = std::move(x);
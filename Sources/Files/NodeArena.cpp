@@ -0,0 +1,213 @@
+#include "NodeArena.hpp"
+
+#include <array>
+#include <cstring>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace acid {
+/**
+ * Blocks of the default size released by arenas, reused by the next document so its memory does not need to be faulted in again.
+ */
+class NodeBlockPool {
+public:
+	static constexpr std::size_t MaxBlocks = 1024;
+
+	static NodeBlockPool &Get() {
+		static NodeBlockPool pool;
+		return pool;
+	}
+
+	std::unique_ptr<std::byte[]> Acquire() {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (!blocks.empty()) {
+				auto block = std::move(blocks.back());
+				blocks.pop_back();
+				return block;
+			}
+		}
+
+		return std::make_unique<std::byte[]>(NodeArena::DefaultBlockSize);
+	}
+
+	void Release(std::vector<std::unique_ptr<std::byte[]>> &released) {
+		std::unique_lock<std::mutex> lock(mutex);
+		for (auto &block : released) {
+			if (blocks.size() >= MaxBlocks)
+				break;
+			blocks.emplace_back(std::move(block));
+		}
+	}
+
+private:
+	std::mutex mutex;
+	std::vector<std::unique_ptr<std::byte[]>> blocks;
+};
+
+NodeArena::NodeArena(std::size_t blockSize) :
+	blockSize(blockSize) {
+}
+
+NodeArena::~NodeArena() {
+	for (auto &[name, key] : keys)
+		NodeKeys::Release(key);
+	if (blockSize == DefaultBlockSize)
+		NodeBlockPool::Get().Release(blocks);
+}
+
+void *NodeArena::Allocate(std::size_t size, std::size_t alignment) {
+	std::unique_lock<std::mutex> lock(mutex);
+	allocated += size;
+
+	auto aligned = reinterpret_cast<std::byte *>((reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~(alignment - 1));
+	if (current && aligned + size <= end) {
+		current = aligned + size;
+		return aligned;
+	}
+
+	// Large allocations get a block of their own so the current block is not wasted.
+	if (size + alignment > blockSize / 4) {
+		auto &block = largeBlocks.emplace_back(std::make_unique<std::byte[]>(size + alignment));
+		return reinterpret_cast<std::byte *>((reinterpret_cast<uintptr_t>(block.get()) + alignment - 1) & ~(alignment - 1));
+	}
+
+	auto &block = blocks.emplace_back(blockSize == DefaultBlockSize ? NodeBlockPool::Get().Acquire() : std::make_unique<std::byte[]>(blockSize));
+	aligned = reinterpret_cast<std::byte *>((reinterpret_cast<uintptr_t>(block.get()) + alignment - 1) & ~(alignment - 1));
+	current = aligned + size;
+	end = block.get() + blockSize;
+	return aligned;
+}
+
+std::string_view NodeArena::AddString(std::string_view string) {
+	if (string.empty())
+		return {};
+
+	auto data = static_cast<char *>(Allocate(string.size(), 1));
+	std::memcpy(data, string.data(), string.size());
+	return {data, string.size()};
+}
+
+const std::string *NodeArena::AddKey(std::string_view name) {
+	std::unique_lock<std::mutex> lock(mutex);
+	if (auto it = keys.find(name); it != keys.end())
+		return it->second;
+
+	// The arena holds one reference to each name its nodes use, released when the document is destroyed.
+	auto key = NodeKeys::Acquire(name);
+	keys.emplace(std::string_view(*key), key);
+	return key;
+}
+
+std::string_view NodeArena::AddSource(std::shared_ptr<const MappedFile> file) {
+	std::unique_lock<std::mutex> lock(mutex);
+	auto &source = sources.emplace_back(std::move(file));
+	return {reinterpret_cast<const char *>(source->GetData()), source->GetSize()};
+}
+
+/**
+ * The interned names, split into shards so parsers on different threads rarely wait on each other.
+ */
+class NodeKeyTable {
+public:
+	static constexpr std::size_t ShardCount = 16;
+
+	class Entry {
+	public:
+		std::unique_ptr<std::string> name;
+		/// The number of arenas and heap nodes holding the name.
+		uint32_t references = 0;
+		/// If the name was interned with Intern, which keeps it for the lifetime of the program.
+		bool pinned = false;
+	};
+
+	class Shard {
+	public:
+		std::shared_mutex mutex;
+		// Keys view the owned strings, which never move once added.
+		std::unordered_map<std::string_view, Entry> names;
+	};
+
+	static NodeKeyTable &Get() {
+		static NodeKeyTable table;
+		return table;
+	}
+
+	Shard &GetShard(std::string_view name) {
+		return shards[std::hash<std::string_view>()(name) % ShardCount];
+	}
+
+	Shard shards[ShardCount];
+};
+
+static NodeKeyTable::Entry &AddEntry(NodeKeyTable::Shard &shard, std::string_view name) {
+	if (auto it = shard.names.find(name); it != shard.names.end())
+		return it->second;
+
+	auto interned = std::make_unique<std::string>(name);
+	std::string_view key(*interned);
+	return shard.names.emplace(key, NodeKeyTable::Entry{std::move(interned)}).first->second;
+}
+
+const std::string *NodeKeys::Intern(std::string_view name) {
+	// Names repeat heavily while parsing, a small per thread cache avoids locking the shared table for most of them.
+	thread_local std::array<const std::string *, 256> cache = {};
+	uint32_t hash = 0x811c9dc5;
+	for (auto c : name)
+		hash = (hash ^ static_cast<uint8_t>(c)) * 0x1000193;
+	auto &cached = cache[hash & (cache.size() - 1)];
+	if (cached && *cached == name)
+		return cached;
+
+	// Only pinned names are cached, as they are never released.
+	auto &shard = NodeKeyTable::Get().GetShard(name);
+	{
+		std::shared_lock<std::shared_mutex> lock(shard.mutex);
+		if (auto it = shard.names.find(name); it != shard.names.end() && it->second.pinned)
+			return cached = it->second.name.get();
+	}
+
+	std::unique_lock<std::shared_mutex> lock(shard.mutex);
+	auto &entry = AddEntry(shard, name);
+	entry.pinned = true;
+	return cached = entry.name.get();
+}
+
+const std::string *NodeKeys::Find(std::string_view name) {
+	auto &shard = NodeKeyTable::Get().GetShard(name);
+	std::shared_lock<std::shared_mutex> lock(shard.mutex);
+	if (auto it = shard.names.find(name); it != shard.names.end())
+		return it->second.name.get();
+	return nullptr;
+}
+
+std::size_t NodeKeys::GetCount() {
+	std::size_t count = 0;
+	for (auto &shard : NodeKeyTable::Get().shards) {
+		std::shared_lock<std::shared_mutex> lock(shard.mutex);
+		count += shard.names.size();
+	}
+	return count;
+}
+
+const std::string *NodeKeys::Acquire(std::string_view name) {
+	auto &shard = NodeKeyTable::Get().GetShard(name);
+	std::unique_lock<std::shared_mutex> lock(shard.mutex);
+	auto &entry = AddEntry(shard, name);
+	entry.references++;
+	return entry.name.get();
+}
+
+void NodeKeys::Release(const std::string *name) {
+	auto &shard = NodeKeyTable::Get().GetShard(*name);
+	std::unique_lock<std::shared_mutex> lock(shard.mutex);
+	auto it = shard.names.find(*name);
+	if (--it->second.references == 0 && !it->second.pinned)
+		shard.names.erase(it);
+}
+
+const std::string *NodeKeys::Empty() {
+	static const std::string *empty = Intern({});
+	return empty;
+}
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Files/MappedFile.hpp"
+#include "Utils/NonCopyable.hpp"
+
+namespace acid {
+class Node;
+
+/**
+ * @brief Class that owns the memory of a parsed {@link Node} document.
+ * Property lists are bump allocated from large blocks that are only released with the arena,
+ * and the parsed source is kept alive so node values can reference it without copying.
+ */
+class ACID_EXPORT NodeArena : NonCopyable {
+public:
+	static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+	/**
+	 * Creates a new node arena.
+	 * @param blockSize The size of each memory block, larger allocations get a block of their own.
+	 */
+	explicit NodeArena(std::size_t blockSize = DefaultBlockSize);
+	~NodeArena();
+
+	/**
+	 * Allocates memory that stays valid until the arena is destroyed.
+	 * @param size The number of bytes.
+	 * @param alignment The alignment of the memory.
+	 * @return The memory.
+	 */
+	void *Allocate(std::size_t size, std::size_t alignment);
+
+	/**
+	 * Copies a string into the arena.
+	 * @param string The string to copy.
+	 * @return A view of the copy.
+	 */
+	std::string_view AddString(std::string_view string);
+
+	/**
+	 * Keeps a mapped file alive for as long as the arena.
+	 * @param file The file to hold, which may be shared with other readers.
+	 * @return A view of the file contents.
+	 */
+	std::string_view AddSource(std::shared_ptr<const MappedFile> file);
+
+	/**
+	 * Gets the interned copy of a name used by nodes of the arena, the name is released when the arena is destroyed.
+	 * @param name The name.
+	 * @return The interned name, valid for the lifetime of the arena.
+	 */
+	const std::string *AddKey(std::string_view name);
+
+	/**
+	 * Gets the number of bytes allocated from the arena, including copied strings.
+	 * @return The allocated bytes.
+	 */
+	std::size_t GetAllocated() const { return allocated; }
+
+private:
+	std::size_t blockSize;
+	std::mutex mutex;
+	std::vector<std::unique_ptr<std::byte[]>> blocks;
+	std::vector<std::unique_ptr<std::byte[]>> largeBlocks;
+	std::byte *current = nullptr;
+	std::byte *end = nullptr;
+	std::size_t allocated = 0;
+	std::vector<std::shared_ptr<const MappedFile>> sources;
+	std::unordered_map<std::string_view, const std::string *> keys;
+};
+
+/**
+ * @brief Allocator used by {@link Node} property lists, allocating from a {@link NodeArena} or the heap when there is none.
+ * The arena is owned by the root node of a document. Nodes constructed in arena memory keep referencing it,
+ * nodes moved or copied anywhere else are re-homed onto the heap so they can outlive the document.
+ * @tparam T The allocated type.
+ */
+template<typename T>
+class NodeAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using is_always_equal = std::false_type;
+
+	NodeAllocator() = default;
+	explicit NodeAllocator(NodeArena *arena) :
+		arena(arena) {
+	}
+	template<typename K>
+	NodeAllocator(const NodeAllocator<K> &other) :
+		arena(other.GetArena()) {
+	}
+
+	T *allocate(std::size_t n) {
+		if (arena)
+			return static_cast<T *>(arena->Allocate(n * sizeof(T), alignof(T)));
+		return static_cast<T *>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T *p, std::size_t) noexcept {
+		// Arena memory is released all at once with the arena.
+		if (!arena)
+			::operator delete(p);
+	}
+
+	template<typename U, typename ...Args>
+	void construct(U *p, Args &&...args) {
+		// Nodes moved into a list tell the move where they are, so moves within a document do not re-home them.
+		if constexpr (std::is_same_v<U, Node> && sizeof...(Args) == 1 && (std::is_same_v<Args, Node> && ...))
+			::new(static_cast<void *>(p)) U(std::forward<Args>(args)..., arena);
+		else
+			::new(static_cast<void *>(p)) U(std::forward<Args>(args)...);
+	}
+
+	NodeAllocator select_on_container_copy_construction() const { return {}; }
+
+	NodeArena *GetArena() const { return arena; }
+
+	template<typename K>
+	bool operator==(const NodeAllocator<K> &other) const { return arena == other.GetArena(); }
+	template<typename K>
+	bool operator!=(const NodeAllocator<K> &other) const { return arena != other.GetArena(); }
+
+private:
+	NodeArena *arena = nullptr;
+};
+
+/**
+ * @brief Allocator for lists that hold nodes of a document until they are moved into it, like the property stacks of parsers.
+ * Memory is allocated on the heap so growing lists leave nothing behind in the arena, but nodes moved in keep referencing the arena.
+ * @tparam T The allocated type.
+ */
+template<typename T>
+class NodeScratchAllocator {
+public:
+	using value_type = T;
+
+	NodeScratchAllocator() = default;
+	explicit NodeScratchAllocator(NodeArena *arena) :
+		arena(arena) {
+	}
+	template<typename K>
+	NodeScratchAllocator(const NodeScratchAllocator<K> &other) :
+		arena(other.GetArena()) {
+	}
+
+	T *allocate(std::size_t n) { return static_cast<T *>(::operator new(n * sizeof(T))); }
+	void deallocate(T *p, std::size_t) noexcept { ::operator delete(p); }
+
+	template<typename U, typename ...Args>
+	void construct(U *p, Args &&...args) { NodeAllocator<U>(arena).construct(p, std::forward<Args>(args)...); }
+
+	NodeArena *GetArena() const { return arena; }
+
+	template<typename K>
+	bool operator==(const NodeScratchAllocator<K> &) const { return true; }
+	template<typename K>
+	bool operator!=(const NodeScratchAllocator<K> &) const { return false; }
+
+private:
+	NodeArena *arena = nullptr;
+};
+
+/**
+ * @brief Class that interns the property names of every {@link Node}, so each distinct name is only stored once.
+ * Names used by parsed documents are held by their {@link NodeArena} and released with the last document using them,
+ * nodes on the heap hold a reference to their own name and release it when destroyed.
+ */
+class ACID_EXPORT NodeKeys {
+public:
+	NodeKeys() = delete;
+
+	/**
+	 * Gets the pinned copy of a name, adding it if it has not been seen before.
+	 * Only used for names that are fixed for the program, like those of reflected types.
+	 * @param name The name.
+	 * @return The interned name, valid for the lifetime of the program.
+	 */
+	static const std::string *Intern(std::string_view name);
+
+	/**
+	 * Gets the interned copy of a name and adds a reference to it.
+	 * @param name The name.
+	 * @return The interned name, valid until the reference is released.
+	 */
+	static const std::string *Acquire(std::string_view name);
+
+	/**
+	 * Removes a reference added by {@link NodeKeys#Acquire}, the name is erased once no references remain unless it is pinned.
+	 * @param name The interned name.
+	 */
+	static void Release(const std::string *name);
+
+	/**
+	 * Finds the interned copy of a name without adding it.
+	 * @param name The name.
+	 * @return The interned name, or nullptr if no live node uses it.
+	 */
+	static const std::string *Find(std::string_view name);
+
+	/**
+	 * Gets the number of interned names, pinned or held by an arena.
+	 * @return The number of names.
+	 */
+	static std::size_t GetCount();
+
+	/**
+	 * Gets the interned empty name, used by unnamed nodes.
+	 * @return The empty name.
+	 */
+	static const std::string *Empty();
+};
+}
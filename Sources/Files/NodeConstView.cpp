@@ -5,8 +5,10 @@
 namespace acid {
 NodeConstView::NodeConstView(const Node *parent, Key key, const Node *value) :
 	parent(parent),
-	value(value),
-	keys{std::move(key)} {
+	value(value) {
+	// Keys are only needed to build the missing tree when a mutable view is written to.
+	if (!value)
+		keys.emplace_back(std::move(key));
 }
 
 NodeConstView::NodeConstView(const NodeConstView *parent, Key key) :
@@ -48,7 +50,8 @@ NodeConstView NodeConstView::operator[](uint32_t index) const {
 std::vector<Node> NodeConstView::GetProperties() const {
 	if (!has_value())
 		return {};
-	return value->GetProperties();
+	// Copied to the heap, so the list can outlive the document.
+	return {value->GetProperties().begin(), value->GetProperties().end()};
 }
 
 std::string NodeConstView::GetName() const {
@@ -5,11 +5,13 @@
 #include <string>
 #include <vector>
 
-#include "Export.hpp"
+#include "NodeArena.hpp"
 
 namespace acid {
 class Node;
 
+using NodeProperties = std::vector<Node, NodeAllocator<Node>>;
+
 /**
  * @brief Class that is returned from a {@link Node} when getting constant properties. This represents a key tree from a parent,
  * this allows reads of large trees with broken nodes to not need to generate new content.
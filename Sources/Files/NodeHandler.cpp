@@ -0,0 +1,50 @@
+#include "NodeHandler.hpp"
+
+#include <algorithm>
+
+namespace acid {
+void NodeHandler::Visit(const Node &node) {
+	Visit(node, node.GetName());
+}
+
+void NodeHandler::Visit(const Node &node, std::string_view name) {
+	auto &properties = node.GetProperties();
+
+	auto isContainer = node.GetType() == Node::Type::Object || node.GetType() == Node::Type::Array;
+	if (properties.empty() && (!isContainer || !node.GetValueView().empty())) {
+		// Containers that only hold a value are sent as strings.
+		Value(name, isContainer ? Node::Type::String : node.GetType(), node.GetValueView());
+		return;
+	}
+
+	// If any property has no name, then this must be an array.
+	auto isArray = properties.empty() ? node.GetType() == Node::Type::Array :
+		std::any_of(properties.begin(), properties.end(), [](const Node &property) { return property.GetName().empty(); });
+	if (!(isArray ? BeginArray(name) : BeginObject(name)))
+		return;
+
+	// Properties the handler needs first, such as Xml attributes that are written into the start tag, keep their order among themselves.
+	if (!isArray) {
+		for (const auto &property : properties) {
+			if (IsLeading(property.GetName()))
+				Visit(property, property.GetName());
+		}
+	}
+
+	// Only Xml allows a node to have both a value and properties, the value is kept as a text property.
+	if (!node.GetValueView().empty())
+		Value("#text", Node::Type::String, node.GetValueView());
+
+	for (const auto &property : properties) {
+		if (isArray)
+			Visit(property, {});
+		else if (!IsLeading(property.GetName()))
+			Visit(property, property.GetName());
+	}
+
+	if (isArray)
+		EndArray();
+	else
+		EndObject();
+}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Files/Node.hpp"
+
+namespace acid {
+/**
+ * @brief Interface that receives a document as a stream of events, so it can be consumed without building a {@link Node} tree.
+ * Names and values are only valid during the call they are passed to.
+ */
+class ACID_EXPORT NodeHandler {
+public:
+	virtual ~NodeHandler() = default;
+
+	/**
+	 * Called when a object starts, followed by its properties and {@link NodeHandler#EndObject}.
+	 * @param name The name of the object, empty in arrays and for the root.
+	 * @return If the properties should be read, when false the object is skipped and EndObject is not called.
+	 */
+	virtual bool BeginObject(std::string_view name) { return true; }
+	virtual void EndObject() {}
+
+	/**
+	 * Called when a array starts, followed by its unnamed elements and {@link NodeHandler#EndArray}.
+	 * @param name The name of the array, empty in arrays and for the root.
+	 * @return If the elements should be read, when false the array is skipped and EndArray is not called.
+	 */
+	virtual bool BeginArray(std::string_view name) { return true; }
+	virtual void EndArray() {}
+
+	/**
+	 * Called for every value that is not a object or array.
+	 * @param name The name of the value, empty in arrays.
+	 * @param type The type of the value.
+	 * @param value The value as written, raw bytes for blobs.
+	 */
+	virtual void Value(std::string_view name, Node::Type type, std::string_view value) {}
+
+	/**
+	 * Sends a node and its properties as events, the same way parsers read them.
+	 * Nodes with properties that are not all named are arrays, and values of nodes with properties are sent as "#text".
+	 * @param node The node to visit.
+	 */
+	void Visit(const Node &node);
+
+protected:
+	/**
+	 * Gets if a property is sent by {@link NodeHandler#Visit} before the value and the other properties of its node.
+	 * @param name The name of the property.
+	 * @return If the property is sent first.
+	 */
+	virtual bool IsLeading(std::string_view name) const { return false; }
+
+private:
+	void Visit(const Node &node, std::string_view name);
+};
+}
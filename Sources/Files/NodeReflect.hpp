@@ -0,0 +1,337 @@
+#pragma once
+
+#include <array>
+#include <tuple>
+
+#include "NodeHandler.hpp"
+
+namespace acid {
+/**
+ * @brief Class that names a member of a reflected class, the hash of the name is found when the field list is compiled.
+ * @tparam Class The class declaring the member.
+ * @tparam T The member type.
+ */
+template<typename Class, typename T>
+class NodeField {
+public:
+	using Type = T;
+
+	constexpr NodeField(std::string_view name, T Class::*member) :
+		name(name),
+		hash(String::fnv1a_32(name)),
+		member(member) {
+	}
+
+	std::string_view name;
+	uint32_t hash;
+	T Class::*member;
+};
+
+template<typename T, typename = void>
+struct is_reflected : std::false_type {
+};
+
+template<typename T>
+struct is_reflected<T, std::void_t<decltype(T::GetFields())>> : std::true_type {
+};
+
+template<typename T>
+inline constexpr bool is_reflected_v = is_reflected<T>::value;
+
+/**
+ * @brief Class that serializes a class from the fields it declares once, instead of hand written node operators.
+ * A reflected class has a public static constexpr GetFields function returning a tuple of {@link NodeField}, in the order they are written:
+ * <pre>
+ * static constexpr auto GetFields() {
+ *     return std::make_tuple(NodeField("colour", &Light::colour), NodeField("radius", &Light::radius));
+ * }
+ * </pre>
+ * Documents are read with the next field in order checked first, so documents written by the same fields match every name on the first compare.
+ * Reading from events converts numbers, booleans, enums and strings straight into their fields without building a {@link Node}.
+ * @tparam T The reflected class.
+ */
+template<typename T>
+class NodeReflect {
+public:
+	static constexpr auto Fields = T::GetFields();
+	static constexpr std::size_t FieldCount = std::tuple_size_v<std::remove_const_t<decltype(Fields)>>;
+
+	/**
+	 * @brief Class that reads a object of the reflected class from events, so a document can be read into a object without building a node tree.
+	 */
+	class Reader : public NodeHandler {
+	public:
+		explicit Reader(T &object) :
+			object(object) {
+		}
+
+		bool BeginObject(std::string_view name) override { return Begin(name, Node::Type::Object); }
+		void EndObject() override { End(); }
+		bool BeginArray(std::string_view name) override { return Begin(name, Node::Type::Array); }
+		void EndArray() override { End(); }
+		void Value(std::string_view name, Node::Type type, std::string_view value) override;
+
+	private:
+		bool Begin(std::string_view name, Node::Type type);
+		void End();
+
+		T &object;
+		/// Containers entered, the reflected object is the first.
+		std::size_t depth = 0;
+		std::size_t next = 0;
+		/// The field being built into a node, for fields that are not plain values.
+		std::size_t building = FieldCount;
+		Node tree;
+		std::vector<Node *> stack;
+	};
+
+	/**
+	 * Reads the fields of a object from a node, properties that do not name a field are ignored.
+	 * @param node The node to read from.
+	 * @param object The object to read into.
+	 */
+	static void Read(const Node &node, T &object);
+
+	/**
+	 * Writes the fields of a object into a node, replacing properties that already have the name of a field.
+	 * @param node The node to write to.
+	 * @param object The object to write.
+	 */
+	static void Write(Node &node, const T &object);
+
+	/**
+	 * Writes the fields of a object as events, such as into a {@link NodeWriter}.
+	 * @param handler The handler to send the events to.
+	 * @param name The name of the object.
+	 * @param object The object to write.
+	 */
+	static void Write(NodeHandler &handler, std::string_view name, const T &object);
+
+private:
+	template<typename U>
+	static constexpr bool IsValue = std::is_arithmetic_v<U> || std::is_enum_v<U> || std::is_same_v<U, std::string> || std::is_same_v<U, std::filesystem::path>;
+
+	static constexpr auto Names = std::apply([](const auto &... fields) {
+		return std::array<std::string_view, sizeof...(fields)>{fields.name...};
+	}, Fields);
+	static constexpr auto Hashes = std::apply([](const auto &... fields) {
+		return std::array<uint32_t, sizeof...(fields)>{fields.hash...};
+	}, Fields);
+
+	/**
+	 * Gets the interned names of the fields, properties of parsed nodes are matched to them by pointer.
+	 * @return The interned names.
+	 */
+	static const std::array<const std::string *, FieldCount> &GetKeys();
+
+	static std::size_t FindField(const std::string *key, std::size_t next);
+	static std::size_t FindField(std::string_view name, std::size_t next);
+
+	template<typename F>
+	static void VisitField(std::size_t i, F &&f) {
+		VisitField(i, std::forward<F>(f), std::make_index_sequence<FieldCount>());
+	}
+
+	template<typename F, std::size_t... Is>
+	static void VisitField(std::size_t i, F &&f, std::index_sequence<Is...>) {
+		((i == Is && (f(std::get<Is>(Fields)), true)) || ...);
+	}
+
+	template<typename U>
+	static void WriteValue(NodeHandler &handler, std::string_view name, const U &value);
+};
+
+template<typename T>
+void NodeReflect<T>::Reader::Value(std::string_view name, Node::Type type, std::string_view value) {
+	if (!stack.empty()) {
+		auto &property = stack.back()->AddProperty(std::string(name));
+		property.SetValue(std::string(value));
+		property.SetType(type);
+		return;
+	}
+
+	if (depth != 1)
+		return;
+
+	auto i = FindField(name, next);
+	if (i == FieldCount)
+		return;
+	next = i + 1;
+
+	VisitField(i, [&](const auto &field) {
+		using U = typename std::decay_t<decltype(field)>::Type;
+
+		if constexpr (IsValue<U>) {
+			// Empty values are not valid, so they leave the field unchanged the same way Node::Get does.
+			if (value.empty())
+				return;
+
+			if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::filesystem::path>)
+				object.*field.member = U(value);
+			else
+				object.*field.member = String::From<U>(value);
+		} else {
+			Node property;
+			property.SetValue(std::string(value));
+			property.SetType(type);
+			if (property.IsValid())
+				property >> object.*field.member;
+		}
+	});
+}
+
+template<typename T>
+bool NodeReflect<T>::Reader::Begin(std::string_view name, Node::Type type) {
+	if (!stack.empty()) {
+		auto &property = stack.back()->AddProperty(std::string(name));
+		property.SetType(type);
+		stack.emplace_back(&property);
+		return true;
+	}
+
+	if (depth == 0) {
+		if (type != Node::Type::Object)
+			return false;
+		depth++;
+		return true;
+	}
+
+	building = FindField(name, next);
+	if (building == FieldCount)
+		return false;
+	next = building + 1;
+
+	tree = Node();
+	tree.SetType(type);
+	stack.emplace_back(&tree);
+	return true;
+}
+
+template<typename T>
+void NodeReflect<T>::Reader::End() {
+	if (stack.empty()) {
+		depth--;
+		return;
+	}
+
+	stack.pop_back();
+	if (!stack.empty())
+		return;
+
+	VisitField(building, [this](const auto &field) {
+		if (tree.IsValid())
+			tree >> object.*field.member;
+	});
+}
+
+template<typename T>
+void NodeReflect<T>::Read(const Node &node, T &object) {
+	std::size_t next = 0;
+
+	for (const auto &property : node.GetProperties()) {
+		auto i = FindField(&property.GetName(), next);
+		if (i == FieldCount)
+			continue;
+		next = i + 1;
+
+		VisitField(i, [&](const auto &field) {
+			if (property.IsValid())
+				property >> object.*field.member;
+		});
+	}
+}
+
+template<typename T>
+void NodeReflect<T>::Write(Node &node, const T &object) {
+	const auto &keys = GetKeys();
+	// Only nodes that already have properties, such as the type written by a factory, need to be searched.
+	auto existing = !node.GetProperties().empty();
+
+	for (std::size_t i = 0; i < FieldCount; i++) {
+		VisitField(i, [&](const auto &field) {
+			if (existing)
+				node[*keys[i]].Set(object.*field.member);
+			else
+				node.AddProperty(*keys[i]) << object.*field.member;
+		});
+	}
+}
+
+template<typename T>
+void NodeReflect<T>::Write(NodeHandler &handler, std::string_view name, const T &object) {
+	if (!handler.BeginObject(name))
+		return;
+
+	std::apply([&](const auto &... fields) {
+		(WriteValue(handler, fields.name, object.*fields.member), ...);
+	}, Fields);
+
+	handler.EndObject();
+}
+
+template<typename T>
+const std::array<const std::string *, NodeReflect<T>::FieldCount> &NodeReflect<T>::GetKeys() {
+	static const auto keys = [] {
+		std::array<const std::string *, FieldCount> keys;
+		for (std::size_t i = 0; i < FieldCount; i++)
+			keys[i] = NodeKeys::Intern(Names[i]);
+		return keys;
+	}();
+	return keys;
+}
+
+template<typename T>
+std::size_t NodeReflect<T>::FindField(const std::string *key, std::size_t next) {
+	const auto &keys = GetKeys();
+	if (next < FieldCount && keys[next] == key)
+		return next;
+
+	return std::find(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+template<typename T>
+std::size_t NodeReflect<T>::FindField(std::string_view name, std::size_t next) {
+	auto hash = String::fnv1a_32(name);
+	if (next < FieldCount && Hashes[next] == hash && Names[next] == name)
+		return next;
+
+	for (std::size_t i = 0; i < FieldCount; i++) {
+		if (Hashes[i] == hash && Names[i] == name)
+			return i;
+	}
+
+	return FieldCount;
+}
+
+template<typename T>
+template<typename U>
+void NodeReflect<T>::WriteValue(NodeHandler &handler, std::string_view name, const U &value) {
+	if constexpr (is_reflected_v<U>) {
+		NodeReflect<U>::Write(handler, name, value);
+	} else if constexpr (std::is_same_v<U, bool>) {
+		handler.Value(name, Node::Type::Boolean, value ? "true" : "false");
+	} else if constexpr (std::is_arithmetic_v<U> || std::is_enum_v<U>) {
+		handler.Value(name, std::is_floating_point_v<U> ? Node::Type::Decimal : Node::Type::Integer, String::To(value));
+	} else if constexpr (std::is_same_v<U, std::string>) {
+		handler.Value(name, Node::Type::String, value);
+	} else {
+		// Containers and classes with their own operators are written through a node.
+		Node node;
+		node << value;
+		node.SetName(name);
+		handler.Visit(node);
+	}
+}
+
+template<typename T, std::enable_if_t<is_reflected_v<T>, int> = 0>
+const Node &operator>>(const Node &node, T &object) {
+	NodeReflect<T>::Read(node, object);
+	return node;
+}
+
+template<typename T, std::enable_if_t<is_reflected_v<T>, int> = 0>
+Node &operator<<(Node &node, const T &object) {
+	NodeReflect<T>::Write(node, object);
+	return node;
+}
+}
@@ -62,7 +62,7 @@ NodeView NodeView::operator[](uint32_t index) {
 	return const_cast<Node *>(value)->operator[](index);
 }
 
-std::vector<Node> &NodeView::GetProperties() {
+NodeProperties &NodeView::GetProperties() {
 	if (!has_value())
 		return get()->GetProperties();
 	return const_cast<Node *>(value)->GetProperties();
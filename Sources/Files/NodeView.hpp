@@ -41,6 +41,6 @@ public:
 	template<typename T>
 	Node &operator=(T &&rhs);
 
-	std::vector<Node> &GetProperties();
+	NodeProperties &GetProperties();
 };
 }
@@ -0,0 +1,48 @@
+#include "NodeWriter.hpp"
+
+namespace acid {
+NodeWriter::NodeWriter(std::ostream &stream, Node::Format format) :
+	format(format),
+	stream(stream) {
+	buffer.reserve(BufferSize);
+}
+
+NodeWriter::~NodeWriter() {
+	Flush();
+}
+
+void NodeWriter::Flush() {
+	stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	buffer.clear();
+}
+
+void NodeWriter::Append(std::string_view string) {
+	// Large values are written straight through rather than being copied into the buffer.
+	if (buffer.size() + string.size() > BufferSize) {
+		Flush();
+		if (string.size() > BufferSize) {
+			stream.write(string.data(), static_cast<std::streamsize>(string.size()));
+			return;
+		}
+	}
+
+	buffer.append(string);
+}
+
+void NodeWriter::AppendNewLine() {
+	if (format.newLine != '\0')
+		buffer += format.newLine;
+}
+
+void NodeWriter::AppendSpace() {
+	if (format.space != '\0')
+		buffer += format.space;
+}
+
+void NodeWriter::AppendIndents(std::size_t indent) {
+	buffer.append(indent * format.spacesPerIndent, ' ');
+	// Single characters are appended without checking the buffer, each indent is a point the buffer can be flushed at.
+	if (buffer.size() > BufferSize)
+		Flush();
+}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "NodeHandler.hpp"
+
+namespace acid {
+/**
+ * @brief Base of the streaming writers, a {@link NodeHandler} that formats events into a buffer that is written to a stream each time it fills.
+ * Documents are written as the events arrive, no {@link Node} tree is built.
+ */
+class ACID_EXPORT NodeWriter : public NodeHandler {
+public:
+	static constexpr std::size_t BufferSize = 64 * 1024;
+
+	/**
+	 * Creates a new node writer.
+	 * @param stream The stream to write to, it must outlive the writer.
+	 * @param format The format to write with.
+	 */
+	NodeWriter(std::ostream &stream, Node::Format format);
+	~NodeWriter() override;
+
+	/**
+	 * Writes a value, the type of value is found from its C++ type.
+	 * @tparam T The value type, a boolean, number, string or nullptr.
+	 * @param name The name of the value, ignored in arrays.
+	 * @param value The value.
+	 */
+	template<typename T>
+	void Write(std::string_view name, const T &value);
+
+	/**
+	 * Writes everything buffered to the stream, this is done when the writer is destroyed.
+	 */
+	void Flush();
+
+protected:
+	void Append(char c) { buffer += c; }
+	void Append(std::string_view string);
+	void AppendNewLine();
+	void AppendSpace();
+	void AppendIndents(std::size_t indent);
+
+	Node::Format format;
+
+private:
+	std::ostream &stream;
+	std::string buffer;
+};
+
+template<typename T>
+void NodeWriter::Write(std::string_view name, const T &value) {
+	if constexpr (std::is_same_v<T, bool>)
+		Value(name, Node::Type::Boolean, value ? "true" : "false");
+	else if constexpr (std::is_same_v<T, std::nullptr_t>)
+		Value(name, Node::Type::Null, {});
+	else if constexpr (std::is_arithmetic_v<T>)
+		Value(name, std::is_floating_point_v<T> ? Node::Type::Decimal : Node::Type::Integer, String::To(value));
+	else
+		Value(name, Node::Type::String, std::string_view(value));
+}
+}
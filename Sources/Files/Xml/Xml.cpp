@@ -1,5 +1,6 @@
 #include "Xml.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 #include "Utils/Enumerate.hpp"
@@ -48,20 +49,133 @@ void Xml::ParseString(Node &node, std::string_view string) {
 
 	// Converts the tokens into nodes.
 	int32_t k = 0;
-	Convert(node, tokens, k);
+	Convert(node, tokens, k, 1);
 }
 
 void Xml::WriteStream(const Node &node, std::ostream &stream, Node::Format format) {
-	stream << R"(<?xml version="1.0" encoding="utf-8"?>)" << format.newLine;
-	// TODO: Taken from body of AppendData properties loop to write parent node tags.
-	stream << '<' << node.GetName();
-	for (const auto &property : node.GetProperties()) {
-		if (property.GetName().rfind('-', 0) != 0) continue;
-		stream << " " << property.GetName().substr(1) << "=\"" << property.GetValue() << "\"";
+	Writer writer(stream, format);
+	writer.Visit(node);
+}
+
+void Xml::Read(std::string_view string, NodeHandler &handler) {
+	auto it = string.begin();
+	auto error = [&](const std::string &message) {
+		throw std::runtime_error("Xml parse error at offset " + std::to_string(it - string.begin()) + ", " + message);
+	};
+	auto startsWith = [&](std::string_view token) {
+		return static_cast<std::size_t>(string.end() - it) >= token.size() && std::string_view(&*it, token.size()) == token;
+	};
+	auto skipPast = [&](std::string_view token) {
+		auto found = string.find(token, it - string.begin());
+		if (found == std::string_view::npos)
+			error("missing '" + std::string(token) + "'");
+		it = string.begin() + found + token.size();
+	};
+	auto skipWhitespace = [&]() {
+		while (it != string.end() && String::IsWhitespace(*it))
+			++it;
+	};
+	auto readName = [&]() {
+		auto start = it;
+		while (it != string.end() && !String::IsWhitespace(*it) && *it != '/' && *it != '>' && *it != '=')
+			++it;
+		if (it == start)
+			error("expected a name");
+		return std::string_view(&*start, it - start);
+	};
+
+	// Names of the open elements, and how many of the innermost ones are being skipped.
+	std::vector<std::string_view> elements;
+	std::size_t skipped = 0;
+	std::string attributeName;
+
+	while (it != string.end()) {
+		if (*it != '<') {
+			auto start = it;
+			while (it != string.end() && *it != '<')
+				++it;
+			if (auto text = String::Trim(std::string_view(&*start, it - start)); !text.empty() && !elements.empty() && skipped == 0)
+				handler.Value("#text", Node::Type::String, text);
+			continue;
+		}
+
+		if (startsWith("<?")) {
+			skipPast("?>");
+		} else if (startsWith("<!--")) {
+			skipPast("-->");
+		} else if (startsWith("<![CDATA[")) {
+			it += 9;
+			auto start = it;
+			skipPast("]]>");
+			if (!elements.empty() && skipped == 0)
+				handler.Value("#text", Node::Type::String, std::string_view(&*start, it - start - 3));
+		} else if (startsWith("<!")) {
+			skipPast(">");
+		} else if (startsWith("</")) {
+			it += 2;
+			auto name = readName();
+			if (elements.empty() || elements.back() != name)
+				error("unexpected end tag '" + std::string(name) + "'");
+			skipPast(">");
+			elements.pop_back();
+
+			if (skipped != 0)
+				skipped--;
+			else
+				handler.EndObject();
+		} else {
+			++it;
+			auto name = readName();
+			auto read = skipped == 0 && handler.BeginObject(name);
+
+			// Attributes are sent as values named with a leading '-'.
+			while (true) {
+				skipWhitespace();
+				if (it == string.end())
+					error("missing end of start tag");
+				if (*it == '/' || *it == '>')
+					break;
+
+				auto attribute = readName();
+				skipWhitespace();
+				if (it == string.end() || *it++ != '=')
+					error("expected '=' after attribute");
+				skipWhitespace();
+				if (it == string.end() || (*it != '"' && *it != '\''))
+					error("expected a quoted attribute value");
+
+				auto quote = *it++;
+				auto start = it;
+				while (it != string.end() && *it != quote)
+					++it;
+				if (it == string.end())
+					error("missing end of attribute value");
+
+				if (read) {
+					attributeName.assign(1, '-');
+					attributeName += attribute;
+					handler.Value(attributeName, Node::Type::String, std::string_view(&*start, it - start));
+				}
+				++it;
+			}
+
+			if (*it == '/') {
+				skipPast(">");
+				if (read)
+					handler.EndObject();
+			} else {
+				++it;
+				if (elements.size() >= Node::MaxDepth)
+					error("nesting is deeper than " + std::to_string(Node::MaxDepth) + " levels");
+				elements.emplace_back(name);
+				if (!read)
+					skipped++;
+			}
+		}
 	}
-	stream << '>' << format.newLine;
-	AppendData(node, stream, format, 0);
-	stream << "</" << node.GetName() << ">";
+
+	if (!elements.empty())
+		error("missing end tag for '" + std::string(elements.back()) + "'");
 }
 
 void Xml::AddToken(std::string_view view, std::vector<Node::Token> &tokens) {
@@ -69,7 +183,7 @@ void Xml::AddToken(std::string_view view, std::vector<Node::Token> &tokens) {
 		tokens.emplace_back(Node::Type::String, view);
 }
 
-void Xml::Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k) {
+void Xml::Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k, uint32_t depth) {
 	// Only start to parse if we are at the start of a tag.
 	if (tokens[k] != Node::Token(Node::Type::Token, "<"))
 		return;
@@ -81,10 +195,13 @@ void Xml::Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t
 		while (tokens[k] != Node::Token(Node::Type::Token, ">"))
 			k++;
 		k++;
-		Convert(current, tokens, k);
+		Convert(current, tokens, k, depth);
 		return;
 	}
 
+	if (depth > Node::MaxDepth)
+		throw std::runtime_error("Xml parse error, nesting is deeper than " + std::to_string(Node::MaxDepth) + " levels");
+
 	// The next token after the open tag is the name.
 	auto name = tokens[k].view;
 	k++;
@@ -111,7 +228,7 @@ void Xml::Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t
 			k++;
 		} else {
 			// TODO: If the token at k is not a '<' this will cause a infinite loop, or if k + 2 > tokens.size() vector access will be violated.
-			Convert(property, tokens, k);
+			Convert(property, tokens, k, depth + 1);
 		}
 	}
 	k += 4;
@@ -136,47 +253,141 @@ Node &Xml::CreateProperty(Node &current, const std::string &name) {
 	return current.AddProperty(name);
 }
 
-void Xml::AppendData(const Node &node, std::ostream &stream, Node::Format format, int32_t indent) {
-	stream << node.GetValue();
+Xml::Writer::Writer(std::ostream &stream, Node::Format format) :
+	NodeWriter(stream, format) {
+	Append(R"(<?xml version="1.0" encoding="utf-8"?>)");
+	AppendNewLine();
+}
 
-	auto indents = format.GetIndents(indent + 1);
-	// Output each property.
-	for (auto it = node.GetProperties().begin(); it < node.GetProperties().end(); ++it) {
-		if (it->GetName().rfind('-', 0) == 0) continue;
+bool Xml::Writer::BeginObject(std::string_view name) {
+	// The name is copied before it is pushed, it may be the name of the array scope.
+	std::string elementName(GetElementName(name));
+	if (!scopes.empty())
+		BeginChild();
+	Append('<');
+	Append(elementName);
 
-		// Skip property tag for arrays and move onto appending its properties.
-		if (it->GetType() == Node::Type::Array) {
-			AppendData(*it, stream, format, indent);
-			continue;
-		}
+	auto &scope = scopes.emplace_back();
+	scope.name = std::move(elementName);
+	scope.isTagOpen = true;
+	return true;
+}
 
-		// If the node is an array, then all properties will inherit the array name.
-		const auto &name = node.GetType() == Node::Type::Array ? node.GetName() : it->GetName();
-		stream << indents << '<' << name;
+void Xml::Writer::EndObject() {
+	auto scope = std::move(scopes.back());
+	scopes.pop_back();
+	if (!scope.isElement)
+		return;
 
-		// Add attributes to opening tag.
-		int attributeCount = 0;
-		for (const auto &property : it->GetProperties()) {
-			if (property.GetName().rfind('-', 0) != 0) continue;
-			stream << " " << property.GetName().substr(1) << "=\"" << property.GetValue() << "\"";
-			attributeCount++;
-		}
+	if (scope.isTagOpen) {
+		Append("/>");
+		return;
+	}
 
-		// When the property has a value or children recursively append them, otherwise shorten tag ending.
-		if (it->GetProperties().size() - attributeCount != 0 || !it->GetValue().empty()) {
-			stream << '>';
+	if (scope.hasChildren) {
+		AppendNewLine();
+		AppendIndents(std::count_if(scopes.begin(), scopes.end(), [](const Scope &s) { return s.isElement; }));
+	}
+	Append("</");
+	Append(scope.name);
+	Append('>');
+}
 
-			if (it->GetProperties().size() - attributeCount != 0) {
-				stream << format.newLine;
-				AppendData(*it, stream, format, indent + 1);
-				stream << indents;
-			} else {
-				AppendData(*it, stream, format, indent + 1);
+bool Xml::Writer::BeginArray(std::string_view name) {
+	// Documents need a root element, a root array becomes one that its elements are written into.
+	if (scopes.empty()) {
+		BeginObject(name);
+		scopes.back().isArray = true;
+		return true;
+	}
+
+	Scope scope;
+	scope.name = GetElementName(name);
+	scope.isArray = true;
+	scope.isElement = false;
+	scopes.emplace_back(std::move(scope));
+	return true;
+}
+
+void Xml::Writer::EndArray() {
+	EndObject();
+}
+
+void Xml::Writer::Value(std::string_view name, Node::Type type, std::string_view value) {
+	if (!scopes.empty() && !scopes.back().isArray) {
+		auto &scope = scopes.back();
+		if (IsLeading(name)) {
+			// Attributes are written into the start tag, so one after the content would become a element with a invalid name.
+			if (!scope.isTagOpen)
+				throw std::runtime_error("Xml write error, attribute '" + std::string(name.substr(1)) + "' after the content of element '" + scope.name + "'");
+			Append(' ');
+			Append(name.substr(1));
+			Append("=\"");
+			AppendValue(type, value);
+			Append('"');
+			return;
+		}
+
+		if (name == "#text") {
+			if (scope.isTagOpen) {
+				Append('>');
+				scope.isTagOpen = false;
 			}
-			stream << "</" << name << '>' << format.newLine;
-		} else {
-			stream << "/>" << format.newLine;
+			AppendValue(type, value);
+			return;
+		}
+	}
+
+	auto elementName = GetElementName(name);
+	if (!scopes.empty())
+		BeginChild();
+	Append('<');
+	Append(elementName);
+
+	// When the value is empty the tag is closed right away.
+	if (value.empty()) {
+		Append("/>");
+		return;
+	}
+
+	Append('>');
+	AppendValue(type, value);
+	Append("</");
+	Append(elementName);
+	Append('>');
+}
+
+std::string_view Xml::Writer::GetElementName(std::string_view name) const {
+	// Elements of arrays are repeated elements named after the array.
+	if (!scopes.empty() && scopes.back().isArray)
+		return scopes.back().name;
+	return name;
+}
+
+void Xml::Writer::BeginChild() {
+	std::size_t depth = 0;
+	Scope *element = nullptr;
+	for (auto &scope : scopes) {
+		if (scope.isElement) {
+			element = &scope;
+			depth++;
 		}
 	}
+
+	if (element->isTagOpen) {
+		Append('>');
+		element->isTagOpen = false;
+	}
+	element->hasChildren = true;
+
+	AppendNewLine();
+	AppendIndents(depth);
+}
+
+void Xml::Writer::AppendValue(Node::Type type, std::string_view value) {
+	if (type == Node::Type::Blob)
+		Append(String::EncodeBase64(value));
+	else
+		Append(value);
 }
 }
@@ -1,20 +1,68 @@
 #pragma once
 
-#include "Files/Node.hpp"
+#include "Files/NodeWriter.hpp"
 
 namespace acid {
+/**
+ * @brief Class that reads and writes XML using {@link Node} as storage.
+ * Elements are nodes, attributes are properties named with a leading '-', and text is the node value.
+ */
 class ACID_EXPORT Xml {
 public:
+	/**
+	 * @brief Class that writes XML as {@link NodeHandler} events arrive, without building a node tree.
+	 * Values named with a leading '-' are attributes of the element they are in and must come before its text and children,
+	 * "#text" values are element text, and the elements of arrays are written as repeated elements named after the array.
+	 */
+	class ACID_EXPORT Writer : public NodeWriter {
+	public:
+		explicit Writer(std::ostream &stream, Node::Format format = Node::Format::Minified);
+
+		bool BeginObject(std::string_view name) override;
+		void EndObject() override;
+		bool BeginArray(std::string_view name) override;
+		void EndArray() override;
+		void Value(std::string_view name, Node::Type type, std::string_view value) override;
+
+	protected:
+		bool IsLeading(std::string_view name) const override { return !name.empty() && name[0] == '-'; }
+
+	private:
+		class Scope {
+		public:
+			std::string name;
+			bool isArray = false;
+			/// If this scope wrote a element, arrays inside other elements only name their elements.
+			bool isElement = true;
+			/// If the start tag is still open for attributes.
+			bool isTagOpen = false;
+			bool hasChildren = false;
+		};
+
+		std::string_view GetElementName(std::string_view name) const;
+		void BeginChild();
+		void AppendValue(Node::Type type, std::string_view value);
+
+		std::vector<Scope> scopes;
+	};
+
 	Xml() = delete;
 	
 	static void ParseString(Node &node, std::string_view string);
 	static void WriteStream(const Node &node, std::ostream &stream, Node::Format format);
 
+	/**
+	 * Reads a document as a stream of events, without building a node tree.
+	 * Each element is a object, attributes are values named with a leading '-', and element text is a "#text" value.
+	 * Repeated elements are not combined into arrays as they are when parsing into a node.
+	 * @param string The document, usually the contents of a {@link MappedFile}.
+	 * @param handler The handler to send events to.
+	 */
+	static void Read(std::string_view string, NodeHandler &handler);
+
 private:
 	static void AddToken(std::string_view view, std::vector<Node::Token> &tokens);
-	static void Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k);
+	static void Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k, uint32_t depth);
 	static Node &CreateProperty(Node &current, const std::string &name);
-	
-	static void AppendData(const Node &node, std::ostream &stream, Node::Format format, int32_t indent);
 };
 }
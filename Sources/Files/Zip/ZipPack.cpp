@@ -0,0 +1,257 @@
+#include "ZipPack.hpp"
+
+#include <memory>
+
+#include "Engine/Log.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "ZipException.hpp"
+
+namespace acid {
+namespace {
+constexpr uint32_t EndRecordSignature = 0x06054b50;
+constexpr uint32_t DirectoryRecordSignature = 0x02014b50;
+constexpr uint32_t LocalHeaderSignature = 0x04034b50;
+constexpr std::size_t EndRecordSize = 22;
+constexpr std::size_t DirectoryRecordSize = 46;
+constexpr std::size_t LocalHeaderSize = 30;
+/// Files smaller than this are always stored, deflate can not make them meaningfully smaller.
+constexpr std::size_t MinCompressSize = 64;
+
+uint16_t Read16(const uint8_t *data) {
+	return static_cast<uint16_t>(data[0] | data[1] << 8);
+}
+
+uint32_t Read32(const uint8_t *data) {
+	return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 | static_cast<uint32_t>(data[2]) << 16 |
+		static_cast<uint32_t>(data[3]) << 24;
+}
+
+template<typename F>
+void ParallelFor(ThreadPool *threadPool, std::size_t count, F &&f) {
+	// Entries differ a lot in size, so each task takes one at a time.
+	if (threadPool)
+		threadPool->ParallelFor(0, count, 1, std::forward<F>(f));
+	else if (count != 0)
+		f(0, count);
+}
+}
+
+ZipPack::ZipPack(const std::filesystem::path &filename) {
+	Open(filename);
+}
+
+bool ZipPack::Open(const std::filesystem::path &filename) {
+	Close();
+
+	if (!file.Open(filename))
+		return false;
+
+	try {
+		auto data = file.GetData();
+		auto size = file.GetSize();
+
+		// The end of central directory record is at the end of the file, followed by a comment of up to 64KB.
+		if (size < EndRecordSize)
+			throw ZipExceptionNotAnArchive("Zip pack " + filename.string() + " is too small to be an archive");
+
+		auto end = size - EndRecordSize;
+		auto lowest = end > 0xFFFF ? end - 0xFFFF : 0;
+		while (Read32(data + end) != EndRecordSignature) {
+			if (end == lowest)
+				throw ZipExceptionFailedFindingCentralDir("Zip pack " + filename.string() + " has no central directory");
+			end--;
+		}
+
+		auto diskEntryCount = Read16(data + end + 8);
+		auto entryCount = Read16(data + end + 10);
+		auto directorySize = Read32(data + end + 12);
+		auto directoryOffset = Read32(data + end + 16);
+
+		if (Read16(data + end + 4) != 0 || diskEntryCount != entryCount)
+			throw ZipExceptionMultidiskUnsupported("Zip pack " + filename.string() + " spans multiple disks");
+		if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF)
+			throw ZipExceptionUnsupportedFeature("Zip pack " + filename.string() + " is a zip64 archive");
+		if (static_cast<std::size_t>(directoryOffset) + directorySize > end)
+			throw ZipExceptionInvalidHeader("Zip pack " + filename.string() + " has a corrupted central directory");
+
+		entries.reserve(entryCount);
+		index.reserve(entryCount);
+
+		std::size_t offset = directoryOffset;
+		for (uint32_t i = 0; i < entryCount; i++) {
+			auto record = data + offset;
+			if (offset + DirectoryRecordSize > end || Read32(record) != DirectoryRecordSignature ||
+				offset + DirectoryRecordSize + Read16(record + 28) > end)
+				throw ZipExceptionInvalidHeader("Zip pack " + filename.string() + " has a corrupted central directory");
+
+			Entry entry;
+			entry.method = Read16(record + 10);
+			entry.crc = Read32(record + 16);
+			entry.compressedSize = Read32(record + 20);
+			entry.size = Read32(record + 24);
+			entry.localHeaderOffset = Read32(record + 42);
+			entry.name = {reinterpret_cast<const char *>(record + DirectoryRecordSize), Read16(record + 28)};
+			offset += DirectoryRecordSize + Read16(record + 28) + Read16(record + 30) + Read16(record + 32);
+
+			if (entry.compressedSize == 0xFFFFFFFF || entry.size == 0xFFFFFFFF || entry.localHeaderOffset == 0xFFFFFFFF)
+				throw ZipExceptionUnsupportedFeature("Zip pack " + filename.string() + " is a zip64 archive");
+
+			if (Read16(record + 8) & 1) {
+				Log::Warning("Skipping encrypted entry ", entry.name, " in zip pack ", filename, '\n');
+				continue;
+			}
+
+			// Later entries replace earlier entries with the same name, the same as ZipArchive.
+			index[entry.name] = entries.size();
+			entries.emplace_back(entry);
+		}
+
+		verified = std::make_unique<std::atomic<bool>[]>(entries.size());
+	} catch (...) {
+		Close();
+		throw;
+	}
+
+	return true;
+}
+
+void ZipPack::Close() {
+	verified.reset();
+	index.clear();
+	entries.clear();
+	file.Close();
+}
+
+const ZipPack::Entry *ZipPack::Find(std::string_view name) const {
+	auto it = index.find(name);
+	return it != index.end() ? &entries[it->second] : nullptr;
+}
+
+std::optional<std::string_view> ZipPack::View(const Entry &entry) const {
+	if (!entry.IsStored())
+		return std::nullopt;
+	if (entry.compressedSize != entry.size)
+		throw ZipExceptionInvalidHeader("Zip entry " + std::string(entry.name) + " is stored with a different size than its contents");
+
+	auto data = GetData(entry);
+	// Threads viewing an entry for the first time may both check it, which is harmless.
+	auto &checked = verified[&entry - entries.data()];
+	if (!checked.load(std::memory_order_acquire)) {
+		CheckCrc(entry, data);
+		checked.store(true, std::memory_order_release);
+	}
+	return data;
+}
+
+std::string ZipPack::Read(const Entry &entry) const {
+	if (auto view = View(entry))
+		return std::string(*view);
+
+	auto data = GetData(entry);
+
+	if (entry.method != MZ_DEFLATED)
+		throw ZipExceptionUnsupportedMethod("Zip entry " + std::string(entry.name) + " uses unsupported method " + std::to_string(entry.method));
+
+	// The whole entry is inflated in one call from the mapping, which keeps no shared state between threads.
+	std::string result(static_cast<std::size_t>(entry.size), '\0');
+	auto size = tinfl_decompress_mem_to_mem(result.data(), result.size(), data.data(), data.size(), 0);
+	if (size == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED || size != result.size())
+		throw ZipExceptionDecompressionFailed("Failed to inflate zip entry " + std::string(entry.name));
+	CheckCrc(entry, result);
+	return result;
+}
+
+std::optional<std::string> ZipPack::Read(std::string_view name) const {
+	if (auto entry = Find(name))
+		return Read(*entry);
+	return std::nullopt;
+}
+
+void ZipPack::CheckCrc(const Entry &entry, std::string_view data) {
+	if (mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const uint8_t *>(data.data()), data.size()) != entry.crc)
+		throw ZipExceptionCrcCheckFailed("Zip entry " + std::string(entry.name) + " failed its crc check");
+}
+
+std::vector<std::string> ZipPack::ReadAll(const std::vector<const Entry *> &entries, ThreadPool *threadPool) const {
+	std::vector<std::string> result(entries.size());
+	ParallelFor(threadPool, entries.size(), [&](std::size_t begin, std::size_t end) {
+		for (auto i = begin; i < end; i++)
+			result[i] = Read(*entries[i]);
+	});
+	return result;
+}
+
+void ZipPack::Write(const std::filesystem::path &filename, const std::vector<Source> &sources, int32_t level, ThreadPool *threadPool) {
+	class Compressed {
+	public:
+		std::unique_ptr<void, decltype(&mz_free)> data = {nullptr, &mz_free};
+		std::size_t size = 0;
+		std::size_t uncompressedSize = 0;
+		uint32_t crc = 0;
+	};
+
+	// Compression runs in parallel, only the compressed data is kept so the source files can be closed straight away.
+	std::vector<Compressed> compressed(sources.size());
+	auto flags = tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+	ParallelFor(threadPool, sources.size(), [&](std::size_t begin, std::size_t end) {
+		for (auto i = begin; i < end; i++) {
+			MappedFile source(sources[i].path);
+			if (!source)
+				throw ZipExceptionFileOpenFailed("Failed to read " + sources[i].path.string() + " into zip pack");
+			if (source.GetSize() < MinCompressSize)
+				continue;
+
+			auto &item = compressed[i];
+			item.uncompressedSize = source.GetSize();
+			item.crc = static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, source.GetData(), source.GetSize()));
+			item.data.reset(tdefl_compress_mem_to_heap(source.GetData(), source.GetSize(), &item.size, flags));
+
+			// Files that barely compress are stored, so they can be viewed without copying when the pack is read.
+			if (item.size >= item.uncompressedSize - item.uncompressedSize / 16)
+				item.data.reset();
+		}
+	});
+
+	auto filenameU8 = filename.u8string();
+	mz_zip_archive archive = {};
+	if (!mz_zip_writer_init_file(&archive, filenameU8.c_str(), 0))
+		throw ZipExceptionFileCreateFailed("Failed to create zip pack " + filenameU8);
+
+	for (std::size_t i = 0; i < sources.size(); i++) {
+		auto &item = compressed[i];
+		mz_bool added;
+		if (item.data) {
+			added = mz_zip_writer_add_mem_ex(&archive, sources[i].name.c_str(), item.data.get(), item.size, nullptr, 0,
+				static_cast<mz_uint>(level) | MZ_ZIP_FLAG_COMPRESSED_DATA, item.uncompressedSize, item.crc);
+			item.data.reset();
+		} else {
+			MappedFile source(sources[i].path);
+			added = source && mz_zip_writer_add_mem(&archive, sources[i].name.c_str(), source.GetData(), source.GetSize(), MZ_NO_COMPRESSION);
+		}
+
+		if (!added) {
+			mz_zip_writer_end(&archive);
+			throw ZipExceptionFileWriteFailed("Failed to add " + sources[i].name + " to zip pack " + filenameU8);
+		}
+	}
+
+	auto finalized = mz_zip_writer_finalize_archive(&archive);
+	mz_zip_writer_end(&archive);
+	if (!finalized)
+		throw ZipExceptionFileWriteFailed("Failed to finalize zip pack " + filenameU8);
+}
+
+std::string_view ZipPack::GetData(const Entry &entry) const {
+	auto data = file.GetData();
+	auto offset = static_cast<std::size_t>(entry.localHeaderOffset);
+
+	// The local header repeats the name and has its own extra field, so the data offset is only known once it is read.
+	if (offset + LocalHeaderSize > file.GetSize() || Read32(data + offset) != LocalHeaderSignature)
+		throw ZipExceptionInvalidHeader("Zip entry " + std::string(entry.name) + " has a corrupted local header");
+
+	offset += LocalHeaderSize + Read16(data + offset + 26) + Read16(data + offset + 28);
+	if (offset + entry.compressedSize > file.GetSize())
+		throw ZipExceptionInvalidHeader("Zip entry " + std::string(entry.name) + " is outside of the archive");
+	return {reinterpret_cast<const char *>(data + offset), static_cast<std::size_t>(entry.compressedSize)};
+}
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <miniz/miniz.h>
+
+#include "Files/MappedFile.hpp"
+
+namespace acid {
+class ThreadPool;
+
+/**
+ * @brief Class that reads a zip archive in place from a memory mapping, used for read-only asset packs.
+ * The central directory is indexed by name when the pack is opened, stored entries are read without copying,
+ * and deflated entries are inflated straight from the mapping so many can be read in parallel.
+ * Unlike {@link ZipArchive} a pack can not be modified, {@link ZipPack#Write} builds a new one.
+ */
+class ACID_EXPORT ZipPack : NonCopyable {
+public:
+	/**
+	 * @brief Class that describes a entry in the central directory of a pack.
+	 */
+	class Entry {
+	public:
+		bool IsStored() const { return method == 0; }
+		bool IsDirectory() const { return !name.empty() && name.back() == '/'; }
+
+		/// The name of the entry, pointing into the mapped central directory.
+		std::string_view name;
+		uint64_t compressedSize = 0;
+		uint64_t size = 0;
+		uint32_t crc = 0;
+		uint32_t localHeaderOffset = 0;
+		uint16_t method = 0;
+	};
+
+	/**
+	 * @brief Class that describes a file on disk to add to a new pack.
+	 */
+	class Source {
+	public:
+		/// The name of the entry in the pack.
+		std::string name;
+		std::filesystem::path path;
+	};
+
+	ZipPack() = default;
+	/**
+	 * Creates a new pack, throws a {@link ZipException} when the file is not a supported archive.
+	 * @param filename The archive file to map.
+	 */
+	explicit ZipPack(const std::filesystem::path &filename);
+
+	/**
+	 * Maps a archive and indexes its central directory, closing any pack already open.
+	 * Multi-disk and zip64 archives are not supported and throw a {@link ZipException}.
+	 * @param filename The archive file to map.
+	 * @return If the file could be mapped.
+	 */
+	bool Open(const std::filesystem::path &filename);
+	void Close();
+
+	/**
+	 * Finds a entry by name, when names are repeated the last entry in the archive is found.
+	 * @param name The name of the entry.
+	 * @return The entry, or nullptr if it is not in the pack.
+	 */
+	const Entry *Find(std::string_view name) const;
+
+	/**
+	 * Gets the contents of a stored entry without copying, throws a {@link ZipException} when they fail the crc check.
+	 * Each entry is only checked the first time it is viewed, so later views do not read the contents.
+	 * @param entry The entry to view.
+	 * @return The contents pointing into the mapping, valid until the pack is closed, or nullopt if the entry is compressed.
+	 */
+	std::optional<std::string_view> View(const Entry &entry) const;
+
+	/**
+	 * Reads the contents of a entry, inflating it when it is compressed. Safe to call from many threads at once.
+	 * Throws a {@link ZipException} when the contents fail the crc check.
+	 * @param entry The entry to read.
+	 * @return The contents of the entry.
+	 */
+	std::string Read(const Entry &entry) const;
+
+	/**
+	 * Reads the contents of a entry found by name.
+	 * @param name The name of the entry.
+	 * @return The contents of the entry, or nullopt if it is not in the pack.
+	 */
+	std::optional<std::string> Read(std::string_view name) const;
+
+	/**
+	 * Reads the contents of many entries, inflating them in parallel.
+	 * @param entries The entries to read.
+	 * @param threadPool The pool to read on, if null the entries are read on the calling thread.
+	 * @return The contents of each entry, in the same order as the entries.
+	 */
+	std::vector<std::string> ReadAll(const std::vector<const Entry *> &entries, ThreadPool *threadPool = nullptr) const;
+
+	/**
+	 * Writes a new pack from files on disk, compressing the files in parallel.
+	 * Files that deflate does not make noticeably smaller are stored, so they can be read without copying.
+	 * @param filename The archive file to write.
+	 * @param sources The files to add.
+	 * @param level The deflate level, from 1 to 10.
+	 * @param threadPool The pool to compress on, if null the files are compressed on the calling thread.
+	 */
+	static void Write(const std::filesystem::path &filename, const std::vector<Source> &sources, int32_t level = MZ_DEFAULT_LEVEL,
+		ThreadPool *threadPool = nullptr);
+
+	const MappedFile &GetFile() const { return file; }
+	const std::vector<Entry> &GetEntries() const { return entries; }
+
+	explicit operator bool() const noexcept { return static_cast<bool>(file); }
+
+private:
+	std::string_view GetData(const Entry &entry) const;
+	static void CheckCrc(const Entry &entry, std::string_view data);
+
+	MappedFile file;
+	std::vector<Entry> entries;
+	std::unordered_map<std::string_view, std::size_t> index;
+	/// If each stored entry has passed its crc check, by entry index.
+	std::unique_ptr<std::atomic<bool>[]> verified;
+};
+}
@@ -1,14 +1,61 @@
 #include "FontType.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <msdf/msdf.h>
 #include <stb/stb_truetype.h>
 
 #include "Files/Files.hpp"
 #include "Resources/Resources.hpp"
-#include "Graphics/Graphics.hpp"
 
 namespace acid {
-static const std::wstring_view NEHE = L" \t\r\nABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz1234567890\"!`?'.,;:()[]{}<>|/@\\^$-%+=#_&~*";
+static const std::u32string_view NEHE = U" ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz1234567890\"!`?'.,;:()[]{}<>|/@\\^$-%+=#_&~*";
+
+namespace {
+constexpr char CacheMagic[4] = {'A', 'F', 'G', '0'};
+constexpr uint32_t CacheVersion = 1;
+
+struct CacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t size;
+	uint32_t glyphCount;
+	uint64_t fontHash;
+	float distanceRange;
+	uint32_t reserved;
+};
+
+struct CacheGlyph {
+	uint32_t codepoint;
+	float advance;
+	float offset[2];
+	uint32_t hasImage;
+};
+
+/// Glyphs each layer of the atlas is sized to fit along each side.
+constexpr uint32_t LayerGlyphs = 16;
+constexpr uint32_t MaxLayers = 8;
+
+uint64_t HashBytes(const uint8_t *data, std::size_t size) {
+	// FNV-1a, only used to tell if the font file changed since glyphs were cached.
+	uint64_t hash = 14695981039346656037ull;
+	for (std::size_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+Vector2ui GetLayerSize(std::size_t size) {
+	uint32_t layerSize = 256;
+	while (layerSize < (size + 2) * LayerGlyphs && layerSize < 4096)
+		layerSize *= 2;
+	return {layerSize, layerSize};
+}
+}
 
 std::shared_ptr<FontType> FontType::Create(const Node &node) {
 	if (auto resource = Resources::Get()->Find<FontType>(node))
@@ -35,6 +82,80 @@ FontType::FontType(std::filesystem::path filename, std::size_t size, bool load)
 		FontType::Load();
 }
 
+FontType::~FontType() {
+	if (cacheWrite.valid())
+		cacheWrite.wait();
+	if (cacheDirty)
+		WriteCacheFile(true);
+}
+
+void FontType::Update() {
+	// Glyphs are packed on the main thread, as the atlas uploads them on its update. Packing can evict glyphs not drawn for a while,
+	// every region is found again in the first call to GetRegion of the next update, so an evicted glyph is packed again when next drawn.
+	uint32_t failed = 0;
+	for (auto index : pending) {
+		auto &image = images[index];
+		image.pending = false;
+		image.region = atlas.Add(std::to_string(glyphs[index].codepoint), *image.bitmap);
+		image.foundUpdate = updateCount;
+		failed += image.region ? 0 : 1;
+	}
+
+	// Glyphs that do not fit are requested again each update they are drawn, the failure is reported once until they fit.
+	if (failed != 0 && !packFailed)
+		Log::Warning("Font type ", filename, " could not pack ", failed, " glyphs into its atlas\n");
+	if (!pending.empty())
+		packFailed = failed != 0;
+
+	pending.clear();
+	atlas.Update();
+	updateCount++;
+
+	if (cacheDirty && (!cacheWrite.valid() || cacheWrite.wait_for(0s) == std::future_status::ready))
+		WriteCacheFile(false);
+}
+
+void FontType::GetGlyphs(std::u32string_view codepoints, std::vector<uint32_t> &indices) {
+	missing.clear();
+	for (auto codepoint : codepoints) {
+		if (codepoint >= 0x20 && this->indices.find(codepoint) == this->indices.end() && missing.find(codepoint) == std::u32string::npos)
+			missing.push_back(codepoint);
+	}
+
+	if (!missing.empty())
+		Generate(missing);
+
+	indices.clear();
+	indices.reserve(codepoints.size());
+	for (auto codepoint : codepoints) {
+		auto it = this->indices.find(codepoint);
+		indices.emplace_back(it != this->indices.end() ? it->second : NoGlyph);
+	}
+}
+
+std::optional<FontType::Glyph> FontType::GetGlyph(char32_t codepoint) const {
+	if (auto it = indices.find(codepoint); it != indices.end())
+		return glyphs[it->second];
+	return std::nullopt;
+}
+
+const TextureAtlas::Region *FontType::GetRegion(uint32_t index) {
+	auto &image = images[index];
+	if (image.region && image.foundUpdate != updateCount) {
+		image.region = atlas.Find(std::to_string(glyphs[index].codepoint));
+		image.foundUpdate = updateCount;
+	}
+
+	if (image.region)
+		return &*image.region;
+
+	if (glyphs[index].hasImage && !image.pending) {
+		image.pending = true;
+		pending.emplace_back(index);
+	}
+	return nullptr;
+}
+
 const Node &operator>>(const Node &node, FontType &fontType) {
 	node["filename"].Get(fontType.filename);
 	node["size"].Get(fontType.size);
@@ -54,39 +175,232 @@ void FontType::Load() {
 	auto debugStart = Time::Now();
 #endif
 
-	auto bytes = Files::ReadBytes(filename);
-	stbtt_fontinfo fontinfo;
-	stbtt_InitFont(&fontinfo, bytes.data(), stbtt_GetFontOffsetForIndex(bytes.data(), 0));
+	fontFile = Files::ReadAsync(filename).get();
+	fontInfo = std::make_unique<stbtt_fontinfo>();
+	auto fontData = fontFile->GetData();
+	if (fontFile->GetSize() == 0 || !stbtt_InitFont(fontInfo.get(), fontData, stbtt_GetFontOffsetForIndex(fontData, 0))) {
+		Log::Error("Font type ", filename, " could not be loaded\n");
+		fontInfo = nullptr;
+		return;
+	}
 
-	auto layerCount = NEHE.size();
-	//image = std::make_unique<Image2dArray>(Vector2ui(size, size), layerCount, VK_FORMAT_R32G32B32_SFLOAT);
+	fontHash = HashBytes(fontData, fontFile->GetSize());
+	atlas = TextureAtlas(GetLayerSize(size), MaxLayers);
 
-	std::size_t arrayLayer = 0;
-	for (auto c : NEHE) {
-		ex_metrics_t metrics = {};
-		auto bitmap = ex_msdf_glyph(&fontinfo, c, size, size, &metrics, 1);
-		if (bitmap) {
-			//image->SetPixels(bitmap, arrayLayer);
+	auto scale = stbtt_ScaleForMappingEmToPixels(fontInfo.get(), static_cast<float>(size));
+	int32_t fontAscent, fontDescent, lineGap;
+	stbtt_GetFontVMetrics(fontInfo.get(), &fontAscent, &fontDescent, &lineGap);
+	ascent = fontAscent * scale;
+	maxHeight = (fontAscent - fontDescent) * scale;
+	lineHeight = (fontAscent - fontDescent + lineGap) * scale;
 
-			free(bitmap);
-		}
-
-		glyphs.emplace_back(Glyph(metrics.left_bearing, metrics.advance, {metrics.ix0, metrics.iy0}, {metrics.ix1, metrics.iy1}));
-		indices[c] = arrayLayer++;
+	// Glyphs from the cache are kept even when the common glyphs are not all in it, only the missing ones are generated.
+	auto cached = ReadCacheFile();
+	missing.clear();
+	for (auto codepoint : NEHE) {
+		if (indices.find(codepoint) == indices.end())
+			missing.push_back(codepoint);
 	}
 
+	if (!missing.empty())
+		Generate(missing);
+
 #if defined(ACID_DEBUG)
-	Log::Out("Font Type ", filename, " loaded ", glyphs.size(), " glyphs in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+	Log::Out("Font Type ", filename, " loaded ", glyphs.size(), " glyphs", cached ? " from cache" : "", " in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
 #endif
 }
 
-std::optional<FontType::Glyph> FontType::GetGlyph(wchar_t ascii) const {
-	auto it = indices.find(ascii);
+void FontType::Generate(std::u32string_view codepoints) {
+	if (!fontInfo)
+		return;
 
-	if (it != indices.end()) {
-		return glyphs[it->second];
+	auto scale = stbtt_ScaleForMappingEmToPixels(fontInfo.get(), static_cast<float>(size));
+	std::vector<Glyph> generated(codepoints.size());
+	std::vector<std::unique_ptr<Bitmap>> generatedBitmaps(codepoints.size());
+
+	auto generate = [&](std::size_t begin, std::size_t end) {
+		for (auto i = begin; i < end; i++) {
+			auto &glyph = generated[i];
+			glyph.codepoint = codepoints[i];
+
+			auto glyphIndex = stbtt_FindGlyphIndex(fontInfo.get(), static_cast<int32_t>(glyph.codepoint));
+			int32_t advance, leftSideBearing;
+			stbtt_GetGlyphHMetrics(fontInfo.get(), glyphIndex, &advance, &leftSideBearing);
+			glyph.advance = advance * scale;
+
+			ex_metrics_t metrics = {};
+			auto distances = ex_msdf_glyph(fontInfo.get(), glyph.codepoint, size, size, &metrics, 0);
+			if (!distances)
+				continue;
+
+			// The generator centers the glyph box in the image, the pen on the baseline is found the same way it placed the outline.
+			int32_t x0, y0, x1, y1;
+			stbtt_GetGlyphBox(fontInfo.get(), glyphIndex, &x0, &y0, &x1, &y1);
+			auto translateX = static_cast<int32_t>(static_cast<float>(size / 2) - ((x1 - x0) * scale) / 2 - metrics.left_bearing);
+			auto translateY = static_cast<int32_t>(static_cast<float>(size / 2) - ((y1 - y0) * scale) / 2 - y0 * scale);
+			glyph.offset = {static_cast<float>(-translateX), static_cast<float>(translateY - static_cast<int32_t>(size))};
+			glyph.hasImage = true;
+
+			// Distances are generated in units of 64 font units, they are stored so the distance range across the outline spans the 8 bits.
+			auto distanceScale = 64.0f * scale / DistanceRange;
+			auto pixelCount = size * size;
+			auto pixels = std::make_unique<uint8_t[]>(pixelCount * 4);
+			for (std::size_t p = 0; p < pixelCount; p++) {
+				for (std::size_t c = 0; c < 3; c++) {
+					auto distance = (distances[p * 3 + c] - 0.5f) * distanceScale + 0.5f;
+					pixels[p * 4 + c] = static_cast<uint8_t>(std::clamp(distance, 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+				pixels[p * 4 + 3] = 255;
+			}
+
+			free(distances);
+			generatedBitmaps[i] = std::make_unique<Bitmap>(std::move(pixels), Vector2ui(static_cast<uint32_t>(size)), PixelFormat::R8G8B8A8Unorm);
+		}
+	};
+
+	// Generating a glyph only reads the font, so each is generated on its own pool thread.
+	if (auto resources = Resources::Get())
+		resources->GetThreadPool().ParallelFor(0, codepoints.size(), 1, generate);
+	else
+		generate(0, codepoints.size());
+
+	for (std::size_t i = 0; i < generated.size(); i++)
+		AddGlyph(generated[i], std::move(generatedBitmaps[i]));
+	cacheDirty = true;
+}
+
+void FontType::AddGlyph(Glyph glyph, std::unique_ptr<Bitmap> bitmap) {
+	auto index = static_cast<uint32_t>(glyphs.size());
+	glyph.hasImage = glyph.hasImage && bitmap;
+
+	auto &image = images.emplace_back();
+	image.bitmap = std::move(bitmap);
+	if (glyph.hasImage) {
+		image.pending = true;
+		pending.emplace_back(index);
 	}
 
-	return std::nullopt;
+	maxAdvance = std::max(maxAdvance, glyph.advance);
+	indices[glyph.codepoint] = index;
+	glyphs.emplace_back(glyph);
+}
+
+std::filesystem::path FontType::GetCacheFilename() const {
+	std::ostringstream name;
+	name << filename.stem().string() << '-' << size << '-' << std::hex << std::setw(16) << std::setfill('0') << fontHash << ".glyphs";
+	return CacheDirectory / name.str();
+}
+
+bool FontType::ReadCacheFile() {
+	if (CacheDirectory.empty())
+		return false;
+
+	auto cacheFilename = GetCacheFilename();
+	if (!std::filesystem::exists(cacheFilename))
+		return false;
+
+	auto file = Files::ReadAsync(cacheFilename).get();
+	return *file && ReadCache(file->GetData(), file->GetSize());
+}
+
+void FontType::WriteCacheFile(bool wait) {
+	cacheDirty = false;
+	if (CacheDirectory.empty() || glyphs.empty())
+		return;
+
+	// The glyphs are copied into memory here, so more can be added while the file is written.
+	std::ostringstream stream(std::ios::out | std::ios::binary);
+	WriteCache(stream);
+
+	auto write = [cacheFilename = GetCacheFilename(), data = stream.str()] {
+		std::error_code error;
+		std::filesystem::create_directories(cacheFilename.parent_path(), error);
+
+		std::ofstream os(cacheFilename, std::ios::out | std::ios::binary);
+		if (!os) {
+			Log::Warning("Font type cache ", cacheFilename, " could not be written\n");
+			return;
+		}
+
+		os.write(data.data(), static_cast<std::streamsize>(data.size()));
+	};
+
+	auto resources = Resources::Get();
+	if (wait || !resources) {
+		write();
+		return;
+	}
+
+	cacheWrite = resources->GetThreadPool().Enqueue(std::move(write));
+}
+
+bool FontType::ReadCache(const uint8_t *data, std::size_t length) {
+	if (length < sizeof(CacheHeader))
+		return false;
+
+	CacheHeader header;
+	std::memcpy(&header, data, sizeof(CacheHeader));
+	if (!std::equal(std::begin(CacheMagic), std::end(CacheMagic), header.magic) || header.version != CacheVersion || header.size != size ||
+		header.fontHash != fontHash || header.distanceRange != DistanceRange) {
+		return false;
+	}
+
+	auto pixelsLength = size * size * 4;
+	std::size_t imageCount = 0;
+	auto glyphsOffset = sizeof(CacheHeader);
+	if (header.glyphCount > (length - glyphsOffset) / sizeof(CacheGlyph))
+		return false;
+
+	std::vector<CacheGlyph> cacheGlyphs(header.glyphCount);
+	std::memcpy(cacheGlyphs.data(), data + glyphsOffset, cacheGlyphs.size() * sizeof(CacheGlyph));
+	for (const auto &cacheGlyph : cacheGlyphs)
+		imageCount += cacheGlyph.hasImage ? 1 : 0;
+
+	auto pixelsOffset = glyphsOffset + cacheGlyphs.size() * sizeof(CacheGlyph);
+	if (imageCount * pixelsLength > length - pixelsOffset)
+		return false;
+
+	for (const auto &cacheGlyph : cacheGlyphs) {
+		Glyph glyph;
+		glyph.codepoint = cacheGlyph.codepoint;
+		glyph.advance = cacheGlyph.advance;
+		glyph.offset = {cacheGlyph.offset[0], cacheGlyph.offset[1]};
+		glyph.hasImage = cacheGlyph.hasImage != 0;
+
+		std::unique_ptr<Bitmap> bitmap;
+		if (glyph.hasImage) {
+			auto pixels = std::make_unique<uint8_t[]>(pixelsLength);
+			std::memcpy(pixels.get(), data + pixelsOffset, pixelsLength);
+			pixelsOffset += pixelsLength;
+			bitmap = std::make_unique<Bitmap>(std::move(pixels), Vector2ui(static_cast<uint32_t>(size)), PixelFormat::R8G8B8A8Unorm);
+		}
+
+		if (indices.find(glyph.codepoint) == indices.end())
+			AddGlyph(glyph, std::move(bitmap));
+	}
+
+	return true;
+}
+
+void FontType::WriteCache(std::ostream &stream) const {
+	CacheHeader header = {};
+	std::copy(std::begin(CacheMagic), std::end(CacheMagic), header.magic);
+	header.version = CacheVersion;
+	header.size = static_cast<uint32_t>(size);
+	header.glyphCount = static_cast<uint32_t>(glyphs.size());
+	header.fontHash = fontHash;
+	header.distanceRange = DistanceRange;
+
+	std::vector<CacheGlyph> cacheGlyphs;
+	cacheGlyphs.reserve(glyphs.size());
+	for (const auto &glyph : glyphs)
+		cacheGlyphs.push_back({static_cast<uint32_t>(glyph.codepoint), glyph.advance, {glyph.offset.x, glyph.offset.y}, glyph.hasImage ? 1u : 0u});
+
+	stream.write(reinterpret_cast<const char *>(&header), sizeof(CacheHeader));
+	stream.write(reinterpret_cast<const char *>(cacheGlyphs.data()), static_cast<std::streamsize>(cacheGlyphs.size() * sizeof(CacheGlyph)));
+	for (std::size_t i = 0; i < glyphs.size(); i++) {
+		if (glyphs[i].hasImage)
+			stream.write(reinterpret_cast<const char *>(images[i].bitmap->GetData().get()), static_cast<std::streamsize>(images[i].bitmap->GetLength()));
+	}
 }
 }
@@ -1,31 +1,40 @@
 #pragma once
 
+#include <future>
+#include <limits>
+#include <unordered_map>
+
 #include "Resources/Resource.hpp"
-#include "Graphics/Images/Image2dArray.hpp"
-#include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Bitmaps/Bitmap.hpp"
+#include "Graphics/Images/TextureAtlas.hpp"
+
+struct stbtt_fontinfo;
 
 namespace acid {
-class Text;
+class MappedFile;
 
 /**
- * @brief Resource that is used when creating a font mesh.
+ * @brief Resource that generates multi-channel signed distance field glyphs from a font file into a texture atlas, used when creating text meshes.
+ * The common glyphs are generated in parallel when loaded and cached to disk for each font and size, other glyphs are generated when first used.
  */
 class ACID_EXPORT FontType : public Resource {
 public:
 	class Glyph {
 	public:
-		Glyph(int32_t leftBearing, int32_t advance, const Vector2i &i0, const Vector2i &i1) :
-			leftBearing(leftBearing),
-			advance(advance),
-			i0(i0),
-			i1(i1) {
-		}
-
-		int32_t leftBearing;
-		int32_t advance;
-		Vector2i i0, i1;
+		char32_t codepoint = 0;
+		/// The distance the pen moves after the glyph in pixels.
+		float advance = 0.0f;
+		/// The top left corner of the glyph image from the pen on the baseline in pixels, the image is as wide and high as the font size.
+		Vector2f offset;
+		/// If the glyph has a outline, glyphs without one such as spaces only move the pen.
+		bool hasImage = false;
 	};
-	
+
+	/// The distance across glyph images in pixels that distances from the outline are stored over, centered on the outline.
+	static constexpr float DistanceRange = 4.0f;
+	/// The glyph index of codepoints without a glyph, such as control characters.
+	static constexpr uint32_t NoGlyph = std::numeric_limits<uint32_t>::max();
+
 	/**
 	 * Creates a new font type, or finds one with the same values.
 	 * @param node The node to decode values from.
@@ -48,33 +57,149 @@ public:
 	 * @param load If this resource will be loaded immediately, otherwise {@link FontType#Load} can be called later.
 	 */
 	FontType(std::filesystem::path filename, std::size_t size = 24, bool load = true);
+	~FontType();
+
+	/**
+	 * Packs glyphs generated or evicted since the last update into the atlas and uploads them, and writes the cache on a resource thread if glyphs were added to it.
+	 * Called on the main thread by {@link Fonts} outside of recording, once for each update the font was drawn in.
+	 */
+	void Update();
+
+	/**
+	 * Finds the glyph of each codepoint, the glyphs not generated yet are generated in parallel.
+	 * @param codepoints The codepoints.
+	 * @param indices The list the glyph index of each codepoint is written to in the same order, or {@link FontType#NoGlyph}.
+	 */
+	void GetGlyphs(std::u32string_view codepoints, std::vector<uint32_t> &indices);
+
+	/**
+	 * Finds a generated glyph.
+	 * @param codepoint The codepoint.
+	 * @return The glyph, or no value if it has not been generated.
+	 */
+	std::optional<Glyph> GetGlyph(char32_t codepoint) const;
+
+	/**
+	 * Gets a glyph by its index.
+	 * @param index The glyph index, from {@link FontType#GetGlyphs}.
+	 * @return The glyph.
+	 */
+	const Glyph &GetGlyphAt(uint32_t index) const { return glyphs[index]; }
+
+	/**
+	 * Gets where the image of a glyph is in the atlas, the first call each update finds it in the atlas so it is not evicted while it is drawn.
+	 * A glyph not in the atlas is packed on the next update.
+	 * @param index The glyph index.
+	 * @return The region, or null if the glyph has no image or it is not in the atlas.
+	 */
+	const TextureAtlas::Region *GetRegion(uint32_t index);
 
-	std::optional<Glyph> GetGlyph(wchar_t ascii) const;
-	
 	std::type_index GetTypeIndex() const override { return typeid(FontType); }
 
 	const std::filesystem::path &GetFilename() const { return filename; }
-	const Image2dArray *GetImage() const { return image.get(); }
+	const Image2dArray *GetImage() const { return atlas.GetImage(); }
+	const TextureAtlas &GetAtlas() const { return atlas; }
 	std::size_t GetSize() const { return size; }
+	std::size_t GetGlyphCount() const { return glyphs.size(); }
+
+	/**
+	 * Gets the distance from the baseline to the top of the tallest glyphs in pixels.
+	 * @return The ascent.
+	 */
+	float GetAscent() const { return ascent; }
+
+	/**
+	 * Gets the distance between the baselines of lines in pixels.
+	 * @return The line height.
+	 */
+	float GetLineHeight() const { return lineHeight; }
 
 	float GetMaxHeight() const { return maxHeight; }
 	float GetMaxAdvance() const { return maxAdvance; }
 
+	/**
+	 * Gets the directory glyphs are cached in, when empty glyphs are not cached.
+	 * @return The cache directory.
+	 */
+	static const std::filesystem::path &GetCacheDirectory() { return CacheDirectory; }
+	static void SetCacheDirectory(const std::filesystem::path &cacheDirectory) { CacheDirectory = cacheDirectory; }
+
 	friend const Node &operator>>(const Node &node, FontType &fontType);
 	friend Node &operator<<(Node &node, const FontType &fontType);
 
+protected:
+	/**
+	 * Adds a glyph, glyphs with a image are packed into the atlas on the next update.
+	 * @param glyph The glyph.
+	 * @param bitmap The distance field of the glyph as 8 bit RGBA, or null if it has no image.
+	 */
+	void AddGlyph(Glyph glyph, std::unique_ptr<Bitmap> bitmap);
+
+	/**
+	 * Adds the glyphs in a cache that are not added yet, if the cache was written for the same font, size and distance range.
+	 * @param data The cache.
+	 * @param length The length of the cache in bytes.
+	 * @return If the cache was read.
+	 */
+	bool ReadCache(const uint8_t *data, std::size_t length);
+
+	/**
+	 * Writes every glyph into a cache.
+	 * @param stream The stream to write to.
+	 */
+	void WriteCache(std::ostream &stream) const;
+
+	float ascent = 0.0f, lineHeight = 0.0f;
+	float maxHeight = 0.0f, maxAdvance = 0.0f;
+
 private:
+	class GlyphImage {
+	public:
+		/// The distance field as 8 bit RGBA.
+		std::unique_ptr<Bitmap> bitmap;
+		std::optional<TextureAtlas::Region> region;
+		/// The update the region was last found in the atlas.
+		uint32_t foundUpdate = 0;
+		/// If the glyph is waiting to be packed into the atlas.
+		bool pending = false;
+	};
+
 	void Load();
+	void Generate(std::u32string_view codepoints);
+	std::filesystem::path GetCacheFilename() const;
+	bool ReadCacheFile();
+	/**
+	 * Writes the cache file from a copy of the glyphs.
+	 * @param wait If the file is written before returning, otherwise it is written on a resource thread.
+	 */
+	void WriteCacheFile(bool wait);
 
-	std::filesystem::path filename;
-	std::unique_ptr<Image2dArray> image;
+	inline static std::filesystem::path CacheDirectory = "Cache/Fonts";
 
-	/// Char to glyphs index.
-	std::map<wchar_t, std::size_t> indices;
-	std::vector<Glyph> glyphs;
+	std::filesystem::path filename;
 	/// Glyph size in pixels.
 	std::size_t size;
-	
-	float maxHeight = 0.0f, maxAdvance = 0.0f;
+
+	/// The font file, which stb_truetype reads glyphs from for as long as the font is loaded.
+	std::shared_ptr<const MappedFile> fontFile;
+	std::unique_ptr<stbtt_fontinfo> fontInfo;
+	uint64_t fontHash = 0;
+
+	std::vector<Glyph> glyphs;
+	std::vector<GlyphImage> images;
+	/// Codepoint to glyphs index.
+	std::unordered_map<char32_t, uint32_t> indices;
+	/// Glyphs waiting to be packed into the atlas on the next update.
+	std::vector<uint32_t> pending;
+	/// Codepoints not generated yet, reused between calls.
+	std::u32string missing;
+	bool cacheDirty = false;
+	std::future<void> cacheWrite;
+
+	TextureAtlas atlas;
+	/// Updates since the font was loaded, regions are found in the atlas once each update.
+	uint32_t updateCount = 0;
+	/// If glyphs have not fit in the atlas since every pending glyph last did, so the failure is only reported once.
+	bool packFailed = false;
 };
 }
@@ -0,0 +1,17 @@
+#include "Fonts.hpp"
+
+namespace acid {
+void Fonts::Update() {
+	for (auto &[key, fontType] : requested) {
+		if (auto locked = fontType.lock())
+			locked->Update();
+	}
+
+	requested.clear();
+}
+
+void Fonts::Request(const std::shared_ptr<FontType> &fontType) {
+	if (fontType)
+		requested.try_emplace(fontType.get(), fontType);
+}
+}
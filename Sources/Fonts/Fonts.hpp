@@ -0,0 +1,31 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Engine/Engine.hpp"
+#include "Graphics/Graphics.hpp"
+#include "FontType.hpp"
+
+namespace acid {
+/**
+ * @brief Module that updates the font types requested by texts, packing their new glyphs into their atlases and writing their caches.
+ * It is updated at the render rate outside of recording, so glyph uploads and cache writes never run while subrenders record their draws.
+ */
+class ACID_EXPORT Fonts : public Module::Registrar<Fonts> {
+	inline static const bool Registered = Register(Stage::Render, Requires<Graphics>());
+public:
+	Fonts() = default;
+
+	void Update() override;
+
+	/**
+	 * Requests a font type is updated before it is next drawn, called by texts each update. Called on the main thread.
+	 * @param fontType The font type.
+	 */
+	void Request(const std::shared_ptr<FontType> &fontType);
+
+private:
+	/// The font types requested since the last update.
+	std::unordered_map<const FontType *, std::weak_ptr<FontType>> requested;
+};
+}
@@ -6,17 +6,40 @@
 namespace acid {
 FontsSubrender::FontsSubrender(const Pipeline::Stage &pipelineStage) :
 	Subrender(pipelineStage),
-	pipeline(pipelineStage, {"Shaders/Fonts/Font.vert", "Shaders/Fonts/Font.frag"}, {VertexText::GetVertexInput()}) {
+	pipeline(pipelineStage, {"Shaders/Fonts/Font.vert", "Shaders/Fonts/Font.frag"}, {TextBatch::Vertex::GetVertexInput()}) {
 }
 
 void FontsSubrender::Render(const CommandBuffer &commandBuffer) {
+	batch.Clear();
+
+	for (const auto &object : texts.Update(Uis::Get()->GetEnabledObjects())) {
+		if (object->GetScreenAlpha() > 0.0f)
+			batch.AddText(*object);
+	}
+
+	batch.Build();
+	buffers.Update();
+
+	if (batch.GetIndices().empty())
+		return;
+
 	pipeline.BindPipeline(commandBuffer);
+	buffers.Bind(commandBuffer, batch.GetVertices(), batch.GetIndices());
+
+	for (const auto &command : batch.GetCommands()) {
+		const auto &font = batch.GetFonts()[command.font];
+		if (command.indexCount == 0 || !font->GetImage())
+			continue;
 
-	for (const auto &screenObject : Uis::Get()->GetObjects()) {
-		if (!screenObject->IsEnabled()) continue;
+		// The atlas image is pushed each render, as it is recreated when the atlas grows a layer.
+		auto &descriptorSet = buffers.GetDescriptorSet(font, pipeline);
+		descriptorSet.Push("samplerMsdf", font->GetImage());
+		if (!descriptorSet.Update(pipeline))
+			continue;
 
-		if (auto object = dynamic_cast<Text *>(screenObject))
-			object->CmdRender(commandBuffer, pipeline);
+		buffers.SetScissor(commandBuffer, command.scissor);
+		descriptorSet.BindDescriptor(commandBuffer, pipeline);
+		vkCmdDrawIndexed(commandBuffer, command.indexCount, 1, command.firstIndex, 0, 0);
 	}
 }
 }
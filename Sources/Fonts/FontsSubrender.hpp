@@ -1,16 +1,27 @@
 #pragma once
 
 #include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/BatchBuffers.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Uis/UiObjectFilter.hpp"
+#include "TextBatch.hpp"
 
 namespace acid {
+/**
+ * @brief Subrender that draws every text from one batch, drawn with a command for each font and scissor.
+ */
 class ACID_EXPORT FontsSubrender : public Subrender {
 public:
 	explicit FontsSubrender(const Pipeline::Stage &pipelineStage);
 
 	void Render(const CommandBuffer &commandBuffer) override;
 
+	const TextBatch &GetBatch() const { return batch; }
+
 private:
 	PipelineGraphics pipeline;
+	TextBatch batch;
+	UiObjectFilter<Text> texts;
+	BatchBuffers buffers;
 };
 }
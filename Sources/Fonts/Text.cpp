@@ -1,45 +1,55 @@
 #include "Text.hpp"
 
-#include "Models/Shapes/RectangleModel.hpp"
+#include "Fonts.hpp"
 
 namespace acid {
-void Text::UpdateObject() {
-	dirty |= GetScreenSize() != lastSize;
-	if (dirty)
-		LoadText();
+/// The spaces a tab is laid out as.
+static constexpr uint32_t TabSpaces = 4;
+/// The smallest codepoint encoded with each sequence length, smaller codepoints are overlong.
+static constexpr char32_t MinCodepoints[5] = {0, 0, 0x80, 0x800, 0x10000};
+
+void Text::DecodeUtf8(std::string_view string, std::u32string &codepoints) {
+	codepoints.clear();
+
+	for (std::size_t i = 0; i < string.size();) {
+		auto c = static_cast<uint8_t>(string[i]);
+		uint32_t length = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xe ? 3 : (c >> 3) == 0x1e ? 4 : 0;
+
+		char32_t codepoint = length == 1 ? c : c & (0x7f >> length);
+		auto valid = length != 0 && i + length <= string.size();
+		for (uint32_t j = 1; valid && j < length; j++) {
+			auto next = static_cast<uint8_t>(string[i + j]);
+			valid = (next & 0xc0) == 0x80;
+			codepoint = (codepoint << 6) | (next & 0x3f);
+		}
 
-	// Updates uniforms.
-	uniformObject.Push("modelView", GetModelView());
-	uniformObject.Push("alpha", GetScreenAlpha());
+		// Overlong forms, surrogates and codepoints past U+10FFFF are ill-formed, which also rejects every sequence with a lead from 0xf5.
+		valid = valid && codepoint >= MinCodepoints[length] && codepoint <= 0x10ffff && (codepoint < 0xd800 || codepoint > 0xdfff);
+
+		if (!valid) {
+			codepoints.push_back(0xfffd);
+			i++;
+			continue;
+		}
 
-	uniformObject.Push("colour", textColour);
-	uniformObject.Push("scale", 0.5f * GetScreenSize().x / (float)fontType->GetSize());
+		i += length;
+		if (codepoint == '\t')
+			codepoints.append(TabSpaces, ' ');
+		else if (codepoint == '\n' || codepoint >= 0x20)
+			codepoints.push_back(codepoint);
+	}
 }
 
-bool Text::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline) {
-	// Gets if this should be rendered.
-	/*if (!model || !fontType || !IsEnabled())
-		return false;
-
-	// Updates descriptors.
-	descriptorSet.Push("UniformObject", uniformObject);
-	descriptorSet.Push("samplerMsdf", fontType->GetImage());
-
-	if (!descriptorSet.Update(pipeline))
-		return false;
-
-	auto scissor = GetScissor();
-	VkRect2D scissorRect = {};
-	scissorRect.offset.x = scissor ? static_cast<int32_t>(scissor->x) : 0;
-	scissorRect.offset.y = scissor ? static_cast<int32_t>(scissor->y) : 0;
-	scissorRect.extent.width = scissor ? static_cast<int32_t>(scissor->z) : Window::Get()->GetSize().x;
-	scissorRect.extent.height = scissor ? static_cast<int32_t>(scissor->w) : Window::Get()->GetSize().y;
-	vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
-
-	// Draws the object.
-	descriptorSet.BindDescriptor(commandBuffer, pipeline);
-	return model->CmdRender(commandBuffer);*/
-	return false;
+void Text::UpdateObject() {
+	dirty |= GetScreenSize() != lastSize;
+	if (dirty) {
+		lastSize = GetScreenSize();
+		LoadText(static_cast<float>(lastSize.x));
+	}
+
+	// The font packs glyphs laid out this update into its atlas before they are drawn.
+	if (auto fonts = Fonts::Get())
+		fonts->Request(fontType);
 }
 
 void Text::SetFontSize(float fontSize) {
@@ -68,175 +78,114 @@ void Text::SetLeading(float leading) {
 }
 
 void Text::SetFontType(const std::shared_ptr<FontType> &fontType) {
-	dirty |= this->fontType == fontType;
+	dirty |= this->fontType != fontType;
 	this->fontType = fontType;
 }
 
 bool Text::IsLoaded() const {
-	return !string.empty() && model;
+	return !quads.empty();
 }
 
-void Text::LoadText() {
-/*#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif*/
-
-	if (string.empty()) {
-		model = nullptr;
-		return;
-	}
-
-	lastSize = GetScreenSize();
-	
-	// Creates mesh data.
-	auto lines = CreateStructure();
-	numberLines = static_cast<uint32_t>(lines.size());
-	auto vertices = CreateQuad(lines);
-
-	vertices.emplace_back(Vector2f(0.0f, 1.0f), Vector3f(0.0f, 0.0f, 0.0f));
-	vertices.emplace_back(Vector2f(0.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f));
-	vertices.emplace_back(Vector2f(1.0f, 0.0f), Vector3f(1.0f, 1.0f, 0.0f));
-	vertices.emplace_back(Vector2f(0.0f, 1.0f), Vector3f(0.0f, 0.0f, 0.0f));
-	vertices.emplace_back(Vector2f(1.0f, 0.0f), Vector3f(1.0f, 1.0f, 0.0f));
-	vertices.emplace_back(Vector2f(1.0f, 1.0f), Vector3f(1.0f, 0.0f, 0.0f));
-
-	// Loads the mesh data.
-	model = std::make_unique<Model>(vertices);
+void Text::LoadText(float maxWidth) {
 	dirty = false;
+	quads.clear();
+	quadWords.clear();
+	numberLines = 0;
 
-/*#if defined(ACID_DEBUG)
-	Log::Out("Text mesh with ", string.length(), " chars created in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
-#endif*/
-}
-
-std::vector<Text::Line> Text::CreateStructure() const {
-	/*auto maxLength = lastSize.x;// / fontSize * fontType->GetMetafile()->GetMaxAdvance();
-
-	std::vector<Line> lines;
-	Line currentLine(fontType->GetSpaceWidth(), maxLength);
-	Word currentWord;
+	if (string.empty() || !fontType)
+		return;
 
-	auto formattedText = String::ReplaceAll(string, "\t", "	");
-	auto textLines = String::Split(formattedText, '\n');
+	DecodeUtf8(string, codepoints);
+	fontType->GetGlyphs(codepoints, glyphIndices);
+
+	auto scale = GetGlyphScale();
+	auto advance = [&](std::size_t i) {
+		return glyphIndices[i] == FontType::NoGlyph ? 0.0f : fontType->GetGlyphAt(glyphIndices[i]).advance * scale + kerning;
+	};
+
+	auto baseline = fontType->GetAscent() * scale;
+	auto pendingSpace = 0.0f;
+	Line line = {};
+
+	auto completeLine = [&](bool wrapped) {
+		line.quadCount = static_cast<uint32_t>(quads.size()) - line.firstQuad;
+		line.wrapped = wrapped;
+		JustifyLine(line, maxWidth);
+
+		numberLines++;
+		baseline += fontType->GetLineHeight() * scale + leading;
+		pendingSpace = 0.0f;
+		line = {static_cast<uint32_t>(quads.size()), 0, 0, 0.0f, false};
+	};
+
+	for (std::size_t i = 0; i < codepoints.size();) {
+		if (codepoints[i] == '\n') {
+			completeLine(false);
+			i++;
+			continue;
+		}
 
-	for (uint32_t i = 0; i < textLines.size(); i++) {
-		if (textLines.at(i).empty()) {
+		if (codepoints[i] == ' ') {
+			pendingSpace += advance(i);
+			i++;
 			continue;
 		}
 
-		for (const auto &c : textLines.at(i)) {
-			auto ascii = static_cast<int32_t>(c);
+		// Words are moved onto the next line when they would pass the width, unless they are the first on their line.
+		auto end = i;
+		auto wordWidth = 0.0f;
+		for (; end < codepoints.size() && codepoints[end] != ' ' && codepoints[end] != '\n'; end++)
+			wordWidth += advance(end);
 
-			if (ascii == FontType::SpaceAscii) {
-				if (!currentLine.AddWord(currentWord)) {
-					lines.emplace_back(currentLine);
-					currentLine = {fontType->GetSpaceWidth(), maxLength};
-					currentLine.AddWord(currentWord);
-				}
+		if (line.wordCount > 0 && maxWidth > 0.0f && line.width + pendingSpace + wordWidth > maxWidth)
+			completeLine(true);
 
-				currentWord = {};
+		auto penX = line.width + pendingSpace;
+		for (; i < end; i++) {
+			if (glyphIndices[i] == FontType::NoGlyph)
 				continue;
-			}
-
-			if (auto character = fontType->GetCharacter(ascii)) {
-				currentWord.AddCharacter(*character, kerning);
-			}
-		}
-
-		if (i != textLines.size() - 1) {
-			auto wordAdded = currentLine.AddWord(currentWord);
-			lines.emplace_back(currentLine);
-			currentLine = {fontType->GetSpaceWidth(), maxLength};
 
-			if (!wordAdded) {
-				currentLine.AddWord(currentWord);
+			const auto &glyph = fontType->GetGlyphAt(glyphIndices[i]);
+			if (glyph.hasImage) {
+				quads.push_back({Vector2f(penX, baseline) + glyph.offset * scale, glyphIndices[i]});
+				quadWords.emplace_back(line.wordCount);
 			}
 
-			currentWord = {};
+			penX += advance(i);
 		}
-	}
-
-	CompleteStructure(lines, currentLine, currentWord, maxLength);
-	return lines;*/
-	return {};
-}
 
-void Text::CompleteStructure(std::vector<Line> &lines, Line &currentLine, const Word &currentWord, float maxLength) const {
-	/*auto added = currentLine.AddWord(currentWord);
-
-	if (!added) {
-		lines.emplace_back(currentLine);
-		currentLine = {fontType->GetSpaceWidth(), maxLength};
-		currentLine.AddWord(currentWord);
+		line.width = penX;
+		line.wordCount++;
+		pendingSpace = 0.0f;
 	}
 
-	lines.emplace_back(currentLine);*/
+	completeLine(false);
 }
 
-std::vector<VertexText> Text::CreateQuad(const std::vector<Line> &lines) const {
-	/*std::vector<VertexText> vertices;
-
-	float cursorX = 0.0f;
-	float cursorY = 0.0f;
-	auto lineOrder = static_cast<int32_t>(lines.size());
-
-	for (const auto &line : lines) {
-		switch (justify) {
-		case Justify::Left:
-			cursorX = 0.0f;
-			break;
-		case Justify::Centre:
-			cursorX = (line.maxLength - line.currentLineLength) / 2.0f;
-			break;
-		case Justify::Right:
-			cursorX = line.maxLength - line.currentLineLength;
-			break;
-		case Justify::Fully:
-			cursorX = 0.0f;
-			break;
-		}
-
-		for (const auto &word : line.words) {
-			for (const auto &letter : word.glyphs) {
-				AddVerticesForGlyph(cursorX, cursorY, letter, vertices);
-				cursorX += kerning + letter.advance;
-			}
-
-			if (justify == Justify::Fully && lineOrder > 1) {
-				cursorX += (line.maxLength - line.currentWordsLength) / line.words.size();
-			} else {
-				cursorX += fontType->GetSpaceWidth();
-			}
-		}
+void Text::JustifyLine(const Line &line, float maxWidth) {
+	if (maxWidth <= 0.0f)
+		return;
 
-		cursorY += leading + FontType::LineHeight;
-		lineOrder--;
+	auto offset = 0.0f;
+	auto wordGap = 0.0f;
+
+	switch (justify) {
+	case Justify::Left:
+		break;
+	case Justify::Centre:
+		offset = (maxWidth - line.width) / 2.0f;
+		break;
+	case Justify::Right:
+		offset = maxWidth - line.width;
+		break;
+	case Justify::Fully:
+		// Only lines that wrapped are stretched, so the last line of a paragraph keeps its spacing.
+		if (line.wrapped && line.wordCount > 1)
+			wordGap = (maxWidth - line.width) / static_cast<float>(line.wordCount - 1);
+		break;
 	}
 
-	return vertices;*/
-	return {};
-}
-
-void Text::AddVerticesForGlyph(float cursorX, float cursorY, const FontType::Glyph &glyph, std::vector<VertexText> &vertices) {
-	/*auto vertexX = cursorX + glyph.offsetX;
-	auto vertexY = cursorY + glyph.offsetY;
-	auto vertexMaxX = vertexX + glyph.sizeX;
-	auto vertexMaxY = vertexY + glyph.sizeY;
-
-	auto textureX = glyph.textureCoordX;
-	auto textureY = glyph.textureCoordY;
-	auto textureMaxX = glyph.maxTextureCoordX;
-	auto textureMaxY = glyph.maxTextureCoordY;
-
-	AddVertex(vertexX, vertexY, textureX, textureY, vertices);
-	AddVertex(vertexMaxX, vertexY, textureMaxX, textureY, vertices);
-	AddVertex(vertexMaxX, vertexMaxY, textureMaxX, textureMaxY, vertices);
-	AddVertex(vertexMaxX, vertexMaxY, textureMaxX, textureMaxY, vertices);
-	AddVertex(vertexX, vertexMaxY, textureX, textureMaxY, vertices);
-	AddVertex(vertexX, vertexY, textureX, textureY, vertices);*/
-}
-
-void Text::AddVertex(float vx, float vy, float tx, float ty, std::vector<VertexText> &vertices) {
-	vertices.emplace_back(VertexText({vx, vy}, {tx, ty, 0.0f}));
+	for (auto i = line.firstQuad; i < line.firstQuad + line.quadCount; i++)
+		quads[i].position.x += offset + wordGap * static_cast<float>(quadWords[i]);
 }
 }
@@ -2,52 +2,14 @@
 
 #include "Maths/Colour.hpp"
 #include "Maths/Vector2.hpp"
-#include "Uis/Drivers/UiDriver.hpp"
-#include "Models/Model.hpp"
-#include "Models/Vertex2d.hpp"
-#include "Graphics/Descriptors/DescriptorsHandler.hpp"
-#include "Graphics/Buffers/UniformHandler.hpp"
-#include "Graphics/Pipelines/PipelineGraphics.hpp"
 #include "Uis/UiObject.hpp"
 #include "FontType.hpp"
 
 namespace acid {
-class ACID_EXPORT VertexText {
-public:
-	VertexText() = default;
-	VertexText(const Vector2f &position, const Vector3f &uv) :
-		position(position),
-		uv(uv) {
-	}
-
-	static Shader::VertexInput GetVertexInput(uint32_t baseBinding = 0) {
-		std::vector<VkVertexInputBindingDescription> bindingDescriptions = {
-			{baseBinding, sizeof(VertexText), VK_VERTEX_INPUT_RATE_VERTEX}
-		};
-		std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
-			{0, baseBinding, VK_FORMAT_R32G32_SFLOAT, offsetof(VertexText, position)},
-			{1, baseBinding, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexText, uv)}
-		};
-		return {bindingDescriptions, attributeDescriptions};
-	}
-
-	bool operator==(const VertexText &rhs) const {
-		return position == rhs.position && uv == rhs.uv;
-	}
-
-	bool operator!=(const VertexText &rhs) const {
-		return !operator==(rhs);
-	}
-
-	Vector2f position;
-	Vector3f uv;
-};
-
 /**
- * @brief Class that represents a text in a GUI.
+ * @brief Class that represents a text in a GUI. The glyphs are laid out when the text or its size changes, and drawn by {@link TextBatch} with all text of the same font.
  */
 class ACID_EXPORT Text : public UiObject {
-	friend class FontType;
 public:
 	/**
 	 * @brief A enum that represents how the text will be justified.
@@ -56,17 +18,32 @@ public:
 		Left, Centre, Right, Fully
 	};
 
+	/**
+	 * @brief Class that represents a glyph placed in the text.
+	 */
+	class Quad {
+	public:
+		/// The top left corner in pixels from the top left of the object, the quad is {@link Text#GetGlyphScale} times the font type size.
+		Vector2f position;
+		/// The glyph index in the font type.
+		uint32_t glyph;
+	};
+
 	Text() = default;
 
 	void UpdateObject() override;
 
-	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline);
+	/**
+	 * Gets the glyphs placed by the latest layout.
+	 * @return The quads.
+	 */
+	const std::vector<Quad> &GetQuads() const { return quads; }
 
 	/**
-	 * Gets the text model, which contains all the vertex data for the quads on which the text will be rendered.
-	 * @return The model of the text.
+	 * Gets the scale from the glyph images of the font type to the font size.
+	 * @return The glyph scale.
 	 */
-	const Model *GetModel() const { return model.get(); }
+	float GetGlyphScale() const { return fontType ? fontSize / static_cast<float>(fontType->GetSize()) : 0.0f; }
 
 	/**
 	 * Gets the font size.
@@ -111,25 +88,25 @@ public:
 	void SetJustify(Justify justify);
 
 	/**
-	 * Gets the kerning (type character spacing multiplier) of this text.
+	 * Gets the kerning (extra spacing after each character in pixels) of this text.
 	 * @return The type kerning.
 	 */
 	float GetKerning() const { return kerning; }
 
 	/**
-	 * Sets the kerning (type character spacing multiplier) of this text.
+	 * Sets the kerning (extra spacing after each character in pixels) of this text.
 	 * @param kerning The new kerning.
 	 */
 	void SetKerning(float kerning);
 
 	/**
-	 * Gets the leading (vertical line spacing multiplier) of this text.
+	 * Gets the leading (extra vertical spacing between lines in pixels) of this text.
 	 * @return The line leading.
 	 */
 	float GetLeading() const { return leading; }
 
 	/**
-	 * Sets the leading (vertical line spacing multiplier) of this text.
+	 * Sets the leading (extra vertical spacing between lines in pixels) of this text.
 	 * @param leading The new leading.
 	 */
 	void SetLeading(float leading);
@@ -159,97 +136,48 @@ public:
 	void SetTextColour(const Colour &textColour) { this->textColour = textColour; }
 
 	/**
-	 * Gets if the text has been loaded to a model.
-	 * @return If the text has been loaded to a model.
+	 * Gets if the text has been laid out into quads.
+	 * @return If the text has been laid out.
 	 */
 	bool IsLoaded() const;
 
-private:
 	/**
-	 * During the loading of a text this represents one word in the text.
+	 * Decodes a UTF-8 string, ill-formed sequences are replaced with the replacement character a byte at a time.
+	 * Overlong forms, surrogates and codepoints past U+10FFFF are ill-formed. Tabs are expanded into spaces, and control characters other than new lines are skipped.
+	 * @param string The UTF-8 string.
+	 * @param codepoints The list to write the codepoints to.
 	 */
-	class Word {
-	public:
-		/**
-		 * Creates a new text word.
-		 */
-		Word() = default;
-
-		/**
-		 * Adds a glyph to the end of the current word and increases the screen-space width of the word.
-		 * @param glyph The glyph to be added.
-		 * @param kerning The glyph kerning.
-		 */
-		void AddCharacter(const FontType::Glyph &glyph, float kerning) {
-			glyphs.emplace_back(glyph);
-			width += kerning + glyph.advance;
-		}
-
-		std::vector<FontType::Glyph> glyphs;
-		float width = 0.0f;
-	};
+	static void DecodeUtf8(std::string_view string, std::u32string &codepoints);
 
+protected:
 	/**
-	 * Represents a line of text during the loading of a text.
+	 * Lays out the glyphs of the string, reusing the memory of the previous layout.
+	 * @param maxWidth The width in pixels lines are wrapped and justified across, or zero to not wrap.
 	 */
+	void LoadText(float maxWidth);
+
+private:
 	class Line {
 	public:
-		/**
-		 * Creates a new text line.
-		 * @param spaceWidth The screen-space width of a space character.
-		 * @param maxLength The screen-space maximum length of a line.
-		 */
-		Line(float spaceWidth, float maxLength) :
-			maxLength(maxLength),
-			spaceSize(spaceWidth) {
-		}
-
-		/**
-		 * Attempt to add a word to the line. If the line can fit the word in without reaching the maximum line length then the word is added and the line length increased.
-		 * @param word The word to try to add.
-		 * @return {@code true} if the word has successfully been added to the line.
-		 */
-		bool AddWord(const Word &word) {
-			auto additionalLength = word.width;
-			additionalLength += !words.empty() ? spaceSize : 0.0f;
-
-			if (currentLineLength + additionalLength <= maxLength) {
-				words.emplace_back(word);
-				currentWordsLength += word.width;
-				currentLineLength += additionalLength;
-				return true;
-			}
-
-			return false;
-		}
-
-		float maxLength;
-		float spaceSize;
-
-		std::vector<Word> words;
-		float currentWordsLength = 0.0f;
-		float currentLineLength = 0.0f;
+		uint32_t firstQuad;
+		uint32_t quadCount;
+		uint32_t wordCount;
+		float width;
+		/// If the line ended by running out of width, rather than at a new line or the end of the string.
+		bool wrapped;
 	};
 
-	/**
-	 * Takes in an unloaded text and calculate all of the vertices for the quads on which this text will be rendered.
-	 * The vertex positions and texture coords and calculated based on the information from the font file.
-	 * Then takes the information about the vertices of all the quads and stores it in a model.
-	 */
-	void LoadText();
-	std::vector<Line> CreateStructure() const;
-	void CompleteStructure(std::vector<Line> &lines, Line &currentLine, const Word &currentWord, float maxLength) const;
-	std::vector<VertexText> CreateQuad(const std::vector<Line> &lines) const;
-	static void AddVerticesForGlyph(float cursorX, float cursorY, const FontType::Glyph &glyph, std::vector<VertexText> &vertices);
-	static void AddVertex(float vx, float vy, float tx, float ty, std::vector<VertexText> &vertices);
+	void JustifyLine(const Line &line, float maxWidth);
 
-	DescriptorsHandler descriptorSet;
-	UniformHandler uniformObject;
-
-	std::unique_ptr<Model> model;
+	std::vector<Quad> quads;
 	uint32_t numberLines = 0;
 	Vector2i lastSize;
 
+	/// Buffers the layout reuses.
+	std::u32string codepoints;
+	std::vector<uint32_t> glyphIndices;
+	std::vector<uint32_t> quadWords;
+
 	float fontSize = 12;
 	std::string string;
 	Justify justify = Justify::Left;
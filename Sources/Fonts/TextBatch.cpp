@@ -0,0 +1,101 @@
+#include "TextBatch.hpp"
+
+#include <algorithm>
+
+#include "Text.hpp"
+
+namespace acid {
+void TextBatch::Clear() {
+	texts.clear();
+	fonts.clear();
+	fontIndices.clear();
+}
+
+void TextBatch::AddText(const Text &text) {
+	const auto &fontType = text.GetFontType();
+	if (!fontType || text.GetQuads().empty())
+		return;
+
+	if (auto [it, inserted] = fontIndices.try_emplace(fontType.get(), static_cast<uint32_t>(fonts.size())); inserted)
+		fonts.emplace_back(fontType);
+
+	texts.emplace_back(&text);
+}
+
+void TextBatch::Build() {
+	vertices.clear();
+	indices.clear();
+	commands.clear();
+	batches.clear();
+
+	for (auto text : texts) {
+		auto font = fontIndices[text->GetFontType().get()];
+		auto it = std::find_if(batches.begin(), batches.end(), [&](const Batch &batch) {
+			return batch.font == font && batch.scissor == text->GetScissor();
+		});
+
+		if (it == batches.end()) {
+			auto &batch = batches.emplace_back();
+			batch.font = font;
+			batch.scissor = text->GetScissor();
+			it = batches.end() - 1;
+		}
+
+		it->texts.emplace_back(text);
+	}
+
+	commands.reserve(batches.size());
+
+	for (const auto &batch : batches) {
+		auto &command = commands.emplace_back();
+		command.font = batch.font;
+		command.scissor = batch.scissor;
+		command.firstIndex = static_cast<uint32_t>(indices.size());
+
+		for (auto text : batch.texts)
+			AddQuads(*text);
+
+		command.indexCount = static_cast<uint32_t>(indices.size()) - command.firstIndex;
+	}
+}
+
+void TextBatch::AddQuads(const Text &text) {
+	auto screenSize = text.GetScreenSize();
+	if (screenSize.x <= 0 || screenSize.y <= 0)
+		return;
+
+	auto &fontType = *text.GetFontType();
+	auto glyphSize = text.GetGlyphScale() * static_cast<float>(fontType.GetSize());
+
+	// The model view is linear, so corners are the clip space origin of the object plus steps along its axes instead of a transform each.
+	const auto &modelView = text.GetModelView();
+	auto origin = modelView.Transform(Vector4f(0.0f, 0.0f, 0.0f, 1.0f));
+	auto axisX = (modelView.Transform(Vector4f(1.0f, 0.0f, 0.0f, 1.0f)) - origin) / static_cast<float>(screenSize.x);
+	auto axisY = (modelView.Transform(Vector4f(0.0f, 1.0f, 0.0f, 1.0f)) - origin) / static_cast<float>(screenSize.y);
+
+	auto colour = text.GetTextColour();
+	colour.a *= text.GetScreenAlpha();
+	auto distanceScale = FontType::DistanceRange * text.GetGlyphScale();
+
+	for (const auto &quad : text.GetQuads()) {
+		auto region = fontType.GetRegion(quad.glyph);
+		if (!region)
+			continue;
+
+		auto min = region->Remap({0.0f, 0.0f}), max = region->Remap({1.0f, 1.0f});
+		auto layer = static_cast<float>(region->layer);
+
+		const Vector2f corners[4] = {{0.0f, 0.0f}, {glyphSize, 0.0f}, {glyphSize, glyphSize}, {0.0f, glyphSize}};
+		const Vector3f uvs[4] = {{min.x, min.y, layer}, {max.x, min.y, layer}, {max.x, max.y, layer}, {min.x, max.y, layer}};
+
+		auto first = static_cast<uint32_t>(vertices.size());
+		for (uint32_t i = 0; i < 4; i++) {
+			auto position = origin + axisX * (quad.position.x + corners[i].x) + axisY * (quad.position.y + corners[i].y);
+			vertices.push_back({Vector3f(position), uvs[i], colour, distanceScale});
+		}
+
+		for (auto corner : {0, 1, 2, 2, 3, 0})
+			indices.emplace_back(first + corner);
+	}
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Maths/Colour.hpp"
+#include "Maths/Vector4.hpp"
+#include "Graphics/Pipelines/Shader.hpp"
+#include "FontType.hpp"
+
+namespace acid {
+class Text;
+
+/**
+ * @brief Class that collects the texts of each frame and builds their glyph quads into one vertex and index list, drawn with a command per font and scissor.
+ * Texts with the same font and scissor are drawn together in the order they were added, as glyphs of every text in a font sample the same atlas.
+ */
+class ACID_EXPORT TextBatch {
+public:
+	class Vertex {
+	public:
+		static Shader::VertexInput GetVertexInput(uint32_t baseBinding = 0) {
+			std::vector<VkVertexInputBindingDescription> bindingDescriptions = {
+				{baseBinding, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX}
+			};
+			std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
+				{0, baseBinding, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position)},
+				{1, baseBinding, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, uv)},
+				{2, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex, colour)},
+				{3, baseBinding, VK_FORMAT_R32_SFLOAT, offsetof(Vertex, distanceScale)}
+			};
+			return {bindingDescriptions, attributeDescriptions};
+		}
+
+		/// The position in clip space.
+		Vector3f position;
+		/// The coordinate in the atlas, with the layer as z.
+		Vector3f uv;
+		Colour colour;
+		/// The screen pixels across the distance range of the glyph images, sharpening the outline to a pixel.
+		float distanceScale;
+	};
+
+	class DrawCommand {
+	public:
+		/// The index into {@link TextBatch#GetFonts}.
+		uint32_t font;
+		std::optional<Vector4i> scissor;
+		uint32_t firstIndex;
+		uint32_t indexCount;
+	};
+
+	/**
+	 * Removes all texts, keeping the memory of the lists.
+	 */
+	void Clear();
+
+	/**
+	 * Adds a text, texts without a font or glyphs are skipped.
+	 * @param text The text, which must live until the batch is built.
+	 */
+	void AddText(const Text &text);
+
+	/**
+	 * Builds the vertices, indices and draw commands.
+	 * Glyphs not in their atlas are skipped, and packed into it on the next update of their font.
+	 */
+	void Build();
+
+	std::size_t GetTextCount() const { return texts.size(); }
+	const std::vector<Vertex> &GetVertices() const { return vertices; }
+	const std::vector<uint32_t> &GetIndices() const { return indices; }
+	const std::vector<DrawCommand> &GetCommands() const { return commands; }
+	const std::vector<std::shared_ptr<FontType>> &GetFonts() const { return fonts; }
+
+private:
+	class Batch {
+	public:
+		uint32_t font;
+		std::optional<Vector4i> scissor;
+		std::vector<const Text *> texts;
+	};
+
+	void AddQuads(const Text &text);
+
+	std::vector<const Text *> texts;
+	std::vector<std::shared_ptr<FontType>> fonts;
+	std::unordered_map<const FontType *, uint32_t> fontIndices;
+	std::vector<Batch> batches;
+
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<DrawCommand> commands;
+};
+}
@@ -0,0 +1,83 @@
+#include "BatchBuffers.hpp"
+
+#include <cstring>
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid {
+BatchBuffers::~BatchBuffers() {
+	ClearFrames();
+}
+
+void BatchBuffers::Update() {
+	for (auto it = descriptorSets.begin(); it != descriptorSets.end();) {
+		if (++it->second.unusedRenders > EvictRenders)
+			it = descriptorSets.erase(it);
+		else
+			++it;
+	}
+}
+
+void BatchBuffers::SetScissor(const CommandBuffer &commandBuffer, const std::optional<Vector4i> &scissor) {
+	auto windowSize = Window::Get()->GetSize();
+
+	VkRect2D scissorRect = {};
+	scissorRect.offset.x = scissor ? scissor->x : 0;
+	scissorRect.offset.y = scissor ? scissor->y : 0;
+	scissorRect.extent.width = scissor ? static_cast<uint32_t>(scissor->z) : windowSize.x;
+	scissorRect.extent.height = scissor ? static_cast<uint32_t>(scissor->w) : windowSize.y;
+	if (lastScissor && std::memcmp(&*lastScissor, &scissorRect, sizeof(VkRect2D)) == 0)
+		return;
+
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
+	lastScissor = scissorRect;
+}
+
+void BatchBuffers::Bind(const CommandBuffer &commandBuffer, const void *vertices, VkDeviceSize verticesSize, const std::vector<uint32_t> &indices) {
+	// Buffers are kept for each frame in flight, the previous frame with this index has finished reading them.
+	auto graphics = Graphics::Get();
+	if (frames.size() != graphics->GetFrameCount()) {
+		ClearFrames();
+		frames.resize(graphics->GetFrameCount());
+	}
+
+	auto &frame = frames[graphics->GetCurrentFrame()];
+	Reserve(frame.vertexBuffer, frame.vertices, verticesSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	Reserve(frame.indexBuffer, frame.indices, indices.size() * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+	std::memcpy(frame.vertices, vertices, static_cast<std::size_t>(verticesSize));
+	std::memcpy(frame.indices, indices.data(), indices.size() * sizeof(uint32_t));
+
+	VkBuffer vertexBuffers[] = {frame.vertexBuffer->GetBuffer()};
+	VkDeviceSize offsets[] = {0};
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+	vkCmdBindIndexBuffer(commandBuffer, frame.indexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+	// The scissor of the command buffer is not known until one is set after binding.
+	lastScissor = std::nullopt;
+}
+
+void BatchBuffers::ClearFrames() {
+	for (auto &frame : frames) {
+		if (frame.vertexBuffer)
+			frame.vertexBuffer->UnmapMemory();
+		if (frame.indexBuffer)
+			frame.indexBuffer->UnmapMemory();
+	}
+	frames.clear();
+}
+
+void BatchBuffers::Reserve(std::unique_ptr<Buffer> &buffer, void *&mapped, VkDeviceSize size, VkBufferUsageFlags usage) {
+	if (buffer && buffer->GetSize() >= size)
+		return;
+
+	auto capacity = MinBufferSize;
+	while (capacity < size)
+		capacity *= 2;
+
+	if (buffer)
+		buffer->UnmapMemory();
+
+	buffer = std::make_unique<Buffer>(capacity, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	buffer->MapMemory(&mapped);
+}
+}
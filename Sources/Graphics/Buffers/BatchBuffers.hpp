@@ -0,0 +1,89 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Maths/Vector4.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Utils/NonCopyable.hpp"
+#include "Buffer.hpp"
+
+namespace acid {
+/**
+ * @brief Class that holds what a subrender needs to draw a batch built each frame. Vertices and indices are written into buffers kept mapped for each frame in flight,
+ * grown to the next power of two when needed, and a descriptor set is kept for each object drawn until frames in flight are done with it.
+ */
+class ACID_EXPORT BatchBuffers : NonCopyable {
+public:
+	BatchBuffers() = default;
+	~BatchBuffers();
+
+	/**
+	 * Drops the descriptor sets of objects no longer drawn, called once each render before any are used.
+	 */
+	void Update();
+
+	/**
+	 * Writes vertices and indices into the buffers of the current frame and binds them.
+	 * @tparam T The type of vertex.
+	 * @param commandBuffer The command buffer to bind to.
+	 * @param vertices The vertices.
+	 * @param indices The indices into the vertices.
+	 */
+	template<typename T>
+	void Bind(const CommandBuffer &commandBuffer, const std::vector<T> &vertices, const std::vector<uint32_t> &indices) {
+		Bind(commandBuffer, vertices.data(), vertices.size() * sizeof(T), indices);
+	}
+
+	/**
+	 * Gets the descriptor set kept for a object, it is kept alive while frames in flight may be drawing it.
+	 * @tparam T The type of object.
+	 * @param object The object drawn.
+	 * @param pipeline The pipeline the descriptor set is created for.
+	 * @return The descriptor set.
+	 */
+	template<typename T>
+	DescriptorsHandler &GetDescriptorSet(const std::shared_ptr<T> &object, const Pipeline &pipeline) {
+		auto it = descriptorSets.find(object.get());
+		if (it == descriptorSets.end())
+			it = descriptorSets.emplace(object.get(), ObjectDescriptors{object, DescriptorsHandler(pipeline)}).first;
+		it->second.unusedRenders = 0;
+		return it->second.descriptorSet;
+	}
+
+	/**
+	 * Sets the scissor of the draws that follow, skipped when it matches the scissor set since the buffers were last bound.
+	 * @param commandBuffer The command buffer to set the scissor in.
+	 * @param scissor The scissor in pixels, or no value to draw across the window.
+	 */
+	void SetScissor(const CommandBuffer &commandBuffer, const std::optional<Vector4i> &scissor);
+
+private:
+	class FrameBuffers {
+	public:
+		std::unique_ptr<Buffer> vertexBuffer;
+		std::unique_ptr<Buffer> indexBuffer;
+		void *vertices = nullptr;
+		void *indices = nullptr;
+	};
+
+	class ObjectDescriptors {
+	public:
+		std::shared_ptr<void> object;
+		DescriptorsHandler descriptorSet;
+		uint32_t unusedRenders = 0;
+	};
+
+	/// Renders the descriptors of a object are kept after it was last drawn, more than the frames the GPU can have in flight.
+	static constexpr uint32_t EvictRenders = 8;
+	/// The smallest size buffers are created with in bytes, they grow to the next power of two.
+	static constexpr VkDeviceSize MinBufferSize = 64 * 1024;
+
+	void Bind(const CommandBuffer &commandBuffer, const void *vertices, VkDeviceSize verticesSize, const std::vector<uint32_t> &indices);
+	void ClearFrames();
+	static void Reserve(std::unique_ptr<Buffer> &buffer, void *&mapped, VkDeviceSize size, VkBufferUsageFlags usage);
+
+	std::vector<FrameBuffers> frames;
+	std::unordered_map<const void *, ObjectDescriptors> descriptorSets;
+	std::optional<VkRect2D> lastScissor;
+};
+}
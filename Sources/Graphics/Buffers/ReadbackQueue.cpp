@@ -0,0 +1,197 @@
+#include "ReadbackQueue.hpp"
+
+#include <cstring>
+
+#include "Bitmaps/BitmapOps.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Graphics/Images/Image.hpp"
+
+namespace acid {
+ReadbackQueue::ReadbackQueue(uint32_t threadCount, std::size_t maxCallbacks) :
+	maxCallbacks(maxCallbacks),
+	threadPool(threadCount) {
+}
+
+ReadbackQueue::~ReadbackQueue() {
+	Flush();
+
+	for (auto &staging : stagings)
+		staging.buffer->UnmapMemory();
+}
+
+bool ReadbackQueue::Record(const CommandBuffer &commandBuffer, VkFence fence, const VkImage &image, VkFormat format, VkImageLayout layout, const Vector2ui &size,
+	uint32_t mipLevel, uint32_t arrayLayer, Callback &&callback) {
+	auto readFormat = GetReadFormat(format);
+
+	if (readFormat == PixelFormat::Undefined) {
+		Log::Error("Image with format ", format, " can not be read back\n");
+		return false;
+	}
+
+	auto staging = AcquireStaging(static_cast<VkDeviceSize>(size.x) * size.y * PixelBlock::Get(readFormat).bytes);
+
+	Image::InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, mipLevel, 1, arrayLayer);
+
+	// Rows are copied tightly packed, so the buffer holds the pixels as a bitmap stores them.
+	VkBufferImageCopy region = {};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = mipLevel;
+	region.imageSubresource.baseArrayLayer = arrayLayer;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent = {size.x, size.y, 1};
+	vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging.buffer->GetBuffer(), 1, &region);
+
+	Image::InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_MEMORY_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, layout,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, mipLevel, 1, arrayLayer);
+	Buffer::InsertBufferMemoryBarrier(commandBuffer, staging.buffer->GetBuffer(), VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+
+	auto &readback = pending.emplace_back();
+	readback.staging = std::move(staging);
+	readback.fence = fence;
+	readback.format = format;
+	readback.size = size;
+	readback.callback = std::move(callback);
+	return true;
+}
+
+bool ReadbackQueue::Submit(const VkImage &image, VkFormat format, VkImageLayout layout, const Vector2ui &size, uint32_t mipLevel, uint32_t arrayLayer,
+	Callback &&callback) {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	VkFenceCreateInfo fenceCreateInfo = {};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	VkFence fence;
+	Graphics::CheckVk(vkCreateFence(*logicalDevice, &fenceCreateInfo, nullptr, &fence));
+
+	auto commandBuffer = std::make_unique<CommandBuffer>();
+
+	if (!Record(*commandBuffer, fence, image, format, layout, size, mipLevel, arrayLayer, std::move(callback))) {
+		vkDestroyFence(*logicalDevice, fence, nullptr);
+		return false;
+	}
+
+	commandBuffer->Submit(VK_NULL_HANDLE, VK_NULL_HANDLE, fence);
+	pending.back().commandBuffer = std::move(commandBuffer);
+	return true;
+}
+
+void ReadbackQueue::Update() {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	for (auto it = pending.begin(); it != pending.end();) {
+		if (vkGetFenceStatus(*logicalDevice, it->fence) != VK_SUCCESS) {
+			++it;
+			continue;
+		}
+
+		// Command buffers are freed on the thread that allocated them.
+		if (it->commandBuffer) {
+			vkDestroyFence(*logicalDevice, it->fence, nullptr);
+			it->commandBuffer = nullptr;
+		}
+
+		auto readback = std::make_shared<Readback>(std::move(*it));
+		it = pending.erase(it);
+
+		callbacks.emplace_back(threadPool.Enqueue([this, readback]() {
+			Read(std::move(*readback));
+		}));
+	}
+
+	// Finished callbacks are dropped, when too many are waiting the oldest is waited on so the pixels held stay bounded.
+	while (!callbacks.empty() && (callbacks.size() > maxCallbacks || callbacks.front().wait_for(0s) == std::future_status::ready)) {
+		callbacks.front().wait();
+		callbacks.pop_front();
+	}
+}
+
+void ReadbackQueue::Flush() {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	for (const auto &readback : pending)
+		Graphics::CheckVk(vkWaitForFences(*logicalDevice, 1, &readback.fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+
+	Update();
+
+	for (auto &callback : callbacks)
+		callback.wait();
+	callbacks.clear();
+}
+
+PixelFormat ReadbackQueue::GetReadFormat(VkFormat format) {
+	switch (format) {
+	case VK_FORMAT_B8G8R8A8_UNORM:
+		return PixelFormat::R8G8B8A8Unorm;
+	case VK_FORMAT_B8G8R8A8_SRGB:
+		return PixelFormat::R8G8B8A8Srgb;
+	default:
+		break;
+	}
+
+	auto pixelFormat = static_cast<PixelFormat>(format);
+	if (PixelBlock::IsCompressed(pixelFormat) || PixelBlock::Get(pixelFormat).bytes == 0)
+		return PixelFormat::Undefined;
+	return pixelFormat;
+}
+
+ReadbackQueue::Staging ReadbackQueue::AcquireStaging(VkDeviceSize size) {
+	{
+		std::unique_lock<std::mutex> lock(stagingsMutex);
+
+		// The smallest buffer the pixels fit in is taken.
+		auto best = stagings.end();
+		for (auto it = stagings.begin(); it != stagings.end(); ++it) {
+			if (it->buffer->GetSize() >= size && (best == stagings.end() || it->buffer->GetSize() < best->buffer->GetSize()))
+				best = it;
+		}
+
+		if (best != stagings.end()) {
+			auto staging = std::move(*best);
+			stagings.erase(best);
+			return staging;
+		}
+	}
+
+	Staging staging;
+	staging.buffer = std::make_unique<Buffer>(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	staging.buffer->MapMemory(&staging.mapped);
+	return staging;
+}
+
+void ReadbackQueue::ReleaseStaging(Staging &&staging) {
+	std::unique_lock<std::mutex> lock(stagingsMutex);
+
+	// As many buffers are kept as reads can be waiting, past that the smallest is freed.
+	stagings.emplace_back(std::move(staging));
+	if (stagings.size() > maxCallbacks) {
+		auto smallest = std::min_element(stagings.begin(), stagings.end(), [](const Staging &a, const Staging &b) {
+			return a.buffer->GetSize() < b.buffer->GetSize();
+		});
+		smallest->buffer->UnmapMemory();
+		stagings.erase(smallest);
+	}
+}
+
+void ReadbackQueue::Read(Readback &&readback) {
+	auto readFormat = GetReadFormat(readback.format);
+	auto length = readback.size.x * readback.size.y * PixelBlock::Get(readFormat).bytes;
+	auto data = std::make_unique<uint8_t[]>(length);
+	std::memcpy(data.get(), readback.staging.mapped, length);
+	ReleaseStaging(std::move(readback.staging));
+
+	auto bitmap = std::make_unique<Bitmap>(std::move(data), readback.size, readFormat);
+
+	// Blue first pixels are swizzled to red first.
+	if (readFormat != static_cast<PixelFormat>(readback.format))
+		BitmapOps::Swizzle(*bitmap, {2, 1, 0, 3});
+
+	try {
+		readback.callback(std::move(bitmap));
+	} catch (const std::exception &e) {
+		Log::Error("Readback callback failed: ", e.what(), '\n');
+	}
+}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <deque>
+#include <future>
+
+#include "Bitmaps/Bitmap.hpp"
+#include "Utils/NonCopyable.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "Buffer.hpp"
+
+namespace acid {
+/**
+ * @brief Class that reads images back to the host without waiting on the device. Copies into host visible buffers are recorded into a command buffer,
+ * the fence of its submission is polled each frame, and once signalled the pixels are read into a bitmap and given to a callback on a worker thread.
+ * Buffers are kept after a read, and reused by later copies that fit in them.
+ */
+class ACID_EXPORT ReadbackQueue : NonCopyable {
+public:
+	/// Called on a worker thread with the pixels that were read back.
+	using Callback = std::function<void(std::unique_ptr<Bitmap>)>;
+
+	/**
+	 * Creates a new readback queue.
+	 * @param threadCount The number of threads callbacks are run on.
+	 * @param maxCallbacks The number of callbacks that can be waiting to run, a update that goes over waits for the oldest to finish.
+	 */
+	explicit ReadbackQueue(uint32_t threadCount = 2, std::size_t maxCallbacks = 8);
+	~ReadbackQueue();
+
+	/**
+	 * Records a copy of a image into the command buffer, the image is left in its layout after the copy.
+	 * @param commandBuffer The command buffer, it must be submitted with the fence before the next update.
+	 * @param fence The fence signalled once the command buffer has run.
+	 * @param image The image to copy.
+	 * @param format The format of the image, blue first 8 bit formats are swizzled to red first.
+	 * @param layout The layout of the image.
+	 * @param size The size of the mip level in pixels.
+	 * @param mipLevel The mip level to copy.
+	 * @param arrayLayer The array layer to copy.
+	 * @param callback The function given the pixels.
+	 * @return If the copy was recorded, images in formats bitmaps can not hold are not copied.
+	 */
+	bool Record(const CommandBuffer &commandBuffer, VkFence fence, const VkImage &image, VkFormat format, VkImageLayout layout, const Vector2ui &size,
+		uint32_t mipLevel, uint32_t arrayLayer, Callback &&callback);
+
+	/**
+	 * Records and submits a copy of a image on its own command buffer, without waiting on it.
+	 * @param image The image to copy.
+	 * @param format The format of the image.
+	 * @param layout The layout of the image.
+	 * @param size The size of the mip level in pixels.
+	 * @param mipLevel The mip level to copy.
+	 * @param arrayLayer The array layer to copy.
+	 * @param callback The function given the pixels.
+	 * @return If the copy was submitted.
+	 */
+	bool Submit(const VkImage &image, VkFormat format, VkImageLayout layout, const Vector2ui &size, uint32_t mipLevel, uint32_t arrayLayer, Callback &&callback);
+
+	/**
+	 * Starts the callbacks of every copy whose fence has signalled. Called on the main thread each frame.
+	 */
+	void Update();
+
+	/**
+	 * Waits until every copy has been read and every callback has finished.
+	 */
+	void Flush();
+
+	/**
+	 * Gets the format pixels of a image are read back in.
+	 * @param format The format of the image.
+	 * @return The pixel format, or undefined if bitmaps can not hold the pixels.
+	 */
+	static PixelFormat GetReadFormat(VkFormat format);
+
+	std::size_t GetPendingCount() const { return pending.size(); }
+
+private:
+	/// A host visible buffer, mapped for as long as it is kept.
+	struct Staging {
+		std::unique_ptr<Buffer> buffer;
+		void *mapped = nullptr;
+	};
+
+	struct Readback {
+		Staging staging;
+		VkFence fence = VK_NULL_HANDLE;
+		/// Set when the copy was submitted by the queue, which then owns the command buffer and fence.
+		std::unique_ptr<CommandBuffer> commandBuffer;
+		VkFormat format;
+		Vector2ui size;
+		Callback callback;
+	};
+
+	Staging AcquireStaging(VkDeviceSize size);
+	void ReleaseStaging(Staging &&staging);
+	void Read(Readback &&readback);
+
+	std::vector<Readback> pending;
+	std::vector<Staging> stagings;
+	std::mutex stagingsMutex;
+	std::deque<std::future<void>> callbacks;
+	std::size_t maxCallbacks;
+	ThreadPool threadPool;
+};
+}
@@ -60,5 +60,14 @@ public:
 	virtual ~Descriptor() = default;
 
 	virtual WriteDescriptorSet GetWriteDescriptor(uint32_t binding, VkDescriptorType descriptorType, const std::optional<OffsetSize> &offsetSize) const = 0;
+
+	/**
+	 * Gets a count that increases whenever the handles written by this descriptor change, such as when it is hot reloaded.
+	 * @return The generation.
+	 */
+	uint32_t GetGeneration() const { return generation; }
+
+protected:
+	uint32_t generation = 0;
 };
 }
@@ -28,8 +28,9 @@ public:
 		auto it = descriptors.find(descriptorName);
 
 		if (it != descriptors.end()) {
-			// If the descriptor and size have not changed then the write is not modified.
-			if (it->second.descriptor == to_address(descriptor) && it->second.offsetSize == offsetSize) {
+			// If the descriptor, its handles, and size have not changed then the write is not modified.
+			if (it->second.descriptor == to_address(descriptor) && to_address(descriptor) && it->second.generation == to_address(descriptor)->GetGeneration() &&
+				it->second.offsetSize == offsetSize) {
 				return;
 			}
 
@@ -67,7 +68,7 @@ public:
 
 		// Adds the new descriptor value.
 		auto writeDescriptor = to_address(descriptor)->GetWriteDescriptor(*location, *descriptorType, offsetSize);
-		descriptors.emplace(descriptorName, DescriptorValue{to_address(descriptor), std::move(writeDescriptor), offsetSize, *location});
+		descriptors.emplace(descriptorName, DescriptorValue{to_address(descriptor), to_address(descriptor)->GetGeneration(), std::move(writeDescriptor), offsetSize, *location});
 		changed = true;
 	}
 
@@ -83,7 +84,7 @@ public:
 		auto location = shader->GetDescriptorLocation(descriptorName);
 		//auto descriptorType = shader->GetDescriptorType(*location);
 
-		descriptors.emplace(descriptorName, DescriptorValue{to_address(descriptor), std::move(writeDescriptorSet), std::nullopt, *location});
+		descriptors.emplace(descriptorName, DescriptorValue{to_address(descriptor), to_address(descriptor)->GetGeneration(), std::move(writeDescriptorSet), std::nullopt, *location});
 		changed = true;
 	}
 
@@ -101,6 +102,7 @@ private:
 	class DescriptorValue {
 	public:
 		const Descriptor *descriptor;
+		uint32_t generation;
 		WriteDescriptorSet writeDescriptor;
 		std::optional<OffsetSize> offsetSize;
 		uint32_t location;
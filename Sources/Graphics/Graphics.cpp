@@ -1,14 +1,16 @@
 #include "Graphics.hpp"
 
-#include <cstring>
+#include <iomanip>
 #include <SPIRV/GlslangToSpv.h>
 
+#include "Buffers/ReadbackQueue.hpp"
 #include "Devices/Window.hpp"
 #include "Subrender.hpp"
 
 namespace acid {
 Graphics::Graphics() :
 	elapsedPurge(5s),
+	readbacks(std::make_unique<ReadbackQueue>()),
 	instance(std::make_unique<Instance>()),
 	physicalDevice(std::make_unique<PhysicalDevice>(instance.get())),
 	surface(std::make_unique<Surface>(instance.get(), physicalDevice.get())),
@@ -24,8 +26,10 @@ Graphics::~Graphics() {
 
 	CheckVk(vkQueueWaitIdle(graphicsQueue));
 
+	readbacks = nullptr;
 	glslang::FinalizeProcess();
 
+	computePipelines.clear();
 	vkDestroyPipelineCache(*logicalDevice, pipelineCache, nullptr);
 
 	for (std::size_t i = 0; i < flightFences.size(); i++) {
@@ -62,6 +66,8 @@ void Graphics::Update() {
 		return;
 	}
 
+	readbacks->Update();
+
 	Pipeline::Stage stage;
 
 	for (auto &renderStage : renderer->renderStages) {
@@ -162,44 +168,19 @@ void Graphics::CheckVk(VkResult result) {
 	throw std::runtime_error("Vulkan error: " + failure);
 }
 
-void Graphics::CaptureScreenshot(const std::filesystem::path &filename) const {
-#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif
-
-	auto size = Window::Get()->GetSize();
-
-	VkImage dstImage;
-	VkDeviceMemory dstImageMemory;
-	auto supportsBlit = Image::CopyImage(swapchain->GetActiveImage(), dstImage, dstImageMemory, surface->GetFormat().format, {size.x, size.y, 1},
-		VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0, 0);
-
-	// Get layout of the image (including row pitch).
-	VkImageSubresource imageSubresource = {};
-	imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	imageSubresource.mipLevel = 0;
-	imageSubresource.arrayLayer = 0;
-
-	VkSubresourceLayout dstSubresourceLayout;
-	vkGetImageSubresourceLayout(*logicalDevice, dstImage, &imageSubresource, &dstSubresourceLayout);
-
-	Bitmap bitmap(std::make_unique<uint8_t[]>(dstSubresourceLayout.size), size);
-
-	void *data;
-	vkMapMemory(*logicalDevice, dstImageMemory, dstSubresourceLayout.offset, dstSubresourceLayout.size, 0, &data);
-	std::memcpy(bitmap.GetData().get(), data, static_cast<size_t>(dstSubresourceLayout.size));
-	vkUnmapMemory(*logicalDevice, dstImageMemory);
-
-	// Frees temp image and memory.
-	vkFreeMemory(*logicalDevice, dstImageMemory, nullptr);
-	vkDestroyImage(*logicalDevice, dstImage, nullptr);
+void Graphics::CaptureScreenshot(const std::filesystem::path &filename) {
+	screenshots.emplace_back(filename);
+}
 
-	// Writes the screenshot bitmap to the file.
-	bitmap.Write(filename);
+void Graphics::StartCapture(const std::filesystem::path &directory, const std::string &extension) {
+	captureDirectory = directory;
+	captureExtension = extension;
+	captureFrame = 0;
+}
 
-#if defined(ACID_DEBUG)
-	Log::Out("Screenshot ", filename, " created in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
-#endif
+void Graphics::StopCapture() {
+	captureDirectory.clear();
+	readbacks->Flush();
 }
 
 RenderStage *Graphics::GetRenderStage(uint32_t index) const {
@@ -214,6 +195,18 @@ const Descriptor *Graphics::GetAttachment(const std::string &name) const {
 	return nullptr;
 }
 
+const PipelineCompute &Graphics::GetComputePipeline(const std::filesystem::path &shaderStage, const std::vector<Shader::Define> &defines) {
+	auto key = shaderStage.generic_string();
+	for (const auto &[defineName, defineValue] : defines)
+		key += ';' + defineName + '=' + defineValue;
+
+	std::lock_guard<std::mutex> lock(computePipelinesMutex);
+	auto &pipeline = computePipelines[key];
+	if (!pipeline)
+		pipeline = std::make_unique<PipelineCompute>(shaderStage, defines);
+	return *pipeline;
+}
+
 const std::shared_ptr<CommandPool> &Graphics::GetCommandPool(const std::thread::id &threadId) {
 	if (auto it = commandPools.find(threadId); it != commandPools.end())
 		return it->second;
@@ -252,6 +245,9 @@ void Graphics::RecreateSwapchain() {
 }
 
 void Graphics::RecreateCommandBuffers() {
+	// The device is idle, so copies waiting on the frame fences are read before the fences are destroyed.
+	readbacks->Update();
+
 	for (std::size_t i = 0; i < flightFences.size(); i++) {
 		vkDestroyFence(*logicalDevice, flightFences[i], nullptr);
 		vkDestroySemaphore(*logicalDevice, renderCompletes[i], nullptr);
@@ -354,6 +350,9 @@ void Graphics::EndRenderpass(RenderStage &renderStage) {
 	if (!renderStage.HasSwapchain())
 		return;
 
+	if (!screenshots.empty() || !captureDirectory.empty())
+		RecordCaptures(*commandBuffer);
+
 	commandBuffer->End();
 	commandBuffer->Submit(presentCompletes[currentFrame], renderCompletes[currentFrame], flightFences[currentFrame]);
 
@@ -368,4 +367,44 @@ void Graphics::EndRenderpass(RenderStage &renderStage) {
 
 	currentFrame = (currentFrame + 1) % swapchain->GetImageCount();
 }
+
+void Graphics::RecordCaptures(const CommandBuffer &commandBuffer) {
+	if (!(surface->GetCapabilities().supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+		Log::Warning("Swapchain images can not be copied from, screenshots and captures are skipped\n");
+		screenshots.clear();
+		captureDirectory.clear();
+		return;
+	}
+
+	// One copy of the frame is read back for every file it is saved in.
+	auto filenames = std::move(screenshots);
+	screenshots.clear();
+
+	if (!captureDirectory.empty()) {
+		std::ostringstream frameName;
+		frameName << std::setw(6) << std::setfill('0') << captureFrame++ << captureExtension;
+		filenames.emplace_back(captureDirectory / frameName.str());
+	}
+
+	Vector2ui size(swapchain->GetExtent().width, swapchain->GetExtent().height);
+	readbacks->Record(commandBuffer, flightFences[currentFrame], swapchain->GetActiveImage(), surface->GetFormat().format, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+		size, 0, 0, [filenames](std::unique_ptr<Bitmap> bitmap) {
+#if defined(ACID_DEBUG)
+		auto debugStart = Time::Now();
+#endif
+
+		// Alpha in the swapchain is not kept by presentation, so frames are saved opaque.
+		if (bitmap->GetBytesPerPixel() == 4) {
+			for (uint32_t i = 3; i < bitmap->GetLength(); i += 4)
+				bitmap->GetData()[i] = 0xff;
+		}
+
+		for (const auto &filename : filenames)
+			bitmap->Write(filename);
+
+#if defined(ACID_DEBUG)
+		Log::Out("Frame ", filenames.front(), " saved in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+	});
+}
 }
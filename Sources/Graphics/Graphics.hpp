@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mutex>
+
 #include "Engine/Engine.hpp"
 #include "Commands/CommandBuffer.hpp"
 #include "Commands/CommandPool.hpp"
@@ -8,9 +10,12 @@
 #include "Devices/PhysicalDevice.hpp"
 #include "Devices/Surface.hpp"
 #include "Devices/Window.hpp"
+#include "Pipelines/PipelineCompute.hpp"
 #include "Renderer.hpp"
 
 namespace acid {
+class ReadbackQueue;
+
 /**
  * @brief Module that manages the Vulkan instance, Surface, Window and the renderpass structure.
  */
@@ -27,10 +32,24 @@ public:
 	static void CheckVk(VkResult result);
 
 	/**
-	 * Takes a screenshot of the current image of the display and saves it into a image file.
-	 * @param filename The file to save the screenshot as.
+	 * Takes a screenshot of the next frame and saves it into a image file, the frame is read back and written on worker threads without stalling rendering.
+	 * @param filename The file to save the screenshot as, the extension picks the format such as PNG or QOI.
+	 */
+	void CaptureScreenshot(const std::filesystem::path &filename);
+
+	/**
+	 * Starts saving every frame into numbered image files in a directory, until capture is stopped.
+	 * @param directory The directory to save frames in.
+	 * @param extension The extension of the frame files, which picks their format. QOI files are quick enough to write at full frame rate.
 	 */
-	void CaptureScreenshot(const std::filesystem::path &filename) const;
+	void StartCapture(const std::filesystem::path &directory, const std::string &extension = ".qoi");
+
+	/**
+	 * Stops saving frames, returning once every frame captured has been written.
+	 */
+	void StopCapture();
+
+	bool IsCapturing() const { return !captureDirectory.empty(); }
 
 	const std::shared_ptr<CommandPool> &GetCommandPool(const std::thread::id &threadId = std::this_thread::get_id());
 
@@ -51,7 +70,27 @@ public:
 	const Descriptor *GetAttachment(const std::string &name) const;
 	const Swapchain *GetSwapchain() const { return swapchain.get(); }
 	const VkPipelineCache &GetPipelineCache() const { return pipelineCache; }
+	ReadbackQueue *GetReadbacks() const { return readbacks.get(); }
+
+	/**
+	 * Gets a compute pipeline that is kept until graphics is destroyed, it is created the first time it is used.
+	 * Descriptor sets are allocated from the pool of the pipeline, callers on different threads must not allocate from it at the same time.
+	 * @param shaderStage The compute shader stage.
+	 * @param defines The defines the shader is compiled with.
+	 * @return The compute pipeline.
+	 */
+	const PipelineCompute &GetComputePipeline(const std::filesystem::path &shaderStage, const std::vector<Shader::Define> &defines = {});
 	void SetFramebufferResized() { framebufferResized = true; }
+	/**
+	 * Gets the index of the frame being recorded, the previous frame with this index has finished on the device.
+	 * @return The frame index, less than {@link Graphics#GetFrameCount}.
+	 */
+	std::size_t GetCurrentFrame() const { return currentFrame; }
+	/**
+	 * Gets the number of frames that can be in flight, so resources written each frame can be kept per frame.
+	 * @return The number of frames.
+	 */
+	std::size_t GetFrameCount() const { return flightFences.size(); }
 	const PhysicalDevice *GetPhysicalDevice() const { return physicalDevice.get(); }
 	const Surface *GetSurface() const { return surface.get(); }
 	const LogicalDevice *GetLogicalDevice() const { return logicalDevice.get(); }
@@ -65,6 +104,7 @@ private:
 	void RecreateAttachmentsMap();
 	bool StartRenderpass(RenderStage &renderStage);
 	void EndRenderpass(RenderStage &renderStage);
+	void RecordCaptures(const CommandBuffer &commandBuffer);
 
 	std::unique_ptr<Renderer> renderer;
 	std::map<std::string, const Descriptor *> attachments;
@@ -75,12 +115,23 @@ private:
 	ElapsedTime elapsedPurge;
 
 	VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+	/// Compute pipelines used while loading, by shader stage and defines.
+	std::map<std::string, std::unique_ptr<PipelineCompute>> computePipelines;
+	std::mutex computePipelinesMutex;
 	std::vector<VkSemaphore> presentCompletes;
 	std::vector<VkSemaphore> renderCompletes;
 	std::vector<VkFence> flightFences;
 	std::size_t currentFrame = 0;
 	bool framebufferResized = false;
 
+	/// Copies of images read back across frames.
+	std::unique_ptr<ReadbackQueue> readbacks;
+	/// Screenshots taken from the next frame.
+	std::vector<std::filesystem::path> screenshots;
+	std::filesystem::path captureDirectory;
+	std::string captureExtension;
+	uint32_t captureFrame = 0;
+
 	std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
 
 	std::unique_ptr<Instance> instance;
@@ -0,0 +1,139 @@
+#include "AtlasPacker.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace acid {
+AtlasPacker::AtlasPacker(const Vector2ui &size) :
+	size(size) {
+	Clear();
+}
+
+std::optional<Vector2ui> AtlasPacker::Insert(const Vector2ui &size) {
+	if (size.x == 0 || size.y == 0)
+		return std::nullopt;
+
+	// Best short side fit, ties are broken by the long side.
+	const Rect *best = nullptr;
+	auto bestShortSide = std::numeric_limits<uint32_t>::max();
+	auto bestLongSide = std::numeric_limits<uint32_t>::max();
+
+	for (const auto &freeRect : freeRects) {
+		if (freeRect.width < size.x || freeRect.height < size.y)
+			continue;
+
+		auto leftoverX = freeRect.width - size.x;
+		auto leftoverY = freeRect.height - size.y;
+		auto shortSide = std::min(leftoverX, leftoverY);
+		auto longSide = std::max(leftoverX, leftoverY);
+
+		if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+			best = &freeRect;
+			bestShortSide = shortSide;
+			bestLongSide = longSide;
+		}
+	}
+
+	if (!best)
+		return std::nullopt;
+
+	Rect used = {best->x, best->y, size.x, size.y};
+	Split(used);
+	Prune();
+	usedArea += static_cast<uint64_t>(size.x) * size.y;
+	return Vector2ui(used.x, used.y);
+}
+
+void AtlasPacker::Remove(const Vector2ui &position, const Vector2ui &size) {
+	usedArea -= std::min(usedArea, static_cast<uint64_t>(size.x) * size.y);
+
+	// Once empty the area is reset, so space split by earlier placements is whole again.
+	if (usedArea == 0) {
+		Clear();
+		return;
+	}
+
+	freeRects.push_back({position.x, position.y, size.x, size.y});
+	Merge();
+	Prune();
+}
+
+void AtlasPacker::Clear() {
+	freeRects.clear();
+	usedArea = 0;
+	if (size.x > 0 && size.y > 0)
+		freeRects.push_back({0, 0, size.x, size.y});
+}
+
+float AtlasPacker::GetOccupancy() const {
+	auto area = static_cast<uint64_t>(size.x) * size.y;
+	return area == 0 ? 0.0f : static_cast<float>(static_cast<double>(usedArea) / area);
+}
+
+void AtlasPacker::Split(const Rect &used) {
+	// Every free rectangle the used rectangle overlaps is replaced with the largest rectangles left around it.
+	std::vector<Rect> split;
+	for (auto it = freeRects.begin(); it != freeRects.end();) {
+		if (!it->Intersects(used)) {
+			++it;
+			continue;
+		}
+
+		auto freeRect = *it;
+		it = freeRects.erase(it);
+
+		if (used.x > freeRect.x)
+			split.push_back({freeRect.x, freeRect.y, used.x - freeRect.x, freeRect.height});
+		if (used.x + used.width < freeRect.x + freeRect.width)
+			split.push_back({used.x + used.width, freeRect.y, freeRect.x + freeRect.width - used.x - used.width, freeRect.height});
+		if (used.y > freeRect.y)
+			split.push_back({freeRect.x, freeRect.y, freeRect.width, used.y - freeRect.y});
+		if (used.y + used.height < freeRect.y + freeRect.height)
+			split.push_back({freeRect.x, used.y + used.height, freeRect.width, freeRect.y + freeRect.height - used.y - used.height});
+	}
+
+	freeRects.insert(freeRects.end(), split.begin(), split.end());
+}
+
+void AtlasPacker::Merge() {
+	// The last rectangle is joined with rectangles that share a whole edge with it, until no more can be.
+	auto merged = freeRects.back();
+	freeRects.pop_back();
+
+	for (std::size_t i = 0; i < freeRects.size();) {
+		const auto &other = freeRects[i];
+
+		if (merged.x == other.x && merged.width == other.width && (merged.y + merged.height == other.y || other.y + other.height == merged.y)) {
+			merged.y = std::min(merged.y, other.y);
+			merged.height += other.height;
+		} else if (merged.y == other.y && merged.height == other.height && (merged.x + merged.width == other.x || other.x + other.width == merged.x)) {
+			merged.x = std::min(merged.x, other.x);
+			merged.width += other.width;
+		} else {
+			i++;
+			continue;
+		}
+
+		freeRects.erase(freeRects.begin() + i);
+		i = 0;
+	}
+
+	freeRects.push_back(merged);
+}
+
+void AtlasPacker::Prune() {
+	// Rectangles inside another free rectangle add no space.
+	for (std::size_t i = 0; i < freeRects.size(); i++) {
+		for (std::size_t j = i + 1; j < freeRects.size();) {
+			if (freeRects[i].Contains(freeRects[j])) {
+				freeRects.erase(freeRects.begin() + j);
+			} else if (freeRects[j].Contains(freeRects[i])) {
+				freeRects.erase(freeRects.begin() + i);
+				j = i + 1;
+			} else {
+				j++;
+			}
+		}
+	}
+}
+}
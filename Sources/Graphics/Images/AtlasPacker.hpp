@@ -0,0 +1,74 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "Maths/Vector2.hpp"
+
+namespace acid {
+/**
+ * @brief Class that packs rectangles into a area with the MaxRects algorithm. The free space is kept as the largest rectangles that fit in it,
+ * which may overlap, and each rectangle is placed in the free rectangle it leaves the least space along its shorter side.
+ * Rectangles can be removed in any order, once every rectangle is removed the area is whole again.
+ */
+class ACID_EXPORT AtlasPacker {
+public:
+	/**
+	 * Creates a new atlas packer.
+	 * @param size The size of the area in pixels.
+	 */
+	explicit AtlasPacker(const Vector2ui &size = {});
+
+	/**
+	 * Places a rectangle in the free space.
+	 * @param size The size of the rectangle in pixels.
+	 * @return The position of the top left corner, or no value if the rectangle does not fit.
+	 */
+	std::optional<Vector2ui> Insert(const Vector2ui &size);
+
+	/**
+	 * Frees the space of a rectangle placed with {@link AtlasPacker#Insert}.
+	 * @param position The position of the rectangle.
+	 * @param size The size of the rectangle.
+	 */
+	void Remove(const Vector2ui &position, const Vector2ui &size);
+
+	/**
+	 * Frees all placed rectangles.
+	 */
+	void Clear();
+
+	/**
+	 * Gets the part of the area covered by placed rectangles.
+	 * @return The occupancy, between 0 and 1.
+	 */
+	float GetOccupancy() const;
+
+	const Vector2ui &GetSize() const { return size; }
+	uint64_t GetUsedArea() const { return usedArea; }
+	std::size_t GetFreeRectCount() const { return freeRects.size(); }
+
+private:
+	class Rect {
+	public:
+		bool Contains(const Rect &other) const {
+			return other.x >= x && other.y >= y && other.x + other.width <= x + width && other.y + other.height <= y + height;
+		}
+
+		bool Intersects(const Rect &other) const {
+			return other.x < x + width && other.x + other.width > x && other.y < y + height && other.y + other.height > y;
+		}
+
+		uint32_t x, y;
+		uint32_t width, height;
+	};
+
+	void Split(const Rect &used);
+	void Merge();
+	void Prune();
+
+	Vector2ui size;
+	std::vector<Rect> freeRects;
+	uint64_t usedArea = 0;
+};
+}
@@ -1,15 +1,52 @@
 #include "Image.hpp"
 
+#include <array>
 #include <cstring>
+#include <mutex>
 
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/BlockDecoder.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Buffers/ReadbackQueue.hpp"
+#include "Graphics/Descriptors/DescriptorSet.hpp"
 #include "Files/Files.hpp"
 
 namespace acid {
 static constexpr float ANISOTROPY = 16.0f;
 
+/**
+ * Finds the GLSL layout qualifier of a format that can be stored to from the mipmap shader.
+ * @param format The image format.
+ * @return The qualifier, or nullptr if the format is not stored to.
+ */
+static const char *FindStorageQualifier(VkFormat format) {
+	switch (format) {
+	case VK_FORMAT_R8_UNORM:
+		return "r8";
+	case VK_FORMAT_R8G8_UNORM:
+		return "rg8";
+	case VK_FORMAT_R8G8B8A8_UNORM:
+		return "rgba8";
+	case VK_FORMAT_R16_SFLOAT:
+		return "r16f";
+	case VK_FORMAT_R16G16_SFLOAT:
+		return "rg16f";
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+		return "rgba16f";
+	case VK_FORMAT_R32_SFLOAT:
+		return "r32f";
+	case VK_FORMAT_R32G32_SFLOAT:
+		return "rg32f";
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		return "rgba32f";
+	case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+		return "r11f_g11f_b10f";
+	default:
+		return nullptr;
+	}
+}
+
 Image::Image(VkFilter filter, VkSamplerAddressMode addressMode, VkSampleCountFlagBits samples, VkImageLayout layout, VkImageUsageFlags usage, VkFormat format, uint32_t mipLevels,
 	uint32_t arrayLayers, const VkExtent3D &extent):
 	extent(extent),
@@ -89,6 +126,11 @@ std::unique_ptr<Bitmap> Image::GetBitmap(uint32_t mipLevel, uint32_t arrayLayer)
 	return bitmap;
 }
 
+bool Image::GetBitmapAsync(std::function<void(std::unique_ptr<Bitmap>)> &&callback, uint32_t mipLevel, uint32_t arrayLayer) const {
+	Vector2ui size(std::max(extent.width >> mipLevel, 1u), std::max(extent.height >> mipLevel, 1u));
+	return Graphics::Get()->GetReadbacks()->Submit(image, format, layout, size, mipLevel, arrayLayer, std::move(callback));
+}
+
 uint32_t Image::GetMipLevels(const VkExtent3D &extent) {
 	return static_cast<uint32_t>(std::floor(std::log2(std::max(extent.width, std::max(extent.height, extent.depth)))) + 1);
 }
@@ -124,8 +166,13 @@ bool Image::HasStencil(VkFormat format) {
 
 void Image::CreateImage(VkImage &image, VkDeviceMemory &memory, const VkExtent3D &extent, VkFormat format, VkSampleCountFlagBits samples,
 	VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, uint32_t mipLevels, uint32_t arrayLayers, VkImageType type) {
+	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
+	// Layer counts can be read from image files, which may hold more layers than the device supports.
+	if (arrayLayers > physicalDevice->GetProperties().limits.maxImageArrayLayers)
+		throw std::runtime_error("Image has more array layers than the device supports");
+
 	VkImageCreateInfo imageCreateInfo = {};
 	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 	imageCreateInfo.flags = arrayLayers == 6 ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
@@ -196,17 +243,34 @@ void Image::CreateImageView(const VkImage &image, VkImageView &imageView, VkImag
 	Graphics::CheckVk(vkCreateImageView(*logicalDevice, &imageViewCreateInfo, nullptr, &imageView));
 }
 
-void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageLayout dstImageLayout, uint32_t mipLevels,
-	uint32_t baseArrayLayer, uint32_t layerCount) {
+VkImageUsageFlags Image::GetMipmapUsage(VkFormat format) {
+	if (FindStorageQualifier(format) && FindSupportedFormat({format}, VK_IMAGE_TILING_OPTIMAL,
+		VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != VK_FORMAT_UNDEFINED) {
+		return VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	}
+	return VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+}
+
+void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageUsageFlags usage, VkImageLayout dstImageLayout,
+	uint32_t mipLevels, uint32_t baseArrayLayer, uint32_t layerCount) {
+	auto computeUsage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	if ((usage & computeUsage) == computeUsage && GetMipmapUsage(format) == computeUsage) {
+		CreateMipmapsCompute(image, extent, format, dstImageLayout, mipLevels, baseArrayLayer, layerCount);
+		return;
+	}
+
 	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
 
 	// Get device properites for the requested Image format.
 	VkFormatProperties formatProperties;
 	vkGetPhysicalDeviceFormatProperties(*physicalDevice, format, &formatProperties);
 
-	// Mip-chain generation requires support for blit source and destination
-	assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT);
-	assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
+	// Mip-chain generation requires support for blit source and destination, without it only the base level is filled.
+	if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT) || !(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT)) {
+		Log::Error("Image format ", format, " can not be blitted or stored to, mipmaps were not created\n");
+		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, dstImageLayout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, layerCount, baseArrayLayer);
+		return;
+	}
 
 	CommandBuffer commandBuffer;
 
@@ -276,6 +340,81 @@ void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkForm
 	commandBuffer.SubmitIdle();
 }
 
+void Image::CreateMipmapsCompute(const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageLayout dstImageLayout, uint32_t mipLevels,
+	uint32_t baseArrayLayer, uint32_t layerCount) {
+	// Descriptor sets of the shared pipeline are allocated from one pool.
+	static std::mutex mutex;
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	const auto &compute = Graphics::Get()->GetComputePipeline("Shaders/Mipmaps.comp", {{"FORMAT", FindStorageQualifier(format)}});
+
+	VkSampler sampler = VK_NULL_HANDLE;
+	CreateImageSampler(sampler, VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, false, 1);
+
+	std::vector<VkImageView> levelViews(mipLevels);
+	for (uint32_t i = 0; i < mipLevels; i++)
+		CreateImageView(image, levelViews[i], VK_IMAGE_VIEW_TYPE_2D_ARRAY, format, VK_IMAGE_ASPECT_COLOR_BIT, 1, i, layerCount, baseArrayLayer);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	CommandBuffer commandBuffer;
+
+	// Every level is kept in the general layout, so the level above can be sampled while the levels below it are stored to.
+	InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, layerCount, baseArrayLayer);
+	compute.BindPipeline(commandBuffer);
+
+	// Each dispatch creates the next five levels, so the chain of a 4096 texture takes three dispatches instead of twelve blits.
+	std::vector<std::unique_ptr<DescriptorSet>> descriptorSets;
+	for (uint32_t base = 0; base + 1 < mipLevels; base += 5) {
+		auto levels = static_cast<int32_t>(std::min(mipLevels - 1 - base, 5u));
+
+		std::array<VkDescriptorImageInfo, 6> imageInfos = {};
+		for (uint32_t i = 0; i < imageInfos.size(); i++) {
+			// Levels past the end of the chain are bound to the last level, the shader does not store to them.
+			imageInfos[i].sampler = sampler;
+			imageInfos[i].imageView = levelViews[std::min(base + i, mipLevels - 1)];
+			imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		}
+
+		auto &descriptorSet = descriptorSets.emplace_back(std::make_unique<DescriptorSet>(compute));
+		std::vector<VkWriteDescriptorSet> descriptorWrites;
+		for (uint32_t i = 0; i < imageInfos.size(); i++) {
+			VkWriteDescriptorSet descriptorWrite = {};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = descriptorSet->GetDescriptorSet();
+			descriptorWrite.dstBinding = i;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			descriptorWrite.pImageInfo = &imageInfos[i];
+			descriptorWrites.emplace_back(descriptorWrite);
+		}
+		DescriptorSet::Update(descriptorWrites);
+
+		descriptorSet->BindDescriptor(commandBuffer);
+		vkCmdPushConstants(commandBuffer, compute.GetPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(levels), &levels);
+
+		// A workgroup covers 16x16 pixels of the first level it creates.
+		auto levelExtent = Vector2ui(std::max(extent.width >> (base + 1), 1u), std::max(extent.height >> (base + 1), 1u));
+		vkCmdDispatch(commandBuffer, (levelExtent.x + 15) / 16, (levelExtent.y + 15) / 16, layerCount);
+
+		// The last level stored becomes the source of the next dispatch.
+		InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL,
+			VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
+			levels, base + 1, layerCount, baseArrayLayer);
+	}
+
+	InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, dstImageLayout,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, layerCount, baseArrayLayer);
+	commandBuffer.SubmitIdle();
+	descriptorSets.clear();
+
+	for (auto &levelView : levelViews)
+		vkDestroyImageView(*logicalDevice, levelView, nullptr);
+	vkDestroySampler(*logicalDevice, sampler, nullptr);
+}
+
 void Image::TransitionImageLayout(const VkImage &image, VkFormat format, VkImageLayout srcImageLayout, VkImageLayout dstImageLayout,
 	VkImageAspectFlags imageAspect, uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer) {
 	CommandBuffer commandBuffer;
@@ -390,6 +529,44 @@ void Image::CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, cons
 	commandBuffer.SubmitIdle();
 }
 
+void Image::CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const Bitmap &bitmap, uint32_t baseArrayLayer) {
+	CommandBuffer commandBuffer;
+
+	// Levels are tightly packed one after another, each holding every layer.
+	std::vector<VkBufferImageCopy> regions(bitmap.GetMipLevels());
+	for (uint32_t i = 0; i < bitmap.GetMipLevels(); i++) {
+		auto levelSize = bitmap.GetLevelSize(i);
+		regions[i].bufferOffset = bitmap.GetLevelOffset(i);
+		regions[i].bufferRowLength = 0;
+		regions[i].bufferImageHeight = 0;
+		regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		regions[i].imageSubresource.mipLevel = i;
+		regions[i].imageSubresource.baseArrayLayer = baseArrayLayer;
+		regions[i].imageSubresource.layerCount = bitmap.GetArrayLayers();
+		regions[i].imageOffset = {0, 0, 0};
+		regions[i].imageExtent = {levelSize.x, levelSize.y, 1};
+	}
+	vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+	commandBuffer.SubmitIdle();
+}
+
+std::unique_ptr<Bitmap> Image::ToSampledFormat(std::unique_ptr<Bitmap> &&bitmap) {
+	if (!bitmap || !bitmap->GetData())
+		return nullptr;
+
+	if (FindSupportedFormat({static_cast<VkFormat>(bitmap->GetFormat())}, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != VK_FORMAT_UNDEFINED)
+		return std::move(bitmap);
+
+	if (!BlockDecoder::IsSupported(bitmap->GetFormat())) {
+		Log::Error("Bitmap ", bitmap->GetFilename(), " format ", static_cast<uint32_t>(bitmap->GetFormat()), " can not be sampled by the device or decoded\n");
+		return nullptr;
+	}
+
+	Log::Warning("Bitmap ", bitmap->GetFilename(), " format ", static_cast<uint32_t>(bitmap->GetFormat()), " can not be sampled by the device, decoding blocks\n");
+	return BlockDecoder::Decode(*bitmap);
+}
+
 bool Image::CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory &dstImageMemory, VkFormat srcFormat, const VkExtent3D &extent,
 	VkImageLayout srcImageLayout, uint32_t mipLevel, uint32_t arrayLayer) {
 	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "Graphics/Commands/CommandBuffer.hpp"
@@ -42,6 +43,15 @@ public:
 	 */
 	std::unique_ptr<Bitmap> GetBitmap(uint32_t mipLevel = 0, uint32_t arrayLayer = 0) const;
 
+	/**
+	 * Copies the images pixels to a bitmap without waiting on the device, the pixels are kept in the images format. Called on the main thread.
+	 * @param callback The function given the bitmap on a worker thread, a frame or more after the call.
+	 * @param mipLevel The mipmap level index to sample.
+	 * @param arrayLayer The array level to sample.
+	 * @return If the copy was started, images in compressed formats can not be read back.
+	 */
+	bool GetBitmapAsync(std::function<void(std::unique_ptr<Bitmap>)> &&callback, uint32_t mipLevel = 0, uint32_t arrayLayer = 0) const;
+
 	const VkExtent3D &GetExtent() const { return extent; }
 	Vector2ui GetSize() const { return {extent.width, extent.height}; }
 	VkFormat GetFormat() const { return format; }
@@ -87,17 +97,52 @@ public:
 	static void CreateImageSampler(VkSampler &sampler, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, uint32_t mipLevels);
 	static void CreateImageView(const VkImage &image, VkImageView &imageView, VkImageViewType type, VkFormat format, VkImageAspectFlags imageAspect,
 		uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer);
-	static void CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageLayout dstImageLayout, uint32_t mipLevels,
-		uint32_t baseArrayLayer, uint32_t layerCount);
+	/**
+	 * Gets the usage an image needs to have its mip levels created. Formats that shaders can store to are downsampled by a compute pipeline, others are blitted.
+	 * @param format The image format.
+	 * @return The usage flags.
+	 */
+	static VkImageUsageFlags GetMipmapUsage(VkFormat format);
+	/**
+	 * Creates every mip level below the base level, the image must be in the transfer destination layout.
+	 * @param image The image.
+	 * @param extent The size of the base level.
+	 * @param format The image format.
+	 * @param usage The usage the image was created with, images with storage and sampled usage are downsampled by a compute pipeline.
+	 * @param dstImageLayout The layout every level is left in.
+	 * @param mipLevels The number of mip levels.
+	 * @param baseArrayLayer The first layer to create levels for.
+	 * @param layerCount The number of layers.
+	 */
+	static void CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageUsageFlags usage, VkImageLayout dstImageLayout,
+		uint32_t mipLevels, uint32_t baseArrayLayer, uint32_t layerCount);
 	static void TransitionImageLayout(const VkImage &image, VkFormat format, VkImageLayout srcImageLayout, VkImageLayout dstImageLayout,
 		VkImageAspectFlags imageAspect, uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer);
 	static void InsertImageMemoryBarrier(const CommandBuffer &commandBuffer, const VkImage &image, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
 		VkImageLayout oldImageLayout, VkImageLayout newImageLayout, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask,
 		VkImageAspectFlags imageAspect, uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer);
 	static void CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent, uint32_t layerCount, uint32_t baseArrayLayer);
+	/**
+	 * Copies every mip level and array layer of a bitmap from a buffer holding its data, the image must be in the transfer destination layout.
+	 * @param buffer The buffer holding the bitmap data.
+	 * @param image The image to copy into.
+	 * @param bitmap The bitmap that gives the size and offset of each level.
+	 * @param baseArrayLayer The first layer to copy into.
+	 */
+	static void CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const Bitmap &bitmap, uint32_t baseArrayLayer);
+	/**
+	 * Gets a bitmap in a format the device can sample, block compressed bitmaps the device can not sample are decoded to 8 bit RGBA.
+	 * @param bitmap The bitmap to check.
+	 * @return The bitmap, a decoded copy of it, or nullptr if the format can not be sampled or decoded.
+	 */
+	static std::unique_ptr<Bitmap> ToSampledFormat(std::unique_ptr<Bitmap> &&bitmap);
 	static bool CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory &dstImageMemory, VkFormat srcFormat, const VkExtent3D &extent,
 		VkImageLayout srcImageLayout, uint32_t mipLevel, uint32_t arrayLayer);
 
+private:
+	static void CreateMipmapsCompute(const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageLayout dstImageLayout, uint32_t mipLevels,
+		uint32_t baseArrayLayer, uint32_t layerCount);
+
 protected:
 	VkExtent3D extent;
 	VkSampleCountFlagBits samples;
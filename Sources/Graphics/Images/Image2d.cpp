@@ -6,8 +6,10 @@
 #include "Graphics/Buffers/Buffer.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Resources/Resources.hpp"
+#include "Files/Files.hpp"
 #include "Files/Node.hpp"
 #include "Image.hpp"
+#include "TextureStreamer.hpp"
 
 namespace acid {
 std::shared_ptr<Image2d> Image2d::Create(const Node &node) {
@@ -21,20 +23,22 @@ std::shared_ptr<Image2d> Image2d::Create(const Node &node) {
 	return result;
 }
 
-std::shared_ptr<Image2d> Image2d::Create(const std::filesystem::path &filename, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, bool mipmap) {
-	Image2d temp(filename, filter, addressMode, anisotropic, mipmap, false);
+std::shared_ptr<Image2d> Image2d::Create(const std::filesystem::path &filename, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, bool mipmap,
+	bool streamed) {
+	Image2d temp(filename, filter, addressMode, anisotropic, mipmap, false, streamed);
 	Node node;
 	node << temp;
 	return Create(node);
 }
 
-Image2d::Image2d(std::filesystem::path filename, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, bool mipmap, bool load) :
+Image2d::Image2d(std::filesystem::path filename, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, bool mipmap, bool load, bool streamed) :
 	Image(filter, addressMode, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
 		VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
 		VK_FORMAT_R8G8B8A8_UNORM, 1, 1, {0, 0, 1}),
 	filename(std::move(filename)),
 	anisotropic(anisotropic),
-	mipmap(mipmap) {
+	mipmap(mipmap),
+	streamed(streamed) {
 	if (load) {
 		Image2d::Load();
 	}
@@ -80,6 +84,7 @@ const Node &operator>>(const Node &node, Image2d &image) {
 	node["addressMode"].Get(image.addressMode);
 	node["anisotropic"].Get(image.anisotropic);
 	node["mipmap"].Get(image.mipmap);
+	node["streamed"].Get(image.streamed);
 	return node;
 }
 
@@ -89,27 +94,138 @@ Node &operator<<(Node &node, const Image2d &image) {
 	node["addressMode"].Set(image.addressMode);
 	node["anisotropic"].Set(image.anisotropic);
 	node["mipmap"].Set(image.mipmap);
+	node["streamed"].Set(image.streamed);
 	return node;
 }
 
-void Image2d::Load(std::unique_ptr<Bitmap> loadBitmap) {
+std::shared_ptr<Resource> Image2d::Reload() const {
+	if (filename.empty())
+		return nullptr;
+
+	auto image = std::make_shared<Image2d>(filename, filter, addressMode, anisotropic, mipmap, false, streamed);
+	// Streamed images keep the levels they had resident.
+	image->loadedBitmap = image->ReadBitmap(residentLevel);
+	if (!image->loadedBitmap)
+		return nullptr;
+	return image;
+}
+
+void Image2d::Upload() {
+	if (loadedBitmap)
+		Load(std::move(loadedBitmap));
+}
+
+std::shared_ptr<Image2d> Image2d::CreateResident(std::unique_ptr<Bitmap> &&levels, uint32_t residentLevel) const {
+	auto image = std::make_shared<Image2d>(filename, filter, addressMode, anisotropic, mipmap, false, streamed);
+	image->dependencies = dependencies;
+	image->storedBitmap = storedBitmap;
+	image->storedSize = storedSize;
+	image->storedMipLevels = storedMipLevels;
+	image->residentLevel = residentLevel;
+	image->extent = {levels->GetSize().x, levels->GetSize().y, 1};
+	image->format = static_cast<VkFormat>(levels->GetFormat());
+	image->components = levels->GetBytesPerPixel();
+	image->Load(std::move(levels));
+	return image;
+}
+
+std::unique_ptr<Bitmap> Image2d::CopyLevels(const Bitmap &bitmap, uint32_t level) {
+	auto offset = bitmap.GetLevelOffset(level);
+	auto data = std::make_unique<uint8_t[]>(bitmap.GetLength() - offset);
+	std::memcpy(data.get(), bitmap.GetData().get() + offset, bitmap.GetLength() - offset);
+	return std::make_unique<Bitmap>(std::move(data), bitmap.GetLevelSize(level), bitmap.GetFormat(), bitmap.GetMipLevels() - level, bitmap.GetArrayLayers());
+}
+
+void Image2d::Swap(Resource &other) {
+	Resource::Swap(other);
+	auto &image = dynamic_cast<Image2d &>(other);
+	std::swap(extent, image.extent);
+	std::swap(format, image.format);
+	std::swap(mipLevels, image.mipLevels);
+	std::swap(arrayLayers, image.arrayLayers);
+	std::swap(layout, image.layout);
+	std::swap(usage, image.usage);
+	std::swap(this->image, image.image);
+	std::swap(memory, image.memory);
+	std::swap(sampler, image.sampler);
+	std::swap(view, image.view);
+	std::swap(components, image.components);
+	std::swap(residentLevel, image.residentLevel);
+	std::swap(storedMipLevels, image.storedMipLevels);
+	std::swap(storedSize, image.storedSize);
+	std::swap(storedBitmap, image.storedBitmap);
+	// Descriptor sets holding the old view are rewritten the next time this image is pushed.
+	generation++;
+}
+
+std::unique_ptr<Bitmap> Image2d::ReadBitmap(std::optional<uint32_t> loadResidentLevel) {
+	// A texture cooked next to its source image is loaded instead, with the mip levels that were created offline.
+	// Both files are watched, a cooked file older than its source is stale so the source is loaded until it is cooked again.
+	auto cookedFilename = std::filesystem::path(filename).replace_extension(".ktx2");
+	auto loadFilename = filename;
+	dependencies = {filename};
+	if (mipmap && cookedFilename != filename) {
+		dependencies.emplace_back(cookedFilename);
+		if (Files::ExistsInPath(cookedFilename)) {
+			auto cookedTime = Files::GetModifiedTime(cookedFilename);
+			auto sourceTime = Files::GetModifiedTime(filename);
+			if (!cookedTime || !sourceTime || *cookedTime >= *sourceTime)
+				loadFilename = cookedFilename;
+		}
+	}
+	// Block compressed files keep their format and mip levels, unless the device can not sample them.
+	auto loadBitmap = ToSampledFormat(std::make_unique<Bitmap>(loadFilename));
+	if (!loadBitmap)
+		return nullptr;
+
+	storedSize = loadBitmap->GetSize();
+	storedMipLevels = loadBitmap->GetMipLevels();
+
+	// Streamed images start with only their smallest levels resident, the texture streamer loads the levels they are drawn at.
+	if (!loadResidentLevel && IsStreamable()) {
+		if (auto textureStreamer = TextureStreamer::Get())
+			loadResidentLevel = textureStreamer->GetInitialLevel(storedSize, storedMipLevels);
+	}
+
+	residentLevel = std::min(loadResidentLevel.value_or(0), storedMipLevels - 1);
+	// Streamable images keep every level, so the texture streamer copies levels out instead of decoding the file each time they change.
+	if (IsStreamable()) {
+		storedBitmap = std::move(loadBitmap);
+		loadBitmap = CopyLevels(*storedBitmap, residentLevel);
+	} else if (residentLevel > 0) {
+		loadBitmap = CopyLevels(*loadBitmap, residentLevel);
+	}
+
+	extent = {loadBitmap->GetSize().x, loadBitmap->GetSize().y, 1};
+	format = static_cast<VkFormat>(loadBitmap->GetFormat());
+	components = loadBitmap->GetBytesPerPixel();
+	return loadBitmap;
+}
+
+void Image2d::Load(std::unique_ptr<Bitmap> loadBitmap, std::optional<uint32_t> loadResidentLevel) {
 	if (!filename.empty() && !loadBitmap) {
-		loadBitmap = std::make_unique<Bitmap>(filename);
-		extent = {loadBitmap->GetSize().y, loadBitmap->GetSize().y, 1};
-		components = loadBitmap->GetBytesPerPixel();
+		loadBitmap = ReadBitmap(loadResidentLevel);
+		if (!loadBitmap)
+			return;
 	}
 		
 	if (extent.width == 0 || extent.height == 0)
 		return;
 
-	mipLevels = mipmap ? GetMipLevels(extent) : 1;
+	// Levels stored in the bitmap are uploaded, blocks can not be blitted so compressed bitmaps are never mipmapped here.
+	auto generateMipmaps = mipmap && (!loadBitmap || (loadBitmap->GetMipLevels() == 1 && !PixelBlock::IsCompressed(loadBitmap->GetFormat())));
+	mipLevels = loadBitmap && loadBitmap->GetMipLevels() > 1 ? loadBitmap->GetMipLevels() : generateMipmaps ? GetMipLevels(extent) : 1;
+
+	// Mip levels made at runtime are downsampled by a compute pipeline when the format can be stored to, otherwise they are blitted.
+	if (generateMipmaps)
+		usage |= GetMipmapUsage(format);
 
 	CreateImage(image, memory, extent, format, samples, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 		mipLevels, arrayLayers, VK_IMAGE_TYPE_2D);
 	CreateImageSampler(sampler, filter, addressMode, anisotropic, mipLevels);
 	CreateImageView(image, view, VK_IMAGE_VIEW_TYPE_2D, format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 
-	if (loadBitmap || mipmap) {
+	if (loadBitmap || generateMipmaps) {
 		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	}
 
@@ -122,11 +238,11 @@ void Image2d::Load(std::unique_ptr<Bitmap> loadBitmap) {
 		std::memcpy(data, loadBitmap->GetData().get(), bufferStaging.GetSize());
 		bufferStaging.UnmapMemory();
 
-		CopyBufferToImage(bufferStaging.GetBuffer(), image, extent, arrayLayers, 0);
+		CopyBufferToImage(bufferStaging.GetBuffer(), image, *loadBitmap, 0);
 	}
 
-	if (mipmap) {
-		CreateMipmaps(image, extent, format, layout, mipLevels, 0, arrayLayers);
+	if (generateMipmaps) {
+		CreateMipmaps(image, extent, format, usage, layout, mipLevels, 0, arrayLayers);
 	} else if (loadBitmap) {
 		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	} else {
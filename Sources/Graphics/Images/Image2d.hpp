@@ -24,10 +24,11 @@ public:
 	 * @param addressMode The addressing mode for outside [0..1] range.
 	 * @param anisotropic If anisotropic filtering is enabled.
 	 * @param mipmap If mapmaps will be generated.
+	 * @param streamed If the mip levels of the image are streamed in and out by the {@link TextureStreamer}.
 	 * @return The 2D image with the requested values.
 	 */
 	static std::shared_ptr<Image2d> Create(const std::filesystem::path &filename, VkFilter filter = VK_FILTER_LINEAR,
-		VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT, bool anisotropic = true, bool mipmap = true);
+		VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT, bool anisotropic = true, bool mipmap = true, bool streamed = false);
 
 	/**
 	 * Creates a new 2D image.
@@ -37,9 +38,10 @@ public:
 	 * @param anisotropic If anisotropic filtering is enabled.
 	 * @param mipmap If mapmaps will be generated.
 	 * @param load If this resource will be loaded immediately, otherwise {@link Image2d#Load} can be called later.
+	 * @param streamed If the mip levels of the image are streamed in and out by the {@link TextureStreamer}.
 	 */
 	explicit Image2d(std::filesystem::path filename, VkFilter filter = VK_FILTER_LINEAR, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-		bool anisotropic = true, bool mipmap = true, bool load = true);
+		bool anisotropic = true, bool mipmap = true, bool load = true, bool streamed = false);
 
 	/**
 	 * Creates a new 2D image.
@@ -86,22 +88,82 @@ public:
 	void SetPixels(const uint8_t *pixels, uint32_t layerCount, uint32_t baseArrayLayer);
 
 	std::type_index GetTypeIndex() const override { return typeid(Image2d); }
+	std::shared_ptr<Resource> Reload() const override;
+	void Upload() override;
+	void Swap(Resource &other) override;
+
+	/**
+	 * Creates a copy of this image from levels copied out of its stored bitmap, called on the main thread.
+	 * The copy is swapped in with {@link Image2d#Swap}.
+	 * @param levels The levels, from {@link Image2d#CopyLevels}.
+	 * @param residentLevel The level of the full chain the levels start at.
+	 * @return The copy.
+	 */
+	std::shared_ptr<Image2d> CreateResident(std::unique_ptr<Bitmap> &&levels, uint32_t residentLevel) const;
+
+	/**
+	 * Copies the levels of a bitmap from a level down, the level becomes the base level of the copy.
+	 * @param bitmap The bitmap.
+	 * @param level The first level to keep.
+	 * @return The copy.
+	 */
+	static std::unique_ptr<Bitmap> CopyLevels(const Bitmap &bitmap, uint32_t level);
 
 	const std::filesystem::path &GetFilename() const { return filename; }
 	bool IsAnisotropic() const { return anisotropic; }
 	bool IsMipmap() const { return mipmap; }
+	bool IsStreamed() const { return streamed; }
 	uint32_t GetComponents() const { return components; }
 
+	/**
+	 * Gets if levels of this image can be streamed in and out, only images created as streamed and loaded from a file that stores mip levels can be.
+	 * @return If the image can be streamed.
+	 */
+	bool IsStreamable() const { return streamed && !filename.empty() && storedMipLevels > 1; }
+
+	/**
+	 * Gets the level of the full mip chain resident as the base level of this image, 0 when every level is resident.
+	 * @return The resident level.
+	 */
+	uint32_t GetResidentLevel() const { return residentLevel; }
+
+	/**
+	 * Gets the number of mip levels stored in the file, every level of the full chain.
+	 * @return The stored mip levels.
+	 */
+	uint32_t GetStoredMipLevels() const { return storedMipLevels; }
+
+	/**
+	 * Gets the size of the first level stored in the file.
+	 * @return The stored size in pixels.
+	 */
+	const Vector2ui &GetStoredSize() const { return storedSize; }
+
+	/**
+	 * Gets every level decoded from the file, kept by streamable images so levels streamed in are copied instead of decoded again.
+	 * @return The stored levels, or nullptr if the image can not be streamed.
+	 */
+	const std::shared_ptr<const Bitmap> &GetStoredBitmap() const { return storedBitmap; }
+
 	friend const Node &operator>>(const Node &node, Image2d &image);
 	friend Node &operator<<(Node &node, const Image2d &image);
 
 private:
-	void Load(std::unique_ptr<Bitmap> loadBitmap = nullptr);
+	void Load(std::unique_ptr<Bitmap> loadBitmap = nullptr, std::optional<uint32_t> loadResidentLevel = std::nullopt);
+	std::unique_ptr<Bitmap> ReadBitmap(std::optional<uint32_t> loadResidentLevel);
 
 	std::filesystem::path filename;
 
 	bool anisotropic;
 	bool mipmap;
+	bool streamed = false;
 	uint32_t components = 0;
+
+	uint32_t residentLevel = 0;
+	uint32_t storedMipLevels = 1;
+	Vector2ui storedSize;
+	std::shared_ptr<const Bitmap> storedBitmap;
+	/// The levels read by a reload copy, until they are uploaded on the main thread.
+	std::unique_ptr<Bitmap> loadedBitmap;
 };
 }
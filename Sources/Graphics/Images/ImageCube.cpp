@@ -122,24 +122,41 @@ Node &operator<<(Node &node, const ImageCube &image) {
 }
 
 void ImageCube::Load(std::unique_ptr<Bitmap> loadBitmap) {
-	if (!filename.empty() && !loadBitmap) {
-		uint8_t *offset = nullptr;
+	// Sides loaded from their own files, copied straight into the staging buffer instead of through a combined bitmap.
+	std::vector<std::unique_ptr<Bitmap>> sides;
 
-		for (const auto &side : fileSides) {
-			Bitmap bitmapSide(filename / (side + fileSuffix));
-			auto lengthSide = bitmapSide.GetLength();
-
-			if (!loadBitmap) {
-				loadBitmap = std::make_unique<Bitmap>(std::make_unique<uint8_t[]>(lengthSide * arrayLayers), bitmapSide.GetSize(),
-					bitmapSide.GetBytesPerPixel());
-				offset = loadBitmap->GetData().get();
+	if (!filename.empty() && !loadBitmap) {
+		// A filename with a extension is one file holding every face, such as a KTX2 or DDS cube map.
+		if (filename.has_extension()) {
+			loadBitmap = std::make_unique<Bitmap>(filename);
+			if (loadBitmap->GetData() && loadBitmap->GetArrayLayers() != arrayLayers) {
+				Log::Error("Cube map ", filename, " has ", loadBitmap->GetArrayLayers(), " layers, not ", arrayLayers, '\n');
+				return;
 			}
-
-			std::memcpy(offset, bitmapSide.GetData().get(), lengthSide);
-			offset += lengthSide;
+		} else {
+			sides = LoadSides();
+			if (sides.empty())
+				return;
+
+			// The combined bitmap only describes the layout of the sides, it holds pixels only when its blocks have to be decoded.
+			const auto &first = *sides.front();
+			loadBitmap = std::make_unique<Bitmap>(nullptr, first.GetSize(), first.GetFormat(), first.GetMipLevels(), static_cast<uint32_t>(sides.size()));
+			loadBitmap->SetBytesPerPixel(first.GetBytesPerPixel());
+
+			if (FindSupportedFormat({static_cast<VkFormat>(first.GetFormat())}, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == VK_FORMAT_UNDEFINED) {
+				loadBitmap->SetData(std::make_unique<uint8_t[]>(loadBitmap->GetLength()));
+				CopySides(sides, loadBitmap->GetData().get());
+				sides.clear();
+			}
 		}
-
+
+		if (sides.empty())
+			loadBitmap = ToSampledFormat(std::move(loadBitmap));
+		if (!loadBitmap)
+			return;
+
 		extent = {loadBitmap->GetSize().y, loadBitmap->GetSize().y, 1};
+		format = static_cast<VkFormat>(loadBitmap->GetFormat());
 		components = loadBitmap->GetBytesPerPixel();
 	}
 
@@ -147,35 +164,77 @@ void ImageCube::Load(std::unique_ptr<Bitmap> loadBitmap) {
 		return;
 	}
 
-	mipLevels = mipmap ? GetMipLevels(extent) : 1;
+	// Bitmaps given with one layer hold every face one after another.
+	if (loadBitmap && loadBitmap->GetArrayLayers() == 1)
+		loadBitmap->SetArrayLayers(arrayLayers);
+
+	// Levels stored in the bitmap are uploaded, blocks can not be blitted so compressed bitmaps are never mipmapped here.
+	auto generateMipmaps = mipmap && (!loadBitmap || (loadBitmap->GetMipLevels() == 1 && !PixelBlock::IsCompressed(loadBitmap->GetFormat())));
+	mipLevels = loadBitmap && loadBitmap->GetMipLevels() > 1 ? loadBitmap->GetMipLevels() : generateMipmaps ? GetMipLevels(extent) : 1;
+
+	// Mip levels made at runtime are downsampled by a compute pipeline when the format can be stored to, otherwise they are blitted.
+	if (generateMipmaps)
+		usage |= GetMipmapUsage(format);
 
 	CreateImage(image, memory, extent, format, samples, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 		mipLevels, arrayLayers, VK_IMAGE_TYPE_2D);
 	CreateImageSampler(sampler, filter, addressMode, anisotropic, mipLevels);
 	CreateImageView(image, view, VK_IMAGE_VIEW_TYPE_CUBE, format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 
-	if (loadBitmap || mipmap) {
+	if (loadBitmap || generateMipmaps) {
 		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	}
 
 	if (loadBitmap) {
-		Buffer bufferStaging(loadBitmap->GetLength() * arrayLayers, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		Buffer bufferStaging(loadBitmap->GetLength(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
 			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
 		uint8_t *data;
 		bufferStaging.MapMemory(reinterpret_cast<void**>(&data));
-		std::memcpy(data, loadBitmap->GetData().get(), bufferStaging.GetSize());
+		if (sides.empty())
+			std::memcpy(data, loadBitmap->GetData().get(), bufferStaging.GetSize());
+		else
+			CopySides(sides, data);
 		bufferStaging.UnmapMemory();
 
-		CopyBufferToImage(bufferStaging.GetBuffer(), image, extent, arrayLayers, 0);
+		CopyBufferToImage(bufferStaging.GetBuffer(), image, *loadBitmap, 0);
 	}
 
-	if (mipmap) {
-		CreateMipmaps(image, extent, format, layout, mipLevels, 0, arrayLayers);
+	if (generateMipmaps) {
+		CreateMipmaps(image, extent, format, usage, layout, mipLevels, 0, arrayLayers);
 	} else if (loadBitmap) {
 		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	} else {
 		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	}
 }
+
+std::vector<std::unique_ptr<Bitmap>> ImageCube::LoadSides() const {
+	std::vector<std::unique_ptr<Bitmap>> sides;
+	sides.reserve(fileSides.size());
+
+	for (const auto &side : fileSides) {
+		auto &bitmapSide = sides.emplace_back(std::make_unique<Bitmap>(filename / (side + fileSuffix)));
+		if (!bitmapSide->GetData())
+			return {};
+
+		if (bitmapSide->GetSize() != sides.front()->GetSize() || bitmapSide->GetFormat() != sides.front()->GetFormat() ||
+			bitmapSide->GetMipLevels() != sides.front()->GetMipLevels() || bitmapSide->GetArrayLayers() != 1) {
+			Log::Error("Cube map ", filename, " side ", side, " does not match the size and format of the first side\n");
+			return {};
+		}
+	}
+
+	return sides;
+}
+
+void ImageCube::CopySides(const std::vector<std::unique_ptr<Bitmap>> &sides, uint8_t *data) {
+	// Sides are interleaved so each level holds every side, sides with mip levels such as compressed files keep them.
+	for (uint32_t level = 0; level < sides.front()->GetMipLevels(); level++) {
+		for (const auto &bitmapSide : sides) {
+			std::memcpy(data, bitmapSide->GetData().get() + bitmapSide->GetLevelOffset(level), bitmapSide->GetLevelLength(level));
+			data += bitmapSide->GetLevelLength(level);
+		}
+	}
+}
 }
@@ -20,8 +20,8 @@ public:
 
 	/**
 	 * Creates a new cubemap image.
-	 * @param filename The file to load the image from.
-	 * @param fileSuffix The files extension type (ex .png).
+	 * @param filename The directory to load the sides from, or a file with every face such as a KTX2 or DDS cube map.
+	 * @param fileSuffix The files extension type (ex .png), not used when loading from one file.
 	 * @param filter The magnification/minification filter to apply to lookups.
 	 * @param addressMode The addressing mode for outside [0..1] range.
 	 * @param anisotropic If anisotropic filtering is enabled.
@@ -33,8 +33,8 @@ public:
 
 	/**
 	 * Creates a new cubemap image.
-	 * @param filename The file to load the image from.
-	 * @param fileSuffix The files extension type (ex .png).
+	 * @param filename The directory to load the sides from, or a file with every face such as a KTX2 or DDS cube map.
+	 * @param fileSuffix The files extension type (ex .png), not used when loading from one file.
 	 * @param filter The magnification/minification filter to apply to lookups.
 	 * @param addressMode The addressing mode for outside [0..1] range.
 	 * @param anisotropic If anisotropic filtering is enabled.
@@ -109,6 +109,8 @@ private:
 	friend Node &operator<<(Node &node, const ImageCube &image);
 
 	void Load(std::unique_ptr<Bitmap> loadBitmap = nullptr);
+	std::vector<std::unique_ptr<Bitmap>> LoadSides() const;
+	static void CopySides(const std::vector<std::unique_ptr<Bitmap>> &sides, uint8_t *data);
 
 	std::filesystem::path filename;
 	std::string fileSuffix;
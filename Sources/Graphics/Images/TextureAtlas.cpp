@@ -0,0 +1,253 @@
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Bitmaps/Bitmap.hpp"
+#include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Graphics.hpp"
+
+namespace acid {
+/// Offsets into the staging buffer are aligned so every texel size copies from a valid offset.
+static constexpr VkDeviceSize UploadAlignment = 16;
+
+TextureAtlas::TextureAtlas(const Vector2ui &layerSize, uint32_t maxLayers, uint32_t padding, VkFormat format) :
+	layerSize(layerSize),
+	maxLayers(maxLayers),
+	padding(padding),
+	format(format) {
+}
+
+void TextureAtlas::Update() {
+	if (imageLayers != GetLayerCount()) {
+		Grow(GetLayerCount());
+		imageLayers = GetLayerCount();
+	}
+
+	if (!uploads.empty()) {
+		Upload(uploads);
+		uploads.clear();
+	}
+
+	updateCount++;
+
+	for (auto it = retiredRegions.begin(); it != retiredRegions.end();) {
+		if (++it->updates < RetireUpdates) {
+			++it;
+			continue;
+		}
+
+		Free(it->region);
+		it = retiredRegions.erase(it);
+	}
+
+	retiredImages.erase(std::remove_if(retiredImages.begin(), retiredImages.end(), [](auto &retired) {
+		return ++retired.second >= RetireUpdates;
+	}), retiredImages.end());
+}
+
+std::optional<TextureAtlas::Region> TextureAtlas::Add(const std::string &key, const Bitmap &bitmap) {
+	if (auto region = Find(key))
+		return region;
+
+	auto pixelFormat = static_cast<PixelFormat>(format);
+	std::unique_ptr<Bitmap> converted;
+	auto source = &bitmap;
+	if (bitmap.GetFormat() != pixelFormat) {
+		converted = bitmap.Convert(pixelFormat);
+		if (!converted)
+			return std::nullopt;
+		source = converted.get();
+	}
+
+	auto region = Pack(source->GetSize());
+	if (!region)
+		return std::nullopt;
+
+	// Edge pixels are repeated into the padding, so samples that fall past the edge read the image and not its neighbours.
+	auto bytes = PixelBlock::Get(pixelFormat).bytes;
+	Vector2ui paddedSize(region->size.x + padding * 2, region->size.y + padding * 2);
+	auto padded = std::make_unique<Bitmap>(nullptr, paddedSize, pixelFormat);
+	padded->SetData(std::make_unique<uint8_t[]>(padded->GetLength()));
+
+	auto sourceRowLength = static_cast<std::size_t>(region->size.x) * bytes;
+	auto paddedRowLength = static_cast<std::size_t>(paddedSize.x) * bytes;
+	for (uint32_t y = 0; y < paddedSize.y; y++) {
+		auto sourceY = std::clamp<int64_t>(static_cast<int64_t>(y) - padding, 0, region->size.y - 1);
+		auto sourceRow = source->GetData().get() + sourceY * sourceRowLength;
+		auto row = padded->GetData().get() + y * paddedRowLength;
+		std::memcpy(row + padding * bytes, sourceRow, sourceRowLength);
+		for (uint32_t x = 0; x < padding; x++) {
+			std::memcpy(row + x * bytes, sourceRow, bytes);
+			std::memcpy(row + (padding + region->size.x + x) * bytes, sourceRow + sourceRowLength - bytes, bytes);
+		}
+	}
+
+	auto &upload = uploads.emplace_back();
+	upload.region = *region;
+	upload.bitmap = std::move(padded);
+
+	auto &entry = entries[key];
+	entry.region = *region;
+	entry.lastUsed = updateCount;
+	return region;
+}
+
+std::optional<TextureAtlas::Region> TextureAtlas::Find(const std::string &key) {
+	auto it = entries.find(key);
+	if (it == entries.end())
+		return std::nullopt;
+
+	it->second.lastUsed = updateCount;
+	return it->second.region;
+}
+
+bool TextureAtlas::Remove(const std::string &key) {
+	auto it = entries.find(key);
+	if (it == entries.end())
+		return false;
+
+	auto region = it->second.region;
+	entries.erase(it);
+
+	uploads.erase(std::remove_if(uploads.begin(), uploads.end(), [&region](const PendingUpload &upload) {
+		return upload.region.layer == region.layer && upload.region.position == region.position;
+	}), uploads.end());
+	retiredRegions.push_back({region, 0});
+	return true;
+}
+
+float TextureAtlas::GetOccupancy() const {
+	if (packers.empty())
+		return 0.0f;
+
+	auto occupancy = 0.0f;
+	for (const auto &packer : packers)
+		occupancy += packer.GetOccupancy();
+	return occupancy / static_cast<float>(packers.size());
+}
+
+std::optional<TextureAtlas::Region> TextureAtlas::Pack(const Vector2ui &size) {
+	Vector2ui paddedSize(size.x + padding * 2, size.y + padding * 2);
+	if (size.x == 0 || size.y == 0 || paddedSize.x > layerSize.x || paddedSize.y > layerSize.y)
+		return std::nullopt;
+
+	// Existing layers are tried first, then a new layer, then space is taken from the least recently used images.
+	do {
+		for (uint32_t layer = 0; layer < packers.size(); layer++) {
+			if (auto position = packers[layer].Insert(paddedSize)) {
+				Region region;
+				region.layer = layer;
+				region.position = *position + Vector2ui(padding);
+				region.size = size;
+				region.uvOffset = Vector2f(region.position) / Vector2f(layerSize);
+				region.uvScale = Vector2f(size) / Vector2f(layerSize);
+				return region;
+			}
+		}
+	} while (AddLayer() || Evict());
+
+	return std::nullopt;
+}
+
+bool TextureAtlas::AddLayer() {
+	if (packers.size() >= maxLayers)
+		return false;
+
+	// The array image is grown on the next update, images packed into the layer are uploaded after it.
+	packers.emplace_back(layerSize);
+	return true;
+}
+
+bool TextureAtlas::Evict() {
+	// Only images unused for longer than frames can be in flight are evicted, so their space can be written over straight away.
+	auto oldest = entries.end();
+	for (auto it = entries.begin(); it != entries.end(); ++it) {
+		if (updateCount - it->second.lastUsed >= EvictUpdates && (oldest == entries.end() || it->second.lastUsed < oldest->second.lastUsed))
+			oldest = it;
+	}
+
+	if (oldest == entries.end())
+		return false;
+
+	Free(oldest->second.region);
+	entries.erase(oldest);
+	return true;
+}
+
+void TextureAtlas::Free(const Region &region) {
+	packers[region.layer].Remove(region.position - Vector2ui(padding), Vector2ui(region.size.x + padding * 2, region.size.y + padding * 2));
+}
+
+void TextureAtlas::Grow(uint32_t layerCount) {
+	auto grown = std::make_unique<Image2dArray>(layerSize, layerCount, format, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT);
+
+	// Layers already filled are copied into the grown image, the old image is held until frames in flight are done with it.
+	if (image) {
+		CommandBuffer commandBuffer;
+		Image::InsertImageMemoryBarrier(commandBuffer, image->GetImage(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, imageLayers, 0);
+		Image::InsertImageMemoryBarrier(commandBuffer, grown->GetImage(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, imageLayers, 0);
+
+		VkImageCopy region = {};
+		region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, imageLayers};
+		region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, imageLayers};
+		region.extent = {layerSize.x, layerSize.y, 1};
+		vkCmdCopyImage(commandBuffer, image->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, grown->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		Image::InsertImageMemoryBarrier(commandBuffer, image->GetImage(), VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, imageLayers, 0);
+		Image::InsertImageMemoryBarrier(commandBuffer, grown->GetImage(), VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, imageLayers, 0);
+		commandBuffer.SubmitIdle();
+
+		retiredImages.emplace_back(std::move(image), 0);
+	}
+
+	image = std::move(grown);
+}
+
+void TextureAtlas::Upload(const std::vector<PendingUpload> &uploads) {
+	// Every pending image is copied from one staging buffer in one submission.
+	std::vector<VkDeviceSize> offsets;
+	offsets.reserve(uploads.size());
+	VkDeviceSize stagingSize = 0;
+	for (const auto &upload : uploads) {
+		offsets.emplace_back(stagingSize);
+		stagingSize += (upload.bitmap->GetLength() + UploadAlignment - 1) / UploadAlignment * UploadAlignment;
+	}
+
+	Buffer bufferStaging(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	uint8_t *data;
+	bufferStaging.MapMemory(reinterpret_cast<void **>(&data));
+	std::vector<VkBufferImageCopy> regions(uploads.size());
+	for (std::size_t i = 0; i < uploads.size(); i++) {
+		const auto &upload = uploads[i];
+		std::memcpy(data + offsets[i], upload.bitmap->GetData().get(), upload.bitmap->GetLength());
+
+		regions[i].bufferOffset = offsets[i];
+		regions[i].imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, upload.region.layer, 1};
+		regions[i].imageOffset = {static_cast<int32_t>(upload.region.position.x - padding), static_cast<int32_t>(upload.region.position.y - padding), 0};
+		regions[i].imageExtent = {upload.bitmap->GetSize().x, upload.bitmap->GetSize().y, 1};
+	}
+	bufferStaging.UnmapMemory();
+
+	// Layers keep their contents through the transitions, only the packed regions are written.
+	CommandBuffer commandBuffer;
+	Image::InsertImageMemoryBarrier(commandBuffer, image->GetImage(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, imageLayers, 0);
+	vkCmdCopyBufferToImage(commandBuffer, bufferStaging.GetBuffer(), image->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()),
+		regions.data());
+	Image::InsertImageMemoryBarrier(commandBuffer, image->GetImage(), VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, imageLayers, 0);
+	commandBuffer.SubmitIdle();
+}
+}
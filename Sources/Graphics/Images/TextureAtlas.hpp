@@ -0,0 +1,150 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Utils/NonCopyable.hpp"
+#include "AtlasPacker.hpp"
+#include "Image2dArray.hpp"
+
+namespace acid {
+/**
+ * @brief Class that packs many small images into the layers of one array image, so objects drawing them can share a descriptor and be drawn together.
+ * Images are packed by key as they are added, and their pixels are uploaded together on the next update. When every layer is full a layer is added,
+ * up to a limit, after which images that have not been used for a while are evicted to make space.
+ * An evicted image's space is written over straight away, so a region must not be drawn in a update it was not found or added in.
+ */
+class ACID_EXPORT TextureAtlas : NonCopyable {
+public:
+	/**
+	 * @brief Class that represents where a image was packed.
+	 */
+	class Region {
+	public:
+		/**
+		 * Maps a coordinate across the added image to a coordinate in its layer.
+		 * @param uv The coordinate across the image, between 0 and 1.
+		 * @return The coordinate in the layer.
+		 */
+		Vector2f Remap(const Vector2f &uv) const { return uvOffset + uv * uvScale; }
+
+		uint32_t layer = 0;
+		/// The top left corner in pixels.
+		Vector2ui position;
+		Vector2ui size;
+		Vector2f uvOffset;
+		Vector2f uvScale;
+	};
+
+	/**
+	 * Creates a new texture atlas, no layers are created until a image is added.
+	 * @param layerSize The size of each layer in pixels.
+	 * @param maxLayers The number of layers the atlas can grow to.
+	 * @param padding The pixels around each image its edges are repeated into, so filtering does not blend in neighbouring images.
+	 * @param format The format of the layers, 8 bit RGBA added images are converted to.
+	 */
+	explicit TextureAtlas(const Vector2ui &layerSize = {2048, 2048}, uint32_t maxLayers = 4, uint32_t padding = 1, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
+
+	/**
+	 * Grows the array image when layers were added, uploads the pixels of images added since the last update,
+	 * and frees the space of removed images no longer used by frames in flight. Called on the main thread once before drawing each update.
+	 */
+	void Update();
+
+	/**
+	 * Packs a image into the atlas, its pixels are uploaded on the next update. A image already added with the key is not added again.
+	 * Packing can evict images that were not found or added in the last updates, their space is reused immediately.
+	 * The region is only valid for the update it was returned in, later updates must call {@link TextureAtlas#Find} before drawing it.
+	 * @param key The key the image is found by.
+	 * @param bitmap The pixels of the image, only the base level of the first layer is used.
+	 * @return The region the image was packed into, or no value if it does not fit, which the caller reports.
+	 */
+	std::optional<Region> Add(const std::string &key, const Bitmap &bitmap);
+
+	/**
+	 * Finds the region of a added image, marking it as used this update so it is not evicted.
+	 * Every update a image is drawn in must find it, a region kept from an earlier update may have been evicted and given to another image.
+	 * @param key The key the image was added with.
+	 * @return The region, or no value if no image was added with the key or it was evicted.
+	 */
+	std::optional<Region> Find(const std::string &key);
+
+	/**
+	 * Removes a image, its space is reused once frames in flight can no longer be drawing it.
+	 * @param key The key the image was added with.
+	 * @return If a image was removed.
+	 */
+	bool Remove(const std::string &key);
+
+	/**
+	 * Gets the part of the created layers covered by images.
+	 * @return The occupancy, between 0 and 1.
+	 */
+	float GetOccupancy() const;
+
+	const Image2dArray *GetImage() const { return image.get(); }
+	const Vector2ui &GetLayerSize() const { return layerSize; }
+	uint32_t GetLayerCount() const { return static_cast<uint32_t>(packers.size()); }
+	uint32_t GetMaxLayers() const { return maxLayers; }
+	std::size_t GetEntryCount() const { return entries.size(); }
+
+protected:
+	class PendingUpload {
+	public:
+		Region region;
+		/// The pixels with their padding.
+		std::unique_ptr<Bitmap> bitmap;
+	};
+
+	/**
+	 * Replaces the array image with one that has more layers, copying the layers already filled into it. Called from {@link TextureAtlas#Update}.
+	 * @param layerCount The number of layers to create.
+	 */
+	virtual void Grow(uint32_t layerCount);
+
+	/**
+	 * Copies the pixels of images into their regions, every image from one staging buffer in one submission. Called from {@link TextureAtlas#Update}.
+	 * @param uploads The images to upload.
+	 */
+	virtual void Upload(const std::vector<PendingUpload> &uploads);
+
+private:
+	class Entry {
+	public:
+		Region region;
+		/// The update the image was last added or found in.
+		uint32_t lastUsed = 0;
+	};
+
+	class RetiredRegion {
+	public:
+		Region region;
+		uint32_t updates = 0;
+	};
+
+	/// Updates a removed image keeps its space, more than the frames the GPU can have in flight.
+	static constexpr uint32_t RetireUpdates = 8;
+	/// Updates a image must go unused before it can be evicted.
+	static constexpr uint32_t EvictUpdates = 120;
+
+	std::optional<Region> Pack(const Vector2ui &size);
+	bool AddLayer();
+	bool Evict();
+	void Free(const Region &region);
+
+	Vector2ui layerSize;
+	uint32_t maxLayers;
+	uint32_t padding;
+	VkFormat format;
+
+	std::unique_ptr<Image2dArray> image;
+	/// The number of layers of the array image, behind the layer count until the next update when layers are added.
+	uint32_t imageLayers = 0;
+	std::vector<AtlasPacker> packers;
+	std::unordered_map<std::string, Entry> entries;
+	std::vector<PendingUpload> uploads;
+	std::vector<RetiredRegion> retiredRegions;
+	/// Images replaced when a layer was added, held while frames in flight may still be drawing them.
+	std::vector<std::pair<std::unique_ptr<Image2dArray>, uint32_t>> retiredImages;
+	uint32_t updateCount = 0;
+};
+}
@@ -0,0 +1,193 @@
+#include "TextureStreamer.hpp"
+
+#include "Image2d.hpp"
+
+namespace acid {
+void TextureStreamer::Update() {
+	UpdateLoads();
+	UpdateTargets();
+
+	// Loads are started for the images furthest from their target first, streaming levels in before streaming them out.
+	std::vector<std::pair<int64_t, StreamedImage *>> changes;
+	uint32_t pendingLoads = 0;
+
+	for (auto &[key, streamed] : images) {
+		if (streamed.load.valid()) {
+			pendingLoads++;
+			continue;
+		}
+
+		auto image = streamed.image.lock();
+		if (image && image->GetStoredBitmap() && image->GetResidentLevel() != streamed.targetLevel)
+			changes.emplace_back(static_cast<int64_t>(image->GetResidentLevel()) - static_cast<int64_t>(streamed.targetLevel), &streamed);
+	}
+
+	std::sort(changes.begin(), changes.end(), [](const auto &a, const auto &b) {
+		return a.first > b.first;
+	});
+
+	for (auto &[difference, streamed] : changes) {
+		if (pendingLoads >= maxLoads)
+			break;
+
+		// Only the copy of the levels is made in the background, images are created and uploaded on the main thread.
+		streamed->loadSource = streamed->image.lock()->GetStoredBitmap();
+		streamed->loadLevel = streamed->targetLevel;
+		streamed->load = Resources::Get()->GetThreadPool().Enqueue([source = streamed->loadSource, level = streamed->loadLevel] {
+			return Image2d::CopyLevels(*source, level);
+		});
+		pendingLoads++;
+	}
+
+	for (auto &[key, streamed] : images) {
+		streamed.requestedLevel = std::nullopt;
+		streamed.idleUpdates++;
+	}
+}
+
+void TextureStreamer::Request(const std::shared_ptr<Image2d> &image, float screenSize) {
+	if (!image || !image->IsStreamable())
+		return;
+
+	auto level = GetRequestedLevel(image->GetStoredSize(), image->GetStoredMipLevels(), screenSize);
+	auto &streamed = images[image.get()];
+	streamed.image = image;
+	streamed.requestedLevel = std::min(streamed.requestedLevel.value_or(level), level);
+	streamed.idleUpdates = 0;
+}
+
+uint32_t TextureStreamer::GetInitialLevel(const Vector2ui &size, uint32_t mipLevels) const {
+	auto maxSize = std::max(size.x, size.y);
+	uint32_t level = 0;
+	while (level + 1 < mipLevels && (maxSize >> level) > initialSize)
+		level++;
+	return level;
+}
+
+uint32_t TextureStreamer::GetRequestedLevel(const Vector2ui &size, uint32_t mipLevels, float screenSize) {
+	if (screenSize <= 0.0f)
+		return mipLevels - 1;
+
+	// Each level down halves the size.
+	auto maxSize = static_cast<float>(std::max(size.x, size.y));
+	return static_cast<uint32_t>(std::clamp(std::floor(std::log2(maxSize / screenSize)), 0.0f, static_cast<float>(mipLevels - 1)));
+}
+
+uint32_t TextureStreamer::GetTargetLevel(std::optional<uint32_t> requestedLevel, uint32_t idleUpdates, uint32_t residentLevel, uint32_t initialLevel) {
+	if (requestedLevel)
+		return std::min(*requestedLevel, initialLevel);
+	// Images that flicker out of view keep their levels until they have been idle for a while.
+	if (idleUpdates >= EvictUpdates)
+		return initialLevel;
+	return std::min(residentLevel, initialLevel);
+}
+
+std::size_t TextureStreamer::FitBudget(std::vector<Target> &targets, std::size_t budget) {
+	std::size_t totalBytes = 0;
+	for (const auto &target : targets)
+		totalBytes += GetLevelBytes(target.size, target.format, target.mipLevels, target.level);
+
+	while (totalBytes > budget) {
+		Target *largest = nullptr;
+		std::size_t largestBytes = 0;
+
+		for (auto &target : targets) {
+			if (target.level >= target.initialLevel)
+				continue;
+
+			auto bytes = GetLevelBytes(target.size, target.format, target.mipLevels, target.level);
+			if (bytes > largestBytes) {
+				largest = &target;
+				largestBytes = bytes;
+			}
+		}
+
+		if (!largest)
+			break;
+
+		largest->level++;
+		totalBytes -= largestBytes - GetLevelBytes(largest->size, largest->format, largest->mipLevels, largest->level);
+	}
+
+	return totalBytes;
+}
+
+float TextureStreamer::GetScreenSize(float radius, float distance, float fieldOfView, float screenHeight) {
+	// Objects the camera is inside of cover the whole screen.
+	if (distance <= radius)
+		return screenHeight;
+	return radius * screenHeight / (distance * std::tan(fieldOfView / 2.0f));
+}
+
+std::size_t TextureStreamer::GetLevelBytes(const Image2d &image, uint32_t level) {
+	return GetLevelBytes(image.GetStoredSize(), static_cast<PixelFormat>(image.GetFormat()), image.GetStoredMipLevels(), level);
+}
+
+std::size_t TextureStreamer::GetLevelBytes(const Vector2ui &size, PixelFormat format, uint32_t mipLevels, uint32_t level) {
+	Bitmap chain(nullptr, size, format, mipLevels);
+	return chain.GetLength() - chain.GetLevelOffset(std::min(level, mipLevels - 1));
+}
+
+std::size_t TextureStreamer::GetResidentBytes() const {
+	std::size_t residentBytes = 0;
+	for (const auto &[key, streamed] : images) {
+		if (auto image = streamed.image.lock())
+			residentBytes += GetLevelBytes(*image, image->GetResidentLevel());
+	}
+	return residentBytes;
+}
+
+void TextureStreamer::UpdateLoads() {
+	for (auto it = images.begin(); it != images.end();) {
+		auto &streamed = it->second;
+
+		if (streamed.load.valid() && streamed.load.wait_for(0s) == std::future_status::ready) {
+			try {
+				auto levels = streamed.load.get();
+				auto image = streamed.image.lock();
+				if (levels && image && image->GetStoredBitmap() == streamed.loadSource) {
+					auto copy = image->CreateResident(std::move(levels), streamed.loadLevel);
+					image->Swap(*copy);
+					// The copy now holds the old levels, which may still be used by frames in flight.
+					Resources::Get()->Retire(std::move(copy));
+				}
+			} catch (const std::exception &e) {
+				Log::Error("Failed to stream image: ", e.what(), '\n');
+			}
+			streamed.loadSource = nullptr;
+		}
+
+		// Images no longer used are forgotten once their loads are finished.
+		if (streamed.image.expired() && !streamed.load.valid()) {
+			it = images.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+}
+
+void TextureStreamer::UpdateTargets() {
+	std::vector<StreamedImage *> live;
+	std::vector<Target> targets;
+
+	for (auto &[key, streamed] : images) {
+		auto image = streamed.image.lock();
+		if (!image)
+			continue;
+
+		auto &target = targets.emplace_back();
+		target.size = image->GetStoredSize();
+		target.mipLevels = image->GetStoredMipLevels();
+		target.format = static_cast<PixelFormat>(image->GetFormat());
+		target.initialLevel = GetInitialLevel(target.size, target.mipLevels);
+		target.level = GetTargetLevel(streamed.requestedLevel, streamed.idleUpdates, image->GetResidentLevel(), target.initialLevel);
+		live.emplace_back(&streamed);
+	}
+
+	FitBudget(targets, budget);
+
+	for (std::size_t i = 0; i < live.size(); i++)
+		live[i]->targetLevel = targets[i].level;
+}
+}
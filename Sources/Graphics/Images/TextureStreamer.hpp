@@ -0,0 +1,162 @@
+#pragma once
+
+#include <future>
+#include <unordered_map>
+
+#include "Bitmaps/Bitmap.hpp"
+#include "Engine/Engine.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Resources/Resources.hpp"
+
+namespace acid {
+class Image2d;
+
+/**
+ * @brief Module that streams the mip levels of images in and out, keeping the levels they are drawn at resident under a memory budget.
+ * Only images created with streaming enabled are streamed, they first load only their smallest levels. Each update the level wanted by requests is copied from the levels
+ * the image keeps in the background, then uploaded on the main thread. Images that are no longer requested fall back to their initial levels,
+ * and when the wanted levels do not fit the budget the least visible images are given less.
+ */
+class ACID_EXPORT TextureStreamer : public Module::Registrar<TextureStreamer> {
+	inline static const bool Registered = Register(Stage::Post, Requires<Graphics, Resources>());
+public:
+	/**
+	 * @brief Class that holds the levels of a streamed image while the targets of a update are fitted to the budget.
+	 */
+	class Target {
+	public:
+		/// The size of the first level stored.
+		Vector2ui size;
+		/// The number of levels stored.
+		uint32_t mipLevels = 1;
+		PixelFormat format = PixelFormat::R8G8B8A8Unorm;
+		/// The level the image is first loaded with, targets are never raised past it.
+		uint32_t initialLevel = 0;
+		/// The level of the full chain the image should have resident.
+		uint32_t level = 0;
+	};
+
+	TextureStreamer() = default;
+
+	void Update() override;
+
+	/**
+	 * Requests the levels of an image needed to draw it at a size on screen this update, the largest size requested in a update is kept. Called on the main thread.
+	 * @param image The image, images that can not be streamed are ignored.
+	 * @param screenSize The size the image covers on screen in pixels.
+	 */
+	void Request(const std::shared_ptr<Image2d> &image, float screenSize);
+
+	/**
+	 * Gets the level a streamed image is first loaded with, so the base level is no larger than the initial size.
+	 * @param size The size of the first level stored.
+	 * @param mipLevels The number of levels stored.
+	 * @return The level.
+	 */
+	uint32_t GetInitialLevel(const Vector2ui &size, uint32_t mipLevels) const;
+
+	/**
+	 * Gets the level needed to draw an image at a size on screen, the level closest to a pixel for every texel.
+	 * @param size The size of the first level stored.
+	 * @param mipLevels The number of levels stored.
+	 * @param screenSize The size the image covers on screen in pixels.
+	 * @return The level.
+	 */
+	static uint32_t GetRequestedLevel(const Vector2ui &size, uint32_t mipLevels, float screenSize);
+
+	/**
+	 * Gets the level a image should have resident before the budget is applied.
+	 * @param requestedLevel The smallest level requested this update, or no value when the image was not requested.
+	 * @param idleUpdates Updates since the image was last requested.
+	 * @param residentLevel The level the image has resident.
+	 * @param initialLevel The level the image is first loaded with.
+	 * @return The level.
+	 */
+	static uint32_t GetTargetLevel(std::optional<uint32_t> requestedLevel, uint32_t idleUpdates, uint32_t residentLevel, uint32_t initialLevel);
+
+	/**
+	 * Raises the levels of targets until they fit a budget, the target taking the most memory drops its largest level first.
+	 * Targets already at their initial level are kept, so the levels may still be over the budget.
+	 * @param targets The targets to fit.
+	 * @param budget The budget in bytes.
+	 * @return The number of bytes the levels of the targets take.
+	 */
+	static std::size_t FitBudget(std::vector<Target> &targets, std::size_t budget);
+
+	/**
+	 * Estimates the size on screen of a object from its bounds, for textures that are mapped once across it.
+	 * @param radius The bounding radius of the object in world space.
+	 * @param distance The distance from the camera to the object.
+	 * @param fieldOfView The vertical field of view of the camera in radians.
+	 * @param screenHeight The height of the screen in pixels.
+	 * @return The size across the screen in pixels.
+	 */
+	static float GetScreenSize(float radius, float distance, float fieldOfView, float screenHeight);
+
+	/**
+	 * Gets the number of bytes the levels of a image take from a level down.
+	 * @param image The image.
+	 * @param level The level of the full chain.
+	 * @return The size in bytes.
+	 */
+	static std::size_t GetLevelBytes(const Image2d &image, uint32_t level);
+
+	/**
+	 * Gets the number of bytes the levels of a mip chain take from a level down.
+	 * @param size The size of the first level.
+	 * @param format The format of the levels.
+	 * @param mipLevels The number of levels in the chain.
+	 * @param level The level of the chain.
+	 * @return The size in bytes.
+	 */
+	static std::size_t GetLevelBytes(const Vector2ui &size, PixelFormat format, uint32_t mipLevels, uint32_t level);
+
+	/**
+	 * Gets the number of bytes the resident levels of every streamed image take.
+	 * @return The resident size in bytes.
+	 */
+	std::size_t GetResidentBytes() const;
+
+	std::size_t GetBudget() const { return budget; }
+	/**
+	 * Sets the memory streamed images can take, the initial levels of each image are always kept.
+	 * @param budget The budget in bytes.
+	 */
+	void SetBudget(std::size_t budget) { this->budget = budget; }
+
+	uint32_t GetInitialSize() const { return initialSize; }
+	void SetInitialSize(uint32_t initialSize) { this->initialSize = initialSize; }
+
+	uint32_t GetMaxLoads() const { return maxLoads; }
+	void SetMaxLoads(uint32_t maxLoads) { this->maxLoads = maxLoads; }
+
+private:
+	class StreamedImage {
+	public:
+		std::weak_ptr<Image2d> image;
+		/// The smallest level requested this update, or no value when the image was not requested.
+		std::optional<uint32_t> requestedLevel;
+		/// The level the budget allows, chosen each update.
+		uint32_t targetLevel = 0;
+		/// Updates since the image was last requested.
+		uint32_t idleUpdates = 0;
+		/// Levels being copied from the stored bitmap, uploaded on the main thread once ready.
+		std::future<std::unique_ptr<Bitmap>> load;
+		/// The stored bitmap being copied from, the levels are discarded if the image was reloaded meanwhile.
+		std::shared_ptr<const Bitmap> loadSource;
+		uint32_t loadLevel = 0;
+	};
+
+	/// Updates a image is kept at its requested levels after it was last requested, so images that flicker out of view are not evicted.
+	static constexpr uint32_t EvictUpdates = 120;
+
+	void UpdateLoads();
+	void UpdateTargets();
+
+	std::unordered_map<const Image2d *, StreamedImage> images;
+
+	std::size_t budget = 512 * 1024 * 1024;
+	uint32_t initialSize = 64;
+	uint32_t maxLoads = 2;
+};
+}
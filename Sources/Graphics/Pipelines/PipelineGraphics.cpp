@@ -2,12 +2,13 @@
 
 #include "Graphics/Graphics.hpp"
 #include "Files/Files.hpp"
+#include "Resources/Resources.hpp"
 
 namespace acid {
 const std::vector<VkDynamicState> DYNAMIC_STATES = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_LINE_WIDTH};
 
 PipelineGraphics::PipelineGraphics(Stage stage, std::vector<std::filesystem::path> shaderStages, std::vector<Shader::VertexInput> vertexInputs, std::vector<Shader::Define> defines,
-	Mode mode, Depth depth, VkPrimitiveTopology topology, VkPolygonMode polygonMode, VkCullModeFlags cullMode, VkFrontFace frontFace, bool pushDescriptors) :
+	Mode mode, Depth depth, VkPrimitiveTopology topology, VkPolygonMode polygonMode, VkCullModeFlags cullMode, VkFrontFace frontFace, bool pushDescriptors, bool load) :
 	stage(std::move(stage)),
 	shaderStages(std::move(shaderStages)),
 	vertexInputs(std::move(vertexInputs)),
@@ -19,37 +20,35 @@ PipelineGraphics::PipelineGraphics(Stage stage, std::vector<std::filesystem::pat
 	cullMode(cullMode),
 	frontFace(frontFace),
 	pushDescriptors(pushDescriptors),
+	tracked(load),
 	shader(std::make_unique<Shader>()),
 	dynamicStates(DYNAMIC_STATES),
 	pipelineBindPoint(VK_PIPELINE_BIND_POINT_GRAPHICS) {
+	std::sort(this->vertexInputs.begin(), this->vertexInputs.end());
+
+	if (!load)
+		return;
+
 #if defined(ACID_DEBUG)
 	auto debugStart = Time::Now();
 #endif
 
-	std::sort(this->vertexInputs.begin(), this->vertexInputs.end());
-	CreateShaderProgram();
-	CreateDescriptorLayout();
-	CreateDescriptorPool();
-	CreatePipelineLayout();
-	CreateAttributes();
-
-	switch (mode) {
-	case Mode::Polygon:
-		CreatePipelinePolygon();
-		break;
-	case Mode::MRT:
-		CreatePipelineMrt();
-		break;
-	default:
-		throw std::runtime_error("Unknown pipeline mode");
-	}
+	CompileShaderProgram();
+	PipelineGraphics::Upload();
 
 #if defined(ACID_DEBUG)
 	Log::Out("Pipeline Graphics ", this->shaderStages.back(), " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
 #endif
+
+	// Pipelines are owned by their subrenders, so they are tracked for hot reload instead of found by node.
+	if (auto resources = Resources::Get())
+		resources->Track(this);
 }
 
 PipelineGraphics::~PipelineGraphics() {
+	if (auto resources = Resources::Get(); resources && tracked)
+		resources->Untrack(this);
+
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
 	for (const auto &shaderModule : modules)
@@ -73,7 +72,48 @@ RenderArea PipelineGraphics::GetRenderArea(const std::optional<uint32_t> &stage)
 	return Graphics::Get()->GetRenderStage(stage ? *stage : this->stage.first)->GetRenderArea();
 }
 
-void PipelineGraphics::CreateShaderProgram() {
+std::shared_ptr<Resource> PipelineGraphics::Reload() const {
+	// The copy only holds the old objects once swapped, so it is never tracked or reloaded itself.
+	auto pipeline = std::make_shared<PipelineGraphics>(stage, shaderStages, vertexInputs, defines, mode, depth, topology, polygonMode, cullMode, frontFace,
+		pushDescriptors, false);
+	// Compiling is the slow part, the modules and pipeline are created from the SPIR-V by Upload.
+	pipeline->CompileShaderProgram();
+	return pipeline;
+}
+
+void PipelineGraphics::Upload() {
+	CreateShaderProgram();
+	CreateDescriptorLayout();
+	CreateDescriptorPool();
+	CreatePipelineLayout();
+	CreateAttributes();
+
+	switch (mode) {
+	case Mode::Polygon:
+		CreatePipelinePolygon();
+		break;
+	case Mode::MRT:
+		CreatePipelineMrt();
+		break;
+	default:
+		throw std::runtime_error("Unknown pipeline mode");
+	}
+}
+
+void PipelineGraphics::Swap(Resource &other) {
+	Resource::Swap(other);
+	auto &pipeline = dynamic_cast<PipelineGraphics &>(other);
+	// Descriptor handlers are rebuilt when they see the new shader.
+	std::swap(shader, pipeline.shader);
+	std::swap(modules, pipeline.modules);
+	std::swap(stages, pipeline.stages);
+	std::swap(descriptorSetLayout, pipeline.descriptorSetLayout);
+	std::swap(descriptorPool, pipeline.descriptorPool);
+	std::swap(this->pipeline, pipeline.pipeline);
+	std::swap(pipelineLayout, pipeline.pipelineLayout);
+}
+
+void PipelineGraphics::CompileShaderProgram() {
 	std::stringstream defineBlock;
 	for (const auto &[defineName, defineValue] : defines)
 		defineBlock << "#define " << defineName << " " << defineValue << '\n';
@@ -84,19 +124,29 @@ void PipelineGraphics::CreateShaderProgram() {
 		if (!fileLoaded)
 			throw std::runtime_error("Could not create pipeline, missing shader stage");
 
-		auto stageFlag = Shader::GetShaderStage(shaderStage);
-		auto shaderModule = shader->CreateShaderModule(shaderStage, *fileLoaded, defineBlock.str(), stageFlag);
+		stageCode.emplace_back(shader->CompileShaderModule(shaderStage, *fileLoaded, defineBlock.str(), Shader::GetShaderStage(shaderStage)));
+	}
+
+	shader->CreateReflection();
+
+	dependencies = shaderStages;
+	dependencies.insert(dependencies.end(), shader->GetIncludes().begin(), shader->GetIncludes().end());
+}
+
+void PipelineGraphics::CreateShaderProgram() {
+	for (std::size_t i = 0; i < shaderStages.size(); i++) {
+		auto shaderModule = Shader::CreateShaderModule(stageCode[i]);
 
 		VkPipelineShaderStageCreateInfo pipelineShaderStageCreateInfo = {};
 		pipelineShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		pipelineShaderStageCreateInfo.stage = stageFlag;
+		pipelineShaderStageCreateInfo.stage = Shader::GetShaderStage(shaderStages[i]);
 		pipelineShaderStageCreateInfo.module = shaderModule;
 		pipelineShaderStageCreateInfo.pName = "main";
 		stages.emplace_back(pipelineShaderStageCreateInfo);
 		modules.emplace_back(shaderModule);
 	}
 
-	shader->CreateReflection();
+	stageCode.clear();
 }
 
 void PipelineGraphics::CreateDescriptorLayout() {
@@ -4,6 +4,7 @@
 
 #include "Maths/Vector2.hpp"
 #include "Files/Node.hpp"
+#include "Resources/Resource.hpp"
 #include "Pipeline.hpp"
 #include "Graphics/RenderStage.hpp"
 
@@ -14,7 +15,7 @@ class Image2d;
 /**
  * @brief Class that represents a graphics pipeline.
  */
-class ACID_EXPORT PipelineGraphics : public Pipeline {
+class ACID_EXPORT PipelineGraphics : public Pipeline, public Resource {
 public:
 	enum class Mode {
 		Polygon, MRT
@@ -40,10 +41,11 @@ public:
 	 * @param cullMode The vertex cull mode.
 	 * @param frontFace The direction to render faces.
 	 * @param pushDescriptors If no actual descriptor sets are allocated but instead pushed.
+	 * @param load If the pipeline is created and tracked for hot reload immediately, otherwise it is an untracked reload copy created by {@link PipelineGraphics#Upload}.
 	 */
 	PipelineGraphics(Stage stage, std::vector<std::filesystem::path> shaderStages, std::vector<Shader::VertexInput> vertexInputs, std::vector<Shader::Define> defines = {},
 		Mode mode = Mode::Polygon, Depth depth = Depth::ReadWrite, VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL, 
-		VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT, VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE, bool pushDescriptors = false);
+		VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT, VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE, bool pushDescriptors = false, bool load = true);
 	~PipelineGraphics();
 
 	/**
@@ -68,6 +70,11 @@ public:
 	 */
 	RenderArea GetRenderArea(const std::optional<uint32_t> &stage = std::nullopt) const;
 
+	std::type_index GetTypeIndex() const override { return typeid(PipelineGraphics); }
+	std::shared_ptr<Resource> Reload() const override;
+	void Upload() override;
+	void Swap(Resource &other) override;
+
 	const Stage &GetStage() const { return stage; }
 	const std::vector<std::filesystem::path> &GetShaderStages() const { return shaderStages; }
 	const std::vector<Shader::VertexInput> &GetVertexInputs() const { return vertexInputs; }
@@ -87,6 +94,7 @@ public:
 	const VkPipelineBindPoint &GetPipelineBindPoint() const override { return pipelineBindPoint; }
 
 private:
+	void CompileShaderProgram();
 	void CreateShaderProgram();
 	void CreateDescriptorLayout();
 	void CreateDescriptorPool();
@@ -107,8 +115,12 @@ private:
 	VkCullModeFlags cullMode;
 	VkFrontFace frontFace;
 	bool pushDescriptors;
+	/// If the pipeline is tracked for hot reload, reload copies are not.
+	bool tracked;
 
 	std::unique_ptr<Shader> shader;
+	/// SPIR-V compiled for each shader stage, until the modules are created.
+	std::vector<std::vector<uint32_t>> stageCode;
 
 	std::vector<VkDynamicState> dynamicStates;
 
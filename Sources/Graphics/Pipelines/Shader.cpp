@@ -17,8 +17,13 @@ namespace acid {
 class ShaderIncluder :
 	public glslang::TShader::Includer {
 public:
+	explicit ShaderIncluder(std::vector<std::filesystem::path> &includes) :
+		includes(includes) {
+	}
+
 	IncludeResult *includeLocal(const char *headerName, const char *includerName, size_t inclusionDepth) override {
 		auto directory = std::filesystem::path(includerName).parent_path();
+		AddInclude(directory / headerName);
 		auto fileLoaded = Files::Read(directory / headerName);
 
 		if (!fileLoaded) {
@@ -32,6 +37,7 @@ public:
 	}
 
 	IncludeResult *includeSystem(const char *headerName, const char *includerName, size_t inclusionDepth) override {
+		AddInclude(headerName);
 		auto fileLoaded = Files::Read(headerName);
 
 		if (!fileLoaded) {
@@ -50,6 +56,14 @@ public:
 			delete result;
 		}
 	}
+
+private:
+	void AddInclude(const std::filesystem::path &filename) {
+		if (std::find(includes.begin(), includes.end(), filename) == includes.end())
+			includes.emplace_back(filename);
+	}
+
+	std::vector<std::filesystem::path> &includes;
 };
 
 Shader::Shader() {
@@ -289,8 +303,11 @@ TBuiltInResource GetResources() {
 }
 
 VkShaderModule Shader::CreateShaderModule(const std::filesystem::path &moduleName, const std::string &moduleCode, const std::string &preamble, VkShaderStageFlags moduleFlag) {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	return CreateShaderModule(CompileShaderModule(moduleName, moduleCode, preamble, moduleFlag));
+}
 
+std::vector<uint32_t> Shader::CompileShaderModule(const std::filesystem::path &moduleName, const std::string &moduleCode, const std::string &preamble,
+	VkShaderStageFlags moduleFlag) {
 	stages.emplace_back(moduleName);
 
 	// Starts converting GLSL to SPIR-V.
@@ -316,7 +333,7 @@ VkShaderModule Shader::CreateShaderModule(const std::filesystem::path &moduleNam
 	shader.setEnvClient(glslang::EShClientVulkan, defaultVersion);
 	shader.setEnvTarget(glslang::EShTargetSpv, volkGetInstanceVersion() >= VK_API_VERSION_1_1 ? glslang::EShTargetSpv_1_3 : glslang::EShTargetSpv_1_0);
 
-	ShaderIncluder includer;
+	ShaderIncluder includer(includes);
 
 	std::string str;
 
@@ -369,6 +386,11 @@ VkShaderModule Shader::CreateShaderModule(const std::filesystem::path &moduleNam
 	spv::SpvBuildLogger logger;
 	std::vector<uint32_t> spirv;
 	GlslangToSpv(*program.getIntermediate(static_cast<EShLanguage>(language)), spirv, &logger, &spvOptions);
+	return spirv;
+}
+
+VkShaderModule Shader::CreateShaderModule(const std::vector<uint32_t> &spirv) {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
 	VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
 	shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -287,9 +287,26 @@ public:
 	std::optional<VkDescriptorType> GetDescriptorType(uint32_t location) const;
 	static VkShaderStageFlagBits GetShaderStage(const std::filesystem::path &filename);
 	VkShaderModule CreateShaderModule(const std::filesystem::path &moduleName, const std::string &moduleCode, const std::string &preamble, VkShaderStageFlags moduleFlag);
+
+	/**
+	 * Compiles a module to SPIR-V and reflects its descriptors, without using the device so it can be called on a resource thread.
+	 * @param moduleName The file the module is loaded from.
+	 * @param moduleCode The GLSL source.
+	 * @param preamble The defines added before the source.
+	 * @param moduleFlag The stage of the module.
+	 * @return The SPIR-V code, created with {@link Shader#CreateShaderModule}.
+	 */
+	std::vector<uint32_t> CompileShaderModule(const std::filesystem::path &moduleName, const std::string &moduleCode, const std::string &preamble, VkShaderStageFlags moduleFlag);
+	static VkShaderModule CreateShaderModule(const std::vector<uint32_t> &spirv);
 	void CreateReflection();
 
 	const std::filesystem::path &GetName() const { return stages.back(); }
+
+	/**
+	 * Gets the files included by the shader modules, so they can be watched along with the stages.
+	 * @return The included files.
+	 */
+	const std::vector<std::filesystem::path> &GetIncludes() const { return includes; }
 	uint32_t GetLastDescriptorBinding() const { return lastDescriptorBinding; }
 	const std::map<std::string, Uniform> &GetUniforms() const { return uniforms; };
 	const std::map<std::string, UniformBlock> &GetUniformBlocks() const { return uniformBlocks; };
@@ -311,6 +328,7 @@ private:
 	static int32_t ComputeSize(const glslang::TType *ttype);
 
 	std::vector<std::filesystem::path> stages;
+	std::vector<std::filesystem::path> includes;
 	std::map<std::string, Uniform> uniforms;
 	std::map<std::string, UniformBlock> uniformBlocks;
 	std::map<std::string, Attribute> attributes;
@@ -1,23 +1,11 @@
 #include "Gui.hpp"
 
-#include "Graphics/Graphics.hpp"
+#include "Engine/Engine.hpp"
 #include "Uis/Drivers/ConstantDriver.hpp"
-#include "Models/Vertex2d.hpp"
+#include "GuiBatch.hpp"
 
 namespace acid {
-static const std::vector<Vertex2d> VERTICES = {
-	{{0.0f, 0.0f}, {0.0f, 0.0f}},
-	{{1.0f, 0.0f}, {1.0f, 0.0f}},
-	{{1.0f, 1.0f}, {1.0f, 1.0f}},
-	{{0.0f, 1.0f}, {0.0f, 1.0f}}
-};
-static const std::vector<uint32_t> INDICES = {
-	0, 1, 2,
-	2, 3, 0
-};
-
 Gui::Gui() :
-	model(std::make_unique<Model>(VERTICES, INDICES)),
 	colourDriver(std::make_unique<ConstantDriver<Colour>>(Colour::White)) {
 }
 
@@ -28,42 +16,45 @@ void Gui::UpdateObject() {
 	atlasOffset = Vector2f(static_cast<float>(column), static_cast<float>(row)) / static_cast<float>(numberOfRows);
 
 	colourDriver->Update(Engine::Get()->GetDelta());
-
-	// Updates uniforms.
-	uniformObject.Push("modelView", GetModelView());
-	uniformObject.Push("alpha", GetScreenAlpha());
-
-	uniformObject.Push("aspectRatio", static_cast<float>(GetScreenSize().x) / static_cast<float>(GetScreenSize().y));
-
-	uniformObject.Push("colourOffset", colourDriver->Get());
-	uniformObject.Push("atlasOffset", atlasOffset);
-	uniformObject.Push("atlasScale", atlasScale);
-	uniformObject.Push("atlasRows", static_cast<float>(numberOfRows));
-	uniformObject.Push("ninePatches", ninePatches);
 }
 
-bool Gui::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline) {
-	// Gets if this should be rendered.
+void Gui::AddQuads(GuiBatch &batch) const {
 	if (!image || !IsEnabled())
-		return false;
-
-	// Updates descriptors.
-	descriptorSet.Push("UniformObject", uniformObject);
-	descriptorSet.Push("samplerColour", image);
-
-	if (!descriptorSet.Update(pipeline))
-		return false;
-
-	auto scissor = GetScissor();
-	VkRect2D scissorRect = {};
-	scissorRect.offset.x = scissor ? static_cast<int32_t>(scissor->x) : 0;
-	scissorRect.offset.y = scissor ? static_cast<int32_t>(scissor->y) : 0;
-	scissorRect.extent.width = scissor ? static_cast<int32_t>(scissor->z) : Window::Get()->GetSize().x;
-	scissorRect.extent.height = scissor ? static_cast<int32_t>(scissor->w) : Window::Get()->GetSize().y;
-	vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
-
-	// Draws the object.
-	descriptorSet.BindDescriptor(commandBuffer, pipeline);
-	return model->CmdRender(commandBuffer);
+		return;
+
+	auto colour = colourDriver->Get();
+	colour.a *= GetScreenAlpha();
+
+	// Coordinates across the object are mapped into the selected cell of the image, then scaled.
+	auto rows = static_cast<float>(numberOfRows);
+	auto toUv = [&](float x, float y) {
+		return atlasScale * (Vector2f(x, y) / rows + atlasOffset);
+	};
+
+	if (ninePatches == Vector4f()) {
+		auto min = toUv(0.0f, 0.0f), max = toUv(1.0f, 1.0f);
+		batch.AddQuad(GetModelView(), {0.0f, 0.0f, 1.0f, 1.0f}, {min.x, min.y, max.x, max.y}, colour, image, GetScissor());
+		return;
+	}
+
+	// The corner patches of the image keep its aspect across the object, the edges and center stretch.
+	auto aspectRatio = static_cast<float>(GetScreenSize().x) / static_cast<float>(GetScreenSize().y);
+	auto borderX = std::min(ninePatches.x / aspectRatio, 0.5f);
+	auto borderY = std::min(ninePatches.y, 0.5f);
+	const float positionsX[4] = {0.0f, borderX, 1.0f - borderX, 1.0f};
+	const float positionsY[4] = {0.0f, borderY, 1.0f - borderY, 1.0f};
+	const float uvsX[4] = {0.0f, ninePatches.x, 1.0f - ninePatches.x, 1.0f};
+	const float uvsY[4] = {0.0f, ninePatches.y, 1.0f - ninePatches.y, 1.0f};
+
+	for (uint32_t y = 0; y < 3; y++) {
+		for (uint32_t x = 0; x < 3; x++) {
+			if (positionsX[x] >= positionsX[x + 1] || positionsY[y] >= positionsY[y + 1])
+				continue;
+
+			auto min = toUv(uvsX[x], uvsY[y]), max = toUv(uvsX[x + 1], uvsY[y + 1]);
+			batch.AddQuad(GetModelView(), {positionsX[x], positionsY[y], positionsX[x + 1], positionsY[y + 1]}, {min.x, min.y, max.x, max.y}, colour, image,
+				GetScissor());
+		}
+	}
 }
 }
@@ -2,14 +2,12 @@
 
 #include "Maths/Colour.hpp"
 #include "Maths/Vector2.hpp"
-#include "Models/Model.hpp"
-#include "Graphics/Buffers/UniformHandler.hpp"
-#include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Images/Image2d.hpp"
-#include "Graphics/Pipelines/PipelineGraphics.hpp"
 #include "Uis/UiObject.hpp"
 
 namespace acid {
+class GuiBatch;
+
 /**
  * @brief Class that represents a image UI.
  */
@@ -19,7 +17,11 @@ public:
 
 	void UpdateObject() override;
 
-	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline);
+	/**
+	 * Adds the quads of this image to a batch, nine patches are split into a quad for each patch.
+	 * @param batch The batch to add to.
+	 */
+	void AddQuads(GuiBatch &batch) const;
 
 	const std::shared_ptr<Image2d> &GetImage() const { return image; }
 	void SetImage(const std::shared_ptr<Image2d> &image) { this->image = image; }
@@ -51,10 +53,6 @@ public:
 	}
 
 private:
-	DescriptorsHandler descriptorSet;
-	UniformHandler uniformObject;
-
-	std::unique_ptr<Model> model;
 	std::shared_ptr<Image2d> image;
 	uint32_t numberOfRows = 1;
 	uint32_t selectedRow = 0;
@@ -0,0 +1,107 @@
+#include "GuiBatch.hpp"
+
+#include <algorithm>
+
+namespace acid {
+static bool Overlaps(const Vector4f &a, const Vector4f &b) {
+	return a.x < b.z && b.x < a.z && a.y < b.w && b.y < a.w;
+}
+
+void GuiBatch::Clear() {
+	quads.clear();
+	images.clear();
+	imageIndices.clear();
+}
+
+void GuiBatch::AddQuad(const Matrix4 &modelView, const Vector4f &rect, const Vector4f &uvRect, const Colour &colour, const std::shared_ptr<Descriptor> &image,
+	const std::optional<Vector4i> &scissor) {
+	auto [it, inserted] = imageIndices.try_emplace(image.get(), static_cast<uint32_t>(images.size()));
+	if (inserted)
+		images.emplace_back(image);
+
+	auto &quad = quads.emplace_back();
+	quad.image = it->second;
+	quad.scissor = scissor;
+
+	// Corners are wound the same way as the unit square models of objects.
+	const Vector2f corners[4] = {{rect.x, rect.y}, {rect.z, rect.y}, {rect.z, rect.w}, {rect.x, rect.w}};
+	const Vector2f uvs[4] = {{uvRect.x, uvRect.y}, {uvRect.z, uvRect.y}, {uvRect.z, uvRect.w}, {uvRect.x, uvRect.w}};
+
+	for (uint32_t i = 0; i < 4; i++) {
+		auto position = modelView.Transform(Vector4f(corners[i].x, corners[i].y, 0.0f, 1.0f));
+		quad.vertices[i] = {Vector3f(position.x, position.y, position.z), uvs[i], colour};
+	}
+
+	quad.depth = quad.vertices[0].position.z;
+	quad.bounds = {quad.vertices[0].position.x, quad.vertices[0].position.y, quad.vertices[0].position.x, quad.vertices[0].position.y};
+	for (const auto &vertex : quad.vertices) {
+		quad.bounds.x = std::min(quad.bounds.x, vertex.position.x);
+		quad.bounds.y = std::min(quad.bounds.y, vertex.position.y);
+		quad.bounds.z = std::max(quad.bounds.z, vertex.position.x);
+		quad.bounds.w = std::max(quad.bounds.w, vertex.position.y);
+	}
+}
+
+void GuiBatch::Build() {
+	vertices.clear();
+	indices.clear();
+	commands.clear();
+	batches.clear();
+
+	// Quads farther away are drawn first, quads at the same depth keep the order they were added in.
+	order.resize(quads.size());
+	for (uint32_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+		return quads[a].depth > quads[b].depth;
+	});
+
+	for (auto index : order) {
+		const auto &quad = quads[index];
+
+		// Searches back for a draw with the same image and scissor, stopping at a draw the quad would be moved behind while overlapping it.
+		Batch *target = nullptr;
+		for (std::size_t i = batches.size(); i > 0 && batches.size() - i < SearchBatches; i--) {
+			auto &batch = batches[i - 1];
+			if (batch.image == quad.image && batch.scissor == quad.scissor) {
+				target = &batch;
+				break;
+			}
+
+			if (Overlaps(batch.bounds, quad.bounds))
+				break;
+		}
+
+		if (!target) {
+			target = &batches.emplace_back();
+			target->image = quad.image;
+			target->scissor = quad.scissor;
+			target->bounds = quad.bounds;
+		}
+
+		target->bounds = {std::min(target->bounds.x, quad.bounds.x), std::min(target->bounds.y, quad.bounds.y), std::max(target->bounds.z, quad.bounds.z),
+			std::max(target->bounds.w, quad.bounds.w)};
+		target->quads.emplace_back(index);
+	}
+
+	vertices.reserve(quads.size() * 4);
+	indices.reserve(quads.size() * 6);
+	commands.reserve(batches.size());
+
+	for (const auto &batch : batches) {
+		auto &command = commands.emplace_back();
+		command.image = batch.image;
+		command.scissor = batch.scissor;
+		command.firstIndex = static_cast<uint32_t>(indices.size());
+
+		for (auto index : batch.quads) {
+			auto first = static_cast<uint32_t>(vertices.size());
+			vertices.insert(vertices.end(), quads[index].vertices.begin(), quads[index].vertices.end());
+			for (auto corner : {0, 1, 2, 2, 3, 0})
+				indices.emplace_back(first + corner);
+		}
+
+		command.indexCount = static_cast<uint32_t>(indices.size()) - command.firstIndex;
+	}
+}
+}
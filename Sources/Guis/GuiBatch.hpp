@@ -0,0 +1,108 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Maths/Colour.hpp"
+#include "Maths/Matrix4.hpp"
+#include "Maths/Vector4.hpp"
+#include "Graphics/Descriptors/Descriptor.hpp"
+#include "Graphics/Pipelines/Shader.hpp"
+
+namespace acid {
+/**
+ * @brief Class that collects the quads of 2D objects each frame and builds them into one vertex and index list, drawn with a command per change of image or scissor.
+ * Quads are ordered by depth, then each joins the latest draw with its image and scissor that it can be moved back to without passing over a quad it overlaps,
+ * so overlapping quads keep their order and the rest are grouped by image.
+ */
+class ACID_EXPORT GuiBatch {
+public:
+	class Vertex {
+	public:
+		static Shader::VertexInput GetVertexInput(uint32_t baseBinding = 0) {
+			std::vector<VkVertexInputBindingDescription> bindingDescriptions = {
+				{baseBinding, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX}
+			};
+			std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
+				{0, baseBinding, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position)},
+				{1, baseBinding, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv)},
+				{2, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex, colour)}
+			};
+			return {bindingDescriptions, attributeDescriptions};
+		}
+
+		/// The position in clip space.
+		Vector3f position;
+		Vector2f uv;
+		Colour colour;
+	};
+
+	class DrawCommand {
+	public:
+		/// The index into {@link GuiBatch#GetImages}.
+		uint32_t image;
+		std::optional<Vector4i> scissor;
+		uint32_t firstIndex;
+		uint32_t indexCount;
+	};
+
+	/**
+	 * Removes all quads, keeping the memory of the lists.
+	 */
+	void Clear();
+
+	/**
+	 * Adds a quad, positioned across a object as a rectangle inside its unit square.
+	 * @param modelView The matrix from the unit square of the object into clip space.
+	 * @param rect The rectangle inside the unit square, as the top left and bottom right corners.
+	 * @param uvRect The rectangle of the image sampled across the quad.
+	 * @param colour The colour the image is multiplied by.
+	 * @param image The image sampled across the quad, quads are grouped by the address of the descriptor.
+	 * @param scissor The scissor of the object in pixels, or no value to draw across the window.
+	 */
+	void AddQuad(const Matrix4 &modelView, const Vector4f &rect, const Vector4f &uvRect, const Colour &colour, const std::shared_ptr<Descriptor> &image,
+		const std::optional<Vector4i> &scissor);
+
+	/**
+	 * Orders the quads added and builds the vertices, indices and draw commands.
+	 */
+	void Build();
+
+	std::size_t GetQuadCount() const { return quads.size(); }
+	const std::vector<Vertex> &GetVertices() const { return vertices; }
+	const std::vector<uint32_t> &GetIndices() const { return indices; }
+	const std::vector<DrawCommand> &GetCommands() const { return commands; }
+	const std::vector<std::shared_ptr<Descriptor>> &GetImages() const { return images; }
+
+private:
+	class Quad {
+	public:
+		std::array<Vertex, 4> vertices;
+		/// The bounds in clip space, as the smallest then largest corner.
+		Vector4f bounds;
+		float depth;
+		uint32_t image;
+		std::optional<Vector4i> scissor;
+	};
+
+	class Batch {
+	public:
+		uint32_t image;
+		std::optional<Vector4i> scissor;
+		Vector4f bounds;
+		std::vector<uint32_t> quads;
+	};
+
+	/// The number of draws back a quad is searched for a draw to join, bounding the cost of building.
+	static constexpr std::size_t SearchBatches = 32;
+
+	std::vector<Quad> quads;
+	std::vector<std::shared_ptr<Descriptor>> images;
+	std::unordered_map<const Descriptor *, uint32_t> imageIndices;
+	std::vector<Batch> batches;
+	std::vector<uint32_t> order;
+
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<DrawCommand> commands;
+};
+}
@@ -1,24 +1,41 @@
 #include "GuisSubrender.hpp"
 
-#include "Models/Vertex2d.hpp"
 #include "Uis/Uis.hpp"
 #include "Gui.hpp"
 
 namespace acid {
 GuisSubrender::GuisSubrender(const Pipeline::Stage &pipelineStage) :
 	Subrender(pipelineStage),
-	pipeline(pipelineStage, {"Shaders/Guis/Gui.vert", "Shaders/Guis/Gui.frag"}, {Vertex2d::GetVertexInput()}) {
+	pipeline(pipelineStage, {"Shaders/Guis/Gui.vert", "Shaders/Guis/Gui.frag"}, {GuiBatch::Vertex::GetVertexInput()}) {
 }
 
 void GuisSubrender::Render(const CommandBuffer &commandBuffer) {
+	batch.Clear();
+
+	for (const auto &object : guis.Update(Uis::Get()->GetEnabledObjects())) {
+		if (object->GetScreenAlpha() > 0.0f)
+			object->AddQuads(batch);
+	}
+
+	batch.Build();
+	buffers.Update();
+
+	if (batch.GetCommands().empty())
+		return;
+
 	pipeline.BindPipeline(commandBuffer);
+	buffers.Bind(commandBuffer, batch.GetVertices(), batch.GetIndices());
 
-	for (const auto &screenObject : Uis::Get()->GetObjects()) {
-		if (!screenObject->IsEnabled())
+	for (const auto &command : batch.GetCommands()) {
+		const auto &image = batch.GetImages()[command.image];
+		auto &descriptorSet = buffers.GetDescriptorSet(image, pipeline);
+		descriptorSet.Push("samplerColour", image);
+		if (!descriptorSet.Update(pipeline))
 			continue;
 
-		if (auto object = dynamic_cast<Gui *>(screenObject))
-			object->CmdRender(commandBuffer, pipeline);
+		buffers.SetScissor(commandBuffer, command.scissor);
+		descriptorSet.BindDescriptor(commandBuffer, pipeline);
+		vkCmdDrawIndexed(commandBuffer, command.indexCount, 1, command.firstIndex, 0, 0);
 	}
 }
 }
@@ -1,16 +1,29 @@
 #pragma once
 
 #include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/BatchBuffers.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Uis/UiObjectFilter.hpp"
+#include "GuiBatch.hpp"
 
 namespace acid {
+class Gui;
+
+/**
+ * @brief Subrender that draws every image UI from one batch, drawn with a command for each change of image or scissor.
+ */
 class ACID_EXPORT GuisSubrender : public Subrender {
 public:
 	explicit GuisSubrender(const Pipeline::Stage &pipelineStage);
 
 	void Render(const CommandBuffer &commandBuffer) override;
 
+	const GuiBatch &GetBatch() const { return batch; }
+
 private:
 	PipelineGraphics pipeline;
+	GuiBatch batch;
+	UiObjectFilter<Gui> guis;
+	BatchBuffers buffers;
 };
 }
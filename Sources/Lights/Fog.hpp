@@ -3,6 +3,7 @@
 #include "Maths/Colour.hpp"
 #include "Files/Node.hpp"
 #include "Scenes/Component.hpp"
+#include "Files/NodeReflect.hpp"
 
 namespace acid {
 /**
@@ -39,8 +40,14 @@ public:
 	float GetUpperLimit() const { return upperLimit; }
 	void SetUpperLimit(float upperLimit) { this->upperLimit = upperLimit; }
 
-	friend const Node &operator>>(const Node &node, Fog &fog);
-	friend Node &operator<<(Node &node, const Fog &fog);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("colour", &Fog::colour),
+			NodeField("density", &Fog::density),
+			NodeField("gradient", &Fog::gradient),
+			NodeField("lowerLimit", &Fog::lowerLimit),
+			NodeField("upperLimit", &Fog::upperLimit));
+	}
 
 private:
 	Colour colour;
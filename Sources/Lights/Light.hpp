@@ -3,6 +3,7 @@
 #include "Maths/Colour.hpp"
 #include "Maths/Vector3.hpp"
 #include "Scenes/Component.hpp"
+#include "Files/NodeReflect.hpp"
 
 namespace acid {
 /**
@@ -27,8 +28,11 @@ public:
 	float GetRadius() const { return radius; }
 	void SetRadius(float radius) { this->radius = radius; }
 
-	friend const Node &operator>>(const Node &node, Light &light);
-	friend Node &operator<<(Node &node, const Light &light);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("colour", &Light::colour),
+			NodeField("radius", &Light::radius));
+	}
 
 private:
 	Colour colour;
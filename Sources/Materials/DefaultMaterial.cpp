@@ -15,6 +15,7 @@ DefaultMaterial::DefaultMaterial(const Colour &baseDiffuse, std::shared_ptr<Imag
 	castsShadows(castsShadows),
 	ignoreLighting(ignoreLighting),
 	ignoreFog(ignoreFog) {
+	UpdateImages();
 }
 
 void DefaultMaterial::CreatePipeline(const Shader::VertexInput &vertexInput, bool animated) {
@@ -53,6 +54,14 @@ std::vector<Shader::Define> DefaultMaterial::GetDefines() const {
 	};
 }
 
+void DefaultMaterial::UpdateImages() {
+	images.clear();
+	for (const auto &image : {imageDiffuse, imageMaterial, imageNormal}) {
+		if (image)
+			images.emplace_back(image);
+	}
+}
+
 const Node &operator>>(const Node &node, DefaultMaterial &material) {
 	node["baseDiffuse"].Get(material.baseDiffuse);
 	node["imageDiffuse"].Get(material.imageDiffuse);
@@ -63,6 +72,7 @@ const Node &operator>>(const Node &node, DefaultMaterial &material) {
 	node["castsShadows"].Get(material.castsShadows);
 	node["ignoreLighting"].Get(material.ignoreLighting);
 	node["ignoreFog"].Get(material.ignoreFog);
+	material.UpdateImages();
 	return node;
 }
 
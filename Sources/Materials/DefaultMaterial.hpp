@@ -23,7 +23,7 @@ public:
 	void SetBaseDiffuse(const Colour &baseDiffuse) { this->baseDiffuse = baseDiffuse; }
 
 	const std::shared_ptr<Image2d> &GetImageDiffuse() const { return imageDiffuse; }
-	void SetImageDiffuse(const std::shared_ptr<Image2d> &imageDiffuse) { this->imageDiffuse = imageDiffuse; }
+	void SetImageDiffuse(const std::shared_ptr<Image2d> &imageDiffuse) { this->imageDiffuse = imageDiffuse; UpdateImages(); }
 
 	float GetMetallic() const { return metallic; }
 	void SetMetallic(float metallic) { this->metallic = metallic; }
@@ -32,10 +32,10 @@ public:
 	void SetRoughness(float roughness) { this->roughness = roughness; }
 
 	const std::shared_ptr<Image2d> &GetImageMaterial() const { return imageMaterial; }
-	void SetImageMaterial(const std::shared_ptr<Image2d> &imageMaterial) { this->imageMaterial = imageMaterial; }
+	void SetImageMaterial(const std::shared_ptr<Image2d> &imageMaterial) { this->imageMaterial = imageMaterial; UpdateImages(); }
 
 	const std::shared_ptr<Image2d> &GetImageNormal() const { return imageNormal; }
-	void SetImageNormal(const std::shared_ptr<Image2d> &imageNormal) { this->imageNormal = imageNormal; }
+	void SetImageNormal(const std::shared_ptr<Image2d> &imageNormal) { this->imageNormal = imageNormal; UpdateImages(); }
 
 	bool IsCastsShadows() const { return castsShadows; }
 	void SetCastsShadows(bool castsShadows) { this->castsShadows = castsShadows; }
@@ -51,6 +51,7 @@ public:
 
 private:
 	std::vector<Shader::Define> GetDefines() const;
+	void UpdateImages();
 
 	bool animated = false;
 	Colour baseDiffuse;
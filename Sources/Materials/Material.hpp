@@ -3,6 +3,7 @@
 #include "Utils/StreamFactory.hpp"
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Images/Image2d.hpp"
 #include "Maths/Transform.hpp"
 #include "MaterialPipeline.hpp"
 
@@ -31,6 +32,12 @@ public:
 	 */
 	virtual void PushDescriptors(DescriptorsHandler &descriptorSet) = 0;
 
+	/**
+	 * Gets the images sampled by this material, so the levels they are drawn at can be streamed in.
+	 * @return The images.
+	 */
+	const std::vector<std::shared_ptr<Image2d>> &GetImages() const { return images; }
+
 	/**
 	 * Gets the material pipeline defined in this material.
 	 * @return The material pipeline.
@@ -39,5 +46,7 @@ public:
 
 protected:
 	std::shared_ptr<MaterialPipeline> pipelineMaterial;
+	/// The images sampled by this material, kept up to date by materials that have images.
+	std::vector<std::shared_ptr<Image2d>> images;
 };
 }
@@ -3,6 +3,8 @@
 #include "Scenes/Entity.hpp"
 #include "Maths/Transform.hpp"
 #include "Scenes/Scenes.hpp"
+#include "Devices/Window.hpp"
+#include "Graphics/Images/TextureStreamer.hpp"
 
 namespace acid {
 Mesh::Mesh(std::shared_ptr<Model> model, std::unique_ptr<Material> &&material) :
@@ -19,6 +21,7 @@ void Mesh::Update() {
 	if (material) {
 		auto transform = GetEntity()->GetComponent<Transform>();
 		material->PushUniforms(uniformObject, transform);
+		RequestImages(transform);
 	}
 }
 
@@ -57,6 +60,22 @@ bool Mesh::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniform
 	return model->CmdRender(commandBuffer);
 }
 
+void Mesh::RequestImages(const Transform *transform) const {
+	auto textureStreamer = TextureStreamer::Get();
+	auto camera = Scenes::Get()->GetCamera();
+	if (!textureStreamer || !camera || !model || !transform)
+		return;
+
+	// The size on screen is estimated from the bounds of the model, as if each image is mapped once across it.
+	auto scale = transform->GetScale();
+	auto radius = model->GetRadius() * std::max({scale.x, scale.y, scale.z});
+	auto distance = camera->GetPosition().Distance(transform->GetPosition());
+	auto screenSize = TextureStreamer::GetScreenSize(radius, distance, camera->GetFieldOfView(), static_cast<float>(Window::Get()->GetSize().y));
+
+	for (const auto &image : material->GetImages())
+		textureStreamer->Request(image, screenSize);
+}
+
 void Mesh::SetMaterial(std::unique_ptr<Material> &&material) {
 	this->material = std::move(material);
 	this->material->CreatePipeline(GetVertexInput(), false);
@@ -39,6 +39,12 @@ public:
 	friend Node &operator<<(Node &node, const Mesh &mesh);
 
 private:
+	/**
+	 * Requests the levels of the material images needed for the size of this mesh on screen.
+	 * @param transform The transform of this mesh.
+	 */
+	void RequestImages(const Transform *transform) const;
+
 	std::shared_ptr<Model> model;
 	std::unique_ptr<Material> material;
 
@@ -0,0 +1,787 @@
+#include "GltfLoader.hpp"
+
+#include <set>
+#include <tinygltf/tiny_gltf.h>
+#include <stb/stb_image.h>
+
+#include "Animations/AnimatedMesh.hpp"
+#include "Files/Files.hpp"
+#include "Resources/Resources.hpp"
+#include "Utils/String.hpp"
+
+namespace acid {
+namespace {
+/// The number of vertices or indices read by each parallel task.
+constexpr std::size_t VertexGrainSize = 16384;
+
+template<typename F>
+void ParallelFor(std::size_t count, std::size_t grainSize, F &&f) {
+	if (auto resources = Resources::Get())
+		resources->GetThreadPool().ParallelFor(0, count, grainSize, std::forward<F>(f));
+	else if (count != 0)
+		f(0, count);
+}
+
+/**
+ * Reads the elements of an accessor directly from its buffer, converting component types as they are read.
+ */
+class AccessorReader {
+public:
+	AccessorReader() = default;
+
+	AccessorReader(const tinygltf::Model &model, int32_t accessorIndex) {
+		if (accessorIndex < 0 || static_cast<std::size_t>(accessorIndex) >= model.accessors.size())
+			throw std::runtime_error("glTF accessor index is out of range");
+
+		const auto &accessor = model.accessors[accessorIndex];
+		count = accessor.count;
+		componentType = accessor.componentType;
+		componentSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+		components = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+		normalized = accessor.normalized;
+
+		if (componentSize <= 0 || components <= 0)
+			throw std::runtime_error("glTF accessor has an unsupported type");
+		if (accessor.sparse.isSparse)
+			Log::Warning("glTF sparse accessors are not supported, reading the base values only\n");
+
+		// An accessor without a buffer view is initialized with zeros.
+		if (accessor.bufferView < 0)
+			return;
+
+		const auto &bufferView = model.bufferViews.at(accessor.bufferView);
+		const auto &buffer = model.buffers.at(bufferView.buffer);
+		stride = accessor.ByteStride(bufferView);
+
+		if (stride <= 0)
+			throw std::runtime_error("glTF accessor has an invalid byte stride");
+
+		auto offset = bufferView.byteOffset + accessor.byteOffset;
+		if (count != 0 && offset + (count - 1) * stride + components * componentSize > buffer.data.size())
+			throw std::runtime_error("glTF accessor exceeds the size of its buffer");
+
+		data = buffer.data.data() + offset;
+	}
+
+	float ReadFloat(std::size_t element, uint32_t component) const {
+		if (!data || component >= static_cast<uint32_t>(components))
+			return 0.0f;
+
+		auto source = data + element * stride + component * componentSize;
+
+		switch (componentType) {
+		case TINYGLTF_COMPONENT_TYPE_FLOAT:
+			return Read<float>(source);
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+			return normalized ? Read<uint8_t>(source) / 255.0f : Read<uint8_t>(source);
+		case TINYGLTF_COMPONENT_TYPE_BYTE:
+			return normalized ? std::max(Read<int8_t>(source) / 127.0f, -1.0f) : Read<int8_t>(source);
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+			return normalized ? Read<uint16_t>(source) / 65535.0f : Read<uint16_t>(source);
+		case TINYGLTF_COMPONENT_TYPE_SHORT:
+			return normalized ? std::max(Read<int16_t>(source) / 32767.0f, -1.0f) : Read<int16_t>(source);
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+			return static_cast<float>(Read<uint32_t>(source));
+		default:
+			return 0.0f;
+		}
+	}
+
+	uint32_t ReadUint(std::size_t element, uint32_t component) const {
+		if (!data || component >= static_cast<uint32_t>(components))
+			return 0;
+
+		auto source = data + element * stride + component * componentSize;
+
+		switch (componentType) {
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+			return Read<uint8_t>(source);
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+			return Read<uint16_t>(source);
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+			return Read<uint32_t>(source);
+		default:
+			return static_cast<uint32_t>(ReadFloat(element, component));
+		}
+	}
+
+	Vector2f ReadVector2(std::size_t element) const {
+		return {ReadFloat(element, 0), ReadFloat(element, 1)};
+	}
+
+	Vector3f ReadVector3(std::size_t element) const {
+		return {ReadFloat(element, 0), ReadFloat(element, 1), ReadFloat(element, 2)};
+	}
+
+	Vector4f ReadVector4(std::size_t element) const {
+		return {ReadFloat(element, 0), ReadFloat(element, 1), ReadFloat(element, 2), ReadFloat(element, 3)};
+	}
+
+	Matrix4 ReadMatrix4(std::size_t element) const {
+		float values[16];
+		for (uint32_t i = 0; i < 16; i++)
+			values[i] = ReadFloat(element, i);
+		return Matrix4(values);
+	}
+
+	std::size_t GetCount() const { return count; }
+	int32_t GetComponents() const { return components; }
+
+private:
+	template<typename T>
+	static T Read(const uint8_t *source) {
+		T value;
+		std::memcpy(&value, source, sizeof(T));
+		return value;
+	}
+
+	const uint8_t *data = nullptr;
+	std::size_t count = 0;
+	std::size_t stride = 0;
+	int32_t componentType = 0;
+	int32_t componentSize = 0;
+	int32_t components = 0;
+	bool normalized = false;
+};
+
+/**
+ * A translation or rotation animation sampler, with the keyframe values read ahead of sampling.
+ */
+class AnimationTrack {
+public:
+	AnimationTrack(const tinygltf::Model &model, const tinygltf::AnimationSampler &sampler) {
+		AccessorReader input(model, sampler.input);
+		AccessorReader output(model, sampler.output);
+
+		step = sampler.interpolation == "STEP";
+		// Cubic spline outputs are stored as in-tangent, value, out-tangent; only the values are kept.
+		auto cubicSpline = sampler.interpolation == "CUBICSPLINE";
+		auto elements = cubicSpline ? 3 : 1;
+
+		if (output.GetCount() < input.GetCount() * elements)
+			throw std::runtime_error("glTF animation sampler has fewer outputs than inputs");
+
+		times.resize(input.GetCount());
+		values.resize(input.GetCount());
+
+		for (std::size_t i = 0; i < times.size(); i++) {
+			times[i] = input.ReadFloat(i, 0);
+			values[i] = output.ReadVector4(i * elements + (cubicSpline ? 1 : 0));
+		}
+	}
+
+	Vector3f SamplePosition(float time) const {
+		auto [previous, next, progression] = GetFrames(time);
+		return Vector3f(values[previous]).Lerp(Vector3f(values[next]), progression);
+	}
+
+	Quaternion SampleRotation(float time) const {
+		auto [previous, next, progression] = GetFrames(time);
+		Quaternion a(values[previous].x, values[previous].y, values[previous].z, values[previous].w);
+		Quaternion b(values[next].x, values[next].y, values[next].z, values[next].w);
+		return a.Slerp(b, progression).Normalize();
+	}
+
+	const std::vector<float> &GetTimes() const { return times; }
+
+private:
+	std::tuple<std::size_t, std::size_t, float> GetFrames(float time) const {
+		auto next = static_cast<std::size_t>(std::upper_bound(times.begin(), times.end(), time) - times.begin());
+		if (next == 0)
+			return {0, 0, 0.0f};
+		if (next == times.size())
+			return {next - 1, next - 1, 0.0f};
+		if (step)
+			return {next - 1, next - 1, 0.0f};
+
+		auto duration = times[next] - times[next - 1];
+		return {next - 1, next, duration > 0.0f ? (time - times[next - 1]) / duration : 0.0f};
+	}
+
+	bool step = false;
+	std::vector<float> times;
+	std::vector<Vector4f> values;
+};
+
+bool FileExists(const std::string &filename, void *) {
+	return Files::ExistsInPath(filename) || std::filesystem::exists(filename);
+}
+
+std::string ExpandFilePath(const std::string &filename, void *) {
+	return filename;
+}
+
+bool ReadWholeFile(std::vector<unsigned char> *out, std::string *err, const std::string &filename, void *) {
+	// External images are shared image resources, so are not read by the parser.
+	if (Bitmap::Registry().count(std::filesystem::path(filename).extension().string()) != 0)
+		return false;
+
+	auto fileLoaded = Files::ReadAsync(filename).get();
+	if (!*fileLoaded) {
+		if (err)
+			*err += "Failed to read " + filename + '\n';
+		return false;
+	}
+
+	out->assign(fileLoaded->GetData(), fileLoaded->GetData() + fileLoaded->GetSize());
+	return true;
+}
+
+bool WriteWholeFile(std::string *err, const std::string &, const std::vector<unsigned char> &, void *) {
+	if (err)
+		*err += "Writing glTF files is not supported\n";
+	return false;
+}
+
+bool LoadImageData(tinygltf::Image *image, const int, std::string *, std::string *, int, int, const unsigned char *bytes, int size, void *) {
+	// Embedded images are kept encoded, they are decoded in parallel once parsing has finished.
+	image->as_is = true;
+	image->image.assign(bytes, bytes + size);
+	return true;
+}
+
+Matrix4 GetLocalTransform(const tinygltf::Node &node) {
+	if (node.matrix.size() == 16) {
+		float values[16];
+		std::copy(node.matrix.begin(), node.matrix.end(), values);
+		return Matrix4(values);
+	}
+
+	Matrix4 result;
+	if (node.translation.size() == 3)
+		result = result.Translate(Vector3f(node.translation[0], node.translation[1], node.translation[2]));
+	if (node.rotation.size() == 4)
+		result = result * Quaternion(node.rotation[0], node.rotation[1], node.rotation[2], node.rotation[3]).ToRotationMatrix();
+	if (node.scale.size() == 3)
+		result = result.Scale(Vector3f(node.scale[0], node.scale[1], node.scale[2]));
+	return result;
+}
+
+std::shared_ptr<Image2d> CreateImage(std::unique_ptr<Bitmap> &&bitmap) {
+	return std::make_shared<Image2d>(std::move(bitmap), VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_FILTER_LINEAR,
+		VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLE_COUNT_1_BIT, true, true);
+}
+}
+
+/**
+ * A primitive of a mesh instanced by a scene node, with the ranges it is read into.
+ */
+class GltfLoader::MeshNode {
+public:
+	const tinygltf::Primitive *primitive = nullptr;
+	Matrix4 transform;
+	Matrix4 normalTransform;
+	std::size_t vertexOffset = 0;
+	std::size_t vertexCount = 0;
+	std::size_t indexOffset = 0;
+	std::size_t indexCount = 0;
+};
+
+GltfLoader::GltfLoader(const std::filesystem::path &filename, bool animated, bool createMaterials) :
+	filename(filename),
+	gltfModel(std::make_unique<tinygltf::Model>()) {
+	auto file = Files::ReadAsync(filename).get();
+	if (!*file)
+		throw std::runtime_error("glTF file could not be read");
+
+	auto folder = filename.parent_path().string();
+	std::replace(folder.begin(), folder.end(), '\\', '/');
+
+	tinygltf::TinyGLTF gltfContext;
+	gltfContext.SetFsCallbacks({&FileExists, &ExpandFilePath, &ReadWholeFile, &WriteWholeFile, nullptr});
+	gltfContext.SetImageLoader(&LoadImageData, nullptr);
+	std::string warn, err;
+
+	if (filename.extension() == ".glb") {
+		if (!gltfContext.LoadBinaryFromMemory(gltfModel.get(), &err, &warn, file->GetData(), static_cast<uint32_t>(file->GetSize()), folder))
+			throw std::runtime_error(warn + err);
+	} else {
+		if (!gltfContext.LoadASCIIFromString(gltfModel.get(), &err, &warn, reinterpret_cast<const char *>(file->GetData()), static_cast<uint32_t>(file->GetSize()),
+			folder)) {
+			throw std::runtime_error(warn + err);
+		}
+	}
+
+	file.reset();
+
+	// Read before the parsed model is released, so reloads can watch the buffers too.
+	for (const auto &buffer : gltfModel->buffers) {
+		if (!buffer.uri.empty() && buffer.uri.rfind("data:", 0) != 0)
+			bufferFiles.emplace_back(filename.parent_path() / buffer.uri);
+	}
+
+	// Rest pose transforms of every node, parents are always visited before their children.
+	// Children are indices read from the file, so the hierarchy is checked to be a forest before it is walked.
+	parents.resize(gltfModel->nodes.size(), -1);
+	globalTransforms.resize(gltfModel->nodes.size());
+
+	for (std::size_t i = 0; i < gltfModel->nodes.size(); i++) {
+		for (auto child : gltfModel->nodes[i].children) {
+			if (child < 0 || static_cast<std::size_t>(child) >= parents.size())
+				throw std::runtime_error("glTF node child index is out of range");
+			if (parents[child] != -1)
+				throw std::runtime_error("glTF node has more than one parent");
+			parents[child] = static_cast<int32_t>(i);
+		}
+	}
+
+	std::vector<int32_t> stack;
+	for (std::size_t i = 0; i < parents.size(); i++) {
+		if (parents[i] == -1)
+			stack.emplace_back(static_cast<int32_t>(i));
+	}
+
+	std::vector<bool> visited(parents.size());
+	std::size_t visitedCount = 0;
+
+	while (!stack.empty()) {
+		auto index = stack.back();
+		stack.pop_back();
+
+		if (visited[index])
+			throw std::runtime_error("glTF node hierarchy contains a cycle");
+		visited[index] = true;
+		visitedCount++;
+
+		const auto &node = gltfModel->nodes[index];
+		auto local = GetLocalTransform(node);
+		globalTransforms[index] = parents[index] == -1 ? local : globalTransforms[parents[index]] * local;
+		stack.insert(stack.end(), node.children.begin(), node.children.end());
+	}
+
+	// Every node has at most one parent, so nodes that cannot be reached from a root are part of a cycle.
+	if (visitedCount != parents.size())
+		throw std::runtime_error("glTF node hierarchy contains a cycle");
+
+	DecodeImages();
+
+	int32_t skinIndex = -1;
+
+	if (animated) {
+		for (const auto &node : gltfModel->nodes) {
+			if (node.mesh >= 0 && node.skin >= 0) {
+				skinIndex = node.skin;
+				break;
+			}
+		}
+
+		if (skinIndex == -1)
+			throw std::runtime_error("glTF file does not contain a skinned mesh");
+	}
+
+	LoadMeshes(skinIndex);
+
+	if (skinIndex != -1) {
+		LoadSkin(skinIndex);
+		LoadAnimations();
+		skinned = true;
+	}
+
+	// The parsed buffers are no longer needed once everything has been read, the materials are read from the rest of the model.
+	gltfModel->buffers.clear();
+
+	if (createMaterials)
+		CreateMaterials();
+}
+
+GltfLoader::~GltfLoader() {
+}
+
+void GltfLoader::CreateMaterials() {
+	if (!gltfModel)
+		return;
+
+	CreateImages();
+	LoadMaterials();
+
+	// The parsed model is no longer needed once the materials have been read.
+	gltfModel.reset();
+	bitmaps.clear();
+}
+
+std::unique_ptr<DefaultMaterial> GltfLoader::CreateMaterial(const std::vector<DefaultMaterial> &materials, std::size_t index) {
+	if (index >= materials.size())
+		return nullptr;
+	return std::make_unique<DefaultMaterial>(materials[index]);
+}
+
+void GltfLoader::DecodeImages() {
+	bitmaps.resize(gltfModel->images.size());
+	ParallelFor(bitmaps.size(), 1, [this](std::size_t begin, std::size_t end) {
+		for (auto i = begin; i < end; i++) {
+			const auto &image = gltfModel->images[i];
+			if (!image.uri.empty() || image.image.empty())
+				continue;
+
+			Vector2i size;
+			int32_t components;
+			std::unique_ptr<uint8_t[]> data(stbi_load_from_memory(image.image.data(), static_cast<int32_t>(image.image.size()), &size.x, &size.y, &components,
+				STBI_rgb_alpha));
+
+			if (data)
+				bitmaps[i] = std::make_unique<Bitmap>(std::move(data), Vector2ui(size), 4);
+		}
+	});
+}
+
+void GltfLoader::CreateImages() {
+	auto folder = filename.parent_path();
+	images.resize(gltfModel->images.size());
+
+	for (std::size_t i = 0; i < images.size(); i++) {
+		const auto &image = gltfModel->images[i];
+
+		if (!image.uri.empty()) {
+			images[i] = Image2d::Create(folder / image.uri);
+		} else if (bitmaps[i]) {
+			images[i] = CreateImage(std::move(bitmaps[i]));
+		} else {
+			Log::Warning("glTF image ", i, " in ", filename, " could not be decoded\n");
+		}
+	}
+}
+
+void GltfLoader::LoadMaterials() {
+	auto getImage = [this](int32_t textureIndex) -> std::shared_ptr<Image2d> {
+		if (textureIndex < 0 || static_cast<std::size_t>(textureIndex) >= gltfModel->textures.size())
+			return nullptr;
+
+		auto source = gltfModel->textures[textureIndex].source;
+		if (source < 0 || static_cast<std::size_t>(source) >= images.size())
+			return nullptr;
+		return images[source];
+	};
+
+	for (const auto &material : gltfModel->materials) {
+		const auto &pbr = material.pbrMetallicRoughness;
+
+		Colour baseDiffuse;
+		if (pbr.baseColorFactor.size() == 4)
+			baseDiffuse = Colour(pbr.baseColorFactor[0], pbr.baseColorFactor[1], pbr.baseColorFactor[2], pbr.baseColorFactor[3]);
+
+		// glTF packs roughness in green and metalness in blue, the default shader reads metalness from red.
+		materials.emplace_back(baseDiffuse, getImage(pbr.baseColorTexture.index), static_cast<float>(pbr.metallicFactor), static_cast<float>(pbr.roughnessFactor),
+			getImage(pbr.metallicRoughnessTexture.index), getImage(material.normalTexture.index));
+	}
+}
+
+void GltfLoader::LoadMeshes(int32_t skinIndex) {
+	// Finds every mesh instanced by the scene, skinned files only import the meshes bound to the skin.
+	std::vector<MeshNode> meshNodes;
+	std::vector<int32_t> stack;
+
+	if (!gltfModel->scenes.empty()) {
+		auto sceneIndex = gltfModel->defaultScene > -1 ? static_cast<std::size_t>(gltfModel->defaultScene) : 0;
+		if (sceneIndex >= gltfModel->scenes.size())
+			throw std::runtime_error("glTF default scene index is out of range");
+
+		const auto &scene = gltfModel->scenes[sceneIndex];
+		for (auto node : scene.nodes) {
+			if (node < 0 || static_cast<std::size_t>(node) >= parents.size())
+				throw std::runtime_error("glTF scene node index is out of range");
+		}
+		stack.assign(scene.nodes.rbegin(), scene.nodes.rend());
+	} else {
+		for (auto i = static_cast<int32_t>(parents.size()) - 1; i >= 0; i--) {
+			if (parents[i] == -1)
+				stack.emplace_back(i);
+		}
+	}
+
+	std::size_t vertexCount = 0, indexCount = 0;
+
+	while (!stack.empty()) {
+		auto index = stack.back();
+		stack.pop_back();
+
+		const auto &node = gltfModel->nodes.at(index);
+		stack.insert(stack.end(), node.children.rbegin(), node.children.rend());
+
+		if (node.mesh < 0 || node.skin != skinIndex)
+			continue;
+
+		for (const auto &primitive : gltfModel->meshes.at(node.mesh).primitives) {
+			auto position = primitive.attributes.find("POSITION");
+
+			if (primitive.mode != TINYGLTF_MODE_TRIANGLES && primitive.mode != -1) {
+				Log::Warning("glTF primitive mode ", primitive.mode, " is not supported, only triangles are imported\n");
+				continue;
+			}
+			if (position == primitive.attributes.end())
+				continue;
+
+			MeshNode meshNode;
+			meshNode.primitive = &primitive;
+			// Skinned vertices stay in the space of the skeleton.
+			if (skinIndex == -1) {
+				meshNode.transform = globalTransforms[index];
+				meshNode.normalTransform = meshNode.transform.Inverse().Transpose();
+			}
+
+			meshNode.vertexOffset = vertexCount;
+			meshNode.vertexCount = gltfModel->accessors.at(position->second).count;
+			meshNode.indexOffset = indexCount;
+			meshNode.indexCount = primitive.indices >= 0 ? gltfModel->accessors.at(primitive.indices).count : meshNode.vertexCount;
+			vertexCount += meshNode.vertexCount;
+			indexCount += meshNode.indexCount;
+
+			primitives.emplace_back(Primitive{static_cast<uint32_t>(meshNode.indexOffset), static_cast<uint32_t>(meshNode.indexCount), primitive.material});
+			meshNodes.emplace_back(meshNode);
+		}
+	}
+
+	if (vertexCount > std::numeric_limits<uint32_t>::max() || indexCount > std::numeric_limits<uint32_t>::max())
+		throw std::runtime_error("glTF file has too many vertices");
+
+	// Splits every primitive into vertex and index ranges that are read in parallel into one allocation.
+	class Task {
+	public:
+		const MeshNode *meshNode;
+		bool indices;
+		std::size_t begin, end;
+	};
+
+	std::vector<Task> tasks;
+	for (const auto &meshNode : meshNodes) {
+		for (std::size_t i = 0; i < meshNode.vertexCount; i += VertexGrainSize)
+			tasks.emplace_back(Task{&meshNode, false, i, std::min(i + VertexGrainSize, meshNode.vertexCount)});
+		for (std::size_t i = 0; i < meshNode.indexCount; i += VertexGrainSize)
+			tasks.emplace_back(Task{&meshNode, true, i, std::min(i + VertexGrainSize, meshNode.indexCount)});
+	}
+
+	if (skinIndex == -1)
+		vertices.resize(vertexCount);
+	else
+		animatedVertices.resize(vertexCount);
+	indices.resize(indexCount);
+
+	ParallelFor(tasks.size(), 1, [this, &tasks, skinIndex](std::size_t begin, std::size_t end) {
+		for (auto t = begin; t < end; t++) {
+			const auto &task = tasks[t];
+			const auto &meshNode = *task.meshNode;
+			const auto &attributes = meshNode.primitive->attributes;
+
+			auto getAttribute = [this, &attributes](const std::string &name) {
+				auto it = attributes.find(name);
+				return it != attributes.end() ? AccessorReader(*gltfModel, it->second) : AccessorReader();
+			};
+
+			if (task.indices) {
+				auto hasIndices = meshNode.primitive->indices >= 0;
+				auto reader = hasIndices ? AccessorReader(*gltfModel, meshNode.primitive->indices) : AccessorReader();
+
+				for (auto i = task.begin; i < task.end; i++) {
+					auto index = hasIndices ? reader.ReadUint(i, 0) : static_cast<uint32_t>(i);
+					if (index >= meshNode.vertexCount)
+						throw std::runtime_error("glTF primitive index is out of range");
+					indices[meshNode.indexOffset + i] = static_cast<uint32_t>(meshNode.vertexOffset + index);
+				}
+
+				continue;
+			}
+
+			auto positions = getAttribute("POSITION");
+			auto normals = getAttribute("NORMAL");
+			auto uvs = getAttribute("TEXCOORD_0");
+
+			if (skinIndex == -1) {
+				for (auto i = task.begin; i < task.end; i++) {
+					Vector3f position = meshNode.transform.Transform(Vector4f(positions.ReadVector3(i), 1.0f));
+					auto normal = Vector3f(meshNode.normalTransform.Transform(Vector4f(normals.ReadVector3(i), 0.0f)));
+					if (normal != Vector3f::Zero)
+						normal = normal.Normalize();
+					vertices[meshNode.vertexOffset + i] = Vertex3d(position, uvs.ReadVector2(i), normal);
+				}
+
+				continue;
+			}
+
+			auto joints = getAttribute("JOINTS_0");
+			auto weights = getAttribute("WEIGHTS_0");
+			auto hasWeights = joints.GetCount() != 0 && weights.GetCount() != 0;
+
+			for (auto i = task.begin; i < task.end; i++) {
+				Vector3ui jointId;
+				Vector3f vertexWeight(1.0f, 0.0f, 0.0f);
+
+				if (hasWeights) {
+					// Only the three strongest influences are kept, then renormalized.
+					std::array<std::pair<float, uint32_t>, 4> influences;
+					for (uint32_t j = 0; j < 4; j++)
+						influences[j] = {weights.ReadFloat(i, j), joints.ReadUint(i, j)};
+					std::partial_sort(influences.begin(), influences.begin() + 3, influences.end(), [](const auto &a, const auto &b) {
+						return a.first > b.first;
+					});
+
+					auto total = influences[0].first + influences[1].first + influences[2].first;
+					if (total > 0.0f) {
+						jointId = {influences[0].second, influences[1].second, influences[2].second};
+						vertexWeight = Vector3f(influences[0].first, influences[1].first, influences[2].first) / total;
+					}
+				}
+
+				animatedVertices[meshNode.vertexOffset + i] = VertexAnimated(positions.ReadVector3(i), uvs.ReadVector2(i), normals.ReadVector3(i), jointId,
+					vertexWeight);
+			}
+		}
+	});
+}
+
+void GltfLoader::LoadSkin(int32_t skinIndex) {
+	const auto &skin = gltfModel->skins.at(skinIndex);
+	jointNodes = skin.joints;
+
+	if (jointNodes.empty())
+		throw std::runtime_error("glTF skin has no joints");
+	for (auto node : jointNodes) {
+		if (node < 0 || static_cast<std::size_t>(node) >= parents.size())
+			throw std::runtime_error("glTF skin joint index is out of range");
+	}
+	if (jointNodes.size() > AnimatedMesh::MaxJoints)
+		Log::Warning("glTF skin in ", filename, " has ", jointNodes.size(), " joints, only ", AnimatedMesh::MaxJoints, " are supported\n");
+
+	std::map<int32_t, uint32_t> jointIndices;
+	for (uint32_t i = 0; i < jointNodes.size(); i++)
+		jointIndices[jointNodes[i]] = i;
+
+	// Keyframe poses are looked up by name, so every joint needs a unique one.
+	std::set<std::string> usedNames;
+	for (auto node : jointNodes) {
+		auto name = gltfModel->nodes.at(node).name;
+		if (name.empty() || usedNames.count(name) != 0)
+			name = (name.empty() ? "node" : name + '_') + String::To(node);
+		usedNames.emplace(name);
+		jointNames.emplace_back(name);
+	}
+
+	std::vector<Matrix4> inverseBindTransforms(jointNodes.size());
+	if (skin.inverseBindMatrices >= 0) {
+		AccessorReader reader(*gltfModel, skin.inverseBindMatrices);
+		if (reader.GetCount() < jointNodes.size())
+			throw std::runtime_error("glTF skin has fewer inverse bind matrices than joints");
+
+		for (std::size_t i = 0; i < jointNodes.size(); i++)
+			inverseBindTransforms[i] = reader.ReadMatrix4(i);
+	} else {
+		for (std::size_t i = 0; i < jointNodes.size(); i++)
+			inverseBindTransforms[i] = globalTransforms[jointNodes[i]].Inverse();
+	}
+
+	// Non-joint nodes between a joint and its parent joint (or the scene root) are folded into the joint offset.
+	std::vector<std::vector<uint32_t>> children(jointNodes.size());
+	std::vector<uint32_t> roots;
+	jointOffsets.resize(jointNodes.size());
+
+	for (uint32_t i = 0; i < jointNodes.size(); i++) {
+		auto parentNode = parents[jointNodes[i]];
+		auto parent = parentNode;
+		while (parent != -1 && jointIndices.count(parent) == 0)
+			parent = parents[parent];
+
+		Matrix4 offset;
+		if (parent != -1)
+			offset = globalTransforms[parent].Inverse();
+		if (parentNode != -1 && parentNode != parent)
+			offset = offset * globalTransforms[parentNode];
+		jointOffsets[i] = offset;
+
+		if (parent != -1)
+			children[jointIndices[parent]].emplace_back(i);
+		else
+			roots.emplace_back(i);
+	}
+
+	std::function<Joint(uint32_t)> buildJoint = [&](uint32_t index) {
+		Joint joint(index, jointNames[index], jointOffsets[index] * GetLocalTransform(gltfModel->nodes[jointNodes[index]]));
+		joint.SetInverseBindTransform(inverseBindTransforms[index]);
+		for (auto child : children[index])
+			joint.AddChild(buildJoint(child));
+		return joint;
+	};
+
+	if (roots.size() == 1) {
+		headJoint = buildJoint(roots[0]);
+		return;
+	}
+
+	// Skeletons with several roots are parented to a joint that is never uploaded.
+	rootJointName = "root";
+	while (usedNames.count(rootJointName) != 0)
+		rootJointName += '_';
+
+	headJoint = Joint(std::numeric_limits<uint32_t>::max(), rootJointName, Matrix4());
+	for (auto root : roots)
+		headJoint.AddChild(buildJoint(root));
+}
+
+void GltfLoader::LoadAnimations() {
+	std::map<int32_t, uint32_t> jointIndices;
+	for (uint32_t i = 0; i < jointNodes.size(); i++)
+		jointIndices[jointNodes[i]] = i;
+
+	// Joints that are not animated hold their rest pose.
+	std::vector<Vector3f> restPositions(jointNodes.size());
+	std::vector<Quaternion> restRotations(jointNodes.size());
+
+	for (std::size_t i = 0; i < jointNodes.size(); i++) {
+		auto local = GetLocalTransform(gltfModel->nodes[jointNodes[i]]);
+		restPositions[i] = local[3];
+		restRotations[i] = Quaternion(local);
+	}
+
+	for (const auto &gltfAnimation : gltfModel->animations) {
+		std::map<int32_t, AnimationTrack> tracks;
+		std::vector<const AnimationTrack *> positionTracks(jointNodes.size()), rotationTracks(jointNodes.size());
+
+		for (const auto &channel : gltfAnimation.channels) {
+			auto joint = jointIndices.find(channel.target_node);
+			if (joint == jointIndices.end() || (channel.target_path != "translation" && channel.target_path != "rotation"))
+				continue;
+
+			auto track = tracks.find(channel.sampler);
+			if (track == tracks.end())
+				track = tracks.emplace(channel.sampler, AnimationTrack(*gltfModel, gltfAnimation.samplers.at(channel.sampler))).first;
+
+			(channel.target_path == "translation" ? positionTracks : rotationTracks)[joint->second] = &track->second;
+		}
+
+		// Keyframes are placed at every time any track has a key, starting from zero as the animator expects.
+		std::vector<float> times = {0.0f};
+		for (const auto &[samplerIndex, track] : tracks)
+			times.insert(times.end(), track.GetTimes().begin(), track.GetTimes().end());
+
+		std::sort(times.begin(), times.end());
+		times.erase(std::unique(times.begin(), times.end(), [](float a, float b) {
+			return std::abs(a - b) < 0.0001f;
+		}), times.end());
+
+		if (tracks.empty() || times.size() < 2)
+			continue;
+
+		std::vector<Keyframe> keyframes(times.size());
+		ParallelFor(times.size(), 16, [&](std::size_t begin, std::size_t end) {
+			for (auto k = begin; k < end; k++) {
+				std::map<std::string, JointTransform> pose;
+
+				for (std::size_t i = 0; i < jointNodes.size(); i++) {
+					auto position = positionTracks[i] ? positionTracks[i]->SamplePosition(times[k]) : restPositions[i];
+					auto rotation = rotationTracks[i] ? rotationTracks[i]->SampleRotation(times[k]) : restRotations[i];
+					JointTransform transform(position, rotation);
+
+					if (jointOffsets[i] != Matrix4())
+						transform = JointTransform(jointOffsets[i] * transform.GetLocalTransform());
+					pose.emplace(jointNames[i], transform);
+				}
+
+				if (!rootJointName.empty())
+					pose.emplace(rootJointName, JointTransform());
+
+				keyframes[k] = Keyframe(Time::Seconds(times[k]), std::move(pose));
+			}
+		});
+
+		animations.emplace_back(Time::Seconds(times.back()), std::move(keyframes));
+	}
+}
+}
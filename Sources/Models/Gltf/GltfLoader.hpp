@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Animations/Animation/Animation.hpp"
+#include "Animations/Geometry/VertexAnimated.hpp"
+#include "Animations/Skeleton/Joint.hpp"
+#include "Materials/DefaultMaterial.hpp"
+#include "Models/Vertex3d.hpp"
+#include "Utils/NonCopyable.hpp"
+
+namespace tinygltf {
+class Model;
+}
+
+namespace acid {
+/**
+ * @brief Class that imports the meshes, materials, skin and animations of a glTF 2.0 (.gltf or .glb) file.
+ * Accessors are read directly from the binary buffers into one contiguous vertex and index list,
+ * primitives and embedded images of large files are decoded in parallel on the resource thread pool.
+ */
+class ACID_EXPORT GltfLoader : NonCopyable {
+public:
+	/**
+	 * @brief A range of indices drawn with a single material.
+	 */
+	class Primitive {
+	public:
+		uint32_t indexOffset = 0;
+		uint32_t indexCount = 0;
+		int32_t material = -1;
+	};
+
+	/**
+	 * Creates a new glTF loader.
+	 * @param filename The file to load from.
+	 * @param animated If the first skin will be imported, producing {@link VertexAnimated} vertices, a skeleton and animations.
+	 * @param createMaterials If the images and materials are created immediately, otherwise {@link GltfLoader#CreateMaterials} can be called later on the main thread.
+	 */
+	explicit GltfLoader(const std::filesystem::path &filename, bool animated = false, bool createMaterials = true);
+	~GltfLoader();
+
+	/**
+	 * Creates the images and materials, images are created on the device so a loader on a resource thread leaves this to the main thread.
+	 */
+	void CreateMaterials();
+
+	const std::vector<Vertex3d> &GetVertices() const { return vertices; }
+	const std::vector<VertexAnimated> &GetAnimatedVertices() const { return animatedVertices; }
+	const std::vector<uint32_t> &GetIndices() const { return indices; }
+	const std::vector<Primitive> &GetPrimitives() const { return primitives; }
+
+	/**
+	 * Gets if a skin was imported, only when the loader was created as animated.
+	 * @return If the loader has a skeleton.
+	 */
+	bool IsSkinned() const { return skinned; }
+	const Joint &GetHeadJoint() const { return headJoint; }
+	const std::vector<Animation> &GetAnimations() const { return animations; }
+
+	/**
+	 * Gets the imported glTF materials, images are shared between copies of a material.
+	 * @return The materials, indexed by {@link GltfLoader.Primitive#material}.
+	 */
+	const std::vector<DefaultMaterial> &GetMaterials() const { return materials; }
+
+	/**
+	 * Gets the external buffer files the glTF file was read with, embedded and data URI buffers are not included.
+	 * @return The buffer files, relative to the same search path as the glTF file.
+	 */
+	const std::vector<std::filesystem::path> &GetBufferFiles() const { return bufferFiles; }
+
+	/**
+	 * Creates a new material from one of the imported materials, the images are shared with the imported material.
+	 * @param materials The imported materials.
+	 * @param index The material index.
+	 * @return The new material, or nullptr if the index is out of range.
+	 */
+	static std::unique_ptr<DefaultMaterial> CreateMaterial(const std::vector<DefaultMaterial> &materials, std::size_t index);
+
+private:
+	class MeshNode;
+
+	void DecodeImages();
+	void CreateImages();
+	void LoadMaterials();
+	void LoadMeshes(int32_t skinIndex);
+	void LoadSkin(int32_t skinIndex);
+	void LoadAnimations();
+
+	std::filesystem::path filename;
+	std::unique_ptr<tinygltf::Model> gltfModel;
+	std::vector<std::filesystem::path> bufferFiles;
+
+	std::vector<int32_t> parents;
+	std::vector<Matrix4> globalTransforms;
+
+	std::vector<Vertex3d> vertices;
+	std::vector<VertexAnimated> animatedVertices;
+	std::vector<uint32_t> indices;
+	std::vector<Primitive> primitives;
+
+	bool skinned = false;
+	std::vector<int32_t> jointNodes;
+	std::vector<std::string> jointNames;
+	std::vector<Matrix4> jointOffsets;
+	std::string rootJointName;
+	Joint headJoint;
+	std::vector<Animation> animations;
+
+	std::vector<std::unique_ptr<Bitmap>> bitmaps;
+	std::vector<std::shared_ptr<Image2d>> images;
+	std::vector<DefaultMaterial> materials;
+};
+}
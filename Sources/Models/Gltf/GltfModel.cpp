@@ -1,10 +1,6 @@
 #include "GltfModel.hpp"
 
-#include <tinygltf/tiny_gltf.h>
-
-#include "Files/Files.hpp"
 #include "Resources/Resources.hpp"
-#include "Models/Vertex3d.hpp"
 
 namespace acid {
 std::shared_ptr<GltfModel> GltfModel::Create(const Node &node) {
@@ -15,6 +11,7 @@ std::shared_ptr<GltfModel> GltfModel::Create(const Node &node) {
 	Resources::Get()->Add(node, std::dynamic_pointer_cast<Resource>(result));
 	node >> *result;
 	result->Load();
+	result->Upload();
 	return result;
 }
 
@@ -29,9 +26,14 @@ GltfModel::GltfModel(std::filesystem::path filename, bool load) :
 	filename(std::move(filename)) {
 	if (load) {
 		Load();
+		GltfModel::Upload();
 	}
 }
 
+std::unique_ptr<DefaultMaterial> GltfModel::CreateMaterial(std::size_t index) const {
+	return GltfLoader::CreateMaterial(materials, index);
+}
+
 const Node &operator>>(const Node &node, GltfModel &model) {
 	node["filename"].Get(model.filename);
 	return node;
@@ -42,78 +44,51 @@ Node &operator<<(Node &node, const GltfModel &model) {
 	return node;
 }
 
-void GltfModel::Load() {
-	if (filename.empty()) {
-		return;
-	}
+std::shared_ptr<Resource> GltfModel::Reload() const {
+	if (filename.empty())
+		return nullptr;
 
-#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif
-
-	auto folder = filename.parent_path();
-	auto fileLoaded = Files::Read(filename);
-
-	if (!fileLoaded) {
-		Log::Error("Model could not be loaded: ", filename, '\n');
-		return;
-	}
+	auto model = std::make_shared<GltfModel>(filename, false);
+	model->Load();
+	return model;
+}
 
-	tinygltf::Model gltfModel;
-	tinygltf::TinyGLTF gltfContext;
-	std::string warn, err;
-
-	if (filename.extension() == ".glb") {
-		if (!gltfContext.LoadBinaryFromMemory(&gltfModel, &err, &warn, reinterpret_cast<uint8_t *>(fileLoaded->data()), static_cast<uint32_t>(fileLoaded->size()))) {
-			throw std::runtime_error(warn + err);
-		}
-	} else {
-		if (!gltfContext.LoadASCIIFromString(&gltfModel, &err, &warn, fileLoaded->c_str(), static_cast<uint32_t>(fileLoaded->size()), folder.string())) {
-			throw std::runtime_error(warn + err);
-		}
+void GltfModel::Upload() {
+	if (loader) {
+		loader->CreateMaterials();
+		materials = loader->GetMaterials();
+		loader.reset();
 	}
 
-	std::vector<Vertex3d> vertices;
-	std::vector<uint32_t> indices;
-	std::unordered_map<Vertex3d, size_t> uniqueVertices;
-
-	//LoadTextureSamplers(gltfModel);
-	//LoadTextures(gltfModel);
-	//LoadMaterials(gltfModel);
-	auto scale = 1.0f;
-
-	// TODO: Scene handling with no default scene.
-	/*const tinygltf::Scene &scene = gltfModel.scenes[gltfModel.defaultScene > -1 ? gltfModel.defaultScene : 0];
+	Model::Upload();
+}
 
-	for (std::size_t i = 0; i < scene.nodes.size(); i++) {
-		const tinygltf::Node node = gltfModel.nodes[scene.nodes[i]];
-		LoadNode(nullptr, node, scene.nodes[i], gltfModel, indices, vertices, scale);
-	}
+void GltfModel::Swap(Resource &other) {
+	Model::Swap(other);
+	auto &model = dynamic_cast<GltfModel &>(other);
+	std::swap(primitives, model.primitives);
+	std::swap(materials, model.materials);
+}
 
-	if (gltfModel.animations.size() > 0) {
-		LoadAnimations(gltfModel);
+void GltfModel::Load() {
+	if (filename.empty()) {
+		return;
 	}
 
-	LoadSkins(gltfModel);
-
-	for (auto node : linearNodes) {
-		// Assign skins.
-		if (node->skinIndex > -1) {
-			node->skin = skins[node->skinIndex];
-		}
-
-		// Initial pose.
-		if (node->mesh) {
-			node->update();
-		}
-	}
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
 
-	auto extensions = gltfModel.extensionsUsed;*/
+	// Materials create their images on the device, so the loader is kept until the model is uploaded.
+	loader = std::make_unique<GltfLoader>(filename, false, false);
+	primitives = loader->GetPrimitives();
+	dependencies = loader->GetBufferFiles();
+	dependencies.insert(dependencies.begin(), filename);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Model ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
 #endif
 
-	Initialize(vertices, indices);
+	Stage(loader->GetVertices(), loader->GetIndices());
 }
 }
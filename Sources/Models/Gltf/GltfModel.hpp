@@ -1,14 +1,14 @@
 #pragma once
 
 #include "Models/Model.hpp"
-#include "Graphics/Images/Image2d.hpp"
+#include "GltfLoader.hpp"
 
 namespace acid {
 /**
- * @brief Resource that represents a GLTF model.
+ * @brief Resource that represents a GLTF model, the meshes of the default scene are merged into one model.
  */
 class ACID_EXPORT GltfModel : public Model::Registrar<GltfModel> {
-	inline static const bool Registered = Register("gltf", ".gltf");
+	inline static const bool Registered = Register("gltf", ".gltf") && Register("gltf", ".glb");
 public:
 	/**
 	 * Creates a new GLTF model, or finds one with the same values.
@@ -31,19 +31,31 @@ public:
 	 */
 	explicit GltfModel(std::filesystem::path filename, bool load = true);
 
+	std::shared_ptr<Resource> Reload() const override;
+	void Upload() override;
+	void Swap(Resource &other) override;
+
+	const std::vector<GltfLoader::Primitive> &GetPrimitives() const { return primitives; }
+	const std::vector<DefaultMaterial> &GetMaterials() const { return materials; }
+
+	/**
+	 * Creates a new material from one of the materials in the GLTF file.
+	 * @param index The GLTF material index.
+	 * @return The new material, or nullptr if the index is out of range.
+	 */
+	std::unique_ptr<DefaultMaterial> CreateMaterial(std::size_t index) const;
+
 	friend const Node &operator>>(const Node &node, GltfModel &model);
 	friend Node &operator<<(Node &node, const GltfModel &model);
 
 private:
 	void Load();
-	
-	//struct Node;
-	//struct Skin;
 
 	std::filesystem::path filename;
 
-	//std::vector<Node *> nodes;
-	//std::vector<Node *> linearNodes;
-	//std::vector<Skin *> skins;
+	std::vector<GltfLoader::Primitive> primitives;
+	std::vector<DefaultMaterial> materials;
+	/// The loader of a model read but not yet uploaded.
+	std::unique_ptr<GltfLoader> loader;
 };
 }
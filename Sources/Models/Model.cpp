@@ -51,14 +51,18 @@ std::vector<uint32_t> Model::GetIndices(std::size_t offset) const {
 }
 
 void Model::SetIndices(const std::vector<uint32_t> &indices) {
+	SetIndices(indices.data(), indices.size());
+}
+
+void Model::SetIndices(const uint32_t *indices, std::size_t indexCount) {
 	indexBuffer = nullptr;
-	indexCount = static_cast<uint32_t>(indices.size());
+	this->indexCount = static_cast<uint32_t>(indexCount);
 
-	if (indices.empty())
+	if (indexCount == 0)
 		return;
 	
-	Buffer indexStaging(sizeof(uint32_t) * indices.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		indices.data());
+	Buffer indexStaging(sizeof(uint32_t) * indexCount, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		indices);
 	indexBuffer = std::make_unique<Buffer>(indexStaging.GetSize(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
@@ -71,6 +75,23 @@ void Model::SetIndices(const std::vector<uint32_t> &indices) {
 	commandBuffer.SubmitIdle();
 }
 
+void Model::Upload() {
+	if (auto initialize = std::exchange(staged, nullptr))
+		initialize();
+}
+
+void Model::Swap(Resource &other) {
+	Resource::Swap(other);
+	auto &model = dynamic_cast<Model &>(other);
+	std::swap(vertexBuffer, model.vertexBuffer);
+	std::swap(indexBuffer, model.indexBuffer);
+	std::swap(vertexCount, model.vertexCount);
+	std::swap(indexCount, model.indexCount);
+	std::swap(minExtents, model.minExtents);
+	std::swap(maxExtents, model.maxExtents);
+	std::swap(radius, model.radius);
+}
+
 std::vector<float> Model::GetPointCloud() const {
 	if (!vertexBuffer) return {};
 
@@ -124,17 +124,33 @@ public:
 	template<typename T>
 	explicit Model(const std::vector<T> &vertices, const std::vector<uint32_t> &indices = {});
 
+	/**
+	 * Creates a new model from contiguous memory, such as a mapped file, without copying into a vector first.
+	 * @tparam T The vertex type.
+	 * @param vertices The model vertices.
+	 * @param vertexCount The number of vertices.
+	 * @param indices The model indices.
+	 * @param indexCount The number of indices.
+	 */
+	template<typename T>
+	Model(const T *vertices, std::size_t vertexCount, const uint32_t *indices = nullptr, std::size_t indexCount = 0);
+
 	bool CmdRender(const CommandBuffer &commandBuffer, uint32_t instances = 1) const;
 
 	std::type_index GetTypeIndex() const override { return typeid(Model); }
+	void Upload() override;
+	void Swap(Resource &other) override;
 
 	template<typename T>
 	std::vector<T> GetVertices(std::size_t offset = 0) const;
 	template<typename T>
 	void SetVertices(const std::vector<T> &vertices);
+	template<typename T>
+	void SetVertices(const T *vertices, std::size_t vertexCount);
 
 	std::vector<uint32_t> GetIndices(std::size_t offset = 0) const;
 	void SetIndices(const std::vector<uint32_t> &indices);
+	void SetIndices(const uint32_t *indices, std::size_t indexCount);
 
 	std::vector<float> GetPointCloud() const;
 
@@ -153,6 +169,17 @@ public:
 protected:
 	template<typename T>
 	void Initialize(const std::vector<T> &vertices, const std::vector<uint32_t> &indices = {});
+	template<typename T>
+	void Initialize(const T *vertices, std::size_t vertexCount, const uint32_t *indices, std::size_t indexCount);
+
+	/**
+	 * Keeps vertices and indices read from a file, so a model loaded on a resource thread creates its buffers in {@link Model#Upload} on the main thread.
+	 * @tparam T The vertex type.
+	 * @param vertices The model vertices.
+	 * @param indices The model indices.
+	 */
+	template<typename T>
+	void Stage(std::vector<T> vertices, std::vector<uint32_t> indices);
 
 private:
 	std::unique_ptr<Buffer> vertexBuffer;
@@ -163,6 +190,9 @@ private:
 	Vector3f minExtents;
 	Vector3f maxExtents;
 	float radius = 0.0f;
+
+	/// Initializes the model from the staged vertices and indices, until it is uploaded.
+	std::function<void()> staged;
 };
 
 template<typename T>
@@ -171,6 +201,12 @@ Model::Model(const std::vector<T> &vertices, const std::vector<uint32_t> &indice
 	Initialize(vertices, indices);
 }
 
+template<typename T>
+Model::Model(const T *vertices, std::size_t vertexCount, const uint32_t *indices, std::size_t indexCount) :
+	Model() {
+	Initialize(vertices, vertexCount, indices, indexCount);
+}
+
 template<typename T>
 std::vector<T> Model::GetVertices(std::size_t offset) const {
 	Buffer vertexStaging(vertexBuffer->GetSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -200,14 +236,19 @@ std::vector<T> Model::GetVertices(std::size_t offset) const {
 
 template<typename T>
 void Model::SetVertices(const std::vector<T> &vertices) {
+	SetVertices(vertices.data(), vertices.size());
+}
+
+template<typename T>
+void Model::SetVertices(const T *vertices, std::size_t vertexCount) {
 	vertexBuffer = nullptr;
-	vertexCount = static_cast<uint32_t>(vertices.size());
+	this->vertexCount = static_cast<uint32_t>(vertexCount);
 
-	if (vertices.empty())
+	if (vertexCount == 0)
 		return;
 
-	Buffer vertexStaging(sizeof(T) * vertices.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		vertices.data());
+	Buffer vertexStaging(sizeof(T) * vertexCount, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		vertices);
 	vertexBuffer = std::make_unique<Buffer>(vertexStaging.GetSize(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
@@ -222,18 +263,30 @@ void Model::SetVertices(const std::vector<T> &vertices) {
 
 template<typename T>
 void Model::Initialize(const std::vector<T> &vertices, const std::vector<uint32_t> &indices) {
-	SetVertices(vertices);
-	SetIndices(indices);
+	Initialize(vertices.data(), vertices.size(), indices.data(), indices.size());
+}
+
+template<typename T>
+void Model::Initialize(const T *vertices, std::size_t vertexCount, const uint32_t *indices, std::size_t indexCount) {
+	SetVertices(vertices, vertexCount);
+	SetIndices(indices, indexCount);
 
 	minExtents = Vector3f::Infinity;
 	maxExtents = -Vector3f::Infinity;
 
-	for (const auto &vertex : vertices) {
-		Vector3f position(vertex.position);
+	for (std::size_t i = 0; i < vertexCount; i++) {
+		Vector3f position(vertices[i].position);
 		minExtents = minExtents.Min(position);
 		maxExtents = maxExtents.Max(position);
 	}
 
 	radius = std::max(minExtents.Length(), maxExtents.Length());
 }
+
+template<typename T>
+void Model::Stage(std::vector<T> vertices, std::vector<uint32_t> indices) {
+	staged = [this, vertices = std::move(vertices), indices = std::move(indices)] {
+		Initialize(vertices, indices);
+	};
+}
 }
@@ -1,5 +1,6 @@
 #include "ObjModel.hpp"
 
+#include <sstream>
 #include <tinyobj/tiny_obj.h>
 
 #include "Files/Files.hpp"
@@ -7,6 +8,11 @@
 #include "Models/Vertex3d.hpp"
 
 namespace acid {
+static std::istringstream ReadStream(const std::filesystem::path &filename) {
+	auto file = Files::ReadAsync(filename).get();
+	return std::istringstream(std::string(reinterpret_cast<const char *>(file->GetData()), file->GetSize()));
+}
+
 class MaterialStreamReader : public tinyobj::MaterialReader {
 public:
 	explicit MaterialStreamReader(std::filesystem::path folder) :
@@ -27,7 +33,7 @@ public:
 			return false;
 		}
 
-		IFStream inStream(filepath);
+		auto inStream = ReadStream(filepath);
 		tinyobj::LoadMtl(matMap, materials, &inStream, warn, err);
 		return true;
 	}
@@ -44,6 +50,7 @@ std::shared_ptr<ObjModel> ObjModel::Create(const Node &node) {
 	Resources::Get()->Add(node, std::dynamic_pointer_cast<Resource>(result));
 	node >> *result;
 	result->Load();
+	result->Upload();
 	return result;
 }
 
@@ -58,6 +65,7 @@ ObjModel::ObjModel(std::filesystem::path filename, bool load) :
 	filename(std::move(filename)) {
 	if (load) {
 		Load();
+		Model::Upload();
 	}
 }
 
@@ -71,6 +79,15 @@ Node &operator<<(Node &node, const ObjModel &model) {
 	return node;
 }
 
+std::shared_ptr<Resource> ObjModel::Reload() const {
+	if (filename.empty())
+		return nullptr;
+
+	auto model = std::make_shared<ObjModel>(filename, false);
+	model->Load();
+	return model;
+}
+
 void ObjModel::Load() {
 	if (filename.empty()) {
 		return;
@@ -81,7 +98,7 @@ void ObjModel::Load() {
 #endif
 
 	auto folder = filename.parent_path();
-	IFStream inStream(filename);
+	auto inStream = ReadStream(filename);
 	MaterialStreamReader materialReader(folder);
 
 	tinyobj::attrib_t attrib;
@@ -93,6 +110,8 @@ void ObjModel::Load() {
 		throw std::runtime_error(warn + err);
 	}
 
+	dependencies = {filename};
+
 	std::vector<Vertex3d> vertices;
 	std::vector<uint32_t> indices;
 	std::unordered_map<Vertex3d, size_t> uniqueVertices;
@@ -123,6 +142,6 @@ void ObjModel::Load() {
 	Log::Out("Model ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
 #endif
 
-	Initialize(vertices, indices);
+	Stage(std::move(vertices), std::move(indices));
 }
 }
@@ -30,6 +30,8 @@ public:
 	 */
 	explicit ObjModel(std::filesystem::path filename, bool load = true);
 
+	std::shared_ptr<Resource> Reload() const override;
+
 	friend const Node &operator>>(const Node &node, ObjModel &model);
 	friend Node &operator<<(Node &node, const ObjModel &model);
 
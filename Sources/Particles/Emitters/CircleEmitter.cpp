@@ -29,16 +29,4 @@ Vector3f CircleEmitter::GeneratePosition() const {
 	auto distance = Vector3f(randX, randY, 0.0f).Length();
 	return direction * distance;
 }
-
-const Node &operator>>(const Node &node, CircleEmitter &emitter) {
-	node["radius"].Get(emitter.radius);
-	node["heading"].Get(emitter.heading);
-	return node;
-}
-
-Node &operator<<(Node &node, const CircleEmitter &emitter) {
-	node["radius"].Set(emitter.radius);
-	node["heading"].Set(emitter.heading);
-	return node;
-}
 }
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Emitter.hpp"
+#include "Files/NodeReflect.hpp"
 
 namespace acid {
 class ACID_EXPORT CircleEmitter : public Emitter::Registrar<CircleEmitter> {
@@ -16,8 +17,11 @@ public:
 	const Vector3f &GetHeading() const { return heading; }
 	void SetHeading(const Vector3f &heading) { this->heading = heading; }
 
-	friend const Node &operator>>(const Node &node, CircleEmitter &emitter);
-	friend Node &operator<<(Node &node, const CircleEmitter &emitter);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("radius", &CircleEmitter::radius),
+			NodeField("heading", &CircleEmitter::heading));
+	}
 
 private:
 	float radius;
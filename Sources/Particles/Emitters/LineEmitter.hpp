@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Emitter.hpp"
+#include "Files/NodeReflect.hpp"
 
 namespace acid {
 class ACID_EXPORT LineEmitter : public Emitter::Registrar<LineEmitter> {
@@ -16,8 +17,11 @@ public:
 	const Vector3f &GetAxis() const { return axis; }
 	void SetAxis(const Vector3f &axis) { this->axis = axis; }
 
-	friend const Node &operator>>(const Node &node, LineEmitter &emitter);
-	friend Node &operator<<(Node &node, const LineEmitter &emitter);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("length", &LineEmitter::length),
+			NodeField("axis", &LineEmitter::axis));
+	}
 
 private:
 	float length;
@@ -9,14 +9,4 @@ PointEmitter::PointEmitter() {
 Vector3f PointEmitter::GeneratePosition() const {
 	return point;
 }
-
-const Node &operator>>(const Node &node, PointEmitter &emitter) {
-	node["point"].Get(emitter.point);
-	return node;
-}
-
-Node &operator<<(Node &node, const PointEmitter &emitter) {
-	node["point"].Set(emitter.point);
-	return node;
-}
 }
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Emitter.hpp"
+#include "Files/NodeReflect.hpp"
 
 namespace acid {
 class ACID_EXPORT PointEmitter : public Emitter::Registrar<PointEmitter> {
@@ -13,8 +14,10 @@ public:
 	const Vector3f &GetPoint() const { return point; }
 	void SetPoint(const Vector3f &point) { this->point = point; }
 
-	friend const Node &operator>>(const Node &node, PointEmitter &emitter);
-	friend Node &operator<<(Node &node, const PointEmitter &emitter);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("point", &PointEmitter::point));
+	}
 
 private:
 	Vector3f point;
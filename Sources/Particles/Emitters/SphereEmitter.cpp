@@ -19,14 +19,4 @@ Vector3f SphereEmitter::GeneratePosition() const {
 	auto distance = Vector2f(randX, randY).Length();
 	return radius * distance * RandomUnitVector();
 }
-
-const Node &operator>>(const Node &node, SphereEmitter &emitter) {
-	node["radius"].Get(emitter.radius);
-	return node;
-}
-
-Node &operator<<(Node &node, const SphereEmitter &emitter) {
-	node["radius"].Set(emitter.radius);
-	return node;
-}
 }
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Emitter.hpp"
+#include "Files/NodeReflect.hpp"
 
 namespace acid {
 class ACID_EXPORT SphereEmitter : public Emitter::Registrar<SphereEmitter> {
@@ -13,8 +14,10 @@ public:
 	float GetRadius() const { return radius; }
 	void SetRadius(float radius) { this->radius = radius; }
 
-	friend const Node &operator>>(const Node &node, SphereEmitter &emitter);
-	friend Node &operator<<(Node &node, const SphereEmitter &emitter);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("radius", &SphereEmitter::radius));
+	}
 
 private:
 	float radius;
@@ -133,36 +133,4 @@ Vector3f ParticleSystem::GenerateRandomUnitVector() const {
 	auto y = rootOneMinusZSquared * std::sin(theta);
 	return {x, y, z};
 }
-
-const Node &operator>>(const Node &node, ParticleSystem &particleSystem) {
-	node["types"].Get(particleSystem.types);
-	node["emitters"].Get(particleSystem.emitters);
-	node["pps"].Get(particleSystem.pps);
-	node["averageSpeed"].Get(particleSystem.averageSpeed);
-	node["gravityEffect"].Get(particleSystem.gravityEffect);
-	node["randomRotation"].Get(particleSystem.randomRotation);
-	node["direction"].Get(particleSystem.direction);
-	node["directionDeviation"].Get(particleSystem.directionDeviation);
-	node["speedDeviation"].Get(particleSystem.speedDeviation);
-	node["lifeDeviation"].Get(particleSystem.lifeDeviation);
-	node["stageDeviation"].Get(particleSystem.stageDeviation);
-	node["scaleDeviation"].Get(particleSystem.scaleDeviation);
-	return node;
-}
-
-Node &operator<<(Node &node, const ParticleSystem &particleSystem) {
-	node["types"].Set(particleSystem.types);
-	node["emitters"].Set(particleSystem.emitters);
-	node["pps"].Set(particleSystem.pps);
-	node["averageSpeed"].Set(particleSystem.averageSpeed);
-	node["gravityEffect"].Set(particleSystem.gravityEffect);
-	node["randomRotation"].Set(particleSystem.randomRotation);
-	node["direction"].Set(particleSystem.direction);
-	node["directionDeviation"].Set(particleSystem.directionDeviation);
-	node["speedDeviation"].Set(particleSystem.speedDeviation);
-	node["lifeDeviation"].Set(particleSystem.lifeDeviation);
-	node["stageDeviation"].Set(particleSystem.stageDeviation);
-	node["scaleDeviation"].Set(particleSystem.scaleDeviation);
-	return node;
-}
 }
@@ -6,6 +6,7 @@
 #include "Emitters/Emitter.hpp"
 #include "Particle.hpp"
 #include "ParticleType.hpp"
+#include "Files/NodeReflect.hpp"
 
 namespace acid {
 /**
@@ -62,8 +63,21 @@ public:
 	float GetScaleDeviation() const { return scaleDeviation; }
 	void SetScaleDeviation(float scaleDeviation) { this->scaleDeviation = scaleDeviation; }
 
-	friend const Node &operator>>(const Node &node, ParticleSystem &particleSystem);
-	friend Node &operator<<(Node &node, const ParticleSystem &particleSystem);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("types", &ParticleSystem::types),
+			NodeField("emitters", &ParticleSystem::emitters),
+			NodeField("pps", &ParticleSystem::pps),
+			NodeField("averageSpeed", &ParticleSystem::averageSpeed),
+			NodeField("gravityEffect", &ParticleSystem::gravityEffect),
+			NodeField("randomRotation", &ParticleSystem::randomRotation),
+			NodeField("direction", &ParticleSystem::direction),
+			NodeField("directionDeviation", &ParticleSystem::directionDeviation),
+			NodeField("speedDeviation", &ParticleSystem::speedDeviation),
+			NodeField("lifeDeviation", &ParticleSystem::lifeDeviation),
+			NodeField("stageDeviation", &ParticleSystem::stageDeviation),
+			NodeField("scaleDeviation", &ParticleSystem::scaleDeviation));
+	}
 
 private:
 	Particle EmitParticle(const Emitter *emitter);
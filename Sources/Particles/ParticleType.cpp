@@ -106,24 +106,4 @@ bool ParticleType::CmdRender(const CommandBuffer &commandBuffer, const PipelineG
 	vkCmdDrawIndexed(commandBuffer, model->GetIndexCount(), instances, 0, 0, 0);
 	return true;
 }
-
-const Node &operator>>(const Node &node, ParticleType &particleType) {
-	node["image"].Get(particleType.image);
-	node["numberOfRows"].Get(particleType.numberOfRows);
-	node["colourOffset"].Get(particleType.colourOffset);
-	node["lifeLength"].Get(particleType.lifeLength);
-	node["stageCycles"].Get(particleType.stageCycles);
-	node["scale"].Get(particleType.scale);
-	return node;
-}
-
-Node &operator<<(Node &node, const ParticleType &particleType) {
-	node["image"].Set(particleType.image);
-	node["numberOfRows"].Set(particleType.numberOfRows);
-	node["colourOffset"].Set(particleType.colourOffset);
-	node["lifeLength"].Set(particleType.lifeLength);
-	node["stageCycles"].Set(particleType.stageCycles);
-	node["scale"].Set(particleType.scale);
-	return node;
-}
 }
@@ -10,6 +10,7 @@
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 #include "Graphics/Images/Image2d.hpp"
 #include "Resources/Resource.hpp"
+#include "Files/NodeReflect.hpp"
 
 namespace acid {
 class Particle;
@@ -99,8 +100,15 @@ public:
 	float GetScale() const { return scale; }
 	void SetScale(float scale) { this->scale = scale; }
 
-	friend const Node &operator>>(const Node &node, ParticleType &particleType);
-	friend Node &operator<<(Node &node, const ParticleType &particleType);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("image", &ParticleType::image),
+			NodeField("numberOfRows", &ParticleType::numberOfRows),
+			NodeField("colourOffset", &ParticleType::colourOffset),
+			NodeField("lifeLength", &ParticleType::lifeLength),
+			NodeField("stageCycles", &ParticleType::stageCycles),
+			NodeField("scale", &ParticleType::scale));
+	}
 
 private:
 	std::shared_ptr<Image2d> image;
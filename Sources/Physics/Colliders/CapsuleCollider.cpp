@@ -30,18 +30,4 @@ void CapsuleCollider::SetHeight(float height) {
 	shape->setImplicitShapeDimensions({radius, 0.5f * height, radius});
 	localTransform.SetLocalScale({radius, height, radius});
 }
-
-const Node &operator>>(const Node &node, CapsuleCollider &collider) {
-	node["localTransform"].Get(collider.localTransform);
-	node["radius"].Get(collider.radius);
-	node["height"].Get(collider.height);
-	return node;
-}
-
-Node &operator<<(Node &node, const CapsuleCollider &collider) {
-	node["localTransform"].Set(collider.localTransform);
-	node["radius"].Set(collider.radius);
-	node["height"].Set(collider.height);
-	return node;
-}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
+#include "Files/NodeReflect.hpp"
 
 class btCapsuleShape;
 
@@ -19,8 +20,12 @@ public:
 	float GetHeight() const { return height; }
 	void SetHeight(float height);
 
-	friend const Node &operator>>(const Node &node, CapsuleCollider &collider);
-	friend Node &operator<<(Node &node, const CapsuleCollider &collider);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("localTransform", &CapsuleCollider::localTransform),
+			NodeField("radius", &CapsuleCollider::radius),
+			NodeField("height", &CapsuleCollider::height));
+	}
 
 private:
 	std::unique_ptr<btCapsuleShape> shape;
@@ -30,18 +30,4 @@ void ConeCollider::SetHeight(float height) {
 	shape->setHeight(height);
 	localTransform.SetLocalScale({radius, height, radius});
 }
-
-const Node &operator>>(const Node &node, ConeCollider &collider) {
-	node["localTransform"].Get(collider.localTransform);
-	node["radius"].Get(collider.radius);
-	node["height"].Get(collider.height);
-	return node;
-}
-
-Node &operator<<(Node &node, const ConeCollider &collider) {
-	node["localTransform"].Set(collider.localTransform);
-	node["radius"].Set(collider.radius);
-	node["height"].Set(collider.height);
-	return node;
-}
 }
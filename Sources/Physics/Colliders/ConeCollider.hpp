@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
+#include "Files/NodeReflect.hpp"
 
 class btConeShape;
 
@@ -19,8 +20,12 @@ public:
 	float GetHeight() const { return height; }
 	void SetHeight(float height);
 
-	friend const Node &operator>>(const Node &node, ConeCollider &collider);
-	friend Node &operator<<(Node &node, const ConeCollider &collider);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("localTransform", &ConeCollider::localTransform),
+			NodeField("radius", &ConeCollider::radius),
+			NodeField("height", &ConeCollider::height));
+	}
 
 private:
 	std::unique_ptr<btConeShape> shape;
@@ -23,16 +23,4 @@ void CubeCollider::SetExtents(const Vector3f &extents) {
 	shape->setImplicitShapeDimensions(Convert(extents));
 	localTransform.SetLocalScale(extents);
 }
-
-const Node &operator>>(const Node &node, CubeCollider &collider) {
-	node["localTransform"].Get(collider.localTransform);
-	node["extents"].Get(collider.extents);
-	return node;
-}
-
-Node &operator<<(Node &node, const CubeCollider &collider) {
-	node["localTransform"].Set(collider.localTransform);
-	node["extents"].Set(collider.extents);
-	return node;
-}
 }
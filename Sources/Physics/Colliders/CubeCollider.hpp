@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
+#include "Files/NodeReflect.hpp"
 
 class btBoxShape;
 
@@ -16,8 +17,11 @@ public:
 	const Vector3f &GetExtents() const { return extents; }
 	void SetExtents(const Vector3f &extents);
 
-	friend const Node &operator>>(const Node &node, CubeCollider &collider);
-	friend Node &operator<<(Node &node, const CubeCollider &collider);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("localTransform", &CubeCollider::localTransform),
+			NodeField("extents", &CubeCollider::extents));
+	}
 
 private:
 	std::unique_ptr<btBoxShape> shape;
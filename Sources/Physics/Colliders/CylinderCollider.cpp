@@ -30,18 +30,4 @@ void CylinderCollider::SetHeight(float height) {
 	shape->setImplicitShapeDimensions({radius, height / 2.0f, radius});
 	localTransform.SetLocalScale({radius, height, radius});
 }
-
-const Node &operator>>(const Node &node, CylinderCollider &collider) {
-	node["localTransform"].Get(collider.localTransform);
-	node["radius"].Get(collider.radius);
-	node["height"].Get(collider.height);
-	return node;
-}
-
-Node &operator<<(Node &node, const CylinderCollider &collider) {
-	node["localTransform"].Set(collider.localTransform);
-	node["radius"].Set(collider.radius);
-	node["height"].Set(collider.height);
-	return node;
-}
 }
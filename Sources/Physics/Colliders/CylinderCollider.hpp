@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
+#include "Files/NodeReflect.hpp"
 
 class btCylinderShape;
 
@@ -19,8 +20,12 @@ public:
 	float GetHeight() const { return height; }
 	void SetHeight(float height);
 
-	friend const Node &operator>>(const Node &node, CylinderCollider &collider);
-	friend Node &operator<<(Node &node, const CylinderCollider &collider);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("localTransform", &CylinderCollider::localTransform),
+			NodeField("radius", &CylinderCollider::radius),
+			NodeField("height", &CylinderCollider::height));
+	}
 
 private:
 	std::unique_ptr<btCylinderShape> shape;
@@ -23,16 +23,4 @@ void SphereCollider::SetRadius(float radius) {
 	shape->setUnscaledRadius(radius);
 	localTransform.SetLocalScale({radius, radius, radius});
 }
-
-const Node &operator>>(const Node &node, SphereCollider &collider) {
-	node["localTransform"].Get(collider.localTransform);
-	node["radius"].Get(collider.radius);
-	return node;
-}
-
-Node &operator<<(Node &node, const SphereCollider &collider) {
-	node["localTransform"].Set(collider.localTransform);
-	node["radius"].Set(collider.radius);
-	return node;
-}
 }
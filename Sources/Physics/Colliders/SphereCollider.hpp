@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
+#include "Files/NodeReflect.hpp"
 
 class btSphereShape;
 
@@ -16,8 +17,11 @@ public:
 	float GetRadius() const { return radius; }
 	void SetRadius(float radius);
 
-	friend const Node &operator>>(const Node &node, SphereCollider &collider);
-	friend Node &operator<<(Node &node, const SphereCollider &collider);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("localTransform", &SphereCollider::localTransform),
+			NodeField("radius", &SphereCollider::radius));
+	}
 
 private:
 	std::unique_ptr<btSphereShape> shape;
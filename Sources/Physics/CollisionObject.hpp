@@ -84,6 +84,12 @@ public:
 	 */
 	Delegate<void(CollisionObject *)> &OnCollision() { return onCollision; }
 
+	/**
+	 * Called every update this object stays in contact with a object, after the first collision.
+	 * @return The delegate.
+	 */
+	Delegate<void(CollisionObject *)> &OnCollisionPersist() { return onCollisionPersist; }
+
 	/**
 	 * Called when this object separates from a object.
 	 * @return The delegate.
@@ -112,6 +118,7 @@ protected:
 	std::vector<std::unique_ptr<Force>> forces;
 
 	Delegate<void(CollisionObject *)> onCollision;
+	Delegate<void(CollisionObject *)> onCollisionPersist;
 	Delegate<void(CollisionObject *)> onSeparation;
 };
 }
@@ -0,0 +1,79 @@
+#include "CollisionPairSet.hpp"
+
+#include <utility>
+
+namespace acid {
+CollisionPairSet::Result CollisionPairSet::Touch(const btCollisionObject *a, const btCollisionObject *b, uint32_t generation) {
+	// Keeps the load factor at or below one half so probe sequences stay short.
+	if ((size + 1) * 2 > entries.size())
+		Rehash(std::max<std::size_t>(entries.size() * 2, 64));
+
+	auto mask = entries.size() - 1;
+
+	for (auto index = GetHome(a, b);; index = (index + 1) & mask) {
+		auto &entry = entries[index];
+
+		if (!entry.a) {
+			entry = {a, b, generation};
+			size++;
+			return Result::Began;
+		}
+
+		if (entry.a == a && entry.b == b) {
+			if (entry.generation == generation)
+				return Result::Repeated;
+
+			entry.generation = generation;
+			return Result::Persisted;
+		}
+	}
+}
+
+void CollisionPairSet::Remove(const btCollisionObject *object) {
+	EraseIf([object](const Entry &entry) {
+		return entry.a == object || entry.b == object;
+	}, [](const btCollisionObject *, const btCollisionObject *) {});
+}
+
+std::size_t CollisionPairSet::GetHome(const btCollisionObject *a, const btCollisionObject *b) const {
+	// Fibonacci hashing of both pointers, the high bits are the best mixed so they are used for the slot.
+	auto hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(a)) * 0x9E3779B97F4A7C15ull;
+	hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(b)) + 0x632BE59BD9B4E019ull + (hash << 6) + (hash >> 2);
+	hash *= 0x9E3779B97F4A7C15ull;
+	return static_cast<std::size_t>(hash >> 32) & (entries.size() - 1);
+}
+
+void CollisionPairSet::Rehash(std::size_t capacity) {
+	auto oldEntries = std::exchange(entries, std::vector<Entry>(capacity));
+	auto mask = capacity - 1;
+
+	for (const auto &entry : oldEntries) {
+		if (!entry.a)
+			continue;
+
+		auto index = GetHome(entry.a, entry.b);
+		while (entries[index].a)
+			index = (index + 1) & mask;
+		entries[index] = entry;
+	}
+}
+
+void CollisionPairSet::Erase(std::size_t index) {
+	// Backward shift deletion, entries after the hole move into it if that keeps them reachable from their home slot.
+	auto mask = entries.size() - 1;
+	auto hole = index;
+
+	for (auto next = (hole + 1) & mask; entries[next].a; next = (next + 1) & mask) {
+		auto home = GetHome(entries[next].a, entries[next].b);
+
+		// The entry can fill the hole if its home is not cyclically between the hole and where it currently is.
+		if (((next - home) & mask) >= ((next - hole) & mask)) {
+			entries[hole] = entries[next];
+			hole = next;
+		}
+	}
+
+	entries[hole] = {};
+	size--;
+}
+}
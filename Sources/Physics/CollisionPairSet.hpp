@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Export.hpp"
+
+class btCollisionObject;
+
+namespace acid {
+/**
+ * @brief Open addressing hash set of the body pairs in contact, each pair is stamped with the last update it was seen in.
+ * Pairs are updated in place every step, so contacts that persist never need to be copied or compared between sets.
+ */
+class ACID_EXPORT CollisionPairSet {
+public:
+	enum class Result {
+		Began, Persisted, Repeated
+	};
+
+	/**
+	 * Inserts a pair or refreshes its stamp.
+	 * @param a The first body, the pair is unordered.
+	 * @param b The second body.
+	 * @param generation The stamp of the current update.
+	 * @return If the pair is new, was also in contact last update, or was already seen this update.
+	 */
+	Result Touch(const btCollisionObject *a, const btCollisionObject *b, uint32_t generation);
+
+	/**
+	 * Removes every pair that was not seen in an update.
+	 * @tparam F The function type, called as f(a, b) for each removed pair.
+	 * @param generation The stamp of the current update.
+	 * @param f The function to run on removed pairs.
+	 */
+	template<typename F>
+	void RemoveStale(uint32_t generation, F &&f);
+
+	/**
+	 * Removes every pair with a body, this must be called before the body is removed from the world and freed.
+	 * @param object The body to remove.
+	 */
+	void Remove(const btCollisionObject *object);
+
+	std::size_t GetSize() const { return size; }
+
+private:
+	class Entry {
+	public:
+		const btCollisionObject *a = nullptr;
+		const btCollisionObject *b = nullptr;
+		uint32_t generation = 0;
+	};
+
+	std::size_t GetHome(const btCollisionObject *a, const btCollisionObject *b) const;
+	void Rehash(std::size_t capacity);
+	void Erase(std::size_t index);
+	template<typename P, typename F>
+	void EraseIf(P &&predicate, F &&f);
+
+	std::vector<Entry> entries;
+	std::size_t size = 0;
+};
+
+template<typename F>
+void CollisionPairSet::RemoveStale(uint32_t generation, F &&f) {
+	EraseIf([generation](const Entry &entry) {
+		return entry.generation != generation;
+	}, f);
+}
+
+template<typename P, typename F>
+void CollisionPairSet::EraseIf(P &&predicate, F &&f) {
+	if (size == 0)
+		return;
+
+	// Starting after an empty slot means no probe sequence wraps around the sweep, erased slots are refilled by later entries and checked again.
+	auto start = static_cast<std::size_t>(std::find_if(entries.begin(), entries.end(), [](const Entry &entry) {
+		return !entry.a;
+	}) - entries.begin());
+	auto mask = entries.size() - 1;
+
+	for (std::size_t step = 1; step <= entries.size();) {
+		auto index = (start + step) & mask;
+		auto &entry = entries[index];
+
+		if (entry.a && predicate(entry)) {
+			f(entry.a, entry.b);
+			Erase(index);
+			continue;
+		}
+
+		step++;
+	}
+}
+}
@@ -25,14 +25,15 @@ KinematicCharacter::~KinematicCharacter() {
 
 	if (physics) {
 		// TODO: Are these being deleted?
-		physics->GetDynamicsWorld()->removeCollisionObject(ghostObject.get());
+		if (ghostObject)
+			physics->RemoveCollisionObject(ghostObject.get());
 		physics->GetDynamicsWorld()->removeAction(controller.get());
 	}
 }
 
 void KinematicCharacter::Start() {
 	if (ghostObject)
-		Scenes::Get()->GetPhysics()->GetDynamicsWorld()->removeCollisionObject(ghostObject.get());
+		Scenes::Get()->GetPhysics()->RemoveCollisionObject(ghostObject.get());
 
 	if (controller)
 		Scenes::Get()->GetPhysics()->GetDynamicsWorld()->removeAction(controller.get());
@@ -169,36 +170,6 @@ void KinematicCharacter::SetWalkDirection(const Vector3f &direction) {
 	controller->setWalkDirection(Collider::Convert(direction));
 }
 
-const Node &operator>>(const Node &node, KinematicCharacter &character) {
-	node["colliders"].Get(character.colliders);
-	node["mass"].Get(character.mass);
-	node["friction"].Get(character.friction);
-	node["frictionRolling"].Get(character.frictionRolling);
-	node["frictionSpinning"].Get(character.frictionSpinning);
-	node["up"].Get(character.up);
-	node["stepHeight"].Get(character.stepHeight);
-	node["fallSpeed"].Get(character.fallSpeed);
-	node["jumpSpeed"].Get(character.jumpSpeed);
-	node["maxHeight"].Get(character.maxHeight);
-	node["interpolate"].Get(character.interpolate);
-	return node;
-}
-
-Node &operator<<(Node &node, const KinematicCharacter &character) {
-	node["colliders"].Set(character.colliders);
-	node["mass"].Set(character.mass);
-	node["friction"].Set(character.friction);
-	node["frictionRolling"].Set(character.frictionRolling);
-	node["frictionSpinning"].Set(character.frictionSpinning);
-	node["up"].Set(character.up);
-	node["stepHeight"].Set(character.stepHeight);
-	node["fallSpeed"].Set(character.fallSpeed);
-	node["jumpSpeed"].Set(character.jumpSpeed);
-	node["maxHeight"].Set(character.maxHeight);
-	node["interpolate"].Set(character.interpolate);
-	return node;
-}
-
 void KinematicCharacter::RecalculateMass() {
 	// TODO
 }
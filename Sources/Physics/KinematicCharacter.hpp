@@ -4,6 +4,7 @@
 #include "Scenes/Component.hpp"
 #include "Colliders/Collider.hpp"
 #include "CollisionObject.hpp"
+#include "Files/NodeReflect.hpp"
 
 class btPairCachingGhostObject;
 class btKinematicCharacterController;
@@ -58,8 +59,20 @@ public:
 	void Jump(const Vector3f &direction);
 	void SetWalkDirection(const Vector3f &direction);
 
-	friend const Node &operator>>(const Node &node, KinematicCharacter &character);
-	friend Node &operator<<(Node &node, const KinematicCharacter &character);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("colliders", &KinematicCharacter::colliders),
+			NodeField("mass", &KinematicCharacter::mass),
+			NodeField("friction", &KinematicCharacter::friction),
+			NodeField("frictionRolling", &KinematicCharacter::frictionRolling),
+			NodeField("frictionSpinning", &KinematicCharacter::frictionSpinning),
+			NodeField("up", &KinematicCharacter::up),
+			NodeField("stepHeight", &KinematicCharacter::stepHeight),
+			NodeField("fallSpeed", &KinematicCharacter::fallSpeed),
+			NodeField("jumpSpeed", &KinematicCharacter::jumpSpeed),
+			NodeField("maxHeight", &KinematicCharacter::maxHeight),
+			NodeField("interpolate", &KinematicCharacter::interpolate));
+	}
 
 protected:
 	void RecalculateMass() override;
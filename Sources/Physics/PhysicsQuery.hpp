@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+
+#include "Maths/Quaternion.hpp"
+#include "Maths/Vector3.hpp"
+
+namespace acid {
+class Collider;
+class CollisionObject;
+
+/**
+ * @brief A ray, shape sweep or shape overlap test submitted to {@link ScenePhysics#Query} in a batch.
+ */
+class ACID_EXPORT PhysicsQuery {
+public:
+	enum class Type {
+		Ray, Sweep, Overlap
+	};
+
+	/// Bullet's default filter group and a mask that accepts every group.
+	static constexpr int32_t DefaultFilterGroup = 1;
+	static constexpr int32_t AllFilterMask = -1;
+
+	/**
+	 * Creates a ray test between two points.
+	 * @param start The start of the ray.
+	 * @param end The end of the ray.
+	 * @param allHits If every hit along the ray is returned, sorted by distance, rather than only the closest.
+	 * @param filterMask The collision groups the ray can hit.
+	 * @return The query.
+	 */
+	static PhysicsQuery Ray(const Vector3f &start, const Vector3f &end, bool allHits = false, int32_t filterMask = AllFilterMask) {
+		return {Type::Ray, start, end, {}, nullptr, allHits, DefaultFilterGroup, filterMask};
+	}
+
+	/**
+	 * Creates a sweep of a convex collider between two points.
+	 * @param collider The convex collider to sweep, this must stay alive until the query has run.
+	 * @param start The start of the sweep.
+	 * @param end The end of the sweep.
+	 * @param rotation The rotation of the collider during the sweep.
+	 * @param allHits If every hit along the sweep is returned, sorted by distance, rather than only the closest.
+	 * @param filterMask The collision groups the sweep can hit.
+	 * @return The query.
+	 */
+	static PhysicsQuery Sweep(const Collider *collider, const Vector3f &start, const Vector3f &end, const Quaternion &rotation = {},
+		bool allHits = false, int32_t filterMask = AllFilterMask) {
+		return {Type::Sweep, start, end, rotation, collider, allHits, DefaultFilterGroup, filterMask};
+	}
+
+	/**
+	 * Creates a test for the objects overlapping a collider.
+	 * @param collider The collider to test with, this must stay alive until the query has run.
+	 * @param position The position of the collider.
+	 * @param rotation The rotation of the collider.
+	 * @param allHits If every overlapping object is returned, rather than only the most penetrating.
+	 * @param filterMask The collision groups the collider can overlap.
+	 * @return The query.
+	 */
+	static PhysicsQuery Overlap(const Collider *collider, const Vector3f &position, const Quaternion &rotation = {}, bool allHits = true,
+		int32_t filterMask = AllFilterMask) {
+		return {Type::Overlap, position, position, rotation, collider, allHits, DefaultFilterGroup, filterMask};
+	}
+
+	Type type = Type::Ray;
+	Vector3f start;
+	Vector3f end;
+	Quaternion rotation;
+	const Collider *collider = nullptr;
+	bool allHits = false;
+	int32_t filterGroup = DefaultFilterGroup;
+	int32_t filterMask = AllFilterMask;
+};
+
+/**
+ * @brief A single hit found by a {@link PhysicsQuery}.
+ */
+class ACID_EXPORT PhysicsQueryHit {
+public:
+	Vector3f pointWorld;
+	Vector3f normalWorld;
+	/// The fraction along the query the hit was found at, overlaps are always zero.
+	float fraction = 0.0f;
+	CollisionObject *collisionObject = nullptr;
+};
+
+/**
+ * @brief The hits of a batch of queries, stored contiguously in the order the queries were submitted.
+ * Results can be reused between batches so their storage is only allocated once.
+ */
+class ACID_EXPORT PhysicsQueryResults {
+	friend class ScenePhysics;
+public:
+	std::size_t GetQueryCount() const { return ranges.size(); }
+
+	bool HasHit(std::size_t query) const { return ranges[query].second != 0; }
+	uint32_t GetHitCount(std::size_t query) const { return ranges[query].second; }
+
+	/**
+	 * Gets the first hit of a query, for closest hit queries this is the only hit.
+	 * @param query The index of the query in the submitted batch.
+	 * @return The hits of the query, {@link PhysicsQueryResults#GetHitCount} long.
+	 */
+	const PhysicsQueryHit *GetHits(std::size_t query) const { return hits.data() + ranges[query].first; }
+
+	/**
+	 * Gets every hit in the batch.
+	 * @return The contiguous hit buffer.
+	 */
+	const std::vector<PhysicsQueryHit> &GetHits() const { return hits; }
+
+private:
+	std::vector<PhysicsQueryHit> hits;
+	/// The offset and count of each queries hits.
+	std::vector<std::pair<uint32_t, uint32_t>> ranges;
+	/// Per job hit buffers, merged into the contiguous buffer once every job has finished.
+	std::vector<std::vector<PhysicsQueryHit>> jobHits;
+};
+}
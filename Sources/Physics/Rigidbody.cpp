@@ -17,16 +17,17 @@ Rigidbody::Rigidbody(std::unique_ptr<Collider> &&collider, float mass, float fri
 }
 
 Rigidbody::~Rigidbody() {
+	// Removing the body waits for a async step, which may still write to the motion state and read the shape.
+	if (auto physics = Scenes::Get()->GetPhysics(); physics && rigidBody)
+		physics->RemoveCollisionObject(rigidBody.get());
+
 	if (auto body = btRigidBody::upcast(this->body); body && body->getMotionState())
 		delete body->getMotionState();
-
-	if (auto physics = Scenes::Get()->GetPhysics())
-		physics->GetDynamicsWorld()->removeRigidBody(rigidBody.get());
 }
 
 void Rigidbody::Start() {
 	if (rigidBody) {
-		Scenes::Get()->GetPhysics()->GetDynamicsWorld()->removeRigidBody(rigidBody.get());
+		Scenes::Get()->GetPhysics()->RemoveCollisionObject(rigidBody.get());
 	}
 
 	CreateShape();
@@ -145,28 +146,6 @@ void Rigidbody::SetAngularVelocity(const Vector3f &angularVelocity) {
 		rigidBody->setAngularVelocity(Collider::Convert(angularVelocity));
 }
 
-const Node &operator>>(const Node &node, Rigidbody &rigidbody) {
-	node["colliders"].Get(rigidbody.colliders);
-	node["mass"].Get(rigidbody.mass);
-	node["friction"].Get(rigidbody.friction);
-	node["frictionRolling"].Get(rigidbody.frictionRolling);
-	node["frictionSpinning"].Get(rigidbody.frictionSpinning);
-	node["linearFactor"].Get(rigidbody.linearFactor);
-	node["angularFactor"].Get(rigidbody.angularFactor);
-	return node;
-}
-
-Node &operator<<(Node &node, const Rigidbody &rigidbody) {
-	node["colliders"].Set(rigidbody.colliders);
-	node["mass"].Set(rigidbody.mass);
-	node["friction"].Set(rigidbody.friction);
-	node["frictionRolling"].Set(rigidbody.frictionRolling);
-	node["frictionSpinning"].Set(rigidbody.frictionSpinning);
-	node["linearFactor"].Set(rigidbody.linearFactor);
-	node["angularFactor"].Set(rigidbody.angularFactor);
-	return node;
-}
-
 void Rigidbody::RecalculateMass() {
 	if (!rigidBody) return;
 
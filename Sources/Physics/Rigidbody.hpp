@@ -3,6 +3,7 @@
 #include "Maths/Vector3.hpp"
 #include "Scenes/Component.hpp"
 #include "CollisionObject.hpp"
+#include "Files/NodeReflect.hpp"
 
 struct btDefaultMotionState;
 class btRigidBody;
@@ -38,8 +39,16 @@ public:
 	void SetLinearVelocity(const Vector3f &linearVelocity) override;
 	void SetAngularVelocity(const Vector3f &angularVelocity) override;
 
-	friend const Node &operator>>(const Node &node, Rigidbody &rigidbody);
-	friend Node &operator<<(Node &node, const Rigidbody &rigidbody);
+	static constexpr auto GetFields() {
+		return std::make_tuple(
+			NodeField("colliders", &Rigidbody::colliders),
+			NodeField("mass", &Rigidbody::mass),
+			NodeField("friction", &Rigidbody::friction),
+			NodeField("frictionRolling", &Rigidbody::frictionRolling),
+			NodeField("frictionSpinning", &Rigidbody::frictionSpinning),
+			NodeField("linearFactor", &Rigidbody::linearFactor),
+			NodeField("angularFactor", &Rigidbody::angularFactor));
+	}
 
 protected:
 	void RecalculateMass() override;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <filesystem>
+#include <memory>
 #include <typeindex>
+#include <vector>
 
 #include "Utils/NonCopyable.hpp"
 #include "Export.hpp"
@@ -15,6 +18,35 @@ public:
 	virtual ~Resource() = default;
 
 	virtual std::type_index GetTypeIndex() const = 0;
+
+	/**
+	 * Loads a new copy of this resource from its dependencies, called on a resource thread when one of them changes.
+	 * Files are only read and decoded here, device objects are created by {@link Resource#Upload}.
+	 * @return The copy to swap in with {@link Resource#Swap}, or nullptr if this resource can not be reloaded.
+	 */
+	virtual std::shared_ptr<Resource> Reload() const { return nullptr; }
+
+	/**
+	 * Creates the device objects of a copy made by {@link Resource#Reload} from what it decoded, called on the main thread before the copy is swapped in.
+	 */
+	virtual void Upload() {}
+
+	/**
+	 * Swaps the loaded contents of this resource with a copy made by {@link Resource#Reload}, called on the main thread.
+	 * The old contents are left in the copy, which is kept alive until the GPU is no longer using them.
+	 * Overrides must call this to swap the dependencies.
+	 * @param other The copy to swap with.
+	 */
+	virtual void Swap(Resource &other) { std::swap(dependencies, other.dependencies); }
+
+	/**
+	 * Gets the files this resource was loaded from, used to find the resources to reload when files change.
+	 * @return The files, as they were given to {@link Files}.
+	 */
+	const std::vector<std::filesystem::path> &GetDependencies() const { return dependencies; }
+
+protected:
+	std::vector<std::filesystem::path> dependencies;
 	
 	/*template<typename T>
 	friend std::enable_if_t<std::is_base_of_v<Resource, T>, const Node &> operator>>(const Node &node, std::shared_ptr<T> &object) {
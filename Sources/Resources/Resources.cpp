@@ -1,5 +1,7 @@
 #include "Resources.hpp"
 
+#include "Files/Files.hpp"
+
 namespace acid {
 Resources::Resources() :
 	elapsedPurge(5s) {
@@ -25,6 +27,9 @@ void Resources::Update() {
 			++it;
 		}
 	}
+
+	UpdateObservers();
+	UpdateReloads();
 }
 
 std::shared_ptr<Resource> Resources::Find(const std::type_index &typeIndex, const Node &node) const {
@@ -55,4 +60,224 @@ void Resources::Remove(const std::shared_ptr<Resource> &resource) {
 	if (resources.empty())
 		this->resources.erase(resource->GetTypeIndex());
 }
+
+void Resources::Track(Resource *resource) {
+	std::unique_lock<std::mutex> lock(mutex);
+	tracked.emplace(resource);
+}
+
+void Resources::Untrack(Resource *resource) {
+	std::shared_ptr<ReloadState> state;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		tracked.erase(resource);
+		swapped.wait(lock, [this, resource] { return swapping != resource; });
+
+		auto it = FindReload(resource);
+		if (it == reloads.end())
+			return;
+
+		state = it->state;
+		abandoned.emplace_back(std::move(it->copy));
+		reloads.erase(it);
+	}
+
+	// The future is never waited on, this may be called on a pool thread the reload is queued behind.
+	// A reload that has not started skips the resource, only one already reading from it is let finish before the resource is destroyed.
+	std::lock_guard<std::mutex> reloadLock(state->mutex);
+	state->abandoned = true;
+}
+
+void Resources::Reload(const std::vector<std::filesystem::path> &filenames) {
+	std::unordered_set<std::string> changed;
+	for (const auto &filename : filenames)
+		changed.emplace(filename.lexically_normal().generic_string());
+
+	auto dependsOnChanged = [&changed](const Resource *resource) {
+		return std::any_of(resource->GetDependencies().begin(), resource->GetDependencies().end(), [&changed](const std::filesystem::path &dependency) {
+			return changed.find(dependency.lexically_normal().generic_string()) != changed.end();
+		});
+	};
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto enqueue = [this](Resource *resource, const std::shared_ptr<Resource> &owner) {
+		// A resource already reloading may have been read before this change, so it is reloaded again once the pending copy is swapped.
+		if (auto it = FindReload(resource); it != reloads.end()) {
+			it->dirty = true;
+			return;
+		}
+
+		PendingReload reload{resource, owner};
+		StartReload(reload);
+		reloads.emplace_back(std::move(reload));
+	};
+
+	for (const auto &[typeIndex, resources] : this->resources) {
+		for (const auto &[key, resource] : resources) {
+			if (dependsOnChanged(resource.get()))
+				enqueue(resource.get(), resource);
+		}
+	}
+
+	for (auto resource : tracked) {
+		if (dependsOnChanged(resource))
+			enqueue(resource, nullptr);
+	}
+}
+
+std::vector<std::filesystem::path> Resources::GetChangedFilenames(const std::vector<FileObserver::Change> &changes, const std::filesystem::path &root) {
+	// Observers report absolute paths while search paths are usually relative, so both are made absolute before comparing.
+	auto absoluteRoot = std::filesystem::absolute(root).lexically_normal();
+	std::vector<std::filesystem::path> filenames;
+	for (const auto &change : changes) {
+		if (change.status == FileObserver::Status::Erased)
+			continue;
+
+		// Dependencies are usually relative to a search path, match both forms.
+		auto path = change.path.lexically_normal();
+		filenames.emplace_back(path);
+		filenames.emplace_back(path.lexically_relative(absoluteRoot));
+	}
+
+	return filenames;
+}
+
+void Resources::SetHotReload(bool hotReload) {
+	this->hotReload = hotReload;
+	UpdateObservers();
+}
+
+void Resources::UpdateObservers() {
+	auto files = Files::Get();
+	if (!hotReload || !files) {
+		observers.clear();
+		return;
+	}
+
+	const auto &searchPaths = files->GetSearchPaths();
+
+	for (auto it = observers.begin(); it != observers.end();) {
+		if (std::find(searchPaths.begin(), searchPaths.end(), it->first) == searchPaths.end()) {
+			it = observers.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	for (const auto &searchPath : searchPaths) {
+		// Packs are read-only, only directories can change.
+		if (observers.find(searchPath) != observers.end() || !std::filesystem::is_directory(searchPath))
+			continue;
+
+		auto observer = std::make_unique<FileObserver>(searchPath);
+		observer->OnChanges().Add([this, root = observer->GetPath()](const std::vector<FileObserver::Change> &changes) {
+			if (auto filenames = GetChangedFilenames(changes, root); !filenames.empty())
+				Reload(filenames);
+		});
+		observers.emplace(searchPath, std::move(observer));
+	}
+}
+
+void Resources::Retire(std::shared_ptr<Resource> resource) {
+	retired.push_back({std::move(resource), RetireUpdates});
+}
+
+void Resources::UpdateReloads() {
+	for (auto it = retired.begin(); it != retired.end();) {
+		if (--it->updates == 0) {
+			it = retired.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	std::vector<std::future<std::shared_ptr<Resource>>> dropped;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (auto it = abandoned.begin(); it != abandoned.end();) {
+			if (it->wait_for(0s) == std::future_status::ready) {
+				dropped.emplace_back(std::move(*it));
+				it = abandoned.erase(it);
+				continue;
+			}
+
+			++it;
+		}
+	}
+
+	// Copies of untracked resources are never uploaded or swapped, they are destroyed here on the main thread and outside the lock.
+	dropped.clear();
+
+	std::vector<Resource *> ready;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (const auto &reload : reloads) {
+			if (reload.copy.wait_for(0s) == std::future_status::ready)
+				ready.emplace_back(reload.resource);
+		}
+	}
+
+	for (auto resource : ready) {
+		std::future<std::shared_ptr<Resource>> copy;
+
+		{
+			// Reloads stay listed until swapped, so changes arriving meanwhile mark them dirty instead of loading alongside the swap.
+			// A tracked resource untracked since it was found ready has had its reload erased, and may already be destroyed.
+			std::unique_lock<std::mutex> lock(mutex);
+			auto it = FindReload(resource);
+			if (it == reloads.end())
+				continue;
+			copy = std::move(it->copy);
+			swapping = resource;
+		}
+
+		try {
+			if (auto loaded = copy.get()) {
+				loaded->Upload();
+				resource->Swap(*loaded);
+				// The copy now holds the old contents, which may still be used by frames in flight.
+				Retire(std::move(loaded));
+			}
+		} catch (const std::exception &e) {
+			Log::Error("Failed to reload resource: ", e.what(), '\n');
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			swapping = nullptr;
+
+			// Untracking waits for the swap, so the reload is still listed.
+			auto it = FindReload(resource);
+			if (it->dirty && (it->owner || tracked.find(resource) != tracked.end())) {
+				it->dirty = false;
+				StartReload(*it);
+			} else {
+				reloads.erase(it);
+			}
+		}
+		swapped.notify_all();
+	}
+}
+
+std::vector<Resources::PendingReload>::iterator Resources::FindReload(Resource *resource) {
+	return std::find_if(reloads.begin(), reloads.end(), [resource](const PendingReload &reload) {
+		return reload.resource == resource;
+	});
+}
+
+void Resources::StartReload(PendingReload &reload) {
+	reload.state = std::make_shared<ReloadState>();
+	reload.copy = threadPool.Enqueue([resource = reload.resource, state = reload.state]() -> std::shared_ptr<Resource> {
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if (state->abandoned)
+			return nullptr;
+		return resource->Reload();
+	});
+}
 }
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <condition_variable>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "Engine/Engine.hpp"
 #include "Utils/ThreadPool.hpp"
+#include "Files/FileObserver.hpp"
 #include "Files/Node.hpp"
 #include "Resource.hpp"
 
@@ -11,6 +14,7 @@ namespace acid {
 /**
  * @brief Module used for managing resources. Resources are held alive as long as they are in use,
  * a existing resource is queried by node value.
+ * When hot reload is enabled the directory search paths are watched, and resources that depend on a changed file are read in the background, then uploaded and swapped in on the main thread.
  */
 class ACID_EXPORT Resources : public Module::Registrar<Resources> {
 	inline static const bool Registered = Register(Stage::Post);
@@ -37,6 +41,47 @@ public:
 	void Add(const Node &node, const std::shared_ptr<Resource> &resource);
 	void Remove(const std::shared_ptr<Resource> &resource);
 
+	/**
+	 * Tracks a resource that is not found by node, so it is still reloaded when its dependencies change.
+	 * @param resource The resource, which must be untracked before it is destroyed.
+	 */
+	void Track(Resource *resource);
+
+	/**
+	 * Stops tracking a resource, waiting for its reload to finish if one is in progress.
+	 * @param resource The resource.
+	 */
+	void Untrack(Resource *resource);
+
+	/**
+	 * Reloads every resource that depends on one of the files, in the background.
+	 * Resources are swapped with their new copy in {@link Resources#Update} once loaded.
+	 * @param filenames The files that changed, as given to {@link Files} or absolute.
+	 */
+	void Reload(const std::vector<std::filesystem::path> &filenames);
+
+	/**
+	 * Gets the filenames resources may depend on for changes observed in a directory search path, both as observed and relative to the search path.
+	 * @param changes The changes, with absolute paths as observers report them.
+	 * @param root The search path the changes were observed in, absolute or relative to the working directory.
+	 * @return The filenames, erased files are skipped.
+	 */
+	static std::vector<std::filesystem::path> GetChangedFilenames(const std::vector<FileObserver::Change> &changes, const std::filesystem::path &root);
+
+	/**
+	 * Holds the old contents left in a copy by {@link Resource#Swap}, until frames in flight can no longer be using them. Called on the main thread.
+	 * @param resource The copy holding the old contents.
+	 */
+	void Retire(std::shared_ptr<Resource> resource);
+
+	bool IsHotReload() const { return hotReload; }
+
+	/**
+	 * Sets if the directory search paths are watched for changes, on by default in debug builds.
+	 * @param hotReload If resources will be reloaded when their files change.
+	 */
+	void SetHotReload(bool hotReload);
+
 	/**
 	 * Gets the resource loader thread pool.
 	 * @return The resource loader thread pool.
@@ -44,9 +89,62 @@ public:
 	ThreadPool &GetThreadPool() { return threadPool; }
 
 private:
+	/**
+	 * @brief Shared by a reload and the task loading it, so an untracked resource is not read by a task that has not started.
+	 */
+	class ReloadState {
+	public:
+		/// Held by the task while it reads from the resource.
+		std::mutex mutex;
+		bool abandoned = false;
+	};
+
+	class PendingReload {
+	public:
+		Resource *resource;
+		/// Keeps a found resource alive while it is loading.
+		std::shared_ptr<Resource> owner;
+		std::shared_ptr<ReloadState> state;
+		std::future<std::shared_ptr<Resource>> copy;
+		/// If the resource changed again after the copy started loading, so it is reloaded once more after the swap.
+		bool dirty = false;
+	};
+
+	class RetiredResource {
+	public:
+		std::shared_ptr<Resource> resource;
+		uint32_t updates;
+	};
+
+	/// Updates the old contents of a swapped resource are held for, more than the frames the GPU can have in flight.
+	static constexpr uint32_t RetireUpdates = 8;
+
+	void UpdateObservers();
+	void UpdateReloads();
+	std::vector<PendingReload>::iterator FindReload(Resource *resource);
+	void StartReload(PendingReload &reload);
+
 	std::unordered_map<std::type_index, std::map<Node, std::shared_ptr<Resource>>> resources;
 	ElapsedTime elapsedPurge;
 
+#if defined(ACID_DEBUG)
+	bool hotReload = true;
+#else
+	bool hotReload = false;
+#endif
+	/// Watchers over the directory search paths, by search path.
+	std::map<std::string, std::unique_ptr<FileObserver>> observers;
+	/// Tracked resources and pending reloads, guarded because tracked resources can be created and destroyed on loader threads.
+	std::unordered_set<Resource *> tracked;
+	std::vector<PendingReload> reloads;
+	/// Reloads of untracked resources, their copies are dropped on the main thread once loaded.
+	std::vector<std::future<std::shared_ptr<Resource>>> abandoned;
+	/// The tracked resource being swapped on the main thread, untracking it waits until the swap is done.
+	Resource *swapping = nullptr;
+	std::mutex mutex;
+	std::condition_variable swapped;
+	std::vector<RetiredResource> retired;
+
 	ThreadPool threadPool;
 };
 }
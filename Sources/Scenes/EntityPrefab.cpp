@@ -33,10 +33,16 @@ EntityPrefab::EntityPrefab(std::filesystem::path filename, bool load) :
 void EntityPrefab::Load() {
 	if (filename.empty()) return;
 
-	file = std::make_unique<File>(filename, File::Type::Json);
+	file = std::make_unique<File>(filename, File::FindType(filename));
 	file->Load();
 }
 
+void EntityPrefab::Load(std::shared_ptr<const MappedFile> mappedFile) {
+	file = std::make_unique<File>(filename, File::FindType(filename));
+	if (*mappedFile)
+		file->Load(std::move(mappedFile));
+}
+
 void EntityPrefab::Write(Node::Format format) const {
 	file->Write(filename, format);
 }
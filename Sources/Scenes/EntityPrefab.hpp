@@ -34,6 +34,12 @@ public:
 	explicit EntityPrefab(std::filesystem::path filename, bool load = true);
 
 	void Load();
+
+	/**
+	 * Loads the entity prefab from its file once it has been read.
+	 * @param mappedFile The file read by {@link Files#ReadAsync}.
+	 */
+	void Load(std::shared_ptr<const MappedFile> mappedFile);
 	void Write(Node::Format format = Node::Format::Minified) const;
 
 	std::type_index GetTypeIndex() const override { return typeid(EntityPrefab); }
@@ -14,11 +14,12 @@ public:
 	/**
 	 * Creates a new scene.
 	 * @param camera The scenes camera.
+	 * @param physicsThreading How the scenes physics world will be stepped.
 	 */
-	explicit Scene(std::unique_ptr<Camera> &&camera) :
+	explicit Scene(std::unique_ptr<Camera> &&camera, ScenePhysics::Threading physicsThreading = ScenePhysics::Threading::Single) :
 		camera(std::move(camera)),
 		structure(std::make_unique<SceneStructure>()),
-		physics(std::make_unique<ScenePhysics>()) {
+		physics(std::make_unique<ScenePhysics>(physicsThreading)) {
 	}
 
 	virtual ~Scene() = default;
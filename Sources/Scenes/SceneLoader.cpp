@@ -0,0 +1,112 @@
+#include "SceneLoader.hpp"
+
+#include <unordered_map>
+
+#include "Files/Files.hpp"
+#include "Resources/Resources.hpp"
+#include "EntityPrefab.hpp"
+
+namespace acid {
+SceneLoader::SceneLoader(SceneStructure &structure) :
+	structure(structure) {
+}
+
+std::vector<Entity *> SceneLoader::Load(const std::vector<std::filesystem::path> &filenames) {
+	auto loadStart = Time::Now();
+	timings = {};
+	timings.entityCount = static_cast<uint32_t>(filenames.size());
+
+	// Entities that share a file share a prefab.
+	std::vector<std::filesystem::path> prefabFilenames;
+	std::vector<std::size_t> prefabIndices(filenames.size());
+	std::unordered_map<std::string, std::size_t> prefabLookup;
+
+	for (std::size_t i = 0; i < filenames.size(); i++) {
+		auto filename = filenames[i].lexically_normal();
+		auto [it, inserted] = prefabLookup.try_emplace(filename.generic_string(), prefabFilenames.size());
+		if (inserted)
+			prefabFilenames.emplace_back(std::move(filename));
+		prefabIndices[i] = it->second;
+	}
+
+	// Prefabs already loaded are found in the resources, the rest are read below.
+	auto resources = Resources::Get();
+	std::vector<std::shared_ptr<EntityPrefab>> prefabs(prefabFilenames.size());
+	std::vector<Node> prefabNodes(prefabFilenames.size());
+	std::vector<std::size_t> missing;
+
+	for (std::size_t i = 0; i < prefabFilenames.size(); i++) {
+		prefabNodes[i] << EntityPrefab(prefabFilenames[i], false);
+		if (resources)
+			prefabs[i] = resources->Find<EntityPrefab>(prefabNodes[i]);
+		if (!prefabs[i])
+			missing.emplace_back(i);
+	}
+
+	// Every file is requested before any is parsed, so the reader keeps its reads in flight while parsing runs on the resource threads.
+	std::vector<std::shared_future<AsyncReader::Result>> reads;
+	reads.reserve(missing.size());
+	for (auto i : missing)
+		reads.emplace_back(Files::ReadAsync(prefabFilenames[i]));
+
+	std::vector<Time> ioTimes(missing.size());
+	std::vector<Time> parseTimes(missing.size());
+	auto readPrefabs = [&](std::size_t begin, std::size_t end) {
+		for (auto j = begin; j < end; j++) {
+			auto i = missing[j];
+			auto readStart = Time::Now();
+			auto mappedFile = reads[j].get();
+			auto parseStart = Time::Now();
+			ioTimes[j] = parseStart - readStart;
+
+			prefabs[i] = std::make_shared<EntityPrefab>(prefabFilenames[i], false);
+			prefabs[i]->Load(mappedFile);
+			parseTimes[j] = Time::Now() - parseStart;
+		}
+	};
+
+	if (resources)
+		resources->GetThreadPool().ParallelFor(0, missing.size(), 1, readPrefabs);
+	else
+		readPrefabs(0, missing.size());
+
+	for (std::size_t j = 0; j < missing.size(); j++) {
+		timings.io = timings.io + ioTimes[j];
+		timings.parse = timings.parse + parseTimes[j];
+		if (resources)
+			resources->Add(prefabNodes[missing[j]], prefabs[missing[j]]);
+	}
+	timings.prefabCount = static_cast<uint32_t>(missing.size());
+
+	// Components load their resources on the main thread, the first entity of each prefab pays for them.
+	std::vector<std::unique_ptr<Entity>> entities(filenames.size());
+	std::vector<Entity *> result(filenames.size());
+	std::vector<bool> created(prefabs.size());
+
+	for (std::size_t i = 0; i < filenames.size(); i++) {
+		auto createStart = Time::Now();
+		entities[i] = std::make_unique<Entity>();
+		*prefabs[prefabIndices[i]] >> *entities[i];
+		result[i] = entities[i].get();
+
+		if (created[prefabIndices[i]]) {
+			timings.instantiate = timings.instantiate + (Time::Now() - createStart);
+		} else {
+			created[prefabIndices[i]] = true;
+			timings.upload = timings.upload + (Time::Now() - createStart);
+		}
+	}
+
+	auto addStart = Time::Now();
+	structure.Add(std::move(entities));
+	timings.instantiate = timings.instantiate + (Time::Now() - addStart);
+	timings.total = Time::Now() - loadStart;
+
+#if defined(ACID_DEBUG)
+	Log::Out("Scene of ", timings.entityCount, " entities from ", timings.prefabCount, " prefabs loaded in ", timings.total.AsMilliseconds<float>(), "ms (io ",
+		timings.io.AsMilliseconds<float>(), "ms, parse ", timings.parse.AsMilliseconds<float>(), "ms, upload ", timings.upload.AsMilliseconds<float>(),
+		"ms, instantiate ", timings.instantiate.AsMilliseconds<float>(), "ms)\n");
+#endif
+	return result;
+}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Maths/Time.hpp"
+#include "SceneStructure.hpp"
+
+namespace acid {
+/**
+ * @brief Class that loads many entities from prefab files into a structure at once.
+ * Each prefab file is read once however many entities use it, the files are read by the {@link AsyncReader} and parsed in parallel on the resource threads.
+ * The first entity of each prefab loads the resources it uses, the rest find them already loaded.
+ */
+class ACID_EXPORT SceneLoader {
+public:
+	/**
+	 * @brief Class that holds the time spent in each phase of a load.
+	 */
+	class Timings {
+	public:
+		/// Time spent waiting on prefab files from the {@link AsyncReader}, summed over all threads.
+		Time io;
+		/// Time spent parsing prefab files, summed over all threads.
+		Time parse;
+		/// Time spent creating the first entity of each prefab, which loads and uploads its resources.
+		Time upload;
+		/// Time spent creating the remaining entities and adding them to the structure.
+		Time instantiate;
+		/// Time the whole load took.
+		Time total;
+		/// Prefab files read by the load, prefabs that were already loaded are not counted.
+		uint32_t prefabCount = 0;
+		uint32_t entityCount = 0;
+	};
+
+	/**
+	 * Creates a new scene loader.
+	 * @param structure The structure entities are added to.
+	 */
+	explicit SceneLoader(SceneStructure &structure);
+
+	/**
+	 * Creates a entity for every prefab file.
+	 * Files that are missing and components that are not registered are skipped, their entities are still created.
+	 * If a file cannot be parsed the parse error is thrown before any entity is added to the structure.
+	 * @param filenames The prefab files, a file may be listed for many entities.
+	 * @return The entities in the order of the files, so they can be given their own components such as a transform.
+	 */
+	std::vector<Entity *> Load(const std::vector<std::filesystem::path> &filenames);
+
+	/**
+	 * Gets the timings of the last load.
+	 * @return The timings.
+	 */
+	const Timings &GetTimings() const { return timings; }
+
+private:
+	SceneStructure &structure;
+	Timings timings;
+};
+}
@@ -1,34 +1,207 @@
 #include "ScenePhysics.hpp"
 
-#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include <utility>
 
 #include <BulletCollision/BroadphaseCollision/btBroadphaseInterface.h>
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
 #include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
 #include <BulletCollision/CollisionShapes/btCollisionShape.h>
+#include <BulletCollision/CollisionShapes/btConvexShape.h>
+#include <BulletCollision/NarrowPhaseCollision/btManifoldPoint.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 #include <BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h>
 #include <BulletSoftBody/btSoftRigidDynamicsWorld.h>
+#include <LinearMath/btThreads.h>
 #include "Engine/Engine.hpp"
 #include "Physics/Colliders/Collider.hpp"
 #include "Physics/CollisionObject.hpp"
+#include "Resources/Resources.hpp"
 
 namespace acid {
-ScenePhysics::ScenePhysics() :
+/**
+ * Runs Bullet's parallel loops on the resource thread pool, or on the calling thread when there is no resources module.
+ */
+class PhysicsTaskScheduler : public btITaskScheduler {
+public:
+	PhysicsTaskScheduler() :
+		btITaskScheduler("Acid") {
+	}
+
+	static PhysicsTaskScheduler *Get() {
+		static PhysicsTaskScheduler scheduler;
+		return &scheduler;
+	}
+
+	int getMaxNumThreads() const override { return BT_MAX_THREAD_COUNT; }
+
+	/**
+	 * Gets the threads that run a loop at once, the pool workers and the calling thread.
+	 * @return The thread count, clamped to the indices Bullet can hand out.
+	 */
+	int getNumThreads() const override {
+		auto threadPool = GetThreadPool();
+		auto threadCount = threadPool ? threadPool->GetWorkers().size() + 1 : 1;
+		return static_cast<int>(std::min<std::size_t>(threadCount, BT_MAX_THREAD_COUNT));
+	}
+
+	void setNumThreads(int) override {}
+
+	void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody &body) override {
+		auto threadPool = GetThreadPool();
+		if (!threadPool) {
+			CheckThreadIndex();
+			body.forLoop(iBegin, iEnd);
+			return;
+		}
+
+		threadPool->ParallelFor(iBegin, iEnd, grainSize, [&body](std::size_t begin, std::size_t end) {
+			CheckThreadIndex();
+			body.forLoop(static_cast<int>(begin), static_cast<int>(end));
+		});
+	}
+
+	btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody &body) override {
+		auto threadPool = GetThreadPool();
+		if (!threadPool) {
+			CheckThreadIndex();
+			return body.sumLoop(iBegin, iEnd);
+		}
+
+		std::mutex mutex;
+		btScalar sum = 0.0f;
+		threadPool->ParallelFor(iBegin, iEnd, grainSize, [&](std::size_t begin, std::size_t end) {
+			CheckThreadIndex();
+			auto partial = body.sumLoop(static_cast<int>(begin), static_cast<int>(end));
+			std::unique_lock<std::mutex> lock(mutex);
+			sum += partial;
+		});
+		return sum;
+	}
+
+private:
+	static ThreadPool *GetThreadPool() {
+		auto resources = Resources::Get();
+		return resources ? &resources->GetThreadPool() : nullptr;
+	}
+
+	static void CheckThreadIndex() {
+		assert(btGetCurrentThreadIndex() < static_cast<unsigned int>(BT_MAX_THREAD_COUNT) && "Too many threads have run Bullet loops");
+	}
+};
+
+/**
+ * Dispatcher with a manifold batch for every thread index.
+ * Bullet gives each thread that runs a loop the next index of a global counter and never reuses them,
+ * so indices grow past the number of threads running loops at once as pools and step threads are recreated.
+ */
+class PhysicsCollisionDispatcher : public btCollisionDispatcherMt {
+public:
+	explicit PhysicsCollisionDispatcher(btCollisionConfiguration *collisionConfiguration) :
+		btCollisionDispatcherMt(collisionConfiguration) {
+		m_batchManifoldsPtr.resize(BT_MAX_THREAD_COUNT);
+		m_batchReleasePtr.resize(BT_MAX_THREAD_COUNT);
+	}
+};
+
+/**
+ * Gets the thread async worlds are stepped on, shared so every scene adds a single thread index to Bullet's count.
+ * @return The physics thread.
+ */
+static ThreadPool &GetPhysicsThread() {
+	static ThreadPool physicsThread(1);
+	return physicsThread;
+}
+
+/**
+ * Collects every hit along a shape sweep, Bullet only provides a closest hit callback for sweeps.
+ */
+class AllConvexResultCallback : public btCollisionWorld::ConvexResultCallback {
+public:
+	btScalar addSingleResult(btCollisionWorld::LocalConvexResult &convexResult, bool normalInWorldSpace) override {
+		auto normal = normalInWorldSpace ? convexResult.m_hitNormalLocal :
+			convexResult.m_hitCollisionObject->getWorldTransform().getBasis() * convexResult.m_hitNormalLocal;
+		hits.emplace_back(PhysicsQueryHit{Collider::Convert(convexResult.m_hitPointLocal), Collider::Convert(normal), convexResult.m_hitFraction,
+			static_cast<CollisionObject *>(convexResult.m_hitCollisionObject->getUserPointer())});
+		// Keeping the closest fraction at one lets the sweep continue past this hit.
+		return m_closestHitFraction;
+	}
+
+	std::vector<PhysicsQueryHit> hits;
+};
+
+/**
+ * Collects the objects overlapping a query object, keeping the deepest contact with each.
+ */
+class OverlapResultCallback : public btCollisionWorld::ContactResultCallback {
+public:
+	explicit OverlapResultCallback(const btCollisionObject *queryObject) :
+		queryObject(queryObject) {
+	}
+
+	btScalar addSingleResult(btManifoldPoint &cp, const btCollisionObjectWrapper *colObj0Wrap, int32_t, int32_t,
+		const btCollisionObjectWrapper *colObj1Wrap, int32_t, int32_t) override {
+		auto swapped = colObj0Wrap->getCollisionObject() != queryObject;
+		auto other = swapped ? colObj0Wrap->getCollisionObject() : colObj1Wrap->getCollisionObject();
+		auto collisionObject = static_cast<CollisionObject *>(other->getUserPointer());
+		// The normal points from the other object towards the query object.
+		auto normal = swapped ? -cp.m_normalWorldOnB : cp.m_normalWorldOnB;
+		auto point = swapped ? cp.getPositionWorldOnA() : cp.getPositionWorldOnB();
+
+		auto it = std::find_if(hits.begin(), hits.end(), [collisionObject](const auto &hit) {
+			return hit.first.collisionObject == collisionObject;
+		});
+
+		if (it == hits.end())
+			hits.emplace_back(PhysicsQueryHit{Collider::Convert(point), Collider::Convert(normal), 0.0f, collisionObject}, cp.getDistance());
+		else if (cp.getDistance() < it->second)
+			*it = {PhysicsQueryHit{Collider::Convert(point), Collider::Convert(normal), 0.0f, collisionObject}, cp.getDistance()};
+		return 0.0f;
+	}
+
+	const btCollisionObject *queryObject;
+	/// Hits and their contact distance, more negative distances are deeper.
+	std::vector<std::pair<PhysicsQueryHit, btScalar>> hits;
+};
+
+ScenePhysics::ScenePhysics(Threading threading) :
+	threading(threading),
 	collisionConfiguration(std::make_unique<btSoftBodyRigidBodyCollisionConfiguration>()),
 	broadphase(std::make_unique<btDbvtBroadphase>()),
-	dispatcher(std::make_unique<btCollisionDispatcher>(collisionConfiguration.get())),
-	solver(std::make_unique<btSequentialImpulseConstraintSolver>()),
-	dynamicsWorld(std::make_unique<btSoftRigidDynamicsWorld>(dispatcher.get(), broadphase.get(), solver.get(), collisionConfiguration.get())),
+	fixedTimestep(Time::Seconds(1.0f / 60.0f)),
 	gravity(0.0f, -9.81f, 0.0f),
 	airDensity(1.2f) {
+	if (threading == Threading::Single) {
+		dispatcher = std::make_unique<btCollisionDispatcher>(collisionConfiguration.get());
+		solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+		dynamicsWorld = std::make_unique<btSoftRigidDynamicsWorld>(dispatcher.get(), broadphase.get(), solver.get(), collisionConfiguration.get());
+	} else {
+		// Must be set from the main thread before the first parallel step.
+		if (btGetTaskScheduler() != PhysicsTaskScheduler::Get())
+			btSetTaskScheduler(PhysicsTaskScheduler::Get());
+
+		dispatcher = std::make_unique<PhysicsCollisionDispatcher>(collisionConfiguration.get());
+		// Solvers are locked by whichever thread needs one, so the pool only needs one for each thread running at once.
+		auto solverPool = std::make_unique<btConstraintSolverPoolMt>(PhysicsTaskScheduler::Get()->getNumThreads());
+		dynamicsWorld = std::make_unique<btDiscreteDynamicsWorldMt>(dispatcher.get(), broadphase.get(), solverPool.get(), nullptr, collisionConfiguration.get());
+		solver = std::move(solverPool);
+	}
+
 	dynamicsWorld->setGravity(Collider::Convert(gravity));
+	dynamicsWorld->setLatencyMotionStateInterpolation(true);
 	dynamicsWorld->getDispatchInfo().m_enableSPU = true;
 	dynamicsWorld->getSolverInfo().m_minimumSolverBatchSize = 128;
 	dynamicsWorld->getSolverInfo().m_globalCfm = 0.00001f;
 
+	if (threading != Threading::Single)
+		return;
+
 	auto softDynamicsWorld = static_cast<btSoftRigidDynamicsWorld *>(dynamicsWorld.get());
 	softDynamicsWorld->getWorldInfo().water_density = 0.0f;
 	softDynamicsWorld->getWorldInfo().water_offset = 0.0f;
@@ -39,6 +212,9 @@ ScenePhysics::ScenePhysics() :
 }
 
 ScenePhysics::~ScenePhysics() {
+	if (stepResult.valid())
+		stepResult.wait();
+
 	for (int32_t i = dynamicsWorld->getNumCollisionObjects() - 1; i >= 0; i--) {
 		auto obj = dynamicsWorld->getCollisionObjectArray()[i];
 		auto body = btRigidBody::upcast(obj);
@@ -53,11 +229,47 @@ ScenePhysics::~ScenePhysics() {
 }
 
 void ScenePhysics::Update() {
-	dynamicsWorld->stepSimulation(Engine::Get()->GetDelta().AsSeconds());
-	CheckForCollisionEvents();
+	Update(Engine::Get()->GetDelta());
+}
+
+void ScenePhysics::Update(const Time &delta) {
+	if (threading != Threading::Async) {
+		Step(delta.AsSeconds());
+		CheckForCollisionEvents();
+		return;
+	}
+
+	// Events from the step run last frame are dispatched on the main thread.
+	WaitForStep();
+	if (stepFinished) {
+		stepFinished = false;
+		CheckForCollisionEvents();
+	}
+
+	stepDelta = delta.AsSeconds();
+}
+
+void ScenePhysics::PostUpdate() {
+	if (threading != Threading::Async || stepResult.valid())
+		return;
+
+	stepResult = GetPhysicsThread().Enqueue([this, delta = stepDelta]() {
+		Step(delta);
+	});
+}
+
+void ScenePhysics::WaitForStep() {
+	if (!stepResult.valid())
+		return;
+
+	stepResult.get();
+	stepFinished = true;
 }
 
 Raycast ScenePhysics::Raytest(const Vector3f &start, const Vector3f &end) const {
+	if (stepResult.valid())
+		stepResult.wait();
+
 	auto startBt = Collider::Convert(start);
 	auto endBt = Collider::Convert(end);
 	btCollisionWorld::ClosestRayResultCallback result(startBt, endBt);
@@ -67,6 +279,68 @@ Raycast ScenePhysics::Raytest(const Vector3f &start, const Vector3f &end) const
 		result.m_collisionObject ? static_cast<CollisionObject *>(result.m_collisionObject->getUserPointer()) : nullptr);
 }
 
+void ScenePhysics::Query(const std::vector<PhysicsQuery> &queries, PhysicsQueryResults &results) const {
+	if (stepResult.valid())
+		stepResult.wait();
+
+	constexpr std::size_t JobSize = 16;
+	auto jobCount = (queries.size() + JobSize - 1) / JobSize;
+
+	results.hits.clear();
+	results.ranges.resize(queries.size());
+	if (results.jobHits.size() < jobCount)
+		results.jobHits.resize(jobCount);
+
+	auto runJob = [this, &queries, &results](std::size_t begin, std::size_t end) {
+		auto &hits = results.jobHits[begin / JobSize];
+		hits.clear();
+
+		for (auto i = begin; i < end; i++) {
+			auto first = hits.size();
+			RunQuery(queries[i], hits);
+			results.ranges[i] = {static_cast<uint32_t>(first), static_cast<uint32_t>(hits.size() - first)};
+		}
+	};
+
+	// Broadphase ray stacks and the collision algorithm pool are only safe to share between threads in a thread safe Bullet build,
+	// otherwise or without the resource thread pool the jobs run on the calling thread.
+	Resources *resources = nullptr;
+#if BT_THREADSAFE
+	resources = Resources::Get();
+#endif
+	if (resources) {
+		resources->GetThreadPool().ParallelFor(0, queries.size(), JobSize, runJob);
+	} else {
+		for (std::size_t i = 0; i < queries.size(); i += JobSize)
+			runJob(i, std::min(i + JobSize, queries.size()));
+	}
+
+	// Joins the job buffers in query order, offsetting each range into the contiguous buffer.
+	for (std::size_t job = 0; job < jobCount; job++) {
+		auto offset = static_cast<uint32_t>(results.hits.size());
+		for (auto i = job * JobSize; i < std::min((job + 1) * JobSize, queries.size()); i++)
+			results.ranges[i].first += offset;
+		results.hits.insert(results.hits.end(), results.jobHits[job].begin(), results.jobHits[job].end());
+	}
+}
+
+void ScenePhysics::RemoveCollisionObject(btCollisionObject *object) {
+	if (stepResult.valid())
+		stepResult.wait();
+
+	collisionPairs.Remove(object);
+
+	// Events are only cleared, not erased, as this may be called while they are being dispatched.
+	if (auto collisionObject = static_cast<CollisionObject *>(object->getUserPointer())) {
+		for (auto &event : collisionEvents) {
+			if (event.collisionObjectA == collisionObject || event.collisionObjectB == collisionObject)
+				event.collisionObjectA = event.collisionObjectB = nullptr;
+		}
+	}
+
+	dynamicsWorld->removeCollisionObject(object);
+}
+
 void ScenePhysics::SetGravity(const Vector3f &gravity) {
 	this->gravity = gravity;
 	dynamicsWorld->setGravity(Collider::Convert(gravity));
@@ -74,66 +348,183 @@ void ScenePhysics::SetGravity(const Vector3f &gravity) {
 
 void ScenePhysics::SetAirDensity(float airDensity) {
 	this->airDensity = airDensity;
+
+	// Air density only affects soft bodies, which are only simulated by the single threaded world.
+	if (threading != Threading::Single)
+		return;
+
 	auto softDynamicsWorld = static_cast<btSoftRigidDynamicsWorld *>(dynamicsWorld.get());
 	softDynamicsWorld->getWorldInfo().air_density = airDensity;
 	softDynamicsWorld->getWorldInfo().m_sparsesdf.Initialize();
 }
 
+void ScenePhysics::Step(float delta) {
+	// Bullet accumulates the delta and takes whole fixed substeps, motion states are interpolated by the remaining time.
+	// The substeps returned are those owed before clamping, time past the max substeps is dropped.
+	auto owedSubSteps = dynamicsWorld->stepSimulation(delta, static_cast<int32_t>(maxSubSteps), fixedTimestep.AsSeconds());
+	subSteps = std::min(static_cast<uint32_t>(owedSubSteps), maxSubSteps);
+}
+
+void ScenePhysics::RunQuery(const PhysicsQuery &query, std::vector<PhysicsQueryHit> &hits) const {
+	auto start = Collider::Convert(query.start);
+	auto end = Collider::Convert(query.end);
+
+	if (query.type == PhysicsQuery::Type::Ray) {
+		if (query.allHits) {
+			btCollisionWorld::AllHitsRayResultCallback result(start, end);
+			result.m_collisionFilterGroup = query.filterGroup;
+			result.m_collisionFilterMask = query.filterMask;
+			dynamicsWorld->rayTest(start, end, result);
+
+			auto first = hits.size();
+			for (int32_t i = 0; i < result.m_collisionObjects.size(); i++) {
+				hits.emplace_back(PhysicsQueryHit{Collider::Convert(result.m_hitPointWorld[i]), Collider::Convert(result.m_hitNormalWorld[i]),
+					result.m_hitFractions[i], static_cast<CollisionObject *>(result.m_collisionObjects[i]->getUserPointer())});
+			}
+
+			std::sort(hits.begin() + first, hits.end(), [](const PhysicsQueryHit &a, const PhysicsQueryHit &b) {
+				return a.fraction < b.fraction;
+			});
+		} else {
+			btCollisionWorld::ClosestRayResultCallback result(start, end);
+			result.m_collisionFilterGroup = query.filterGroup;
+			result.m_collisionFilterMask = query.filterMask;
+			dynamicsWorld->rayTest(start, end, result);
+
+			if (result.hasHit()) {
+				hits.emplace_back(PhysicsQueryHit{Collider::Convert(result.m_hitPointWorld), Collider::Convert(result.m_hitNormalWorld),
+					result.m_closestHitFraction, static_cast<CollisionObject *>(result.m_collisionObject->getUserPointer())});
+			}
+		}
+
+		return;
+	}
+
+	auto shape = query.collider ? query.collider->GetCollisionShape() : nullptr;
+	if (!shape)
+		return;
+
+	btTransform transformStart(Collider::Convert(query.rotation), start);
+
+	if (query.type == PhysicsQuery::Type::Sweep) {
+		if (!shape->isConvex()) {
+			Log::Warning("Physics sweep queries require a convex collider\n");
+			return;
+		}
+
+		btTransform transformEnd(Collider::Convert(query.rotation), end);
+		auto convexShape = static_cast<const btConvexShape *>(shape);
+
+		if (query.allHits) {
+			AllConvexResultCallback result;
+			result.m_collisionFilterGroup = query.filterGroup;
+			result.m_collisionFilterMask = query.filterMask;
+			dynamicsWorld->convexSweepTest(convexShape, transformStart, transformEnd, result);
+
+			std::sort(result.hits.begin(), result.hits.end(), [](const PhysicsQueryHit &a, const PhysicsQueryHit &b) {
+				return a.fraction < b.fraction;
+			});
+			hits.insert(hits.end(), result.hits.begin(), result.hits.end());
+		} else {
+			btCollisionWorld::ClosestConvexResultCallback result(start, end);
+			result.m_collisionFilterGroup = query.filterGroup;
+			result.m_collisionFilterMask = query.filterMask;
+			dynamicsWorld->convexSweepTest(convexShape, transformStart, transformEnd, result);
+
+			if (result.hasHit()) {
+				hits.emplace_back(PhysicsQueryHit{Collider::Convert(result.m_hitPointWorld), Collider::Convert(result.m_hitNormalWorld),
+					result.m_closestHitFraction, static_cast<CollisionObject *>(result.m_hitCollisionObject->getUserPointer())});
+			}
+		}
+
+		return;
+	}
+
+	btCollisionObject queryObject;
+	queryObject.setCollisionShape(shape);
+	queryObject.setWorldTransform(transformStart);
+
+	OverlapResultCallback result(&queryObject);
+	result.m_collisionFilterGroup = query.filterGroup;
+	result.m_collisionFilterMask = query.filterMask;
+	dynamicsWorld->contactTest(&queryObject, result);
+
+	if (query.allHits) {
+		for (const auto &[hit, distance] : result.hits)
+			hits.emplace_back(hit);
+	} else if (!result.hits.empty()) {
+		hits.emplace_back(std::min_element(result.hits.begin(), result.hits.end(), [](const auto &a, const auto &b) {
+			return a.second < b.second;
+		})->first);
+	}
+}
+
 void ScenePhysics::CheckForCollisionEvents() {
-	// Keep a list of the collision pairs found during the current update.
-	CollisionPairs pairsThisUpdate;
+	// Every pair touched this update is stamped with the generation, pairs left with an older stamp have separated.
+	collisionGeneration++;
+	collisionEvents.clear();
 
 	// Iterate through all of the manifolds in the dispatcher.
 	for (int32_t i = 0; i < dispatcher->getNumManifolds(); ++i) {
-		// Get the manifold.
 		auto manifold = dispatcher->getManifoldByIndexInternal(i);
 
-		// Ignore manifolds that have no contact points..
+		// Ignore manifolds that have no contact points.
 		if (manifold->getNumContacts() == 0)
 			continue;
 
-		// Get the two rigid bodies involved in the collision.
+		// Always create the pair in a predictable order (use the pointer value..).
 		auto body0 = manifold->getBody0();
 		auto body1 = manifold->getBody1();
-
-		// Always create the pair in a predictable order (use the pointer value..).
 		const auto swapped = body0 > body1;
 		const auto sortedBodyA = swapped ? body1 : body0;
 		const auto sortedBodyB = swapped ? body0 : body1;
 
-		// Create the pair.
-		auto thisPair = std::make_pair(sortedBodyA, sortedBodyB);
+		// A pair with multiple manifolds only sends one event.
+		auto result = collisionPairs.Touch(sortedBodyA, sortedBodyB, collisionGeneration);
+		if (result == CollisionPairSet::Result::Repeated)
+			continue;
 
-		// Insert the pair into the current list.
-		pairsThisUpdate.insert(thisPair);
+		auto collisionObjectA = static_cast<CollisionObject *>(sortedBodyA->getUserPointer());
+		auto collisionObjectB = static_cast<CollisionObject *>(sortedBodyB->getUserPointer());
 
-		// If this pair doesn't exist in the list from the previous update, it is a new pair and we must send a collision event.
-		if (pairsLastUpdate.find(thisPair) == pairsLastUpdate.end()) {
-			// Gets the user pointer (entity).
-			auto collisionObjectA = static_cast<CollisionObject *>(sortedBodyA->getUserPointer());
-			auto collisionObjectB = static_cast<CollisionObject *>(sortedBodyB->getUserPointer());
+		// Most contacts persist every step, so persist events are only buffered when one of the objects listens for them.
+		if (result == CollisionPairSet::Result::Persisted && (!collisionObjectA || collisionObjectA->OnCollisionPersist().IsEmpty()) &&
+			(!collisionObjectB || collisionObjectB->OnCollisionPersist().IsEmpty()))
+			continue;
 
-			collisionObjectA->OnCollision()(collisionObjectB);
-		}
+		collisionEvents.emplace_back(CollisionEvent{result == CollisionPairSet::Result::Began ? CollisionEvent::Type::Begin : CollisionEvent::Type::Persist,
+			collisionObjectA, collisionObjectB});
 	}
 
-	// Creates another list for pairs that were removed this update.
-	CollisionPairs removedPairs;
-
-	// This handy function gets the difference between two sets. It takes the difference between collision pairs from the last update,
-	// and this update and pushes them into the removed pairs list.
-	std::set_difference(pairsLastUpdate.begin(), pairsLastUpdate.end(), pairsThisUpdate.begin(), pairsThisUpdate.end(), std::inserter(removedPairs, removedPairs.begin()));
+	collisionPairs.RemoveStale(collisionGeneration, [this](const btCollisionObject *a, const btCollisionObject *b) {
+		collisionEvents.emplace_back(CollisionEvent{CollisionEvent::Type::End,
+			static_cast<CollisionObject *>(a->getUserPointer()), static_cast<CollisionObject *>(b->getUserPointer())});
+	});
 
-	// Iterate through all of the removed pairs sending separation events for them.
-	for (const auto &[removedObject0, removedObject1] : removedPairs) {
-		// Gets the user pointer (entity).
-		auto collisionObjectA = static_cast<CollisionObject *>(removedObject0->getUserPointer());
-		auto collisionObjectB = static_cast<CollisionObject *>(removedObject1->getUserPointer());
+	// Events are only dispatched once the pair set is consistent, so callbacks are free to add or remove bodies.
+	// A callback that removes either body clears the event, so the other callback is skipped.
+	for (auto &event : collisionEvents) {
+		if (!event.collisionObjectA || !event.collisionObjectB)
+			continue;
 
-		collisionObjectA->OnSeparation()(collisionObjectB);
+		switch (event.type) {
+		case CollisionEvent::Type::Begin:
+			event.collisionObjectA->OnCollision()(event.collisionObjectB);
+			if (event.collisionObjectA)
+				event.collisionObjectB->OnCollision()(event.collisionObjectA);
+			break;
+		case CollisionEvent::Type::Persist:
+			if (!event.collisionObjectA->OnCollisionPersist().IsEmpty())
+				event.collisionObjectA->OnCollisionPersist()(event.collisionObjectB);
+			if (event.collisionObjectA && !event.collisionObjectB->OnCollisionPersist().IsEmpty())
+				event.collisionObjectB->OnCollisionPersist()(event.collisionObjectA);
+			break;
+		case CollisionEvent::Type::End:
+			event.collisionObjectA->OnSeparation()(event.collisionObjectB);
+			if (event.collisionObjectA)
+				event.collisionObjectB->OnSeparation()(event.collisionObjectA);
+			break;
+		}
 	}
-
-	// In the next iteration we'll want to compare against the pairs we found in this iteration.
-	pairsLastUpdate = pairsThisUpdate;
 }
 }
@@ -1,9 +1,14 @@
 #pragma once
 
-#include <set>
+#include <algorithm>
 #include <memory>
+#include <future>
+#include <vector>
 
+#include "Maths/Time.hpp"
 #include "Maths/Vector3.hpp"
+#include "Physics/CollisionPairSet.hpp"
+#include "Physics/PhysicsQuery.hpp"
 
 class btCollisionObject;
 class btCollisionConfiguration;
@@ -16,9 +21,6 @@ namespace acid {
 class Entity;
 class CollisionObject;
 
-using CollisionPair = std::pair<const btCollisionObject *, const btCollisionObject *>;
-using CollisionPairs = std::set<CollisionPair>;
-
 class ACID_EXPORT Raycast {
 public:
 	Raycast(bool hasHit, const Vector3f &pointWorld, CollisionObject *collisionObject) :
@@ -37,15 +39,86 @@ private:
 	CollisionObject *collisionObject;
 };
 
+/**
+ * @brief Class that steps the dynamics world of a scene with a fixed timestep.
+ * Frame time is accumulated and simulated in fixed substeps, motion states are interpolated between the last two substeps,
+ * so rigidbody transforms move smoothly regardless of the frame rate.
+ */
 class ACID_EXPORT ScenePhysics {
 public:
-	ScenePhysics();
+	/**
+	 * @brief How the dynamics world is stepped.
+	 */
+	enum class Threading {
+		/// Stepped on the main thread, soft bodies are supported.
+		Single,
+		/// Collision dispatch, islands and constraint solving are spread across the resource thread pool.
+		Parallel,
+		/// Parallel stepping run on a physics thread shared by every async scene, overlapping the step with the rest of the frame.
+		Async
+	};
+
+	explicit ScenePhysics(Threading threading = Threading::Single);
 	~ScenePhysics();
 
+	/**
+	 * Accumulates the frame delta and steps the world, then dispatches collision events.
+	 * In async mode this dispatches the events of the previous step, the next step is started by {@link ScenePhysics#PostUpdate}.
+	 */
 	void Update();
 
+	/**
+	 * Accumulates a delta and steps the world, then dispatches collision events.
+	 * @param delta The time passed since the last update.
+	 */
+	void Update(const Time &delta);
+
+	/**
+	 * Starts the step accumulated by {@link ScenePhysics#Update} on the physics thread, this is only used in async mode.
+	 * Bodies must not be changed until {@link ScenePhysics#WaitForStep} returns.
+	 */
+	void PostUpdate();
+
+	/**
+	 * Blocks until the step running on the physics thread has finished.
+	 */
+	void WaitForStep();
+
 	Raycast Raytest(const Vector3f &start, const Vector3f &end) const;
 
+	/**
+	 * Runs a batch of ray, sweep and overlap queries read-only against the world, spread across the resource thread pool.
+	 * @param queries The queries to run.
+	 * @param results The results to write into, hits are stored contiguously in the order of the queries.
+	 */
+	void Query(const std::vector<PhysicsQuery> &queries, PhysicsQueryResults &results) const;
+
+	/**
+	 * Removes a body from the world along with its contact pairs and the events queued for it,
+	 * so a body freed during a collision callback is never read again. Bodies must be removed with this before they are freed.
+	 * @param object The body to remove.
+	 */
+	void RemoveCollisionObject(btCollisionObject *object);
+
+	Threading GetThreading() const { return threading; }
+
+	const Time &GetFixedTimestep() const { return fixedTimestep; }
+	void SetFixedTimestep(const Time &fixedTimestep) { this->fixedTimestep = fixedTimestep; }
+
+	/**
+	 * Gets the most substeps taken in a single update, time past this is dropped so slow frames do not spiral.
+	 * @return The max number of substeps.
+	 */
+	uint32_t GetMaxSubSteps() const { return maxSubSteps; }
+	void SetMaxSubSteps(uint32_t maxSubSteps) { this->maxSubSteps = maxSubSteps; }
+
+	/**
+	 * Gets the number of fixed substeps the last step took, zero when the accumulated time was less than one timestep.
+	 * In async mode this is only valid once {@link ScenePhysics#WaitForStep} has returned.
+	 * @return The number of substeps.
+	 */
+	uint32_t GetSubSteps() const { return subSteps; }
+
 	const Vector3f &GetGravity() const { return gravity; }
 	void SetGravity(const Vector3f &gravity);
 
@@ -57,14 +130,39 @@ public:
 	btDiscreteDynamicsWorld *GetDynamicsWorld() { return dynamicsWorld.get(); }
 
 private:
+	class CollisionEvent {
+	public:
+		enum class Type {
+			Begin, Persist, End
+		};
+
+		Type type;
+		CollisionObject *collisionObjectA;
+		CollisionObject *collisionObjectB;
+	};
+
+	void Step(float delta);
+	void RunQuery(const PhysicsQuery &query, std::vector<PhysicsQueryHit> &hits) const;
 	void CheckForCollisionEvents();
 
+	Threading threading;
+
 	std::unique_ptr<btCollisionConfiguration> collisionConfiguration;
 	std::unique_ptr<btBroadphaseInterface> broadphase;
 	std::unique_ptr<btCollisionDispatcher> dispatcher;
 	std::unique_ptr<btConstraintSolver> solver;
 	std::unique_ptr<btDiscreteDynamicsWorld> dynamicsWorld;
-	CollisionPairs pairsLastUpdate;
+	CollisionPairSet collisionPairs;
+	uint32_t collisionGeneration = 0;
+	std::vector<CollisionEvent> collisionEvents;
+
+	Time fixedTimestep;
+	uint32_t maxSubSteps = 8;
+	uint32_t subSteps = 0;
+
+	std::future<void> stepResult;
+	float stepDelta = 0.0f;
+	bool stepFinished = false;
 
 	Vector3f gravity;
 	float airDensity;
@@ -31,6 +31,12 @@ void SceneStructure::Add(std::unique_ptr<Entity> object) {
 	objects.emplace_back(std::move(object));
 }
 
+void SceneStructure::Add(std::vector<std::unique_ptr<Entity>> &&objects) {
+	this->objects.reserve(this->objects.size() + objects.size());
+	std::move(objects.begin(), objects.end(), std::back_inserter(this->objects));
+	objects.clear();
+}
+
 void SceneStructure::Remove(Entity *object) {
 	objects.erase(std::remove_if(objects.begin(), objects.end(), [object](std::unique_ptr<Entity> &e) {
 		return e.get() == object;
@@ -38,6 +38,12 @@ public:
 	 */
 	void Add(std::unique_ptr<Entity> object);
 
+	/**
+	 * Adds many new objects to the spatial structure at once.
+	 * @param objects The objects to add.
+	 */
+	void Add(std::vector<std::unique_ptr<Entity>> &&objects);
+
 	/**
 	 * Removes an object from the spatial structure.
 	 * @param object The object to remove.
@@ -12,11 +12,14 @@ void Scenes::Update() {
 		scene->started = true;
 	}
 
+	// A step running on the physics thread must finish before the scene can change any bodies.
+	scene->GetPhysics()->WaitForStep();
 	scene->Update();
 	scene->GetPhysics()->Update();
 	if (scene->GetStructure())
 		scene->GetStructure()->Update();
 	if (scene->GetCamera())
 		scene->GetCamera()->Update();
+	scene->GetPhysics()->PostUpdate();
 }
 }
@@ -24,7 +24,10 @@ public:
 	}
 
 	float GetRatio() const { return ratio; }
-	void SetRatio(float ratio) { this->ratio = ratio; }
+	void SetRatio(float ratio) {
+		this->ratio = ratio;
+		this->dirty = true;
+	}
 	
 private:
 	float ratio;
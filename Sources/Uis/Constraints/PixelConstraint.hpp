@@ -32,9 +32,15 @@ public:
 	}
 
 	float GetValue() const { return value; }
-	void SetValue(float value) { this->value = value; }
+	void SetValue(float value) {
+		this->value = value;
+		this->dirty = true;
+	}
 	const UiAnchor &GetAnchor() const { return anchor; }
-	void SetAnchor(UiAnchor &anchor) { this->anchor = anchor; }
+	void SetAnchor(UiAnchor &anchor) {
+		this->anchor = anchor;
+		this->dirty = true;
+	}
 
 private:
 	int32_t value;
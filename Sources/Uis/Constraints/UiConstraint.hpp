@@ -17,6 +17,7 @@ public:
 	bool Update(const UiConstraints *object, const UiConstraints *parent) {
 		auto last = current;
 		current = Calculate(object, parent) + offset;
+		dirty = false;
 		return current != last;
 	}
 
@@ -29,13 +30,24 @@ public:
 	virtual int32_t Get() const { return current; }
 
 	int32_t GetOffset() const { return offset; }
-	void SetOffset(int32_t offset) { this->offset = offset; }
+	void SetOffset(int32_t offset) {
+		dirty |= this->offset != offset;
+		this->offset = offset;
+	}
+
+	/**
+	 * Gets if a value of this constraint has changed since it was last calculated.
+	 * @return If the constraint needs to be recalculated.
+	 */
+	bool IsDirty() const { return dirty; }
 
 protected:
 	/// The most recent value calculation.
 	int32_t current = 0;
 	/// Value offset in pixels.
 	int32_t offset = 0;
+	/// If a value has changed since the last calculation, setters in constraints set this.
+	bool dirty = true;
 };
 }
 
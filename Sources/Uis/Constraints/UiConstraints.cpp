@@ -12,11 +12,14 @@ UiConstraints::UiConstraints() {
 }
 
 bool UiConstraints::Update(const UiConstraints *parent) {
-	bool dirty = false;
-	dirty |= x->Update(this, parent);
-	dirty |= y->Update(this, parent);
-	dirty |= width->Update(this, parent);
-	dirty |= height->Update(this, parent);
-	return dirty;
+	// Sizes are calculated before the positions anchored with them, the width is calculated again as it may be a ratio of the height.
+	bool changed = false;
+	changed |= width->Update(this, parent);
+	changed |= height->Update(this, parent);
+	changed |= width->Update(this, parent);
+	changed |= x->Update(this, parent);
+	changed |= y->Update(this, parent);
+	dirty = false;
+	return changed;
 }
 }
\ No newline at end of file
@@ -12,6 +12,12 @@ public:
 
 	bool Update(const UiConstraints *parent);
 
+	/**
+	 * Gets if a constraint has been replaced or changed since the constraints were last updated.
+	 * @return If the constraints need to be updated.
+	 */
+	bool IsDirty() const { return dirty || x->IsDirty() || y->IsDirty() || width->IsDirty() || height->IsDirty(); }
+
 	UiConstraint<UiConstraintType::X> *GetX() const { return x.get(); }
 	UiConstraint<UiConstraintType::Y> *GetY() const { return y.get(); }
 	UiConstraint<UiConstraintType::Width> *GetWidth() const { return width.get(); }
@@ -21,6 +27,7 @@ public:
 		typename = std::enable_if_t<std::is_convertible_v<T<UiConstraintType::X> *, UiConstraint<UiConstraintType::X> *>>>
 		UiConstraints &SetX(Args &&... args) {
 		x = std::make_unique<T<UiConstraintType::X>>(std::forward<Args>(args)...);
+		dirty = true;
 		return *this;
 	}
 
@@ -28,6 +35,7 @@ public:
 		typename = std::enable_if_t<std::is_convertible_v<T<UiConstraintType::Y> *, UiConstraint<UiConstraintType::Y> *>>>
 		UiConstraints &SetY(Args &&... args) {
 		y = std::make_unique<T<UiConstraintType::Y>>(std::forward<Args>(args)...);
+		dirty = true;
 		return *this;
 	}
 
@@ -35,6 +43,7 @@ public:
 		typename = std::enable_if_t<std::is_convertible_v<T<UiConstraintType::Width> *, UiConstraint<UiConstraintType::Width> *>>>
 		UiConstraints &SetWidth(Args &&... args) {
 		width = std::make_unique<T<UiConstraintType::Width>>(std::forward<Args>(args)...);
+		dirty = true;
 		return *this;
 	}
 
@@ -42,11 +51,15 @@ public:
 		typename = std::enable_if_t<std::is_convertible_v<T<UiConstraintType::Height> *, UiConstraint<UiConstraintType::Height> *>>>
 		UiConstraints &SetHeight(Args &&... args) {
 		height = std::make_unique<T<UiConstraintType::Height>>(std::forward<Args>(args)...);
+		dirty = true;
 		return *this;
 	}
 
 	float GetDepth() const { return depth; }
-	void SetDepth(float depth) { this->depth = depth; }
+	void SetDepth(float depth) {
+		dirty |= this->depth != depth;
+		this->depth = depth;
+	}
 
 private:
 	std::unique_ptr<UiConstraint<UiConstraintType::X>> x;
@@ -55,5 +68,6 @@ private:
 	std::unique_ptr<UiConstraint<UiConstraintType::Height>> height;
 
 	float depth = 0.0f;
+	bool dirty = true;
 };
 }
\ No newline at end of file
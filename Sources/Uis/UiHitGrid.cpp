@@ -0,0 +1,50 @@
+#include "UiHitGrid.hpp"
+
+#include <algorithm>
+
+namespace acid {
+UiHitGrid::UiHitGrid(int32_t cellSize) :
+	cellSize(std::max(cellSize, 1)) {
+}
+
+void UiHitGrid::Clear(const Vector2i &size) {
+	this->size = {std::max(size.x, 0), std::max(size.y, 0)};
+	cellCount = {this->size.x / cellSize + 1, this->size.y / cellSize + 1};
+	rects.clear();
+	cells.resize(cellCount.x * cellCount.y);
+	for (auto &cell : cells)
+		cell.clear();
+}
+
+void UiHitGrid::Add(uint32_t index, const Vector2i &position, const Vector2i &size) {
+	if (size.x < 0 || size.y < 0)
+		return;
+
+	auto &rect = rects.emplace_back(Rect{index, position, position + size});
+
+	// Only the cells the rectangle overlaps inside of the area are filled.
+	auto minX = std::max(rect.min.x, 0), minY = std::max(rect.min.y, 0);
+	auto maxX = std::min(rect.max.x, this->size.x), maxY = std::min(rect.max.y, this->size.y);
+	if (minX > maxX || minY > maxY)
+		return;
+
+	auto rectIndex = static_cast<uint32_t>(rects.size() - 1);
+	for (auto y = minY / cellSize; y <= maxY / cellSize; y++) {
+		for (auto x = minX / cellSize; x <= maxX / cellSize; x++)
+			cells[y * cellCount.x + x].emplace_back(rectIndex);
+	}
+}
+
+void UiHitGrid::Query(const Vector2f &point, std::vector<uint32_t> &indices) const {
+	if (point.x < 0.0f || point.y < 0.0f || point.x > size.x || point.y > size.y)
+		return;
+
+	auto x = std::min(static_cast<int32_t>(point.x) / cellSize, cellCount.x - 1);
+	auto y = std::min(static_cast<int32_t>(point.y) / cellSize, cellCount.y - 1);
+	for (auto rectIndex : cells[y * cellCount.x + x]) {
+		const auto &rect = rects[rectIndex];
+		if (point.x >= rect.min.x && point.y >= rect.min.y && point.x <= rect.max.x && point.y <= rect.max.y)
+			indices.emplace_back(rect.index);
+	}
+}
+}
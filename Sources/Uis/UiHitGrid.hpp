@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include "Maths/Vector2.hpp"
+
+namespace acid {
+/**
+ * @brief Class that buckets screen rectangles into a grid of cells, so a point only has to be tested against the rectangles in the cell it falls in.
+ */
+class ACID_EXPORT UiHitGrid {
+public:
+	/**
+	 * Creates a new hit grid.
+	 * @param cellSize The width and height of a cell in pixels.
+	 */
+	explicit UiHitGrid(int32_t cellSize = 64);
+
+	/**
+	 * Removes all rectangles and resizes the grid, keeping the memory of the cells.
+	 * @param size The size of the area covered in pixels, rectangles outside of it are never hit.
+	 */
+	void Clear(const Vector2i &size);
+
+	/**
+	 * Adds a rectangle, rectangles must be added in the order they are to be returned.
+	 * @param index The index returned when the rectangle is hit.
+	 * @param position The top left corner of the rectangle.
+	 * @param size The size of the rectangle, the bottom right edges are included.
+	 */
+	void Add(uint32_t index, const Vector2i &position, const Vector2i &size);
+
+	/**
+	 * Finds the rectangles containing a point.
+	 * @param point The point in pixels.
+	 * @param indices The list the indices of the rectangles hit are written to, in the order they were added.
+	 */
+	void Query(const Vector2f &point, std::vector<uint32_t> &indices) const;
+
+	int32_t GetCellSize() const { return cellSize; }
+	std::size_t GetRectCount() const { return rects.size(); }
+
+private:
+	class Rect {
+	public:
+		uint32_t index;
+		Vector2i min, max;
+	};
+
+	int32_t cellSize;
+	Vector2i size;
+	Vector2i cellCount;
+	std::vector<Rect> rects;
+	/// Indices into the rectangles, per cell from the top left in rows.
+	std::vector<std::vector<uint32_t>> cells;
+};
+}
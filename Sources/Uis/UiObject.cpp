@@ -11,6 +11,7 @@ UiObject::UiObject() :
 	screenDepth(0.0f),
 	screenAlpha(1.0f),
 	screenScale(1.0f) {
+	Uis::IncrementGeneration();
 }
 
 UiObject::~UiObject() {
@@ -19,11 +20,12 @@ UiObject::~UiObject() {
 
 	for (auto &child : children)
 		child->parent = nullptr;
+	Uis::IncrementGeneration();
 }
 
-void UiObject::Update(const Matrix4 &viewMatrix, std::vector<UiObject *> &list, UiObject *&cursorSelect) {
+bool UiObject::Update(const Matrix4 &viewMatrix, std::vector<UiObject *> &list) {
 	if (!enabled) {
-		return;
+		return false;
 	}
 
 	// Alpha and scale updates.
@@ -31,13 +33,7 @@ void UiObject::Update(const Matrix4 &viewMatrix, std::vector<UiObject *> &list,
 	scaleDriver->Update(Engine::Get()->GetDelta());
 
 	UpdateObject();
-	
-	// Transform updates.
-	constraints.Update(parent ? &parent->constraints : nullptr);
 
-	screenPosition = {constraints.GetX()->Get(), constraints.GetY()->Get()};
-	screenSize = {constraints.GetWidth()->Get(), constraints.GetHeight()->Get()};
-	screenDepth = constraints.GetDepth();
 	screenAlpha = alphaDriver->Get();
 	screenScale = scaleDriver->Get();
 
@@ -46,39 +42,33 @@ void UiObject::Update(const Matrix4 &viewMatrix, std::vector<UiObject *> &list,
 		screenScale *= parent->screenScale;
 	}
 
-	auto modelMatrix = Matrix4::TransformationMatrix(Vector3f(screenPosition, 0.01f * screenDepth),
-		Vector3f(), Vector3f(screenSize));
-	modelView = viewMatrix * modelMatrix;
-
-	bool selected = false;
-	if (IsEnabled() && Mouse::Get()->IsWindowSelected() && Window::Get()->IsFocused()) {
-		auto distance = Mouse::Get()->GetPosition() - screenPosition;
-		selected = distance.x <= screenSize.x && distance.y <= screenSize.y &&
-			distance.x >= 0.0f && distance.y >= 0.0f;
-	}
-
-	if (this->selected != selected) {
-		this->selected = selected;
-		onSelected(selected);
-	}
-
-	if (selected) {
-		if (cursorHover)
-			cursorSelect = this;
-
-		for (auto button : EnumIterator<MouseButton>()) {
-			if (Uis::Get()->WasDown(button))
-				onClick(button);
+	// Transform updates, skipped while nothing the layout is calculated from has changed.
+	bool layoutChanged = false;
+	if (layoutDirty || constraints.IsDirty() || parent != layoutParent || (parent && parent->layoutVersion != layoutParentVersion)) {
+		layoutChanged = constraints.Update(parent ? &parent->constraints : nullptr);
+		layoutChanged |= layoutDirty || screenDepth != constraints.GetDepth();
+		layoutDirty = false;
+		layoutParent = parent;
+		layoutParentVersion = parent ? parent->layoutVersion : 0;
+
+		if (layoutChanged) {
+			screenPosition = {constraints.GetX()->Get(), constraints.GetY()->Get()};
+			screenSize = {constraints.GetWidth()->Get(), constraints.GetHeight()->Get()};
+			screenDepth = constraints.GetDepth();
+
+			auto modelMatrix = Matrix4::TransformationMatrix(Vector3f(screenPosition, 0.01f * screenDepth),
+				Vector3f(), Vector3f(screenSize));
+			modelView = viewMatrix * modelMatrix;
+			layoutVersion++;
 		}
 	}
 
-	// Adds this object to the list if it is visible.
-	if (screenAlpha > 0.0f)
-		list.emplace_back(this);
+	list.emplace_back(this);
 
 	// Update all children objects.
 	for (auto &child : children)
-		child->Update(viewMatrix, list, cursorSelect);
+		layoutChanged |= child->Update(viewMatrix, list);
+	return layoutChanged;
 }
 
 void UiObject::UpdateObject() {
@@ -88,20 +78,29 @@ void UiObject::CancelEvent(MouseButton button) const {
 	Uis::Get()->CancelWasEvent(button);
 }
 
+void UiObject::MarkLayoutDirty() {
+	layoutDirty = true;
+	for (auto &child : children)
+		child->MarkLayoutDirty();
+}
+
 void UiObject::AddChild(UiObject *child) {
 	if (child->parent || this == child)
 		throw std::runtime_error("Adding child to UI object with an existing parent!");
 	children.emplace_back(child);
 	child->parent = this;
+	Uis::IncrementGeneration();
 }
 
 void UiObject::RemoveChild(UiObject *child) {
 	children.erase(std::remove(children.begin(), children.end(), child), children.end());
 	child->parent = nullptr;
+	Uis::IncrementGeneration();
 }
 
 void UiObject::ClearChildren() {
 	children.clear();
+	Uis::IncrementGeneration();
 }
 
 void UiObject::SetParent(UiObject *parent) {
@@ -114,6 +113,14 @@ void UiObject::SetParent(UiObject *parent) {
 	this->parent = parent;
 }
 
+void UiObject::SetSelected(bool selected) {
+	if (this->selected == selected)
+		return;
+
+	this->selected = selected;
+	onSelected(selected);
+}
+
 bool UiObject::IsEnabled() const {
 	// TODO: enabled getter, update enabled on object update.
 	if (parent)
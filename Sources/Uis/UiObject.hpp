@@ -20,12 +20,13 @@ public:
 	virtual ~UiObject();
 
 	/**
-	 * Updates this screen object and the extended object.
+	 * Updates this screen object and the extended object, then the children.
+	 * The layout is only recalculated when the constraints change, or the parent layout changed or was replaced since it was last calculated.
 	 * @param viewMatrix The screens orthographic view matrix.
-	 * @param list The list to add to.
-	 * @param cursorSelect The currently selected UI that has a cursor hover.
+	 * @param list The list enabled objects are added to, in tree order.
+	 * @return If the layout of this object or a child was changed.
 	 */
-	void Update(const Matrix4 &viewMatrix, std::vector<UiObject *> &list, UiObject *&cursorSelect);
+	bool Update(const Matrix4 &viewMatrix, std::vector<UiObject *> &list);
 
 	/**
 	 * Updates the ui object.
@@ -34,6 +35,11 @@ public:
 
 	void CancelEvent(MouseButton button) const;
 
+	/**
+	 * Marks the layout of this object and its children to be recalculated on the next update, used when the view matrix changes.
+	 */
+	void MarkLayoutDirty();
+
 	const std::vector<UiObject *> &GetChildren() const { return children; }
 
 	/**
@@ -110,6 +116,10 @@ public:
 	Delegate<void(bool)> &OnSelected() { return onSelected; }
 
 private:
+	friend class Uis;
+
+	void SetSelected(bool selected);
+
 	std::vector<UiObject *> children;
 	UiObject *parent = nullptr;
 
@@ -129,6 +139,12 @@ private:
 	Vector2f screenScale;
 	bool selected = false;
 
+	bool layoutDirty = true;
+	/// Incremented each time the layout changes, children compare it against the version they were calculated from.
+	uint32_t layoutVersion = 0;
+	const UiObject *layoutParent = nullptr;
+	uint32_t layoutParentVersion = 0;
+
 	Delegate<void(MouseButton)> onClick;
 	Delegate<void(bool)> onSelected;
 };
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Uis.hpp"
+
+namespace acid {
+/**
+ * @brief Class that keeps the objects of a type from a list of objects, in the same order. The list is only searched again when it changes,
+ * or when the generation of {@link Uis} changed, so subrenders drawing the enabled objects do not cast every object each render.
+ * Comparing the pointers alone would keep a cast for a object destroyed and replaced by another at the same address.
+ * @tparam T The type of object kept.
+ */
+template<typename T>
+class UiObjectFilter {
+public:
+	/**
+	 * Gets the objects of the type in a list, searching it again if it or the generation of {@link Uis} changed since the last call.
+	 * @param objects The list of objects.
+	 * @return The objects of the type.
+	 */
+	const std::vector<T *> &Update(const std::vector<UiObject *> &objects) {
+		if (Uis::GetGeneration() != lastGeneration || objects != lastObjects) {
+			lastGeneration = Uis::GetGeneration();
+			lastObjects = objects;
+			filtered.clear();
+			for (const auto &object : objects) {
+				if (auto casted = dynamic_cast<T *>(object))
+					filtered.emplace_back(casted);
+			}
+		}
+
+		return filtered;
+	}
+
+private:
+	uint64_t lastGeneration = 0;
+	std::vector<UiObject *> lastObjects;
+	std::vector<T *> filtered;
+};
+}
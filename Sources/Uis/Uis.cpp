@@ -17,19 +17,34 @@ void Uis::Update() {
 		selector.isDown = isDown;
 	}
 
-	auto lastCursorSelect = cursorSelect;
-	cursorSelect = nullptr;
+	// The view only changes with the window size, every layout is recalculated with it.
+	if (windowSize != Window::Get()->GetSize()) {
+		windowSize = Window::Get()->GetSize();
+		viewMatrix = Matrix4::OrthographicMatrix(0.0f, windowSize.x, 0.0f, windowSize.y, -1.0f, 1.0f);
+		canvas.GetConstraints().GetWidth()->SetOffset(windowSize.x);
+		canvas.GetConstraints().GetHeight()->SetOffset(windowSize.y);
+		canvas.MarkLayoutDirty();
+	}
 
-	objects.clear();
-	auto viewMatrix = Matrix4::OrthographicMatrix(0.0f, Window::Get()->GetSize().x, 
-		0.0f, Window::Get()->GetSize().y, -1.0f, 1.0f);
-	canvas.GetConstraints().GetWidth()->SetOffset(Window::Get()->GetSize().x);
-	canvas.GetConstraints().GetHeight()->SetOffset(Window::Get()->GetSize().y);
-	canvas.Update(viewMatrix, objects, cursorSelect);
+	updatedObjects.clear();
+	auto layoutChanged = canvas.Update(viewMatrix, updatedObjects);
 
-	if (lastCursorSelect != cursorSelect) {
-		Mouse::Get()->SetCursor(cursorSelect ? *cursorSelect->GetCursorHover() : CursorStandard::Arrow);
+	// The hit grid is rebuilt only when a layout changed, or objects were added, removed, enabled or disabled.
+	if (layoutChanged || updatedObjects != enabledObjects) {
+		enabledObjects.swap(updatedObjects);
+		hitGrid.Clear(windowSize);
+		for (uint32_t i = 0; i < enabledObjects.size(); i++)
+			hitGrid.Add(i, enabledObjects[i]->GetScreenPosition(), enabledObjects[i]->GetScreenSize());
+	}
+
+	// Adds objects to the render list if they are visible.
+	objects.clear();
+	for (auto &object : enabledObjects) {
+		if (object->GetScreenAlpha() > 0.0f)
+			objects.emplace_back(object);
 	}
+
+	UpdateSelected();
 }
 
 bool Uis::IsDown(MouseButton button) {
@@ -43,4 +58,55 @@ bool Uis::WasDown(MouseButton button) {
 void Uis::CancelWasEvent(MouseButton button) {
 	selectors[button].wasDown = false;
 }
+
+void Uis::UpdateSelected() {
+	auto lastCursorSelect = cursorSelect;
+	cursorSelect = nullptr;
+
+	hovered.clear();
+	if (Mouse::Get()->IsWindowSelected() && Window::Get()->IsFocused())
+		hitGrid.Query(Mouse::Get()->GetPosition(), hovered);
+
+	// Hovered indices are in tree order, so the events are called in the same order objects are updated.
+	selectEvents.clear();
+	auto hoveredIt = hovered.begin();
+	for (uint32_t i = 0; i < enabledObjects.size(); i++) {
+		auto object = enabledObjects[i];
+		auto selected = hoveredIt != hovered.end() && *hoveredIt == i;
+		if (object->IsSelected() != selected)
+			selectEvents.push_back({object, selected, std::nullopt});
+
+		if (!selected)
+			continue;
+
+		hoveredIt++;
+		if (object->GetCursorHover())
+			cursorSelect = object;
+
+		for (auto button : EnumIterator<MouseButton>()) {
+			if (WasDown(button))
+				selectEvents.push_back({object, true, button});
+		}
+	}
+
+	if (lastCursorSelect != cursorSelect) {
+		Mouse::Get()->SetCursor(cursorSelect ? *cursorSelect->GetCursorHover() : CursorStandard::Arrow);
+	}
+
+	// Events are called once the objects have been visited, as they can create or destroy objects.
+	// Once the trees change the remaining objects may be gone, their selection is updated next frame instead.
+	auto eventGeneration = generation.load();
+	for (const auto &event : selectEvents) {
+		if (generation != eventGeneration)
+			break;
+
+		// A click cancelled by an earlier handler is not passed on.
+		if (event.button) {
+			if (WasDown(*event.button))
+				event.object->onClick(*event.button);
+		} else {
+			event.object->SetSelected(event.selected);
+		}
+	}
+}
 }
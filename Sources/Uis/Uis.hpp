@@ -1,8 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <optional>
+
 #include "Engine/Engine.hpp"
 #include "Devices/Mouse.hpp"
 #include "UiObject.hpp"
+#include "UiHitGrid.hpp"
 
 namespace acid {
 /**
@@ -30,16 +34,59 @@ public:
 	 * @return The objects.
 	 */
 	const std::vector<UiObject *> &GetObjects() const { return objects; };
+
+	/**
+	 * The enabled objects from the canvas, in tree order, including objects that are not visible.
+	 * @return The objects.
+	 */
+	const std::vector<UiObject *> &GetEnabledObjects() const { return enabledObjects; };
+
+	/**
+	 * Gets the generation of the object trees, changed when a object is created, destroyed, added to a parent or removed from one.
+	 * A object can be destroyed and another created at the same address, so lists of objects are only equal if the generation is too.
+	 * @return The generation.
+	 */
+	static uint64_t GetGeneration() { return generation; }
+
+	/**
+	 * Changes the generation of the object trees, called by objects as they are created, destroyed, added or removed.
+	 */
+	static void IncrementGeneration() { generation++; }
 private:
+	void UpdateSelected();
+
 	class SelectorMouse {
 	public:
 		bool isDown;
 		bool wasDown;
 	};
 
+	/**
+	 * @brief Class that holds a selection change or click found while updating selection, called once every object has been visited.
+	 */
+	class SelectEvent {
+	public:
+		UiObject *object;
+		bool selected;
+		/// The button clicked, or no value if the selection changed.
+		std::optional<MouseButton> button;
+	};
+
 	std::map<MouseButton, SelectorMouse> selectors;
 	UiObject canvas;
 	UiObject *cursorSelect = nullptr;
 	std::vector<UiObject *> objects;
+
+	Vector2ui windowSize;
+	Matrix4 viewMatrix;
+	/// The objects the hit grid was built from, and the objects from the latest update compared against them.
+	std::vector<UiObject *> enabledObjects;
+	std::vector<UiObject *> updatedObjects;
+	UiHitGrid hitGrid;
+	std::vector<uint32_t> hovered;
+	std::vector<SelectEvent> selectEvents;
+
+	/// Static as objects are created before the module, and in tests without it.
+	inline static std::atomic<uint64_t> generation = 0;
 };
 }
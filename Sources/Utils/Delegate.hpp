@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -42,6 +43,7 @@ public:
 			++it;
 		}
 
+		delegate.UpdateEmpty();
 		return returnValues;
 	}
 };
@@ -67,6 +69,8 @@ public:
 			it->function(params...);
 			++it;
 		}
+
+		delegate.UpdateEmpty();
 	}
 };
 
@@ -108,6 +112,7 @@ public:
 		}
 
 		functions.emplace_back(FunctionPair{std::move(function), observers});
+		UpdateEmpty();
 	}
 
 	void Remove(const FunctionType &function) {
@@ -115,6 +120,7 @@ public:
 		functions.erase(std::remove_if(functions.begin(), functions.end(), [function](FunctionPair &f) {
 			return Hash(f.function) == Hash(function);
 		}), functions.end());
+		UpdateEmpty();
 	}
 
 	template<typename ...KArgs>
@@ -147,6 +153,8 @@ public:
 			else
 				++it;
 		}
+
+		UpdateEmpty();
 	}
 
 	void MoveFunctions(Delegate &from, const ObserversType &exclude = {}) {
@@ -168,13 +176,23 @@ public:
 				++it;
 			}
 		}
+
+		UpdateEmpty();
+		from.UpdateEmpty();
 	}
 
 	void Clear() {
 		std::lock_guard<std::mutex> lock(mutex);
 		functions.clear();
+		UpdateEmpty();
 	}
 
+	/**
+	 * Gets if no functions are added, without locking. Callers on hot paths can skip invoking a delegate nobody listens to.
+	 * @return If the delegate is empty.
+	 */
+	bool IsEmpty() const { return empty.load(std::memory_order_relaxed); }
+
 	typename Invoker::ReturnType Invoke(TArgs ... args) {
 		return Invoker::Invoke(*this, args...);
 	}
@@ -194,12 +212,15 @@ public:
 private:
 	friend Invoker;
 
+	void UpdateEmpty() { empty.store(functions.empty(), std::memory_order_relaxed); }
+
 	static constexpr size_t Hash(const FunctionType &function) {
 		return function.target_type().hash_code();
 	}
 
 	std::mutex mutex;
 	std::vector<FunctionPair> functions;
+	std::atomic<bool> empty{true};
 };
 
 template<typename T>
@@ -134,6 +134,74 @@ std::string String::UnfixEscapedChars(std::string str) {
 	return str;
 }
 
+std::string String::EncodeBase64(std::string_view bytes) {
+	static constexpr std::string_view Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	std::string str;
+	str.reserve((bytes.size() + 2) / 3 * 4);
+
+	std::size_t i = 0;
+	for (; i + 3 <= bytes.size(); i += 3) {
+		auto triple = static_cast<uint8_t>(bytes[i]) << 16 | static_cast<uint8_t>(bytes[i + 1]) << 8 | static_cast<uint8_t>(bytes[i + 2]);
+		str += Alphabet[triple >> 18 & 63];
+		str += Alphabet[triple >> 12 & 63];
+		str += Alphabet[triple >> 6 & 63];
+		str += Alphabet[triple & 63];
+	}
+
+	if (auto remaining = bytes.size() - i; remaining != 0) {
+		auto triple = static_cast<uint8_t>(bytes[i]) << 16 | (remaining == 2 ? static_cast<uint8_t>(bytes[i + 1]) << 8 : 0);
+		str += Alphabet[triple >> 18 & 63];
+		str += Alphabet[triple >> 12 & 63];
+		str += remaining == 2 ? Alphabet[triple >> 6 & 63] : '=';
+		str += '=';
+	}
+
+	return str;
+}
+
+std::optional<std::string> String::DecodeBase64(std::string_view str) {
+	static constexpr auto Decode = [](char c) -> int32_t {
+		if (c >= 'A' && c <= 'Z') return c - 'A';
+		if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+		if (c >= '0' && c <= '9') return c - '0' + 52;
+		if (c == '+') return 62;
+		if (c == '/') return 63;
+		return -1;
+	};
+
+	std::string bytes;
+	bytes.reserve(str.size() / 4 * 3);
+
+	uint32_t bits = 0;
+	int32_t bitCount = 0;
+	std::size_t padding = 0;
+	for (auto c : str) {
+		if (IsWhitespace(c))
+			continue;
+		if (c == '=') {
+			padding++;
+			continue;
+		}
+
+		auto value = Decode(c);
+		// Data can not continue after padding.
+		if (value < 0 || padding != 0)
+			return std::nullopt;
+
+		bits = bits << 6 | static_cast<uint32_t>(value);
+		bitCount += 6;
+		if (bitCount >= 8) {
+			bitCount -= 8;
+			bytes += static_cast<char>(bits >> bitCount & 0xff);
+		}
+	}
+
+	if (padding > 2 || bitCount >= 6)
+		return std::nullopt;
+	return bytes;
+}
+
 std::string String::Lowercase(std::string str) {
 	std::transform(str.begin(), str.end(), str.begin(), ::tolower);
 	return str;
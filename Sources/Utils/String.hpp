@@ -1,5 +1,6 @@
 #pragma once
 
+#include <charconv>
 #include <string>
 #include <vector>
 #include <optional>
@@ -147,6 +148,20 @@ public:
 	 */
 	static std::string UnfixEscapedChars(std::string str);
 
+	/**
+	 * Encodes bytes as base64 text.
+	 * @param bytes The bytes to encode.
+	 * @return The base64 text.
+	 */
+	static std::string EncodeBase64(std::string_view bytes);
+
+	/**
+	 * Decodes base64 text into bytes, whitespace is skipped.
+	 * @param str The base64 text.
+	 * @return The bytes, or std::nullopt if the text is not valid base64.
+	 */
+	static std::optional<std::string> DecodeBase64(std::string_view str);
+
 	/**
 	 * Lower cases a string.
 	 * @param str The string.
@@ -184,6 +199,15 @@ public:
 			return To(*val);
 		} else if constexpr (std::is_same_v<char, T>) {
 			return std::string(1, val);
+		} else if constexpr (std::is_floating_point_v<T>) {
+#if defined(__cpp_lib_to_chars)
+			// The shortest text that reads back as the same value, std::to_string rounds to six decimal places.
+			char buffer[64];
+			auto result = std::to_chars(buffer, buffer + sizeof(buffer), val);
+			return std::string(buffer, result.ptr);
+#else
+			return std::to_string(val);
+#endif
 		} else {
 			return std::to_string(val);
 		}
@@ -196,9 +220,9 @@ public:
 	 * @return The string as a value.
 	 */
 	template<typename T>
-	static T From(const std::string &str) {
+	static T From(std::string_view str) {
 		if constexpr (std::is_same_v<std::string, T>) {
-			return str;
+			return std::string(str);
 		} else if constexpr (std::is_enum_v<T>) {
 			typedef typename std::underlying_type<T>::type safe_type;
 			return static_cast<T>(From<safe_type>(str));
@@ -207,14 +231,28 @@ public:
 		} else if constexpr (is_optional_v<T>) {
 			typedef typename T::value_type base_type;
 			base_type temp;
-			std::istringstream iss(str);
+			std::istringstream iss{std::string(str)};
 
 			if ((iss >> temp).fail())
 				return std::nullopt;
 			return temp;
 		} else {
+			// Plain numbers, as written by the node parsers, are read without going through a stream.
+			// Floating point from_chars is only used where the standard library implements it.
+#if defined(__cpp_lib_to_chars)
+			constexpr auto FromChars = std::is_arithmetic_v<T> && !std::is_same_v<char, T>;
+#else
+			constexpr auto FromChars = std::is_integral_v<T> && !std::is_same_v<char, T>;
+#endif
+			if constexpr (FromChars) {
+				T temp;
+				auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), temp);
+				if (ec == std::errc() && ptr == str.data() + str.size())
+					return temp;
+			}
+
 			long double temp;
-			std::istringstream iss(str);
+			std::istringstream iss{std::string(str)};
 			iss >> temp;
 			return static_cast<T>(temp);
 		}
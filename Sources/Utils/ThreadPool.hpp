@@ -6,6 +6,8 @@
 #include <mutex>
 #include <queue>
 #include <future>
+#include <atomic>
+#include <algorithm>
 
 #include "Export.hpp"
 
@@ -21,6 +23,18 @@ public:
 	template<typename F, typename... Args>
 	auto Enqueue(F &&f, Args &&... args);
 
+	/**
+	 * Runs a function over a range of indices split into chunks, spread across the pool workers and the calling thread.
+	 * The calling thread always takes part, so this is safe to call from inside a pool task.
+	 * @tparam F The function type, called as f(begin, end) for each chunk.
+	 * @param begin The first index.
+	 * @param end One past the last index.
+	 * @param grainSize The maximum number of indices given to a single call.
+	 * @param f The function to run.
+	 */
+	template<typename F>
+	void ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, F &&f);
+
 	void Wait();
 
 	const std::vector<std::thread> &GetWorkers() const { return workers; }
@@ -55,4 +69,69 @@ auto ThreadPool::Enqueue(F &&f, Args &&... args) {
 	condition.notify_one();
 	return result;
 }
+
+template<typename F>
+void ThreadPool::ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, F &&f) {
+	if (end <= begin)
+		return;
+
+	grainSize = std::max<std::size_t>(grainSize, 1);
+	auto chunkCount = (end - begin + grainSize - 1) / grainSize;
+
+	if (chunkCount == 1 || workers.empty()) {
+		for (auto i = begin; i < end; i += grainSize)
+			f(i, std::min(i + grainSize, end));
+		return;
+	}
+
+	struct State {
+		std::atomic<std::size_t> nextChunk = 0;
+		std::atomic<std::size_t> completedChunks = 0;
+		std::mutex mutex;
+		std::condition_variable finished;
+		std::exception_ptr exception;
+	};
+
+	auto state = std::make_shared<State>();
+	auto runChunks = [state, begin, end, grainSize, chunkCount, &f]() {
+		for (auto chunk = state->nextChunk++; chunk < chunkCount; chunk = state->nextChunk++) {
+			auto chunkBegin = begin + chunk * grainSize;
+
+			try {
+				f(chunkBegin, std::min(chunkBegin + grainSize, end));
+			} catch (...) {
+				std::unique_lock<std::mutex> lock(state->mutex);
+				if (!state->exception)
+					state->exception = std::current_exception();
+			}
+
+			if (++state->completedChunks == chunkCount) {
+				std::unique_lock<std::mutex> lock(state->mutex);
+				state->finished.notify_all();
+			}
+		}
+	};
+
+	// Helpers that start after every chunk has been claimed return without touching f.
+	auto helperCount = std::min<std::size_t>(workers.size(), chunkCount - 1);
+	{
+		std::unique_lock<std::mutex> lock(queueMutex);
+
+		for (std::size_t i = 0; i < helperCount; i++)
+			tasks.emplace(runChunks);
+	}
+
+	condition.notify_all();
+	runChunks();
+
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->finished.wait(lock, [&state, chunkCount]() {
+			return state->completedChunks == chunkCount;
+		});
+	}
+
+	if (state->exception)
+		std::rethrow_exception(state->exception);
+}
 }
@@ -0,0 +1,68 @@
+#include <Engine/Log.hpp>
+#include <Animations/AnimatedModel.hpp>
+
+using namespace acid;
+
+int main(int argc, char **argv) {
+	std::vector<std::filesystem::path> inputs;
+	std::filesystem::path output;
+	auto quantize = false;
+
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg(argv[i]);
+
+		if (arg == "--quantize") {
+			quantize = true;
+		} else if (arg == "-o" && i + 1 < argc) {
+			output = argv[++i];
+		} else {
+			inputs.emplace_back(arg);
+		}
+	}
+
+	if (inputs.empty()) {
+		Log::Out("Usage: AnimationCompiler [--quantize] [-o output] <file.dae | directory>...\n");
+		return EXIT_FAILURE;
+	}
+
+	// Directories are searched for every COLLADA file inside of them.
+	std::vector<std::filesystem::path> files;
+	for (const auto &input : inputs) {
+		if (std::filesystem::is_directory(input)) {
+			for (auto &file : std::filesystem::recursive_directory_iterator(input)) {
+				if (file.is_regular_file() && file.path().extension() == ".dae")
+					files.emplace_back(file.path());
+			}
+		} else {
+			files.emplace_back(input);
+		}
+	}
+
+	if (!output.empty() && files.size() != 1) {
+		Log::Error("An output filename can only be given when compiling a single file\n");
+		return EXIT_FAILURE;
+	}
+
+	auto result = EXIT_SUCCESS;
+
+	for (const auto &file : files) {
+		auto compiledFile = output.empty() ? std::filesystem::path(file).replace_extension(AnimatedModel::CompiledExtension) : output;
+		auto debugStart = Time::Now();
+
+		try {
+			if (!AnimatedModel::Compile(file, compiledFile, quantize)) {
+				Log::Error("Failed to write ", compiledFile, '\n');
+				result = EXIT_FAILURE;
+				continue;
+			}
+		} catch (const std::exception &e) {
+			Log::Error("Failed to compile ", file, ", ", e.what(), '\n');
+			result = EXIT_FAILURE;
+			continue;
+		}
+
+		Log::Out("Compiled ", file, " to ", compiledFile, " in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+	}
+
+	return result;
+}
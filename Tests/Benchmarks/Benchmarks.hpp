@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace test {
+/**
+ * Times a function, keeping the fastest of a few runs so a warm cache is compared.
+ * @tparam Function The function type.
+ * @param function The function to time.
+ * @param iterations The number of runs.
+ * @return The fastest run in milliseconds.
+ */
+template<typename Function>
+double Time(Function &&function, uint32_t iterations = 3) {
+	std::chrono::duration<double> best(std::numeric_limits<double>::max());
+	for (uint32_t i = 0; i < iterations; i++) {
+		auto start = std::chrono::steady_clock::now();
+		function();
+		best = std::min<std::chrono::duration<double>>(best, std::chrono::steady_clock::now() - start);
+	}
+	return best.count() * 1000.0;
+}
+
+void BenchmarkNodes();
+void BenchmarkBitmapOps();
+}
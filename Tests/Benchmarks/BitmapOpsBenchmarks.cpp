@@ -0,0 +1,92 @@
+#include <random>
+#include <Bitmaps/BitmapOps.hpp>
+#include <Engine/Log.hpp>
+#include <Utils/ThreadPool.hpp>
+
+#include "Benchmarks.hpp"
+
+using namespace acid;
+
+namespace test {
+static const char *GetSimdName(BitmapOps::Simd simd) {
+	switch (simd) {
+	case BitmapOps::Simd::Sse41:
+		return "SSE4.1";
+	case BitmapOps::Simd::Avx2:
+		return "AVX2";
+	case BitmapOps::Simd::Neon:
+		return "NEON";
+	default:
+		return "Scalar";
+	}
+}
+
+static std::unique_ptr<Bitmap> RandomBitmap(const Vector2ui &size, PixelFormat format) {
+	auto bitmap = std::make_unique<Bitmap>(nullptr, size, format);
+	bitmap->SetData(std::make_unique<uint8_t[]>(bitmap->GetLength()));
+	std::mt19937 random(1);
+	for (uint32_t i = 0; i < bitmap->GetLength(); i++)
+		bitmap->GetData()[i] = static_cast<uint8_t>(random());
+	return bitmap;
+}
+
+static std::unique_ptr<Bitmap> RandomFloatBitmap(const Vector2ui &size) {
+	auto bitmap = std::make_unique<Bitmap>(nullptr, size, PixelFormat::R32G32B32A32Sfloat);
+	bitmap->SetData(std::make_unique<uint8_t[]>(bitmap->GetLength()));
+	auto values = reinterpret_cast<float *>(bitmap->GetData().get());
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> distribution(-0.25f, 1.25f);
+	for (uint32_t i = 0; i < bitmap->GetLength() / 4; i++)
+		values[i] = distribution(random);
+	return bitmap;
+}
+
+void BenchmarkBitmapOps() {
+	// Each operation is run on a 2048x2048 bitmap at every level the CPU supports, on one thread then across a pool.
+	const Vector2ui size(2048, 2048);
+	auto megapixels = size.x * size.y / 1000000.0;
+	auto rgba = RandomBitmap(size, PixelFormat::R8G8B8A8Unorm);
+	auto rgb = RandomBitmap(size, PixelFormat::R8G8B8Unorm);
+	auto linear = RandomFloatBitmap(size);
+	ThreadPool threadPool;
+
+	std::vector<BitmapOps::Simd> simds = {BitmapOps::Simd::Scalar};
+	switch (BitmapOps::GetSupportedSimd()) {
+	case BitmapOps::Simd::Avx2:
+		simds.emplace_back(BitmapOps::Simd::Sse41);
+		simds.emplace_back(BitmapOps::Simd::Avx2);
+		break;
+	case BitmapOps::Simd::Sse41:
+	case BitmapOps::Simd::Neon:
+		simds.emplace_back(BitmapOps::GetSupportedSimd());
+		break;
+	default:
+		break;
+	}
+
+	auto measure = [&](const char *name, auto &&function) {
+		for (auto threads : {false, true}) {
+			std::string line = name + std::string(threads ? " threaded:" : ":");
+			for (auto simd : simds) {
+				BitmapOps::SetSimd(simd);
+				auto time = Time([&] {
+					function(threads ? &threadPool : nullptr);
+				});
+				line += ' ' + std::string(GetSimdName(simd)) + ' ' + std::to_string(megapixels / (time / 1000.0)) + "MP/s";
+			}
+			Log::Out(line, '\n');
+		}
+	};
+
+	measure("Swizzle", [&](ThreadPool *pool) { BitmapOps::Swizzle(*rgba, {2, 1, 0, 3}, pool); });
+	measure("Expand", [&](ThreadPool *pool) { BitmapOps::ExpandToRgba(*rgb, pool); });
+	measure("Premultiply", [&](ThreadPool *pool) { BitmapOps::Premultiply(*rgba, pool); });
+	measure("SrgbToLinear", [&](ThreadPool *pool) { BitmapOps::SrgbToLinear(*rgba, pool); });
+	measure("LinearToSrgb", [&](ThreadPool *pool) { BitmapOps::LinearToSrgb(*linear, pool); });
+	measure("FlipVertical", [&](ThreadPool *pool) { BitmapOps::FlipVertical(*rgba, pool); });
+	measure("Resize box", [&](ThreadPool *pool) { BitmapOps::Resize(*rgba, size / 2, BitmapOps::Filter::Box, pool); });
+	measure("Resize lanczos", [&](ThreadPool *pool) { BitmapOps::Resize(*rgba, size / 2, BitmapOps::Filter::Lanczos, pool); });
+
+	BitmapOps::SetSimd(BitmapOps::GetSupportedSimd());
+}
+}
@@ -0,0 +1,8 @@
+#include "Benchmarks.hpp"
+
+int main(int argc, char **argv) {
+	// Timings are only printed, they are compared between builds by hand rather than run as tests.
+	test::BenchmarkNodes();
+	test::BenchmarkBitmapOps();
+	return 0;
+}
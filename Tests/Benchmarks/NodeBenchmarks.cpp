@@ -0,0 +1,77 @@
+#include <Engine/Log.hpp>
+#include <Files/Binary/Binary.hpp>
+#include <Files/Json/Json.hpp>
+
+#include "Benchmarks.hpp"
+
+using namespace acid;
+
+namespace test {
+static void BenchmarkJsonParse() {
+	// Builds a scene file of a few megabytes, shaped like the entity prefabs the engine loads.
+	std::string scene = "{\"entities\": [";
+	constexpr uint32_t EntityCount = 20000;
+	for (uint32_t i = 0; i < EntityCount; i++) {
+		if (i != 0)
+			scene += ',';
+		scene += R"({"name": "Entity)" + std::to_string(i) + R"(", "components": {"Transform": {"position": {"x": )" + std::to_string(i * 0.25f) +
+			R"(, "y": 1.5, "z": -3.25e2}, "rotation": {"x": 0, "y": 0.7071, "z": 0, "w": 0.7071}, "scale": {"x": 1, "y": 1, "z": 1}},)" +
+			R"("Mesh": {"model": "Objects/Crate/Crate.obj", "material": {"baseColour": [0.8, 0.8, 0.8, 1.0], "castsShadows": true}},)" +
+			R"("Rigidbody": {"mass": 2.5, "friction": 0.5, "tags": ["static", "crate", "level1"]}}})";
+	}
+	scene += "]}";
+
+	auto parse = Time([&] {
+		Node node;
+		node.ParseString<Json>(scene);
+		if (node["entities"]->GetProperties().size() != EntityCount)
+			Log::Error("Json benchmark parsed the wrong number of entities\n");
+	}, 5);
+
+	auto megabytes = scene.size() / (1024.0 * 1024.0);
+	Log::Out("Parsed ", megabytes, "MB of Json in ", parse, "ms, ", megabytes / (parse / 1000.0), "MB/s\n");
+}
+
+static void BenchmarkBinary() {
+	// The same shape of scene as the Json benchmark, plus a mesh blob per entity.
+	Node scene;
+	constexpr uint32_t EntityCount = 20000;
+	for (uint32_t i = 0; i < EntityCount; i++) {
+		auto &entity = scene["entities"]->AddProperty();
+		entity["name"] = "Entity" + std::to_string(i);
+		auto transform = entity["components"]["Transform"];
+		transform["position"] = Node().Append(i * 0.25f, 1.5f, -325.0f);
+		transform["rotation"] = Node().Append(0.0f, 0.7071f, 0.0f, 0.7071f);
+		transform["scale"] = Node().Append(1, 1, 1);
+		entity["components"]["Mesh"]["model"] = "Objects/Crate/Crate.obj";
+		entity["components"]["Mesh"]["vertices"]->SetBlob(std::vector<float>(96, i * 0.5f));
+		entity["components"]["Rigidbody"]["mass"] = 2.5f;
+		entity["components"]["Rigidbody"]["tags"] = std::vector<std::string>{"static", "crate", "level1"};
+	}
+
+	std::string json, binary;
+	auto jsonSave = Time([&] { json = scene.WriteString<Json>(); });
+	auto binarySave = Time([&] { binary = scene.WriteString<Binary>(); });
+	auto jsonLoad = Time([&] {
+		Node node;
+		node.ParseString<Json>(json);
+	});
+	auto binaryLoad = Time([&] {
+		Node node;
+		node.ParseString<Binary>(binary);
+	});
+
+	Node parsed;
+	parsed.ParseString<Binary>(binary);
+	if (parsed != scene)
+		Log::Error("Binary benchmark scene did not round trip\n");
+
+	Log::Out("Json ", json.size() / (1024.0 * 1024.0), "MB, saved in ", jsonSave, "ms, loaded in ", jsonLoad, "ms\n");
+	Log::Out("Binary ", binary.size() / (1024.0 * 1024.0), "MB, saved in ", binarySave, "ms, loaded in ", binaryLoad, "ms\n");
+}
+
+void BenchmarkNodes() {
+	BenchmarkJsonParse();
+	BenchmarkBinary();
+}
+}
@@ -1,45 +1,46 @@
 #include <Engine/Log.hpp>
-#include <Files/Zip/ZipArchive.hpp>
+#include <Files/Zip/ZipPack.hpp>
+#include <Utils/ThreadPool.hpp>
 #include "Config.hpp"
 
 std::filesystem::path PATH = acid::ACID_RESOURCES_DEV;
 
-std::unique_ptr<acid::ZipArchive> NewArchive(int index) {
+void WritePack(int index, const std::vector<acid::ZipPack::Source> &sources, acid::ThreadPool &threadPool) {
 	auto zipFilepath = std::filesystem::current_path() / ("data-" + std::to_string(index) + ".zip");
-	acid::Log::Out("New zip archive: ", zipFilepath, '\n');
+	acid::Log::Out("New zip pack: ", zipFilepath, " with ", sources.size(), " files\n");
 
 	if (std::filesystem::exists(zipFilepath))
 		std::filesystem::remove(zipFilepath);
 
-	return std::make_unique<acid::ZipArchive>(zipFilepath);
+	acid::ZipPack::Write(zipFilepath, sources, MZ_DEFAULT_LEVEL, &threadPool);
 }
 
 int main(int argc, char **argv) {
 	auto maxFraction = 16 * 1000000;
 
-	auto archive = NewArchive(0);
-	int index = 1;
-	int currentSizeBytes = 0;
-	
+	// Files are mapped and compressed in parallel when each pack is written, only the file list is gathered here.
+	acid::ThreadPool threadPool;
+	std::vector<acid::ZipPack::Source> sources;
+	int index = 0;
+	std::uintmax_t currentSizeBytes = 0;
+
 	for (auto &file : std::filesystem::recursive_directory_iterator(PATH)) {
 		if (!file.is_regular_file()) continue;
 
 		if (currentSizeBytes > maxFraction) {
-			archive->Write();
-			archive = NewArchive(index++);
+			WritePack(index++, sources, threadPool);
+			sources.clear();
 			currentSizeBytes = 0;
 		}
-		
+
 		acid::Log::Out(file.path(), '\n');
-		
-		std::ifstream t(file.path(), std::ios::in | std::ios::binary);
-		std::string str((std::istreambuf_iterator<char>(t)),
-			std::istreambuf_iterator<char>());
-		archive->AddEntry(file.path().string().substr(PATH.string().length() + 1), str);
+
+		auto name = file.path().lexically_relative(PATH).generic_string();
+		sources.push_back({name, file.path()});
 		currentSizeBytes += file.file_size();
 	}
-	
-	archive->Write();
+
+	WritePack(index, sources, threadPool);
 
 	// Pauses the console.
 	std::cout << "Press enter to continue...";
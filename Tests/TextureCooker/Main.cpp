@@ -0,0 +1,83 @@
+#include <Engine/Log.hpp>
+#include <Bitmaps/TextureCooker.hpp>
+#include <Utils/String.hpp>
+#include <Utils/ThreadPool.hpp>
+
+using namespace acid;
+
+int main(int argc, char **argv) {
+	std::vector<std::filesystem::path> inputs;
+	std::filesystem::path output;
+	std::optional<TextureCooker::Content> content;
+
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg(argv[i]);
+
+		if (arg == "--colour") {
+			content = TextureCooker::Content::Colour;
+		} else if (arg == "--linear") {
+			content = TextureCooker::Content::Linear;
+		} else if (arg == "--normal") {
+			content = TextureCooker::Content::Normal;
+		} else if (arg == "-o" && i + 1 < argc) {
+			output = argv[++i];
+		} else {
+			inputs.emplace_back(arg);
+		}
+	}
+
+	if (inputs.empty()) {
+		Log::Out("Usage: TextureCooker [--colour | --linear | --normal] [-o output] <image | directory>...\n");
+		return EXIT_FAILURE;
+	}
+
+	// Directories are searched for every PNG and JPG inside of them.
+	std::vector<std::filesystem::path> files;
+	for (const auto &input : inputs) {
+		if (std::filesystem::is_directory(input)) {
+			for (auto &file : std::filesystem::recursive_directory_iterator(input)) {
+				auto extension = String::Lowercase(file.path().extension().string());
+				if (file.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg"))
+					files.emplace_back(file.path());
+			}
+		} else {
+			files.emplace_back(input);
+		}
+	}
+
+	if (!output.empty() && files.size() != 1) {
+		Log::Error("An output filename can only be given when cooking a single file\n");
+		return EXIT_FAILURE;
+	}
+
+	// Each texture is cooked on its own thread, the slowest part is filtering the mip levels.
+	ThreadPool threadPool;
+	std::vector<std::future<bool>> results;
+
+	for (const auto &file : files) {
+		auto cookedFile = output.empty() ? std::filesystem::path(file).replace_extension(".ktx2") : output;
+		// Without a content given, textures named as normal maps are filtered as vectors.
+		auto fileContent = content.value_or(String::Lowercase(file.stem().string()).find("normal") != std::string::npos ?
+			TextureCooker::Content::Normal : TextureCooker::Content::Colour);
+
+		results.emplace_back(threadPool.Enqueue([file, cookedFile, fileContent] {
+			auto debugStart = Time::Now();
+
+			if (!TextureCooker::Cook(file, cookedFile, fileContent)) {
+				Log::Error("Failed to cook ", file, '\n');
+				return false;
+			}
+
+			Log::Out("Cooked ", file, " to ", cookedFile, " in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+			return true;
+		}));
+	}
+
+	auto result = EXIT_SUCCESS;
+	for (auto &cooked : results) {
+		if (!cooked.get())
+			result = EXIT_FAILURE;
+	}
+
+	return result;
+}
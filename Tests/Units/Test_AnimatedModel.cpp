@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <Animations/AnimatedModel.hpp>
+
+namespace {
+acid::AnimatedModel::CompiledData CreateData() {
+	acid::AnimatedModel::CompiledData data;
+	data.vertices = {
+		{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0, 0, 0}, {1.0f, 0.0f, 0.0f}},
+		{{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0, 1, 0}, {0.5f, 0.5f, 0.0f}},
+		{{0.0f, 2.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1, 0, 0}, {1.0f, 0.0f, 0.0f}}
+	};
+	data.indices = {0, 1, 2};
+
+	acid::Joint root(0, "root", acid::Matrix4());
+	root.AddChild(acid::Joint(1, "arm", acid::Matrix4().Translate(acid::Vector3f(0.0f, 2.0f, 0.0f))));
+	data.headJoint = root;
+
+	data.length = acid::Time::Seconds(1.0f);
+	for (auto time : {0.0f, 1.0f}) {
+		std::map<std::string, acid::JointTransform> pose;
+		pose.emplace("root", acid::JointTransform({time, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}));
+		pose.emplace("arm", acid::JointTransform({0.0f, 2.0f, -time}, acid::Quaternion(0.0f, 0.6f, 0.0f, 0.8f)));
+		data.keyframes.emplace_back(acid::Time::Seconds(time), std::move(pose));
+	}
+
+	return data;
+}
+
+std::string Write(const acid::AnimatedModel::CompiledData &data, bool quantize) {
+	std::ostringstream stream(std::ios::out | std::ios::binary);
+	acid::AnimatedModel::WriteCompiled(data, stream, quantize);
+	return stream.str();
+}
+
+acid::AnimatedModel::CompiledData Read(const std::string &bytes) {
+	return acid::AnimatedModel::ReadCompiled(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+}
+}
+
+TEST(AnimatedModel, compiledRoundTrip) {
+	auto written = CreateData();
+	auto read = Read(Write(written, false));
+
+	EXPECT_EQ(read.vertices, written.vertices);
+	EXPECT_EQ(read.indices, written.indices);
+	EXPECT_EQ(read.length, written.length);
+
+	EXPECT_EQ(read.headJoint.GetName(), "root");
+	ASSERT_EQ(read.headJoint.GetChildren().size(), 1);
+	const auto &arm = read.headJoint.GetChildren()[0];
+	EXPECT_EQ(arm.GetIndex(), 1);
+	EXPECT_EQ(arm.GetName(), "arm");
+	EXPECT_EQ(arm.GetLocalBindTransform(), written.headJoint.GetChildren()[0].GetLocalBindTransform());
+
+	ASSERT_EQ(read.keyframes.size(), 2);
+	for (std::size_t i = 0; i < read.keyframes.size(); i++) {
+		EXPECT_EQ(read.keyframes[i].GetTimeStamp(), written.keyframes[i].GetTimeStamp());
+		ASSERT_EQ(read.keyframes[i].GetPose().size(), 2);
+		for (const auto &[name, transform] : written.keyframes[i].GetPose()) {
+			EXPECT_EQ(read.keyframes[i].GetPose().at(name).GetPosition(), transform.GetPosition()) << name;
+			EXPECT_EQ(read.keyframes[i].GetPose().at(name).GetRotation(), transform.GetRotation()) << name;
+		}
+	}
+}
+
+TEST(AnimatedModel, compiledQuantized) {
+	auto written = CreateData();
+	auto bytes = Write(written, true);
+	EXPECT_LT(bytes.size(), Write(written, false).size());
+
+	auto read = Read(bytes);
+	EXPECT_EQ(read.vertices, written.vertices);
+	ASSERT_EQ(read.keyframes.size(), 2);
+	for (std::size_t i = 0; i < read.keyframes.size(); i++) {
+		for (const auto &[name, transform] : written.keyframes[i].GetPose()) {
+			const auto &pose = read.keyframes[i].GetPose().at(name);
+			for (uint32_t j = 0; j < 3; j++)
+				EXPECT_NEAR(pose.GetPosition()[j], transform.GetPosition()[j], 1e-4f) << name;
+			EXPECT_NEAR(pose.GetRotation().y, transform.GetRotation().y, 1e-4f) << name;
+			EXPECT_NEAR(pose.GetRotation().w, transform.GetRotation().w, 1e-4f) << name;
+		}
+	}
+}
+
+TEST(AnimatedModel, compiledRejected) {
+	auto bytes = Write(CreateData(), false);
+
+	// Every truncation is caught before reading past the end.
+	for (std::size_t size = 0; size < bytes.size(); size++)
+		EXPECT_THROW(Read(bytes.substr(0, size)), std::runtime_error) << size;
+
+	auto corrupted = bytes;
+	corrupted[0] = 'X';
+	EXPECT_THROW(Read(corrupted), std::runtime_error);
+
+	// The name of the first joint follows the header, its index and its parent.
+	corrupted = bytes;
+	const std::size_t nameSizeOffset = 60 + 8;
+	corrupted.replace(nameSizeOffset, 4, "\xff\xff\xff\x7f");
+	EXPECT_THROW(Read(corrupted), std::runtime_error);
+
+	auto outOfRange = CreateData();
+	outOfRange.indices.emplace_back(3);
+	EXPECT_THROW(Read(Write(outOfRange, false)), std::runtime_error);
+
+	auto badJoint = CreateData();
+	badJoint.vertices[0].jointId.x = 1000;
+	EXPECT_THROW(Read(Write(badJoint, false)), std::runtime_error);
+}
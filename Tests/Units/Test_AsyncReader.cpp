@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <Files/AsyncReader.hpp>
+
+TEST(AsyncReader, readFiles) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidAsyncReader";
+	std::filesystem::create_directories(directory);
+
+	// Small files are read into a buffer, files past the threshold are mapped.
+	std::vector<std::string> contents;
+	for (uint32_t i = 0; i < 16; i++) {
+		contents.emplace_back(i % 2 == 0 ? 100 + i : acid::MappedFile::MapThreshold * 4 + i, static_cast<char>('a' + i));
+		std::ofstream(directory / std::to_string(i), std::ios::binary) << contents.back();
+	}
+
+	acid::AsyncReader reader(2);
+	std::vector<std::shared_future<acid::AsyncReader::Result>> futures;
+	for (uint32_t i = 0; i < 16; i++)
+		futures.emplace_back(reader.Read(directory / std::to_string(i), i < 8 ? acid::AsyncReader::Priority::Streaming : acid::AsyncReader::Priority::Startup));
+	// Requests for a file already pending share its read.
+	auto repeated = reader.Read(directory / "15");
+	auto missing = reader.Read(directory / "missing");
+
+	for (uint32_t i = 0; i < 16; i++) {
+		auto file = futures[i].get();
+		ASSERT_TRUE(*file) << i;
+		EXPECT_EQ(file->IsMapped(), i % 2 == 1) << i;
+		EXPECT_EQ(std::string_view(reinterpret_cast<const char *>(file->GetData()), file->GetSize()), contents[i]) << i;
+	}
+	EXPECT_FALSE(*missing.get());
+
+	reader.Wait();
+	EXPECT_EQ(reader.GetPendingCount(), 0u);
+	auto stats = reader.GetStats();
+	EXPECT_EQ(stats.requestCount, 18u);
+	EXPECT_EQ(stats.failedCount, 1u);
+	EXPECT_EQ(stats.completedCount + stats.coalescedCount, 17u);
+	EXPECT_EQ(repeated.get()->GetSize(), contents[15].size());
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST(AsyncReader, failedRead) {
+	acid::AsyncReader reader(1);
+
+	// A name longer than file systems allow makes the lookup throw, rather than finding no file.
+	auto failed = reader.Read(std::filesystem::temp_directory_path() / std::string(300, 'a'));
+	ASSERT_EQ(failed.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+	EXPECT_FALSE(*failed.get());
+
+	reader.Wait();
+	EXPECT_EQ(reader.GetStats().failedCount, 1u);
+	EXPECT_EQ(reader.GetPendingCount(), 0u);
+}
+
+TEST(AsyncReader, priorityOrder) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidAsyncReaderPriority";
+	std::filesystem::create_directories(directory);
+	for (uint32_t i = 0; i < 4; i++)
+		std::ofstream(directory / std::to_string(i), std::ios::binary) << i;
+
+	// Requests are queued while paused, then one thread reads startup requests first and each priority in request order.
+	acid::AsyncReader reader(1);
+	reader.Pause();
+	auto streaming0 = reader.Read(directory / "0", acid::AsyncReader::Priority::Streaming);
+	auto streaming1 = reader.Read(directory / "1", acid::AsyncReader::Priority::Streaming);
+	auto startup0 = reader.Read(directory / "2", acid::AsyncReader::Priority::Startup);
+	auto startup1 = reader.Read(directory / "3", acid::AsyncReader::Priority::Startup);
+	EXPECT_EQ(startup0.wait_for(std::chrono::milliseconds(10)), std::future_status::timeout);
+	reader.Resume();
+
+	// A future is set once its read is done, so reads made before the last are ready by the time it is.
+	ASSERT_TRUE(*streaming1.get());
+	for (auto &future : {streaming0, startup0, startup1})
+		EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+	ASSERT_TRUE(*startup0.get());
+
+	reader.Wait();
+	std::filesystem::remove_all(directory);
+}
+
+TEST(AsyncReader, raisedPriority) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidAsyncReaderRaised";
+	std::filesystem::create_directories(directory);
+	for (uint32_t i = 0; i < 3; i++)
+		std::ofstream(directory / std::to_string(i), std::ios::binary) << i;
+
+	// A streaming request requested again at startup priority is read before the startup requests queued after it.
+	acid::AsyncReader reader(1);
+	reader.Pause();
+	auto streaming = reader.Read(directory / "0", acid::AsyncReader::Priority::Streaming);
+	auto startup0 = reader.Read(directory / "1", acid::AsyncReader::Priority::Startup);
+	auto raised = reader.Read(directory / "0", acid::AsyncReader::Priority::Startup);
+	auto startup1 = reader.Read(directory / "2", acid::AsyncReader::Priority::Startup);
+	reader.Resume();
+
+	ASSERT_TRUE(*startup1.get());
+	for (auto &future : {streaming, startup0, raised})
+		EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+	EXPECT_EQ(streaming.get(), raised.get());
+	EXPECT_EQ(reader.GetStats().coalescedCount, 1u);
+
+	reader.Wait();
+	std::filesystem::remove_all(directory);
+}
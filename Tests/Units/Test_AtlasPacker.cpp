@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <Graphics/Images/AtlasPacker.hpp>
+
+namespace {
+struct Placed {
+	acid::Vector2ui position;
+	acid::Vector2ui size;
+};
+
+bool Overlaps(const Placed &a, const Placed &b) {
+	return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x &&
+		a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+}
+
+void ExpectDisjoint(const std::vector<Placed> &placed, const acid::Vector2ui &size) {
+	for (std::size_t i = 0; i < placed.size(); i++) {
+		EXPECT_LE(placed[i].position.x + placed[i].size.x, size.x);
+		EXPECT_LE(placed[i].position.y + placed[i].size.y, size.y);
+		for (std::size_t j = i + 1; j < placed.size(); j++)
+			ASSERT_FALSE(Overlaps(placed[i], placed[j])) << i << " overlaps " << j;
+	}
+}
+}
+
+TEST(AtlasPacker, insert) {
+	acid::AtlasPacker packer({64, 64});
+
+	// Sixteen squares tile the area exactly.
+	for (uint32_t i = 0; i < 16; i++)
+		ASSERT_TRUE(packer.Insert({16, 16}));
+	EXPECT_FLOAT_EQ(packer.GetOccupancy(), 1.0f);
+	EXPECT_FALSE(packer.Insert({1, 1}));
+
+	packer.Clear();
+	EXPECT_FALSE(packer.Insert({65, 1}));
+	EXPECT_FALSE(packer.Insert({0, 4}));
+	EXPECT_EQ(packer.Insert({64, 64}), acid::Vector2ui(0, 0));
+}
+
+TEST(AtlasPacker, removeAndReuse) {
+	const acid::Vector2ui size(512, 512);
+	acid::AtlasPacker packer(size);
+	std::mt19937 random(7);
+	std::uniform_int_distribution<uint32_t> distribution(4, 48);
+
+	std::vector<Placed> placed;
+	for (uint32_t i = 0; i < 400; i++) {
+		acid::Vector2ui rect(distribution(random), distribution(random));
+		if (auto position = packer.Insert(rect))
+			placed.push_back({*position, rect});
+	}
+	ExpectDisjoint(placed, size);
+	EXPECT_GT(packer.GetOccupancy(), 0.8f);
+
+	// Every other rectangle is freed, the same rectangles fit again in the space left.
+	std::vector<Placed> removed;
+	for (std::size_t i = 0; i < placed.size(); i++) {
+		if (i % 2 == 0) {
+			packer.Remove(placed[i].position, placed[i].size);
+			removed.push_back(placed[i]);
+		}
+	}
+	placed.erase(std::remove_if(placed.begin(), placed.end(), [&](const Placed &rect) {
+		return std::any_of(removed.begin(), removed.end(), [&](const Placed &other) { return other.position == rect.position; });
+	}), placed.end());
+
+	uint32_t reinserted = 0;
+	for (const auto &rect : removed) {
+		if (auto position = packer.Insert(rect.size)) {
+			placed.push_back({*position, rect.size});
+			reinserted++;
+		}
+	}
+	ExpectDisjoint(placed, size);
+	EXPECT_GT(reinserted, removed.size() * 9 / 10);
+
+	// Once everything is removed the whole area is free again.
+	for (const auto &rect : placed)
+		packer.Remove(rect.position, rect.size);
+	EXPECT_EQ(packer.GetUsedArea(), 0u);
+	EXPECT_EQ(packer.GetFreeRectCount(), 1u);
+	EXPECT_TRUE(packer.Insert(size));
+}
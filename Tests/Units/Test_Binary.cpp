@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <Files/Binary/Binary.hpp>
+#include <Files/Json/Json.hpp>
+
+TEST(Binary, roundTrip) {
+	acid::Node node;
+	node.ParseString<acid::Json>(R"({"name": "Player", "health": 100, "offset": -7, "speed": 0.7071, "precise": 0.1, "big": 18446744073709551615,
+		"huge": 99999999999999999999, "alive": true, "target": null, "tags": ["a", "b"], "text": "line\nbreak", "empty": {}})");
+
+	std::vector<float> vertices = {0.0f, 1.5f, -2.25f, 3.0e8f};
+	node["vertices"]->SetBlob(vertices);
+
+	auto binary = node.WriteString<acid::Binary>();
+	acid::Node parsed;
+	parsed.ParseString<acid::Binary>(binary);
+	// Decimals are written back in their shortest form, the rest of the tree is identical.
+	EXPECT_EQ(parsed["huge"].Get<std::string>(), "1e+20");
+	parsed["huge"] = node["huge"].Get<std::string>();
+	parsed["huge"]->SetType(acid::Node::Type::Decimal);
+	EXPECT_EQ(node, parsed);
+	EXPECT_EQ(parsed["health"]->GetType(), acid::Node::Type::Integer);
+	EXPECT_EQ(parsed["offset"].Get<int32_t>(), -7);
+	EXPECT_EQ(parsed["speed"]->GetType(), acid::Node::Type::Decimal);
+	EXPECT_DOUBLE_EQ(parsed["precise"].Get<double>(), 0.1);
+	EXPECT_EQ(parsed["big"].Get<uint64_t>(), 18446744073709551615ull);
+	EXPECT_EQ(parsed["target"]->GetType(), acid::Node::Type::Null);
+	EXPECT_EQ(parsed["empty"]->GetType(), acid::Node::Type::Object);
+
+	std::vector<float> parsedVertices;
+	ASSERT_TRUE(parsed["vertices"]->GetBlob(parsedVertices));
+	EXPECT_EQ(parsedVertices, vertices);
+
+	// Text formats store blobs as base64 strings, which still read back as blobs.
+	acid::Node json;
+	json.ParseString<acid::Json>(parsed.WriteString<acid::Json>());
+	parsedVertices.clear();
+	ASSERT_TRUE(json["vertices"]->GetBlob(parsedVertices));
+	EXPECT_EQ(parsedVertices, vertices);
+
+	for (auto length : {std::size_t(0), std::size_t(3), binary.size() / 2, binary.size() - 1}) {
+		acid::Node failed;
+		EXPECT_THROW(failed.ParseString<acid::Binary>(binary.substr(0, length)), std::runtime_error) << length;
+	}
+}
+
+TEST(Binary, depthLimit) {
+	auto nested = [](uint32_t depth) {
+		acid::Node node;
+		auto current = &node;
+		for (uint32_t i = 0; i < depth; i++)
+			current = &current->AddProperty("child");
+		return node.WriteString<acid::Binary>();
+	};
+
+	acid::Node parsed;
+	parsed.ParseString<acid::Binary>(nested(acid::Node::MaxDepth));
+
+	// Each property list is a level, one more than the limit is rejected.
+	acid::Node failed;
+	EXPECT_THROW(failed.ParseString<acid::Binary>(nested(acid::Node::MaxDepth + 1)), std::runtime_error);
+}
+
+TEST(Binary, lazyView) {
+	acid::Node node;
+	for (uint32_t i = 0; i < 100; i++) {
+		auto &entity = node["entities"]->AddProperty();
+		entity["name"] = "Entity" + std::to_string(i);
+		entity["mass"] = i * 0.5f;
+		entity["mesh"]->SetBlob(std::vector<uint32_t>(i, i));
+	}
+
+	auto binary = node.WriteString<acid::Binary>();
+	acid::BinaryView root(binary);
+	EXPECT_EQ(root.GetType(), acid::Node::Type::Object);
+	EXPECT_EQ(root["entities"].GetPropertyCount(), 100u);
+	EXPECT_FALSE(root["missing"]);
+	EXPECT_FALSE(root["entities"][100]);
+
+	auto entity = root["entities"][42];
+	EXPECT_EQ(entity["mesh"].GetBlob().size(), 42 * sizeof(uint32_t));
+
+	acid::Node loaded;
+	entity.Load(loaded);
+	EXPECT_EQ(loaded, *node["entities"][42]);
+	EXPECT_EQ(loaded["name"].Get<std::string>(), "Entity42");
+}
+
@@ -0,0 +1,483 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <miniz/miniz.h>
+#include <Bitmaps/BlockDecoder.hpp>
+#include <Bitmaps/Dds/DdsBitmap.hpp>
+#include <Bitmaps/Dng/DngBitmap.hpp>
+#include <Bitmaps/Exr/ExrBitmap.hpp>
+#include <Bitmaps/Ktx/KtxBitmap.hpp>
+#include <Bitmaps/Qoi/QoiBitmap.hpp>
+#include <Bitmaps/TextureCooker.hpp>
+
+namespace {
+template<typename T>
+void Append(std::string &data, T value) {
+	data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+std::vector<uint8_t> Pixel(const uint8_t *pixels, uint32_t x, uint32_t y) {
+	return {pixels + (y * 4 + x) * 4, pixels + (y * 4 + x) * 4 + 4};
+}
+
+std::vector<uint8_t> Rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+	return {r, g, b, a};
+}
+}
+
+TEST(Bitmap, levels) {
+	static_assert(acid::PixelBlock::Get(acid::PixelFormat::Bc7Unorm).bytes == 16);
+	static_assert(acid::PixelBlock::Get(acid::PixelFormat::Astc6x6Srgb).width == 6);
+	static_assert(acid::PixelBlock::IsSrgb(acid::PixelFormat::Astc6x6Srgb));
+	static_assert(!acid::PixelBlock::IsCompressed(acid::PixelFormat::R8G8B8A8Unorm));
+
+	// Partial blocks on the edges take a whole block, the smallest levels are one block.
+	acid::Bitmap bitmap(nullptr, {10, 6}, acid::PixelFormat::Bc1RgbaUnorm, 4, 2);
+	EXPECT_EQ(bitmap.GetLevelLength(0), 3u * 2 * 8 * 2);
+	EXPECT_EQ(bitmap.GetLevelSize(1), acid::Vector2ui(5, 3));
+	EXPECT_EQ(bitmap.GetLevelOffset(2), bitmap.GetLevelLength(0) + 2u * 1 * 8 * 2);
+	EXPECT_EQ(bitmap.GetLevelLength(3), 8u * 2);
+	EXPECT_EQ(bitmap.GetLength(), bitmap.GetLevelOffset(4));
+
+	acid::Bitmap pixels({3, 2}, 4);
+	EXPECT_EQ(pixels.GetFormat(), acid::PixelFormat::R8G8B8A8Unorm);
+	EXPECT_EQ(pixels.GetLength(), 24u);
+}
+
+TEST(Bitmap, decodeBc) {
+	uint8_t pixels[64];
+
+	// Red and blue endpoints in order use four colours.
+	const uint8_t bc1[8] = {0x00, 0xF8, 0x1F, 0x00, 0b11100100, 0, 0, 0};
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Bc1RgbaUnorm, bc1, pixels);
+	EXPECT_EQ(Pixel(pixels, 0, 0), Rgba(255, 0, 0, 255));
+	EXPECT_EQ(Pixel(pixels, 1, 0), Rgba(0, 0, 255, 255));
+	EXPECT_EQ(Pixel(pixels, 2, 0), Rgba(170, 0, 85, 255));
+	EXPECT_EQ(Pixel(pixels, 3, 0), Rgba(85, 0, 170, 255));
+	EXPECT_EQ(Pixel(pixels, 3, 3), Rgba(255, 0, 0, 255));
+
+	// Endpoints out of order use three colours and transparent black.
+	const uint8_t punchthrough[8] = {0x1F, 0x00, 0x00, 0xF8, 0b11100100, 0, 0, 0};
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Bc1RgbaUnorm, punchthrough, pixels);
+	EXPECT_EQ(Pixel(pixels, 2, 0), Rgba(128, 0, 128, 255));
+	EXPECT_EQ(Pixel(pixels, 3, 0), Rgba(0, 0, 0, 0));
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Bc1RgbUnorm, punchthrough, pixels);
+	EXPECT_EQ(Pixel(pixels, 3, 0), Rgba(0, 0, 0, 255));
+
+	const uint8_t bc3[16] = {255, 0, 0b10001000, 0, 0, 0, 0, 0, 0x00, 0xF8, 0x1F, 0x00, 0, 0, 0, 0};
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Bc3Unorm, bc3, pixels);
+	EXPECT_EQ(Pixel(pixels, 0, 0), Rgba(255, 0, 0, 255));
+	EXPECT_EQ(Pixel(pixels, 1, 0), Rgba(255, 0, 0, 0));
+	EXPECT_EQ(Pixel(pixels, 2, 0), Rgba(255, 0, 0, 219));
+
+	const uint8_t bc5[16] = {200, 0, 0, 0, 0, 0, 0, 0, 40, 0, 0, 0, 0, 0, 0, 0};
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Bc5Unorm, bc5, pixels);
+	EXPECT_EQ(Pixel(pixels, 1, 2), Rgba(200, 40, 0, 255));
+}
+
+TEST(Bitmap, decodeEtc2) {
+	uint8_t pixels[64];
+
+	// Individual mode, white on the left and blue on the right, every pixel adding the smallest modifier.
+	const uint8_t individual[8] = {0xF0, 0xF0, 0xFF, 0b00000000, 0, 0, 0, 0};
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Etc2R8G8B8Unorm, individual, pixels);
+	EXPECT_EQ(Pixel(pixels, 0, 3), Rgba(255, 255, 255, 255));
+	EXPECT_EQ(Pixel(pixels, 3, 0), Rgba(2, 2, 255, 255));
+
+	// Differential mode flipped into top and bottom halves, the first pixel takes the largest negative modifier.
+	const uint8_t differential[8] = {0x81, 0x80, 0x80, 0b11100011, 0, 0x01, 0, 0x01};
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Etc2R8G8B8Unorm, differential, pixels);
+	EXPECT_EQ(Pixel(pixels, 0, 0), Rgba(0, 0, 0, 255));
+	EXPECT_EQ(Pixel(pixels, 1, 1), Rgba(179, 179, 179, 255));
+	EXPECT_EQ(Pixel(pixels, 3, 0), Rgba(179, 179, 179, 255));
+	EXPECT_EQ(Pixel(pixels, 1, 3), Rgba(142, 134, 134, 255));
+
+	// Punchthrough blocks that are not opaque make the third index transparent.
+	const uint8_t punchthrough[8] = {0x80, 0x80, 0x80, 0, 0, 0x01, 0, 0};
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Etc2R8G8B8A1Unorm, punchthrough, pixels);
+	EXPECT_EQ(Pixel(pixels, 0, 0), Rgba(0, 0, 0, 0));
+	EXPECT_EQ(Pixel(pixels, 1, 0), Rgba(132, 132, 132, 255));
+
+	// Alpha is stored before the colour, with a base, multiplier and modifier table.
+	const uint8_t rgba[16] = {100, 0x2E, 0b11100000, 0, 0, 0, 0, 0, 0xF0, 0xF0, 0xF0, 0, 0, 0, 0, 0};
+	acid::BlockDecoder::DecodeBlock(acid::PixelFormat::Etc2R8G8B8A8Unorm, rgba, pixels);
+	EXPECT_EQ(Pixel(pixels, 0, 0)[3], 100 + 8 * 2);
+	EXPECT_EQ(Pixel(pixels, 0, 1)[3], 100 - 4 * 2);
+}
+
+TEST(Bitmap, loadDds) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+	std::filesystem::create_directories(directory);
+
+	// A array of two BC1 layers with two levels, stored one layer after another.
+	std::string file = "DDS ";
+	Append<uint32_t>(file, 124);
+	Append<uint32_t>(file, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000);
+	Append<uint32_t>(file, 4);
+	Append<uint32_t>(file, 8);
+	Append<uint32_t>(file, 16);
+	Append<uint32_t>(file, 0);
+	Append<uint32_t>(file, 2);
+	file.append(44, '\0');
+	Append<uint32_t>(file, 32);
+	Append<uint32_t>(file, 0x4);
+	file += "DX10";
+	file.append(20, '\0');
+	Append<uint32_t>(file, 0x1000 | 0x400000);
+	file.append(16, '\0');
+	Append<uint32_t>(file, 71);
+	Append<uint32_t>(file, 3);
+	Append<uint32_t>(file, 0);
+	Append<uint32_t>(file, 2);
+	Append<uint32_t>(file, 0);
+	for (char layer : {'a', 'b'})
+		file += std::string(16, layer) + std::string(8, static_cast<char>(layer + 2));
+	std::ofstream(directory / "Array.dds", std::ios::binary) << file;
+
+	acid::Bitmap bitmap(directory / "Array.dds");
+	ASSERT_TRUE(bitmap.GetData());
+	EXPECT_EQ(bitmap.GetFormat(), acid::PixelFormat::Bc1RgbaUnorm);
+	EXPECT_EQ(bitmap.GetSize(), acid::Vector2ui(8, 4));
+	EXPECT_EQ(bitmap.GetMipLevels(), 2u);
+	EXPECT_EQ(bitmap.GetArrayLayers(), 2u);
+	ASSERT_EQ(bitmap.GetLength(), 48u);
+	EXPECT_EQ(std::string(reinterpret_cast<const char *>(bitmap.GetData().get()), 48),
+		std::string(16, 'a') + std::string(16, 'b') + std::string(8, 'c') + std::string(8, 'd'));
+
+	auto decoded = acid::BlockDecoder::Decode(bitmap);
+	ASSERT_TRUE(decoded);
+	EXPECT_EQ(decoded->GetFormat(), acid::PixelFormat::R8G8B8A8Unorm);
+	EXPECT_EQ(decoded->GetLength(), (8u * 4 + 4 * 2) * 4 * 2);
+}
+
+TEST(Bitmap, loadDdsRejected) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+	std::filesystem::create_directories(directory);
+
+	// A DX10 BC1 array found by fuzzing, its width of 0xFFFFFFFF made the layout length wrap to a tiny allocation.
+	std::string file(
+		"\x44\x44\x53\x20\x7C\x00\x00\x00\x07\x10\x02\x00\x04\x00\x00\x00\xFF\xFF\xFF\xFF\x10\x00\x00\x00\x00\x00\x00\x00\x02\x00\x00\x00"
+		"\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+		"\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x20\x00\x00\x00\x04\x00\x00\x00\x44\x58\x31\x30\x00\x00\x00\x00\x10\x00\x00\x00"
+		"\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x10\x40\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+		"\x47\x00\x00\x00\x03\x00\x00\x00\x00\x00\x00\x00\x02\x00\x00\x00\x00\x00\x00\x00\x61\x61\x61\x61\x61\x61\x61\x61\x61\x61\x61\x61"
+		"\x61\x61\x61\x7B\x48\x2D\xBC\x63\x63\x63\x63\x63\x62\x62\x62\x62\x62\x62\x62\x62\x62\x62\x62\x62\x62\x62\x62\x62\x64\x64\x64\x64"
+		"\x64\x64\x64\x64", 196);
+	std::ofstream(directory / "Fuzzed.dds", std::ios::binary) << file;
+	EXPECT_FALSE(acid::Bitmap(directory / "Fuzzed.dds").GetData());
+
+	// A mip count of zero is rejected when the header says it is set, as are more levels than the size can be halved.
+	for (uint32_t mipLevels : {0u, 5u}) {
+		file = "DDS ";
+		Append<uint32_t>(file, 124);
+		Append<uint32_t>(file, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000);
+		Append<uint32_t>(file, 4);
+		Append<uint32_t>(file, 4);
+		Append<uint32_t>(file, 8);
+		Append<uint32_t>(file, 0);
+		Append<uint32_t>(file, mipLevels);
+		file.append(44, '\0');
+		Append<uint32_t>(file, 32);
+		Append<uint32_t>(file, 0x4);
+		file += "DXT1";
+		file.append(40, '\0');
+		file.append(64, 'a');
+		std::ofstream(directory / "Fuzzed.dds", std::ios::binary) << file;
+		EXPECT_FALSE(acid::Bitmap(directory / "Fuzzed.dds").GetData());
+	}
+
+	EXPECT_FALSE(acid::Bitmap::CheckLayout({acid::Bitmap::MaxSize + 1, 1}, acid::PixelFormat::R8G8B8A8Unorm, 1, 1));
+	EXPECT_FALSE(acid::Bitmap::CheckLayout({4096, 4096}, acid::PixelFormat::R32G32B32A32Sfloat, 1, 64));
+	EXPECT_EQ(acid::Bitmap::CheckLayout({8, 4}, acid::PixelFormat::Bc1RgbaUnorm, 4, 2), (2u * 1 + 1 + 1 + 1) * 8 * 2);
+	EXPECT_EQ(acid::Bitmap(nullptr, {1, 1}, acid::PixelFormat::R8Unorm, 40).GetLevelSize(39), acid::Vector2ui(1, 1));
+}
+
+TEST(Bitmap, loadKtx2) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+	std::filesystem::create_directories(directory);
+
+	std::string level0, level1(4, '\x7F');
+	for (uint8_t i = 0; i < 16; i++)
+		level0 += static_cast<char>(i);
+
+	for (uint32_t supercompression : {0, 3}) {
+		auto stored0 = level0, stored1 = level1;
+		if (supercompression == 3) {
+			for (auto *level : {&stored0, &stored1}) {
+				auto bound = mz_compressBound(static_cast<mz_ulong>(level->size()));
+				std::string compressed(bound, '\0');
+				ASSERT_EQ(mz_compress(reinterpret_cast<uint8_t *>(compressed.data()), &bound, reinterpret_cast<const uint8_t *>(level->data()),
+					static_cast<mz_ulong>(level->size())), MZ_OK);
+				compressed.resize(bound);
+				*level = compressed;
+			}
+		}
+
+		std::string file = "\xABKTX 20\xBB\r\n\x1A\n";
+		for (uint32_t value : {37u, 1u, 2u, 2u, 0u, 0u, 1u, 2u, supercompression})
+			Append(file, value);
+		file.append(16, '\0');
+		file.append(16, '\0');
+		// Levels are stored smallest first, the index finds them.
+		auto dataOffset = file.size() + 2 * 24;
+		for (auto [offset, stored, length] : {std::tuple(dataOffset + stored1.size(), stored0.size(), 16), std::tuple(dataOffset, stored1.size(), 4)}) {
+			Append<uint64_t>(file, offset);
+			Append<uint64_t>(file, stored);
+			Append<uint64_t>(file, length);
+		}
+		file += stored1 + stored0;
+		std::ofstream(directory / "Texture.ktx2", std::ios::binary) << file;
+
+		acid::Bitmap bitmap(directory / "Texture.ktx2");
+		ASSERT_TRUE(bitmap.GetData());
+		EXPECT_EQ(bitmap.GetFormat(), acid::PixelFormat::R8G8B8A8Unorm);
+		EXPECT_EQ(bitmap.GetBytesPerPixel(), 4u);
+		EXPECT_EQ(bitmap.GetMipLevels(), 2u);
+		ASSERT_EQ(bitmap.GetLength(), 20u);
+		EXPECT_EQ(std::string(reinterpret_cast<const char *>(bitmap.GetData().get()), 20), level0 + level1);
+	}
+}
+
+TEST(Bitmap, loadKtx2Rejected) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+	std::filesystem::create_directories(directory);
+
+	// A 2x2 image with one 16 byte level stored after the index.
+	auto load = [&](uint32_t layerCount, uint32_t faceCount, uint32_t levelCount, uint64_t offset) {
+		std::string file = "\xABKTX 20\xBB\r\n\x1A\n";
+		for (uint32_t value : {37u, 1u, 2u, 2u, 0u, layerCount, faceCount, levelCount, 0u})
+			Append(file, value);
+		file.append(32, '\0');
+		for (uint32_t level = 0; level < std::max(levelCount, 1u); level++) {
+			Append<uint64_t>(file, offset);
+			Append<uint64_t>(file, 16);
+			Append<uint64_t>(file, 16);
+		}
+		file.append(16, '\x7F');
+		std::ofstream(directory / "Rejected.ktx2", std::ios::binary) << file;
+		return acid::Bitmap(directory / "Rejected.ktx2").GetData() != nullptr;
+	};
+
+	EXPECT_TRUE(load(0, 1, 1, 80 + 24));
+	// Offsets that wrap around when the length is added.
+	EXPECT_FALSE(load(0, 1, 1, std::numeric_limits<uint64_t>::max() - 8));
+	// Layer counts whose product with the faces wraps around, or that are larger than a bitmap can hold.
+	EXPECT_FALSE(load(0x80000000, 6, 1, 80 + 24));
+	EXPECT_FALSE(load(0x10000000, 1, 1, 80 + 24));
+	// More levels than the size can be halved.
+	EXPECT_FALSE(load(0, 1, 3, 80 + 3 * 24));
+	EXPECT_FALSE(load(0, 1, 40, 80 + 40 * 24));
+}
+
+TEST(Bitmap, cookMipmaps) {
+	// Black and white average to middle grey in linear space, which is brighter than 128 in sRGB.
+	acid::Bitmap colour({2, 1});
+	const uint8_t colourPixels[8] = {0, 0, 0, 255, 255, 255, 255, 255};
+	std::memcpy(colour.GetData().get(), colourPixels, sizeof(colourPixels));
+	auto colourMipmaps = acid::TextureCooker::CreateMipmaps(colour, acid::TextureCooker::Content::Colour);
+	ASSERT_TRUE(colourMipmaps);
+	ASSERT_EQ(colourMipmaps->GetMipLevels(), 2u);
+	EXPECT_EQ(std::vector<uint8_t>(colourMipmaps->GetData().get() + 8, colourMipmaps->GetData().get() + 12), Rgba(188, 188, 188, 255));
+
+	// Transparent pixels do not darken the colour of the level below them.
+	const uint8_t transparentPixels[8] = {0, 0, 0, 0, 255, 0, 0, 255};
+	std::memcpy(colour.GetData().get(), transparentPixels, sizeof(transparentPixels));
+	colourMipmaps = acid::TextureCooker::CreateMipmaps(colour, acid::TextureCooker::Content::Colour);
+	EXPECT_EQ(std::vector<uint8_t>(colourMipmaps->GetData().get() + 8, colourMipmaps->GetData().get() + 12), Rgba(255, 0, 0, 128));
+
+	// Normals facing +X and +Z average to a unit vector between them.
+	acid::Bitmap normal({1, 2});
+	const uint8_t normalPixels[8] = {255, 128, 128, 255, 128, 128, 255, 255};
+	std::memcpy(normal.GetData().get(), normalPixels, sizeof(normalPixels));
+	auto normalMipmaps = acid::TextureCooker::CreateMipmaps(normal, acid::TextureCooker::Content::Normal);
+	ASSERT_TRUE(normalMipmaps);
+	EXPECT_EQ(std::vector<uint8_t>(normalMipmaps->GetData().get() + 8, normalMipmaps->GetData().get() + 12), Rgba(218, 128, 218, 255));
+
+	acid::Bitmap compressed(nullptr, {4, 4}, acid::PixelFormat::Bc1RgbaUnorm);
+	EXPECT_FALSE(acid::TextureCooker::CreateMipmaps(compressed, acid::TextureCooker::Content::Colour));
+}
+
+TEST(Bitmap, writeKtx2) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+	acid::Bitmap source({5, 3});
+	for (uint32_t i = 0; i < source.GetLength(); i++)
+		source.GetData()[i] = static_cast<uint8_t>(i * 7);
+
+	auto mipmaps = acid::TextureCooker::CreateMipmaps(source, acid::TextureCooker::Content::Linear);
+	ASSERT_TRUE(mipmaps);
+	EXPECT_EQ(mipmaps->GetMipLevels(), 3u);
+	acid::KtxBitmap::Write(mipmaps.get(), directory / "Cooked.ktx2");
+
+	acid::Bitmap loaded(directory / "Cooked.ktx2");
+	ASSERT_TRUE(loaded.GetData());
+	EXPECT_EQ(loaded.GetFormat(), acid::PixelFormat::R8G8B8A8Unorm);
+	EXPECT_EQ(loaded.GetSize(), acid::Vector2ui(5, 3));
+	EXPECT_EQ(loaded.GetMipLevels(), 3u);
+	ASSERT_EQ(loaded.GetLength(), mipmaps->GetLength());
+	EXPECT_EQ(std::memcmp(loaded.GetData().get(), mipmaps->GetData().get(), loaded.GetLength()), 0);
+
+	acid::Bitmap compressed(std::make_unique<uint8_t[]>(8), {4, 4}, acid::PixelFormat::Bc1RgbaUnorm);
+	std::filesystem::remove(directory / "Compressed.ktx2");
+	acid::KtxBitmap::Write(&compressed, directory / "Compressed.ktx2");
+	EXPECT_FALSE(std::filesystem::exists(directory / "Compressed.ktx2"));
+}
+
+TEST(Bitmap, halfFloats) {
+	EXPECT_EQ(acid::Bitmap::FloatToHalf(1.0f), 0x3c00);
+	EXPECT_EQ(acid::Bitmap::FloatToHalf(-2.0f), 0xc000);
+	EXPECT_EQ(acid::Bitmap::FloatToHalf(65504.0f), 0x7bff);
+	EXPECT_EQ(acid::Bitmap::FloatToHalf(1.0e6f), 0x7c00);
+	EXPECT_EQ(acid::Bitmap::FloatToHalf(std::ldexp(1.0f, -24)), 0x0001);
+	EXPECT_EQ(acid::Bitmap::FloatToHalf(std::ldexp(1.0f, -26)), 0x0000);
+	// Ties round to the even mantissa.
+	EXPECT_EQ(acid::Bitmap::FloatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+	EXPECT_EQ(acid::Bitmap::FloatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)), 0x3c02);
+
+	// Every half that is not NaN converts to a float and back unchanged.
+	for (uint32_t half = 0; half <= 0xffff; half++) {
+		if ((half & 0x7c00) == 0x7c00 && (half & 0x3ff))
+			continue;
+		EXPECT_EQ(acid::Bitmap::FloatToHalf(acid::Bitmap::HalfToFloat(static_cast<uint16_t>(half))), half);
+	}
+}
+
+TEST(Bitmap, convert) {
+	acid::Bitmap source({2, 1});
+	const uint8_t pixels[] = {0, 51, 255, 128, 255, 0, 0, 255};
+	std::memcpy(source.GetData().get(), pixels, sizeof(pixels));
+
+	auto halfs = source.Convert(acid::PixelFormat::R16G16B16A16Sfloat);
+	ASSERT_TRUE(halfs);
+	EXPECT_EQ(halfs->GetBytesPerPixel(), 8u);
+	auto values = reinterpret_cast<const uint16_t *>(halfs->GetData().get());
+	EXPECT_FLOAT_EQ(acid::Bitmap::HalfToFloat(values[2]), 1.0f);
+	EXPECT_NEAR(acid::Bitmap::HalfToFloat(values[1]), 0.2f, 0.001f);
+
+	auto back = halfs->Convert(acid::PixelFormat::R8G8B8A8Unorm);
+	ASSERT_TRUE(back);
+	EXPECT_EQ(std::memcmp(back->GetData().get(), pixels, sizeof(pixels)), 0);
+
+	// Missing channels are filled with 0 and a alpha of 1.
+	acid::Bitmap grey({1, 1}, 1);
+	grey.GetData()[0] = 255;
+	auto floats = grey.Convert(acid::PixelFormat::R32G32B32A32Sfloat);
+	ASSERT_TRUE(floats);
+	auto floatValues = reinterpret_cast<const float *>(floats->GetData().get());
+	EXPECT_EQ(std::vector<float>(floatValues, floatValues + 4), std::vector<float>({1.0f, 0.0f, 0.0f, 1.0f}));
+
+	acid::Bitmap compressed(std::make_unique<uint8_t[]>(8), {4, 4}, acid::PixelFormat::Bc1RgbaUnorm);
+	EXPECT_FALSE(compressed.Convert(acid::PixelFormat::R8G8B8A8Unorm));
+}
+
+TEST(Bitmap, writeExr) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+	acid::Bitmap source(nullptr, {37, 5}, acid::PixelFormat::R16G16B16A16Sfloat);
+	source.SetData(std::make_unique<uint8_t[]>(source.GetLength()));
+	auto values = reinterpret_cast<uint16_t *>(source.GetData().get());
+	for (uint32_t i = 0; i < source.GetLength() / 2; i++)
+		values[i] = acid::Bitmap::FloatToHalf(static_cast<float>(i) * 0.75f);
+
+	acid::ExrBitmap::Write(&source, directory / "Hdr.exr");
+	acid::Bitmap loaded(directory / "Hdr.exr");
+	ASSERT_TRUE(loaded.GetData());
+	EXPECT_EQ(loaded.GetFormat(), acid::PixelFormat::R16G16B16A16Sfloat);
+	EXPECT_EQ(loaded.GetSize(), source.GetSize());
+	ASSERT_EQ(loaded.GetLength(), source.GetLength());
+	EXPECT_EQ(std::memcmp(loaded.GetData().get(), source.GetData().get(), source.GetLength()), 0);
+
+	// 32 bit floats are stored as they are, then loaded as halfs.
+	auto floats = source.Convert(acid::PixelFormat::R32G32B32A32Sfloat);
+	ASSERT_TRUE(floats);
+	acid::ExrBitmap::Write(floats.get(), directory / "Float.exr");
+	acid::Bitmap loadedFloats(directory / "Float.exr");
+	ASSERT_EQ(loadedFloats.GetLength(), source.GetLength());
+	EXPECT_EQ(std::memcmp(loadedFloats.GetData().get(), source.GetData().get(), source.GetLength()), 0);
+}
+
+TEST(Bitmap, writeDng) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+	acid::Bitmap source(nullptr, {6, 4}, acid::PixelFormat::R16G16B16A16Sfloat);
+	source.SetData(std::make_unique<uint8_t[]>(source.GetLength()));
+	auto values = reinterpret_cast<uint16_t *>(source.GetData().get());
+	for (uint32_t i = 0; i < source.GetLength() / 2; i++)
+		values[i] = acid::Bitmap::FloatToHalf(i % 4 == 3 ? 1.0f : static_cast<float>(i) * 1.5f);
+
+	acid::DngBitmap::Write(&source, directory / "Linear.dng");
+	acid::Bitmap loaded(directory / "Linear.dng");
+	ASSERT_TRUE(loaded.GetData());
+	EXPECT_EQ(loaded.GetFormat(), acid::PixelFormat::R16G16B16A16Sfloat);
+	EXPECT_EQ(loaded.GetSize(), source.GetSize());
+	ASSERT_EQ(loaded.GetLength(), source.GetLength());
+	EXPECT_EQ(std::memcmp(loaded.GetData().get(), source.GetData().get(), source.GetLength()), 0);
+}
+
+TEST(Bitmap, loadDngActiveArea) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+	acid::Bitmap source(nullptr, {6, 4}, acid::PixelFormat::R16G16B16A16Sfloat);
+	source.SetData(std::make_unique<uint8_t[]>(source.GetLength()));
+	auto values = reinterpret_cast<uint16_t *>(source.GetData().get());
+	for (uint32_t i = 0; i < source.GetLength() / 2; i++)
+		values[i] = acid::Bitmap::FloatToHalf(i % 4 == 3 ? 1.0f : static_cast<float>(i));
+	acid::DngBitmap::Write(&source, directory / "Area.dng");
+
+	std::ifstream stream(directory / "Area.dng", std::ios::binary);
+	std::string written((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	// The orientation entry, the eighth of the IFD, is replaced with a active area stored at the end of the file.
+	auto load = [&](std::initializer_list<int32_t> area) {
+		auto file = written;
+		auto entry = file.data() + 8 + 2 + 7 * 12;
+		uint16_t tag = 50829, type = 4;
+		uint32_t count = 4, offset = static_cast<uint32_t>(file.size());
+		std::memcpy(entry, &tag, 2);
+		std::memcpy(entry + 2, &type, 2);
+		std::memcpy(entry + 4, &count, 4);
+		std::memcpy(entry + 8, &offset, 4);
+		for (auto value : area)
+			Append(file, value);
+		std::ofstream(directory / "Area.dng", std::ios::binary) << file;
+		return std::make_unique<acid::Bitmap>(directory / "Area.dng");
+	};
+
+	// Top, left, bottom and right.
+	auto cropped = load({1, 2, 3, 5});
+	ASSERT_TRUE(cropped->GetData());
+	EXPECT_EQ(cropped->GetSize(), acid::Vector2ui(3, 2));
+	EXPECT_EQ(std::memcmp(cropped->GetData().get(), values + (1 * 6 + 2) * 4, 3 * sizeof(uint16_t)), 0);
+
+	EXPECT_FALSE(load({0, 0, 5, 6})->GetData());
+	EXPECT_FALSE(load({0, 0, 4, 7})->GetData());
+	EXPECT_FALSE(load({2, 0, 2, 6})->GetData());
+	EXPECT_FALSE(load({0, 3, 4, 1})->GetData());
+	EXPECT_FALSE(load({-1, 0, 4, 6})->GetData());
+}
+
+TEST(Bitmap, writeQoi) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidBitmap";
+
+	// A pixel matching the start pixel is a run, a small change from it is a difference.
+	acid::Bitmap runs({2, 1});
+	for (uint32_t i = 0; i < 2; i++)
+		std::memcpy(runs.GetData().get() + i * 4, Rgba(i, 0, 0, 255).data(), 4);
+	acid::QoiBitmap::Write(&runs, directory / "Runs.qoi");
+	std::ifstream file(directory / "Runs.qoi", std::ios::binary);
+	std::vector<uint8_t> encoded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	EXPECT_EQ(encoded, std::vector<uint8_t>({'q', 'o', 'i', 'f', 0, 0, 0, 2, 0, 0, 0, 1, 4, 0, 0xc0, 0x7a, 0, 0, 0, 0, 0, 0, 0, 1}));
+
+	// Long runs, repeated colours, luma and full colour changes and alpha changes all round trip.
+	acid::Bitmap source({67, 9});
+	auto pixels = source.GetData().get();
+	for (uint32_t i = 0; i < 67 * 9; i++) {
+		auto pixel = i < 100 ? Rgba(10, 20, 30, 255) : i % 7 == 0 ? Rgba(200, 10, 10, 128) : Rgba(i * 3, i * 5 + i % 11, i * 3 + 4, i % 13 == 0 ? 7 : 255);
+		std::memcpy(pixels + i * 4, pixel.data(), 4);
+	}
+
+	source.Write(directory / "Frame.qoi");
+	acid::Bitmap loaded(directory / "Frame.qoi");
+	ASSERT_TRUE(loaded.GetData());
+	EXPECT_EQ(loaded.GetSize(), source.GetSize());
+	ASSERT_EQ(loaded.GetLength(), source.GetLength());
+	EXPECT_EQ(std::memcmp(loaded.GetData().get(), source.GetData().get(), source.GetLength()), 0);
+}
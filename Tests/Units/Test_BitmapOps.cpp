@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <Bitmaps/BitmapOps.hpp>
+#include <Utils/ThreadPool.hpp>
+
+namespace {
+std::vector<acid::BitmapOps::Simd> GetVectorSimds() {
+	std::vector<acid::BitmapOps::Simd> simds;
+	switch (acid::BitmapOps::GetSupportedSimd()) {
+	case acid::BitmapOps::Simd::Avx2:
+		simds = {acid::BitmapOps::Simd::Sse41, acid::BitmapOps::Simd::Avx2};
+		break;
+	case acid::BitmapOps::Simd::Sse41:
+		simds = {acid::BitmapOps::Simd::Sse41};
+		break;
+	case acid::BitmapOps::Simd::Neon:
+		simds = {acid::BitmapOps::Simd::Neon};
+		break;
+	default:
+		break;
+	}
+	return simds;
+}
+
+const char *GetSimdName(acid::BitmapOps::Simd simd) {
+	switch (simd) {
+	case acid::BitmapOps::Simd::Sse41:
+		return "SSE4.1";
+	case acid::BitmapOps::Simd::Avx2:
+		return "AVX2";
+	case acid::BitmapOps::Simd::Neon:
+		return "NEON";
+	default:
+		return "Scalar";
+	}
+}
+
+std::unique_ptr<acid::Bitmap> RandomBitmap(const acid::Vector2ui &size, acid::PixelFormat format, uint32_t arrayLayers = 1, uint32_t seed = 1) {
+	auto bitmap = std::make_unique<acid::Bitmap>(nullptr, size, format, 1, arrayLayers);
+	bitmap->SetData(std::make_unique<uint8_t[]>(bitmap->GetLength()));
+	std::mt19937 random(seed);
+	for (uint32_t i = 0; i < bitmap->GetLength(); i++)
+		bitmap->GetData()[i] = static_cast<uint8_t>(random());
+	return bitmap;
+}
+
+std::unique_ptr<acid::Bitmap> RandomFloatBitmap(const acid::Vector2ui &size, uint32_t seed = 1) {
+	auto bitmap = std::make_unique<acid::Bitmap>(nullptr, size, acid::PixelFormat::R32G32B32A32Sfloat);
+	bitmap->SetData(std::make_unique<uint8_t[]>(bitmap->GetLength()));
+	auto values = reinterpret_cast<float *>(bitmap->GetData().get());
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> distribution(-0.25f, 1.25f);
+	constexpr float Special[] = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+		-0.0f, 0.0f, 1.0f, std::numeric_limits<float>::denorm_min(), 0.99999994f, 1e-6f, 0.0031308f};
+	for (uint32_t i = 0; i < bitmap->GetLength() / 4; i++)
+		values[i] = i < std::size(Special) ? Special[i] : distribution(random);
+	return bitmap;
+}
+
+bool SameBytes(const acid::Bitmap &a, const acid::Bitmap &b) {
+	return a.GetLength() == b.GetLength() && std::memcmp(a.GetData().get(), b.GetData().get(), a.GetLength()) == 0;
+}
+
+/**
+ * Runs a operation with scalar then each vector version, and expects the same bytes from each.
+ */
+template<typename F>
+void ExpectMatchesScalar(F &&f) {
+	auto supported = acid::BitmapOps::GetSimd();
+	acid::BitmapOps::SetSimd(acid::BitmapOps::Simd::Scalar);
+	auto expected = f();
+
+	for (auto simd : GetVectorSimds()) {
+		acid::BitmapOps::SetSimd(simd);
+		ASSERT_EQ(acid::BitmapOps::GetSimd(), simd);
+		EXPECT_TRUE(SameBytes(*f(), *expected)) << GetSimdName(simd);
+	}
+
+	acid::BitmapOps::SetSimd(supported);
+}
+}
+
+TEST(BitmapOps, matchesScalar) {
+	acid::ThreadPool threadPool(3);
+
+	// Odd sizes leave pixels past the last full vector.
+	for (auto size : {acid::Vector2ui(1, 1), acid::Vector2ui(3, 2), acid::Vector2ui(37, 19), acid::Vector2ui(130, 67)}) {
+		ExpectMatchesScalar([&] {
+			auto bitmap = RandomBitmap(size, acid::PixelFormat::R8G8B8A8Unorm);
+			acid::BitmapOps::Swizzle(*bitmap, {2, 1, 0, 3}, &threadPool);
+			return bitmap;
+		});
+		ExpectMatchesScalar([&] {
+			auto bitmap = RandomBitmap(size, acid::PixelFormat::R8G8B8A8Unorm);
+			acid::BitmapOps::Premultiply(*bitmap, &threadPool);
+			return bitmap;
+		});
+		ExpectMatchesScalar([&] {
+			return acid::BitmapOps::SrgbToLinear(*RandomBitmap(size, acid::PixelFormat::R8G8B8A8Srgb), &threadPool);
+		});
+		ExpectMatchesScalar([&] {
+			return acid::BitmapOps::LinearToSrgb(*RandomFloatBitmap(size), &threadPool);
+		});
+
+		for (auto format : {acid::PixelFormat::R8Unorm, acid::PixelFormat::R8G8Unorm, acid::PixelFormat::R8G8B8Unorm}) {
+			ExpectMatchesScalar([&] {
+				return acid::BitmapOps::ExpandToRgba(*RandomBitmap(size, format), &threadPool);
+			});
+		}
+
+		for (auto filter : {acid::BitmapOps::Filter::Box, acid::BitmapOps::Filter::Lanczos}) {
+			for (auto resized : {acid::Vector2ui((size.x + 1) / 2, (size.y + 1) / 2), acid::Vector2ui(size.x * 2 + 1, size.y / 3 + 1)}) {
+				ExpectMatchesScalar([&] {
+					return acid::BitmapOps::Resize(*RandomBitmap(size, acid::PixelFormat::R8G8B8A8Unorm, 2), resized, filter, &threadPool);
+				});
+			}
+		}
+	}
+}
+
+TEST(BitmapOps, premultiply) {
+	// Every colour and alpha pair, rounded to the nearest.
+	auto bitmap = std::make_unique<acid::Bitmap>(nullptr, acid::Vector2ui(256, 256), acid::PixelFormat::R8G8B8A8Unorm);
+	bitmap->SetData(std::make_unique<uint8_t[]>(bitmap->GetLength()));
+	for (uint32_t i = 0; i < 256 * 256; i++) {
+		auto pixel = bitmap->GetData().get() + i * 4;
+		pixel[0] = pixel[1] = pixel[2] = static_cast<uint8_t>(i % 256);
+		pixel[3] = static_cast<uint8_t>(i / 256);
+	}
+
+	// Scalar is checked too, the vector levels are only compared against it elsewhere.
+	auto simds = GetVectorSimds();
+	simds.insert(simds.begin(), acid::BitmapOps::Simd::Scalar);
+
+	for (auto simd : simds) {
+		acid::BitmapOps::SetSimd(simd);
+		auto copy = std::make_unique<acid::Bitmap>(std::make_unique<uint8_t[]>(bitmap->GetLength()), bitmap->GetSize(), bitmap->GetFormat());
+		std::memcpy(copy->GetData().get(), bitmap->GetData().get(), bitmap->GetLength());
+		acid::BitmapOps::Premultiply(*copy);
+
+		for (uint32_t i = 0; i < 256 * 256; i++) {
+			auto pixel = copy->GetData().get() + i * 4;
+			auto expected = static_cast<uint8_t>(std::lround(i % 256 * (i / 256) / 255.0));
+			ASSERT_EQ(pixel[0], expected) << GetSimdName(simd) << " " << i % 256 << " * " << i / 256;
+			ASSERT_EQ(pixel[3], i / 256);
+		}
+	}
+
+	acid::BitmapOps::SetSimd(acid::BitmapOps::GetSupportedSimd());
+}
+
+TEST(BitmapOps, srgb) {
+	// Every 8 bit value decodes and encodes back to itself.
+	auto bitmap = std::make_unique<acid::Bitmap>(nullptr, acid::Vector2ui(256, 1), acid::PixelFormat::R8G8B8A8Srgb);
+	bitmap->SetData(std::make_unique<uint8_t[]>(bitmap->GetLength()));
+	for (uint32_t i = 0; i < 256 * 4; i++)
+		bitmap->GetData()[i] = static_cast<uint8_t>(i / 4);
+
+	auto linear = acid::BitmapOps::SrgbToLinear(*bitmap);
+	ASSERT_TRUE(linear);
+	EXPECT_EQ(linear->GetFormat(), acid::PixelFormat::R32G32B32A32Sfloat);
+	auto values = reinterpret_cast<const float *>(linear->GetData().get());
+	EXPECT_FLOAT_EQ(values[128 * 4], std::pow((128 / 255.0f + 0.055f) / 1.055f, 2.4f));
+	EXPECT_FLOAT_EQ(values[128 * 4 + 3], 128 / 255.0f);
+	EXPECT_TRUE(SameBytes(*acid::BitmapOps::LinearToSrgb(*linear), *bitmap));
+
+	// Encoded values are within one step of the exact curve.
+	auto floats = RandomFloatBitmap({64, 64});
+	auto encoded = acid::BitmapOps::LinearToSrgb(*floats);
+	auto source = reinterpret_cast<const float *>(floats->GetData().get());
+	for (uint32_t i = 0; i < 64 * 64 * 4; i++) {
+		if (i % 4 == 3 || std::isnan(source[i]))
+			continue;
+		auto value = std::clamp(static_cast<double>(source[i]), 0.0, 1.0);
+		auto exact = 255.0 * (value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055);
+		EXPECT_LE(std::abs(encoded->GetData()[i] - exact), 1.0) << source[i];
+	}
+	EXPECT_EQ(encoded->GetData()[0], 0);
+	EXPECT_EQ(encoded->GetData()[1], 255);
+	EXPECT_EQ(encoded->GetData()[2], 0);
+}
+
+TEST(BitmapOps, layout) {
+	auto bitmap = RandomBitmap({5, 3}, acid::PixelFormat::R8G8B8A8Unorm);
+	auto copy = std::make_unique<acid::Bitmap>(std::make_unique<uint8_t[]>(bitmap->GetLength()), bitmap->GetSize(), bitmap->GetFormat());
+	std::memcpy(copy->GetData().get(), bitmap->GetData().get(), bitmap->GetLength());
+
+	acid::BitmapOps::Swizzle(*copy, {2, 1, 0, 3});
+	EXPECT_EQ(copy->GetData()[0], bitmap->GetData()[2]);
+	EXPECT_EQ(copy->GetData()[2], bitmap->GetData()[0]);
+	acid::BitmapOps::Swizzle(*copy, {2, 1, 0, 3});
+	EXPECT_TRUE(SameBytes(*copy, *bitmap));
+
+	acid::BitmapOps::FlipVertical(*copy);
+	EXPECT_EQ(std::memcmp(copy->GetData().get(), bitmap->GetData().get() + 2 * 5 * 4, 5 * 4), 0);
+	EXPECT_EQ(std::memcmp(copy->GetData().get() + 5 * 4, bitmap->GetData().get() + 5 * 4, 5 * 4), 0);
+	acid::BitmapOps::FlipVertical(*copy);
+	EXPECT_TRUE(SameBytes(*copy, *bitmap));
+
+	auto rgb = RandomBitmap({7, 1}, acid::PixelFormat::R8G8B8Unorm);
+	auto expanded = acid::BitmapOps::ExpandToRgba(*rgb);
+	ASSERT_TRUE(expanded);
+	EXPECT_EQ(expanded->GetFormat(), acid::PixelFormat::R8G8B8A8Unorm);
+	for (uint32_t i = 0; i < 7; i++) {
+		EXPECT_EQ(std::memcmp(expanded->GetData().get() + i * 4, rgb->GetData().get() + i * 3, 3), 0);
+		EXPECT_EQ(expanded->GetData()[i * 4 + 3], 255);
+	}
+
+	EXPECT_FALSE(acid::BitmapOps::ExpandToRgba(*bitmap));
+}
+
+TEST(BitmapOps, resize) {
+	// A solid colour stays the same colour through either filter.
+	auto solid = std::make_unique<acid::Bitmap>(nullptr, acid::Vector2ui(33, 17), acid::PixelFormat::R8G8B8A8Unorm);
+	solid->SetData(std::make_unique<uint8_t[]>(solid->GetLength()));
+	for (uint32_t i = 0; i < solid->GetLength(); i += 4) {
+		const uint8_t colour[] = {200, 17, 255, 1};
+		std::memcpy(solid->GetData().get() + i, colour, 4);
+	}
+	for (auto filter : {acid::BitmapOps::Filter::Box, acid::BitmapOps::Filter::Lanczos}) {
+		auto resized = acid::BitmapOps::Resize(*solid, {10, 7}, filter);
+		ASSERT_TRUE(resized);
+		for (uint32_t i = 0; i < resized->GetLength(); i += 4)
+			ASSERT_EQ(std::memcmp(resized->GetData().get() + i, solid->GetData().get(), 4), 0);
+	}
+
+	// Halving with a box filter averages each 2x2 square.
+	auto bitmap = std::make_unique<acid::Bitmap>(nullptr, acid::Vector2ui(4, 2), acid::PixelFormat::R8G8B8A8Unorm);
+	bitmap->SetData(std::make_unique<uint8_t[]>(bitmap->GetLength()));
+	const uint8_t values[] = {0, 40, 100, 200, 20, 60, 100, 100};
+	for (uint32_t i = 0; i < 8; i++)
+		std::memset(bitmap->GetData().get() + i * 4, values[i], 4);
+	auto halved = acid::BitmapOps::Resize(*bitmap, {2, 1}, acid::BitmapOps::Filter::Box);
+	ASSERT_TRUE(halved);
+	EXPECT_EQ(halved->GetData()[0], 30);
+	EXPECT_EQ(halved->GetData()[4], 125);
+}
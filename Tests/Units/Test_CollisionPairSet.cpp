@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <Physics/CollisionPairSet.hpp>
+
+namespace {
+using Pair = std::pair<const btCollisionObject *, const btCollisionObject *>;
+
+// Pairs are only compared by address, so bodies can be any distinct addresses.
+char bodies[64];
+
+const btCollisionObject *Body(std::size_t index) {
+	return reinterpret_cast<const btCollisionObject *>(&bodies[index]);
+}
+}
+
+TEST(CollisionPairSet, transitions) {
+	acid::CollisionPairSet pairs;
+	std::vector<Pair> removed;
+	auto collect = [&removed](const btCollisionObject *a, const btCollisionObject *b) {
+		removed.emplace_back(a, b);
+	};
+
+	EXPECT_EQ(pairs.Touch(Body(0), Body(1), 1), acid::CollisionPairSet::Result::Began);
+	// A second manifold between the same bodies in one update is repeated.
+	EXPECT_EQ(pairs.Touch(Body(0), Body(1), 1), acid::CollisionPairSet::Result::Repeated);
+	pairs.RemoveStale(1, collect);
+	EXPECT_TRUE(removed.empty());
+
+	EXPECT_EQ(pairs.Touch(Body(0), Body(1), 2), acid::CollisionPairSet::Result::Persisted);
+	EXPECT_EQ(pairs.Touch(Body(2), Body(3), 2), acid::CollisionPairSet::Result::Began);
+	pairs.RemoveStale(2, collect);
+	EXPECT_TRUE(removed.empty());
+	EXPECT_EQ(pairs.GetSize(), 2);
+
+	// Pairs not touched in an update have separated.
+	EXPECT_EQ(pairs.Touch(Body(2), Body(3), 3), acid::CollisionPairSet::Result::Persisted);
+	pairs.RemoveStale(3, collect);
+	ASSERT_EQ(removed.size(), 1);
+	EXPECT_EQ(removed[0], Pair(Body(0), Body(1)));
+	EXPECT_EQ(pairs.GetSize(), 1);
+
+	// A pair that touches again after separating begins again.
+	EXPECT_EQ(pairs.Touch(Body(0), Body(1), 4), acid::CollisionPairSet::Result::Began);
+}
+
+TEST(CollisionPairSet, removeBody) {
+	acid::CollisionPairSet pairs;
+	pairs.Touch(Body(0), Body(1), 1);
+	pairs.Touch(Body(1), Body(2), 1);
+	pairs.Touch(Body(2), Body(3), 1);
+
+	// Every pair with the body is removed without being reported as stale later.
+	pairs.Remove(Body(1));
+	EXPECT_EQ(pairs.GetSize(), 1);
+
+	std::vector<Pair> removed;
+	pairs.RemoveStale(2, [&removed](const btCollisionObject *a, const btCollisionObject *b) {
+		removed.emplace_back(a, b);
+	});
+	ASSERT_EQ(removed.size(), 1);
+	EXPECT_EQ(removed[0], Pair(Body(2), Body(3)));
+}
+
+TEST(CollisionPairSet, matchesSet) {
+	acid::CollisionPairSet pairs;
+	std::set<Pair> previous;
+	std::mt19937 random(7);
+
+	// Random contacts grow the set past several rehashes and remove runs of neighbouring entries.
+	for (uint32_t generation = 1; generation <= 50; generation++) {
+		std::set<Pair> current;
+		auto contacts = std::uniform_int_distribution<uint32_t>(0, 400)(random);
+		for (uint32_t i = 0; i < contacts; i++) {
+			auto a = std::uniform_int_distribution<std::size_t>(0, 62)(random);
+			auto b = std::uniform_int_distribution<std::size_t>(a + 1, 63)(random);
+			Pair pair(Body(a), Body(b));
+
+			auto result = pairs.Touch(pair.first, pair.second, generation);
+			if (current.count(pair))
+				EXPECT_EQ(result, acid::CollisionPairSet::Result::Repeated);
+			else if (previous.count(pair))
+				EXPECT_EQ(result, acid::CollisionPairSet::Result::Persisted);
+			else
+				EXPECT_EQ(result, acid::CollisionPairSet::Result::Began);
+			current.emplace(pair);
+		}
+
+		std::set<Pair> removed;
+		pairs.RemoveStale(generation, [&removed](const btCollisionObject *a, const btCollisionObject *b) {
+			EXPECT_TRUE(removed.emplace(a, b).second);
+		});
+
+		std::set<Pair> expected;
+		std::set_difference(previous.begin(), previous.end(), current.begin(), current.end(), std::inserter(expected, expected.end()));
+		EXPECT_EQ(removed, expected);
+		EXPECT_EQ(pairs.GetSize(), current.size());
+		previous = std::move(current);
+	}
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <thread>
+#include <Files/FileObserver.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+/**
+ * Delivers changes on this thread until a condition holds, or gives up after a few seconds.
+ */
+template<typename Condition>
+bool UpdateUntil(Condition &&condition) {
+	auto deadline = std::chrono::steady_clock::now() + 5s;
+	while (!condition()) {
+		if (std::chrono::steady_clock::now() > deadline)
+			return false;
+		std::this_thread::yield();
+		acid::FileObserver::Update();
+	}
+	return true;
+}
+}
+
+TEST(FileObserver, batchedChanges) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidFileObserver";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	directory = std::filesystem::canonical(directory);
+	std::ofstream(directory / "existing.txt") << "a";
+
+	acid::FileObserver observer(directory, 100ms);
+	std::vector<acid::FileObserver::Change> changes;
+	uint32_t batchCount = 0;
+	observer.OnChanges().Add([&](const std::vector<acid::FileObserver::Change> &batch) {
+		changes.insert(changes.end(), batch.begin(), batch.end());
+		batchCount++;
+	});
+
+	// A file written many times in a row is reported once it settles, as a single creation.
+	for (uint32_t i = 0; i < 10; i++) {
+		std::ofstream(directory / "created.txt", std::ios::app) << i;
+		std::this_thread::sleep_for(5ms);
+	}
+	std::filesystem::create_directories(directory / "sub");
+	std::ofstream(directory / "sub" / "nested.txt") << "b";
+	std::filesystem::remove(directory / "existing.txt");
+
+	ASSERT_TRUE(UpdateUntil([&] { return changes.size() >= 4; }));
+	std::sort(changes.begin(), changes.end(), [](const auto &a, const auto &b) { return a.path < b.path; });
+	ASSERT_EQ(changes.size(), 4u);
+	EXPECT_EQ(changes[0].path, directory / "created.txt");
+	EXPECT_EQ(changes[0].status, acid::FileObserver::Status::Created);
+	EXPECT_EQ(changes[1].path, directory / "existing.txt");
+	EXPECT_EQ(changes[1].status, acid::FileObserver::Status::Erased);
+	EXPECT_EQ(changes[2].path, directory / "sub");
+	EXPECT_EQ(changes[3].path, directory / "sub" / "nested.txt");
+	EXPECT_EQ(changes[3].status, acid::FileObserver::Status::Created);
+	EXPECT_LE(batchCount, 2u);
+
+	// Files created inside a new directory are watched as well.
+	changes.clear();
+	std::ofstream(directory / "sub" / "nested.txt", std::ios::app) << "c";
+	ASSERT_TRUE(UpdateUntil([&] { return !changes.empty(); }));
+	ASSERT_EQ(changes.size(), 1u);
+	EXPECT_EQ(changes[0].path, directory / "sub" / "nested.txt");
+	EXPECT_EQ(changes[0].status, acid::FileObserver::Status::Modified);
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST(FileObserver, destroyedByCallback) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidFileObserverDestroyed";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	// Each observer destroys itself on its first change, the later changes of its batch are not delivered.
+	auto first = std::make_unique<acid::FileObserver>(directory, 10ms);
+	auto second = std::make_unique<acid::FileObserver>(directory, 10ms);
+	uint32_t firstCount = 0, secondCount = 0, batchCount = 0;
+	first->OnChange().Add([&](std::filesystem::path, acid::FileObserver::Status) {
+		firstCount++;
+		first.reset();
+	});
+	first->OnChanges().Add([&](const std::vector<acid::FileObserver::Change> &) { batchCount++; });
+	second->OnChange().Add([&](std::filesystem::path, acid::FileObserver::Status) {
+		secondCount++;
+		second.reset();
+	});
+
+	std::ofstream(directory / "a.txt") << "a";
+	std::ofstream(directory / "b.txt") << "b";
+	ASSERT_TRUE(UpdateUntil([&] { return !first && !second; }));
+	EXPECT_EQ(firstCount, 1u);
+	EXPECT_EQ(secondCount, 1u);
+	EXPECT_EQ(batchCount, 0u);
+
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <Fonts/FontType.hpp>
+
+namespace {
+/**
+ * Font type with glyphs added directly instead of generated from a font file.
+ */
+class CacheFontType : public acid::FontType {
+public:
+	explicit CacheFontType(std::size_t size) :
+		FontType("", size, false) {
+	}
+
+	void Add(char32_t codepoint, float advance, bool hasImage) {
+		Glyph glyph;
+		glyph.codepoint = codepoint;
+		glyph.advance = advance;
+		glyph.offset = {1.0f, -static_cast<float>(GetSize())};
+		glyph.hasImage = hasImage;
+
+		std::unique_ptr<acid::Bitmap> bitmap;
+		if (hasImage) {
+			auto length = GetSize() * GetSize() * 4;
+			auto pixels = std::make_unique<uint8_t[]>(length);
+			for (std::size_t i = 0; i < length; i++)
+				pixels[i] = static_cast<uint8_t>(codepoint + i);
+			bitmap = std::make_unique<acid::Bitmap>(std::move(pixels), acid::Vector2ui(static_cast<uint32_t>(GetSize())), acid::PixelFormat::R8G8B8A8Unorm);
+		}
+
+		AddGlyph(glyph, std::move(bitmap));
+	}
+
+	std::string Write() const {
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		WriteCache(stream);
+		return stream.str();
+	}
+
+	bool Read(const std::string &data) {
+		return ReadCache(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+	}
+};
+}
+
+TEST(FontType, cacheRoundTrip) {
+	CacheFontType written(8);
+	written.Add('a', 5.0f, true);
+	written.Add(' ', 3.0f, false);
+	written.Add(U'é', 6.0f, true);
+	auto data = written.Write();
+
+	CacheFontType read(8);
+	ASSERT_TRUE(read.Read(data));
+	ASSERT_EQ(read.GetGlyphCount(), 3);
+	for (auto codepoint : {U'a', U' ', U'é'}) {
+		auto glyph = read.GetGlyph(codepoint);
+		ASSERT_TRUE(glyph.has_value()) << static_cast<uint32_t>(codepoint);
+		EXPECT_EQ(glyph->advance, written.GetGlyph(codepoint)->advance);
+		EXPECT_EQ(glyph->offset, written.GetGlyph(codepoint)->offset);
+		EXPECT_EQ(glyph->hasImage, written.GetGlyph(codepoint)->hasImage);
+	}
+	EXPECT_EQ(read.GetMaxAdvance(), 6.0f);
+
+	// The images read back are written again byte for byte.
+	EXPECT_EQ(read.Write(), data);
+
+	// Glyphs already added are kept, only the others are added from the cache.
+	CacheFontType partial(8);
+	partial.Add('a', 9.0f, false);
+	ASSERT_TRUE(partial.Read(data));
+	EXPECT_EQ(partial.GetGlyphCount(), 3);
+	EXPECT_EQ(partial.GetGlyph('a')->advance, 9.0f);
+}
+
+TEST(FontType, cacheRejected) {
+	CacheFontType written(8);
+	written.Add('a', 5.0f, true);
+	auto data = written.Write();
+
+	// A cache for another size is not read.
+	CacheFontType otherSize(16);
+	EXPECT_FALSE(otherSize.Read(data));
+	EXPECT_EQ(otherSize.GetGlyphCount(), 0);
+
+	// Nor one cut short or with another magic.
+	CacheFontType truncated(8);
+	EXPECT_FALSE(truncated.Read(data.substr(0, data.size() - 1)));
+	EXPECT_FALSE(truncated.Read(data.substr(0, 8)));
+	EXPECT_EQ(truncated.GetGlyphCount(), 0);
+
+	auto corrupted = data;
+	corrupted[0] = 'X';
+	EXPECT_FALSE(truncated.Read(corrupted));
+	EXPECT_EQ(truncated.GetGlyphCount(), 0);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <Models/Gltf/GltfLoader.hpp>
+
+namespace {
+std::string Base64(const std::string &bytes) {
+	static const char *Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::string result;
+	for (std::size_t i = 0; i < bytes.size(); i += 3) {
+		uint32_t value = static_cast<uint8_t>(bytes[i]) << 16;
+		if (i + 1 < bytes.size()) value |= static_cast<uint8_t>(bytes[i + 1]) << 8;
+		if (i + 2 < bytes.size()) value |= static_cast<uint8_t>(bytes[i + 2]);
+		result += Alphabet[(value >> 18) & 63];
+		result += Alphabet[(value >> 12) & 63];
+		result += i + 1 < bytes.size() ? Alphabet[(value >> 6) & 63] : '=';
+		result += i + 2 < bytes.size() ? Alphabet[value & 63] : '=';
+	}
+	return result;
+}
+
+template<typename T>
+void Append(std::string &buffer, std::initializer_list<T> values) {
+	for (auto value : values)
+		buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * Writes a triangle with its buffer embedded as a data URI, so the file is read without any other files.
+ * @param nodes The node list, the triangle is mesh 0.
+ * @param skins The skin list.
+ * @return The file.
+ */
+std::filesystem::path WriteTriangle(const std::string &name, const std::string &nodes, const std::string &skins = "[]") {
+	// Positions, 16 bit indices padded to 4 bytes, joints as bytes and weights as floats.
+	std::string buffer;
+	Append<float>(buffer, {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f});
+	Append<uint16_t>(buffer, {0, 1, 2, 0});
+	Append<uint8_t>(buffer, {0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0});
+	Append<float>(buffer, {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.25f, 0.75f, 0.0f, 0.0f});
+
+	auto directory = std::filesystem::temp_directory_path() / "AcidGltfLoader";
+	std::filesystem::create_directories(directory);
+	auto filename = directory / (name + ".gltf");
+	std::ofstream(filename) << R"({
+	"asset": {"version": "2.0"},
+	"buffers": [{"byteLength": )" << buffer.size() << R"(, "uri": "data:application/octet-stream;base64,)" << Base64(buffer) << R"("}],
+	"bufferViews": [
+		{"buffer": 0, "byteOffset": 0, "byteLength": 36},
+		{"buffer": 0, "byteOffset": 36, "byteLength": 6},
+		{"buffer": 0, "byteOffset": 44, "byteLength": 12},
+		{"buffer": 0, "byteOffset": 56, "byteLength": 48}
+	],
+	"accessors": [
+		{"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3", "min": [0, 0, 0], "max": [1, 1, 0]},
+		{"bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR"},
+		{"bufferView": 2, "componentType": 5121, "count": 3, "type": "VEC4"},
+		{"bufferView": 3, "componentType": 5126, "count": 3, "type": "VEC4"}
+	],
+	"materials": [{"pbrMetallicRoughness": {"baseColorFactor": [1, 0.5, 0.25, 1], "metallicFactor": 0.25, "roughnessFactor": 0.75}}],
+	"meshes": [{"primitives": [{"attributes": {"POSITION": 0, "JOINTS_0": 2, "WEIGHTS_0": 3}, "indices": 1, "material": 0}]}],
+	"nodes": )" << nodes << R"(,
+	"skins": )" << skins << R"(
+})";
+	return filename;
+}
+}
+
+TEST(GltfLoader, embeddedTriangle) {
+	// The mesh node is a child of a translated node, static meshes are read in the space of the scene.
+	acid::GltfLoader loader(WriteTriangle("Triangle", R"([{"translation": [1, 0, 0], "children": [1]}, {"translation": [0, 2, 0], "mesh": 0}])"));
+
+	ASSERT_EQ(loader.GetVertices().size(), 3);
+	EXPECT_EQ(loader.GetVertices()[0].position, acid::Vector3f(1.0f, 2.0f, 0.0f));
+	EXPECT_EQ(loader.GetVertices()[1].position, acid::Vector3f(2.0f, 2.0f, 0.0f));
+	EXPECT_EQ(loader.GetVertices()[2].position, acid::Vector3f(1.0f, 3.0f, 0.0f));
+	EXPECT_EQ(loader.GetIndices(), (std::vector<uint32_t>{0, 1, 2}));
+	EXPECT_FALSE(loader.IsSkinned());
+	EXPECT_TRUE(loader.GetBufferFiles().empty());
+
+	ASSERT_EQ(loader.GetPrimitives().size(), 1);
+	EXPECT_EQ(loader.GetPrimitives()[0].indexCount, 3);
+	EXPECT_EQ(loader.GetPrimitives()[0].material, 0);
+
+	ASSERT_EQ(loader.GetMaterials().size(), 1);
+	EXPECT_EQ(loader.GetMaterials()[0].GetBaseDiffuse(), acid::Colour(1.0f, 0.5f, 0.25f, 1.0f));
+	EXPECT_FLOAT_EQ(loader.GetMaterials()[0].GetMetallic(), 0.25f);
+	EXPECT_FLOAT_EQ(loader.GetMaterials()[0].GetRoughness(), 0.75f);
+	EXPECT_NE(acid::GltfLoader::CreateMaterial(loader.GetMaterials(), 0), nullptr);
+	EXPECT_EQ(acid::GltfLoader::CreateMaterial(loader.GetMaterials(), 1), nullptr);
+}
+
+TEST(GltfLoader, deferredMaterials) {
+	// Reloads read the file on a resource thread, the materials are created later on the main thread.
+	acid::GltfLoader loader(WriteTriangle("Deferred", R"([{"mesh": 0}])"), false, false);
+
+	EXPECT_EQ(loader.GetVertices().size(), 3);
+	EXPECT_TRUE(loader.GetMaterials().empty());
+
+	loader.CreateMaterials();
+	ASSERT_EQ(loader.GetMaterials().size(), 1);
+	EXPECT_EQ(loader.GetMaterials()[0].GetBaseDiffuse(), acid::Colour(1.0f, 0.5f, 0.25f, 1.0f));
+}
+
+TEST(GltfLoader, skinWithoutAnimations) {
+	acid::GltfLoader loader(WriteTriangle("Skin", R"([{"name": "hip", "children": [1]}, {"name": "spine", "translation": [0, 1, 0]}, {"mesh": 0, "skin": 0}])",
+		R"([{"joints": [0, 1]}])"), true);
+
+	EXPECT_TRUE(loader.IsSkinned());
+	EXPECT_TRUE(loader.GetAnimations().empty());
+	ASSERT_EQ(loader.GetAnimatedVertices().size(), 3);
+	EXPECT_EQ(loader.GetAnimatedVertices()[1].jointId.x, 1);
+	EXPECT_EQ(loader.GetAnimatedVertices()[2].vertexWeight, acid::Vector3f(0.75f, 0.25f, 0.0f));
+
+	EXPECT_EQ(loader.GetHeadJoint().GetName(), "hip");
+	ASSERT_EQ(loader.GetHeadJoint().GetChildren().size(), 1);
+	EXPECT_EQ(loader.GetHeadJoint().GetChildren()[0].GetName(), "spine");
+}
+
+TEST(GltfLoader, malformedHierarchy) {
+	// Children out of range, nodes with two parents and cycles are rejected before the hierarchy is walked.
+	EXPECT_THROW(acid::GltfLoader(WriteTriangle("ChildRange", R"([{"children": [5]}, {"mesh": 0}])")), std::runtime_error);
+	EXPECT_THROW(acid::GltfLoader(WriteTriangle("TwoParents", R"([{"children": [2]}, {"children": [2]}, {"mesh": 0}])")), std::runtime_error);
+	EXPECT_THROW(acid::GltfLoader(WriteTriangle("Cycle", R"([{"mesh": 0}, {"children": [2]}, {"children": [1]}])")), std::runtime_error);
+	EXPECT_THROW(acid::GltfLoader(WriteTriangle("SelfCycle", R"([{"mesh": 0}, {"children": [1]}])")), std::runtime_error);
+	EXPECT_THROW(acid::GltfLoader(WriteTriangle("JointRange", R"([{"mesh": 0, "skin": 0}])", R"([{"joints": [3]}])"), true), std::runtime_error);
+
+	std::filesystem::remove_all(std::filesystem::temp_directory_path() / "AcidGltfLoader");
+}
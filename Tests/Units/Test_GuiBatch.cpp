@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <Guis/GuiBatch.hpp>
+
+namespace {
+/**
+ * Images are only compared by address while building, so a test image is a descriptor that is never written.
+ */
+class TestImage : public acid::Descriptor {
+public:
+	acid::WriteDescriptorSet GetWriteDescriptor(uint32_t, VkDescriptorType, const std::optional<acid::OffsetSize> &) const override {
+		return {VkWriteDescriptorSet{}, VkDescriptorImageInfo{}};
+	}
+};
+
+std::shared_ptr<acid::Descriptor> CreateImage() {
+	return std::make_shared<TestImage>();
+}
+
+void AddQuad(acid::GuiBatch &batch, const acid::Vector4f &rect, const std::shared_ptr<acid::Descriptor> &image, float depth = 0.0f,
+	const std::optional<acid::Vector4i> &scissor = std::nullopt) {
+	batch.AddQuad(acid::Matrix4().Translate(acid::Vector3f(0.0f, 0.0f, depth)), rect, {0.0f, 0.0f, 1.0f, 1.0f}, acid::Colour::White, image, scissor);
+}
+
+std::vector<std::shared_ptr<acid::Descriptor>> GetCommandImages(const acid::GuiBatch &batch) {
+	std::vector<std::shared_ptr<acid::Descriptor>> images;
+	for (const auto &command : batch.GetCommands())
+		images.emplace_back(batch.GetImages()[command.image]);
+	return images;
+}
+}
+
+TEST(GuiBatch, depthSort) {
+	auto a = CreateImage(), b = CreateImage(), c = CreateImage();
+	acid::GuiBatch batch;
+	// Every quad overlaps, so no two can be grouped and the draws follow the sorted order.
+	AddQuad(batch, {0.0f, 0.0f, 1.0f, 1.0f}, a, 0.1f);
+	AddQuad(batch, {0.0f, 0.0f, 1.0f, 1.0f}, b, 0.5f);
+	AddQuad(batch, {0.0f, 0.0f, 1.0f, 1.0f}, c, 0.1f);
+	AddQuad(batch, {0.0f, 0.0f, 1.0f, 1.0f}, a, 0.5f);
+	batch.Build();
+
+	// Farther quads are drawn first, quads at the same depth keep the order they were added in.
+	EXPECT_EQ(GetCommandImages(batch), (std::vector<std::shared_ptr<acid::Descriptor>>{b, a, c}));
+	ASSERT_EQ(batch.GetCommands().size(), 3);
+	EXPECT_EQ(batch.GetCommands()[0].indexCount, 6);
+	EXPECT_EQ(batch.GetCommands()[1].indexCount, 12);
+	EXPECT_FLOAT_EQ(batch.GetVertices()[0].position.z, 0.5f);
+	EXPECT_FLOAT_EQ(batch.GetVertices()[4].position.z, 0.5f);
+	EXPECT_FLOAT_EQ(batch.GetVertices()[12].position.z, 0.1f);
+}
+
+TEST(GuiBatch, overlapOrder) {
+	auto a = CreateImage(), b = CreateImage();
+	acid::GuiBatch batch;
+	AddQuad(batch, {0.0f, 0.0f, 0.5f, 0.5f}, a);
+	AddQuad(batch, {0.25f, 0.25f, 0.75f, 0.75f}, b);
+	AddQuad(batch, {0.5f, 0.5f, 1.0f, 1.0f}, a);
+	batch.Build();
+
+	// The last quad would be drawn under the quad it overlaps if it joined the first draw.
+	EXPECT_EQ(GetCommandImages(batch), (std::vector<std::shared_ptr<acid::Descriptor>>{a, b, a}));
+	EXPECT_EQ(batch.GetQuadCount(), 3);
+	EXPECT_EQ(batch.GetIndices().size(), 18);
+}
+
+TEST(GuiBatch, merge) {
+	auto a = CreateImage(), b = CreateImage();
+	acid::GuiBatch batch;
+	AddQuad(batch, {0.0f, 0.0f, 0.25f, 0.25f}, a);
+	AddQuad(batch, {0.5f, 0.0f, 0.75f, 0.25f}, b);
+	// Quads that only share an edge do not overlap.
+	AddQuad(batch, {0.25f, 0.0f, 0.5f, 0.25f}, a);
+	AddQuad(batch, {0.75f, 0.0f, 1.0f, 0.25f}, b);
+	batch.Build();
+
+	EXPECT_EQ(GetCommandImages(batch), (std::vector<std::shared_ptr<acid::Descriptor>>{a, b}));
+	const auto &commands = batch.GetCommands();
+	EXPECT_EQ(commands[0].firstIndex, 0);
+	EXPECT_EQ(commands[0].indexCount, 12);
+	EXPECT_EQ(commands[1].firstIndex, 12);
+	EXPECT_EQ(commands[1].indexCount, 12);
+
+	// Quads in a draw keep their order, the third quad follows the first.
+	EXPECT_FLOAT_EQ(batch.GetVertices()[4].position.x, 0.25f);
+	EXPECT_EQ(batch.GetIndices()[6], 4);
+
+	// Clearing keeps nothing from the last build.
+	batch.Clear();
+	batch.Build();
+	EXPECT_TRUE(batch.GetCommands().empty());
+	EXPECT_TRUE(batch.GetImages().empty());
+}
+
+TEST(GuiBatch, searchLimit) {
+	auto a = CreateImage();
+	for (uintptr_t between : {31, 32}) {
+		acid::GuiBatch batch;
+		AddQuad(batch, {0.0f, 0.0f, 0.01f, 0.01f}, a);
+		for (uintptr_t i = 0; i < between; i++) {
+			auto x = 0.02f * static_cast<float>(i + 1);
+			AddQuad(batch, {x, 0.0f, x + 0.01f, 0.01f}, CreateImage());
+		}
+		AddQuad(batch, {0.0f, 0.5f, 0.01f, 0.51f}, a);
+		batch.Build();
+
+		// A draw at most 32 back is joined, past that the quad starts a new draw.
+		auto merged = between < 32;
+		EXPECT_EQ(batch.GetCommands().size(), between + (merged ? 1 : 2)) << between;
+		EXPECT_EQ(batch.GetCommands()[0].indexCount, merged ? 12 : 6) << between;
+	}
+}
+
+TEST(GuiBatch, scissors) {
+	auto a = CreateImage();
+	acid::Vector4i scissor(0, 0, 10, 10);
+	acid::GuiBatch batch;
+	AddQuad(batch, {0.0f, 0.0f, 0.25f, 0.25f}, a, 0.0f, scissor);
+	AddQuad(batch, {0.25f, 0.0f, 0.5f, 0.25f}, a);
+	AddQuad(batch, {0.5f, 0.0f, 0.75f, 0.25f}, a, 0.0f, acid::Vector4i(0, 0, 20, 20));
+	AddQuad(batch, {0.75f, 0.0f, 1.0f, 0.25f}, a, 0.0f, scissor);
+	batch.Build();
+
+	// Quads with the same image are drawn apart for each scissor, and joined when the scissor matches.
+	const auto &commands = batch.GetCommands();
+	ASSERT_EQ(commands.size(), 3);
+	EXPECT_EQ(commands[0].scissor, scissor);
+	EXPECT_EQ(commands[0].indexCount, 12);
+	EXPECT_EQ(commands[1].scissor, std::nullopt);
+	EXPECT_EQ(commands[2].scissor, acid::Vector4i(0, 0, 20, 20));
+	EXPECT_EQ(batch.GetImages().size(), 1);
+}
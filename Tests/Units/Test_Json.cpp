@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <Files/Json/Json.hpp>
+
+TEST(Json, parseValues) {
+	acid::Node node;
+	node.ParseString<acid::Json>(R"({"name": "Player", "health": 100, "speed": -2.5e1, "big": 18446744073709551615, "huge": 99999999999999999999,
+		"alive": true, "target": null, "tags": ["a", "b",], "text": "line\nbreak \"quoted\" é😀", "empty": {}})");
+
+	EXPECT_EQ(node.GetType(), acid::Node::Type::Object);
+	EXPECT_EQ(node["name"]->GetType(), acid::Node::Type::String);
+	EXPECT_EQ(node["name"].Get<std::string>(), "Player");
+	EXPECT_EQ(node["health"]->GetType(), acid::Node::Type::Integer);
+	EXPECT_EQ(node["health"].Get<int32_t>(), 100);
+	EXPECT_EQ(node["speed"]->GetType(), acid::Node::Type::Decimal);
+	EXPECT_FLOAT_EQ(node["speed"].Get<float>(), -25.0f);
+	EXPECT_EQ(node["big"]->GetType(), acid::Node::Type::Integer);
+	EXPECT_EQ(node["big"].Get<uint64_t>(), 18446744073709551615ull);
+	EXPECT_EQ(node["huge"]->GetType(), acid::Node::Type::Decimal);
+	EXPECT_TRUE(node["alive"].Get<bool>());
+	EXPECT_EQ(node["target"]->GetType(), acid::Node::Type::Null);
+	EXPECT_EQ(node["tags"]->GetType(), acid::Node::Type::Array);
+	EXPECT_EQ(node["tags"]->GetProperties().size(), 2u);
+	EXPECT_EQ(node["tags"][1].Get<std::string>(), "b");
+	EXPECT_EQ(node["text"].Get<std::string>(), "line\nbreak \"quoted\" \xC3\xA9\xF0\x9F\x98\x80");
+	EXPECT_EQ(node["empty"]->GetType(), acid::Node::Type::Object);
+
+	// Writing and parsing again gives the same tree.
+	acid::Node reparsed;
+	reparsed.ParseString<acid::Json>(node.WriteString<acid::Json>(acid::Node::Format::Beautified));
+	EXPECT_EQ(node, reparsed);
+
+	for (auto invalid : {"{\"a\": }", "{\"a\" 1}", "[1, 2", "{\"a\": tru}", "{\"a\": 1.}", "{\"a\": \"open}", "{} {}", "[01]", "[-01]", "[00.5]"}) {
+		acid::Node failed;
+		EXPECT_THROW(failed.ParseString<acid::Json>(invalid), std::runtime_error) << invalid;
+	}
+}
+
+TEST(Json, numbers) {
+	acid::Node node;
+	node.ParseString<acid::Json>("[0, -0, 0.5, -0.5, 0e1, 10, 100]");
+	ASSERT_EQ(node.GetProperties().size(), 7u);
+	EXPECT_EQ(node[1]->GetType(), acid::Node::Type::Integer);
+	EXPECT_EQ(node[3]->GetType(), acid::Node::Type::Decimal);
+	EXPECT_EQ(node[4]->GetType(), acid::Node::Type::Decimal);
+	EXPECT_EQ(node[6].Get<int32_t>(), 100);
+}
+
+TEST(Json, depthLimit) {
+	auto nested = [](std::size_t depth) {
+		return std::string(depth, '[') + std::string(depth, ']');
+	};
+
+	acid::Node node;
+	node.ParseString<acid::Json>(nested(acid::Node::MaxDepth));
+	EXPECT_EQ(node.GetType(), acid::Node::Type::Array);
+
+	// Deeper documents fail before the recursion can run out of stack.
+	for (auto depth : {std::size_t(acid::Node::MaxDepth) + 1, std::size_t(200000)}) {
+		acid::Node failed;
+		EXPECT_THROW(failed.ParseString<acid::Json>(nested(depth)), std::runtime_error) << depth;
+		EXPECT_THROW(failed.ParseString<acid::Json>(std::string(depth, '[')), std::runtime_error) << depth;
+
+		acid::NodeHandler handler;
+		EXPECT_THROW(acid::Json::Read(nested(depth), handler), std::runtime_error) << depth;
+	}
+}
+
+TEST(Json, unicodeEscapes) {
+	acid::Node node;
+	node.ParseString<acid::Json>(R"({"text": "\u00e9\u20ac\ud83d\ude00"})");
+	EXPECT_EQ(node["text"].Get<std::string>(), "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+
+	// Surrogates must come as a high then low pair.
+	for (auto invalid : {R"(["\ud83d"])", R"(["\ud83dx"])", R"(["\ud83d\u0041"])", R"(["\ud83d\ud83d"])", R"(["\ude00"])"}) {
+		acid::Node failed;
+		EXPECT_THROW(failed.ParseString<acid::Json>(invalid), std::runtime_error) << invalid;
+	}
+}
+
+/**
+ * Records events as a flat list of strings.
+ */
+class RecordingHandler : public acid::NodeHandler {
+public:
+	bool BeginObject(std::string_view name) override {
+		events.emplace_back("{" + std::string(name));
+		return name != "skipped";
+	}
+	void EndObject() override { events.emplace_back("}"); }
+	bool BeginArray(std::string_view name) override {
+		events.emplace_back("[" + std::string(name));
+		return true;
+	}
+	void EndArray() override { events.emplace_back("]"); }
+	void Value(std::string_view name, acid::Node::Type type, std::string_view value) override {
+		events.emplace_back(std::string(name) + "=" + std::string(value));
+	}
+
+	std::vector<std::string> events;
+};
+
+TEST(Json, streamRead) {
+	RecordingHandler handler;
+	acid::Json::Read(R"({"name": "Crate", "escaped\n": "a\tb", "skipped": {"a": [1, 2]}, "values": [1, -2.5e1, true, null, {"x": 1}]})", handler);
+
+	std::vector<std::string> expected = {"{", "name=Crate", "escaped\n=a\tb", "{skipped", "[values", "=1", "=-2.5e1", "=true", "=", "{", "x=1", "}", "]", "}"};
+	EXPECT_EQ(handler.events, expected);
+
+	EXPECT_THROW(acid::Json::Read("{\"a\": [1, 2}", handler), std::runtime_error);
+}
+
+TEST(Json, streamWrite) {
+	std::ostringstream stream;
+	{
+		acid::Json::Writer writer(stream);
+		writer.BeginObject({});
+		writer.Write("name", "Quote \" and \\");
+		writer.Write("count", 3);
+		writer.Write("scale", 0.5f);
+		writer.Write("alive", true);
+		writer.Write("target", nullptr);
+		writer.BeginArray("tags");
+		writer.Write({}, "a");
+		writer.Write({}, "b");
+		writer.EndArray();
+		writer.BeginObject("empty");
+		writer.EndObject();
+		writer.EndObject();
+	}
+	EXPECT_EQ(stream.str(), R"({"name":"Quote \" and \\","count":3,"scale":0.5,"alive":true,"target":null,"tags":["a","b"],"empty":{}})");
+
+	// Writing a parsed node and parsing it again gives the same tree in both formats.
+	acid::Node node;
+	node.ParseString<acid::Json>(stream.str());
+	for (auto format : {acid::Node::Format::Minified, acid::Node::Format::Beautified}) {
+		acid::Node reparsed;
+		reparsed.ParseString<acid::Json>(node.WriteString<acid::Json>(format));
+		EXPECT_EQ(node, reparsed);
+	}
+	EXPECT_EQ(node.WriteString<acid::Json>(acid::Node::Format::Beautified),
+		"{\n  \"name\": \"Quote \\\" and \\\\\",\n  \"count\": 3,\n  \"scale\": 0.5,\n  \"alive\": true,\n  \"target\": null,\n  \"tags\": [\"a\", \"b\"],\n  \"empty\": {}\n}");
+}
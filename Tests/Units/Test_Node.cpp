@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <Files/Json/Json.hpp>
+
+TEST(Node, arenaDocument) {
+	acid::Node copy;
+
+	{
+		acid::Node document;
+		document.ParseString<acid::Json>(R"({"name": "Crate", "mass": 2.5, "escaped": "a\tb", "children": [{"name": "Lid"}, {"name": "Base"}]})");
+		ASSERT_NE(document.GetArena(), nullptr);
+		EXPECT_EQ(document["children"]->GetArena(), document.GetArena());
+		EXPECT_EQ(document["name"]->GetValue(), "Crate");
+		EXPECT_EQ(document["escaped"]->GetValue(), "a\tb");
+
+		// Names are interned, so equal names share storage between documents.
+		EXPECT_EQ(&document["children"][0]->GetProperties()[0].GetName(), &document["children"][1]->GetProperties()[0].GetName());
+
+		// Setting a value replaces the view of the source with a owned copy.
+		document["name"] = "Barrel";
+		EXPECT_EQ(document["name"].Get<std::string>(), "Barrel");
+
+		// Copies are allocated on the heap and stay valid once the document is gone.
+		copy = document;
+		EXPECT_EQ(copy.GetArena(), nullptr);
+	}
+
+	EXPECT_EQ(copy["name"].Get<std::string>(), "Barrel");
+	EXPECT_FLOAT_EQ(copy["mass"].Get<float>(), 2.5f);
+	EXPECT_EQ(copy["children"][1]["name"].Get<std::string>(), "Base");
+
+	// Missing keys on a const node never create properties.
+	const auto &constCopy = copy;
+	EXPECT_FALSE(constCopy["missing"]["deeper"].has_value());
+	EXPECT_FALSE(copy.HasProperty("missing"));
+}
+
+TEST(Node, indexedLookup) {
+	acid::Node node;
+
+	for (uint32_t i = 0; i < 100; i++)
+		node.AddProperty("key" + std::to_string(i)) = i;
+	node.AddProperty("key5") = 500;
+
+	for (uint32_t i = 0; i < 100; i++)
+		EXPECT_EQ(node["key" + std::to_string(i)].Get<uint32_t>(), i);
+	// The first property with a name is found.
+	EXPECT_EQ(node["key5"].Get<uint32_t>(), 5u);
+	EXPECT_FALSE(node.HasProperty("key100"));
+	EXPECT_FALSE(node.HasProperty("neverInterned"));
+
+	node.RemoveProperty("key5");
+	EXPECT_EQ(node["key5"].Get<uint32_t>(), 0u);
+	EXPECT_EQ(node["key6"].Get<uint32_t>(), 6u);
+
+	// Properties added through the list are picked up on the next lookup.
+	node.GetProperties().emplace_back("late") = 7;
+	EXPECT_EQ(node["late"].Get<uint32_t>(), 7u);
+}
+
+TEST(Node, releasedKeys) {
+	acid::Node copy;
+
+	{
+		acid::Node other;
+		{
+			acid::Node document;
+			document.ParseString<acid::Json>(R"({"releasedKeyA": 1, "releasedKeyB": {"releasedKeyC": true}})");
+			EXPECT_NE(acid::NodeKeys::Find("releasedKeyA"), nullptr);
+			EXPECT_NE(acid::NodeKeys::Find("releasedKeyC"), nullptr);
+
+			// A second document using the same names shares them, and keeps them once the first is gone.
+			other.ParseString<acid::Json>(R"({"releasedKeyA": 2})");
+			EXPECT_EQ(&other.GetProperties()[0].GetName(), &document.GetProperties()[0].GetName());
+		}
+
+		EXPECT_NE(acid::NodeKeys::Find("releasedKeyA"), nullptr);
+		EXPECT_EQ(acid::NodeKeys::Find("releasedKeyC"), nullptr);
+
+		// Heap copies hold their own names.
+		copy = other;
+	}
+
+	EXPECT_EQ(acid::NodeKeys::Find("releasedKeyB"), nullptr);
+	EXPECT_EQ(copy.GetProperties()[0].GetName(), "releasedKeyA");
+	EXPECT_NE(acid::NodeKeys::Find("releasedKeyA"), nullptr);
+
+	// And release them once every copy is gone.
+	{
+		auto moved = std::move(copy.GetProperties()[0]);
+		copy.Clear();
+		EXPECT_NE(acid::NodeKeys::Find("releasedKeyA"), nullptr);
+	}
+	EXPECT_EQ(acid::NodeKeys::Find("releasedKeyA"), nullptr);
+
+	{
+		acid::Node heap("releasedKeyF");
+		heap.AddProperty("releasedKeyG", acid::Node()).SetName("releasedKeyH");
+		auto heapCopy = heap;
+		EXPECT_EQ(acid::NodeKeys::Find("releasedKeyG"), nullptr);
+		EXPECT_NE(acid::NodeKeys::Find("releasedKeyH"), nullptr);
+	}
+	EXPECT_EQ(acid::NodeKeys::Find("releasedKeyF"), nullptr);
+	EXPECT_EQ(acid::NodeKeys::Find("releasedKeyG"), nullptr);
+	EXPECT_EQ(acid::NodeKeys::Find("releasedKeyH"), nullptr);
+
+	// The table does not grow with repeated documents of the same schema.
+	auto count = acid::NodeKeys::GetCount();
+	for (uint32_t i = 0; i < 8; i++) {
+		acid::Node document;
+		document.ParseString<acid::Json>(R"({"releasedKeyD": {"releasedKeyE": [1, 2]}})");
+	}
+	EXPECT_EQ(acid::NodeKeys::GetCount(), count);
+}
+
+TEST(Node, movedOutOfDocument) {
+	std::unique_ptr<acid::Node> moved;
+	acid::Node assigned;
+
+	{
+		acid::Node document;
+		document.ParseString<acid::Json>(R"({"crate": {"name": "Crate", "lid": {"hinged": true}}, "barrel": {"name": "Barrel"}})");
+
+		// Nodes moved out of a document do not reference its arena, so they outlive it.
+		moved = std::make_unique<acid::Node>(std::move(document.GetProperties()[0]));
+		EXPECT_EQ(moved->GetArena(), nullptr);
+		EXPECT_EQ((*moved)["lid"]->GetArena(), nullptr);
+		assigned = std::move(document.GetProperties()[1]);
+		EXPECT_EQ(assigned.GetArena(), nullptr);
+	}
+
+	EXPECT_EQ(moved->GetName(), "crate");
+	EXPECT_EQ((*moved)["name"].Get<std::string>(), "Crate");
+	EXPECT_TRUE((*moved)["lid"]["hinged"].Get<bool>());
+	EXPECT_EQ(assigned["name"]->GetValue(), "Barrel");
+	EXPECT_EQ(assigned["name"]->GetValueView(), "Barrel");
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <Files/Json/Json.hpp>
+#include <Files/NodeReflect.hpp>
+
+namespace {
+enum class Shape {
+	Cube, Sphere
+};
+
+class Emitter {
+public:
+	static constexpr auto GetFields() {
+		return std::make_tuple(acid::NodeField("radius", &Emitter::radius), acid::NodeField("shape", &Emitter::shape));
+	}
+
+	float radius = 1.0f;
+	Shape shape = Shape::Cube;
+};
+
+class System {
+public:
+	static constexpr auto GetFields() {
+		return std::make_tuple(acid::NodeField("name", &System::name), acid::NodeField("pps", &System::pps), acid::NodeField("count", &System::count),
+			acid::NodeField("randomRotation", &System::randomRotation), acid::NodeField("emitter", &System::emitter),
+			acid::NodeField("stages", &System::stages));
+	}
+
+	bool operator==(const System &rhs) const {
+		return name == rhs.name && pps == rhs.pps && count == rhs.count && randomRotation == rhs.randomRotation && emitter.radius == rhs.emitter.radius &&
+			emitter.shape == rhs.emitter.shape && stages == rhs.stages;
+	}
+
+	std::string name;
+	float pps = 5.0f;
+	int32_t count = 0;
+	bool randomRotation = false;
+	Emitter emitter;
+	std::vector<float> stages;
+};
+
+System CreateSystem() {
+	System system;
+	system.name = "Sparks";
+	system.pps = 12.5f;
+	system.count = -3;
+	system.randomRotation = true;
+	system.emitter.radius = 2.0f;
+	system.emitter.shape = Shape::Sphere;
+	system.stages = {0.25f, 0.5f, 1.0f};
+	return system;
+}
+}
+
+TEST(NodeReflect, fields) {
+	static_assert(acid::is_reflected_v<System>);
+	static_assert(!acid::is_reflected_v<std::string>);
+	static_assert(acid::NodeReflect<System>::FieldCount == 6);
+	static_assert(std::get<1>(acid::NodeReflect<System>::Fields).hash == acid::String::fnv1a_32("pps"));
+}
+
+TEST(NodeReflect, nodeRoundTrip) {
+	auto system = CreateSystem();
+	acid::Node node;
+	node << system;
+	EXPECT_EQ(node["pps"].Get<float>(), 12.5f);
+	EXPECT_EQ(node["emitter"]["shape"].Get<int32_t>(), 1);
+
+	acid::Node parsed;
+	parsed.ParseString<acid::Json>(node.WriteString<acid::Json>());
+	EXPECT_EQ(parsed.Get<System>(), system);
+
+	// Out of order, unknown and missing properties are all read, missing fields keep their values.
+	acid::Node shuffled;
+	shuffled.ParseString<acid::Json>(R"({"unknown": 1, "count": 7, "name": "Smoke", "extra": {"a": [1]}, "pps": 2})");
+	auto read = shuffled.Get<System>();
+	EXPECT_EQ(read.name, "Smoke");
+	EXPECT_EQ(read.count, 7);
+	EXPECT_EQ(read.pps, 2.0f);
+	EXPECT_EQ(read.emitter.radius, 1.0f);
+
+	// Properties already in a node, such as a factory type, are kept and fields are replaced.
+	acid::Node typed;
+	typed["type"].Set(std::string("system"));
+	typed["pps"].Set(1.0f);
+	typed << system;
+	EXPECT_EQ(typed["type"].Get<std::string>(), "system");
+	EXPECT_EQ(typed["pps"].Get<float>(), 12.5f);
+	EXPECT_EQ(typed.GetProperties().size(), 7u);
+}
+
+TEST(NodeReflect, streamRoundTrip) {
+	auto system = CreateSystem();
+	std::ostringstream stream;
+	{
+		acid::Json::Writer writer(stream);
+		acid::NodeReflect<System>::Write(writer, {}, system);
+	}
+
+	System read;
+	acid::NodeReflect<System>::Reader reader(read);
+	acid::Json::Read(stream.str(), reader);
+	EXPECT_EQ(read, system);
+
+	// Streaming and node writes produce the same document.
+	acid::Node node;
+	node << system;
+	EXPECT_EQ(stream.str(), node.WriteString<acid::Json>());
+
+	System partial;
+	acid::NodeReflect<System>::Reader partialReader(partial);
+	acid::Json::Read(R"({"skipped": {"pps": 3}, "emitter": {"radius": 4}, "stages": [], "pps": 9, "name": ""})", partialReader);
+	EXPECT_EQ(partial.pps, 9.0f);
+	EXPECT_EQ(partial.emitter.radius, 4.0f);
+	EXPECT_TRUE(partial.name.empty());
+	EXPECT_TRUE(partial.stages.empty());
+}
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <Resources/Resources.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+std::atomic<int> sourceValue = 0;
+/// While set, reloads read the source and then wait, so changes can arrive while a copy is loading.
+std::atomic<bool> reloadsHeld = false;
+std::atomic<int> reloadsStarted = 0;
+std::atomic<int> copiesDestroyed = 0;
+std::thread::id copyDestroyedThread;
+
+class CountingResource : public acid::Resource {
+public:
+	explicit CountingResource(std::filesystem::path filename) :
+		filename(std::move(filename)),
+		value(sourceValue) {
+		dependencies = {this->filename};
+	}
+
+	~CountingResource() {
+		if (copy) {
+			copyDestroyedThread = std::this_thread::get_id();
+			copiesDestroyed++;
+		}
+	}
+
+	std::type_index GetTypeIndex() const override { return typeid(CountingResource); }
+
+	std::shared_ptr<Resource> Reload() const override {
+		if (sourceValue < 0)
+			throw std::runtime_error("Source could not be read");
+		auto copy = std::make_shared<CountingResource>(filename);
+		copy->copy = true;
+		reloadsStarted++;
+		while (reloadsHeld)
+			std::this_thread::sleep_for(1ms);
+		return copy;
+	}
+
+	void Upload() override {
+		uploadThread = std::this_thread::get_id();
+	}
+
+	void Swap(Resource &other) override {
+		Resource::Swap(other);
+		std::swap(value, dynamic_cast<CountingResource &>(other).value);
+		std::swap(uploadThread, dynamic_cast<CountingResource &>(other).uploadThread);
+	}
+
+	std::filesystem::path filename;
+	int value;
+	std::thread::id uploadThread;
+	bool copy = false;
+};
+
+void UpdateUntil(acid::Resources &resources, const std::function<bool()> &done) {
+	for (uint32_t i = 0; i < 200 && !done(); i++) {
+		std::this_thread::sleep_for(5ms);
+		resources.Update();
+	}
+}
+}
+
+TEST(Resources, reloadTracked) {
+	acid::Resources resources;
+	sourceValue = 1;
+	CountingResource shader("Shaders/Default.frag");
+	CountingResource other("Shaders/Other.frag");
+	resources.Track(&shader);
+	resources.Track(&other);
+
+	// Changes are matched by normalized path, absolute paths that do not match are ignored.
+	sourceValue = 2;
+	resources.Reload({"Shaders/./Default.frag", "/unrelated/Shaders/Other.vert"});
+	UpdateUntil(resources, [&] { return shader.value == 2; });
+	EXPECT_EQ(shader.value, 2);
+	EXPECT_EQ(shader.GetDependencies().front(), "Shaders/Default.frag");
+	EXPECT_EQ(other.value, 1);
+
+	resources.Untrack(&shader);
+	resources.Untrack(&other);
+}
+
+TEST(Resources, reloadUploadsOnUpdate) {
+	acid::Resources resources;
+	sourceValue = 1;
+	CountingResource shader("Shaders/Default.frag");
+	resources.Track(&shader);
+
+	// Copies are read on a resource thread, but create their device objects on the thread that updates resources.
+	sourceValue = 2;
+	resources.Reload({"Shaders/Default.frag"});
+	UpdateUntil(resources, [&] { return shader.value == 2; });
+	EXPECT_EQ(shader.value, 2);
+	EXPECT_EQ(shader.uploadThread, std::this_thread::get_id());
+
+	resources.Untrack(&shader);
+}
+
+TEST(Resources, reloadFound) {
+	acid::Resources resources;
+	sourceValue = 1;
+	auto texture = std::make_shared<CountingResource>("Textures/Tile.png");
+	acid::Node node;
+	node["filename"] = "Textures/Tile.png";
+	resources.Add(node, texture);
+
+	sourceValue = 3;
+	resources.Reload({"Textures/Tile.png"});
+	UpdateUntil(resources, [&] { return texture->value == 3; });
+	EXPECT_EQ(texture->value, 3);
+}
+
+TEST(Resources, reloadFailureKeepsContents) {
+	acid::Resources resources;
+	sourceValue = 1;
+	CountingResource shader("Shaders/Default.frag");
+	resources.Track(&shader);
+
+	sourceValue = -1;
+	resources.Reload({"Shaders/Default.frag"});
+	for (uint32_t i = 0; i < 20; i++) {
+		std::this_thread::sleep_for(5ms);
+		resources.Update();
+	}
+	EXPECT_EQ(shader.value, 1);
+
+	// A pending reload is abandoned by untracking, so the resource can be destroyed.
+	sourceValue = 4;
+	resources.Reload({"Shaders/Default.frag"});
+	resources.Untrack(&shader);
+	resources.Update();
+	EXPECT_EQ(shader.value, 1);
+}
+
+TEST(Resources, reloadOverlapping) {
+	acid::Resources resources;
+	sourceValue = 1;
+	reloadsStarted = 0;
+	CountingResource shader("Shaders/Default.frag");
+	resources.Track(&shader);
+
+	sourceValue = 2;
+	reloadsHeld = true;
+	resources.Reload({"Shaders/Default.frag"});
+	while (reloadsStarted == 0)
+		std::this_thread::sleep_for(1ms);
+
+	// The copy loading has already read the source, so the second change needs a reload of its own.
+	sourceValue = 3;
+	resources.Reload({"Shaders/Default.frag"});
+	reloadsHeld = false;
+	UpdateUntil(resources, [&] { return shader.value == 3; });
+	EXPECT_EQ(shader.value, 3);
+	EXPECT_EQ(reloadsStarted, 2);
+
+	// Once swapped nothing is reloaded again.
+	for (uint32_t i = 0; i < 10; i++) {
+		std::this_thread::sleep_for(5ms);
+		resources.Update();
+	}
+	EXPECT_EQ(reloadsStarted, 2);
+
+	resources.Untrack(&shader);
+}
+
+TEST(Resources, reloadAbandoned) {
+	acid::Resources resources;
+	sourceValue = 1;
+	reloadsStarted = 0;
+	copiesDestroyed = 0;
+	auto shader = std::make_unique<CountingResource>("Shaders/Default.frag");
+	resources.Track(shader.get());
+
+	sourceValue = 2;
+	reloadsHeld = true;
+	resources.Reload({"Shaders/Default.frag"});
+	while (reloadsStarted == 0)
+		std::this_thread::sleep_for(1ms);
+
+	// Untracking on another thread returns once the running reload stops reading, without waiting on its future.
+	std::thread untrack([&] {
+		resources.Untrack(shader.get());
+	});
+	std::this_thread::sleep_for(10ms);
+	reloadsHeld = false;
+	untrack.join();
+	shader.reset();
+
+	// The abandoned copy is dropped on the main thread, and never swapped into the destroyed resource.
+	UpdateUntil(resources, [&] { return copiesDestroyed == 1; });
+	EXPECT_EQ(copiesDestroyed, 1);
+	EXPECT_EQ(copyDestroyedThread, std::this_thread::get_id());
+}
+
+TEST(Resources, changedFilenames) {
+	// Observers report absolute paths, search paths are often relative to the working directory.
+	auto root = std::filesystem::path("Resources") / "Engine";
+	auto absoluteRoot = std::filesystem::absolute(root);
+	auto filenames = acid::Resources::GetChangedFilenames({
+		{absoluteRoot / "Shaders" / "." / "Default.frag", acid::FileObserver::Status::Modified},
+		{absoluteRoot / "Textures" / "Old.png", acid::FileObserver::Status::Erased}
+	}, root / ".");
+
+	ASSERT_EQ(filenames.size(), 2u);
+	EXPECT_EQ(filenames[0], (absoluteRoot / "Shaders" / "Default.frag").lexically_normal());
+	EXPECT_EQ(filenames[1].generic_string(), "Shaders/Default.frag");
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <Maths/Transform.hpp>
+#include <Scenes/SceneLoader.hpp>
+
+TEST(SceneLoader, minimalScene) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidSceneLoader";
+	std::filesystem::create_directories(directory);
+	std::ofstream(directory / "Box.json") << R"({"transform": {"position": {"x": 1, "y": 2, "z": 3}}})";
+	std::ofstream(directory / "Empty.json") << R"({"unknown": {}})";
+
+	acid::SceneStructure structure;
+	acid::SceneLoader loader(structure);
+	// The same prefab is listed twice, once through a path that normalises to it.
+	auto entities = loader.Load({directory / "Box.json", directory / "Empty.json", directory / "." / "Box.json", directory / "Missing.json"});
+
+	ASSERT_EQ(entities.size(), 4);
+	EXPECT_EQ(structure.GetSize(), 4);
+	EXPECT_EQ(loader.GetTimings().entityCount, 4);
+	EXPECT_EQ(loader.GetTimings().prefabCount, 3);
+
+	// Entities are returned in the order of the files, prefabs shared by entities give each their own components.
+	for (auto i : {0, 2}) {
+		auto transform = entities[i]->GetComponent<acid::Transform>();
+		ASSERT_NE(transform, nullptr);
+		EXPECT_EQ(transform->GetLocalPosition(), acid::Vector3f(1.0f, 2.0f, 3.0f));
+	}
+	EXPECT_NE(entities[0]->GetComponent<acid::Transform>(), entities[2]->GetComponent<acid::Transform>());
+
+	// Unknown components and missing files are skipped, leaving an entity without components.
+	EXPECT_TRUE(entities[1]->GetComponents().empty());
+	EXPECT_TRUE(entities[3]->GetComponents().empty());
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST(SceneLoader, malformedScene) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidSceneLoaderMalformed";
+	std::filesystem::create_directories(directory);
+	std::ofstream(directory / "Box.json") << R"({"transform": {"position": {"x": 1}}})";
+	std::ofstream(directory / "Broken.json") << R"({"transform": {"position": )";
+
+	acid::SceneStructure structure;
+	acid::SceneLoader loader(structure);
+	EXPECT_THROW(loader.Load({directory / "Box.json", directory / "Broken.json"}), std::runtime_error);
+
+	// A prefab that fails to parse stops the load before any entity is added.
+	EXPECT_EQ(structure.GetSize(), 0);
+
+	// The structure is still usable once the file is fixed.
+	std::ofstream(directory / "Broken.json") << R"({"transform": {}})";
+	auto entities = loader.Load({directory / "Box.json", directory / "Broken.json"});
+	ASSERT_EQ(entities.size(), 2);
+	EXPECT_EQ(structure.GetSize(), 2);
+	EXPECT_NE(entities[1]->GetComponent<acid::Transform>(), nullptr);
+
+	std::filesystem::remove_all(directory);
+}
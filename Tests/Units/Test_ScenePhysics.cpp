@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <btBulletDynamicsCommon.h>
+#include <Scenes/ScenePhysics.hpp>
+
+TEST(ScenePhysics, fixedTimestep) {
+	acid::ScenePhysics physics;
+	physics.SetFixedTimestep(acid::Time::Seconds(0.25f));
+
+	// Frames shorter than the timestep are accumulated until a whole substep can be taken.
+	physics.Update(acid::Time::Seconds(0.125f));
+	EXPECT_EQ(physics.GetSubSteps(), 0);
+	physics.Update(acid::Time::Seconds(0.25f));
+	EXPECT_EQ(physics.GetSubSteps(), 1);
+
+	// The remaining eighth of a step carries over into the next frame.
+	physics.Update(acid::Time::Seconds(0.625f));
+	EXPECT_EQ(physics.GetSubSteps(), 3);
+}
+
+TEST(ScenePhysics, maxSubSteps) {
+	acid::ScenePhysics physics;
+	physics.SetFixedTimestep(acid::Time::Seconds(0.25f));
+	physics.SetMaxSubSteps(2);
+
+	// A long frame is clamped to the max substeps, the dropped time is not simulated later.
+	physics.Update(acid::Time::Seconds(2.0f));
+	EXPECT_EQ(physics.GetSubSteps(), 2);
+	physics.Update(acid::Time::Seconds(0.125f));
+	EXPECT_EQ(physics.GetSubSteps(), 0);
+}
+
+TEST(ScenePhysics, parallelStep) {
+	// Without the resources module the task scheduler runs Bullet's parallel loops on the calling thread.
+	for (auto threading : {acid::ScenePhysics::Threading::Parallel, acid::ScenePhysics::Threading::Async}) {
+		btSphereShape sphere(0.5f);
+		btRigidBody body(1.0f, nullptr, &sphere, btVector3(0.4f, 0.4f, 0.4f));
+		body.setActivationState(DISABLE_DEACTIVATION);
+
+		acid::ScenePhysics physics(threading);
+		physics.SetFixedTimestep(acid::Time::Seconds(0.25f));
+		physics.GetDynamicsWorld()->addRigidBody(&body);
+
+		physics.Update(acid::Time::Seconds(0.5f));
+		if (threading == acid::ScenePhysics::Threading::Async) {
+			// The step accumulated by the update is run on the physics thread.
+			physics.PostUpdate();
+			physics.WaitForStep();
+		}
+
+		EXPECT_EQ(physics.GetSubSteps(), 2);
+		EXPECT_LT(body.getLinearVelocity().y(), -4.0f);
+		EXPECT_LT(body.getWorldTransform().getOrigin().y(), 0.0f);
+	}
+}
+
+TEST(ScenePhysics, removeCollisionObject) {
+	btBoxShape box(btVector3(0.5f, 0.5f, 0.5f));
+	btCollisionObject ground;
+	ground.setCollisionShape(&box);
+
+	acid::ScenePhysics physics;
+	physics.SetFixedTimestep(acid::Time::Seconds(0.25f));
+	physics.GetDynamicsWorld()->addCollisionObject(&ground);
+
+	// The body overlaps the ground, so the first step puts the pair in contact.
+	auto body = std::make_unique<btRigidBody>(1.0f, nullptr, &box, btVector3(0.2f, 0.2f, 0.2f));
+	body->setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0.0f, 0.5f, 0.0f)));
+	physics.GetDynamicsWorld()->addRigidBody(body.get());
+	physics.Update(acid::Time::Seconds(0.25f));
+	ASSERT_GT(physics.GetDynamicsWorld()->getDispatcher()->getNumManifolds(), 0);
+
+	// The pair is purged with the body, the next update does not read the freed body to end the contact.
+	physics.RemoveCollisionObject(body.get());
+	body.reset();
+	physics.Update(acid::Time::Seconds(0.25f));
+	EXPECT_EQ(physics.GetDynamicsWorld()->getNumCollisionObjects(), 1);
+}
+
+TEST(ScenePhysics, queryRays) {
+	// Objects are declared before the world, which removes them from itself when destroyed.
+	btBoxShape box(btVector3(0.5f, 0.5f, 0.5f));
+	btCollisionObject nearObject, farObject;
+	nearObject.setCollisionShape(&box);
+	nearObject.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0.0f, 0.0f, 2.0f)));
+	farObject.setCollisionShape(&box);
+	farObject.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0.0f, 0.0f, 5.0f)));
+
+	// Hits are matched by user pointer, which only has to be a distinct address.
+	auto nearTag = reinterpret_cast<acid::CollisionObject *>(&nearObject);
+	auto farTag = reinterpret_cast<acid::CollisionObject *>(&farObject);
+	nearObject.setUserPointer(nearTag);
+	farObject.setUserPointer(farTag);
+
+	acid::ScenePhysics physics;
+	physics.GetDynamicsWorld()->addCollisionObject(&nearObject);
+	physics.GetDynamicsWorld()->addCollisionObject(&farObject);
+
+	// Enough queries for several jobs, odd rays miss and every fourth ray returns all hits.
+	std::vector<acid::PhysicsQuery> queries;
+	for (uint32_t i = 0; i < 40; i++) {
+		auto x = i % 2 == 0 ? 0.0f : 10.0f;
+		queries.emplace_back(acid::PhysicsQuery::Ray({x, 0.0f, 0.0f}, {x, 0.0f, 10.0f}, i % 4 == 0));
+	}
+
+	acid::PhysicsQueryResults results;
+	physics.Query(queries, results);
+	ASSERT_EQ(results.GetQueryCount(), 40);
+	EXPECT_EQ(results.GetHits().size(), 30);
+
+	for (uint32_t i = 0; i < 40; i++) {
+		if (i % 2 != 0) {
+			EXPECT_FALSE(results.HasHit(i));
+			continue;
+		}
+
+		auto hits = results.GetHits(i);
+		ASSERT_EQ(results.GetHitCount(i), i % 4 == 0 ? 2 : 1);
+		EXPECT_EQ(hits[0].collisionObject, nearTag);
+		EXPECT_NEAR(hits[0].fraction, 0.15f, 1e-4f);
+		EXPECT_NEAR(hits[0].pointWorld.z, 1.5f, 1e-4f);
+
+		if (i % 4 == 0) {
+			EXPECT_EQ(hits[1].collisionObject, farTag);
+			EXPECT_NEAR(hits[1].fraction, 0.45f, 1e-4f);
+		}
+	}
+
+	// Results are reset when reused for a smaller batch.
+	queries.resize(2);
+	physics.Query(queries, results);
+	ASSERT_EQ(results.GetQueryCount(), 2);
+	EXPECT_EQ(results.GetHitCount(0), 2);
+	EXPECT_FALSE(results.HasHit(1));
+	EXPECT_EQ(results.GetHits().size(), 2);
+}
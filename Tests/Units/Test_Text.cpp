@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <Fonts/Text.hpp>
+
+namespace {
+/**
+ * Font type with glyphs a to z ten pixels across and a space half as wide, as a font file is not loaded in tests.
+ */
+class LayoutFontType : public acid::FontType {
+public:
+	LayoutFontType() :
+		FontType("", 10, false) {
+		ascent = 8.0f;
+		lineHeight = 12.0f;
+
+		Glyph space;
+		space.codepoint = ' ';
+		space.advance = 5.0f;
+		AddGlyph(space, nullptr);
+
+		for (char32_t codepoint = 'a'; codepoint <= 'z'; codepoint++) {
+			Glyph glyph;
+			glyph.codepoint = codepoint;
+			glyph.advance = 10.0f;
+			glyph.offset = {0.0f, -8.0f};
+			glyph.hasImage = true;
+			AddGlyph(glyph, std::make_unique<acid::Bitmap>(std::make_unique<uint8_t[]>(10 * 10 * 4), acid::Vector2ui(10), acid::PixelFormat::R8G8B8A8Unorm));
+		}
+	}
+};
+
+class LayoutText : public acid::Text {
+public:
+	LayoutText(const std::string &string, Justify justify) {
+		SetFontType(std::make_shared<LayoutFontType>());
+		SetFontSize(10.0f);
+		SetString(string);
+		SetJustify(justify);
+	}
+
+	using Text::LoadText;
+
+	std::vector<float> GetQuadsX() const {
+		std::vector<float> x;
+		for (const auto &quad : GetQuads())
+			x.emplace_back(quad.position.x);
+		return x;
+	}
+};
+
+std::u32string Decode(std::string_view string) {
+	std::u32string codepoints;
+	acid::Text::DecodeUtf8(string, codepoints);
+	return codepoints;
+}
+}
+
+TEST(Text, decodeUtf8) {
+	EXPECT_EQ(Decode("ab\n"), U"ab\n");
+	EXPECT_EQ(Decode("\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"), U"\u00e9\u20ac\U0001f600");
+	EXPECT_EQ(Decode("\xf4\x8f\xbf\xbf"), U"\U0010ffff");
+	// Tabs are expanded and other control characters are skipped.
+	EXPECT_EQ(Decode("a\tb\rc\x01"), U"a    bc");
+}
+
+TEST(Text, decodeUtf8Invalid) {
+	// Each byte of a ill-formed sequence is replaced.
+	EXPECT_EQ(Decode("\xc0\x80"), U"\ufffd\ufffd");
+	EXPECT_EQ(Decode("\xc1\xbf"), U"\ufffd\ufffd");
+	EXPECT_EQ(Decode("\xe0\x80\x80"), U"\ufffd\ufffd\ufffd");
+	EXPECT_EQ(Decode("\xf0\x8f\xbf\xbf"), U"\ufffd\ufffd\ufffd\ufffd");
+	// Surrogates.
+	EXPECT_EQ(Decode("\xed\xa0\x80"), U"\ufffd\ufffd\ufffd");
+	EXPECT_EQ(Decode("\xed\x9f\xbf"), U"\ud7ff");
+	// Codepoints past U+10FFFF, and leads that can only start them.
+	EXPECT_EQ(Decode("\xf4\x90\x80\x80"), U"\ufffd\ufffd\ufffd\ufffd");
+	EXPECT_EQ(Decode("\xf5\x80\x80\x80"), U"\ufffd\ufffd\ufffd\ufffd");
+	EXPECT_EQ(Decode("\xf7\xbf\xbf\xbf"), U"\ufffd\ufffd\ufffd\ufffd");
+	EXPECT_EQ(Decode("\xf8\x88\x80\x80\x80"), U"\ufffd\ufffd\ufffd\ufffd\ufffd");
+	// Sequences cut short, or interrupted by another character.
+	EXPECT_EQ(Decode("a\xe2\x82"), U"a\ufffd\ufffd");
+	EXPECT_EQ(Decode("\xe2" "a"), U"\ufffda");
+}
+
+TEST(Text, wrap) {
+	LayoutText text("aa bb cc", acid::Text::Justify::Left);
+	text.LoadText(55.0f);
+
+	// The third word would pass the width, so it starts the next line.
+	EXPECT_EQ(text.GetNumberLines(), 2);
+	EXPECT_EQ(text.GetQuadsX(), (std::vector<float>{0.0f, 10.0f, 25.0f, 35.0f, 0.0f, 10.0f}));
+	EXPECT_FLOAT_EQ(text.GetQuads()[4].position.y - text.GetQuads()[0].position.y, 12.0f);
+	EXPECT_FLOAT_EQ(text.GetQuads()[0].position.y, 0.0f);
+
+	// Without a width lines only end at new lines, spaces only move the pen.
+	text.LoadText(0.0f);
+	EXPECT_EQ(text.GetNumberLines(), 1);
+	EXPECT_EQ(text.GetQuads().size(), 6);
+	EXPECT_FLOAT_EQ(text.GetQuads()[5].position.x, 60.0f);
+
+	// A word wider than the line is kept on its own line.
+	LayoutText longWord("a bbbbbbbb\nc", acid::Text::Justify::Left);
+	longWord.LoadText(55.0f);
+	EXPECT_EQ(longWord.GetNumberLines(), 3);
+	EXPECT_FLOAT_EQ(longWord.GetQuads()[1].position.x, 0.0f);
+	EXPECT_FLOAT_EQ(longWord.GetQuads()[8].position.x, 70.0f);
+	EXPECT_FLOAT_EQ(longWord.GetQuads()[9].position.x, 0.0f);
+	EXPECT_FLOAT_EQ(longWord.GetQuads()[9].position.y - longWord.GetQuads()[0].position.y, 24.0f);
+}
+
+TEST(Text, justify) {
+	LayoutText right("aa bb cc", acid::Text::Justify::Right);
+	right.LoadText(55.0f);
+	EXPECT_EQ(right.GetQuadsX(), (std::vector<float>{10.0f, 20.0f, 35.0f, 45.0f, 35.0f, 45.0f}));
+
+	LayoutText centre("aa bb cc", acid::Text::Justify::Centre);
+	centre.LoadText(55.0f);
+	EXPECT_EQ(centre.GetQuadsX(), (std::vector<float>{5.0f, 15.0f, 30.0f, 40.0f, 17.5f, 27.5f}));
+
+	// Wrapped lines are stretched across the width between words, the last line of a paragraph is not.
+	LayoutText fully("aa bb cc", acid::Text::Justify::Fully);
+	fully.LoadText(55.0f);
+	EXPECT_EQ(fully.GetQuadsX(), (std::vector<float>{0.0f, 10.0f, 35.0f, 45.0f, 0.0f, 10.0f}));
+
+	// Kerning is added after every character, including spaces.
+	LayoutText kerned("ab c", acid::Text::Justify::Left);
+	kerned.SetKerning(1.0f);
+	kerned.LoadText(0.0f);
+	EXPECT_EQ(kerned.GetQuadsX(), (std::vector<float>{0.0f, 11.0f, 28.0f}));
+}
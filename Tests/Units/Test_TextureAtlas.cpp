@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <Bitmaps/Bitmap.hpp>
+#include <Graphics/Images/TextureAtlas.hpp>
+
+namespace {
+/**
+ * Atlas that records the work it would give the device instead of doing it.
+ */
+class RecordingAtlas : public acid::TextureAtlas {
+public:
+	using TextureAtlas::TextureAtlas;
+
+	std::vector<uint32_t> grows;
+	std::vector<std::vector<Region>> uploadBatches;
+	std::vector<std::vector<acid::Vector2ui>> uploadSizes;
+	/// The pixels of the last image uploaded, with its padding.
+	std::vector<uint8_t> lastPixels;
+
+protected:
+	void Grow(uint32_t layerCount) override {
+		grows.emplace_back(layerCount);
+	}
+
+	void Upload(const std::vector<PendingUpload> &uploads) override {
+		auto &regions = uploadBatches.emplace_back();
+		auto &sizes = uploadSizes.emplace_back();
+		for (const auto &upload : uploads) {
+			regions.emplace_back(upload.region);
+			sizes.emplace_back(upload.bitmap->GetSize());
+			lastPixels.assign(upload.bitmap->GetData().get(), upload.bitmap->GetData().get() + upload.bitmap->GetLength());
+		}
+	}
+};
+
+std::unique_ptr<acid::Bitmap> CreateBitmap(const acid::Vector2ui &size) {
+	auto bitmap = std::make_unique<acid::Bitmap>(std::make_unique<uint8_t[]>(size.x * size.y * 4), size, acid::PixelFormat::R8G8B8A8Unorm);
+	for (uint32_t i = 0; i < size.x * size.y * 4; i++)
+		bitmap->GetData()[i] = static_cast<uint8_t>(i / 4);
+	return bitmap;
+}
+}
+
+TEST(TextureAtlas, grow) {
+	// Each image fills a whole layer with its padding.
+	RecordingAtlas atlas({64, 64}, 3);
+	auto bitmap = CreateBitmap({62, 62});
+
+	auto a = atlas.Add("a", *bitmap);
+	auto b = atlas.Add("b", *bitmap);
+	ASSERT_TRUE(a && b);
+	EXPECT_EQ(a->layer, 0);
+	EXPECT_EQ(b->layer, 1);
+	EXPECT_EQ(a->position, acid::Vector2ui(1, 1));
+	EXPECT_EQ(atlas.GetLayerCount(), 2);
+
+	// Layers added between updates grow the image once, before the images in them are uploaded.
+	EXPECT_TRUE(atlas.grows.empty());
+	atlas.Update();
+	EXPECT_EQ(atlas.grows, std::vector<uint32_t>{2});
+
+	ASSERT_TRUE(atlas.Add("c", *bitmap));
+	atlas.Update();
+	EXPECT_EQ(atlas.grows, (std::vector<uint32_t>{2, 3}));
+
+	// Past the layer limit nothing more fits until images can be evicted.
+	EXPECT_FALSE(atlas.Add("d", *bitmap));
+	atlas.Update();
+	EXPECT_EQ(atlas.grows.size(), 2);
+	EXPECT_EQ(atlas.GetLayerCount(), 3);
+}
+
+TEST(TextureAtlas, retire) {
+	RecordingAtlas atlas({64, 64}, 1);
+	auto bitmap = CreateBitmap({62, 62});
+
+	auto a = atlas.Add("a", *bitmap);
+	ASSERT_TRUE(a);
+	atlas.Update();
+	EXPECT_TRUE(atlas.Remove("a"));
+	EXPECT_FALSE(atlas.Remove("a"));
+	EXPECT_FALSE(atlas.Find("a"));
+
+	// The space of a removed image is held while frames in flight may still be drawing it.
+	EXPECT_FALSE(atlas.Add("b", *bitmap));
+	uint32_t updates = 0;
+	while (!atlas.Add("b", *bitmap)) {
+		atlas.Update();
+		ASSERT_LT(++updates, 100);
+	}
+	EXPECT_GT(updates, 2);
+	EXPECT_EQ(atlas.Find("b")->position, a->position);
+}
+
+TEST(TextureAtlas, evict) {
+	RecordingAtlas atlas({64, 64}, 1);
+	auto bitmap = CreateBitmap({62, 62});
+
+	ASSERT_TRUE(atlas.Add("a", *bitmap));
+
+	// A image found every update is never evicted.
+	for (uint32_t i = 0; i < 200; i++) {
+		atlas.Update();
+		ASSERT_TRUE(atlas.Find("a"));
+	}
+	EXPECT_FALSE(atlas.Add("b", *bitmap));
+
+	// Once unused for long enough its space is given to the next image straight away.
+	for (uint32_t i = 0; i < 200; i++)
+		atlas.Update();
+	EXPECT_TRUE(atlas.Add("b", *bitmap));
+	EXPECT_FALSE(atlas.Find("a"));
+	EXPECT_EQ(atlas.GetEntryCount(), 1);
+}
+
+TEST(TextureAtlas, uploadBatching) {
+	RecordingAtlas atlas({64, 64}, 1, 1);
+	auto small = CreateBitmap({2, 2});
+
+	ASSERT_TRUE(atlas.Add("a", *small));
+	ASSERT_TRUE(atlas.Add("b", *small));
+	ASSERT_TRUE(atlas.Add("c", *small));
+	// Adding a key again does not upload it again.
+	ASSERT_TRUE(atlas.Add("a", *small));
+	// A image removed before its upload is not uploaded.
+	EXPECT_TRUE(atlas.Remove("b"));
+
+	// Every image added in a update is uploaded together.
+	atlas.Update();
+	ASSERT_EQ(atlas.uploadBatches.size(), 1);
+	ASSERT_EQ(atlas.uploadBatches[0].size(), 2);
+	EXPECT_EQ(atlas.uploadBatches[0][0].position, atlas.Find("a")->position);
+	EXPECT_EQ(atlas.uploadBatches[0][1].position, atlas.Find("c")->position);
+	EXPECT_EQ(atlas.uploadSizes[0][0], acid::Vector2ui(4, 4));
+
+	// Edge pixels are repeated into the padding.
+	const uint8_t expected[4][4] = {{0, 0, 1, 1}, {0, 0, 1, 1}, {2, 2, 3, 3}, {2, 2, 3, 3}};
+	for (uint32_t y = 0; y < 4; y++) {
+		for (uint32_t x = 0; x < 4; x++)
+			EXPECT_EQ(atlas.lastPixels[(y * 4 + x) * 4], expected[y][x]) << x << ", " << y;
+	}
+
+	// Updates without new images upload nothing.
+	atlas.Update();
+	EXPECT_EQ(atlas.uploadBatches.size(), 1);
+
+	auto region = atlas.Find("c");
+	EXPECT_EQ(region->Remap({0.0f, 0.0f}), acid::Vector2f(region->position) / 64.0f);
+	EXPECT_EQ(region->Remap({1.0f, 1.0f}), acid::Vector2f(region->position + region->size) / 64.0f);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <Graphics/Images/Image2d.hpp>
+#include <Graphics/Images/TextureStreamer.hpp>
+
+namespace {
+acid::TextureStreamer::Target CreateTarget(uint32_t size, uint32_t initialLevel) {
+	acid::TextureStreamer::Target target;
+	target.size = {size, size};
+	target.mipLevels = static_cast<uint32_t>(std::log2(size)) + 1;
+	target.initialLevel = initialLevel;
+	return target;
+}
+
+std::size_t GetBytes(const acid::TextureStreamer::Target &target) {
+	return acid::TextureStreamer::GetLevelBytes(target.size, target.format, target.mipLevels, target.level);
+}
+}
+
+TEST(TextureStreamer, initialLevel) {
+	acid::TextureStreamer streamer;
+
+	// The first level no larger than the initial size across its longest side.
+	EXPECT_EQ(streamer.GetInitialLevel({1024, 512}, 11), 4);
+	EXPECT_EQ(streamer.GetInitialLevel({32, 32}, 6), 0);
+	// Files that store too few levels start with their smallest one.
+	EXPECT_EQ(streamer.GetInitialLevel({1024, 1024}, 3), 2);
+
+	streamer.SetInitialSize(256);
+	EXPECT_EQ(streamer.GetInitialLevel({1024, 512}, 11), 2);
+}
+
+TEST(TextureStreamer, requestedLevel) {
+	EXPECT_EQ(acid::TextureStreamer::GetRequestedLevel({1024, 1024}, 11, 2048.0f), 0);
+	EXPECT_EQ(acid::TextureStreamer::GetRequestedLevel({1024, 1024}, 11, 1024.0f), 0);
+	EXPECT_EQ(acid::TextureStreamer::GetRequestedLevel({1024, 1024}, 11, 512.0f), 1);
+	// Levels are rounded towards the larger level, so no texel covers more than a pixel.
+	EXPECT_EQ(acid::TextureStreamer::GetRequestedLevel({1024, 256}, 11, 300.0f), 1);
+	EXPECT_EQ(acid::TextureStreamer::GetRequestedLevel({1024, 1024}, 11, 1.0f), 10);
+	EXPECT_EQ(acid::TextureStreamer::GetRequestedLevel({1024, 1024}, 4, 1.0f), 3);
+	EXPECT_EQ(acid::TextureStreamer::GetRequestedLevel({1024, 1024}, 11, 0.0f), 10);
+
+	// A radius of one seen from ten away with a field of view of 90 degrees covers a tenth of the screen.
+	EXPECT_FLOAT_EQ(acid::TextureStreamer::GetScreenSize(1.0f, 10.0f, acid::Maths::Radians(90.0f), 1000.0f), 100.0f);
+	EXPECT_FLOAT_EQ(acid::TextureStreamer::GetScreenSize(2.0f, 1.0f, acid::Maths::Radians(90.0f), 1000.0f), 1000.0f);
+}
+
+TEST(TextureStreamer, targetLevel) {
+	// Requests are followed but never past the initial level.
+	EXPECT_EQ(acid::TextureStreamer::GetTargetLevel(2, 0, 4, 4), 2);
+	EXPECT_EQ(acid::TextureStreamer::GetTargetLevel(6, 0, 4, 4), 4);
+	// Images that are not requested keep their levels until they have been idle for long enough.
+	EXPECT_EQ(acid::TextureStreamer::GetTargetLevel(std::nullopt, 10, 1, 4), 1);
+	EXPECT_EQ(acid::TextureStreamer::GetTargetLevel(std::nullopt, 10000, 1, 4), 4);
+}
+
+TEST(TextureStreamer, fitBudget) {
+	std::vector<acid::TextureStreamer::Target> targets = {CreateTarget(1024, 4), CreateTarget(256, 2)};
+
+	// Under the budget nothing changes.
+	auto totalBytes = acid::TextureStreamer::FitBudget(targets, GetBytes(targets[0]) + GetBytes(targets[1]));
+	EXPECT_EQ(targets[0].level, 0);
+	EXPECT_EQ(targets[1].level, 0);
+	EXPECT_EQ(totalBytes, GetBytes(targets[0]) + GetBytes(targets[1]));
+
+	// The largest image gives up its largest level first.
+	totalBytes = acid::TextureStreamer::FitBudget(targets, 2 * 1024 * 1024);
+	EXPECT_EQ(targets[0].level, 1);
+	EXPECT_EQ(targets[1].level, 0);
+	EXPECT_EQ(totalBytes, GetBytes(targets[0]) + GetBytes(targets[1]));
+	EXPECT_LE(totalBytes, 2 * 1024 * 1024);
+
+	// Levels are given up until every image is at its initial level, even if that is still over the budget.
+	totalBytes = acid::TextureStreamer::FitBudget(targets, 0);
+	EXPECT_EQ(targets[0].level, 4);
+	EXPECT_EQ(targets[1].level, 2);
+	EXPECT_EQ(totalBytes, GetBytes(targets[0]) + GetBytes(targets[1]));
+	EXPECT_GT(totalBytes, 0);
+}
+
+TEST(TextureStreamer, copyLevels) {
+	// Levels streamed in are copied from the levels a image keeps, the copy starts at the requested level.
+	acid::Bitmap stored(nullptr, {4, 4}, acid::PixelFormat::R8G8B8A8Unorm, 3);
+	stored.SetData(std::make_unique<uint8_t[]>(stored.GetLength()));
+	for (uint32_t i = 0; i < stored.GetLength(); i++)
+		stored.GetData()[i] = static_cast<uint8_t>(i);
+
+	auto levels = acid::Image2d::CopyLevels(stored, 1);
+	EXPECT_EQ(levels->GetSize(), acid::Vector2ui(2, 2));
+	EXPECT_EQ(levels->GetMipLevels(), 2u);
+	ASSERT_EQ(levels->GetLength(), stored.GetLength() - stored.GetLevelOffset(1));
+	EXPECT_EQ(levels->GetData()[0], stored.GetData()[stored.GetLevelOffset(1)]);
+	EXPECT_EQ(levels->GetData()[levels->GetLength() - 1], stored.GetData()[stored.GetLength() - 1]);
+}
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <Utils/ThreadPool.hpp>
+
+TEST(ThreadPool, parallelFor) {
+	acid::ThreadPool pool(4);
+	std::vector<uint32_t> values(10000);
+
+	pool.ParallelFor(0, values.size(), 128, [&values](std::size_t begin, std::size_t end) {
+		for (auto i = begin; i < end; i++)
+			values[i] = 1;
+	});
+	EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0u), 10000u);
+
+	// Nested calls run on the calling worker when the pool is busy.
+	std::atomic<uint32_t> nested = 0;
+	pool.ParallelFor(0, 8, 1, [&pool, &nested](std::size_t, std::size_t) {
+		pool.ParallelFor(0, 100, 10, [&nested](std::size_t begin, std::size_t end) {
+			nested += static_cast<uint32_t>(end - begin);
+		});
+	});
+	EXPECT_EQ(nested, 800u);
+
+	EXPECT_THROW(pool.ParallelFor(0, 10, 1, [](std::size_t begin, std::size_t) {
+		if (begin == 5)
+			throw std::runtime_error("Chunk failed");
+	}), std::runtime_error);
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <Uis/UiHitGrid.hpp>
+
+namespace {
+bool Contains(const acid::Vector2i &position, const acid::Vector2i &size, const acid::Vector2f &point) {
+	return point.x >= position.x && point.y >= position.y && point.x <= position.x + size.x && point.y <= position.y + size.y;
+}
+}
+
+TEST(UiHitGrid, query) {
+	acid::UiHitGrid grid(64);
+	grid.Clear({1280, 720});
+	grid.Add(0, {0, 0}, {1280, 720});
+	grid.Add(1, {100, 100}, {28, 28});
+	grid.Add(2, {120, 64}, {200, 64});
+	grid.Add(3, {-50, -50}, {10, 10});
+
+	std::vector<uint32_t> indices;
+	grid.Query({110.0f, 110.0f}, indices);
+	EXPECT_EQ(indices, (std::vector<uint32_t>{0, 1}));
+
+	// Edges are included, including edges on a cell boundary.
+	indices.clear();
+	grid.Query({128.0f, 128.0f}, indices);
+	EXPECT_EQ(indices, (std::vector<uint32_t>{0, 1, 2}));
+
+	indices.clear();
+	grid.Query({-45.0f, -45.0f}, indices);
+	EXPECT_TRUE(indices.empty());
+
+	indices.clear();
+	grid.Query({1280.0f, 720.0f}, indices);
+	EXPECT_EQ(indices, (std::vector<uint32_t>{0}));
+
+	grid.Clear({640, 480});
+	indices.clear();
+	grid.Query({110.0f, 110.0f}, indices);
+	EXPECT_TRUE(indices.empty());
+}
+
+TEST(UiHitGrid, matchesBruteForce) {
+	const acid::Vector2i area(1920, 1080);
+	std::mt19937 random(3);
+	std::uniform_int_distribution<int32_t> positionX(-100, area.x), positionY(-100, area.y), extent(0, 400);
+	std::uniform_real_distribution<float> pointX(0.0f, area.x), pointY(0.0f, area.y);
+
+	std::vector<std::pair<acid::Vector2i, acid::Vector2i>> rects;
+	for (uint32_t i = 0; i < 500; i++)
+		rects.emplace_back(acid::Vector2i(positionX(random), positionY(random)), acid::Vector2i(extent(random), extent(random)));
+
+	acid::UiHitGrid grid;
+	grid.Clear(area);
+	for (uint32_t i = 0; i < rects.size(); i++)
+		grid.Add(i, rects[i].first, rects[i].second);
+
+	std::vector<uint32_t> indices;
+	for (uint32_t i = 0; i < 2000; i++) {
+		acid::Vector2f point(pointX(random), pointY(random));
+		std::vector<uint32_t> expected;
+		for (uint32_t j = 0; j < rects.size(); j++) {
+			if (Contains(rects[j].first, rects[j].second, point))
+				expected.emplace_back(j);
+		}
+
+		indices.clear();
+		grid.Query(point, indices);
+		ASSERT_EQ(indices, expected);
+	}
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <Uis/UiObjectFilter.hpp>
+
+namespace {
+class FilterImage : public acid::UiObject {
+};
+
+class FilterText : public acid::UiObject {
+};
+}
+
+TEST(UiObjectFilter, update) {
+	FilterImage image;
+	FilterText text;
+	acid::UiObjectFilter<FilterImage> filter;
+	EXPECT_EQ(filter.Update({&image, &text}), (std::vector<FilterImage *>{&image}));
+
+	FilterImage other;
+	EXPECT_EQ(filter.Update({&text, &other, &image}), (std::vector<FilterImage *>{&other, &image}));
+	EXPECT_TRUE(filter.Update({&text}).empty());
+}
+
+TEST(UiObjectFilter, replacedAtSameAddress) {
+	// A object destroyed and another created in its place leaves the list of pointers unchanged.
+	alignas(std::max_align_t) unsigned char storage[std::max(sizeof(FilterImage), sizeof(FilterText))];
+	auto image = new(storage) FilterImage();
+	std::vector<acid::UiObject *> objects{image};
+
+	acid::UiObjectFilter<FilterImage> filter;
+	EXPECT_EQ(filter.Update(objects).size(), 1);
+
+	image->~FilterImage();
+	auto text = new(storage) FilterText();
+	ASSERT_EQ(static_cast<acid::UiObject *>(text), objects[0]);
+	EXPECT_TRUE(filter.Update(objects).empty());
+	text->~FilterText();
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <Files/Xml/Xml.hpp>
+
+/**
+ * Collects the text of every float_array element, the way a loader would consume a large document without building a tree.
+ */
+class FloatArrayHandler : public acid::NodeHandler {
+public:
+	bool BeginObject(std::string_view name) override {
+		// Skipped elements are read past without sending their contents.
+		if (name == "library_animations")
+			return false;
+		elements.emplace_back(name);
+		return true;
+	}
+	void EndObject() override { elements.pop_back(); }
+	void Value(std::string_view name, acid::Node::Type type, std::string_view value) override {
+		if (elements.back() == "float_array" && name == "#text")
+			arrays.emplace_back(value);
+		else if (name == "-count")
+			counts.emplace_back(value);
+	}
+
+	std::vector<std::string> elements;
+	std::vector<std::string> arrays;
+	std::vector<std::string> counts;
+};
+
+TEST(Xml, streamRead) {
+	FloatArrayHandler handler;
+	acid::Xml::Read(R"(<?xml version="1.0" encoding="utf-8"?>
+<!-- exported -->
+<COLLADA version="1.4.1">
+  <library_geometries>
+    <source id="positions"><float_array count="3"> 1 2.5 -3 </float_array></source>
+    <source id="normals"><float_array count='2'><![CDATA[0 1]]></float_array><empty/></source>
+  </library_geometries>
+  <library_animations><float_array count="1">9</float_array></library_animations>
+</COLLADA>)", handler);
+
+	EXPECT_TRUE(handler.elements.empty());
+	EXPECT_EQ(handler.arrays, (std::vector<std::string>{"1 2.5 -3", "0 1"}));
+	EXPECT_EQ(handler.counts, (std::vector<std::string>{"3", "2"}));
+
+	EXPECT_THROW(acid::Xml::Read("<a><b></a>", handler), std::runtime_error);
+}
+
+TEST(Xml, depthLimit) {
+	auto nested = [](std::size_t depth) {
+		std::string document;
+		for (std::size_t i = 0; i < depth; i++)
+			document += "<a>";
+		for (std::size_t i = 0; i < depth; i++)
+			document += "</a>";
+		return document;
+	};
+
+	acid::Node node;
+	node.ParseString<acid::Xml>(nested(acid::Node::MaxDepth));
+	acid::NodeHandler handler;
+	acid::Xml::Read(nested(acid::Node::MaxDepth), handler);
+
+	for (auto depth : {std::size_t(acid::Node::MaxDepth) + 1, std::size_t(200000)}) {
+		acid::Node failed;
+		EXPECT_THROW(failed.ParseString<acid::Xml>(nested(depth)), std::runtime_error) << depth;
+		EXPECT_THROW(acid::Xml::Read(nested(depth), handler), std::runtime_error) << depth;
+	}
+}
+
+TEST(Xml, streamWrite) {
+	std::ostringstream stream;
+	{
+		acid::Xml::Writer writer(stream);
+		writer.BeginObject("mesh");
+		writer.Write("-name", "Crate");
+		writer.BeginArray("source");
+		writer.BeginObject({});
+		writer.Write("-id", "positions");
+		writer.Write("#text", "1 2 3");
+		writer.EndObject();
+		writer.Write({}, "4 5 6");
+		writer.EndArray();
+		writer.Write("empty", "");
+		writer.EndObject();
+	}
+	EXPECT_EQ(stream.str(), R"(<?xml version="1.0" encoding="utf-8"?><mesh name="Crate"><source id="positions">1 2 3</source><source>4 5 6</source><empty/></mesh>)");
+
+	// The written document parses into the tree the Xml parser has always built.
+	acid::Node node;
+	node.ParseString<acid::Xml>(stream.str());
+	EXPECT_EQ(node["mesh"]["-name"].Get<std::string>(), "Crate");
+	EXPECT_EQ(node["mesh"]["source"]->GetType(), acid::Node::Type::Array);
+	EXPECT_EQ(node["mesh"]["source"][0]["-id"].Get<std::string>(), "positions");
+	EXPECT_EQ(node["mesh"]["source"][1].Get<std::string>(), "4 5 6");
+
+	acid::Node reparsed;
+	reparsed.ParseString<acid::Xml>(node["mesh"]->WriteString<acid::Xml>(acid::Node::Format::Beautified));
+	EXPECT_EQ(reparsed["mesh"]["source"][1].Get<std::string>(), "4 5 6");
+	EXPECT_EQ(reparsed["mesh"]["-name"].Get<std::string>(), "Crate");
+}
+
+TEST(Xml, lateAttributes) {
+	// Attributes added after the text and children of a node are still written into its start tag.
+	acid::Node node;
+	auto &mesh = node.AddProperty("mesh");
+	mesh.SetValue("text");
+	mesh["source"] = "positions";
+	mesh["-name"] = "Crate";
+	mesh["source"]["-id"] = "a";
+
+	auto written = node["mesh"]->WriteString<acid::Xml>();
+	EXPECT_EQ(written.find("<-"), std::string::npos) << written;
+
+	acid::Node reparsed;
+	reparsed.ParseString<acid::Xml>(written);
+	EXPECT_EQ(reparsed["mesh"]["-name"].Get<std::string>(), "Crate");
+	EXPECT_EQ(reparsed["mesh"]["source"]["-id"].Get<std::string>(), "a");
+	EXPECT_EQ(reparsed["mesh"]["source"]->GetValue(), "positions");
+	EXPECT_EQ(reparsed["mesh"]->GetValue(), "text");
+
+	// Events can not be reordered once written, so the writer rejects them.
+	std::ostringstream stream;
+	acid::Xml::Writer writer(stream);
+	writer.BeginObject("mesh");
+	writer.Write("#text", "text");
+	EXPECT_THROW(writer.Write("-name", "Crate"), std::runtime_error);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <random>
+#include <Files/Zip/ZipException.hpp>
+#include <Files/Zip/ZipPack.hpp>
+#include <Utils/ThreadPool.hpp>
+
+TEST(ZipPack, writeAndRead) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidZipPack";
+	std::filesystem::create_directories(directory);
+
+	// Text compresses well and is deflated, random bytes do not and are stored.
+	std::string text;
+	for (uint32_t i = 0; i < 10000; i++)
+		text += "Entity" + std::to_string(i % 100) + " ";
+	std::string noise(50000, '\0');
+	std::mt19937 generator(7);
+	for (auto &c : noise)
+		c = static_cast<char>(generator());
+
+	std::vector<acid::ZipPack::Source> sources;
+	for (uint32_t i = 0; i < 32; i++) {
+		auto path = directory / ("file" + std::to_string(i));
+		std::ofstream(path, std::ios::binary) << (i % 2 == 0 ? text : noise) << i;
+		sources.push_back({"Assets/File" + std::to_string(i) + ".bin", path});
+	}
+	std::ofstream(directory / "empty");
+	sources.push_back({"Assets/Empty.txt", directory / "empty"});
+
+	acid::ThreadPool threadPool(4);
+	auto packPath = directory / "Pack.zip";
+	acid::ZipPack::Write(packPath, sources, MZ_DEFAULT_LEVEL, &threadPool);
+
+	acid::ZipPack pack(packPath);
+	ASSERT_TRUE(pack);
+	EXPECT_EQ(pack.GetEntries().size(), sources.size());
+	EXPECT_EQ(pack.Find("Assets/Missing.bin"), nullptr);
+	EXPECT_FALSE(pack.Read("Assets/Missing.bin"));
+
+	auto deflated = pack.Find("Assets/File4.bin");
+	ASSERT_NE(deflated, nullptr);
+	EXPECT_FALSE(deflated->IsStored());
+	EXPECT_LT(deflated->compressedSize, deflated->size);
+	EXPECT_FALSE(pack.View(*deflated));
+	EXPECT_EQ(pack.Read(*deflated), text + "4");
+
+	auto stored = pack.Find("Assets/File5.bin");
+	ASSERT_NE(stored, nullptr);
+	EXPECT_TRUE(stored->IsStored());
+	auto view = pack.View(*stored);
+	ASSERT_TRUE(view);
+	EXPECT_EQ(*view, noise + "5");
+	EXPECT_GE(view->data(), reinterpret_cast<const char *>(pack.GetFile().GetData()));
+	EXPECT_EQ(*pack.Read("Assets/Empty.txt"), "");
+
+	std::vector<const acid::ZipPack::Entry *> entries;
+	for (const auto &entry : pack.GetEntries())
+		entries.emplace_back(&entry);
+	auto contents = pack.ReadAll(entries, &threadPool);
+	for (uint32_t i = 0; i < 32; i++)
+		EXPECT_EQ(contents[i], (i % 2 == 0 ? text : noise) + std::to_string(i)) << i;
+
+	// Without a pool the entries are read on the calling thread.
+	EXPECT_EQ(pack.ReadAll({stored, deflated}), (std::vector<std::string>{noise + "5", text + "4"}));
+
+	pack.Close();
+	std::filesystem::remove_all(directory);
+}
+
+TEST(ZipPack, crcCheck) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidZipPackCrc";
+	std::filesystem::create_directories(directory);
+
+	std::string text(4096, 'a');
+	std::string noise(4096, '\0');
+	std::mt19937 generator(11);
+	for (auto &c : noise)
+		c = static_cast<char>(generator());
+	std::ofstream(directory / "text", std::ios::binary) << text;
+	std::ofstream(directory / "noise", std::ios::binary) << noise;
+
+	auto packPath = directory / "Pack.zip";
+	acid::ZipPack::Write(packPath, {{"Text.txt", directory / "text"}, {"Noise.bin", directory / "noise"}});
+
+	// Corrupts a byte of the stored entry, which is read without inflating so only the crc can catch it.
+	std::string archive;
+	{
+		std::ifstream stream(packPath, std::ios::binary);
+		archive.assign(std::istreambuf_iterator<char>(stream), {});
+	}
+	auto storedOffset = archive.find(noise);
+	ASSERT_NE(storedOffset, std::string::npos);
+	archive[storedOffset + 100] ^= 1;
+	std::ofstream(packPath, std::ios::binary) << archive;
+
+	{
+		acid::ZipPack pack(packPath);
+		auto stored = pack.Find("Noise.bin");
+		ASSERT_NE(stored, nullptr);
+		ASSERT_TRUE(stored->IsStored());
+		EXPECT_THROW(pack.View(*stored), acid::ZipException);
+		EXPECT_THROW(pack.Read(*stored), acid::ZipException);
+		EXPECT_EQ(*pack.Read("Text.txt"), text);
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST(ZipPack, storedSizeMismatch) {
+	auto directory = std::filesystem::temp_directory_path() / "AcidZipPackSize";
+	std::filesystem::create_directories(directory);
+
+	std::string noise(4096, '\0');
+	std::mt19937 generator(13);
+	for (auto &c : noise)
+		c = static_cast<char>(generator());
+	std::ofstream(directory / "noise", std::ios::binary) << noise;
+
+	auto packPath = directory / "Pack.zip";
+	acid::ZipPack::Write(packPath, {{"Noise.bin", directory / "noise"}, {"Other.bin", directory / "noise"}});
+
+	// Shrinks the uncompressed size in the central directory record of the first entry, which follows every local entry.
+	std::string archive;
+	{
+		std::ifstream stream(packPath, std::ios::binary);
+		archive.assign(std::istreambuf_iterator<char>(stream), {});
+	}
+	auto record = archive.rfind("Noise.bin");
+	ASSERT_NE(record, std::string::npos);
+	record -= 46;
+	ASSERT_EQ(archive.compare(record, 4, "PK\x01\x02"), 0);
+	archive[record + 24] ^= 1;
+	std::ofstream(packPath, std::ios::binary) << archive;
+
+	{
+		acid::ZipPack pack(packPath);
+		auto stored = pack.Find("Noise.bin");
+		ASSERT_NE(stored, nullptr);
+		ASSERT_TRUE(stored->IsStored());
+		EXPECT_NE(stored->compressedSize, stored->size);
+		EXPECT_THROW(pack.View(*stored), acid::ZipExceptionInvalidHeader);
+		EXPECT_THROW(pack.Read(*stored), acid::ZipExceptionInvalidHeader);
+
+		// A valid entry keeps returning the same view once it has been checked.
+		auto other = pack.Find("Other.bin");
+		ASSERT_NE(other, nullptr);
+		auto first = pack.View(*other);
+		auto second = pack.View(*other);
+		ASSERT_TRUE(first && second);
+		EXPECT_EQ(first->data(), second->data());
+		EXPECT_EQ(*second, noise);
+	}
+
+	std::filesystem::remove_all(directory);
+}